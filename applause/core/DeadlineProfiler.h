@@ -0,0 +1,122 @@
+#pragma once
+#include <applause/util/thirdparty/readerwriterqueue.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Shared with SynthProfiler: the CMake option APPLAUSE_ENABLE_PROFILING compiles in both
+#ifndef APPLAUSE_ENABLE_PROFILING
+#define APPLAUSE_ENABLE_PROFILING 0
+#endif
+
+namespace applause {
+
+/** One process() call that took longer than the audio it produced. */
+struct DeadlineOverrun {
+    uint64_t block_index = 0;   ///< Which process() call, counted from the first timed one
+    uint64_t elapsed_ns = 0;    ///< Time spent in process()
+    uint64_t budget_ns = 0;     ///< num_frames / sample_rate
+    uint32_t num_frames = 0;
+    uint32_t num_events = 0;    ///< Input events the host delivered with the block
+    float load = 0.0f;          ///< elapsed_ns / budget_ns
+};
+
+/**
+ * Times process() calls against their real-time deadline, the duration of the audio they produce, for a UI or the
+ * inspector to show how much headroom a plugin has on the user's machine.
+ *
+ * PluginBase records into its own instance when APPLAUSE_ENABLE_PROFILING is set or the plugin publishes telemetry
+ * (getDeadlineProfiler() returns nullptr otherwise, and no block is timed). Each block lands in a bin of a load
+ * histogram, 10% of the deadline wide, with everything past 150% in the last bin. Blocks over their deadline are also
+ * queued as DeadlineOverrun records, with the worst load kept separately. Recording only touches atomics and a
+ * fixed-capacity single-producer queue, so it is safe on the audio thread; every getter is safe from one reader
+ * thread.
+ */
+class DeadlineProfiler {
+public:
+    static constexpr size_t kNumBins = 16;
+    static constexpr float kBinWidth = 0.1f;
+
+    explicit DeadlineProfiler(size_t overrun_capacity = 64) : overruns_(overrun_capacity) {}
+
+    /** Audio thread: records one block that took elapsed_ns to render num_frames at sample_rate. */
+    void record(uint64_t elapsed_ns, uint32_t num_frames, uint32_t num_events, double sample_rate) noexcept {
+        const uint64_t block = blocks_.fetch_add(1, std::memory_order_relaxed);
+        if (num_frames == 0 || sample_rate <= 0.0) return;
+
+        const auto budget_ns = static_cast<uint64_t>(num_frames * 1e9 / sample_rate);
+        const float load = budget_ns > 0 ? static_cast<float>(elapsed_ns) / static_cast<float>(budget_ns) : 0.0f;
+        const auto bin = std::min(static_cast<size_t>(load / kBinWidth), kNumBins - 1);
+        histogram_[bin].fetch_add(1, std::memory_order_relaxed);
+
+        if (load > std::bit_cast<float>(worst_load_bits_.load(std::memory_order_relaxed))) {
+            worst_load_bits_.store(std::bit_cast<uint32_t>(load), std::memory_order_relaxed);
+        }
+        if (elapsed_ns > budget_ns) {
+            overrun_count_.fetch_add(1, std::memory_order_relaxed);
+            const DeadlineOverrun overrun{.block_index = block,
+                                          .elapsed_ns = elapsed_ns,
+                                          .budget_ns = budget_ns,
+                                          .num_frames = num_frames,
+                                          .num_events = num_events,
+                                          .load = load};
+            if (!overruns_.try_enqueue(overrun)) dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /** A snapshot of the histogram: bin i counts blocks with a load in [i, i + 1) * kBinWidth. */
+    [[nodiscard]] std::array<uint64_t, kNumBins> getHistogram() const noexcept {
+        std::array<uint64_t, kNumBins> counts{};
+        for (size_t i = 0; i < kNumBins; ++i) counts[i] = histogram_[i].load(std::memory_order_relaxed);
+        return counts;
+    }
+
+    [[nodiscard]] uint64_t getBlockCount() const noexcept { return blocks_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t getOverrunCount() const noexcept { return overrun_count_.load(std::memory_order_relaxed); }
+
+    /** The highest elapsed / budget ratio seen; above 1 means at least one block missed its deadline. */
+    [[nodiscard]] float getWorstLoad() const noexcept {
+        return std::bit_cast<float>(worst_load_bits_.load(std::memory_order_relaxed));
+    }
+
+    /** Reader thread: pops the oldest overrun. Returns false when there is none. */
+    bool tryPopOverrun(DeadlineOverrun& overrun) noexcept { return overruns_.try_dequeue(overrun); }
+
+    /** Overruns that didn't fit in the queue because the reader fell behind. */
+    [[nodiscard]] uint64_t getDroppedOverrunCount() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Reader thread: clears the counts, say when the user presses reset in a meter. A block recorded at the same
+     * moment may land on either side of the reset.
+     */
+    void resetCounts() noexcept {
+        for (auto& bin : histogram_) bin.store(0, std::memory_order_relaxed);
+        overrun_count_.store(0, std::memory_order_relaxed);
+        worst_load_bits_.store(0, std::memory_order_relaxed);
+        dropped_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kNumBins> histogram_{};
+    std::atomic<uint64_t> blocks_{0};
+    std::atomic<uint64_t> overrun_count_{0};
+    std::atomic<uint32_t> worst_load_bits_{0};  // A float; the audio thread is the only writer besides resetCounts()
+    std::atomic<uint64_t> dropped_{0};
+    ReaderWriterQueue<DeadlineOverrun> overruns_;
+};
+
+/** Nanoseconds on the steady clock, for DeadlineProfiler::record(). */
+inline uint64_t deadlineClockNanos() noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+}  // namespace applause
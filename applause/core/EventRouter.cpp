@@ -0,0 +1,94 @@
+#include "EventRouter.h"
+
+#include <algorithm>
+
+namespace applause {
+
+EventRouter::EventRouter(size_t capacity) : events_(capacity) {
+    list_.ctx = this;
+    list_.size = listSize;
+    list_.get = listGet;
+}
+
+void EventRouter::addHandler(uint16_t type, void* target, Handler handler) {
+    ASSERT(handler, "EventRouter: null handler");
+    ASSERT(num_handlers_ < kMaxHandlers, "EventRouter: more than {} handlers", kMaxHandlers);
+    if (num_handlers_ == kMaxHandlers) return;
+    handlers_[num_handlers_++] = {type, target, handler};
+}
+
+void EventRouter::removeHandlers(const void* target) noexcept {
+    const auto end = handlers_.begin() + static_cast<std::ptrdiff_t>(num_handlers_);
+    const auto kept = std::stable_partition(handlers_.begin(), end,
+                                            [target](const HandlerEntry& entry) { return entry.target != target; });
+    num_handlers_ = static_cast<size_t>(kept - handlers_.begin());
+}
+
+void EventRouter::begin(const clap_input_events_t* in) noexcept {
+    source_ = in;
+    count_ = 0;
+    next_dispatch_ = 0;
+    types_ = 0;
+    cached_ = true;
+    if (!in) return;
+
+    const uint32_t size = in->size(in);
+    if (size > events_.size()) {
+        cached_ = false;
+        count_ = size;
+        return;
+    }
+
+    bool sorted = true;
+    for (uint32_t i = 0; i < size; ++i) {
+        const clap_event_header_t* event = in->get(in, i);
+        if (!event) continue;
+        if (count_ > 0 && event->time < events_[count_ - 1]->time) sorted = false;
+        if (event->space_id == CLAP_CORE_EVENT_SPACE_ID && event->type < 64) types_ |= uint64_t{1} << event->type;
+        events_[count_++] = event;
+    }
+    if (!sorted) {
+        // Insertion sort: stable, doesn't allocate, and fast for lists that are only slightly out of order
+        for (uint32_t i = 1; i < count_; ++i) {
+            const clap_event_header_t* event = events_[i];
+            uint32_t j = i;
+            for (; j > 0 && events_[j - 1]->time > event->time; --j) events_[j] = events_[j - 1];
+            events_[j] = event;
+        }
+    }
+}
+
+const clap_event_header_t* EventRouter::get(uint32_t index) const noexcept {
+    if (index >= count_) return nullptr;
+    return cached_ ? events_[index] : source_->get(source_, index);
+}
+
+const EventRouter* EventRouter::fromInputEvents(const clap_input_events_t* in) noexcept {
+    return in && in->size == listSize ? static_cast<const EventRouter*>(in->ctx) : nullptr;
+}
+
+void EventRouter::dispatchUntil(uint32_t time) noexcept {
+    while (next_dispatch_ < count_) {
+        const clap_event_header_t* event = get(next_dispatch_);
+        if (event && event->time >= time) break;
+        ++next_dispatch_;
+        if (event) dispatch(*event);
+    }
+}
+
+void EventRouter::dispatch(const clap_event_header_t& event) const noexcept {
+    if (event.space_id != CLAP_CORE_EVENT_SPACE_ID) return;
+    for (size_t i = 0; i < num_handlers_; ++i) {
+        if (handlers_[i].type == event.type) handlers_[i].handler(handlers_[i].target, event);
+    }
+}
+
+uint32_t EventRouter::listSize(const clap_input_events_t* list) noexcept {
+    return static_cast<const EventRouter*>(list->ctx)->size();
+}
+
+const clap_event_header_t* EventRouter::listGet(const clap_input_events_t* list, uint32_t index) noexcept {
+    return static_cast<const EventRouter*>(list->ctx)->get(index);
+}
+
+}  // namespace applause
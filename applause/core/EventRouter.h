@@ -0,0 +1,148 @@
+#pragma once
+
+#include <applause/util/DebugHelpers.h>
+
+#include <clap/events.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace applause {
+
+/**
+ * Walks the host's input events once per block and shares that one pass between every consumer.
+ *
+ * PluginBase calls begin() before each process(): it fetches every event from the host's list, once, into a flat
+ * array of header pointers, sorted by time (hosts already deliver them sorted, a misbehaving one gets a stable
+ * fix-up), and notes which core event types the block contains. ProcessContext::inputEvents() then hands out a
+ * clap_input_events_t over that array instead of the host's, so ParamsExtension::processEvents(),
+ * Synthesizer::process() and the plugin's own loops all read the cached pointers, and can skip event types the
+ * block doesn't have (hasType()).
+ *
+ * Consumers that only care about some event types register handlers per type instead, and the plugin dispatches:
+ * dispatchAll() for block-rate processing, or forEachSubBlock(), which splits the block at event times and runs
+ * each sub-block's handlers in time order before rendering it.
+ *
+ * @code
+ * // Main thread
+ * getEventRouter().addHandler<&MyPlugin::onMidi>(CLAP_EVENT_MIDI, *this);
+ *
+ * // Audio thread
+ * context.eventRouter()->forEachSubBlock(context.numFrames(), [&](uint32_t start, uint32_t count) {
+ *     renderFilter(start, count);
+ * });
+ * @endcode
+ *
+ * Blocks with more events than the capacity aren't cached: the list view then forwards to the host's list as is.
+ */
+class EventRouter {
+public:
+    /** Called with the registered target for each routed event. */
+    using Handler = void (*)(void* target, const clap_event_header_t& event) noexcept;
+
+    static constexpr size_t kDefaultCapacity = 4096;
+    static constexpr size_t kMaxHandlers = 16;
+
+    /** Main thread: reserves room for capacity events per block. */
+    explicit EventRouter(size_t capacity = kDefaultCapacity);
+
+    EventRouter(const EventRouter&) = delete;
+    EventRouter& operator=(const EventRouter&) = delete;
+
+    /**
+     * Main thread, outside process(): routes core events of the given type (CLAP_EVENT_NOTE_ON, ...) to
+     * handler(target, event). Handlers of the same type run in the order they were added.
+     */
+    void addHandler(uint16_t type, void* target, Handler handler);
+
+    /** addHandler() for a member function `void Target::Method(const clap_event_header_t&) noexcept`. */
+    template <auto Method, typename Target>
+    void addHandler(uint16_t type, Target& target) {
+        addHandler(type, &target, [](void* object, const clap_event_header_t& event) noexcept {
+            (static_cast<Target*>(object)->*Method)(event);
+        });
+    }
+
+    /** Main thread, outside process(): removes every handler registered for target. */
+    void removeHandlers(const void* target) noexcept;
+
+    /** Audio thread: fetches the block's events from in (may be nullptr) and resets dispatching. */
+    void begin(const clap_input_events_t* in) noexcept;
+
+    /** Audio thread: forgets the block's events, which the host may free once process() returns. */
+    void end() noexcept { begin(nullptr); }
+
+    [[nodiscard]] uint32_t size() const noexcept { return count_; }
+
+    /** The i-th event in time order, or nullptr if out of range. */
+    [[nodiscard]] const clap_event_header_t* get(uint32_t index) const noexcept;
+
+    /** A list view of the block's events, for code that takes the host's clap_input_events_t. */
+    [[nodiscard]] const clap_input_events_t* inputEvents() const noexcept { return &list_; }
+
+    /** Whether the block has a core event of the given type. Always true for blocks that weren't cached. */
+    [[nodiscard]] bool hasType(uint16_t type) const noexcept {
+        return !cached_ || type >= 64 || (types_ & (uint64_t{1} << type)) != 0;
+    }
+
+    /** The router behind a list returned by inputEvents(), or nullptr for any other list. */
+    [[nodiscard]] static const EventRouter* fromInputEvents(const clap_input_events_t* in) noexcept;
+
+    /** Audio thread: runs the handlers of every not yet dispatched event with a time before time. */
+    void dispatchUntil(uint32_t time) noexcept;
+
+    /** Audio thread: runs the handlers of every remaining event. */
+    void dispatchAll() noexcept { dispatchUntil(UINT32_MAX); }
+
+    /**
+     * Audio thread: splits [0, num_frames) at the event times and calls render(start, count) for each piece, after
+     * dispatching the events that take effect by its start. Events less than min_frames after a sub-block's start
+     * are applied at that start instead of splitting again; events at or past num_frames land in the last
+     * sub-block.
+     */
+    template <typename F>
+    void forEachSubBlock(uint32_t num_frames, F&& render, uint32_t min_frames = 1) {
+        if (min_frames == 0) min_frames = 1;
+        uint32_t start = 0;
+        while (start < num_frames) {
+            const uint32_t window = num_frames - start > min_frames ? start + min_frames : num_frames;
+            dispatchUntil(window);
+            uint32_t next = num_frames;
+            if (next_dispatch_ < count_) {
+                const clap_event_header_t* event = get(next_dispatch_);
+                if (event && event->time < num_frames) next = event->time;
+            }
+            render(start, next - start);
+            start = next;
+        }
+        dispatchAll();
+    }
+
+private:
+    struct HandlerEntry {
+        uint16_t type = 0;
+        void* target = nullptr;
+        Handler handler = nullptr;
+    };
+
+    static uint32_t listSize(const clap_input_events_t* list) noexcept;
+    static const clap_event_header_t* listGet(const clap_input_events_t* list, uint32_t index) noexcept;
+
+    void dispatch(const clap_event_header_t& event) const noexcept;
+
+    std::vector<const clap_event_header_t*> events_;  // Sized once; the first count_ are this block's
+    const clap_input_events_t* source_ = nullptr;
+    uint32_t count_ = 0;
+    uint32_t next_dispatch_ = 0;
+    uint64_t types_ = 0;  // Bit t: the block has a core event of type t
+    bool cached_ = true;
+
+    std::array<HandlerEntry, kMaxHandlers> handlers_{};
+    size_t num_handlers_ = 0;
+
+    clap_input_events_t list_{};
+};
+
+}  // namespace applause
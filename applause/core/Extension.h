@@ -1,7 +1,14 @@
 #pragma once
 
+#include <applause/core/RealtimeSafety.h>
+#include <applause/util/DebugHelpers.h>
 #include <clap/clap.h>
 
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
 namespace applause {
 
 /**
@@ -71,6 +78,12 @@ protected:
      */
     virtual void onHostReady() noexcept {}
 
+    /**
+     * @brief Hook invoked from the host's clap_plugin::on_main_thread(), before PluginBase::onMainThread(), so an
+     * extension can finish on the main thread what it requested with clap_host::request_callback().
+     */
+    virtual void onMainThread() noexcept {}
+
     const clap_host_t* host_ = nullptr;
 
 private:
@@ -94,4 +107,39 @@ struct CExtensionWrapper : IExtension {
 
     const void* getClapExtensionStruct() const override { return &_ext; }
 };
+
+namespace detail {
+inline constexpr std::size_t kMaxExtensionSlots = 32;
+inline constexpr std::size_t kNoExtensionSlot = kMaxExtensionSlots;
+
+/**
+ * Maps a CLAP extension ID to a small process-wide index, assigning the next free one the first time an ID is
+ * seen. This is the only place extension IDs are compared as strings; returns kNoExtensionSlot once every slot
+ * is taken.
+ */
+inline std::size_t extensionSlotFor(const char* id) {
+    static std::mutex mutex;
+    static std::array<std::string, kMaxExtensionSlots> ids;
+    static std::size_t count = 0;
+
+    APPLAUSE_ASSERT_NOT_REALTIME("extension slot lookup; call findExtension<T>() once before processing");
+    std::lock_guard lock{mutex};
+    for (std::size_t i = 0; i < count; ++i) {
+        if (ids[i] == id) return i;
+    }
+    if (count == kMaxExtensionSlots) {
+        LOG_ERR("Extension: out of extension slots, {} falls back to a map lookup", id);
+        return kNoExtensionSlot;
+    }
+    ids[count] = id;
+    return count++;
+}
+
+/** The slot of ExtType::ID, resolved once per type; afterwards a plain static load. */
+template <typename ExtType>
+std::size_t extensionSlot() {
+    static const std::size_t slot = extensionSlotFor(ExtType::ID);
+    return slot;
+}
+}  // namespace detail
 }  // namespace applause
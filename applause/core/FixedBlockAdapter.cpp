@@ -0,0 +1,269 @@
+#include "FixedBlockAdapter.h"
+
+#include <applause/util/DebugHelpers.h>
+
+#include <cstring>
+
+namespace applause {
+namespace {
+// Events hold doubles and pointers; keep every copy aligned for them
+constexpr size_t kEventAlignment = std::max(alignof(double), alignof(void*));
+
+// How long a status keeps the plugin running, Error aside
+int keepRunningRank(ProcessStatus status) noexcept {
+    switch (status) {
+    case ProcessStatus::Continue:
+        return 3;
+    case ProcessStatus::ContinueIfNotQuiet:
+        return 2;
+    case ProcessStatus::Tail:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+template <typename T>
+bool hasChannels(T* const* channels, uint32_t count) noexcept {
+    if (!channels) return false;
+    for (uint32_t ch = 0; ch < count; ++ch) {
+        if (!channels[ch]) return false;
+    }
+    return true;
+}
+}  // namespace
+
+FixedBlockAdapter::FixedBlockAdapter() noexcept {
+    list_.ctx = this;
+    list_.size = listSize;
+    list_.get = listGet;
+    block_.in_events = &list_;
+}
+
+void FixedBlockAdapter::configure(uint32_t block_size, FixedBlockMode mode, std::span<const uint32_t> input_channels,
+                                  std::span<const uint32_t> output_channels, size_t event_bytes, size_t max_events) {
+    ASSERT(block_size > 0, "FixedBlockAdapter: block size must be positive");
+    if (block_size == 0) {
+        disable();
+        return;
+    }
+    block_size_ = block_size;
+    mode_ = mode;
+
+    // In Latency mode each port buffers one block: input ports the one being filled, output ports the one playing
+    const bool fifos = mode == FixedBlockMode::Latency;
+    const auto makePorts = [&](std::vector<Port>& ports, std::vector<clap_audio_buffer_t>& buffers,
+                               std::span<const uint32_t> channels) {
+        ports.assign(channels.size(), Port{});
+        buffers.assign(channels.size(), clap_audio_buffer_t{});
+        for (size_t i = 0; i < channels.size(); ++i) {
+            Port& port = ports[i];
+            port.channels = channels[i];
+            port.data32.assign(channels[i], nullptr);
+            port.data64.assign(channels[i], nullptr);
+            if (fifos) {
+                port.fifo32.assign(size_t{channels[i]} * block_size, 0.0f);
+                port.fifo64.assign(size_t{channels[i]} * block_size, 0.0);
+            }
+        }
+    };
+    makePorts(inputs_, input_buffers_, input_channels);
+    makePorts(outputs_, output_buffers_, output_channels);
+    block_.audio_inputs = input_buffers_.data();
+    block_.audio_outputs = output_buffers_.data();
+
+    event_storage_ = std::make_unique<std::byte[]>(event_bytes);
+    event_bytes_ = event_bytes;
+    pending_.assign(max_events, PendingEvent{});
+    reset();
+}
+
+void FixedBlockAdapter::disable() noexcept {
+    block_size_ = 0;
+    inputs_.clear();
+    outputs_.clear();
+    input_buffers_.clear();
+    output_buffers_.clear();
+    block_.audio_inputs = nullptr;
+    block_.audio_outputs = nullptr;
+    block_.audio_inputs_count = 0;
+    block_.audio_outputs_count = 0;
+    event_storage_.reset();
+    event_bytes_ = 0;
+    pending_.clear();
+    reset();
+}
+
+void FixedBlockAdapter::reset() noexcept {
+    for (auto* ports : {&inputs_, &outputs_}) {
+        for (Port& port : *ports) {
+            std::fill(port.fifo32.begin(), port.fifo32.end(), 0.0f);
+            std::fill(port.fifo64.begin(), port.fifo64.end(), 0.0);
+        }
+    }
+    stream_position_ = 0;
+    fill_ = 0;
+    fifo_steady_time_ = -1;
+    last_status_ = ProcessStatus::Continue;
+    used_event_bytes_ = 0;
+    num_pending_ = 0;
+    next_pending_ = 0;
+    block_first_ = 0;
+}
+
+ProcessStatus FixedBlockAdapter::keepRunningLongest(ProcessStatus a, ProcessStatus b) noexcept {
+    if (a == ProcessStatus::Error || b == ProcessStatus::Error) return ProcessStatus::Error;
+    return keepRunningRank(a) >= keepRunningRank(b) ? a : b;
+}
+
+void FixedBlockAdapter::ingestEvents(const EventRouter& events, uint32_t last_frame) noexcept {
+    for (uint32_t i = 0; i < events.size(); ++i) {
+        const clap_event_header_t* event = events.get(i);
+        if (!event) continue;
+        const size_t offset = (used_event_bytes_ + kEventAlignment - 1) / kEventAlignment * kEventAlignment;
+        if (num_pending_ == pending_.size() || event->size < sizeof(clap_event_header_t) ||
+            offset + event->size > event_bytes_) {
+            ++dropped_events_;
+            continue;
+        }
+        std::memcpy(event_storage_.get() + offset, event, event->size);
+        used_event_bytes_ = offset + event->size;
+        pending_[num_pending_++] = {stream_position_ + std::min(event->time, last_frame),
+                                    static_cast<uint32_t>(offset)};
+    }
+}
+
+void FixedBlockAdapter::selectEvents(uint64_t start, uint32_t count) noexcept {
+    // A block of no frames (the host's event-only calls) still takes the events at its start
+    const uint64_t end = start + std::max<uint32_t>(count, 1);
+    block_first_ = next_pending_;
+    while (next_pending_ < num_pending_ && pending_[next_pending_].position < end) {
+        const PendingEvent& pending = pending_[next_pending_++];
+        auto* header = reinterpret_cast<clap_event_header_t*>(event_storage_.get() + pending.offset);
+        header->time = pending.position > start ? static_cast<uint32_t>(pending.position - start) : 0;
+    }
+}
+
+void FixedBlockAdapter::compactEvents() noexcept {
+    block_first_ = 0;
+    if (next_pending_ == 0) return;
+    if (next_pending_ == num_pending_) {
+        used_event_bytes_ = 0;
+        num_pending_ = 0;
+        next_pending_ = 0;
+        return;
+    }
+    // Events still waiting for a later block (Latency mode) move to the front; they're few, at most one block's
+    const uint32_t base = pending_[next_pending_].offset;
+    std::memmove(event_storage_.get(), event_storage_.get() + base, used_event_bytes_ - base);
+    used_event_bytes_ -= base;
+    for (size_t i = next_pending_; i < num_pending_; ++i) {
+        pending_[i - next_pending_] = {pending_[i].position, pending_[i].offset - base};
+    }
+    num_pending_ -= next_pending_;
+    next_pending_ = 0;
+}
+
+void FixedBlockAdapter::pointIntoHost(const clap_process_t& host, uint32_t offset) noexcept {
+    const auto point = [offset](const clap_audio_buffer_t* host_buffers, uint32_t host_count, std::vector<Port>& ports,
+                                std::vector<clap_audio_buffer_t>& buffers) {
+        const size_t count = host_buffers ? std::min<size_t>(host_count, ports.size()) : 0;
+        for (size_t i = 0; i < count; ++i) {
+            const clap_audio_buffer_t& from = host_buffers[i];
+            Port& port = ports[i];
+            const uint32_t channels = std::min(from.channel_count, port.channels);
+            const bool has32 = hasChannels(from.data32, channels);
+            const bool has64 = hasChannels(from.data64, channels);
+            for (uint32_t ch = 0; ch < channels; ++ch) {
+                port.data32[ch] = has32 ? from.data32[ch] + offset : nullptr;
+                port.data64[ch] = has64 ? from.data64[ch] + offset : nullptr;
+            }
+            buffers[i] = {.data32 = has32 ? port.data32.data() : nullptr,
+                          .data64 = has64 ? port.data64.data() : nullptr,
+                          .channel_count = channels,
+                          .latency = from.latency,
+                          .constant_mask = from.constant_mask};
+        }
+        return static_cast<uint32_t>(count);
+    };
+    block_.audio_inputs_count = point(host.audio_inputs, host.audio_inputs_count, inputs_, input_buffers_);
+    block_.audio_outputs_count = point(host.audio_outputs, host.audio_outputs_count, outputs_, output_buffers_);
+    // Whatever the host flagged on its outputs doesn't hold for what the plugin writes there
+    for (uint32_t i = 0; i < block_.audio_outputs_count; ++i) output_buffers_[i].constant_mask = 0;
+}
+
+void FixedBlockAdapter::exchangeWithFifos(const clap_process_t& host, uint32_t first, uint32_t count) noexcept {
+    // Inputs are copied in before outputs are copied out, so ports the host processes in place work too
+    const size_t in_ports = host.audio_inputs ? std::min<size_t>(host.audio_inputs_count, inputs_.size()) : 0;
+    for (size_t i = 0; i < in_ports; ++i) {
+        const clap_audio_buffer_t& from = host.audio_inputs[i];
+        Port& port = inputs_[i];
+        const uint32_t channels = std::min(from.channel_count, port.channels);
+        const bool use64 = !hasChannels(from.data32, channels) && hasChannels(from.data64, channels);
+        port.fifo_is_double = use64;
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            const size_t at = size_t{ch} * block_size_ + fill_;
+            if (use64) {
+                std::copy_n(from.data64[ch] + first, count, port.fifo64.data() + at);
+            } else if (from.data32 && from.data32[ch]) {
+                std::copy_n(from.data32[ch] + first, count, port.fifo32.data() + at);
+            }
+        }
+    }
+
+    const size_t out_ports = host.audio_outputs ? std::min<size_t>(host.audio_outputs_count, outputs_.size()) : 0;
+    for (size_t i = 0; i < out_ports; ++i) {
+        const clap_audio_buffer_t& to = host.audio_outputs[i];
+        Port& port = outputs_[i];
+        const uint32_t channels = std::min(to.channel_count, port.channels);
+        const bool use64 = !hasChannels(to.data32, channels) && hasChannels(to.data64, channels);
+        if (use64 != port.fifo_is_double) {
+            // The host switched the port's format: what the last block wrote is in the other FIFO
+            std::fill(port.fifo32.begin(), port.fifo32.end(), 0.0f);
+            std::fill(port.fifo64.begin(), port.fifo64.end(), 0.0);
+            port.fifo_is_double = use64;
+        }
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            const size_t at = size_t{ch} * block_size_ + fill_;
+            if (use64) {
+                std::copy_n(port.fifo64.data() + at, count, to.data64[ch] + first);
+            } else if (to.data32 && to.data32[ch]) {
+                std::copy_n(port.fifo32.data() + at, count, to.data32[ch] + first);
+            }
+        }
+    }
+}
+
+void FixedBlockAdapter::pointIntoFifos() noexcept {
+    const auto point = [this](std::vector<Port>& ports, std::vector<clap_audio_buffer_t>& buffers) {
+        for (size_t i = 0; i < ports.size(); ++i) {
+            Port& port = ports[i];
+            for (uint32_t ch = 0; ch < port.channels; ++ch) {
+                port.data32[ch] = port.fifo32.data() + size_t{ch} * block_size_;
+                port.data64[ch] = port.fifo64.data() + size_t{ch} * block_size_;
+            }
+            buffers[i] = {.data32 = port.fifo_is_double ? nullptr : port.data32.data(),
+                          .data64 = port.fifo_is_double ? port.data64.data() : nullptr,
+                          .channel_count = port.channels,
+                          .latency = 0,
+                          .constant_mask = 0};
+        }
+        return static_cast<uint32_t>(ports.size());
+    };
+    block_.audio_inputs_count = point(inputs_, input_buffers_);
+    block_.audio_outputs_count = point(outputs_, output_buffers_);
+}
+
+uint32_t FixedBlockAdapter::listSize(const clap_input_events_t* list) noexcept {
+    const auto* self = static_cast<const FixedBlockAdapter*>(list->ctx);
+    return static_cast<uint32_t>(self->next_pending_ - self->block_first_);
+}
+
+const clap_event_header_t* FixedBlockAdapter::listGet(const clap_input_events_t* list, uint32_t index) noexcept {
+    const auto* self = static_cast<const FixedBlockAdapter*>(list->ctx);
+    if (index >= self->next_pending_ - self->block_first_) return nullptr;
+    const PendingEvent& pending = self->pending_[self->block_first_ + index];
+    return reinterpret_cast<const clap_event_header_t*>(self->event_storage_.get() + pending.offset);
+}
+
+}  // namespace applause
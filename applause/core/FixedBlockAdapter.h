@@ -0,0 +1,200 @@
+#pragma once
+
+#include <applause/core/EventRouter.h>
+#include <applause/core/OutputEventBatch.h>
+#include <applause/core/ProcessContext.h>
+
+#include <clap/process.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace applause {
+
+/** How PluginBase::setFixedBlockSize() cuts the host's blocks. */
+enum class FixedBlockMode : uint8_t {
+    /**
+     * No added latency: each host block is processed as full blocks of the fixed size, then one shorter block for
+     * the frames left over. Only the last block of a host call can be short.
+     */
+    VariableTail,
+    /**
+     * Every block is exactly the fixed size, whatever the host sends, at the cost of one block of latency, which
+     * PluginBase adds to the LatencyExtension's report.
+     */
+    Latency,
+};
+
+/**
+ * @brief Re-blocks the host's process() calls into blocks of a fixed size, so DSP can count on FFT- and SIMD-friendly
+ * block lengths and per-block costs (modulation, event dispatch) stay predictable. PluginBase drives it once
+ * setFixedBlockSize() is set; see there.
+ *
+ * Each block gets its own clap_process_t: the audio ports (at offsets into the host's buffers in VariableTail mode,
+ * or the adapter's FIFOs in Latency mode), the events that fall into it with times relative to its start, and a
+ * steady time to match. The transport stays the host block's. Output events pushed from a block are moved back to
+ * host time; in Latency mode, those that would land past the end of the host block are sent at its last frame.
+ *
+ * Buffers and event storage are allocated by configure(), from the port layout; process() doesn't allocate or
+ * lock. Host ports beyond the layout, and channels beyond a port's, are left out of the blocks.
+ */
+class FixedBlockAdapter {
+public:
+    static constexpr size_t kDefaultEventBytes = 64 * 1024;
+    static constexpr size_t kDefaultMaxEvents = 2048;
+
+    FixedBlockAdapter() noexcept;
+
+    FixedBlockAdapter(const FixedBlockAdapter&) = delete;
+    FixedBlockAdapter& operator=(const FixedBlockAdapter&) = delete;
+
+    /**
+     * Main thread, while deactivated: cuts host blocks into block_size frames from now on, for ports with the given
+     * channel counts. Input events are copied into event_bytes of storage, up to max_events at a time.
+     */
+    void configure(uint32_t block_size, FixedBlockMode mode, std::span<const uint32_t> input_channels,
+                   std::span<const uint32_t> output_channels, size_t event_bytes = kDefaultEventBytes,
+                   size_t max_events = kDefaultMaxEvents);
+
+    /** Main thread, while deactivated: hands host blocks through unchanged again and frees the buffers. */
+    void disable() noexcept;
+
+    [[nodiscard]] bool isEnabled() const noexcept { return block_size_ > 0; }
+
+    [[nodiscard]] uint32_t blockSize() const noexcept { return block_size_; }
+
+    [[nodiscard]] FixedBlockMode mode() const noexcept { return mode_; }
+
+    /** The latency the adapter adds: the block size in Latency mode, otherwise none. */
+    [[nodiscard]] uint32_t latency() const noexcept { return mode_ == FixedBlockMode::Latency ? block_size_ : 0; }
+
+    /** Audio thread: forgets buffered audio and pending events, e.g. from clap_plugin::reset(). */
+    void reset() noexcept;
+
+    /** Input events dropped because they didn't fit the event storage, since construction. */
+    [[nodiscard]] uint64_t getDroppedEventCount() const noexcept { return dropped_events_; }
+
+    /**
+     * Audio thread: processes one host block as fixed-size blocks, calling process_block(const clap_process_t&) for
+     * each; it returns the block's ProcessStatus. events holds the host block's input events, sorted (PluginBase's
+     * router once begun on the host's list); out collects the output events. Returns the status that keeps the
+     * plugin running the longest, or in Latency mode with no complete block, the previous status.
+     */
+    template <typename F>
+    ProcessStatus process(const clap_process_t& host, const EventRouter& events, OutputEventBatch& out,
+                          F&& process_block) {
+        const uint32_t frames = host.frames_count;
+        const uint32_t last_frame = frames > 0 ? frames - 1 : 0;
+        ingestEvents(events, last_frame);
+        for (auto& buffer : hostOutputs(host)) buffer.constant_mask = 0;
+
+        bool ran = false;
+        ProcessStatus status = ProcessStatus::Sleep;
+        const auto run = [&](uint32_t count, uint64_t start, int64_t steady_time, uint32_t out_offset) {
+            block_.frames_count = count;
+            block_.steady_time = steady_time;
+            block_.transport = host.transport;
+            block_.out_events = host.out_events;
+            selectEvents(start, count);
+            out.setTimeOffset(out_offset, last_frame);
+            const ProcessStatus result = process_block(static_cast<const clap_process_t&>(block_));
+            status = ran ? keepRunningLongest(status, result) : result;
+            out.setTimeOffset(0);
+            ran = true;
+        };
+
+        if (mode_ == FixedBlockMode::VariableTail) {
+            uint32_t base = 0;
+            do {
+                const uint32_t count = std::min(block_size_, frames - base);
+                pointIntoHost(host, base);
+                run(count, stream_position_ + base, host.steady_time >= 0 ? host.steady_time + base : -1, base);
+                base += count;
+            } while (base < frames);
+            stream_position_ += frames;
+        } else {
+            uint32_t first = 0;
+            while (first < frames) {
+                const uint32_t count = std::min(frames - first, block_size_ - fill_);
+                if (fill_ == 0) fifo_steady_time_ = host.steady_time >= 0 ? host.steady_time + first : -1;
+                exchangeWithFifos(host, first, count);
+                fill_ += count;
+                first += count;
+                stream_position_ += count;
+                if (fill_ == block_size_) {
+                    pointIntoFifos();
+                    // The block's output starts playing at the host frame after its last input
+                    run(block_size_, stream_position_ - block_size_, fifo_steady_time_, first);
+                    fill_ = 0;
+                }
+            }
+            if (!ran) status = last_status_;
+        }
+        last_status_ = status;
+        compactEvents();
+        return status;
+    }
+
+    /** Of two block statuses, the one that keeps the plugin running the longest; Error wins over everything. */
+    [[nodiscard]] static ProcessStatus keepRunningLongest(ProcessStatus a, ProcessStatus b) noexcept;
+
+private:
+    struct Port {
+        uint32_t channels = 0;
+        bool fifo_is_double = false;
+        std::vector<float*> data32;
+        std::vector<double*> data64;
+        std::vector<float> fifo32;   // [channel][frame], Latency mode only; in whichever format the host supplies,
+        std::vector<double> fifo64;  // fifo_is_double
+    };
+
+    struct PendingEvent {
+        uint64_t position;  // In frames since configure() or reset(), on the input side
+        uint32_t offset;    // Into event_storage_
+    };
+
+    static std::span<clap_audio_buffer_t> hostOutputs(const clap_process_t& host) noexcept {
+        if (!host.audio_outputs) return {};
+        return {host.audio_outputs, host.audio_outputs_count};
+    }
+
+    void ingestEvents(const EventRouter& events, uint32_t last_frame) noexcept;
+    void selectEvents(uint64_t start, uint32_t count) noexcept;
+    void compactEvents() noexcept;
+    void pointIntoHost(const clap_process_t& host, uint32_t offset) noexcept;
+    void exchangeWithFifos(const clap_process_t& host, uint32_t first, uint32_t count) noexcept;
+    void pointIntoFifos() noexcept;
+
+    static uint32_t listSize(const clap_input_events_t* list) noexcept;
+    static const clap_event_header_t* listGet(const clap_input_events_t* list, uint32_t index) noexcept;
+
+    uint32_t block_size_ = 0;
+    FixedBlockMode mode_ = FixedBlockMode::VariableTail;
+
+    std::vector<Port> inputs_;
+    std::vector<Port> outputs_;
+    std::vector<clap_audio_buffer_t> input_buffers_;
+    std::vector<clap_audio_buffer_t> output_buffers_;
+    clap_process_t block_{};
+
+    uint64_t stream_position_ = 0;  // Frames taken from the host so far
+    uint32_t fill_ = 0;             // Latency mode: frames of the current block already in the FIFOs
+    int64_t fifo_steady_time_ = -1;
+    ProcessStatus last_status_ = ProcessStatus::Continue;
+
+    std::unique_ptr<std::byte[]> event_storage_;
+    size_t event_bytes_ = 0;
+    size_t used_event_bytes_ = 0;
+    std::vector<PendingEvent> pending_;  // Sized once; the first num_pending_ are in use, sorted by position
+    size_t num_pending_ = 0;
+    size_t next_pending_ = 0;  // The first not yet handed to a block
+    size_t block_first_ = 0;   // The current block's events: [block_first_, next_pending_)
+    uint64_t dropped_events_ = 0;
+    clap_input_events_t list_{};
+};
+
+}  // namespace applause
@@ -1,13 +1,106 @@
 #include "ModMatrix.h"
 
+#include <applause/dsp/simd/Kernels.h>
+
+#include <array>
+#include <bit>
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+
+#include <xsimd/xsimd.hpp>
 
 namespace applause {
 
-static inline float applyConnectionPolarity(float src_val, bool src_bipolar, bool bipolar_mapping) {
-    if (src_bipolar)     src_val = (src_val + 1.0f) * 0.5f;  // [-1,+1] -> [0,1]
-    if (bipolar_mapping) src_val -= 0.5f;                    // [0,1]   -> [-0.5,+0.5]
-    return src_val;                                          // unipolar path: [0,1] unchanged
+namespace {
+
+using LaneBatch = xsimd::batch<float>;
+constexpr uint32_t kLaneWidth = static_cast<uint32_t>(LaneBatch::size);
+
+uint32_t roundUpToLanes(uint32_t n) {
+    return (n + kLaneWidth - 1) / kLaneWidth * kLaneWidth;
+}
+
+}  // namespace
+
+template <typename T>
+static inline T applyConnectionPolarity(T src_val, bool src_bipolar, bool bipolar_mapping) {
+    if (src_bipolar)     src_val = (src_val + T(1.0f)) * T(0.5f);  // [-1,+1] -> [0,1]
+    if (bipolar_mapping) src_val -= T(0.5f);                       // [0,1]   -> [-0.5,+0.5]
+    return src_val;                                                // unipolar path: [0,1] unchanged
+}
+
+ModMatrix::ModMatrix(Config config) : ModMatrix(config, nullptr) {}
+
+ModMatrix::ModMatrix(Config config, MemoryArena& arena) : ModMatrix(config, &arena) {}
+
+ModMatrix::ModMatrix(Config config, MemoryArena* arena) :
+    config_(config),
+    lane_stride_(config.voice_layout == ModVoiceLayout::VoiceLanes ? roundUpToLanes(config.num_voices) : 0),
+    poly_src_stride_(lane_stride_ ? 1 : config.max_sources),
+    poly_dst_stride_(lane_stride_ ? 1 : config.max_destinations),
+    poly_depth_stride_(lane_stride_ ? 1 : config.max_connections),
+    poly_src_index_stride_(lane_stride_ ? lane_stride_ : 1),
+    poly_dst_index_stride_(lane_stride_ ? lane_stride_ : 1),
+    poly_depth_index_stride_(lane_stride_ ? lane_stride_ : 1),
+    program_(*this, config.max_connections, config.max_destinations),
+    snapshots_{ModProgram(*this, config.max_connections, config.max_destinations), ModProgram(*this, config.max_connections, config.max_destinations),
+               ModProgram(*this, config.max_connections, config.max_destinations)},
+    ui_snapshots_{ModUiSnapshot(config.num_voices, config.max_destinations),
+                  ModUiSnapshot(config.num_voices, config.max_destinations),
+                  ModUiSnapshot(config.num_voices, config.max_destinations)},
+    src_registry_(config.max_sources),
+    dst_registry_(config.max_destinations),
+    dst_scale_info_(config.max_destinations) {
+    if (arena) {
+        carveBuffers(*arena);
+    } else {
+        owned_storage_.resize(requiredArenaBytes(config));
+        MemoryArena owned(owned_storage_.data(), owned_storage_.size());
+        carveBuffers(owned);
+    }
+    fresh_voices_.reserve(config.num_voices);
+    if (config.smooth_outputs) {
+        smoothing_ms_.assign(config.max_destinations, 0.0f);
+        std::ranges::fill(smooth_coeff_, 1.0f);
+    }
+    param_scaler_.reserve(config.max_destinations);
+    if (config.host_modulation) {
+        host_mod_dsts_.reserve(config.max_destinations);
+        host_mod_flags_.assign(config.max_destinations, 0);
+    }
+    active_voices_.reserve(config.num_voices);
+    voice_pos_.assign(config.num_voices, kNoPos);
+    active_mask_.assign((config.num_voices + 63) / 64, 0);
+    voice_order_.reserve(config.num_voices);
+    ui_last_mono_.assign(config.max_destinations, 0.0f);
+    ui_last_poly_.assign(static_cast<size_t>(config.num_voices) * config.max_destinations, 0.0f);
+    ui_last_voices_.reserve(config.num_voices);
+    ui_dst_versions_.assign(config.max_destinations, 0);
+    voice_stamp_.assign(config.num_voices, 0);
+    pending_changes_.reserve(config.max_connections);
+    connections_.reserve(config.max_connections);
+    conn_index_.reserve(config.max_connections);
+    slot_pos_.assign(config.max_connections, kNoPos);
+    src_adj_.resize(config.max_sources);
+    dst_adj_.resize(config.max_destinations);
+    dm_adj_.resize(config.max_connections);
+}
+
+void ModMatrix::carveBuffers(MemoryArena& arena) {
+    const std::array<std::span<float>*, kNumArenaBuffers> buffers = {
+        &base_plain_dst_, &base_mono_dst_, &mono_dst_,      &mono_depth_buf_, &mono_src_buf_,
+        &lane_active_,    &poly_src_buf_,  &base_poly_dst_, &poly_depth_buf_, &poly_dst_acc_,
+        &poly_dst_buf_,   &prev_mono_dst_, &prev_poly_dst_buf_, &smooth_coeff_, &smooth_mono_state_,
+        &smooth_poly_state_, &host_poly_mod_,
+    };
+    const auto lengths = arenaBufferLengths(config_);
+    for (size_t i = 0; i < kNumArenaBuffers; ++i) {
+        *buffers[i] = arena.makeSpan<float>(lengths[i]);
+        ASSERT(buffers[i]->data() != nullptr, "Arena too small for ModMatrix buffers; see requiredArenaBytes()");
+        std::ranges::fill(*buffers[i], 0.0f);
+    }
 }
 
 ModSource& ModMatrix::registerSource(const std::string& string_id, ModSrcType type, bool bipolar,
@@ -35,12 +128,18 @@ void ModMatrix::setSourceMode(uint16_t srcIdx, ModSrcMode mode) {
     ASSERT(src_registry_[srcIdx].type == ModSrcType::Both,
            "setSourceMode only valid for sources with ModSrcType::Both");
     src_registry_[srcIdx].mode = mode;
-    recompileProgram();
+    for (const uint16_t slot : src_adj_[srcIdx]) {
+        const ModConnection& c = *connectionAt(slot);
+        patchProgram(c);
+        recordChange(ModConnectionChange::Kind::Rerouted, c);
+    }
+    commitEdit(true);
 }
 
 ModDestination& ModMatrix::registerDestination(const std::string& string_id, ModDstMode mode,
-                                               applause::ValueScaleInfo scale_info) {
+                                               applause::ValueScaleInfo scale_info, float smoothing_ms) {
     ASSERT(dst_count_ < config_.max_destinations, "max_destinations exceeded");
+    ASSERT(smoothing_ms <= 0.0f || config_.smooth_outputs, "Destination smoothing requires Config::smooth_outputs");
     ASSERT(!dst_lookup_.contains(string_id), "Destination name already registered");
 
     const auto idx = static_cast<uint16_t>(dst_count_++);
@@ -52,6 +151,15 @@ ModDestination& ModMatrix::registerDestination(const std::string& string_id, Mod
     d.mode = mode;
     d.matrix = this;
     dst_scale_info_[idx] = scale_info;
+    // Until something writes its base, an unmodulated destination outputs its minimum rather than 0, which may be
+    // out of range
+    base_mono_dst_[idx] = base_poly_dst_[idx] = 0.0f;
+    base_plain_dst_[idx] = scale_info.scaling.fromNormalized(0.0f, scale_info.min, scale_info.max);
+    if (config_.smooth_outputs) {
+        smoothing_ms_[idx] = smoothing_ms;
+        updateSmoothingCoeff(idx);
+    }
+    markInputsChanged();
 
     if (mode == ModDstMode::Poly) {
         poly_dst_indices_.push_back(idx);
@@ -68,8 +176,11 @@ void ModMatrix::registerFromParamsExtension(const applause::ParamsExtension& par
     for (uint32_t i = 0; i < params.size(); ++i) {
         const auto& param = params[i];
         ModDstMode mode = param.polyphonic ? ModDstMode::Poly : ModDstMode::Mono;
-        registerDestination(param.stringId, mode, scale_array[i]);
+        registerDestination(param.stringId, mode, scale_array[i], config_.smooth_outputs ? param.smoothingMs : 0.0f);
+        param_scaler_.add(static_cast<uint16_t>(i), scale_array[i]);
     }
+    num_param_dsts_ = static_cast<uint16_t>(params.size());
+    params_ = &params_extension;
 
     // Seed base values so addConnection's smart-default resolver sees real knob positions
     // before the first process() block runs. Steady-state freshness continues to come from
@@ -77,6 +188,25 @@ void ModMatrix::registerFromParamsExtension(const applause::ParamsExtension& par
     loadParamBaseValues(params_extension);
 }
 
+void ModMatrix::setBlockRate(double sample_rate, uint32_t block_size) {
+    ASSERT(sample_rate > 0.0 && block_size > 0, "Invalid block rate");
+    block_rate_ = sample_rate / static_cast<double>(block_size);
+    if (!config_.smooth_outputs) return;
+    for (uint16_t i = 0; i < dst_count_; ++i) updateSmoothingCoeff(i);
+    markInputsChanged();
+}
+
+void ModMatrix::updateSmoothingCoeff(uint16_t dstIdx) {
+    const float ms = smoothing_ms_[dstIdx];
+    if (ms <= 0.0f || block_rate_ <= 0.0) {
+        smooth_coeff_[dstIdx] = 1.0f;
+    } else {
+        // One-pole step per block reaching 1 - 1/e of a step change after ms milliseconds
+        smooth_coeff_[dstIdx] = static_cast<float>(1.0 - std::exp(-1000.0 / (static_cast<double>(ms) * block_rate_)));
+    }
+    smoothing_active_ = std::ranges::any_of(smooth_coeff_.first(dst_count_), [](float c) { return c < 1.0f; });
+}
+
 ModConnection ModMatrix::addConnection(ModSource src, ModDestination dst, float depth,
                                        std::optional<bool> bipolar_mapping) {
     ASSERT(src.index < src_count_, "Source index out of bounds");
@@ -110,14 +240,19 @@ ModConnection ModMatrix::addConnection(ModSource src, ModDestination dst, float
     }
 
     // Check for existing parameter connection with same (src, dst)
-    for (auto& existing : connections_) {
-        if (!existing.isDepthMod() && existing.src_idx == src.index && existing.dst_idx == dst.index) {
-            program_.depth_base_[existing.depth_slot] = depth;
-            existing.flags = mapping ? (existing.flags | ModConnection::kFlagBipolar)
-                                     : (existing.flags & ~ModConnection::kFlagBipolar);
-            recompileProgram();
-            return existing;
+    if (ModConnection* found = findIndexed(false, src.index, dst.index)) {
+        auto& existing = *found;
+        program_.depth_base_[existing.depth_slot] = depth;
+        const uint8_t old_flags = existing.flags;
+        existing.flags = mapping ? (existing.flags | ModConnection::kFlagBipolar)
+                                 : (existing.flags & ~ModConnection::kFlagBipolar);
+        recordChange(ModConnectionChange::Kind::DepthChanged, existing);
+        if (existing.flags != old_flags) {
+            patchProgram(existing);
+            recordChange(ModConnectionChange::Kind::MappingChanged, existing);
         }
+        commitEdit(false);
+        return existing;
     }
 
     // No existing connection found; create new one
@@ -128,8 +263,13 @@ ModConnection ModMatrix::addConnection(ModSource src, ModDestination dst, float
     connection.flags = mapping ? ModConnection::kFlagBipolar : 0;
     connection.depth_slot = allocateDepthSlot(depth);
     connections_.push_back(connection);
+    slot_pos_[connection.depth_slot] = static_cast<uint16_t>(connections_.size() - 1);
+    indexConnection(connection);
 
-    recompileProgram();
+    const auto [b, handle] = compileConnection(connection);
+    program_.insertHandle(b, handle);
+    recordChange(ModConnectionChange::Kind::Added, connection);
+    commitEdit(true);
     return connections_.back();
 }
 
@@ -139,49 +279,59 @@ bool ModMatrix::removeConnection(uint16_t srcIdx, uint16_t dstIdx) {
 }
 
 bool ModMatrix::removeConnection(const ModConnection& connection) {
-    auto it = std::ranges::find_if(
-        connections_, [&](const ModConnection& c) { return c.depth_slot == connection.depth_slot; });
-    if (it == connections_.end()) return false;
+    if (!removeConnectionImpl(connection)) return false;
+    commitEdit(true);
+    return true;
+}
 
-    const uint16_t freed_slot = it->depth_slot;
-    const bool was_param_conn = !it->isDepthMod();
-    program_.depth_active_[freed_slot] = 0;
-    connections_.erase(it);
+bool ModMatrix::removeConnectionImpl(const ModConnection& connection) {
+    const ModConnection* found = connectionAt(connection.depth_slot);
+    if (!found) return false;
+
+    const ModConnection removed = *found;
+    size_t first_pos = slot_pos_[removed.depth_slot];
+    tombstoneConnection(removed);
 
     // Cascade: removing a parameter connection must also remove any depth mods targeting its
     // slot. allocateDepthSlot reuses tombstoned slots, so an orphaned depth mod would silently
     // rebind to whatever new connection later reclaims freed_slot.
-    if (was_param_conn) {
-        std::erase_if(connections_, [this, freed_slot](const ModConnection& c) {
-            if (c.isDepthMod() && c.dst_idx == freed_slot) {
-                program_.depth_active_[c.depth_slot] = 0;
-                return true;
-            }
-            return false;
-        });
+    // A merge can leave such a depth mod ahead of its target in connections_, so the reindex
+    // starts at whichever tombstoned connection sits earliest.
+    if (!removed.isDepthMod()) {
+        while (!dm_adj_[removed.depth_slot].empty()) {
+            const uint16_t dm_slot = dm_adj_[removed.depth_slot].front();
+            first_pos = std::min<size_t>(first_pos, slot_pos_[dm_slot]);
+            tombstoneConnection(*connectionAt(dm_slot));
+        }
     }
-    recompileProgram();
+
+    // Tombstoned connections are exactly those whose depth slot is no longer active
+    std::erase_if(connections_, [this](const ModConnection& c) { return program_.depth_active_[c.depth_slot] == 0; });
+    reindexPositions(first_pos);
+    program_.trimFreeSlots();
     return true;
 }
 
+void ModMatrix::tombstoneConnection(const ModConnection& c) {
+    program_.depth_active_[c.depth_slot] = 0;
+    program_.eraseHandle(c.depth_slot);
+    recordChange(ModConnectionChange::Kind::Removed, c);
+    unindexConnection(c);
+    slot_pos_[c.depth_slot] = kNoPos;
+}
+
 std::optional<ModConnection> ModMatrix::findConnection(uint16_t srcIdx, uint16_t dstIdx) {
-    for (auto& conn : connections_) {
-        if (!conn.isDepthMod() && conn.src_idx == srcIdx && conn.dst_idx == dstIdx) return conn;
-    }
+    if (const auto* c = findIndexed(false, srcIdx, dstIdx)) return *c;
     return std::nullopt;
 }
 
 std::optional<ModConnection> ModMatrix::findConnection(uint16_t depthSlot) {
-    for (auto& conn : connections_) {
-        if (!conn.isDepthMod() && conn.depth_slot == depthSlot) return conn;
-    }
+    if (const auto* c = connectionAt(depthSlot); c && !c->isDepthMod()) return *c;
     return std::nullopt;
 }
 
 std::optional<ModConnection> ModMatrix::findDepthMod(uint16_t srcIdx, uint16_t targetDepthSlot) {
-    for (auto& conn : connections_) {
-        if (conn.isDepthMod() && conn.src_idx == srcIdx && conn.dst_idx == targetDepthSlot) return conn;
-    }
+    if (const auto* c = findIndexed(true, srcIdx, targetDepthSlot)) return *c;
     return std::nullopt;
 }
 
@@ -214,8 +364,8 @@ std::pair<float, float> ModMatrix::getModOffsetRange(uint16_t dstIdx) const {
 
     float min_off = 0.0f;
     float max_off = 0.0f;
-    for (const auto& conn : connections_) {
-        if (conn.isDepthMod() || conn.dst_idx != dstIdx) continue;
+    for (const uint16_t slot : dst_adj_[dstIdx]) {
+        const ModConnection& conn = *connectionAt(slot);
         const float d = program_.depth_base_[conn.depth_slot];
         const float a = d < 0.0f ? -d : d;
         if (conn.isBipolar()) {
@@ -241,14 +391,19 @@ ModConnection ModMatrix::addDepthModulation(ModSource src, const ModConnection&
     const uint16_t target_slot = target_conn.depth_slot;
 
     // Check for existing depth-mod connection with same (src, target_slot)
-    for (auto& existing : connections_) {
-        if (existing.isDepthMod() && existing.src_idx == src.index && existing.dst_idx == target_slot) {
-            program_.depth_base_[existing.depth_slot] = depth;
-            existing.flags = mapping ? (existing.flags | ModConnection::kFlagBipolar)
-                                     : (existing.flags & ~ModConnection::kFlagBipolar);
-            recompileProgram();
-            return existing;
+    if (ModConnection* found = findIndexed(true, src.index, target_slot)) {
+        auto& existing = *found;
+        program_.depth_base_[existing.depth_slot] = depth;
+        const uint8_t old_flags = existing.flags;
+        existing.flags = mapping ? (existing.flags | ModConnection::kFlagBipolar)
+                                 : (existing.flags & ~ModConnection::kFlagBipolar);
+        recordChange(ModConnectionChange::Kind::DepthChanged, existing);
+        if (existing.flags != old_flags) {
+            patchProgram(existing);
+            recordChange(ModConnectionChange::Kind::MappingChanged, existing);
         }
+        commitEdit(false);
+        return existing;
     }
 
     // Depth mod connections now allocate a depth slot for their own depth, even though it is impossible for a
@@ -262,84 +417,374 @@ ModConnection ModMatrix::addDepthModulation(ModSource src, const ModConnection&
     connection.flags = ModConnection::kFlagDepthMod | (mapping ? ModConnection::kFlagBipolar : 0);
     connection.depth_slot = allocateDepthSlot(depth);
     connections_.push_back(connection);
+    slot_pos_[connection.depth_slot] = static_cast<uint16_t>(connections_.size() - 1);
+    indexConnection(connection);
 
-    recompileProgram();
+    const auto [b, handle] = compileConnection(connection);
+    program_.insertHandle(b, handle);
+    recordChange(ModConnectionChange::Kind::Added, connection);
+    commitEdit(true);
     return connections_.back();
 }
 
 ModConnection ModMatrix::reassignSource(const ModConnection& conn, ModSource newSrc) {
     ASSERT(newSrc.index < src_count_, "Source index out of bounds");
-    auto it = std::ranges::find_if(
-        connections_, [&](const ModConnection& c) { return c.depth_slot == conn.depth_slot; });
-    ASSERT(it != connections_.end(), "Connection not found");
+    ModConnection* it = connectionAt(conn.depth_slot);
+    ASSERT(it != nullptr, "Connection not found");
     if (it->src_idx == newSrc.index) return *it;
 
     // Merge: if a peer connection with (newSrc, dst, same kind) already exists, copy this
     // conn's depth/flags onto it, transfer this conn's depth mods to it (peer-wins on
     // conflict), then remove this conn.
-    for (auto& existing : connections_) {
-        if (existing.depth_slot == it->depth_slot) continue;
-        if (existing.isDepthMod() == it->isDepthMod() && existing.src_idx == newSrc.index
-            && existing.dst_idx == it->dst_idx) {
-            program_.depth_base_[existing.depth_slot] = program_.depth_base_[it->depth_slot];
-            existing.flags = it->flags;
-            const uint16_t old_slot = it->depth_slot;
-            const uint16_t new_slot = existing.depth_slot;
-            for (auto& dm : connections_) {
-                if (!dm.isDepthMod() || dm.dst_idx != old_slot) continue;
-                const bool peer_has_conflict = std::ranges::any_of(connections_, [&](const ModConnection& c) {
-                    return c.isDepthMod() && c.src_idx == dm.src_idx && c.dst_idx == new_slot;
-                });
-                if (!peer_has_conflict) dm.dst_idx = new_slot;
-            }
-            const ModConnection peer_copy = existing;
-            removeConnection(*it);
-            return peer_copy;
-        }
+    if (ModConnection* peer = findIndexed(it->isDepthMod(), newSrc.index, it->dst_idx)) {
+        return mergeInto(*it, *peer);
     }
+
+    unindexConnection(*it);
     it->src_idx = newSrc.index;
-    recompileProgram();
+    indexConnection(*it);
+    patchProgram(*it);
+    recordChange(ModConnectionChange::Kind::Rerouted, *it);
+    commitEdit(true);
     return *it;
 }
 
 ModConnection ModMatrix::reassignDestination(const ModConnection& conn, ModDestination newDst) {
     ASSERT(!conn.isDepthMod(), "reassignDestination not valid for depth-mod connections");
     ASSERT(newDst.index < dst_count_, "Destination index out of bounds");
-    auto it = std::ranges::find_if(
-        connections_, [&](const ModConnection& c) { return c.depth_slot == conn.depth_slot; });
-    ASSERT(it != connections_.end(), "Connection not found");
+    ModConnection* it = connectionAt(conn.depth_slot);
+    ASSERT(it != nullptr, "Connection not found");
     if (it->dst_idx == newDst.index) return *it;
 
-    for (auto& existing : connections_) {
-        if (existing.depth_slot == it->depth_slot) continue;
-        if (!existing.isDepthMod() && existing.src_idx == it->src_idx
-            && existing.dst_idx == newDst.index) {
-            program_.depth_base_[existing.depth_slot] = program_.depth_base_[it->depth_slot];
-            existing.flags = it->flags;
-            const uint16_t old_slot = it->depth_slot;
-            const uint16_t new_slot = existing.depth_slot;
-            for (auto& dm : connections_) {
-                if (!dm.isDepthMod() || dm.dst_idx != old_slot) continue;
-                const bool peer_has_conflict = std::ranges::any_of(connections_, [&](const ModConnection& c) {
-                    return c.isDepthMod() && c.src_idx == dm.src_idx && c.dst_idx == new_slot;
-                });
-                if (!peer_has_conflict) dm.dst_idx = new_slot;
-            }
-            const ModConnection peer_copy = existing;
-            removeConnection(*it);
-            return peer_copy;
-        }
+    if (ModConnection* peer = findIndexed(false, it->src_idx, newDst.index)) {
+        return mergeInto(*it, *peer);
     }
+
+    // Record the pre-move state too, so listeners on the old destination also see the change
+    recordChange(ModConnectionChange::Kind::Rerouted, *it);
+    unindexConnection(*it);
     it->dst_idx = newDst.index;
-    recompileProgram();
+    indexConnection(*it);
+    patchProgram(*it);
+    recordChange(ModConnectionChange::Kind::Rerouted, *it);
+    commitEdit(true);
     return *it;
 }
 
+ModConnection ModMatrix::mergeInto(ModConnection& moving, ModConnection& peer) {
+    program_.depth_base_[peer.depth_slot] = program_.depth_base_[moving.depth_slot];
+    peer.flags = moving.flags;
+    patchProgram(peer);
+
+    // Transfer the moving connection's depth mods unless the peer already has one from the same source
+    const uint16_t old_slot = moving.depth_slot;
+    const uint16_t new_slot = peer.depth_slot;
+    const std::vector<uint16_t> depth_mods = dm_adj_[old_slot];
+    for (const uint16_t dm_slot : depth_mods) {
+        ModConnection& dm = *connectionAt(dm_slot);
+        if (findIndexed(true, dm.src_idx, new_slot)) continue;
+        unindexConnection(dm);
+        dm.dst_idx = new_slot;
+        indexConnection(dm);
+        patchProgram(dm);
+        recordChange(ModConnectionChange::Kind::Rerouted, dm);
+    }
+
+    const ModConnection peer_copy = peer;
+    removeConnectionImpl(moving);  // also drops the conflicting depth mods still attached to old_slot
+    recordChange(ModConnectionChange::Kind::Rerouted, peer_copy);
+    commitEdit(true);
+    return peer_copy;
+}
+
+namespace {
+
+// Routing blob layout: RoutingHeader, then num_records RoutingRecords, then the name table of num_sources source
+// entries followed by num_destinations destination entries. Each name entry is a uint16_t length, a uint8_t
+// (source mode; 0 for destinations) and the id's bytes. Records are fixed-size and copied out as-is; only the
+// name table needs walking.
+constexpr uint32_t kRoutingMagic = 0x544D5241;  // "ARMT"
+constexpr uint16_t kRoutingVersion = 1;
+
+struct RoutingHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t num_records;
+    uint16_t num_sources;
+    uint16_t num_destinations;
+    uint32_t names_bytes;
+};
+
+struct RoutingRecord {
+    uint16_t depth_slot;
+    uint16_t src;  // index into the blob's source names
+    uint16_t dst;  // index into the blob's destination names, or the target depth slot for depth mods
+    uint8_t flags;  // ModConnection::kFlag*
+    uint8_t reduction;
+    float depth;
+};
+
+static_assert(sizeof(RoutingHeader) == 16 && sizeof(RoutingRecord) == 12, "Routing blob structs must be packed");
+static_assert(std::endian::native == std::endian::little, "Routing blobs assume a little-endian host");
+
+template <typename T>
+void appendBytes(std::vector<std::byte>& out, const T& value) {
+    const auto* p = reinterpret_cast<const std::byte*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+}  // namespace
+
+std::vector<std::byte> ModMatrix::saveRouting() const {
+    // Only sources and destinations that appear in a connection go into the name table
+    constexpr uint16_t kUnused = 0xFFFF;
+    std::vector<uint16_t> src_ids(src_count_, kUnused);
+    std::vector<uint16_t> dst_ids(dst_count_, kUnused);
+    std::vector<uint16_t> srcs;
+    std::vector<uint16_t> dsts;
+    for (const auto& c : connections_) {
+        if (src_ids[c.src_idx] == kUnused) {
+            src_ids[c.src_idx] = static_cast<uint16_t>(srcs.size());
+            srcs.push_back(c.src_idx);
+        }
+        if (!c.isDepthMod() && dst_ids[c.dst_idx] == kUnused) {
+            dst_ids[c.dst_idx] = static_cast<uint16_t>(dsts.size());
+            dsts.push_back(c.dst_idx);
+        }
+    }
+
+    std::vector<std::byte> names;
+    const auto appendName = [&names](const std::string& name, uint8_t mode) {
+        ASSERT(name.size() <= 0xFFFF, "Mod source/destination id too long to serialize");
+        appendBytes(names, static_cast<uint16_t>(name.size()));
+        appendBytes(names, mode);
+        const auto* p = reinterpret_cast<const std::byte*>(name.data());
+        names.insert(names.end(), p, p + name.size());
+    };
+    for (const uint16_t i : srcs) appendName(src_registry_[i].name, static_cast<uint8_t>(src_registry_[i].mode));
+    for (const uint16_t i : dsts) appendName(dst_registry_[i].name, 0);
+
+    const RoutingHeader header{kRoutingMagic,
+                               kRoutingVersion,
+                               static_cast<uint16_t>(connections_.size()),
+                               static_cast<uint16_t>(srcs.size()),
+                               static_cast<uint16_t>(dsts.size()),
+                               static_cast<uint32_t>(names.size())};
+
+    std::vector<std::byte> out;
+    out.reserve(sizeof(RoutingHeader) + connections_.size() * sizeof(RoutingRecord) + names.size());
+    appendBytes(out, header);
+    for (const auto& c : connections_) {
+        const RoutingRecord record{c.depth_slot,
+                                   src_ids[c.src_idx],
+                                   c.isDepthMod() ? c.dst_idx : dst_ids[c.dst_idx],
+                                   c.flags,
+                                   static_cast<uint8_t>(c.reduction),
+                                   program_.depth_base_[c.depth_slot]};
+        appendBytes(out, record);
+    }
+    out.insert(out.end(), names.begin(), names.end());
+    return out;
+}
+
+bool ModMatrix::loadRouting(std::span<const std::byte> data) {
+    RoutingHeader header;
+    if (data.size() < sizeof(header)) return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+    const size_t records_bytes = size_t{header.num_records} * sizeof(RoutingRecord);
+    if (header.magic != kRoutingMagic || header.version != kRoutingVersion ||
+        header.num_records > config_.max_connections ||
+        data.size() != sizeof(header) + records_bytes + header.names_bytes) {
+        return false;
+    }
+
+    // Resolve the name table to registry indices (kNoPos for ids this matrix doesn't have)
+    std::span<const std::byte> names = data.subspan(sizeof(header) + records_bytes);
+    const auto readName = [&names](std::string_view& name, uint8_t& mode) {
+        uint16_t len;
+        if (names.size() < sizeof(len) + sizeof(mode)) return false;
+        std::memcpy(&len, names.data(), sizeof(len));
+        std::memcpy(&mode, names.data() + sizeof(len), sizeof(mode));
+        names = names.subspan(sizeof(len) + sizeof(mode));
+        if (names.size() < len) return false;
+        name = {reinterpret_cast<const char*>(names.data()), len};
+        names = names.subspan(len);
+        return true;
+    };
+
+    std::vector<uint16_t> src_map(header.num_sources, kNoPos);
+    std::vector<uint8_t> src_modes(header.num_sources, 0);
+    for (size_t i = 0; i < src_map.size(); ++i) {
+        std::string_view name;
+        if (!readName(name, src_modes[i])) return false;
+        if (const auto it = src_lookup_.find(std::string(name)); it != src_lookup_.end()) {
+            src_map[i] = it->second;
+        } else {
+            LOG_WARN("Dropping routing for unknown mod source '{}'", name);
+        }
+    }
+    std::vector<uint16_t> dst_map(header.num_destinations, kNoPos);
+    for (auto& idx : dst_map) {
+        std::string_view name;
+        uint8_t unused_mode;
+        if (!readName(name, unused_mode)) return false;
+        if (const auto it = dst_lookup_.find(std::string(name)); it != dst_lookup_.end()) {
+            idx = it->second;
+        } else {
+            LOG_WARN("Dropping routing for unknown mod destination '{}'", name);
+        }
+    }
+    if (!names.empty()) return false;
+
+    // Validate every record before touching the current routing
+    std::vector<RoutingRecord> records(header.num_records);
+    if (records_bytes) std::memcpy(records.data(), data.data() + sizeof(header), records_bytes);
+    std::vector<uint8_t> slot_kind(config_.max_connections, 0);  // 0 unused, 1 param connection, 2 depth mod
+    for (const auto& r : records) {
+        const bool depth_mod = r.flags & ModConnection::kFlagDepthMod;
+        if (r.depth_slot >= config_.max_connections || slot_kind[r.depth_slot] != 0) return false;
+        if (r.src >= header.num_sources || r.reduction > static_cast<uint8_t>(ModReduction::LastVoice)) return false;
+        if (!depth_mod && r.dst >= header.num_destinations) return false;
+        slot_kind[r.depth_slot] = depth_mod ? 2 : 1;
+    }
+    for (const auto& r : records) {
+        if ((r.flags & ModConnection::kFlagDepthMod) && (r.dst >= config_.max_connections || slot_kind[r.dst] != 1)) {
+            return false;
+        }
+    }
+
+    // A param connection survives if both ends resolved; a depth mod if its source and its target survive
+    std::vector<uint8_t> keep(config_.max_connections, 0);
+    for (const auto& r : records) {
+        if (!(r.flags & ModConnection::kFlagDepthMod)) {
+            keep[r.depth_slot] = src_map[r.src] != kNoPos && dst_map[r.dst] != kNoPos;
+        }
+    }
+    for (const auto& r : records) {
+        if (r.flags & ModConnection::kFlagDepthMod) keep[r.depth_slot] = src_map[r.src] != kNoPos && keep[r.dst];
+    }
+
+    // Two surviving connections between the same ends would alias in conn_index_
+    std::unordered_set<uint64_t> keys;
+    for (const auto& r : records) {
+        if (!keep[r.depth_slot]) continue;
+        const bool depth_mod = r.flags & ModConnection::kFlagDepthMod;
+        if (!keys.insert(connectionKey(depth_mod, src_map[r.src], depth_mod ? r.dst : dst_map[r.dst])).second) {
+            return false;
+        }
+    }
+
+    for (const auto& c : connections_) recordChange(ModConnectionChange::Kind::Removed, c);
+    connections_.clear();
+    conn_index_.clear();
+    std::ranges::fill(slot_pos_, kNoPos);
+    for (auto& adj : src_adj_) adj.clear();
+    for (auto& adj : dst_adj_) adj.clear();
+    for (auto& adj : dm_adj_) adj.clear();
+    program_.clearConnections();
+
+    for (size_t i = 0; i < src_map.size(); ++i) {
+        if (src_map[i] != kNoPos && src_registry_[src_map[i]].type == ModSrcType::Both) {
+            src_registry_[src_map[i]].mode = static_cast<ModSrcMode>(src_modes[i]);
+        }
+    }
+
+    // Depth values go straight into their saved slots; slots left unused stay free for later edits
+    uint16_t num_slots = 0;
+    for (const auto& r : records) {
+        if (keep[r.depth_slot]) num_slots = std::max<uint16_t>(num_slots, r.depth_slot + 1);
+    }
+    program_.depth_base_.assign(num_slots, 0.0f);
+    program_.depth_active_.assign(num_slots, 0);
+
+    for (const auto& r : records) {
+        if (!keep[r.depth_slot]) continue;
+        ModConnection connection{};
+        connection.matrix_ = this;
+        connection.src_idx = src_map[r.src];
+        connection.dst_idx = (r.flags & ModConnection::kFlagDepthMod) ? r.dst : dst_map[r.dst];
+        connection.depth_slot = r.depth_slot;
+        connection.flags = r.flags & (ModConnection::kFlagDepthMod | ModConnection::kFlagBipolar);
+        connection.reduction = static_cast<ModReduction>(r.reduction);
+        program_.depth_base_[r.depth_slot] = r.depth;
+        program_.depth_active_[r.depth_slot] = 1;
+        connections_.push_back(connection);
+        slot_pos_[connection.depth_slot] = static_cast<uint16_t>(connections_.size() - 1);
+        indexConnection(connection);
+
+        const auto [b, handle] = compileConnection(connection);
+        program_.insertHandle(b, handle);
+        recordChange(ModConnectionChange::Kind::Added, connection);
+    }
+
+    commitEdit(true);
+    return true;
+}
+
 void ModMatrix::notifyVoiceOn(uint16_t voice_index) {
     ASSERT(voice_index < config_.num_voices, "voice_index out of bounds");
-    if (std::ranges::find(active_voices_, voice_index) == active_voices_.end()) {
-        active_voices_.push_back(voice_index);
+    // A retrigger of an active voice only refreshes its trigger order, which LastVoice reductions depend on
+    voice_stamp_[voice_index] = ++next_voice_stamp_;
+    markInputsChanged();
+    // A new note starts without the previous note's host modulation
+    for (const uint16_t dst : host_mod_dsts_) host_poly_mod_[polyDstOffset(voice_index, dst)] = 0.0f;
+    if (voice_pos_[voice_index] != kNoPos) return;
+
+    voice_pos_[voice_index] = static_cast<uint16_t>(active_voices_.size());
+    active_voices_.push_back(voice_index);
+    active_mask_[voice_index / 64] |= uint64_t{1} << (voice_index % 64);
+    fresh_voices_.push_back(voice_index);
+}
+
+void ModMatrix::notifyVoiceOff(uint16_t voice_index) {
+    ASSERT(voice_index < config_.num_voices, "voice_index out of bounds");
+    const uint16_t pos = voice_pos_[voice_index];
+    if (pos == kNoPos) return;
+
+    // Swap-remove: the last active voice takes over the freed position
+    const uint16_t moved = active_voices_.back();
+    active_voices_[pos] = moved;
+    voice_pos_[moved] = pos;
+    active_voices_.pop_back();
+    voice_pos_[voice_index] = kNoPos;
+    active_mask_[voice_index / 64] &= ~(uint64_t{1} << (voice_index % 64));
+
+    // Only holds voices triggered since the last computed block, so this stays short
+    std::erase(fresh_voices_, voice_index);
+    markInputsChanged();
+}
+
+void ModMatrix::rebuildVoiceOrder() {
+    voice_order_.clear();
+    for (size_t word = 0; word < active_mask_.size(); ++word) {
+        for (uint64_t bits = active_mask_[word]; bits != 0; bits &= bits - 1) {
+            voice_order_.push_back(static_cast<uint16_t>(word * 64 + std::countr_zero(bits)));
+        }
+    }
+}
+
+void ModMatrix::setHostPolyModulation(uint16_t dstIdx, uint16_t voice, float amount) {
+    ASSERT(config_.host_modulation, "Host modulation requires Config::host_modulation");
+    ASSERT(dstIdx < dst_count_ && dst_registry_[dstIdx].mode == ModDstMode::Poly,
+           "Host per-note modulation needs a poly destination");
+    ASSERT(voice < config_.num_voices, "voice out of bounds");
+    if (!config_.host_modulation) return;
+
+    if (!host_mod_flags_[dstIdx]) {
+        host_mod_flags_[dstIdx] = 1;
+        host_mod_dsts_.push_back(dstIdx);
     }
+    host_poly_mod_[polyDstOffset(voice, dstIdx)] = amount;
+    markInputsChanged();
+}
+
+std::optional<uint16_t> ModMatrix::findHostModDestination(const clap_event_param_mod_t& event) const {
+    if (!config_.host_modulation || !params_) return std::nullopt;
+    if (event.note_id == -1 && event.key == -1 && event.channel == -1 && event.port_index == -1) return std::nullopt;
+
+    const uint32_t index = params_->findParamIndex(event.cookie, event.param_id);
+    if (index >= num_param_dsts_ || dst_registry_[index].mode != ModDstMode::Poly) return std::nullopt;
+    return static_cast<uint16_t>(index);
 }
 
 void ModMatrix::setBaseValue(uint16_t dstIdx, float plain_value) {
@@ -348,128 +793,477 @@ void ModMatrix::setBaseValue(uint16_t dstIdx, float plain_value) {
     float norm = s.scaling.toNormalized(plain_value, s.min, s.max);
     base_mono_dst_[dstIdx] = norm;
     base_poly_dst_[dstIdx] = norm;
+    base_plain_dst_[dstIdx] = std::clamp(plain_value, s.min, s.max);
+    markInputsChanged();
 }
 
 void ModMatrix::loadParamBaseValues(const applause::ParamsExtension& params) {
     const auto* values = params.getValuesArray();
     const auto* scales = params.getScaleInfoArray();
-
-    for (uint16_t i = 0; i < dst_count_; i++) {
-        float plain = values[i].load(std::memory_order_relaxed);
-        const auto& s = scales[i];
-        float norm = s.scaling.toNormalized(plain, s.min, s.max);
-        base_mono_dst_[i] = norm;
-        base_poly_dst_[i] = norm;
+    const auto* modulation = params.getModulationArray();
+    const auto* normalized = params.getNormalizedArray();
+    const auto plainAt = [&](uint32_t i) {
+        return std::clamp(values[i].load(std::memory_order_relaxed) + modulation[i], scales[i].min, scales[i].max);
+    };
+
+    // The first load converts every parameter to seed the normalized bases
+    if (!param_bases_seeded_) {
+        params.consumeChangedParams([](uint32_t) {});
+        for (uint16_t i = 0; i < num_param_dsts_; i++) {
+            base_plain_dst_[i] = plainAt(i);
+        }
+        param_scaler_.toNormalized(base_plain_dst_.data(), base_mono_dst_.data(), config_.scaling_precision);
+        std::copy_n(base_mono_dst_.begin(), num_param_dsts_, base_poly_dst_.begin());
+        param_bases_seeded_ = true;
+        markInputsChanged();
+        return;
     }
+
+    // After that, only the parameters written since the last load are reconverted
+    bool changed = false;
+    params.consumeChangedParams([&](uint32_t i) {
+        if (i >= num_param_dsts_) return;
+        const float plain = plainAt(i);
+        if (plain == base_plain_dst_[i]) return;
+        base_plain_dst_[i] = plain;
+        // Unmodulated parameters come with their normalized value cached
+        base_mono_dst_[i] = base_poly_dst_[i] = modulation[i] == 0.0f
+                                                    ? normalized[i].load(std::memory_order_relaxed)
+                                                    : toNormalized(scales[i], plain, config_.scaling_precision);
+        changed = true;
+    });
+    if (changed) markInputsChanged();
 }
 
 void ModMatrix::process() {
-    // Reset mono destinations to base values
-    mono_dst_ = base_mono_dst_;
+    const ModProgram* prog = beginBlock();
+    if (!prog) return;
+    processVoiceUnits(*prog, 0, voiceWorkUnits());
+    endBlock();
+}
 
-    // Reset poly destinations for active voices (only poly destinations need per-voice reset)
-    for (size_t i = 0; i < active_voices_.size(); i++) {
-        const uint16_t voice_index = active_voices_[i];
-        const size_t voice_offset = static_cast<size_t>(voice_index) * poly_dst_stride_;
-        for (uint16_t poly_idx : poly_dst_indices_) {
-            poly_dst_buf_[voice_offset + poly_idx] = base_poly_dst_[poly_idx];
+void ModMatrix::processParallel(ThreadPoolExtension& pool, uint32_t voices_per_task) {
+    ASSERT(voices_per_task > 0, "voices_per_task must be positive");
+    const ModProgram* prog = beginBlock();
+    if (!prog) return;
+
+    const uint32_t units = voiceWorkUnits();
+    // Under VoiceLanes a unit is already a batch of lanes
+    const uint32_t per_task = config_.voice_layout == ModVoiceLayout::VoiceLanes
+                                  ? std::max<uint32_t>(1, voices_per_task / kLaneWidth)
+                                  : voices_per_task;
+    const uint32_t num_tasks = (units + per_task - 1) / per_task;
+
+    bool done = false;
+    if (num_tasks > 1 && pool.hasParallelSupport()) {
+        parallel_prog_ = prog;
+        parallel_units_ = units;
+        parallel_units_per_task_ = per_task;
+        auto previous = pool.exchangeCallback([this](uint32_t task) {
+            const uint32_t first = task * parallel_units_per_task_;
+            processVoiceUnits(*parallel_prog_, first, std::min(first + parallel_units_per_task_, parallel_units_));
+        });
+        done = pool.requestExec(num_tasks);
+        pool.exchangeCallback(std::move(previous));
+        parallel_prog_ = nullptr;
+    }
+    if (!done) processVoiceUnits(*prog, 0, units);
+
+    endBlock();
+}
+
+const ModProgram* ModMatrix::beginBlock() {
+    const ModProgram& prog = acquireProgram();
+
+    if (!inputs_changed_.exchange(false, std::memory_order_acq_rel)) {
+        ++quiescent_block_count_;
+        // The outputs hold still, so the ramps flatten once the previous block's start values are overwritten
+        if (config_.ramp_outputs && !ramp_settled_) {
+            saveRampStartValues();
+            ramp_settled_ = true;
         }
+        return nullptr;
+    }
+    ramp_settled_ = false;
+    rebuildVoiceOrder();
+
+    if (config_.ramp_outputs) saveRampStartValues();
+
+    // Reset mono destinations: unmodulated ones get their final plain value, modulated ones start from the
+    // normalized base and are accumulated and rescaled below
+    std::ranges::copy(base_plain_dst_, mono_dst_.begin());
+    for (const uint16_t i : prog.modulated_mono_dsts_) {
+        mono_dst_[i] = base_mono_dst_[i];
     }
 
     // load base depth values into the mono depth buffer
-    for (size_t slot = 0; slot < program_.depth_base_.size(); ++slot) {
-        mono_depth_buf_[slot] = program_.depth_active_[slot] ? program_.depth_base_[slot] : 0.0f;
+    for (size_t slot = 0; slot < prog.depth_base_.size(); ++slot) {
+        mono_depth_buf_[slot] = prog.depth_active_[slot] ? prog.depth_base_[slot] : 0.0f;
     }
 
     // calculate mono depth modulation
-    for (const auto& mono_depth_conn : program_.depth_connections_mono_) {
+    for (const auto& mono_depth_conn : prog.depth_connections_mono_) {
         const float src_val = applyConnectionPolarity(mono_src_buf_[mono_depth_conn.src],
                                                       mono_depth_conn.isSourceBipolar(),
                                                       mono_depth_conn.isBipolar());
-        const float depth = program_.depth_base_[mono_depth_conn.depth_slot];
+        const float depth = prog.depth_base_[mono_depth_conn.depth_slot];
         mono_depth_buf_[mono_depth_conn.target] += src_val * depth;
     }
 
-    // load poly depth from mono_depth_buf_
-    for (uint16_t i = 0; i < active_voices_.size(); i++) {
-        const uint16_t voice_index = active_voices_[i];
-        for (uint16_t j = 0; j < program_.depth_base_.size(); j++) {
-            poly_depth_buf_[static_cast<size_t>(voice_index) * poly_depth_stride_ + j] = mono_depth_buf_[j];
-        }
+    // mono -> mono connections
+    // NOTE: MM and PM connections read from mono_depth_buf_, so poly depth modulation on these
+    // depth slots is silently ignored. Avoid poly depth mods on slots used by MM or PM connections.
+    for (const auto& mm_conn : prog.mm_connections) {
+        const float src_val = applyConnectionPolarity(mono_src_buf_[mm_conn.src],
+                                                      mm_conn.isSourceBipolar(), mm_conn.isBipolar());
+        const float depth_val = mono_depth_buf_[mm_conn.depth_slot];
+        mono_dst_[mm_conn.target] += src_val * depth_val;
     }
 
-    // load poly depth modulation into the poly depth buffer
-    for (uint16_t i = 0; i < active_voices_.size(); i++) {
-        uint16_t voice_index = active_voices_[i];
-        for (const auto& poly_depth_conn : program_.depth_connections_poly_) {
-            const float src_val = applyConnectionPolarity(
-                poly_src_buf_[static_cast<size_t>(voice_index) * poly_src_stride_ + poly_depth_conn.src],
-                poly_depth_conn.isSourceBipolar(), poly_depth_conn.isBipolar());
-            const float depth = program_.depth_base_[poly_depth_conn.depth_slot];
-            poly_depth_buf_[static_cast<size_t>(voice_index) * poly_depth_stride_ + poly_depth_conn.target] +=
-                src_val * depth;
+    // poly -> mono connections: reduce the source across active voices, then map it like a mono source
+    if (config_.voice_layout == ModVoiceLayout::VoiceLanes) updateLaneMask();
+    if (!voice_order_.empty()) {
+        for (const auto& pm_conn : prog.pm_connections) {
+            const float src_val = applyConnectionPolarity(reducePolySource(pm_conn.src, pm_conn.reduction),
+                                                          pm_conn.isSourceBipolar(), pm_conn.isBipolar());
+            mono_dst_[pm_conn.target] += src_val * mono_depth_buf_[pm_conn.depth_slot];
         }
     }
 
-    // now that the modulation depth pass is done, we can calculate final modulation values
-    // first, mono -> mono connections
-    // NOTE: MM connections read from mono_depth_buf_, so poly depth modulation on these
-    // depth slots is silently ignored. This is analogous to PM connections (NYI) - both
-    // require a reduction policy to collapse per-voice values to mono. Until implemented,
-    // avoid poly depth mods on slots used by MM connections.
-    for (const auto& mm_conn : program_.mm_connections) {
-        const float src_val = applyConnectionPolarity(mono_src_buf_[mm_conn.src],
-                                                      mm_conn.isSourceBipolar(), mm_conn.isBipolar());
-        const float depth_val = mono_depth_buf_[mm_conn.depth_slot];
-        mono_dst_[mm_conn.target] += src_val * depth_val;
+    // Scale modulated mono destinations: normalized -> true-value
+    prog.mono_scaler_.fromNormalized(mono_dst_.data(), mono_dst_.data(), config_.scaling_precision);
+    return &prog;
+}
+
+uint32_t ModMatrix::voiceWorkUnits() const {
+    if (config_.voice_layout == ModVoiceLayout::VoiceLanes) return (lane_end_ - lane_begin_) / kLaneWidth;
+    return static_cast<uint32_t>(voice_order_.size());
+}
+
+void ModMatrix::processVoiceUnits(const ModProgram& prog, uint32_t first, uint32_t last) {
+    // Per-voice passes: reset, poly depth, MP and PP connections, and per-voice scaling
+    if (first >= last) return;
+    if (config_.voice_layout == ModVoiceLayout::VoiceLanes) {
+        processVoiceLanes(prog, lane_begin_ + first * kLaneWidth, lane_begin_ + last * kLaneWidth);
+    } else {
+        processVoiceRows(prog, first, last);
+    }
+}
+
+void ModMatrix::endBlock() {
+    // Keep processing while any smoother is still moving, even if no input changes
+    if (smoothing_active_ && !smoothOutputs()) markInputsChanged();
+    if (config_.ramp_outputs) snapFreshRamps();
+    fresh_voices_.clear();
+    publishUiSnapshot();
+}
+
+namespace {
+
+// One smoothing step toward target; a coefficient of 1 (unsmoothed) or a step within 1e-6 (relative) of the
+// target lands exactly on it. Returns the mask of values that are still moving.
+template <typename S>
+auto smoothStep(S& state, S target, S coeff) {
+    const S next = applause::fma(coeff, target - state, state);
+    if constexpr (SimdBatch<S>) {
+        const auto close = xsimd::abs(target - next) <= xsimd::fma(S(1e-6f), xsimd::abs(target), S(1e-9f));
+        const auto settled = (coeff >= S(1.0f)) | close;
+        state = xsimd::select(settled, target, next);
+        return !settled;
+    } else {
+        const bool settled = coeff >= 1.0f || std::abs(target - next) <= 1e-6f * std::abs(target) + 1e-9f;
+        state = settled ? target : next;
+        return !settled;
     }
+}
+
+}  // namespace
+
+bool ModMatrix::smoothOutputs() {
+    const uint32_t n = static_cast<uint32_t>(dst_count_);
+    bool settled = true;
 
-    // mono -> poly connections
-    for (uint16_t i = 0; i < active_voices_.size(); i++) {
-        uint16_t voice_index = active_voices_[i];
-        for (const auto& mp_conn : program_.mp_connections) {
-            const float src_val = applyConnectionPolarity(mono_src_buf_[mp_conn.src],
-                                                          mp_conn.isSourceBipolar(), mp_conn.isBipolar());
-            const float depth_val =
-                poly_depth_buf_[static_cast<size_t>(voice_index) * poly_depth_stride_ + mp_conn.depth_slot];
-            poly_dst_buf_[static_cast<size_t>(voice_index) * poly_dst_stride_ + mp_conn.target] += src_val * depth_val;
+    // The first computed block has no history, and fresh voices start at their first output
+    if (!smoothing_primed_) {
+        std::ranges::copy(mono_dst_, smooth_mono_state_.begin());
+        smoothing_primed_ = true;
+    }
+    for (const auto voice_index : fresh_voices_) {
+        for (const uint16_t poly_idx : poly_dst_indices_) {
+            const size_t offset = polyDstOffset(voice_index, poly_idx);
+            smooth_poly_state_[offset] = poly_dst_buf_[offset];
         }
     }
 
-    // poly -> poly connections
-    for (uint16_t i = 0; i < active_voices_.size(); i++) {
-        uint16_t voice_index = active_voices_[i];
-        for (const auto& pp_conn : program_.pp_connections) {
-            const float src_val = applyConnectionPolarity(
-                poly_src_buf_[static_cast<size_t>(voice_index) * poly_src_stride_ + pp_conn.src],
-                pp_conn.isSourceBipolar(), pp_conn.isBipolar());
-            const float depth_val =
-                poly_depth_buf_[static_cast<size_t>(voice_index) * poly_depth_stride_ + pp_conn.depth_slot];
-            poly_dst_buf_[static_cast<size_t>(voice_index) * poly_dst_stride_ + pp_conn.target] += src_val * depth_val;
+    // Dense pass over a contiguous row of n outputs with per-element coefficients
+    const auto smoothRow = [&](float* out, float* state, const float* coeff) {
+        uint32_t i = 0;
+        for (; i + kLaneWidth <= n; i += kLaneWidth) {
+            auto y = LaneBatch::load_unaligned(state + i);
+            const auto moving = smoothStep(y, LaneBatch::load_unaligned(out + i), LaneBatch::load_unaligned(coeff + i));
+            settled &= !xsimd::any(moving);
+            y.store_unaligned(state + i);
+            y.store_unaligned(out + i);
+        }
+        for (; i < n; ++i) {
+            settled &= !smoothStep(state[i], out[i], coeff[i]);
+            out[i] = state[i];
+        }
+    };
+
+    smoothRow(mono_dst_.data(), smooth_mono_state_.data(), smooth_coeff_.data());
+
+    if (config_.voice_layout == ModVoiceLayout::VoiceLanes) {
+        // One row per destination, one lane per voice; inactive lanes keep their state and stale output
+        const LaneBatch zero(0.0f);
+        for (const uint16_t poly_idx : poly_dst_indices_) {
+            const LaneBatch coeff(smooth_coeff_[poly_idx]);
+            float* out_row = poly_dst_buf_.data() + poly_idx * lane_stride_;
+            float* state_row = smooth_poly_state_.data() + poly_idx * lane_stride_;
+            for (uint32_t v = lane_begin_; v < lane_end_; v += kLaneWidth) {
+                const auto active = LaneBatch::load_unaligned(lane_active_.data() + v) != zero;
+                const auto prev = LaneBatch::load_unaligned(state_row + v);
+                auto y = prev;
+                const auto moving = smoothStep(y, LaneBatch::load_unaligned(out_row + v), coeff);
+                settled &= !xsimd::any(moving & active);
+                y = xsimd::select(active, y, prev);
+                y.store_unaligned(state_row + v);
+                xsimd::select(active, y, LaneBatch::load_unaligned(out_row + v)).store_unaligned(out_row + v);
+            }
+        }
+    } else {
+        for (const auto voice_index : voice_order_) {
+            const size_t offset = static_cast<size_t>(voice_index) * poly_dst_stride_;
+            smoothRow(poly_dst_buf_.data() + offset, smooth_poly_state_.data() + offset, smooth_coeff_.data());
         }
     }
+    return settled;
+}
 
-    // poly -> mono connections (NYI -- leave as stub for now...) TODO fix this
+void ModMatrix::publishUiSnapshot() {
+    ModUiSnapshot& snap = ui_snapshots_[ui_write_snapshot_];
+    const uint64_t block = ++block_count_;
 
+    // Stamp every destination whose values moved since the last published block with this block
+    for (int i = 0; i < dst_count_; ++i) {
+        if (mono_dst_[i] != ui_last_mono_[i]) {
+            ui_last_mono_[i] = mono_dst_[i];
+            ui_dst_versions_[i] = block;
+        }
+    }
+    if (!std::ranges::equal(voice_order_, ui_last_voices_)) {
+        ui_last_voices_.assign(voice_order_.begin(), voice_order_.end());
+        for (const uint16_t poly_idx : poly_dst_indices_) ui_dst_versions_[poly_idx] = block;
+    }
+    for (const auto voice_index : voice_order_) {
+        float* last = ui_last_poly_.data() + static_cast<size_t>(voice_index) * snap.dst_stride_;
+        for (const uint16_t poly_idx : poly_dst_indices_) {
+            const float value = poly_dst_buf_[polyDstOffset(voice_index, poly_idx)];
+            if (value != last[poly_idx]) {
+                last[poly_idx] = value;
+                ui_dst_versions_[poly_idx] = block;
+            }
+        }
+    }
 
-    // Scale mono destinations: normalized -> true-value
-    for (uint16_t i = 0; i < dst_count_; i++) {
-        const auto& s = dst_scale_info_[i];
-        float norm = std::clamp(mono_dst_[i], 0.0f, 1.0f);
-        mono_dst_[i] = s.scaling.fromNormalized(norm, s.min, s.max);
+    std::copy_n(mono_dst_.begin(), dst_count_, snap.mono_dst_.begin());
+    snap.active_voices_.assign(voice_order_.begin(), voice_order_.end());
+    for (const auto voice_index : voice_order_) {
+        const size_t offset = static_cast<size_t>(voice_index) * snap.dst_stride_;
+        for (const uint16_t poly_idx : poly_dst_indices_) {
+            snap.poly_dst_[offset + poly_idx] = ui_last_poly_[offset + poly_idx];
+        }
     }
+    std::copy_n(ui_dst_versions_.begin(), dst_count_, snap.dst_versions_.begin());
+    snap.block_count_ = block;
 
-    // Scale poly destinations for active voices: normalized -> true-value
-    // Only iterate over poly destinations; mono destinations don't need per-voice scaling
-    for (const auto voice_index : active_voices_) {
-        const size_t voice_offset = static_cast<size_t>(voice_index) * poly_dst_stride_;
+    const uint8_t prev = ui_back_snapshot_.exchange(ui_write_snapshot_ | kSnapshotFresh, std::memory_order_acq_rel);
+    ui_write_snapshot_ = prev & kSnapshotIndexMask;
+}
+
+const ModUiSnapshot& ModMatrix::acquireUiSnapshot() {
+    if (ui_back_snapshot_.load(std::memory_order_relaxed) & kSnapshotFresh) {
+        const uint8_t prev = ui_back_snapshot_.exchange(ui_read_snapshot_, std::memory_order_acq_rel);
+        ui_read_snapshot_ = prev & kSnapshotIndexMask;
+    }
+    return ui_snapshots_[ui_read_snapshot_];
+}
+
+void ModMatrix::saveRampStartValues() {
+    std::ranges::copy(mono_dst_, prev_mono_dst_.begin());
+    std::ranges::copy(poly_dst_buf_, prev_poly_dst_buf_.begin());
+}
+
+void ModMatrix::snapFreshRamps() {
+    // The very first block has no meaningful previous output, so every destination starts where it ends.
+    if (!ramp_primed_) {
+        std::ranges::copy(mono_dst_, prev_mono_dst_.begin());
+        ramp_primed_ = true;
+    }
 
+    for (const auto voice_index : fresh_voices_) {
         for (uint16_t poly_idx : poly_dst_indices_) {
-            const auto& s = dst_scale_info_[poly_idx];
-            float norm = std::clamp(poly_dst_buf_[voice_offset + poly_idx], 0.0f, 1.0f);
-            poly_dst_buf_[voice_offset + poly_idx] = s.scaling.fromNormalized(norm, s.min, s.max);
+            const size_t offset = polyDstOffset(voice_index, poly_idx);
+            prev_poly_dst_buf_[offset] = poly_dst_buf_[offset];
+        }
+    }
+    fresh_voices_.clear();
+}
+
+void ModMatrix::processVoiceRows(const ModProgram& prog, uint32_t first, uint32_t last) {
+    // Each voice's row is independent, so run every pass for one voice before moving to the next. The voice's
+    // source, depth and destination rows are resolved once, keeping the strides out of the inner loops.
+    for (uint32_t i = first; i < last; ++i) {
+        const uint16_t voice_index = voice_order_[i];
+        const float* const src_row = poly_src_buf_.data() + static_cast<size_t>(voice_index) * poly_src_stride_;
+        float* const depth_row = poly_depth_buf_.data() + static_cast<size_t>(voice_index) * poly_depth_stride_;
+        float* const dst_row = poly_dst_buf_.data() + static_cast<size_t>(voice_index) * poly_dst_stride_;
+
+        // Reset poly destinations: unmodulated ones get their final plain value; modulated ones start from the
+        // normalized base.
+        for (const uint16_t poly_idx : poly_dst_indices_) dst_row[poly_idx] = base_plain_dst_[poly_idx];
+        for (const uint16_t poly_idx : prog.modulated_poly_dsts_) dst_row[poly_idx] = base_poly_dst_[poly_idx];
+
+        // Per-voice depth only exists for slots with poly depth modulation: start from the mono depth, then add
+        // the modulation. Every other slot is read from mono_depth_buf_ directly.
+        for (const uint16_t slot : prog.poly_depth_slots_) depth_row[slot] = mono_depth_buf_[slot];
+        for (const auto& conn : prog.depth_connections_poly_) {
+            const float src_val = applyConnectionPolarity(src_row[conn.src], conn.isSourceBipolar(), conn.isBipolar());
+            depth_row[conn.target] += src_val * prog.depth_base_[conn.depth_slot];
+        }
+
+        // mono -> poly connections
+        for (const auto& conn : prog.mp_connections) {
+            const float src_val =
+                applyConnectionPolarity(mono_src_buf_[conn.src], conn.isSourceBipolar(), conn.isBipolar());
+            const float* depth = conn.hasPolyDepth() ? depth_row : mono_depth_buf_.data();
+            dst_row[conn.target] += src_val * depth[conn.depth_slot];
+        }
+
+        // poly -> poly connections
+        for (const auto& conn : prog.pp_connections) {
+            const float src_val = applyConnectionPolarity(src_row[conn.src], conn.isSourceBipolar(), conn.isBipolar());
+            const float* depth = conn.hasPolyDepth() ? depth_row : mono_depth_buf_.data();
+            dst_row[conn.target] += src_val * depth[conn.depth_slot];
+        }
+
+        // Scale modulated poly destinations: normalized -> true-value
+        prog.poly_scaler_.fromNormalized(dst_row, dst_row, config_.scaling_precision);
+
+        // Host per-note modulation, in plain units on top
+        if (!host_mod_dsts_.empty()) {
+            const float* host_row = host_poly_mod_.data() + static_cast<size_t>(voice_index) * poly_dst_stride_;
+            for (const uint16_t poly_idx : host_mod_dsts_) {
+                const auto& s = dst_scale_info_[poly_idx];
+                dst_row[poly_idx] = std::clamp(dst_row[poly_idx] + host_row[poly_idx], s.min, s.max);
+            }
+        }
+    }
+}
+
+void ModMatrix::updateLaneMask() {
+    // Build the lane mask and the range of batches that hold at least one active voice. Inactive lanes inside
+    // that range are computed along with the rest but never written back to poly_dst_buf_.
+    std::fill(lane_active_.begin(), lane_active_.end(), 0.0f);
+    for (const auto voice_index : voice_order_) lane_active_[voice_index] = 1.0f;
+    if (voice_order_.empty()) {
+        lane_begin_ = lane_end_ = 0;
+        return;
+    }
+    lane_begin_ = voice_order_.front() / kLaneWidth * kLaneWidth;
+    lane_end_ = roundUpToLanes(voice_order_.back() + 1u);
+}
+
+float ModMatrix::reducePolySource(uint16_t srcIdx, ModReduction reduction) const {
+    if (reduction == ModReduction::LastVoice) {
+        uint16_t last = voice_order_.front();
+        for (const auto voice_index : voice_order_) {
+            if (voice_stamp_[voice_index] > voice_stamp_[last]) last = voice_index;
+        }
+        return poly_src_buf_[polySrcOffset(last, srcIdx)];
+    }
+
+    const bool take_max = reduction == ModReduction::Max;
+    float reduced;
+    if (config_.voice_layout == ModVoiceLayout::VoiceLanes) {
+        // One pass over the source's lane row; inactive lanes are replaced by the reduction's identity
+        const LaneBatch identity(take_max ? -std::numeric_limits<float>::infinity() : 0.0f);
+        const LaneBatch zero(0.0f);
+        const float* row = poly_src_buf_.data() + static_cast<size_t>(srcIdx) * lane_stride_;
+        LaneBatch acc = identity;
+        for (uint32_t v = lane_begin_; v < lane_end_; v += kLaneWidth) {
+            const auto active = LaneBatch::load_unaligned(lane_active_.data() + v) != zero;
+            const auto x = xsimd::select(active, LaneBatch::load_unaligned(row + v), identity);
+            acc = take_max ? xsimd::max(acc, x) : acc + x;
+        }
+        reduced = take_max ? xsimd::reduce_max(acc) : xsimd::reduce_add(acc);
+    } else {
+        reduced = take_max ? -std::numeric_limits<float>::infinity() : 0.0f;
+        for (const auto voice_index : voice_order_) {
+            const float x = poly_src_buf_[polySrcOffset(voice_index, srcIdx)];
+            reduced = take_max ? std::max(reduced, x) : reduced + x;
         }
     }
+
+    if (reduction == ModReduction::Mean) reduced /= static_cast<float>(voice_order_.size());
+    return reduced;
+}
+
+void ModMatrix::processVoiceLanes(const ModProgram& prog, uint32_t lane_begin, uint32_t lane_end) {
+    // Each row pass runs through the plugin's SIMD kernel table; a pass covers lanes [lane_begin, lane_end)
+    const simd::Kernels& k = simd::kernels();
+    const size_t ls = lane_stride_;
+    const size_t n = lane_end - lane_begin;
+    float* const depth = poly_depth_buf_.data() + lane_begin;
+    float* const acc = poly_dst_acc_.data() + lane_begin;
+    const float* const src = poly_src_buf_.data() + lane_begin;
+    const float* const active = lane_active_.data() + lane_begin;
+    float* const out = poly_dst_buf_.data() + lane_begin;
+
+    // Reset the modulated poly destination accumulators to their base values
+    for (uint16_t poly_idx : prog.modulated_poly_dsts_) std::fill_n(acc + poly_idx * ls, n, base_poly_dst_[poly_idx]);
+
+    // Materialize per-voice depth rows only for slots with poly depth modulation
+    for (const uint16_t slot : prog.poly_depth_slots_) std::fill_n(depth + slot * ls, n, mono_depth_buf_[slot]);
+
+    // Poly depth modulation
+    for (const auto& conn : prog.depth_connections_poly_) {
+        k.modAccumulate(depth + conn.target * ls, src + conn.src * ls, 0.0f, nullptr, prog.depth_base_[conn.depth_slot],
+                        conn.isSourceBipolar(), conn.isBipolar(), n);
+    }
+
+    // mono -> poly connections: one broadcast source value; per-voice depth only with poly depth modulation,
+    // otherwise the whole contribution is one broadcast constant
+    for (const auto& conn : prog.mp_connections) {
+        const float s = applyConnectionPolarity(mono_src_buf_[conn.src], conn.isSourceBipolar(), conn.isBipolar());
+        const float* depth_row = conn.hasPolyDepth() ? depth + conn.depth_slot * ls : nullptr;
+        k.modAccumulate(acc + conn.target * ls, nullptr, s, depth_row, mono_depth_buf_[conn.depth_slot], false, false,
+                        n);
+    }
+
+    // poly -> poly connections
+    for (const auto& conn : prog.pp_connections) {
+        const float* depth_row = conn.hasPolyDepth() ? depth + conn.depth_slot * ls : nullptr;
+        k.modAccumulate(acc + conn.target * ls, src + conn.src * ls, 0.0f, depth_row, mono_depth_buf_[conn.depth_slot],
+                        conn.isSourceBipolar(), conn.isBipolar(), n);
+    }
+
+    // Clamp, scale and write back active lanes only
+
+    // Unmodulated destinations pass their plain base value through to the active lanes
+    for (uint16_t poly_idx : poly_dst_indices_) k.maskedFill(out + poly_idx * ls, active, n, base_plain_dst_[poly_idx]);
+
+    for (uint16_t poly_idx : prog.modulated_poly_dsts_) {
+        k.maskedScale(out + poly_idx * ls, acc + poly_idx * ls, active, n, dst_scale_info_[poly_idx],
+                      config_.scaling_precision);
+    }
+
+    // Host per-note modulation, in plain units on top
+    for (const uint16_t poly_idx : host_mod_dsts_) {
+        const auto& s = dst_scale_info_[poly_idx];
+        k.maskedClampAdd(out + poly_idx * ls, host_poly_mod_.data() + lane_begin + poly_idx * ls, active, n, s.min,
+                         s.max);
+    }
 }
 
 uint16_t ModMatrix::allocateDepthSlot(float initial_depth) {
@@ -487,66 +1281,142 @@ uint16_t ModMatrix::allocateDepthSlot(float initial_depth) {
     return static_cast<uint16_t>(program_.depth_base_.size() - 1);
 }
 
-bool ModMatrix::dstIsConnected(uint16_t dstIdx) const {
-    for (const auto& c : connections_) {
-        if (!c.isDepthMod() && c.dst_idx == dstIdx) return true;
+bool ModMatrix::dstIsConnected(uint16_t dstIdx) const { return !dst_adj_[dstIdx].empty(); }
+
+bool ModMatrix::srcIsConnected(uint16_t srcIdx) const { return !src_adj_[srcIdx].empty(); }
+
+ModConnection* ModMatrix::connectionAt(uint16_t depthSlot) {
+    if (depthSlot >= slot_pos_.size() || slot_pos_[depthSlot] == kNoPos) return nullptr;
+    return &connections_[slot_pos_[depthSlot]];
+}
+
+const ModConnection* ModMatrix::connectionAt(uint16_t depthSlot) const {
+    if (depthSlot >= slot_pos_.size() || slot_pos_[depthSlot] == kNoPos) return nullptr;
+    return &connections_[slot_pos_[depthSlot]];
+}
+
+ModConnection* ModMatrix::findIndexed(bool depth_mod, uint16_t srcIdx, uint16_t dstIdx) {
+    auto it = conn_index_.find(connectionKey(depth_mod, srcIdx, dstIdx));
+    return it == conn_index_.end() ? nullptr : connectionAt(it->second);
+}
+
+void ModMatrix::indexConnection(const ModConnection& c) {
+    conn_index_.emplace(connectionKey(c.isDepthMod(), c.src_idx, c.dst_idx), c.depth_slot);
+    src_adj_[c.src_idx].push_back(c.depth_slot);
+    (c.isDepthMod() ? dm_adj_ : dst_adj_)[c.dst_idx].push_back(c.depth_slot);
+}
+
+void ModMatrix::unindexConnection(const ModConnection& c) {
+    conn_index_.erase(connectionKey(c.isDepthMod(), c.src_idx, c.dst_idx));
+    std::erase(src_adj_[c.src_idx], c.depth_slot);
+    std::erase((c.isDepthMod() ? dm_adj_ : dst_adj_)[c.dst_idx], c.depth_slot);
+}
+
+void ModMatrix::reindexPositions(size_t from) {
+    for (size_t i = from; i < connections_.size(); ++i) {
+        slot_pos_[connections_[i].depth_slot] = static_cast<uint16_t>(i);
     }
-    return false;
 }
 
-bool ModMatrix::srcIsConnected(uint16_t srcIdx) const {
-    for (const auto& c : connections_) {
-        if (c.src_idx == srcIdx) return true;
+std::pair<uint8_t, ModConnectionHandle> ModMatrix::compileConnection(const ModConnection& conn) const {
+    const auto& src = src_registry_[conn.src_idx];
+    const bool src_bipolar = src.bipolar;
+    const ModSrcMode src_mode = (src.type == ModSrcType::Mono) ? ModSrcMode::Mono
+        : (src.type == ModSrcType::Poly)                       ? ModSrcMode::Poly
+                                                               : src.mode;
+
+    uint8_t handle_flags = 0;
+    if (conn.isDepthMod()) handle_flags |= ModConnectionHandle::kFlagDepthMod;
+    if (src_bipolar) handle_flags |= ModConnectionHandle::kFlagSrcBipolar;
+    if (conn.isBipolar()) handle_flags |= ModConnectionHandle::kFlagBipolar;
+
+    ModConnectionHandle handle{conn.src_idx, conn.dst_idx, conn.depth_slot, handle_flags, conn.reduction};
+
+    if (conn.isDepthMod()) {
+        // Depth modulation connection - partition by source mono/poly
+        return {src_mode == ModSrcMode::Mono ? ModProgram::kDepthMono : ModProgram::kDepthPoly, handle};
     }
-    return false;
+
+    // Parameter connection - partition by src/dst mono/poly routing
+    const ModDstMode dst_mode = dst_registry_[conn.dst_idx].mode;
+    if (src_mode == ModSrcMode::Mono) {
+        return {dst_mode == ModDstMode::Mono ? ModProgram::kMM : ModProgram::kMP, handle};
+    }
+    return {dst_mode == ModDstMode::Mono ? ModProgram::kPM : ModProgram::kPP, handle};
 }
 
-void ModMatrix::recompileProgram() {
-    program_.mm_connections.clear();
-    program_.mp_connections.clear();
-    program_.pm_connections.clear();
-    program_.pp_connections.clear();
-    program_.depth_connections_mono_.clear();
-    program_.depth_connections_poly_.clear();
-
-    for (const auto& conn : connections_) {
-        const auto& src = src_registry_[conn.src_idx];
-        const bool src_bipolar = src.bipolar;
-        const ModSrcMode src_mode = (src.type == ModSrcType::Mono) ? ModSrcMode::Mono
-            : (src.type == ModSrcType::Poly)                       ? ModSrcMode::Poly
-                                                                   : src.mode;
-
-        uint8_t handle_flags = 0;
-        if (conn.isDepthMod()) handle_flags |= ModConnectionHandle::kFlagDepthMod;
-        if (src_bipolar) handle_flags |= ModConnectionHandle::kFlagSrcBipolar;
-        if (conn.isBipolar()) handle_flags |= ModConnectionHandle::kFlagBipolar;
-
-        ModConnectionHandle handle{conn.src_idx, conn.dst_idx, conn.depth_slot, handle_flags};
-
-        if (conn.isDepthMod()) {
-            // Depth modulation connection - partition by source mono/poly
-            if (src_mode == ModSrcMode::Mono) {
-                program_.depth_connections_mono_.push_back(handle);
-            } else {
-                program_.depth_connections_poly_.push_back(handle);
-            }
-        } else {
-            // Parameter connection - partition by src/dst mono/poly routing
-            const ModDstMode dst_mode = dst_registry_[conn.dst_idx].mode;
-
-            if (src_mode == ModSrcMode::Mono && dst_mode == ModDstMode::Mono) {
-                program_.mm_connections.push_back(handle);
-            } else if (src_mode == ModSrcMode::Mono && dst_mode == ModDstMode::Poly) {
-                program_.mp_connections.push_back(handle);
-            } else if (src_mode == ModSrcMode::Poly && dst_mode == ModDstMode::Poly) {
-                program_.pp_connections.push_back(handle);
-            } else if (src_mode == ModSrcMode::Poly && dst_mode == ModDstMode::Mono) {
-                program_.pm_connections.push_back(handle);
-            }
+void ModMatrix::patchProgram(const ModConnection& conn) {
+    const auto [b, handle] = compileConnection(conn);
+    const uint32_t loc = program_.handle_loc_[conn.depth_slot];
+    if (loc != ModProgram::kNoHandle && (loc >> 16) == b) {
+        auto& slot = program_.bucket(b)[loc & 0xFFFFu];
+        // Same bucket and target: patch in place. A new target goes through erase/insert to keep the
+        // modulated-destination lists in sync.
+        if (slot.target == handle.target) {
+            slot = program_.withPolyDepthFlag(handle);
+            return;
         }
     }
+    program_.eraseHandle(conn.depth_slot);
+    program_.insertHandle(b, handle);
+}
+
+void ModMatrix::recordChange(ModConnectionChange::Kind kind, const ModConnection& conn) {
+    pending_changes_.push_back({kind, conn.depth_slot, conn.src_idx, conn.dst_idx, conn.isDepthMod()});
+}
+
+void ModMatrix::commitEdit(bool topology_changed) {
+    pending_topology_change_ |= topology_changed;
+    if (edit_depth_ > 0) return;
+
+    const bool notify_topology = std::exchange(pending_topology_change_, false);
+    publishProgram();
+    on_connections_edited(std::span<const ModConnectionChange>(pending_changes_));
+    if (notify_topology) on_connections_changed();
+    pending_changes_.clear();
+}
+
+void ModMatrix::endEdit() {
+    ASSERT(edit_depth_ > 0, "endEdit() without a matching beginEdit()");
+    if (--edit_depth_ > 0) return;
+    // Nothing was edited in the batch; skip the publish and the notifications
+    if (pending_changes_.empty() && !pending_topology_change_) return;
+    commitEdit(false);
+}
+
+void ModMatrix::setDepthBase(uint16_t slot, float value) {
+    program_.depth_base_[slot] = value;
+    // Describe the change from the compiled handle, so a depth drag stays O(1) in the number of connections
+    const uint32_t loc = program_.handle_loc_[slot];
+    if (loc != ModProgram::kNoHandle) {
+        const auto& h = program_.bucket(static_cast<uint8_t>(loc >> 16))[loc & 0xFFFFu];
+        pending_changes_.push_back({ModConnectionChange::Kind::DepthChanged, slot, h.src, h.target, h.isDepthMod()});
+    }
+    commitEdit(false);
+}
+
+void ModMatrix::publishProgram() {
+    if (program_.scalers_dirty_) rebuildScalers(program_);
+    snapshots_[edit_snapshot_].copyFrom(program_);
+    const uint8_t prev = back_snapshot_.exchange(edit_snapshot_ | kSnapshotFresh, std::memory_order_acq_rel);
+    edit_snapshot_ = prev & kSnapshotIndexMask;
+}
 
-    on_connections_changed();
+void ModMatrix::rebuildScalers(ModProgram& prog) const {
+    prog.mono_scaler_.clear();
+    prog.poly_scaler_.clear();
+    for (const uint16_t i : prog.modulated_mono_dsts_) prog.mono_scaler_.add(i, dst_scale_info_[i]);
+    for (const uint16_t i : prog.modulated_poly_dsts_) prog.poly_scaler_.add(i, dst_scale_info_[i]);
+    prog.scalers_dirty_ = false;
+}
+
+const ModProgram& ModMatrix::acquireProgram() {
+    if (back_snapshot_.load(std::memory_order_relaxed) & kSnapshotFresh) {
+        const uint8_t prev = back_snapshot_.exchange(audio_snapshot_, std::memory_order_acq_rel);
+        audio_snapshot_ = prev & kSnapshotIndexMask;
+        inputs_changed_.store(true, std::memory_order_relaxed);
+    }
+    return snapshots_[audio_snapshot_];
 }
 
 float ModConnection::getDepth() const { return matrix_->getDepthBase(depth_slot); }
@@ -556,13 +1426,23 @@ void ModConnection::setDepth(float d) { matrix_->setDepthBase(depth_slot, d); }
 void ModConnection::setBipolar(bool v) {
     if (isBipolar() == v) return;
     flags = v ? (flags | kFlagBipolar) : (flags & ~kFlagBipolar);
-    for (auto& c : matrix_->connections_) {
-        if (c.depth_slot == depth_slot) {
-            c.flags = flags;
-            break;
-        }
+    if (ModConnection* c = matrix_->connectionAt(depth_slot)) {
+        c->flags = flags;
+        matrix_->patchProgram(*c);
+        matrix_->recordChange(ModConnectionChange::Kind::MappingChanged, *c);
+    }
+    matrix_->commitEdit(false);
+}
+
+void ModConnection::setReduction(ModReduction r) {
+    if (reduction == r) return;
+    reduction = r;
+    if (ModConnection* c = matrix_->connectionAt(depth_slot)) {
+        c->reduction = r;
+        matrix_->patchProgram(*c);
+        matrix_->recordChange(ModConnectionChange::Kind::MappingChanged, *c);
     }
-    matrix_->recompileProgram();
+    matrix_->commitEdit(false);
 }
 
 const ModSource& ModConnection::source() const { return matrix_->getSource(src_idx); }
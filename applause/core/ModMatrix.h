@@ -2,14 +2,20 @@
 
 #include <algorithm>
 #include <applause/extensions/ParamsExtension.h>
+#include <applause/extensions/ThreadPoolExtension.h>
 #include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
 #include <applause/util/ValueScaling.h>
+#include <applause/util/ValueScalingBatch.h>
 #include <applause/util/thirdparty/rocket.hpp>
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <optional>
 #include <span>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace applause {
@@ -20,6 +26,19 @@ enum class ModSrcMode : uint8_t { Mono, Poly };
 
 enum class ModDstMode : uint8_t { Mono, Poly };
 
+/**
+ * Memory layout of the matrix's per-voice buffers (poly sources, poly depths and poly destinations).
+ *
+ * - VoiceRows:  one row per voice, indexed [voice][index]. Per-voice passes walk each voice's row with a scalar
+ *               loop. This is the reference implementation.
+ * - VoiceLanes: one row per source/slot/destination, indexed [index][voice], with each row padded to a whole
+ *               number of SIMD batches. Per-voice passes process several voices per instruction, one voice per
+ *               SIMD lane. Prefer this for high voice counts with many poly connections.
+ *
+ * The layout only affects internal storage; every public accessor behaves identically under both layouts.
+ */
+enum class ModVoiceLayout : uint8_t { VoiceRows, VoiceLanes };
+
 class ModMatrix;  // Forward decl so ModSource/ModDestination can hold a back-pointer.
 
 /**
@@ -54,6 +73,18 @@ struct ModDestination {
     ModMatrix* matrix = nullptr;  ///< Set by registerDestination(); identifies the owning matrix.
 };
 
+/**
+ * How a poly->mono connection collapses its per-voice source values into one mono value. The reduction is applied
+ * to the raw source values of the active voices; the connection's mapping and depth are then applied as for a mono
+ * source. With no active voices, poly->mono connections contribute nothing.
+ */
+enum class ModReduction : uint8_t {
+    Max,        ///< Largest value across active voices (e.g. loudest envelope)
+    Sum,        ///< Sum across active voices
+    Mean,       ///< Average across active voices
+    LastVoice,  ///< Value of the most recently triggered active voice
+};
+
 /**
  * Unified modulation connection structure.
  * Holds a pointer to its parent ModMatrix for safe depth access (avoids dangling pointers
@@ -68,6 +99,7 @@ struct ModConnection {
     uint16_t dst_idx = 0;  ///< Destination index (param conn) OR target depth slot (depth mod)
     uint16_t depth_slot = 0;  ///< Slot index where this connection's depth is stored
     uint8_t flags = 0;  ///< Packed flags; see kFlag* constants above
+    ModReduction reduction = ModReduction::Max;  ///< Only used when routed poly src -> mono dst
 
     [[nodiscard]] bool isDepthMod() const { return flags & kFlagDepthMod; }
     [[nodiscard]] bool isBipolar() const { return flags & kFlagBipolar; }
@@ -76,6 +108,7 @@ struct ModConnection {
     [[nodiscard]] float getDepth() const;
     void setDepth(float d);
     void setBipolar(bool v);
+    void setReduction(ModReduction r);
 
     // Convenience accessors
     [[nodiscard]] const ModSource& source() const;
@@ -89,62 +122,331 @@ struct ModConnectionHandle {
     static constexpr uint8_t kFlagDepthMod = 1u << 0;    ///< Connection modulates another connection's depth
     static constexpr uint8_t kFlagSrcBipolar = 1u << 1;  ///< Source's native output range is [-1, +1]
     static constexpr uint8_t kFlagBipolar = 1u << 2;     ///< Output is centered at 0 (bidirectional mapping)
+    static constexpr uint8_t kFlagPolyDepth = 1u << 3;   ///< Depth slot has poly depth modulation (MP/PP only)
 
     uint16_t src;  ///< Source index
     uint16_t target;  ///< Destination index (param conn) OR target depth slot (depth mod)
     uint16_t depth_slot;  ///< Slot index where this connection's depth is stored
     uint8_t flags;  ///< Packed flags; see kFlag* constants above
+    ModReduction reduction;  ///< Voice reduction policy; PM connections only
 
     [[nodiscard]] bool isDepthMod() const { return flags & kFlagDepthMod; }
     [[nodiscard]] bool isSourceBipolar() const { return flags & kFlagSrcBipolar; }
     [[nodiscard]] bool isBipolar() const { return flags & kFlagBipolar; }
+    [[nodiscard]] bool hasPolyDepth() const { return flags & kFlagPolyDepth; }
 };
 
 /**
  * Lightweight handle for audio-thread access to a modulated parameter value.
- * Use getModHandle() to obtain. The pointer is pre-computed, so getValue()
+ * Use getModHandle() to obtain. The pointers are pre-computed, so getValue()
  * is a simple dereference with no arithmetic.
+ *
+ * getValue() is the value at the end of the current block. When the matrix was configured with ramp_outputs,
+ * getStartValue() is the previous block's value, so DSP code can interpolate across the block instead of
+ * stepping. Without ramp_outputs, both return the same value.
  */
 struct ModParamHandle {
     float* value_ = nullptr;
+    const float* start_ = nullptr;
+
     [[nodiscard]] float getValue() const noexcept { return *value_; }
+    [[nodiscard]] float getStartValue() const noexcept { return *start_; }
+
+    /** Linearly interpolated value at position t in [0, 1] across the current block. */
+    [[nodiscard]] float getValueAt(float t) const noexcept { return *start_ + (*value_ - *start_) * t; }
+
+    /** Per-sample increment that ramps from getStartValue() to getValue() over num_frames samples. */
+    [[nodiscard]] float getIncrement(uint32_t num_frames) const noexcept {
+        return num_frames ? (*value_ - *start_) / static_cast<float>(num_frames) : 0.0f;
+    }
+
+    /**
+     * Fills out with a per-sample ramp for this block. out[i] is the value at sample i + 1, so the last sample
+     * lands exactly on getValue() and consecutive blocks join without a discontinuity.
+     */
+    void fillRamp(std::span<float> out) const noexcept {
+        const float start = *start_;
+        const float inc = getIncrement(static_cast<uint32_t>(out.size()));
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = start + inc * static_cast<float>(i + 1);
+        }
+    }
 };
 
 /**
- * Represents a "compiled" modulation graph that can be executed efficiently. A ModMatrix owns exactly one of these.
- * When the user changes the modulation graph, this object is modified/replaced.
- *
- * We keep it as a separate object to atomically swap the whole thing all at the same time when an update is made,
- * so the DSP thread never reads from a partially-updated modulation system. Thread safety!
+ * Write access to one poly source's values for every voice, for modulators that compute all voices at once.
+ * Use ModMatrix::getPolySourceRow() to obtain. Voice v's value lives at data[v * stride]: stride is 1 under
+ * ModVoiceLayout::VoiceLanes, so the row can be written with SIMD stores, and the matrix's source count under
+ * VoiceRows.
+ */
+struct ModPolySourceRow {
+    float* data = nullptr;
+    size_t stride = 0;
+    size_t num_voices = 0;
+
+    [[nodiscard]] bool isContiguous() const noexcept { return stride == 1; }
+
+    float& operator[](size_t voice) const noexcept { return data[voice * stride]; }
+};
+
+/**
+ * Describes one edited connection in a change-set delivered by ModMatrix::on_connections_edited.
+ * Connections are identified by depth_slot, which is stable for a connection's lifetime. For removed connections
+ * the fields describe the connection as it was just before removal.
+ */
+struct ModConnectionChange {
+    enum class Kind : uint8_t {
+        Added,           ///< New connection
+        Removed,         ///< Connection removed (directly or by cascade)
+        DepthChanged,    ///< Base depth changed
+        MappingChanged,  ///< Bipolar/unipolar mapping changed
+        Rerouted,        ///< Source, destination or source mode changed; may also move between program buckets
+    };
+
+    Kind kind;
+    uint16_t depth_slot;
+    uint16_t src_idx;
+    uint16_t dst_idx;  ///< Destination index, or target depth slot for depth mods
+    bool is_depth_mod;
+};
+
+/**
+ * Represents a "compiled" modulation graph that can be executed efficiently.
  *
- * (the actual atomic swapping shenanigans are NYI, but it's a TODO)
+ * A ModMatrix owns one editable program, which the UI/main thread patches whenever the modulation graph changes,
+ * plus three published snapshots of it arranged as a lock-free triple buffer. After each edit the editable program
+ * is copied into a spare snapshot and published with a single atomic exchange; process() picks up the newest
+ * snapshot with another exchange. The DSP thread therefore never reads a partially-updated program, and never
+ * waits, allocates or frees memory. Every vector is reserved to max_connections up front, so copying into a
+ * snapshot does not allocate either.
  */
 class ModProgram {
     [[maybe_unused]] ModMatrix& matrix;
 
     std::vector<ModConnectionHandle> mm_connections;  // mono src -> mono dst
     std::vector<ModConnectionHandle> mp_connections;  // mono src -> poly dst
-    std::vector<ModConnectionHandle> pm_connections;  // poly src -> mono dst (NYI)
+    std::vector<ModConnectionHandle> pm_connections;  // poly src -> mono dst (reduced over active voices)
     std::vector<ModConnectionHandle> pp_connections;  // poly src -> poly dst
 
     std::vector<float> depth_base_;
     std::vector<uint8_t> depth_active_;
 
+    // Depth slots targeted by poly depth modulation, the only slots with per-voice depth rows. MP and PP
+    // connections on any other slot read mono_depth_buf_ directly; kFlagPolyDepth tells them apart.
+    std::vector<uint16_t> poly_depth_slots_;
+
+    // Number of poly depth mods per target slot; maintains the list above. Edit-side only.
+    std::vector<uint16_t> poly_depth_refcount_;
+
     std::vector<ModConnectionHandle> depth_connections_mono_;
     std::vector<ModConnectionHandle> depth_connections_poly_;
 
+    // Destinations targeted by at least one parameter connection. process() only accumulates and rescales these;
+    // every other destination passes its plain base value straight through.
+    std::vector<uint16_t> modulated_mono_dsts_;
+    std::vector<uint16_t> modulated_poly_dsts_;
+
+    // Converters for the two lists above, grouped by scale type. Rebuilt by the matrix when a list changes.
+    applause::ValueScalingBatch mono_scaler_;
+    applause::ValueScalingBatch poly_scaler_;
+    bool scalers_dirty_ = false;
+
+    // Number of parameter connections per destination; maintains the lists above. Edit-side only.
+    std::vector<uint16_t> dst_refcount_;
+
+    // Program buckets, in the order handle_loc_ encodes them
+    enum Bucket : uint8_t { kMM, kMP, kPM, kPP, kDepthMono, kDepthPoly };
+
+    // Per depth slot: (bucket << 16) | index of the connection's handle, or kNoHandle. Lets single-connection edits
+    // patch the program in place instead of re-partitioning every connection. Edit-side only; not copied into
+    // published snapshots.
+    static constexpr uint32_t kNoHandle = 0xFFFFFFFFu;
+    std::vector<uint32_t> handle_loc_;
+
+    std::vector<ModConnectionHandle>& bucket(uint8_t b) {
+        switch (b) {
+            case kMM: return mm_connections;
+            case kMP: return mp_connections;
+            case kPM: return pm_connections;
+            case kPP: return pp_connections;
+            case kDepthMono: return depth_connections_mono_;
+            default: return depth_connections_poly_;
+        }
+    }
+
+    // MM/PM buckets target mono destinations, MP/PP target poly ones; depth buckets target depth slots
+    static bool isParamBucket(uint8_t b) { return b <= kPP; }
+    std::vector<uint16_t>& modulatedList(uint8_t b) {
+        return (b == kMM || b == kPM) ? modulated_mono_dsts_ : modulated_poly_dsts_;
+    }
+
+    // Sets or clears kFlagPolyDepth on the handle of the connection owning depth_slot, if it has one
+    void setPolyDepthFlag(uint16_t depth_slot, bool on) {
+        const uint32_t loc = handle_loc_[depth_slot];
+        if (loc == kNoHandle) return;
+        auto& h = bucket(static_cast<uint8_t>(loc >> 16))[loc & 0xFFFFu];
+        h.flags = on ? (h.flags | ModConnectionHandle::kFlagPolyDepth)
+                     : (h.flags & ~ModConnectionHandle::kFlagPolyDepth);
+    }
+
+    // Returns handle with kFlagPolyDepth reflecting whether its slot currently has poly depth modulation
+    ModConnectionHandle withPolyDepthFlag(ModConnectionHandle handle) const {
+        if (poly_depth_refcount_[handle.depth_slot] > 0) handle.flags |= ModConnectionHandle::kFlagPolyDepth;
+        return handle;
+    }
+
+    void insertHandle(uint8_t b, const ModConnectionHandle& handle) {
+        auto& list = bucket(b);
+        handle_loc_[handle.depth_slot] = (static_cast<uint32_t>(b) << 16) | static_cast<uint32_t>(list.size());
+        list.push_back(withPolyDepthFlag(handle));
+        if (b == kDepthPoly && poly_depth_refcount_[handle.target]++ == 0) {
+            poly_depth_slots_.push_back(handle.target);
+            setPolyDepthFlag(handle.target, true);
+        }
+        if (isParamBucket(b) && dst_refcount_[handle.target]++ == 0) {
+            modulatedList(b).push_back(handle.target);
+            scalers_dirty_ = true;
+        }
+    }
+
+    void eraseHandle(uint16_t depth_slot) {
+        const uint32_t loc = handle_loc_[depth_slot];
+        if (loc == kNoHandle) return;
+        const auto b = static_cast<uint8_t>(loc >> 16);
+        auto& list = bucket(b);
+        const size_t idx = loc & 0xFFFFu;
+        if (b == kDepthPoly && --poly_depth_refcount_[list[idx].target] == 0) {
+            std::erase(poly_depth_slots_, list[idx].target);
+            setPolyDepthFlag(list[idx].target, false);
+        }
+        if (isParamBucket(b) && --dst_refcount_[list[idx].target] == 0) {
+            std::erase(modulatedList(b), list[idx].target);
+            scalers_dirty_ = true;
+        }
+        // Preserve order within the bucket so removals don't reorder the remaining summation
+        list.erase(list.begin() + static_cast<std::ptrdiff_t>(idx));
+        for (size_t i = idx; i < list.size(); ++i) handle_loc_[list[i].depth_slot]--;
+        handle_loc_[depth_slot] = kNoHandle;
+    }
+
+    // Drops free slots from the end of the depth arrays, so per-block loops over every slot and snapshot copies
+    // don't keep paying for connections that no longer exist. Slots in the middle keep their numbers.
+    void trimFreeSlots() {
+        while (!depth_active_.empty() && depth_active_.back() == 0) {
+            depth_active_.pop_back();
+            depth_base_.pop_back();
+        }
+    }
+
 public:
-    explicit ModProgram(ModMatrix& matrix, uint16_t max_connections) : matrix(matrix) {
+    explicit ModProgram(ModMatrix& matrix, uint16_t max_connections, uint16_t max_destinations) : matrix(matrix) {
+        handle_loc_.assign(max_connections, kNoHandle);
+        dst_refcount_.assign(max_destinations, 0);
+        modulated_mono_dsts_.reserve(max_destinations);
+        modulated_poly_dsts_.reserve(max_destinations);
+        mono_scaler_.reserve(max_destinations);
+        poly_scaler_.reserve(max_destinations);
         mm_connections.reserve(max_connections);
         mp_connections.reserve(max_connections);
         pm_connections.reserve(max_connections);
         pp_connections.reserve(max_connections);
         depth_base_.reserve(max_connections);
         depth_active_.reserve(max_connections);
+        poly_depth_slots_.reserve(max_connections);
+        poly_depth_refcount_.assign(max_connections, 0);
         depth_connections_mono_.reserve(max_connections);
         depth_connections_poly_.reserve(max_connections);
     }
 
+    /** Removes every connection, leaving the program as freshly constructed. Edit-side only. */
+    void clearConnections() {
+        for (uint8_t b = kMM; b <= kDepthPoly; ++b) bucket(b).clear();
+        depth_base_.clear();
+        depth_active_.clear();
+        poly_depth_slots_.clear();
+        std::ranges::fill(poly_depth_refcount_, 0);
+        modulated_mono_dsts_.clear();
+        modulated_poly_dsts_.clear();
+        std::ranges::fill(dst_refcount_, 0);
+        std::ranges::fill(handle_loc_, kNoHandle);
+        scalers_dirty_ = true;
+    }
+
+    /** Copies other's contents into this program, reusing the reserved storage. */
+    void copyFrom(const ModProgram& other) {
+        mm_connections = other.mm_connections;
+        mp_connections = other.mp_connections;
+        pm_connections = other.pm_connections;
+        pp_connections = other.pp_connections;
+        depth_base_ = other.depth_base_;
+        depth_active_ = other.depth_active_;
+        poly_depth_slots_ = other.poly_depth_slots_;
+        depth_connections_mono_ = other.depth_connections_mono_;
+        depth_connections_poly_ = other.depth_connections_poly_;
+        modulated_mono_dsts_ = other.modulated_mono_dsts_;
+        modulated_poly_dsts_ = other.modulated_poly_dsts_;
+        mono_scaler_.copyFrom(other.mono_scaler_);
+        poly_scaler_.copyFrom(other.poly_scaler_);
+    }
+
+    friend class ModMatrix;
+};
+
+
+/**
+ * One block's modulated output values, published by the audio thread at the end of ModMatrix::process() for
+ * UI readers. Obtain one with ModMatrix::acquireUiSnapshot(); its contents stay fixed until the next acquire, so
+ * a UI frame reads values that all come from the same block without locking or touching the live DSP buffers.
+ *
+ * Poly values are only copied for voices that were active in that block.
+ */
+class ModUiSnapshot {
+public:
+    ModUiSnapshot(uint16_t num_voices, uint16_t max_destinations)
+        : dst_stride_(max_destinations),
+          mono_dst_(max_destinations, 0.0f),
+          poly_dst_(static_cast<size_t>(num_voices) * max_destinations, 0.0f),
+          dst_versions_(max_destinations, 0) {
+        active_voices_.reserve(num_voices);
+    }
+
+    /** Plain modulated value of a mono destination. */
+    [[nodiscard]] float getModValue(uint16_t dstIdx) const {
+        ASSERT(dstIdx < dst_stride_, "Destination index out of bounds");
+        return mono_dst_[dstIdx];
+    }
+
+    /** Plain modulated value of a poly destination for one of getActiveVoices(). */
+    [[nodiscard]] float getPolyModValue(uint16_t dstIdx, uint16_t voice) const {
+        ASSERT(dstIdx < dst_stride_, "Destination index out of bounds");
+        ASSERT(static_cast<size_t>(voice) * dst_stride_ < poly_dst_.size(), "Voice index out of bounds");
+        return poly_dst_[static_cast<size_t>(voice) * dst_stride_ + dstIdx];
+    }
+
+    /** Voices that were active in the published block, in ascending order. */
+    [[nodiscard]] std::span<const uint16_t> getActiveVoices() const { return active_voices_; }
+
+    /** Number of process() calls up to and including the published block; 0 if nothing has been published. */
+    [[nodiscard]] uint64_t getBlockCount() const { return block_count_; }
+
+    /**
+     * The block (as in getBlockCount()) in which a destination's published values last changed: its mono value,
+     * one of its poly values, or the set of voices they're read for. A UI element that remembers the version it
+     * drew can skip redrawing until this moves.
+     */
+    [[nodiscard]] uint64_t getDstVersion(uint16_t dstIdx) const {
+        ASSERT(dstIdx < dst_stride_, "Destination index out of bounds");
+        return dst_versions_[dstIdx];
+    }
+
+private:
+    uint16_t dst_stride_;
+    std::vector<float> mono_dst_;
+    std::vector<float> poly_dst_;  // [voice][destination]
+    std::vector<uint64_t> dst_versions_;
+    std::vector<uint16_t> active_voices_;
+    uint64_t block_count_ = 0;
+
     friend class ModMatrix;
 };
 
@@ -180,26 +482,31 @@ public:
         uint16_t max_sources;
         uint16_t max_destinations;
         uint16_t max_connections;
+        ModVoiceLayout voice_layout = ModVoiceLayout::VoiceRows;
+        bool ramp_outputs = false;  ///< Keep the previous block's outputs so handles can ramp across a block
+        bool smooth_outputs = false;  ///< Allocate state for per-destination output smoothing (see registerDestination)
+        bool host_modulation = false;  ///< Allocate per-voice offsets for host per-note modulation
+        /// Accuracy of normalized <-> plain conversions in process() and loadParamBaseValues()
+        ScalingPrecision scaling_precision = ScalingPrecision::Fast;
     };
 
-    explicit ModMatrix(Config config) :
-        config_(config),
-        poly_src_stride_(config.max_sources),
-        poly_dst_stride_(config.max_destinations),
-        poly_depth_stride_(config.max_connections),
-        program_(*this, config.max_connections),
-        src_registry_(config.max_sources),
-        dst_registry_(config.max_destinations),
-        dst_scale_info_(config.max_destinations),
-        mono_src_buf_(config.max_sources, 0.0f),
-        poly_src_buf_(static_cast<size_t>(config.num_voices) * config.max_sources, 0.0f),
-        base_mono_dst_(config.max_destinations, 0.0f),
-        base_poly_dst_(config.max_destinations, 0.0f),
-        mono_depth_buf_(config.max_connections, 0.0f),
-        poly_depth_buf_(static_cast<size_t>(config.num_voices) * config.max_connections, 0.0f),
-        mono_dst_(config.max_destinations, 0.0f),
-        poly_dst_buf_(static_cast<size_t>(config.num_voices) * config.max_destinations, 0.0f) {
-        active_voices_.reserve(config.num_voices);
+    /** Constructs the matrix with its per-block buffers in one internally owned allocation. */
+    explicit ModMatrix(Config config);
+
+    /**
+     * Constructs the matrix with its per-block buffers carved from @p arena, so several matrices (or a matrix and
+     * the rest of a plugin's state) can share one contiguous block. The arena must outlive the matrix and have at
+     * least requiredArenaBytes(config) bytes free.
+     */
+    ModMatrix(Config config, MemoryArena& arena);
+
+    /** Arena bytes the per-block buffers need for @p config, including alignment padding. */
+    [[nodiscard]] static constexpr size_t requiredArenaBytes(const Config& config) {
+        // Worst-case padding to align the first buffer, then every buffer rounded up to whole cache lines
+        constexpr size_t line = defaultByteAlignment;
+        size_t bytes = line - 1;
+        for (const size_t n : arenaBufferLengths(config)) bytes += (n * sizeof(float) + line - 1) / line * line;
+        return bytes;
     }
 
     ModMatrix() = delete;
@@ -237,11 +544,23 @@ public:
      * @param string_id unique identifier for the destination
      * @param mode whether the destination is mono or poly
      * @param scale_info scaling info for converting normalized <-> real values. Optional; defaults to no scaling.
+     * @param smoothing_ms time constant of a one-pole smoother applied to the destination's output (per voice for
+     *                     poly destinations) across blocks. 0 disables smoothing. Non-zero values require
+     *                     Config::smooth_outputs and take effect once setBlockRate() has been called.
      * @return reference to the registered destination
      */
     ModDestination& registerDestination(const std::string& string_id, ModDstMode mode,
                                         applause::ValueScaleInfo scale_info = {0.0f, 1.0f,
-                                                                               applause::ValueScaling::linear()});
+                                                                               applause::ValueScaling::linear()},
+                                        float smoothing_ms = 0.0f);
+
+    /**
+     * Sets how often process() runs, which converts destination smoothing times into per-block coefficients.
+     * Call from activate(), not concurrently with process().
+     * @param sample_rate the audio sample rate
+     * @param block_size the number of samples covered by one process() call
+     */
+    void setBlockRate(double sample_rate, uint32_t block_size);
 
     [[nodiscard]] uint16_t getDestinationCount() const { return static_cast<uint16_t>(dst_count_); }
 
@@ -341,6 +660,29 @@ public:
 
     [[nodiscard]] const std::vector<ModConnection>& getConnections() const { return connections_; }
 
+    /**
+     * Serializes the routing into a compact binary blob: every connection with its depth slot, depth, mapping
+     * and reduction, plus the mode of each connected source. Sources and destinations are stored by string id,
+     * so a blob stays loadable after sources or destinations are registered in a different order.
+     *
+     * The blob is in native (little-endian) byte order. Embed it in your state however you like, e.g. as a
+     * JSON binary value.
+     */
+    [[nodiscard]] std::vector<std::byte> saveRouting() const;
+
+    /**
+     * Replaces every connection with the routing in a blob written by saveRouting(). The whole program is rebuilt
+     * in one pass and published once, with a single on_connections_edited / on_connections_changed notification,
+     * so switching presets costs one edit rather than one per connection. Connections keep their saved depth
+     * slots.
+     *
+     * Connections whose source or destination id isn't registered are dropped, along with the depth mods that
+     * target them. A malformed or incompatible blob is rejected without touching the current routing.
+     *
+     * @return false if the blob was rejected
+     */
+    bool loadRouting(std::span<const std::byte> data);
+
     /**
      * Returns true if any connection targets the given destination. This function disregards second-order connections,
      * i.e. when a source is modulating the depth of another extant connection.
@@ -354,10 +696,61 @@ public:
     [[nodiscard]] bool srcIsConnected(uint16_t srcIdx) const;
 
     /**
-     * Fires whenever the connection graph is changed, e.g. after adding/removing a connection.
+     * Fires whenever the connection graph's topology changes: a connection was added, removed or rerouted.
+     * Depth and mapping edits only fire on_connections_edited.
      */
     mutable rocket::signal<void()> on_connections_changed;
 
+    /**
+     * Fires after every connection edit with the set of connections it touched, including depth and mapping
+     * changes. Listeners that only care about particular sources or destinations should filter on this instead of
+     * rebuilding on on_connections_changed.
+     */
+    mutable rocket::signal<void(std::span<const ModConnectionChange>)> on_connections_edited;
+
+    /**
+     * Starts a batch of connection edits. Until the matching endEdit(), edits update the matrix's connections
+     * and lookups immediately but are neither published to the audio thread nor reported to listeners. The
+     * outermost endEdit() publishes one program and fires on_connections_edited once with every recorded change
+     * (in order; a connection may appear more than once), then on_connections_changed if the topology changed.
+     *
+     * Calls nest. Prefer the RAII Transaction over calling these directly.
+     */
+    void beginEdit() { ++edit_depth_; }
+
+    /** Ends a batch started by beginEdit(); see there. */
+    void endEdit();
+
+    /** Whether a beginEdit() batch is open. */
+    [[nodiscard]] bool isEditing() const { return edit_depth_ > 0; }
+
+    /**
+     * Scoped edit batch: calls beginEdit() on construction and endEdit() on destruction or commit(), whichever
+     * comes first.
+     *
+     * @code
+     * {
+     *     ModMatrix::Transaction tx(matrix);
+     *     for (auto& dst : dsts) matrix.addConnection(lfo, dst, randomDepth());
+     * }  // one publish, one notification
+     * @endcode
+     */
+    class Transaction {
+    public:
+        explicit Transaction(ModMatrix& matrix) : matrix_(&matrix) { matrix.beginEdit(); }
+        ~Transaction() { commit(); }
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        void commit() {
+            if (matrix_) std::exchange(matrix_, nullptr)->endEdit();
+        }
+
+    private:
+        ModMatrix* matrix_;
+    };
+
     /**
      * Finds a first-order (non-depth-mod) connection by source and destination index.
      */
@@ -411,19 +804,38 @@ public:
      * Notifies the matrix that the voice corresponding to voice_index has been deactivated and is no longer
      * being processed nor producing audio. This function must be called whenever a voice is disabled.
      */
-    void notifyVoiceOff(uint16_t voice_index) { std::erase(active_voices_, voice_index); }
+    void notifyVoiceOff(uint16_t voice_index);
+
+    /** Whether voice_index is currently active (between notifyVoiceOn and notifyVoiceOff). */
+    [[nodiscard]] bool isVoiceActive(uint16_t voice_index) const {
+        return voice_index < config_.num_voices && voice_pos_[voice_index] != kNoPos;
+    }
 
     /**
-     * Returns a view over the currently active voice indices. The underlying storage
-     * is reserved to num_voices at construction, so the data pointer is stable across
-     * voice on/off notifications. Intended for UI read-only access at frame rate;
-     * a torn size read may cause at most one frame of visual glitch (e.g. a voice
-     * displayed one frame late after voice-off), which is benign for visualization.
+     * Returns a view over the currently active voice indices, in no particular order. For use on the audio
+     * thread; UI code should read ModUiSnapshot::getActiveVoices() from acquireUiSnapshot() instead.
      */
     [[nodiscard]] std::span<const uint16_t> getActiveVoices() const {
         return {active_voices_.data(), active_voices_.size()};
     }
 
+    /**
+     * Sets the host's per-note modulation of a poly destination for one voice, in plain units. It's added to the
+     * voice's modulated value, which is then clamped to the destination's range, at the same per-voice cost as the
+     * matrix's own modulation. The offset lasts until it's set again or the voice is next notified on.
+     * Requires Config::host_modulation. A Synthesizer bound to the matrix calls this for the per-note
+     * CLAP_EVENT_PARAM_MOD events it receives (see findHostModDestination()).
+     */
+    void setHostPolyModulation(uint16_t dstIdx, uint16_t voice, float amount);
+
+    /**
+     * Resolves a per-note CLAP_EVENT_PARAM_MOD event to the poly destination it modulates, through the params
+     * extension given to registerFromParamsExtension() and the event's cookie. Global events (no note id, key,
+     * channel or port) are the extension's own (ParamHandle::getModulation()), so they resolve to nullopt, as do
+     * events for mono destinations and every event without Config::host_modulation.
+     */
+    [[nodiscard]] std::optional<uint16_t> findHostModDestination(const clap_event_param_mod_t& event) const;
+
     /**
      * Sets the base (unmodulated) value for a destination in plain units.
      * The value is internally normalized using the destination's scaling info.
@@ -438,7 +850,9 @@ public:
      */
     void setMonoSourceValue(uint16_t srcIdx, float value) {
         ASSERT(srcIdx < src_count_, "Source index out of bounds");
+        if (mono_src_buf_[srcIdx] == value) return;
         mono_src_buf_[srcIdx] = value;
+        markInputsChanged();
     }
 
     /**
@@ -451,7 +865,20 @@ public:
     void setPolySourceValue(uint16_t srcIdx, uint16_t voice, float value) {
         ASSERT(srcIdx < src_count_, "Source index out of bounds");
         ASSERT(voice < config_.num_voices, "Voice index out of bounds");
-        poly_src_buf_[static_cast<size_t>(voice) * poly_src_stride_ + srcIdx] = value;
+        float& slot = poly_src_buf_[polySrcOffset(voice, srcIdx)];
+        if (slot == value) return;
+        slot = value;
+        markInputsChanged();
+    }
+
+    /**
+     * Returns the poly values of srcIdx for direct writes, replacing one setPolySourceValue() call per voice. The
+     * matrix assumes the values change, so the next process() is never skipped as quiescent. Call before process().
+     */
+    [[nodiscard]] ModPolySourceRow getPolySourceRow(uint16_t srcIdx) {
+        ASSERT(srcIdx < src_count_, "Source index out of bounds");
+        markInputsChanged();
+        return {poly_src_buf_.data() + polySrcOffset(0, srcIdx), poly_src_stride_, config_.num_voices};
     }
 
     /**
@@ -464,13 +891,14 @@ public:
     void setSourceValue(uint16_t srcIdx, uint16_t voice, float value) {
         ASSERT(srcIdx < src_count_, "Source index out of bounds");
         ASSERT(voice < config_.num_voices, "Voice index out of bounds");
-        mono_src_buf_[srcIdx] = value;
-        poly_src_buf_[static_cast<size_t>(voice) * poly_src_stride_ + srcIdx] = value;
+        setMonoSourceValue(srcIdx, value);
+        setPolySourceValue(srcIdx, voice, value);
     }
 
     /**
      * Returns the final modulated value for a mono destination in plain units.
-     * Call this after process() to retrieve the modulated parameter value.
+     * Call this after process() to retrieve the modulated parameter value. Audio thread only; UI code should use
+     * acquireUiSnapshot().
      */
     [[nodiscard]] float getModValue(uint16_t dstIdx) const {
         ASSERT(dstIdx < dst_count_, "Destination index out of bounds");
@@ -481,18 +909,19 @@ public:
      * Returns the cumulative modulation offset range `{min_offset, max_offset}` for a destination, summed
      * over all parameter-modulating connections that target it. Result is in normalized in [0,1] with
      * respect to the underlying destination's normalized range. Use this to draw "modulation depth arcs" on
-     * knobs or sliders or whatever.
+     * knobs or sliders or whatever. Reads connection state only, so it is safe on the editing (UI) thread.
      */
     [[nodiscard]] std::pair<float, float> getModOffsetRange(uint16_t dstIdx) const;
 
     /**
      * Returns the final modulated value for a poly destination for a specific voice, in plain units.
-     * Call this after process() to retrieve the modulated parameter value.
+     * Call this after process() to retrieve the modulated parameter value. Audio thread only; UI code should use
+     * acquireUiSnapshot().
      */
     [[nodiscard]] float getPolyModValue(uint16_t dstIdx, uint16_t voice) const {
         ASSERT(dstIdx < dst_count_, "Destination index out of bounds");
         ASSERT(voice < config_.num_voices, "Voice index out of bounds");
-        return poly_dst_buf_[static_cast<size_t>(voice) * poly_dst_stride_ + dstIdx];
+        return poly_dst_buf_[polyDstOffset(voice, dstIdx)];
     }
 
     /**
@@ -502,7 +931,7 @@ public:
      */
     [[nodiscard]] ModParamHandle getModHandle(uint16_t dstIdx) {
         ASSERT(dstIdx < dst_count_, "Destination index out of bounds");
-        return ModParamHandle{&mono_dst_[dstIdx]};
+        return ModParamHandle{&mono_dst_[dstIdx], config_.ramp_outputs ? &prev_mono_dst_[dstIdx] : &mono_dst_[dstIdx]};
     }
 
     /**
@@ -514,25 +943,160 @@ public:
     [[nodiscard]] ModParamHandle getModHandle(uint16_t dstIdx, uint16_t voice) {
         ASSERT(dstIdx < dst_count_, "Destination index out of bounds");
         ASSERT(voice < config_.num_voices, "Voice index out of bounds");
-        return ModParamHandle{&poly_dst_buf_[static_cast<size_t>(voice) * poly_dst_stride_ + dstIdx]};
+        const size_t offset = polyDstOffset(voice, dstIdx);
+        return ModParamHandle{&poly_dst_buf_[offset],
+                              config_.ramp_outputs ? &prev_poly_dst_buf_[offset] : &poly_dst_buf_[offset]};
     }
 
     /**
-     * Load all param values as normalized into base destination values.
-     * Assumes param index == destination index (1:1 bijection).
+     * Load all param values, plus the host's global modulation of them, as normalized into base destination values.
+     * Assumes param index == destination index (1:1 bijection). Only the destinations registered by
+     * registerFromParamsExtension() are loaded; destinations registered afterwards keep their base values.
+     * After the first load, only parameters the extension reports as changed (ParamsExtension::consumeChangedParams())
+     * are reconverted, so the matrix should be the extension's only consumer of change notifications.
      * Call once per block before process().
      */
     void loadParamBaseValues(const applause::ParamsExtension& params);
 
     /**
      * Processes modulation. Should be called once per block, before parameters are read and used by DSP components.
+     *
+     * If nothing that feeds the outputs changed since the previous block (source values, base values, depths,
+     * connections, or the set of active voices), the previous block's outputs are still correct and process()
+     * returns without recomputing them. Ramping handles then report a flat ramp, and no new UI snapshot is
+     * published.
      */
     void process();
 
+    /**
+     * Same as process(), but spreads the per-voice passes over the pool's threads (the host's, or the fallback
+     * pool), with each task handling voices_per_task active voices (VoiceRows) or that many lanes (VoiceLanes).
+     * Falls back to running them serially when there is no pool, the host refuses the request, or there is only
+     * one task's worth of work.
+     *
+     * For the duration of the call the pool's task callback is replaced with the matrix's own, then restored.
+     */
+    void processParallel(ThreadPoolExtension& pool, uint32_t voices_per_task = 8);
+
+    /** Number of process() calls that reused the previous block's outputs because no input changed. */
+    [[nodiscard]] uint64_t getQuiescentBlockCount() const { return quiescent_block_count_; }
+
+    /**
+     * Returns the most recent block's output values published by process(). Lock-free and wait-free; call from a
+     * single UI thread. The returned snapshot stays valid and unchanged until the next call.
+     */
+    [[nodiscard]] const ModUiSnapshot& acquireUiSnapshot();
+
+    [[nodiscard]] ModVoiceLayout getVoiceLayout() const { return config_.voice_layout; }
+
+    [[nodiscard]] const Config& getConfig() const { return config_; }
+
 private:
+    // Offsets into the per-voice buffers. Under VoiceRows the voice stride is the row length and the index stride
+    // is 1; under VoiceLanes the voice stride is 1 and the index stride is the padded lane count.
+    [[nodiscard]] size_t polySrcOffset(uint16_t voice, uint16_t srcIdx) const {
+        return static_cast<size_t>(voice) * poly_src_stride_ + static_cast<size_t>(srcIdx) * poly_src_index_stride_;
+    }
+    [[nodiscard]] size_t polyDstOffset(uint16_t voice, uint16_t dstIdx) const {
+        return static_cast<size_t>(voice) * poly_dst_stride_ + static_cast<size_t>(dstIdx) * poly_dst_index_stride_;
+    }
+    [[nodiscard]] size_t polyDepthOffset(uint16_t voice, uint16_t slot) const {
+        return static_cast<size_t>(voice) * poly_depth_stride_ + static_cast<size_t>(slot) * poly_depth_index_stride_;
+    }
+
+    /** With ramp_outputs: saves this block's outputs as the next block's start values. */
+    void saveRampStartValues();
+
+    /** With ramp_outputs: snaps start values to end values for first-block voices, so new notes don't glide. */
+    void snapFreshRamps();
+
+    /**
+     * Runs everything up to the per-voice passes: program pickup, quiescence check and the mono stages. Returns
+     * nullptr if the block is quiescent and nothing else needs to run.
+     */
+    const ModProgram* beginBlock();
+
+    /** Smoothing, ramp bookkeeping and UI publication after the per-voice passes. */
+    void endBlock();
+
+    /**
+     * Per-voice passes are split into independent work units: active voices (VoiceRows) or SIMD batches of lanes
+     * (VoiceLanes). Returns the number of units in this block.
+     */
+    [[nodiscard]] uint32_t voiceWorkUnits() const;
+
+    /** Runs the per-voice passes for work units [first, last). Distinct ranges may run concurrently. */
+    void processVoiceUnits(const ModProgram& prog, uint32_t first, uint32_t last);
+
+    /** Scalar per-voice passes over VoiceRows storage for voice_order_[first, last) (reference implementation). */
+    void processVoiceRows(const ModProgram& prog, uint32_t first, uint32_t last);
+
+    /** SIMD per-voice passes over VoiceLanes storage for lanes [lane_begin, lane_end); see ModVoiceLayout. */
+    void processVoiceLanes(const ModProgram& prog, uint32_t lane_begin, uint32_t lane_end);
+
+    /** Rebuilds voice_order_ from active_mask_. */
+    void rebuildVoiceOrder();
+
+    /** VoiceLanes only: rebuilds lane_active_ and the [lane_begin_, lane_end_) range from voice_order_. */
+    void updateLaneMask();
+
+    /** Collapses a poly source's active-voice values into one value. Requires at least one active voice. */
+    [[nodiscard]] float reducePolySource(uint16_t srcIdx, ModReduction reduction) const;
+
     // Depth accessors for ModConnection (avoids dangling pointer issues)
     [[nodiscard]] float getDepthBase(uint16_t slot) const { return program_.depth_base_[slot]; }
-    void setDepthBase(uint16_t slot, float value) { program_.depth_base_[slot] = value; }
+    void setDepthBase(uint16_t slot, float value);
+
+    /**
+     * Copies the editable program into a spare snapshot and hands it to the audio thread. Editing thread only.
+     */
+    void publishProgram();
+    void rebuildScalers(ModProgram& prog) const;
+
+    ModMatrix(Config config, MemoryArena* arena);
+    void carveBuffers(MemoryArena& arena);
+
+    static constexpr size_t kNumArenaBuffers = 17;
+
+    // Lengths of the per-block buffers, in the order carveBuffers() lays them out. Both layouts hold the same
+    // number of voice slots; VoiceLanes pads each row up to a whole SIMD batch.
+    static constexpr std::array<size_t, kNumArenaBuffers> arenaBufferLengths(const Config& config) {
+        constexpr size_t width = xsimd::batch<float>::size;
+        const size_t lanes =
+            config.voice_layout == ModVoiceLayout::VoiceLanes ? (config.num_voices + width - 1) / width * width : 0;
+        const size_t voices = lanes ? lanes : config.num_voices;
+        const size_t dsts = config.max_destinations;
+        const size_t poly_dsts = voices * dsts;
+        return {
+            dsts,                                 // base_plain_dst_
+            dsts,                                 // base_mono_dst_
+            dsts,                                 // mono_dst_
+            config.max_connections,               // mono_depth_buf_
+            config.max_sources,                   // mono_src_buf_
+            lanes,                                // lane_active_
+            voices * config.max_sources,          // poly_src_buf_
+            dsts,                                 // base_poly_dst_
+            voices * config.max_connections,      // poly_depth_buf_
+            lanes ? poly_dsts : 0,                // poly_dst_acc_
+            poly_dsts,                            // poly_dst_buf_
+            config.ramp_outputs ? dsts : 0,       // prev_mono_dst_
+            config.ramp_outputs ? poly_dsts : 0,  // prev_poly_dst_buf_
+            config.smooth_outputs ? dsts : 0,       // smooth_coeff_
+            config.smooth_outputs ? dsts : 0,       // smooth_mono_state_
+            config.smooth_outputs ? poly_dsts : 0,  // smooth_poly_state_
+            config.host_modulation ? poly_dsts : 0,  // host_poly_mod_
+        };
+    }
+    void publishUiSnapshot();
+    void updateSmoothingCoeff(uint16_t dstIdx);
+    [[nodiscard]] bool smoothOutputs();
+    void markInputsChanged() { inputs_changed_.store(true, std::memory_order_release); }
+
+    /**
+     * Picks up the newest published snapshot, if any, and returns the snapshot the audio thread owns for this
+     * block. Audio thread only.
+     */
+    const ModProgram& acquireProgram();
 
     /**
      * Allocates a depth slot, reusing tombstoned slots when available.
@@ -540,21 +1104,96 @@ private:
     uint16_t allocateDepthSlot(float initial_depth);
 
     /**
-     * Rebuilds the modulation program object. Called whenever the user changes the modulation matrix state.
+     * Builds the program handle for a connection and picks the program bucket it belongs in, based on the
+     * effective source mode and the destination mode.
      */
-    void recompileProgram();
+    [[nodiscard]] std::pair<uint8_t, ModConnectionHandle> compileConnection(const ModConnection& conn) const;
 
-    const Config config_;
-    const uint32_t poly_src_stride_;  // = max_sources
-    const uint32_t poly_dst_stride_;  // = max_destinations
-    const uint32_t poly_depth_stride_;  // = max_connections
+    /** Re-compiles a single connection's handle in place, moving it between buckets if needed. */
+    void patchProgram(const ModConnection& conn);
+
+    /** Records a change for the current edit; see commitEdit(). */
+    void recordChange(ModConnectionChange::Kind kind, const ModConnection& conn);
+
+    /**
+     * Publishes the program and notifies listeners of the changes recorded since the last commit. Inside a
+     * beginEdit() batch, only notes whether the topology changed; endEdit() does the rest.
+     */
+    void commitEdit(bool topology_changed);
+
+    bool removeConnectionImpl(const ModConnection& connection);
+
+    /** Looks up a connection by depth slot, or nullptr. O(1). */
+    [[nodiscard]] ModConnection* connectionAt(uint16_t depthSlot);
+    [[nodiscard]] const ModConnection* connectionAt(uint16_t depthSlot) const;
 
-    ModProgram program_;
+    /** Looks up a connection by kind and (src, dst-or-target-slot), or nullptr. O(1). */
+    [[nodiscard]] ModConnection* findIndexed(bool depth_mod, uint16_t srcIdx, uint16_t dstIdx);
+
+    [[nodiscard]] static uint64_t connectionKey(bool depth_mod, uint16_t srcIdx, uint16_t dstIdx) {
+        return (static_cast<uint64_t>(depth_mod) << 32) | (static_cast<uint64_t>(srcIdx) << 16) | dstIdx;
+    }
+
+    // Keep conn_index_ and the adjacency lists in sync with a connection's (kind, src, dst)
+    void indexConnection(const ModConnection& c);
+    void unindexConnection(const ModConnection& c);
+
+    /** Refreshes slot_pos_ for connections_[from..] after an erase shifted them. */
+    void reindexPositions(size_t from);
+
+    /** Frees a connection's slot, program handle and index entries. The caller erases it from connections_. */
+    void tombstoneConnection(const ModConnection& c);
+
+    /** Shared merge path for reassignSource/reassignDestination when the new route already exists. */
+    ModConnection mergeInto(ModConnection& moving, ModConnection& peer);
+
+    const Config config_;
+    const uint32_t lane_stride_;  // = num_voices rounded up to a whole SIMD batch (VoiceLanes only)
+    const uint32_t poly_src_stride_;  // voice stride: max_sources (rows) or 1 (lanes)
+    const uint32_t poly_dst_stride_;  // voice stride: max_destinations (rows) or 1 (lanes)
+    const uint32_t poly_depth_stride_;  // voice stride: max_connections (rows) or 1 (lanes)
+    const uint32_t poly_src_index_stride_;  // index stride: 1 (rows) or lane_stride_ (lanes)
+    const uint32_t poly_dst_index_stride_;
+    const uint32_t poly_depth_index_stride_;
+
+    ModProgram program_;  // editable program; only touched by the editing thread
+
+    // Triple buffer of published programs. Each index is owned by exactly one side at a time: edit_snapshot_ by the
+    // editing thread, audio_snapshot_ by the audio thread, and back_snapshot_ by whoever exchanges it next. The
+    // fresh bit marks a back snapshot the audio thread hasn't picked up yet.
+    static constexpr uint8_t kSnapshotIndexMask = 0x3;
+    static constexpr uint8_t kSnapshotFresh = 0x4;
+    std::array<ModProgram, 3> snapshots_;
+    uint8_t edit_snapshot_ = 0;
+    uint8_t audio_snapshot_ = 1;
+    std::atomic<uint8_t> back_snapshot_{2};
+
+    // Second triple buffer carrying output values the other way: written by the audio thread, read by the UI
+    std::array<ModUiSnapshot, 3> ui_snapshots_;
+    uint8_t ui_write_snapshot_ = 0;
+    uint8_t ui_read_snapshot_ = 1;
+    std::atomic<uint8_t> ui_back_snapshot_{2};
+    uint64_t block_count_ = 0;
+    // Audio thread: the values last published, laid out like ModUiSnapshot, to detect which destinations moved
+    std::vector<float> ui_last_mono_;
+    std::vector<float> ui_last_poly_;
+    std::vector<uint16_t> ui_last_voices_;
+    std::vector<uint64_t> ui_dst_versions_;
 
     int src_count_ = 0;
     int dst_count_ = 0;
 
+    // Active voices. active_voices_ is dense and unordered (voice on/off append and swap-remove), voice_pos_ maps
+    // a voice to its position in it (kNoPos when inactive), and active_mask_ holds one bit per voice.
+    // voice_order_ is the active set in ascending voice order, rebuilt from the mask at the start of each
+    // computed block so the per-voice passes walk the voice rows front to back. voice_stamp_ records trigger
+    // order for the LastVoice reduction.
     std::vector<uint16_t> active_voices_;
+    std::vector<uint16_t> voice_pos_;
+    std::vector<uint64_t> active_mask_;
+    std::vector<uint16_t> voice_order_;
+    std::vector<uint64_t> voice_stamp_;
+    uint64_t next_voice_stamp_ = 0;
 
     std::unordered_map<std::string, uint16_t> src_lookup_;
     std::unordered_map<std::string, uint16_t> dst_lookup_;
@@ -562,23 +1201,86 @@ private:
     std::vector<ModSource> src_registry_;
     std::vector<ModDestination> dst_registry_;
     std::vector<applause::ValueScaleInfo> dst_scale_info_;
+    applause::ValueScalingBatch param_scaler_;  // destinations registered from the params extension
+    uint16_t num_param_dsts_ = 0;
+    const applause::ParamsExtension* params_ = nullptr;  // set by registerFromParamsExtension()
     std::vector<uint16_t> poly_dst_indices_;  // indices of poly destinations only; small optimization
 
-    // Source values (written by modulators before processBlock)
-    std::vector<float> mono_src_buf_;
-    std::vector<float> poly_src_buf_;
+    // Per-block buffers. All of them live in one arena block (owned_storage_ unless an arena was supplied), each
+    // starting on a cache line, in the order below, which follows the order process() first touches them.
+    std::vector<std::byte> owned_storage_;
 
-    // Base destination values (unmodulated knob values, optional)
-    std::vector<float> base_mono_dst_;
-    std::vector<float> base_poly_dst_;
+    // Base destination values (unmodulated knob values, optional): plain clamped to range, and normalized
+    std::span<float> base_plain_dst_;
+    std::span<float> base_mono_dst_;
 
-    std::vector<float> mono_depth_buf_;
-    std::vector<float> poly_depth_buf_;
+    std::span<float> mono_dst_;
+    std::span<float> mono_depth_buf_;
 
-    std::vector<float> mono_dst_;
-    std::vector<float> poly_dst_buf_;
+    // Source values (written by modulators before processBlock)
+    std::span<float> mono_src_buf_;
+
+    // VoiceLanes only: per-lane activity mask (1.0f for active voices) used to leave inactive voices' outputs
+    // untouched, and normalized accumulator rows for poly destinations.
+    std::span<float> lane_active_;
+    uint32_t lane_begin_ = 0;
+    uint32_t lane_end_ = 0;
+
+    std::span<float> poly_src_buf_;
+    std::span<float> base_poly_dst_;
+    std::span<float> poly_depth_buf_;
+    std::span<float> poly_dst_acc_;
+    std::span<float> poly_dst_buf_;
+
+    // ramp_outputs only: previous block's outputs (same layout as mono_dst_ / poly_dst_buf_), and voices that
+    // became active since the last process() call.
+    std::span<float> prev_mono_dst_;
+    std::span<float> prev_poly_dst_buf_;
+
+    // smooth_outputs only: per-destination one-pole coefficient (1 = unsmoothed), and the smoothed outputs
+    // (same layout as mono_dst_ / poly_dst_buf_).
+    std::span<float> smooth_coeff_;
+    std::span<float> smooth_mono_state_;
+    std::span<float> smooth_poly_state_;
+    std::vector<float> smoothing_ms_;
+
+    // host_modulation only: per-voice plain offsets from host per-note modulation (same layout as poly_dst_buf_),
+    // and the poly destinations that have ever received one.
+    std::span<float> host_poly_mod_;
+    std::vector<uint16_t> host_mod_dsts_;
+    std::vector<uint8_t> host_mod_flags_;
+    double block_rate_ = 0.0;  // process() calls per second; 0 until setBlockRate()
+    bool smoothing_active_ = false;
+    bool smoothing_primed_ = false;
+    std::vector<uint16_t> fresh_voices_;  // voices that became active since the last computed block
+    bool ramp_primed_ = false;
+    bool ramp_settled_ = false;  // prev_* already equal the current outputs (set by a quiescent block)
+
+    // Quiescence tracking. Set by every input write (any thread that may write inputs), consumed by process().
+    std::atomic<bool> inputs_changed_{true};
+    bool param_bases_seeded_ = false;
+    uint64_t quiescent_block_count_ = 0;
+
+    // processParallel() only: the block's program and work-unit split, read by the pool's tasks
+    const ModProgram* parallel_prog_ = nullptr;
+    uint32_t parallel_units_ = 0;
+    uint32_t parallel_units_per_task_ = 1;
 
     std::vector<ModConnection> connections_;
+    std::vector<ModConnectionChange> pending_changes_;
+    uint32_t edit_depth_ = 0;  // open beginEdit() batches
+    bool pending_topology_change_ = false;
+
+    // Edit-side connection index, kept in sync by every mutation so edits and lookups don't scan connections_.
+    // conn_index_ maps connectionKey(kind, src, dst) -> depth slot; slot_pos_ maps depth slot -> position in
+    // connections_. The adjacency lists hold depth slots: src_adj_ per source (all kinds), dst_adj_ per destination
+    // (param connections), dm_adj_ per target slot (depth mods).
+    static constexpr uint16_t kNoPos = 0xFFFF;
+    std::unordered_map<uint64_t, uint16_t> conn_index_;
+    std::vector<uint16_t> slot_pos_;
+    std::vector<std::vector<uint16_t>> src_adj_;
+    std::vector<std::vector<uint16_t>> dst_adj_;
+    std::vector<std::vector<uint16_t>> dm_adj_;
 
     friend class ModProgram;
     friend struct ModConnection;
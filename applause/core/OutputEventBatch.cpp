@@ -0,0 +1,66 @@
+#include "OutputEventBatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace applause {
+namespace {
+// Events hold doubles and pointers; keep every copy aligned for them
+constexpr size_t kEventAlignment = std::max(alignof(double), alignof(void*));
+}  // namespace
+
+OutputEventBatch::OutputEventBatch(size_t capacity_bytes, size_t max_events)
+    : storage_(std::make_unique<std::byte[]>(capacity_bytes)),
+      capacity_bytes_(capacity_bytes),
+      entries_(std::make_unique<Entry[]>(max_events)),
+      max_events_(max_events) {
+    list_.ctx = this;
+    list_.try_push = listTryPush;
+}
+
+bool OutputEventBatch::push(const clap_event_header_t& event) noexcept {
+    const size_t offset = (used_bytes_ + kEventAlignment - 1) / kEventAlignment * kEventAlignment;
+    if (count_ == max_events_ || event.size < sizeof(clap_event_header_t) || offset + event.size > capacity_bytes_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    auto* copy = reinterpret_cast<clap_event_header_t*>(storage_.get() + offset);
+    std::memcpy(copy, &event, event.size);
+    if (time_offset_ != 0 || max_time_ != UINT32_MAX) {
+        copy->time = std::min(event.time > UINT32_MAX - time_offset_ ? UINT32_MAX : event.time + time_offset_,
+                              max_time_);
+    }
+    entries_[count_++] = {copy->time, static_cast<uint32_t>(offset)};
+    used_bytes_ = offset + event.size;
+    return true;
+}
+
+uint32_t OutputEventBatch::flush(const clap_output_events_t* out) noexcept {
+    uint32_t refused = 0;
+    if (out) {
+        // Offsets grow with push order, so they break ties between events of equal time; std::sort doesn't allocate
+        std::sort(entries_.get(), entries_.get() + count_, [](const Entry& a, const Entry& b) {
+            return a.time != b.time ? a.time < b.time : a.offset < b.offset;
+        });
+        for (uint32_t i = 0; i < count_; ++i) {
+            const auto* event = reinterpret_cast<const clap_event_header_t*>(storage_.get() + entries_[i].offset);
+            if (!out->try_push(out, event)) ++refused;
+        }
+    } else {
+        refused = count_;
+    }
+    if (refused > 0) dropped_.fetch_add(refused, std::memory_order_relaxed);
+    clear();
+    return refused;
+}
+
+void OutputEventBatch::clear() noexcept {
+    count_ = 0;
+    used_bytes_ = 0;
+}
+
+bool OutputEventBatch::listTryPush(const clap_output_events_t* list, const clap_event_header_t* event) noexcept {
+    return event && static_cast<OutputEventBatch*>(list->ctx)->push(*event);
+}
+
+}  // namespace applause
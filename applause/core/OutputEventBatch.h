@@ -0,0 +1,92 @@
+#pragma once
+
+#include <clap/events.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace applause {
+
+/**
+ * Collects a block's output events and hands them to the host all at once, sorted by time.
+ *
+ * PluginBase gives process() a batch instead of the host's list: ProcessContext::outputEvents() is a
+ * clap_output_events_t whose try_push() copies the event into preallocated storage, so ParamsExtension's
+ * gestures and value changes, the Synthesizer's NOTE_ENDs and the plugin's own MIDI output can be pushed in any
+ * order, from any stage of the block. Once process() returns, flush() sorts the events by time, keeping events of
+ * equal time in push order, and pushes them to the host's list in one go.
+ *
+ * Pushing never allocates. An event that doesn't fit the storage is refused, like a full host list would, and
+ * counted in getDroppedCount().
+ */
+class OutputEventBatch {
+public:
+    static constexpr size_t kDefaultCapacityBytes = 64 * 1024;
+    static constexpr size_t kDefaultMaxEvents = 2048;
+
+    /** Main thread: preallocates capacity_bytes of event storage for up to max_events events per block. */
+    explicit OutputEventBatch(size_t capacity_bytes = kDefaultCapacityBytes, size_t max_events = kDefaultMaxEvents);
+
+    OutputEventBatch(const OutputEventBatch&) = delete;
+    OutputEventBatch& operator=(const OutputEventBatch&) = delete;
+
+    /** Copies the event (header.size bytes) into the batch. false if it doesn't fit. */
+    bool push(const clap_event_header_t& event) noexcept;
+
+    /** push() for a complete CLAP event struct, e.g. a clap_event_note_t. */
+    template <typename Event>
+    bool push(const Event& event) noexcept {
+        return push(event.header);
+    }
+
+    /**
+     * Moves events pushed from now on by offset frames, and no later than max_time, so events from a part of the
+     * block (FixedBlockAdapter's blocks) land at their time in the whole block. Reset with setTimeOffset(0).
+     */
+    void setTimeOffset(uint32_t offset, uint32_t max_time = UINT32_MAX) noexcept {
+        time_offset_ = offset;
+        max_time_ = max_time;
+    }
+
+    /** The batch as a list for code that takes the host's clap_output_events_t. */
+    [[nodiscard]] const clap_output_events_t* outputEvents() const noexcept { return &list_; }
+
+    /** Events pushed since the last flush() or clear(). */
+    [[nodiscard]] uint32_t size() const noexcept { return count_; }
+
+    /**
+     * Sorts the pending events by time and pushes them to out, then clears the batch. Returns how many the host
+     * refused; with out == nullptr every pending event is discarded.
+     */
+    uint32_t flush(const clap_output_events_t* out) noexcept;
+
+    /** Drops the pending events without sending them. */
+    void clear() noexcept;
+
+    /** Events refused since construction, by the batch or by the host. Safe from any thread. */
+    [[nodiscard]] uint64_t getDroppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint32_t time;
+        uint32_t offset;  // Into storage_
+    };
+
+    static bool listTryPush(const clap_output_events_t* list, const clap_event_header_t* event) noexcept;
+
+    std::unique_ptr<std::byte[]> storage_;
+    size_t capacity_bytes_ = 0;
+    size_t used_bytes_ = 0;
+    std::unique_ptr<Entry[]> entries_;
+    size_t max_events_ = 0;
+    uint32_t count_ = 0;
+    uint32_t time_offset_ = 0;
+    uint32_t max_time_ = UINT32_MAX;
+    std::atomic<uint64_t> dropped_{0};
+
+    clap_output_events_t list_{};
+};
+
+}  // namespace applause
@@ -1,14 +1,35 @@
 #pragma once
 
+#include <applause/core/DeadlineProfiler.h>
+#include <applause/core/EventRouter.h>
+#include <applause/core/FixedBlockAdapter.h>
 #include <applause/core/ModMatrix.h>
+#include <applause/core/OutputEventBatch.h>
 #include <applause/core/ProcessContext.h>
 #include <applause/core/ProcessInfo.h>
+#include <applause/core/QualityTier.h>
+#include <applause/core/RealtimeSafety.h>
+#include <applause/core/RealtimeScope.h>
+#include <applause/core/Telemetry.h>
+#include <applause/util/BackgroundJobs.h>
 #include <applause/util/MemoryArena.h>
 #include <clap/clap.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <applause/core/Extension.h>
+#include <applause/extensions/AudioPortsExtension.h>
+#include <applause/extensions/LatencyExtension.h>
+#include <applause/extensions/RenderExtension.h>
+#include <applause/extensions/TailExtension.h>
 
 namespace applause {
 
@@ -26,7 +47,39 @@ private:
     clap_plugin_t _plugin;
     const clap_host_t* _host;
     std::unordered_map<std::string, IExtension*> _extensions;
+    // Typed lookups index this by detail::extensionSlot<ExtType>(); the map serves the host's get_extension()
+    std::array<IExtension*, detail::kMaxExtensionSlots> extension_slots_{};
     bool extensions_connected_ = false;
+    bool flush_denormals_ = true;
+
+    // Real-time scratch for ProcessContext::scratch(), sized at activate() and rewound after every block
+    static constexpr size_t kDefaultScratchBytesPerFrame = 32 * sizeof(float);
+    static constexpr size_t kDefaultScratchFixedBytes = 16 * 1024;
+    size_t scratch_bytes_per_frame_ = kDefaultScratchBytesPerFrame;
+    size_t scratch_fixed_bytes_ = kDefaultScratchFixedBytes;
+    std::unique_ptr<std::byte[]> scratch_storage_;  // kept across deactivate(), only regrown for a larger size
+    size_t scratch_storage_bytes_ = 0;
+    MemoryArena scratch_;
+    std::atomic<size_t> scratch_peak_{0};
+
+    // Fetches each block's input events once for every consumer, see ProcessContext::inputEvents()
+    EventRouter event_router_;
+    // Collects the block's output events, sent to the host sorted by time once process() returns
+    OutputEventBatch output_batch_;
+    // This instance's jobs on the process-wide background threads; completions run from on_main_thread()
+    JobGroup background_jobs_;
+    // Cuts host blocks into fixed-size ones once setFixedBlockSize() is set, configured at activate()
+    uint32_t fixed_block_size_ = 0;
+    FixedBlockMode fixed_block_mode_ = FixedBlockMode::VariableTail;
+    FixedBlockAdapter block_adapter_;
+
+    // Times process() when profiling is compiled in, and whenever telemetry is on
+    static constexpr bool kProfileDeadlines = APPLAUSE_ENABLE_PROFILING != 0;
+    DeadlineProfiler deadline_profiler_;
+    double sample_rate_ = 0.0;
+    // This instance's slot in the process's telemetry segment, claimed at activate() once enableTelemetry() is set
+    bool telemetry_enabled_ = false;
+    TelemetryPublisher telemetry_;
 
     // Static C function dispatchers for core plugin functions
     static bool clapInit(const clap_plugin_t* plugin) noexcept {
@@ -43,6 +96,8 @@ private:
 
     static void clapDestroy(const clap_plugin_t* plugin) noexcept {
         auto* self = static_cast<PluginBase*>(plugin->plugin_data);
+        // No background job may still be running against the plugin destroy() tears down
+        self->background_jobs_.shutdown();
         self->destroy();
         delete self;
     }
@@ -50,14 +105,27 @@ private:
     static bool clapActivate(const clap_plugin_t* plugin, double sample_rate, uint32_t min_frames_count,
                              uint32_t max_frames_count) noexcept {
         auto* self = static_cast<PluginBase*>(plugin->plugin_data);
-        const ProcessInfo info{
-            .sample_rate = sample_rate, .min_frame_size = min_frames_count, .max_frame_size = max_frames_count};
-        return self->activate(info);
+        const ProcessInfo info = self->configureBlocks(
+            {.sample_rate = sample_rate, .min_frame_size = min_frames_count, .max_frame_size = max_frames_count});
+        if (!self->allocateScratch(info)) return false;
+        self->sample_rate_ = sample_rate;
+        if (!self->activate(info)) return false;
+        // Only once activation succeeded: the host doesn't deactivate a plugin that failed to activate
+        if (self->telemetry_enabled_) {
+            const char* id = self->_plugin.desc != nullptr ? self->_plugin.desc->id : nullptr;
+            if (!self->telemetry_.claim(TelemetrySegment::shared(), id, sample_rate, info.max_frame_size,
+                                        self->telemetryCounters())) {
+                LOG_WARN("PluginBase: all {} telemetry slots are taken; this instance isn't published",
+                         kTelemetrySlotCount);
+            }
+        }
+        return true;
     }
 
     static void clapDeactivate(const clap_plugin_t* plugin) noexcept {
         auto* self = static_cast<PluginBase*>(plugin->plugin_data);
         self->deactivate();
+        self->telemetry_.release();
     }
 
     static bool clapStartProcessing(const clap_plugin_t* plugin) noexcept {
@@ -72,6 +140,7 @@ private:
 
     static void clapReset(const clap_plugin_t* plugin) noexcept {
         auto* self = static_cast<PluginBase*>(plugin->plugin_data);
+        self->block_adapter_.reset();
         self->reset();
     }
 
@@ -80,8 +149,110 @@ private:
         const clap_process_t* process) noexcept {
         if (process == nullptr) return CLAP_PROCESS_ERROR;
         auto* self = static_cast<PluginBase*>(plugin->plugin_data);
-        ProcessContext context{*process};
-        return static_cast<clap_process_status>(self->process(context));
+        const bool timed = kProfileDeadlines || self->telemetry_.isActive();
+        const uint64_t start_ns = timed ? deadlineClockNanos() : 0;
+        const RealtimeScope realtime{self->flush_denormals_};
+#if APPLAUSE_REALTIME_CHECKS
+        const RealtimeThreadScope realtime_thread;
+#endif
+        const QualityTierScope quality{self->getQualityTier()};
+        self->event_router_.begin(process->in_events);
+        const auto run = [&](const clap_process_t& block) {
+            ProcessContext context{block, &self->scratch_, &self->event_router_, &self->output_batch_};
+            const MemoryArena::Frame frame{self->scratch_};
+            const ProcessStatus result = self->process(context);
+            context.commitBridgedOutputs();
+            return result;
+        };
+        ProcessStatus status;
+        if (self->block_adapter_.isEnabled()) {
+            // The adapter copies the host's events first; the router then serves each block's in turn
+            status = self->block_adapter_.process(*process, self->event_router_, self->output_batch_,
+                                                  [&](const clap_process_t& block) {
+                                                      self->event_router_.begin(block.in_events);
+                                                      return run(block);
+                                                  });
+        } else {
+            status = run(*process);
+        }
+        self->output_batch_.flush(process->out_events);
+        if (auto* tail = self->getExtension<TailExtension>()) tail->notifyHost();
+        self->scratch_peak_.store(self->scratch_.getPeakBytesUsed(), std::memory_order_relaxed);
+        if (timed) {
+            self->deadline_profiler_.record(deadlineClockNanos() - start_ns, process->frames_count,
+                                            self->event_router_.size(), self->sample_rate_);
+        }
+        if (self->telemetry_.advance(process->frames_count)) {
+            self->telemetry_.publish(self->telemetryCounters());
+        }
+        self->event_router_.end();
+        return static_cast<clap_process_status>(status);
+    }
+
+    /**
+     * Sets up the block adapter for activation and returns what process() will see: with a fixed block size, blocks
+     * of at most that size, and in Latency mode exactly that size.
+     */
+    ProcessInfo configureBlocks(ProcessInfo info) {
+        auto* latency = getExtension<LatencyExtension>();
+        if (fixed_block_size_ == 0) {
+            block_adapter_.disable();
+            if (latency) latency->setFrameworkLatency(0);
+            return info;
+        }
+
+        std::vector<uint32_t> input_channels;
+        std::vector<uint32_t> output_channels;
+        if (const auto* ports = getExtension<AudioPortsExtension>()) {
+            for (const auto& port : ports->inputPorts()) input_channels.push_back(port.channel_count);
+            for (const auto& port : ports->outputPorts()) output_channels.push_back(port.channel_count);
+        } else {
+            LOG_WARN("PluginBase: fixed block size without an AudioPortsExtension; blocks carry no audio");
+        }
+        block_adapter_.configure(fixed_block_size_, fixed_block_mode_, input_channels, output_channels);
+
+        if (latency) {
+            latency->setFrameworkLatency(block_adapter_.latency());
+        } else if (block_adapter_.latency() > 0) {
+            LOG_WARN("PluginBase: FixedBlockMode::Latency adds {} samples but no LatencyExtension reports them",
+                     block_adapter_.latency());
+        }
+
+        if (fixed_block_mode_ == FixedBlockMode::Latency) {
+            info.min_frame_size = fixed_block_size_;
+            info.max_frame_size = fixed_block_size_;
+        } else {
+            info.min_frame_size = std::min<uint32_t>(info.min_frame_size, 1);
+            info.max_frame_size = std::min(info.max_frame_size, fixed_block_size_);
+        }
+        return info;
+    }
+
+    // What the telemetry slot publishes, and its baseline at claim()
+    TelemetryCounters telemetryCounters() const noexcept {
+        return {.profiler = &deadline_profiler_,
+                .dropped_output_events = output_batch_.getDroppedCount(),
+                .dropped_input_events = block_adapter_.getDroppedEventCount(),
+                .scratch_peak_bytes = scratch_.getPeakBytesUsed(),
+                .scratch_capacity_bytes = scratch_.getCapacity()};
+    }
+
+    // Sizes the scratch arena for info; false if the memory can't be had, which fails the activation
+    bool allocateScratch(const ProcessInfo& info) noexcept {
+        const size_t bytes = scratch_fixed_bytes_ + scratch_bytes_per_frame_ * info.max_frame_size;
+        if (bytes > scratch_storage_bytes_) {
+            scratch_ = MemoryArena{};
+            scratch_storage_.reset(new (std::nothrow) std::byte[bytes]);
+            scratch_storage_bytes_ = scratch_storage_ ? bytes : 0;
+            if (!scratch_storage_) {
+                LOG_ERR("PluginBase: can't allocate {} bytes of scratch memory", bytes);
+                return false;
+            }
+        }
+        // Reactivating with the same or a smaller size reuses the storage
+        scratch_ = MemoryArena{scratch_storage_.get(), bytes};
+        scratch_peak_.store(0, std::memory_order_relaxed);
+        return true;
     }
 
     static const void* clapGetExtension(const clap_plugin_t* plugin, const char* id) noexcept {
@@ -90,13 +261,30 @@ private:
         return it != self->_extensions.end() ? it->second->getClapExtensionStruct() : nullptr;
     }
 
+    template <typename ExtType>
+    IExtension* lookupExtension() const {
+        const size_t slot = detail::extensionSlot<ExtType>();
+        if (slot != detail::kNoExtensionSlot) return extension_slots_[slot];
+        auto it = _extensions.find(ExtType::ID);
+        return it != _extensions.end() ? it->second : nullptr;
+    }
+
     static void clapOnMainThread(const clap_plugin_t* plugin) noexcept {
         auto* self = static_cast<PluginBase*>(plugin->plugin_data);
+        self->background_jobs_.dispatchCompletions();
+        for (auto& [id, ext] : self->_extensions) {
+            (void)id;
+            ext->onMainThread();
+        }
         self->onMainThread();
     }
 
 protected:
-    PluginBase(const clap_plugin_descriptor_t* desc, const clap_host_t* host) : _host(host) {
+    PluginBase(const clap_plugin_descriptor_t* desc, const clap_host_t* host) : _host(host), background_jobs_(host) {
+#ifndef NDEBUG
+        // Start the log's writer thread here rather than at the audio thread's first message
+        debug::Logger::instance();
+#endif
         // Initialize the C struct with our static dispatchers
         _plugin = {};
         _plugin.desc = desc;
@@ -111,12 +299,19 @@ protected:
         _plugin.process = clapProcess;
         _plugin.get_extension = clapGetExtension;
         _plugin.on_main_thread = clapOnMainThread;
+
+        // clapProcess() looks these up every block; resolve their slots here, off the audio thread
+        (void)detail::extensionSlot<RenderExtension>();
+        (void)detail::extensionSlot<TailExtension>();
     }
 
     virtual ~PluginBase() = default;
 
     void registerExtension(IExtension& ext) {
         _extensions[ext.id()] = &ext;
+        if (const size_t slot = detail::extensionSlotFor(ext.id()); slot != detail::kNoExtensionSlot) {
+            extension_slots_[slot] = &ext;
+        }
         if (extensions_connected_) {
             ext.assignHost(_host);
         }
@@ -127,9 +322,8 @@ protected:
      *
      * This is a convenience wrapper around the static findExtension().
      *
-     * If you need to access an extension regularly within audio processing code,
-     * e.g. every block, it is more efficient to call this once during
-     * preparation and then use the cached pointer during rendering.
+     * After the first call for a given type this is a single array load, so it
+     * is cheap enough for every CLAP callback and every block.
      *
      * @tparam ExtType The extension type
      * @return Pointer to extension if registered, nullptr otherwise
@@ -143,8 +337,7 @@ protected:
      */
     template <typename ExtType>
     ExtType* getExtension() {
-        auto it = _extensions.find(ExtType::ID);
-        return it != _extensions.end() ? static_cast<ExtType*>(it->second) : nullptr;
+        return static_cast<ExtType*>(lookupExtension<ExtType>());
     }
 
     /**
@@ -152,28 +345,130 @@ protected:
      */
     template <typename ExtType>
     const ExtType* getExtension() const {
-        auto it = _extensions.find(ExtType::ID);
-        return it != _extensions.end() ? static_cast<const ExtType*>(it->second) : nullptr;
+        return static_cast<const ExtType*>(lookupExtension<ExtType>());
     }
 
     // Access to host
     const clap_host_t* host() const { return _host; }
 
+    /**
+     * @brief Choose whether process() runs with denormals flushed to zero (the default).
+     *
+     * Every process() call runs inside a RealtimeScope, which sets FTZ/DAZ (x86) or FZ (ARM64) and restores the
+     * host's floating-point state afterwards. Disable it only for plugins whose DSP depends on gradual underflow.
+     */
+    void setFlushDenormals(bool enabled) noexcept { flush_denormals_ = enabled; }
+
+    /**
+     * @brief Process in blocks of a fixed size, whatever block sizes the host sends; 0 (the default) turns it off.
+     *
+     * Takes effect at the next activate(), whose ProcessInfo then reports the block size as max_frame_size, and in
+     * Latency mode as min_frame_size too. process() is called once per block, each with its own ProcessContext:
+     * the block's frames of every audio port, the events that fall into it, at times relative to its start, and
+     * the matching steady time; the transport is the host block's. Output events are moved back to host time.
+     *
+     * In FixedBlockMode::VariableTail nothing is delayed: a host block is cut into full blocks, then one shorter
+     * block for the rest. FixedBlockMode::Latency buffers audio so every block is exactly block_size, and adds
+     * block_size to the latency a registered LatencyExtension reports. Both need an AudioPortsExtension to size
+     * their buffers.
+     *
+     * @code
+     * MyPlugin(const clap_plugin_descriptor_t* desc, const clap_host_t* host) : PluginBase(desc, host) {
+     *     setFixedBlockSize(64);  // Every block is 64 frames, except at most the last of each host call
+     * }
+     * @endcode
+     */
+    void setFixedBlockSize(uint32_t block_size, FixedBlockMode mode = FixedBlockMode::VariableTail) noexcept {
+        fixed_block_size_ = block_size;
+        fixed_block_mode_ = mode;
+    }
+
+    /** Input events the fixed-block adapter had no room for, since construction. */
+    [[nodiscard]] uint64_t getDroppedFixedBlockEventCount() const noexcept {
+        return block_adapter_.getDroppedEventCount();
+    }
+
+    /**
+     * @brief Size the scratch arena behind ProcessContext::scratch().
+     *
+     * At the next activate() the arena gets fixed_bytes plus bytes_per_frame for every frame of
+     * ProcessInfo::max_frame_size; the default fits 32 float channels of temporaries plus 16 KiB. Leave room for
+     * alignment padding: allocateAudioBuffer() starts each buffer on a 64-byte boundary. getScratchPeakBytes()
+     * shows how much a plugin actually uses.
+     */
+    void setScratchBytesPerFrame(size_t bytes_per_frame, size_t fixed_bytes = kDefaultScratchFixedBytes) noexcept {
+        scratch_bytes_per_frame_ = bytes_per_frame;
+        scratch_fixed_bytes_ = fixed_bytes;
+    }
+
+    /**
+     * @brief Publish this instance's performance numbers for an external monitor.
+     *
+     * From the next activate() on, the instance holds a TelemetrySlot in the process's shared-memory segment
+     * (TelemetrySegment) and updates it from the audio thread a few times a second: deadline load and overruns,
+     * dropped events, scratch use, and whatever setTelemetryVoiceCount() and setTelemetryArena() report. Turning it
+     * on also times every process() call, as an APPLAUSE_ENABLE_PROFILING build does. A monitor reads the segment
+     * with TelemetryReader::open(pid) without ever touching the plugin's threads.
+     */
+    void enableTelemetry(bool enabled = true) noexcept { telemetry_enabled_ = enabled; }
+
+    /** Audio thread, from process(): the voice counts the next telemetry update carries. */
+    void setTelemetryVoiceCount(uint32_t active, uint32_t capacity) noexcept {
+        telemetry_.setVoiceCount(active, capacity);
+    }
+
+    /** Main thread, e.g. in activate(): an arena of the plugin's whose high-water mark telemetry publishes. */
+    void setTelemetryArena(const MemoryArena* arena) noexcept { telemetry_.setArena(arena); }
+
 public:
-    // Helper for extensions to find themselves from C callbacks
+    // Helper for extensions to find themselves from C callbacks; an array load, no hashing or allocation
     template <typename ExtType>
     static ExtType* findExtension(const clap_plugin_t* plugin) {
         auto* self = static_cast<PluginBase*>(plugin->plugin_data);
-        auto it = self->_extensions.find(ExtType::ID);
-        if (it != self->_extensions.end()) {
-            return static_cast<ExtType*>(it->second);
-        }
-        return nullptr;
+        return static_cast<ExtType*>(self->lookupExtension<ExtType>());
     }
 
     // Get the C plugin struct
     clap_plugin_t* clapPlugin() { return &_plugin; }
 
+    /**
+     * The timing of every process() call against its real-time deadline, for the UI or the inspector. nullptr
+     * unless the framework is built with APPLAUSE_ENABLE_PROFILING or this instance publishes telemetry.
+     */
+    [[nodiscard]] DeadlineProfiler* getDeadlineProfiler() noexcept {
+        return kProfileDeadlines || telemetry_.isActive() ? &deadline_profiler_ : nullptr;
+    }
+
+    /** Whether this instance has a slot in the process's telemetry segment, see enableTelemetry(). */
+    [[nodiscard]] bool isPublishingTelemetry() const noexcept { return telemetry_.isActive(); }
+
+    /** The tier process() runs at: Offline while a registered RenderExtension says the host renders offline. */
+    [[nodiscard]] QualityTier getQualityTier() const noexcept {
+        const auto* render = getExtension<RenderExtension>();
+        return render ? render->getQualityTier() : QualityTier::Realtime;
+    }
+
+    /**
+     * The router process() sees as ProcessContext::eventRouter(). Register event handlers on the main thread, e.g.
+     * in the constructor; during process() they run when the plugin dispatches.
+     */
+    [[nodiscard]] EventRouter& getEventRouter() noexcept { return event_router_; }
+
+    /**
+     * This instance's share of the process-wide background threads, for work too slow for the main thread and not
+     * part of process(): baking tables, loading samples, indexing presets. Completions run on the main thread, from
+     * the host's on_main_thread(), and the plugin waits for its running jobs before destroy().
+     */
+    [[nodiscard]] JobGroup& backgroundJobs() noexcept { return background_jobs_; }
+
+    /** Output events the host refused, or that didn't fit the block's batch, since construction. */
+    [[nodiscard]] uint64_t getDroppedOutputEventCount() const noexcept { return output_batch_.getDroppedCount(); }
+
+    /** The most scratch memory any process() call has used since activation, in bytes. Safe from any thread. */
+    [[nodiscard]] size_t getScratchPeakBytes() const noexcept {
+        return scratch_peak_.load(std::memory_order_relaxed);
+    }
+
     // Virtual methods for plugin implementation
     virtual bool init() { return true; }
 
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <applause/core/EventRouter.h>
+#include <applause/core/OutputEventBatch.h>
 #include <applause/dsp/BufferView.h>
 #include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
 
 #include <clap/process.h>
 
+#include <algorithm>
+#include <array>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <type_traits>
 
 namespace applause {
 
@@ -52,8 +58,14 @@ enum class ProcessStatus : int32_t {
  */
 class ProcessContext {
 public:
-    /** Creates a non-owning view of the supplied CLAP process data. */
-    explicit ProcessContext(const clap_process_t& process) noexcept : process_{process} {}
+    /**
+     * Creates a non-owning view of the supplied CLAP process data. scratch, if given, is the arena returned
+     * by scratch(); events, if given, has already been begun on process.in_events and backs inputEvents();
+     * out_batch, if given, backs outputEvents() and is flushed to process.out_events by the caller.
+     */
+    explicit ProcessContext(const clap_process_t& process, MemoryArena* scratch = nullptr,
+                            EventRouter* events = nullptr, OutputEventBatch* out_batch = nullptr) noexcept
+        : process_{process}, scratch_{scratch}, events_{events}, out_batch_{out_batch} {}
 
     /** Returns the number of sample frames in this process block. */
     [[nodiscard]] uint32_t numFrames() const noexcept { return process_.frames_count; }
@@ -69,11 +81,24 @@ public:
      */
     [[nodiscard]] const clap_event_transport_t* transport() const noexcept { return process_.transport; }
 
-    /** Returns the sample-ordered input event list supplied by the host. */
-    [[nodiscard]] const clap_input_events_t* inputEvents() const noexcept { return process_.in_events; }
+    /**
+     * Returns the sample-ordered input event list: the event router's cached copy of the host's list when there
+     * is one, so every consumer shares the router's single pass, otherwise the host's list itself.
+     */
+    [[nodiscard]] const clap_input_events_t* inputEvents() const noexcept {
+        return events_ ? events_->inputEvents() : process_.in_events;
+    }
+
+    /** Returns the block's event router, or nullptr when the context was created without one. */
+    [[nodiscard]] EventRouter* eventRouter() const noexcept { return events_; }
 
-    /** Returns the event list into which the plugin may enqueue output events. */
-    [[nodiscard]] const clap_output_events_t* outputEvents() const noexcept { return process_.out_events; }
+    /**
+     * Returns the event list into which the plugin may enqueue output events. Under PluginBase this is an
+     * OutputEventBatch, so events may be pushed in any order: they reach the host sorted by time after process().
+     */
+    [[nodiscard]] const clap_output_events_t* outputEvents() const noexcept {
+        return out_batch_ ? out_batch_->outputEvents() : process_.out_events;
+    }
 
     /**
      * Returns a read-only view of all audio input ports. Returns an empty span
@@ -103,8 +128,10 @@ public:
 
     /**
      * Returns a read-only sample view of an input port for the requested sample
-     * type. Returns an empty view if the port, format, channels, or capacity are
-     * unavailable.
+     * type. If the host only supplied the other format, e.g. 32-bit buffers to
+     * a plugin that processes in double, the port is converted into scratch()
+     * memory once per block. Returns an empty view if the port, channels, or
+     * capacity are unavailable.
      *
      * @tparam T float or double sample type.
      * @tparam ChannelCapacity Maximum number of channels the view can hold.
@@ -135,8 +162,11 @@ public:
         }
 
         if (!channelsAvailable(channels, buffer.channel_count)) {
-            LOG_ERR("ProcessContext: requested input sample format is unavailable on port {}", port);
-            return {};
+            channels = bridge<T>(buffer, static_cast<uint32_t>(port), false);
+            if (channels == nullptr) {
+                LOG_ERR("ProcessContext: requested input sample format is unavailable on port {}", port);
+                return {};
+            }
         }
 
         return {channels, buffer.channel_count, process_.frames_count};
@@ -144,8 +174,10 @@ public:
 
     /**
      * Returns a writable sample view of an output port for the requested sample
-     * type. Returns an empty view if the port, format, channels, or capacity are
-     * unavailable.
+     * type. If the host only supplied the other format, the view is scratch()
+     * memory holding a converted copy of the port, converted back into the
+     * host's buffers after process() returns. Returns an empty view if the
+     * port, channels, or capacity are unavailable.
      *
      * @tparam T float or double sample type.
      * @tparam ChannelCapacity Maximum number of channels the view can hold.
@@ -176,17 +208,236 @@ public:
         }
 
         if (!channelsAvailable(channels, buffer.channel_count)) {
-            LOG_ERR("ProcessContext: requested output sample format is unavailable on port {}", port);
-            return {};
+            channels = bridge<T>(buffer, static_cast<uint32_t>(port), true);
+            if (channels == nullptr) {
+                LOG_ERR("ProcessContext: requested output sample format is unavailable on port {}", port);
+                return {};
+            }
         }
 
         return {channels, buffer.channel_count, process_.frames_count};
     }
 
+    /**
+     * Flags channels of an output port as constant for this block: bit i set means every sample of channel i
+     * equals its first sample, e.g. a silent output. Lets the host skip work downstream.
+     */
+    void setConstantMask(std::size_t port, uint64_t mask) noexcept {
+        const auto outputs = audioOutputs();
+        if (port >= outputs.size()) {
+            LOG_ERR("ProcessContext: audio output port {} is unavailable", port);
+            return;
+        }
+        outputs[port].constant_mask = mask;
+    }
+
+    /** Flags every channel of an output port as constant, e.g. after writing silence to all of it. */
+    void markOutputConstant(std::size_t port = 0) noexcept {
+        const auto outputs = audioOutputs();
+        if (port >= outputs.size()) {
+            LOG_ERR("ProcessContext: audio output port {} is unavailable", port);
+            return;
+        }
+        setConstantMask(port, allChannels(outputs[port].channel_count));
+    }
+
+    /**
+     * Zeros an output port, including any 32/64-bit converted copy handed out by output(), and flags it
+     * constant. The usual response to a silent input or an idle send.
+     */
+    void clearOutput(std::size_t port = 0) noexcept {
+        const auto outputs = audioOutputs();
+        if (port >= outputs.size()) {
+            LOG_ERR("ProcessContext: audio output port {} is unavailable", port);
+            return;
+        }
+        const auto& buffer = outputs[port];
+        for (uint32_t ch = 0; ch < buffer.channel_count; ++ch) {
+            if (buffer.data32 && buffer.data32[ch]) std::fill_n(buffer.data32[ch], process_.frames_count, 0.0f);
+            if (buffer.data64 && buffer.data64[ch]) std::fill_n(buffer.data64[ch], process_.frames_count, 0.0);
+        }
+        for (size_t i = 0; i < num_bridges_; ++i) {
+            const Bridge& b = bridges_[i];
+            if (!b.is_output || b.port != port) continue;
+            for (uint32_t ch = 0; ch < buffer.channel_count; ++ch) {
+                if (b.is_double) {
+                    std::fill_n(static_cast<double*>(b.channels[ch]), process_.frames_count, 0.0);
+                } else {
+                    std::fill_n(static_cast<float*>(b.channels[ch]), process_.frames_count, 0.0f);
+                }
+            }
+        }
+        markOutputConstant(port);
+    }
+
+    /**
+     * Returns the host's constant flags for an input port: bit i set means every sample of channel i equals its
+     * first sample. Returns 0 for an unavailable port.
+     */
+    [[nodiscard]] uint64_t inputConstantMask(std::size_t port = 0) const noexcept {
+        const auto inputs = audioInputs();
+        return port < inputs.size() ? inputs[port].constant_mask : 0;
+    }
+
+    /** Returns whether the host flagged one channel of an input port as constant. */
+    [[nodiscard]] bool isInputChannelConstant(std::size_t port, std::size_t channel) const noexcept {
+        return channel < 64 && (inputConstantMask(port) >> channel & 1u) != 0;
+    }
+
+    /**
+     * Returns whether every channel of an input port is flagged constant and starts at zero, i.e. the whole port
+     * is silent, e.g. an unused sidechain. Only reads each channel's first sample.
+     */
+    [[nodiscard]] bool isInputSilent(std::size_t port = 0) const noexcept {
+        const auto inputs = audioInputs();
+        if (port >= inputs.size()) return false;
+        const auto& buffer = inputs[port];
+        if ((buffer.constant_mask & allChannels(buffer.channel_count)) != allChannels(buffer.channel_count)) {
+            return false;
+        }
+        if (process_.frames_count == 0) return true;
+        for (uint32_t ch = 0; ch < buffer.channel_count; ++ch) {
+            if (buffer.data32 && buffer.data32[ch]) {
+                if (buffer.data32[ch][0] != 0.0f) return false;
+            } else if (buffer.data64 && buffer.data64[ch]) {
+                if (buffer.data64[ch][0] != 0.0) return false;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Returns whether the host processes one channel in place: the input and output ports share its buffer, so
+     * the output already holds the input and writing the output overwrites it.
+     */
+    [[nodiscard]] bool isChannelInPlace(std::size_t input_port, std::size_t output_port,
+                                        std::size_t channel) const noexcept {
+        const auto inputs = audioInputs();
+        if (input_port >= inputs.size() || output_port >= process_.audio_outputs_count || !process_.audio_outputs) {
+            return false;
+        }
+        const auto& in = inputs[input_port];
+        const auto& out = process_.audio_outputs[output_port];
+        if (channel >= in.channel_count || channel >= out.channel_count) return false;
+        const bool same32 = in.data32 && out.data32 && in.data32[channel] && in.data32[channel] == out.data32[channel];
+        const bool same64 = in.data64 && out.data64 && in.data64[channel] && in.data64[channel] == out.data64[channel];
+        return same32 || same64;
+    }
+
+    /** Returns whether every channel of the output port is processed in place with the input port. */
+    [[nodiscard]] bool isInPlace(std::size_t input_port = 0, std::size_t output_port = 0) const noexcept {
+        const auto inputs = audioInputs();
+        if (input_port >= inputs.size() || output_port >= process_.audio_outputs_count || !process_.audio_outputs) {
+            return false;
+        }
+        const uint32_t channels = process_.audio_outputs[output_port].channel_count;
+        if (channels == 0 || inputs[input_port].channel_count != channels) return false;
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            if (!isChannelInPlace(input_port, output_port, ch)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Returns the real-time scratch arena for temporaries that only live for this block, e.g.
+     * scratch().allocateAudioBuffer<float, 2>(numFrames()). PluginBase sizes it at activate() from
+     * ProcessInfo::max_frame_size (see PluginBase::setScratchBytesPerFrame()) and rewinds it after every
+     * process() call, so nothing allocated here survives the block.
+     */
+    [[nodiscard]] MemoryArena& scratch() const noexcept {
+        ASSERT(scratch_ != nullptr, "ProcessContext: no scratch arena for this process call");
+        return *scratch_;
+    }
+
     /** Returns the underlying CLAP process structure. */
     [[nodiscard]] const clap_process_t& native() const noexcept { return process_; }
 
+    /**
+     * Converts every bridged output port back into the host's format. PluginBase calls this after process();
+     * call it yourself when driving a ProcessContext by hand.
+     */
+    void commitBridgedOutputs() noexcept {
+        for (size_t i = 0; i < num_bridges_; ++i) {
+            const Bridge& b = bridges_[i];
+            if (!b.is_output) continue;
+            auto& buffer = process_.audio_outputs[b.port];
+            for (uint32_t ch = 0; ch < buffer.channel_count; ++ch) {
+                if (b.is_double) {
+                    convertSamples(static_cast<const double*>(b.channels[ch]), buffer.data32[ch],
+                                   process_.frames_count);
+                } else {
+                    convertSamples(static_cast<const float*>(b.channels[ch]), buffer.data64[ch],
+                                   process_.frames_count);
+                }
+            }
+        }
+    }
+
 private:
+    /** A port converted into scratch memory because the host didn't supply the requested format. */
+    struct Bridge {
+        uint32_t port = 0;
+        bool is_output = false;
+        bool is_double = false;  // Format of the scratch copy
+        void** channels = nullptr;
+    };
+    static constexpr size_t kMaxBridges = 16;
+
+    static constexpr uint64_t allChannels(uint32_t channel_count) noexcept {
+        return channel_count >= 64 ? ~uint64_t{0} : (uint64_t{1} << channel_count) - 1;
+    }
+
+    template <typename From, typename To>
+    static void convertSamples(const From* in, To* out, uint32_t count) noexcept {
+        // A plain conversion loop; compilers vectorize it into cvtps2pd/cvtpd2ps (or fcvtl/fcvtn)
+        for (uint32_t i = 0; i < count; ++i) out[i] = static_cast<To>(in[i]);
+    }
+
+    /**
+     * Returns T channel pointers for a port the host only supplied in the other format, converting it into scratch
+     * memory the first time it's requested this block, or nullptr if that isn't possible.
+     */
+    template <typename T>
+    T* const* bridge(const clap_audio_buffer_t& buffer, uint32_t port, bool is_output) const noexcept {
+        constexpr bool is_double = std::same_as<T, double>;
+        for (size_t i = 0; i < num_bridges_; ++i) {
+            const Bridge& b = bridges_[i];
+            if (b.port == port && b.is_output == is_output && b.is_double == is_double) {
+                return reinterpret_cast<T* const*>(b.channels);
+            }
+        }
+
+        using Other = std::conditional_t<is_double, float, double>;
+        Other* const* source = nullptr;
+        if constexpr (is_double) {
+            source = buffer.data32;
+        } else {
+            source = buffer.data64;
+        }
+        if (scratch_ == nullptr || !channelsAvailable(source, buffer.channel_count)) return nullptr;
+        if (num_bridges_ == kMaxBridges) {
+            LOG_ERR("ProcessContext: too many ports need sample format conversion");
+            return nullptr;
+        }
+
+        const uint32_t frames = process_.frames_count;
+        const size_t needed =
+            alignof(T*) + buffer.channel_count * (sizeof(T*) + frames * sizeof(T) + defaultByteAlignment);
+        if (scratch_->getCapacity() - scratch_->getBytesUsed() < needed) {
+            LOG_ERR("ProcessContext: scratch arena too small to convert port {}", port);
+            return nullptr;
+        }
+        T** channels = scratch_->allocate<T*>(buffer.channel_count);
+        for (uint32_t ch = 0; ch < buffer.channel_count; ++ch) {
+            channels[ch] = scratch_->allocate<T>(frames, defaultByteAlignment);
+            convertSamples(source[ch], channels[ch], frames);
+        }
+        bridges_[num_bridges_++] = {port, is_output, is_double, reinterpret_cast<void**>(channels)};
+        return channels;
+    }
+
     /** Returns whether an array contains a non-null pointer for every channel. */
     template <typename T>
     [[nodiscard]] bool channelsAvailable(T* const* channels, uint32_t channel_count) const noexcept {
@@ -199,6 +450,11 @@ private:
     }
 
     const clap_process_t& process_;
+    MemoryArena* scratch_ = nullptr;
+    EventRouter* events_ = nullptr;
+    OutputEventBatch* out_batch_ = nullptr;
+    mutable std::array<Bridge, kMaxBridges> bridges_{};
+    mutable size_t num_bridges_ = 0;
 };
 
 }  // namespace applause
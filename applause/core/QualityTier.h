@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace applause {
+
+/**
+ * How much CPU DSP code should spend on quality. PluginBase sets the tier for every process() call from the
+ * host's render mode (see RenderExtension): Offline while the host bounces, Realtime otherwise. Primitives read it
+ * once per block with currentQualityTier() and pick, say, a higher oversampling factor, exact math instead of fast
+ * approximations, or longer smoothing.
+ */
+enum class QualityTier : uint8_t {
+    Realtime,  ///< Playing live: take the cheap paths
+    Offline,   ///< Rendering offline: time isn't critical, take the best paths
+};
+
+namespace detail {
+inline thread_local QualityTier current_quality_tier = QualityTier::Realtime;
+}  // namespace detail
+
+/** The tier of the process() call running on this thread; Realtime outside of one. */
+[[nodiscard]] inline QualityTier currentQualityTier() noexcept { return detail::current_quality_tier; }
+
+/** Sets the calling thread's tier while alive, e.g. on a worker thread rendering for process(). Scopes nest. */
+class QualityTierScope {
+public:
+    explicit QualityTierScope(QualityTier tier) noexcept : previous_(detail::current_quality_tier) {
+        detail::current_quality_tier = tier;
+    }
+    ~QualityTierScope() noexcept { detail::current_quality_tier = previous_; }
+
+    QualityTierScope(const QualityTierScope&) = delete;
+    QualityTierScope& operator=(const QualityTierScope&) = delete;
+
+private:
+    QualityTier previous_;
+};
+
+}  // namespace applause
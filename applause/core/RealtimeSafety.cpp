@@ -0,0 +1,153 @@
+#include "RealtimeSafety.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <unistd.h>
+#define APPLAUSE_REALTIME_BACKTRACE 1
+#endif
+
+namespace applause {
+namespace {
+thread_local int realtime_depth = 0;
+thread_local int exempt_depth = 0;
+
+std::atomic<RealtimeViolationHandler> violation_handler{nullptr};
+std::atomic<uint64_t> violation_count{0};
+
+const char* violationName(RealtimeViolation violation) noexcept {
+    switch (violation) {
+        case RealtimeViolation::Allocation:
+            return "allocation";
+        case RealtimeViolation::Deallocation:
+            return "deallocation";
+        case RealtimeViolation::Blocking:
+            return "blocking call";
+    }
+    return "violation";
+}
+
+void printViolation(RealtimeViolation violation, const char* what) noexcept {
+    std::fprintf(stderr, "[realtime] %s on the audio thread: %s\n", violationName(violation), what);
+#if defined(APPLAUSE_REALTIME_BACKTRACE)
+    void* frames[32];
+    const int count = backtrace(frames, 32);
+    backtrace_symbols_fd(frames, count, STDERR_FILENO);
+#endif
+}
+
+#if defined(APPLAUSE_REALTIME_BACKTRACE) && APPLAUSE_REALTIME_CHECKS
+// backtrace() loads its unwinder on first use, which allocates; do that before any thread is marked
+[[maybe_unused]] const bool backtrace_ready = [] {
+    void* frame = nullptr;
+    backtrace(&frame, 1);
+    return true;
+}();
+#endif
+}  // namespace
+
+RealtimeViolationHandler setRealtimeViolationHandler(RealtimeViolationHandler handler) noexcept {
+    return violation_handler.exchange(handler, std::memory_order_acq_rel);
+}
+
+uint64_t getRealtimeViolationCount() noexcept { return violation_count.load(std::memory_order_relaxed); }
+
+bool isRealtimeThread() noexcept { return realtime_depth > 0 && exempt_depth == 0; }
+
+void checkRealtimeViolation(RealtimeViolation violation, const char* what) noexcept {
+    if (!isRealtimeThread()) return;
+    violation_count.fetch_add(1, std::memory_order_relaxed);
+    // Whatever the handler allocates or locks isn't reported again
+    const NonRealtimeScope exempt;
+    const RealtimeViolationHandler handler = violation_handler.load(std::memory_order_acquire);
+    if (handler) {
+        handler(violation, what);
+    } else {
+        printViolation(violation, what);
+    }
+}
+
+RealtimeThreadScope::RealtimeThreadScope() noexcept { ++realtime_depth; }
+RealtimeThreadScope::~RealtimeThreadScope() noexcept { --realtime_depth; }
+
+NonRealtimeScope::NonRealtimeScope() noexcept { ++exempt_depth; }
+NonRealtimeScope::~NonRealtimeScope() noexcept { --exempt_depth; }
+
+}  // namespace applause
+
+#if APPLAUSE_REALTIME_CHECKS
+// Replacing these in the framework covers every C++ allocation in the plugin: containers, std::function, strings.
+// malloc() called directly from C code isn't intercepted.
+namespace {
+void* checkedAllocate(std::size_t size) {
+    applause::checkRealtimeViolation(applause::RealtimeViolation::Allocation, "operator new");
+    if (size == 0) size = 1;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc{};
+}
+
+void* checkedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    applause::checkRealtimeViolation(applause::RealtimeViolation::Allocation, "operator new");
+    const auto align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = ((size == 0 ? 1 : size) + align - 1) / align * align;
+#if defined(_WIN32)
+    if (void* p = _aligned_malloc(rounded, align)) return p;
+#else
+    if (void* p = std::aligned_alloc(align, rounded)) return p;
+#endif
+    throw std::bad_alloc{};
+}
+
+void checkedFree(void* p) noexcept {
+    if (!p) return;
+    applause::checkRealtimeViolation(applause::RealtimeViolation::Deallocation, "operator delete");
+    std::free(p);
+}
+
+void checkedFreeAligned(void* p) noexcept {
+    if (!p) return;
+    applause::checkRealtimeViolation(applause::RealtimeViolation::Deallocation, "operator delete");
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+}  // namespace
+
+void* operator new(std::size_t size) { return checkedAllocate(size); }
+void* operator new[](std::size_t size) { return checkedAllocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return checkedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return checkedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new(std::size_t size, std::align_val_t alignment) { return checkedAllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return checkedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept { checkedFree(p); }
+void operator delete[](void* p) noexcept { checkedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { checkedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { checkedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { checkedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { checkedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { checkedFreeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { checkedFreeAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { checkedFreeAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { checkedFreeAligned(p); }
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Set APPLAUSE_REALTIME_CHECKS to 1 (CMake option APPLAUSE_REALTIME_CHECKS, meant for debug and test builds) to
+ * report heap allocations and blocking calls made while a thread is marked real-time. PluginBase marks the audio
+ * thread for the duration of every process() call, the framework replaces the global operator new and delete to
+ * check the mark, and APPLAUSE_ASSERT_NOT_REALTIME() flags code that locks or waits. When it's 0 none of that is
+ * compiled in; the functions below still exist but nothing calls them.
+ */
+#ifndef APPLAUSE_REALTIME_CHECKS
+#define APPLAUSE_REALTIME_CHECKS 0
+#endif
+
+namespace applause {
+
+enum class RealtimeViolation : uint8_t {
+    Allocation,    ///< operator new on a real-time thread
+    Deallocation,  ///< operator delete on a real-time thread
+    Blocking,      ///< APPLAUSE_ASSERT_NOT_REALTIME(), e.g. a mutex lock
+};
+
+/**
+ * Called for each violation on the offending thread, with what names the call (e.g. "operator new"). It must not
+ * allocate itself; anything it does is exempt from checking anyway.
+ */
+using RealtimeViolationHandler = void (*)(RealtimeViolation violation, const char* what) noexcept;
+
+/**
+ * Installs the handler for violations on every thread; nullptr restores the default, which prints the violation and
+ * a stack trace (where the platform offers one) to stderr. Returns the previous handler.
+ */
+RealtimeViolationHandler setRealtimeViolationHandler(RealtimeViolationHandler handler) noexcept;
+
+/** Violations reported since the process started, on any thread. */
+[[nodiscard]] uint64_t getRealtimeViolationCount() noexcept;
+
+/** Whether the calling thread is inside a RealtimeThreadScope and outside any NonRealtimeScope. */
+[[nodiscard]] bool isRealtimeThread() noexcept;
+
+/** Reports a violation if the calling thread is real-time; the hooks behind the checks call this. */
+void checkRealtimeViolation(RealtimeViolation violation, const char* what) noexcept;
+
+/** Marks the calling thread real-time while alive. Scopes nest. */
+class RealtimeThreadScope {
+public:
+    RealtimeThreadScope() noexcept;
+    ~RealtimeThreadScope() noexcept;
+
+    RealtimeThreadScope(const RealtimeThreadScope&) = delete;
+    RealtimeThreadScope& operator=(const RealtimeThreadScope&) = delete;
+};
+
+/**
+ * Exempts the calling thread from checking while alive, for deliberate exceptions such as a first-use
+ * initialization that can't be moved off the audio thread.
+ */
+class NonRealtimeScope {
+public:
+    NonRealtimeScope() noexcept;
+    ~NonRealtimeScope() noexcept;
+
+    NonRealtimeScope(const NonRealtimeScope&) = delete;
+    NonRealtimeScope& operator=(const NonRealtimeScope&) = delete;
+};
+
+}  // namespace applause
+
+#if APPLAUSE_REALTIME_CHECKS
+#define APPLAUSE_ASSERT_NOT_REALTIME(what) \
+    ::applause::checkRealtimeViolation(::applause::RealtimeViolation::Blocking, what)
+#else
+#define APPLAUSE_ASSERT_NOT_REALTIME(what) ((void)0)
+#endif
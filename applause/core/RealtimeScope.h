@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define APPLAUSE_REALTIME_SCOPE_X86 1
+#include <xmmintrin.h>
+#elif defined(__aarch64__)
+#define APPLAUSE_REALTIME_SCOPE_ARM64 1
+#endif
+
+namespace applause {
+
+/**
+ * RAII guard for realtime audio code. While it's alive, floating-point denormals are flushed to zero: FTZ and DAZ
+ * on x86 (MXCSR), FZ on ARM64 (FPCR). Decaying filter and reverb tails otherwise drift into denormal range, where
+ * every operation can cost a hundred times more. The caller's floating-point state is restored on destruction.
+ *
+ * PluginBase enters one around every process() call (see PluginBase::setFlushDenormals()), so voice and effect
+ * code doesn't need its own denormal guards. It's also useful on threads the plugin runs DSP on itself. On other
+ * architectures the guard does nothing.
+ */
+class RealtimeScope {
+public:
+    explicit RealtimeScope(bool flush_denormals = true) noexcept {
+        if (!flush_denormals) return;
+#if defined(APPLAUSE_REALTIME_SCOPE_X86)
+        saved_ = _mm_getcsr();
+        _mm_setcsr(static_cast<unsigned int>(saved_) | kFlushToZero | kDenormalsAreZero);
+        active_ = true;
+#elif defined(APPLAUSE_REALTIME_SCOPE_ARM64)
+        uint64_t fpcr;
+        asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+        saved_ = fpcr;
+        asm volatile("msr fpcr, %0" : : "r"(fpcr | kFlushToZero));
+        active_ = true;
+#endif
+    }
+
+    ~RealtimeScope() noexcept {
+        if (!active_) return;
+#if defined(APPLAUSE_REALTIME_SCOPE_X86)
+        _mm_setcsr(static_cast<unsigned int>(saved_));
+#elif defined(APPLAUSE_REALTIME_SCOPE_ARM64)
+        asm volatile("msr fpcr, %0" : : "r"(saved_));
+#endif
+    }
+
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+
+    /** Whether this scope changed the floating-point state, i.e. it was asked to and the architecture supports it. */
+    [[nodiscard]] bool isActive() const noexcept { return active_; }
+
+private:
+#if defined(APPLAUSE_REALTIME_SCOPE_X86)
+    static constexpr unsigned int kFlushToZero = 0x8000;     // MXCSR.FTZ
+    static constexpr unsigned int kDenormalsAreZero = 0x40;  // MXCSR.DAZ
+#elif defined(APPLAUSE_REALTIME_SCOPE_ARM64)
+    static constexpr uint64_t kFlushToZero = uint64_t{1} << 24;  // FPCR.FZ
+#endif
+
+    uint64_t saved_ = 0;
+    bool active_ = false;
+};
+
+}  // namespace applause
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <applause/core/ModMatrix.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace applause {
+
+namespace detail {
+// Holds a StaticModMatrix's buffer storage. It's a base class listed before ModMatrix so the storage exists by the
+// time ModMatrix's constructor carves its buffers out of it.
+template <size_t Bytes>
+struct StaticModMatrixStorage {
+    alignas(defaultByteAlignment) std::array<std::byte, Bytes> storage_;
+    MemoryArena arena_{storage_.data(), storage_.size()};
+};
+}  // namespace detail
+
+/**
+ * A ModMatrix whose dimensions are fixed at compile time, for products that know their voice count and
+ * source/destination/connection budget up front (as Synthesizer does with NumVoices).
+ *
+ * The per-block buffers live inside the object in one std::array instead of being allocated, and the
+ * configuration is available as kConfig. Everything else, including the whole connection
+ * and processing API, is ModMatrix's, so a StaticModMatrix can be passed anywhere a ModMatrix& is expected.
+ *
+ * The object is as large as its buffers; allocate it as a member of your plugin rather than on the stack.
+ *
+ * @tparam NumVoices Number of voices
+ * @tparam MaxSources Maximum number of registered sources
+ * @tparam MaxDestinations Maximum number of registered destinations
+ * @tparam MaxConnections Maximum number of connections, including depth modulations
+ * @tparam Layout Memory layout of the per-voice buffers
+ * @tparam RampOutputs Keep the previous block's outputs so handles can ramp across a block
+ */
+template <uint16_t NumVoices, uint16_t MaxSources, uint16_t MaxDestinations, uint16_t MaxConnections,
+          ModVoiceLayout Layout = ModVoiceLayout::VoiceRows, bool RampOutputs = false>
+class StaticModMatrix
+    : private detail::StaticModMatrixStorage<ModMatrix::requiredArenaBytes(
+          {NumVoices, MaxSources, MaxDestinations, MaxConnections, Layout, RampOutputs})>,
+      public ModMatrix {
+public:
+    static_assert(NumVoices > 0 && MaxSources > 0 && MaxDestinations > 0 && MaxConnections > 0,
+                  "StaticModMatrix dimensions must be positive");
+
+    static constexpr Config kConfig{NumVoices, MaxSources, MaxDestinations, MaxConnections, Layout, RampOutputs};
+
+    StaticModMatrix() : ModMatrix(kConfig, this->arena_) {}
+
+    StaticModMatrix(const StaticModMatrix&) = delete;
+    StaticModMatrix& operator=(const StaticModMatrix&) = delete;
+};
+
+}  // namespace applause
@@ -0,0 +1,423 @@
+#include "Telemetry.h"
+
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace applause {
+namespace {
+// Every access to the segment goes through atomic_ref: other modules and the monitor touch it concurrently
+template <typename T>
+T load(const T& field, std::memory_order order = std::memory_order_relaxed) noexcept {
+    // Loads only; the monitor's mapping is read-only, which plain loads of these sizes are fine with
+    return std::atomic_ref<T>{const_cast<T&>(field)}.load(order);
+}
+
+template <typename T>
+void store(T& field, T value, std::memory_order order = std::memory_order_relaxed) noexcept {
+    std::atomic_ref<T>{field}.store(value, order);
+}
+
+template <typename T>
+bool compareExchange(T& field, T expected, T desired) noexcept {
+    return std::atomic_ref<T>{field}.compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+}
+
+// Calls fn(from.x, to.x) for every field but sequence and state, which the seqlock itself owns
+template <typename Fn>
+void forEachField(const TelemetrySlot& from, TelemetrySlot& to, Fn&& fn) noexcept {
+    fn(from.generation, to.generation);
+    for (size_t i = 0; i < std::size(from.plugin_id); ++i) fn(from.plugin_id[i], to.plugin_id[i]);
+    fn(from.published_ns, to.published_ns);
+    fn(from.blocks, to.blocks);
+    fn(from.overruns, to.overruns);
+    fn(from.dropped_overruns, to.dropped_overruns);
+    fn(from.dropped_output_events, to.dropped_output_events);
+    fn(from.dropped_input_events, to.dropped_input_events);
+    fn(from.scratch_peak_bytes, to.scratch_peak_bytes);
+    fn(from.scratch_capacity_bytes, to.scratch_capacity_bytes);
+    fn(from.arena_peak_bytes, to.arena_peak_bytes);
+    fn(from.arena_capacity_bytes, to.arena_capacity_bytes);
+    for (size_t i = 0; i < std::size(from.histogram); ++i) fn(from.histogram[i], to.histogram[i]);
+    fn(from.worst_load, to.worst_load);
+    fn(from.sample_rate, to.sample_rate);
+    fn(from.max_frames, to.max_frames);
+    fn(from.active_voices, to.active_voices);
+    fn(from.voice_capacity, to.voice_capacity);
+}
+
+// A lifetime counter's count since baseline; a counter reset after the claim reads as zero until it passes it
+uint64_t countSince(uint64_t count, uint64_t baseline) noexcept { return count > baseline ? count - baseline : 0; }
+
+// The one writer of a slot replaces every field with values' under the seqlock
+void writeSlot(TelemetrySlot& slot, const TelemetrySlot& values) noexcept {
+    const uint32_t sequence = load(slot.sequence);
+    store(slot.sequence, sequence + 1);
+    std::atomic_thread_fence(std::memory_order_release);
+    forEachField(values, slot, [](const auto& from, auto& to) { store(to, from); });
+    store(slot.sequence, sequence + 2, std::memory_order_release);
+}
+
+const TelemetrySlot* slotAt(const std::byte* data, const TelemetryHeader& header, size_t index) noexcept {
+    return reinterpret_cast<const TelemetrySlot*>(data + header.header_bytes + index * header.slot_bytes);
+}
+
+constexpr int kOpenAttempts = 100;  // 1 ms apart, while another module finishes creating the segment
+constexpr int kReadAttempts = 4;
+}  // namespace
+
+std::string telemetrySegmentName(uint32_t process_id) {
+#if defined(_WIN32)
+    return "Local\\applause-telemetry-" + std::to_string(process_id);
+#else
+    return "/applause-telemetry-" + std::to_string(process_id);
+#endif
+}
+
+uint32_t currentProcessId() noexcept {
+#if defined(_WIN32)
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+TelemetrySegment& TelemetrySegment::shared() {
+    static TelemetrySegment segment;
+    return segment;
+}
+
+TelemetrySegment::TelemetrySegment() {
+    if (create()) return;
+    LOG_WARN("TelemetrySegment: no shared memory for {}, keeping telemetry in-process",
+             telemetrySegmentName(currentProcessId()));
+    data_ = static_cast<std::byte*>(::operator new(kBytes, std::align_val_t{alignof(TelemetrySlot)}));
+    std::memset(data_, 0, kBytes);
+    shared_ = false;
+
+    auto& header = *reinterpret_cast<TelemetryHeader*>(data_);
+    header = {.schema_version = kTelemetrySchemaVersion,
+              .header_bytes = sizeof(TelemetryHeader),
+              .slot_bytes = sizeof(TelemetrySlot),
+              .slot_count = kTelemetrySlotCount,
+              .process_id = currentProcessId(),
+              .histogram_bins = DeadlineProfiler::kNumBins,
+              .modules = 1};
+    store(header.magic, kTelemetryMagic, std::memory_order_release);
+}
+
+bool TelemetrySegment::create() noexcept {
+    const std::string name = telemetrySegmentName(currentProcessId());
+#if defined(_WIN32)
+    const std::wstring wide_name(name.begin(), name.end());
+    // Pagefile-backed mappings start zeroed and go away with the last handle, so there is nothing to unlink
+    HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(kBytes),
+                                        wide_name.c_str());
+    if (mapping == nullptr) return false;
+    const bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, kBytes);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+    data_ = static_cast<std::byte*>(view);
+    mapping_ = mapping;
+    shared_ = true;
+#else
+    bool existed = false;
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        // Another plugin binary in this process got there first; wait for it to size the segment
+        existed = true;
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+        struct stat info{};
+        for (int attempt = 0; fd >= 0 && attempt < kOpenAttempts; ++attempt) {
+            if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= kBytes) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (fd >= 0 && static_cast<size_t>(info.st_size) < kBytes) {
+            ::close(fd);
+            return false;
+        }
+    } else if (fd >= 0 && ftruncate(fd, static_cast<off_t>(kBytes)) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    if (fd < 0) return false;
+
+    void* view = mmap(nullptr, kBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        if (!existed) shm_unlink(name.c_str());
+        return false;
+    }
+    data_ = static_cast<std::byte*>(view);
+    shared_ = true;
+#endif
+
+    auto& header = *reinterpret_cast<TelemetryHeader*>(data_);
+    if (existed) {
+        for (int attempt = 0; attempt < kOpenAttempts; ++attempt) {
+            if (load(header.magic, std::memory_order_acquire) == kTelemetryMagic) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (load(header.magic, std::memory_order_acquire) != kTelemetryMagic ||
+            header.schema_version != kTelemetrySchemaVersion || header.slot_bytes != sizeof(TelemetrySlot)) {
+            // A binary built on another schema owns the name; don't scribble over its slots
+            LOG_WARN("TelemetrySegment: {} has an unknown schema", name);
+            shared_ = false;
+            data_ = nullptr;
+#if defined(_WIN32)
+            UnmapViewOfFile(view);
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+#else
+            munmap(view, kBytes);
+#endif
+            return false;
+        }
+        std::atomic_ref<uint32_t>{header.modules}.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // The creator's mapping starts zeroed: every slot is already free
+    header.schema_version = kTelemetrySchemaVersion;
+    header.header_bytes = sizeof(TelemetryHeader);
+    header.slot_bytes = sizeof(TelemetrySlot);
+    header.slot_count = kTelemetrySlotCount;
+    header.process_id = currentProcessId();
+    header.histogram_bins = DeadlineProfiler::kNumBins;
+    header.created_unix_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                       std::chrono::system_clock::now().time_since_epoch())
+                                                       .count());
+    store(header.modules, uint32_t{1});
+    store(header.magic, kTelemetryMagic, std::memory_order_release);
+    return true;
+}
+
+TelemetrySegment::~TelemetrySegment() {
+    if (data_ == nullptr) return;
+    if (!shared_) {
+        ::operator delete(data_, std::align_val_t{alignof(TelemetrySlot)});
+        return;
+    }
+    auto& header = *reinterpret_cast<TelemetryHeader*>(data_);
+    const bool last = std::atomic_ref<uint32_t>{header.modules}.fetch_sub(1, std::memory_order_acq_rel) == 1;
+#if defined(_WIN32)
+    (void)last;
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+#else
+    munmap(data_, kBytes);
+    if (last) shm_unlink(telemetrySegmentName(currentProcessId()).c_str());
+#endif
+}
+
+TelemetrySlot* TelemetrySegment::claim(const char* plugin_id) noexcept {
+    for (size_t i = 0; i < kTelemetrySlotCount; ++i) {
+        TelemetrySlot& slot = slots()[i];
+        if (!compareExchange(slot.state, kTelemetrySlotFree, kTelemetrySlotClaiming)) continue;
+
+        TelemetrySlot values;
+        values.generation = load(slot.generation) + 1;
+        if (plugin_id != nullptr) std::strncpy(values.plugin_id, plugin_id, sizeof(values.plugin_id) - 1);
+        writeSlot(slot, values);
+        store(slot.state, kTelemetrySlotActive, std::memory_order_release);
+        return &slot;
+    }
+    return nullptr;
+}
+
+void TelemetrySegment::release(TelemetrySlot* slot) noexcept {
+    if (slot != nullptr) store(slot->state, kTelemetrySlotFree, std::memory_order_release);
+}
+
+bool TelemetryPublisher::claim(TelemetrySegment& segment, const char* plugin_id, double sample_rate,
+                               uint32_t max_frames, const TelemetryCounters& baseline) {
+    release();
+    slot_ = segment.claim(plugin_id);
+    if (slot_ == nullptr) return false;
+    segment_ = &segment;
+    publish_interval_frames_ = static_cast<uint64_t>(std::max(1.0, sample_rate * kPublishIntervalMs / 1000.0));
+    frames_since_publish_ = 0;
+
+    baseline_ = {};
+    if (const DeadlineProfiler* profiler = baseline.profiler) {
+        baseline_.blocks = profiler->getBlockCount();
+        baseline_.overruns = profiler->getOverrunCount();
+        baseline_.dropped_overruns = profiler->getDroppedOverrunCount();
+        baseline_.histogram = profiler->getHistogram();
+        baseline_.worst_load = profiler->getWorstLoad();
+    }
+    baseline_.dropped_output_events = baseline.dropped_output_events;
+    baseline_.dropped_input_events = baseline.dropped_input_events;
+
+    TelemetrySlot values;
+    forEachField(*slot_, values, [](const auto& from, auto& to) { to = load(from); });
+    values.sample_rate = static_cast<float>(sample_rate);
+    values.max_frames = max_frames;
+    values.published_ns = deadlineClockNanos();
+    writeSlot(*slot_, values);
+    return true;
+}
+
+void TelemetryPublisher::release() noexcept {
+    if (segment_ != nullptr) segment_->release(slot_);
+    segment_ = nullptr;
+    slot_ = nullptr;
+}
+
+void TelemetryPublisher::publish(const TelemetryCounters& counters) noexcept {
+    if (slot_ == nullptr) return;
+    frames_since_publish_ = 0;
+
+    // Only this thread writes the slot, so reading it back needs no retries
+    TelemetrySlot values;
+    forEachField(*slot_, values, [](const auto& from, auto& to) { to = load(from); });
+    values.published_ns = deadlineClockNanos();
+    if (const DeadlineProfiler* profiler = counters.profiler) {
+        values.blocks = countSince(profiler->getBlockCount(), baseline_.blocks);
+        values.overruns = countSince(profiler->getOverrunCount(), baseline_.overruns);
+        values.dropped_overruns = countSince(profiler->getDroppedOverrunCount(), baseline_.dropped_overruns);
+        const auto histogram = profiler->getHistogram();
+        for (size_t i = 0; i < DeadlineProfiler::kNumBins; ++i) {
+            values.histogram[i] = countSince(histogram[i], baseline_.histogram[i]);
+        }
+
+        // A worst load above the baseline's was recorded after the claim; otherwise the histogram bounds it
+        values.worst_load = profiler->getWorstLoad();
+        if (values.worst_load <= baseline_.worst_load) {
+            values.worst_load = 0.0f;
+            for (size_t i = DeadlineProfiler::kNumBins; i-- > 0;) {
+                if (values.histogram[i] > 0) {
+                    values.worst_load = static_cast<float>(i) * DeadlineProfiler::kBinWidth;
+                    break;
+                }
+            }
+        }
+    }
+    values.dropped_output_events = countSince(counters.dropped_output_events, baseline_.dropped_output_events);
+    values.dropped_input_events = countSince(counters.dropped_input_events, baseline_.dropped_input_events);
+    values.scratch_peak_bytes = counters.scratch_peak_bytes;
+    values.scratch_capacity_bytes = counters.scratch_capacity_bytes;
+    if (arena_ != nullptr) {
+        values.arena_peak_bytes = arena_->getPeakBytesUsed();
+        values.arena_capacity_bytes = arena_->getCapacity();
+    }
+    values.active_voices = active_voices_;
+    values.voice_capacity = voice_capacity_;
+    writeSlot(*slot_, values);
+}
+
+bool TelemetryReader::open(uint32_t process_id) {
+    close();
+    const std::string name = telemetrySegmentName(process_id);
+#if defined(_WIN32)
+    const std::wstring wide_name(name.begin(), name.end());
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, wide_name.c_str());
+    if (mapping == nullptr) return false;
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+    MEMORY_BASIC_INFORMATION region{};
+    VirtualQuery(view, &region, sizeof(region));
+    data_ = static_cast<const std::byte*>(view);
+    size_ = region.RegionSize;
+    mapping_ = mapping;
+#else
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TelemetryHeader)) {
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    data_ = static_cast<const std::byte*>(view);
+    size_ = size;
+#endif
+    mapped_ = true;
+    if (validate()) return true;
+    close();
+    return false;
+}
+
+bool TelemetryReader::attach(std::span<const std::byte> bytes) {
+    close();
+    if (bytes.size() < sizeof(TelemetryHeader)) return false;
+    data_ = bytes.data();
+    size_ = bytes.size();
+    if (validate()) return true;
+    close();
+    return false;
+}
+
+void TelemetryReader::close() noexcept {
+    if (mapped_ && data_ != nullptr) {
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+#else
+        munmap(const_cast<std::byte*>(data_), size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    header_ = {};
+}
+
+bool TelemetryReader::validate() noexcept {
+    const auto& header = *reinterpret_cast<const TelemetryHeader*>(data_);
+    if (load(header.magic, std::memory_order_acquire) != kTelemetryMagic) return false;
+    std::memcpy(&header_, &header, sizeof(header_));
+    header_.modules = load(header.modules);
+    return header_.schema_version == kTelemetrySchemaVersion && header_.header_bytes == sizeof(TelemetryHeader) &&
+           header_.slot_bytes == sizeof(TelemetrySlot) &&
+           size_ >= header_.header_bytes + size_t{header_.slot_count} * header_.slot_bytes;
+}
+
+bool TelemetryReader::read(size_t index, TelemetrySlot& out) const noexcept {
+    if (data_ == nullptr || index >= header_.slot_count) return false;
+    const TelemetrySlot& slot = *slotAt(data_, header_, index);
+    for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+        if (load(slot.state, std::memory_order_acquire) != kTelemetrySlotActive) return false;
+        const uint32_t before = load(slot.sequence, std::memory_order_acquire);
+        if ((before & 1) != 0) continue;
+        forEachField(slot, out, [](const auto& from, auto& to) { to = load(from); });
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (load(slot.sequence) == before) {
+            out.sequence = before;
+            out.state = kTelemetrySlotActive;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace applause
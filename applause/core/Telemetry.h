@@ -0,0 +1,245 @@
+#pragma once
+
+#include <applause/core/DeadlineProfiler.h>
+#include <applause/util/MemoryArena.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace applause {
+
+/**
+ * The layout of the telemetry segment, which an external monitor reads by hand, so every field has a fixed size and
+ * a fixed offset. The segment is one TelemetryHeader and then header.slot_count TelemetrySlots, in native byte
+ * order. Any change to either struct bumps kTelemetrySchemaVersion; monitors should refuse versions they don't know.
+ */
+inline constexpr uint32_t kTelemetryMagic = 0x4C545041;  // "APTL" in little-endian memory
+inline constexpr uint32_t kTelemetrySchemaVersion = 1;
+inline constexpr uint32_t kTelemetrySlotCount = 64;
+
+/** Offset 0 of the segment. magic is stored last, so a monitor that sees it sees the rest of the header. */
+struct TelemetryHeader {
+    uint32_t magic = 0;
+    uint32_t schema_version = 0;
+    uint32_t header_bytes = 0;  ///< sizeof(TelemetryHeader): where slot 0 starts
+    uint32_t slot_bytes = 0;    ///< sizeof(TelemetrySlot)
+    uint32_t slot_count = 0;
+    uint32_t process_id = 0;
+    uint32_t histogram_bins = 0;  ///< DeadlineProfiler::kNumBins, each DeadlineProfiler::kBinWidth of the deadline
+    uint32_t modules = 0;  ///< Plugin binaries in the process using the segment; the last one out removes it
+    uint64_t created_unix_ms = 0;
+    uint8_t reserved[24] = {};
+};
+static_assert(sizeof(TelemetryHeader) == 64);
+
+/** TelemetrySlot::state; a reader skips every slot that isn't Active. */
+inline constexpr uint32_t kTelemetrySlotFree = 0;
+inline constexpr uint32_t kTelemetrySlotActive = 1;
+inline constexpr uint32_t kTelemetrySlotClaiming = 2;  ///< Taken, its counters being zeroed
+
+/**
+ * One plugin instance's numbers. Only the instance's audio thread writes them, under a sequence lock: sequence is
+ * odd while an update is in progress, so a reader copies the slot, then checks that sequence is even and unchanged.
+ * Counters count from the slot's claim at activate(), even though the profiler and event counters behind them run
+ * for the plugin's lifetime: TelemetryPublisher::claim() takes a baseline and publish() subtracts it.
+ */
+struct alignas(64) TelemetrySlot {
+    uint32_t sequence = 0;
+    uint32_t state = kTelemetrySlotFree;
+    uint64_t generation = 0;  ///< Bumped at every claim, so a monitor notices an instance replacing another
+    char plugin_id[64] = {};  ///< The descriptor's id, truncated and null-terminated
+    uint64_t published_ns = 0;  ///< Steady-clock nanoseconds of this update, see deadlineClockNanos()
+    uint64_t blocks = 0;        ///< process() calls
+    uint64_t overruns = 0;      ///< process() calls that took longer than the audio they produced
+    uint64_t dropped_overruns = 0;       ///< DeadlineProfiler overrun records nobody popped in time
+    uint64_t dropped_output_events = 0;  ///< Output events the host refused or the batch had no room for
+    uint64_t dropped_input_events = 0;   ///< Input events the fixed-block adapter had no room for
+    uint64_t scratch_peak_bytes = 0;     ///< High-water mark of ProcessContext::scratch()
+    uint64_t scratch_capacity_bytes = 0;
+    uint64_t arena_peak_bytes = 0;  ///< High-water mark of the arena passed to PluginBase::setTelemetryArena()
+    uint64_t arena_capacity_bytes = 0;
+    uint64_t histogram[DeadlineProfiler::kNumBins] = {};  ///< Blocks per load bin, as DeadlineProfiler::getHistogram()
+    float worst_load = 0.0f;  ///< Highest elapsed / deadline ratio since the claim, see TelemetryPublisher::publish()
+    float sample_rate = 0.0f;
+    uint32_t max_frames = 0;
+    uint32_t active_voices = 0;
+    uint32_t voice_capacity = 0;
+};
+static_assert(sizeof(TelemetrySlot) == 320);
+
+/**
+ * The process's telemetry segment: shared memory named telemetrySegmentName(pid), "/applause-telemetry-<pid>" on
+ * POSIX and "Local\applause-telemetry-<pid>" on Windows, created by the first instance that enables telemetry and
+ * removed at process exit. Several plugin binaries built on the framework share the one segment, claiming slots
+ * with compare-and-swap on TelemetrySlot::state. A process that crashes leaves its segment behind; a monitor should
+ * check that the process is still alive. If shared memory can't be created the segment lives on the heap, still
+ * readable in-process.
+ */
+class TelemetrySegment {
+public:
+    /** The segment of this process, created or opened on first use. Main thread. */
+    static TelemetrySegment& shared();
+
+    TelemetrySegment();
+    ~TelemetrySegment();
+
+    TelemetrySegment(const TelemetrySegment&) = delete;
+    TelemetrySegment& operator=(const TelemetrySegment&) = delete;
+
+    /** Claims a free slot for plugin_id, with its counters zeroed; nullptr if all of them are taken. */
+    TelemetrySlot* claim(const char* plugin_id) noexcept;
+
+    /** Frees a slot from claim(). */
+    void release(TelemetrySlot* slot) noexcept;
+
+    /** Whether the segment is shared memory an external monitor can open, rather than the heap fallback. */
+    [[nodiscard]] bool isShared() const noexcept { return shared_; }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, kBytes}; }
+
+    static constexpr size_t kBytes = sizeof(TelemetryHeader) + kTelemetrySlotCount * sizeof(TelemetrySlot);
+
+private:
+    TelemetrySlot* slots() const noexcept { return reinterpret_cast<TelemetrySlot*>(data_ + sizeof(TelemetryHeader)); }
+
+    bool create() noexcept;
+
+    std::byte* data_ = nullptr;
+    bool shared_ = false;
+#if defined(_WIN32)
+    void* mapping_ = nullptr;
+#endif
+};
+
+/** The name a monitor opens to find process_id's segment. */
+std::string telemetrySegmentName(uint32_t process_id);
+
+/** The current process's id, as stored in TelemetryHeader::process_id. */
+uint32_t currentProcessId() noexcept;
+
+/** What PluginBase hands to TelemetryPublisher::publish() after a block, besides what the publisher tracks itself. */
+struct TelemetryCounters {
+    const DeadlineProfiler* profiler = nullptr;
+    uint64_t dropped_output_events = 0;
+    uint64_t dropped_input_events = 0;
+    size_t scratch_peak_bytes = 0;
+    size_t scratch_capacity_bytes = 0;
+};
+
+/**
+ * One instance's slot in the telemetry segment. PluginBase owns one: claimed at activate() when telemetry is
+ * enabled, released at deactivate(), and published from the audio thread about every kPublishIntervalMs of audio,
+ * so the cost is a few dozen stores a few times a second. The monitor never touches the plugin's threads.
+ */
+class TelemetryPublisher {
+public:
+    static constexpr double kPublishIntervalMs = 50.0;
+
+    TelemetryPublisher() = default;
+    ~TelemetryPublisher() { release(); }
+
+    TelemetryPublisher(const TelemetryPublisher&) = delete;
+    TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    /**
+     * Main thread: claims a slot in segment, false if there is none left. baseline holds the counters as they stand
+     * now; later updates publish the counts since then.
+     */
+    bool claim(TelemetrySegment& segment, const char* plugin_id, double sample_rate, uint32_t max_frames,
+               const TelemetryCounters& baseline = {});
+
+    /** Main thread: gives the slot back, say at deactivate(). */
+    void release() noexcept;
+
+    [[nodiscard]] bool isActive() const noexcept { return slot_ != nullptr; }
+
+    /** Audio thread: the voices sounding now and the most there can be, published with the next update. */
+    void setVoiceCount(uint32_t active, uint32_t capacity) noexcept {
+        active_voices_ = active;
+        voice_capacity_ = capacity;
+    }
+
+    /** Main thread, while inactive or at activate(): an arena whose high-water mark is published too, or nullptr. */
+    void setArena(const MemoryArena* arena) noexcept { arena_ = arena; }
+
+    /** Audio thread: counts num_frames of audio, true once it's time to publish(). */
+    bool advance(uint32_t num_frames) noexcept {
+        frames_since_publish_ += num_frames;
+        return slot_ != nullptr && frames_since_publish_ >= publish_interval_frames_;
+    }
+
+    /**
+     * Audio thread: writes every field of the slot. The profiler only keeps its lifetime worst load, so while that
+     * is still the worst from before the claim, worst_load is the lower edge of the highest histogram bin reached
+     * since.
+     */
+    void publish(const TelemetryCounters& counters) noexcept;
+
+private:
+    // The counters at claim(), subtracted from every update
+    struct Baseline {
+        uint64_t blocks = 0;
+        uint64_t overruns = 0;
+        uint64_t dropped_overruns = 0;
+        uint64_t dropped_output_events = 0;
+        uint64_t dropped_input_events = 0;
+        std::array<uint64_t, DeadlineProfiler::kNumBins> histogram{};
+        float worst_load = 0.0f;
+    };
+
+    TelemetrySegment* segment_ = nullptr;
+    TelemetrySlot* slot_ = nullptr;
+    const MemoryArena* arena_ = nullptr;
+    uint64_t frames_since_publish_ = 0;
+    uint64_t publish_interval_frames_ = 0;
+    uint32_t active_voices_ = 0;
+    uint32_t voice_capacity_ = 0;
+    Baseline baseline_;
+};
+
+/**
+ * The monitor side: opens a process's segment read-only, or wraps bytes already mapped, and copies out consistent
+ * slots. Every read is a plain load; the reader never writes to the segment or waits for a writer.
+ */
+class TelemetryReader {
+public:
+    TelemetryReader() = default;
+    ~TelemetryReader() { close(); }
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    /** Maps process_id's segment; false if there is none, or its magic, schema or sizes aren't this version's. */
+    bool open(uint32_t process_id);
+
+    /** Reads a segment already in memory, e.g. TelemetrySegment::bytes(); same checks as open(). */
+    bool attach(std::span<const std::byte> bytes);
+
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return data_ != nullptr; }
+
+    [[nodiscard]] const TelemetryHeader& header() const noexcept { return header_; }
+
+    /**
+     * Copies slot index into out. False if the slot is free, or an update kept landing while it was copied (after a
+     * few retries; try again at the next poll).
+     */
+    bool read(size_t index, TelemetrySlot& out) const noexcept;
+
+private:
+    bool validate() noexcept;
+
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    TelemetryHeader header_{};
+    bool mapped_ = false;
+#if defined(_WIN32)
+    void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace applause
@@ -0,0 +1,110 @@
+#include "UndoHistory.h"
+
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+
+namespace applause {
+UndoHistory::UndoHistory(ParamsExtension& params, ModMatrix* matrix, size_t capacity)
+    : params_(params), matrix_(matrix), steps_(std::max<size_t>(capacity, 1)) {
+    if (matrix_) {
+        routing_connection_ = matrix_->on_connections_edited.connect(
+            [this](std::span<const ModConnectionChange>) { routing_edited_ = true; });
+    }
+    clear();
+}
+
+bool UndoHistory::snapshot() {
+    Step step;
+    // Host automation, modulation and state loads only move the baseline: they're the host's to undo
+    params_.consumeSnapshotChanges([&](uint32_t index, bool by_user) {
+        const float value = params_.getInfoAt(index).getValue();
+        if (by_user && value != values_[index]) step.params.push_back({index, values_[index], value});
+        values_[index] = value;
+    });
+
+    if (matrix_ && routing_edited_) {
+        routing_edited_ = false;
+        auto routing = std::make_shared<const std::vector<std::byte>>(matrix_->saveRouting());
+        if (*routing != *routing_) {
+            step.routing_before = routing_;
+            step.routing_after = routing;
+            routing_ = std::move(routing);
+        }
+    }
+
+    if (step.params.empty() && !step.routing_after) return false;
+
+    // A new edit branches off here, so the undone steps can't be redone anymore
+    count_ = position_;
+    if (count_ == steps_.size()) {
+        first_ = (first_ + 1) % steps_.size();
+        --count_;
+    }
+    at(count_) = std::move(step);
+    position_ = ++count_;
+    return true;
+}
+
+bool UndoHistory::undo() {
+    snapshot();
+    if (!canUndo()) return false;
+    apply(at(--position_), false);
+    return true;
+}
+
+bool UndoHistory::redo() {
+    if (!canRedo()) return false;
+    apply(at(position_++), true);
+    return true;
+}
+
+size_t UndoHistory::getMemoryUsage() const noexcept {
+    size_t bytes = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        const Step& step = at(i);
+        bytes += step.params.capacity() * sizeof(ParamChange);
+        if (step.routing_after) bytes += step.routing_after->size();
+    }
+    return bytes;
+}
+
+void UndoHistory::clear() {
+    for (auto& step : steps_) step = {};
+    first_ = 0;
+    count_ = 0;
+    position_ = 0;
+
+    values_.resize(params_.getParamCount());
+    resync();
+    for (uint32_t i = 0; i < values_.size(); ++i) values_[i] = params_.getInfoAt(i).getValue();
+
+    if (matrix_) routing_ = std::make_shared<const std::vector<std::byte>>(matrix_->saveRouting());
+    routing_edited_ = false;
+}
+
+void UndoHistory::apply(const Step& step, bool forward) {
+    params_.beginBulkChange();
+    for (const ParamChange& change : step.params) {
+        const float value = forward ? change.after : change.before;
+        params_.getInfoAt(change.index).setValueNotifyingHost(value);
+        values_[change.index] = value;
+    }
+    params_.endBulkChange();
+
+    if (matrix_ && step.routing_after) {
+        const Routing& routing = forward ? step.routing_after : step.routing_before;
+        if (!matrix_->loadRouting(*routing)) LOG_WARN("UndoHistory: couldn't restore the routing");
+        routing_ = routing;
+    }
+
+    resync();
+}
+
+void UndoHistory::resync() {
+    params_.consumeSnapshotChanges(
+        [this](uint32_t index, bool) { values_[index] = params_.getInfoAt(index).getValue(); });
+    routing_edited_ = false;
+}
+
+}  // namespace applause
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <applause/core/ModMatrix.h>
+#include <applause/extensions/ParamsExtension.h>
+#include <applause/util/thirdparty/rocket.hpp>
+
+namespace applause {
+
+/**
+ * @brief An undo/redo history that records only what each edit changed.
+ *
+ * Call snapshot() after every user edit (e.g. at the end of a knob gesture). It records the parameters the UI
+ * wrote since the last snapshot, with their old and new values, from ParamsExtension::consumeSnapshotChanges(), so
+ * it costs a few bytes per changed parameter instead of a full state save. Host automation isn't recorded. If a ModMatrix is attached, edits that
+ * changed the routing also record it, as the compact blob ModMatrix::saveRouting() writes; consecutive steps share
+ * the blob between them, so the routing is stored once per routing edit.
+ *
+ * Steps live in a ring buffer of fixed capacity; the oldest step is dropped once it's full. Undo and redo apply a
+ * step's values through ParamInfo::setValueNotifyingHost() inside one bulk change, so the host records them as
+ * regular edits, and restore routing with ModMatrix::loadRouting().
+ *
+ * @code
+ * history_ = std::make_unique<UndoHistory>(params_, &mod_matrix_);
+ *
+ * knob.on_gesture_end = [this] { history_->snapshot(); };
+ * undo_button.on_click = [this] { history_->undo(); };
+ * @endcode
+ *
+ * @note UI thread only. Register every parameter and source/destination before constructing the history.
+ */
+class UndoHistory {
+public:
+    /** One parameter's value before and after a step. */
+    struct ParamChange {
+        uint32_t index;  /// Parameter index, see ParamsExtension::getInfoAt()
+        float before;
+        float after;
+    };
+
+    /**
+     * @param capacity Maximum number of steps kept; the oldest step is dropped when a new one doesn't fit.
+     */
+    explicit UndoHistory(ParamsExtension& params, ModMatrix* matrix = nullptr, size_t capacity = 1024);
+
+    UndoHistory(const UndoHistory&) = delete;
+    UndoHistory& operator=(const UndoHistory&) = delete;
+
+    /**
+     * Records everything changed since the last snapshot as one step, discarding the steps that could have been
+     * redone. Changes that were reverted in the meantime aren't recorded.
+     * @return false if nothing changed
+     */
+    bool snapshot();
+
+    /** Reverts the last step, after recording pending changes as a step of their own. false if there's none. */
+    bool undo();
+
+    /** Reapplies the last undone step. false if there's none. */
+    bool redo();
+
+    [[nodiscard]] bool canUndo() const noexcept { return position_ > 0; }
+    [[nodiscard]] bool canRedo() const noexcept { return position_ < count_; }
+
+    /** Number of recorded steps, including those that can be redone. */
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+
+    [[nodiscard]] size_t getCapacity() const noexcept { return steps_.size(); }
+
+    /** Approximate bytes held by the recorded steps. */
+    [[nodiscard]] size_t getMemoryUsage() const noexcept;
+
+    /** The parameter changes of step index, oldest first. */
+    [[nodiscard]] const std::vector<ParamChange>& getParamChanges(size_t index) const { return at(index).params; }
+
+    /** Drops every step and takes the current state as the new starting point, e.g. after loading a preset. */
+    void clear();
+
+private:
+    using Routing = std::shared_ptr<const std::vector<std::byte>>;
+
+    struct Step {
+        std::vector<ParamChange> params;
+        Routing routing_before;  // Both null if the step didn't change the routing
+        Routing routing_after;
+    };
+
+    Step& at(size_t index) { return steps_[(first_ + index) % steps_.size()]; }
+    const Step& at(size_t index) const { return steps_[(first_ + index) % steps_.size()]; }
+
+    void apply(const Step& step, bool forward);
+
+    // Takes the current values as the baseline without recording them
+    void resync();
+
+    ParamsExtension& params_;
+    ModMatrix* matrix_;
+    std::vector<float> values_;  // Parameter values as of the last snapshot
+    Routing routing_;            // Routing as of the last snapshot
+    bool routing_edited_ = false;
+    rocket::scoped_connection routing_connection_;
+
+    std::vector<Step> steps_;  // Ring buffer
+    size_t first_ = 0;         // Ring index of the oldest step
+    size_t count_ = 0;
+    size_t position_ = 0;      // Steps currently applied; steps from here on can be redone
+};
+
+}  // namespace applause
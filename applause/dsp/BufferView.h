@@ -1,10 +1,12 @@
 #pragma once
 
+#include <applause/dsp/simd/Kernels.h>
 #include <applause/util/DebugHelpers.h>
 #include <applause/util/SampleType.h>
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
@@ -13,6 +15,8 @@
 #include <span>
 #include <type_traits>
 
+#include <xsimd/xsimd.hpp>
+
 namespace applause {
 /**
  * Non-owning view over a planar audio buffer with capacity for MaxChannels.
@@ -314,6 +318,18 @@ public:
         return sub;
     }
 
+    /**
+     * Returns `count` frames starting at `start`, e.g. the part of a block a
+     * voice renders between two events. Shorthand for
+     * getSubView(start, start + count); it only offsets the channel pointers.
+     */
+    [[nodiscard]] constexpr BufferView slice(std::size_t start,
+                                             std::size_t count) const noexcept {
+        ASSERT(start <= frame_count_ && count <= frame_count_ - start,
+               "BufferView::slice: range out of bounds");
+        return getSubView(start, start + count);
+    }
+
     [[nodiscard]] Value load(std::size_t channel,
                              std::size_t frame) const noexcept {
         ASSERT(frame < frame_count_, "BufferView::load: frame out of range");
@@ -378,6 +394,228 @@ public:
                     scalarsPerChannel() * sizeof(Scalar));
     }
 
+    /**
+     * Block operations. These run over each channel's scalars in SIMD
+     * (xsimd::batch<Scalar>), so they apply to SIMD sample types lane by lane.
+     * Aligned loads are used when every channel pointer involved is aligned
+     * for the batch, unaligned ones otherwise; a scalar loop handles the
+     * tail. Source views must have the same frame count; channels beyond the
+     * smaller channel count are left alone. Float views go through
+     * simd::kernels(), so they use the plugin's dispatched instruction set.
+     */
+
+    /** Copies src's samples into this view. */
+    template <typename OtherSample, std::size_t OtherChannels>
+        requires std::same_as<std::remove_const_t<OtherSample>, Value>
+    void copyFrom(
+        const BufferView<OtherSample, OtherChannels>& src) const noexcept
+        requires(!std::is_const_v<Sample>) {
+        ASSERT(src.numFrames() == frame_count_,
+               "BufferView::copyFrom: frame count mismatch");
+        const std::size_t channels =
+            std::min(active_channels_, src.numChannels());
+        for (std::size_t ch = 0; ch < channels; ++ch) {
+            std::copy_n(src.channelSamples(ch), frame_count_,
+                        channel_ptrs_[ch]);
+        }
+    }
+
+    /** Adds src's samples to this view. */
+    template <typename OtherSample, std::size_t OtherChannels>
+        requires std::same_as<std::remove_const_t<OtherSample>, Value>
+    void addFrom(
+        const BufferView<OtherSample, OtherChannels>& src) const noexcept
+        requires(!std::is_const_v<Sample>) {
+        if constexpr (std::same_as<Scalar, float>) {
+            combineBlocks(src, simd::kernels().add);
+        } else {
+            combine(src, [](auto d, auto s) { return d + s; });
+        }
+    }
+
+    /** Adds src's samples, scaled by gain, to this view. */
+    template <typename OtherSample, std::size_t OtherChannels>
+        requires std::same_as<std::remove_const_t<OtherSample>, Value>
+    void mixWithGain(const BufferView<OtherSample, OtherChannels>& src,
+                     Scalar gain) const noexcept
+        requires(!std::is_const_v<Sample>) {
+        if constexpr (std::same_as<Scalar, float>) {
+            const auto mix = simd::kernels().mixWithGain;
+            combineBlocks(src, [mix, gain](float* d, const float* s,
+                                           std::size_t n) {
+                mix(d, s, n, gain);
+            });
+        } else {
+            combine(src, [gain](auto d, auto s) {
+                return d + s * decltype(s)(gain);
+            });
+        }
+    }
+
+    /** Multiplies this view's samples by src's, e.g. by a rendered envelope. */
+    template <typename OtherSample, std::size_t OtherChannels>
+        requires std::same_as<std::remove_const_t<OtherSample>, Value>
+    void multiplyBy(
+        const BufferView<OtherSample, OtherChannels>& src) const noexcept
+        requires(!std::is_const_v<Sample>) {
+        if constexpr (std::same_as<Scalar, float>) {
+            combineBlocks(src, simd::kernels().multiply);
+        } else {
+            combine(src, [](auto d, auto s) { return d * s; });
+        }
+    }
+
+    /** Scales every channel by gain. */
+    void applyGain(Scalar gain) const noexcept
+        requires(!std::is_const_v<Sample>) {
+        for (std::size_t ch = 0; ch < active_channels_; ++ch) {
+            applyGain(ch, gain);
+        }
+    }
+
+    /** Scales one channel by gain. */
+    void applyGain(std::size_t channel, Scalar gain) const noexcept
+        requires(!std::is_const_v<Sample>) {
+        Scalar* data = reinterpret_cast<Scalar*>(channelSamples(channel));
+        if constexpr (std::same_as<Scalar, float>) {
+            simd::kernels().gain(data, scalarsPerChannel(), gain);
+        } else {
+            transform(data, data, scalarsPerChannel(), [gain](auto d, auto) {
+                return d * decltype(d)(gain);
+            });
+        }
+    }
+
+    /**
+     * Scales every channel by a gain that moves linearly from start_gain at
+     * frame 0 towards end_gain, reaching it one frame past the end, so
+     * consecutive blocks ramp without a repeated step.
+     */
+    void applyGainRamp(Scalar start_gain, Scalar end_gain) const noexcept
+        requires(!std::is_const_v<Sample>) {
+        if (frame_count_ == 0) return;
+        const Scalar step =
+            (end_gain - start_gain) / static_cast<Scalar>(frame_count_);
+        for (std::size_t ch = 0; ch < active_channels_; ++ch) {
+            Sample* samples = channel_ptrs_[ch];
+            if constexpr (is_simd) {
+                // Each frame is already a full batch
+                for (std::size_t i = 0; i < frame_count_; ++i) {
+                    samples[i] *= applause::set1<Value>(
+                        start_gain + static_cast<Scalar>(i) * step);
+                }
+            } else if constexpr (std::same_as<Scalar, float>) {
+                simd::kernels().gainRamp(samples, frame_count_, start_gain,
+                                         step);
+            } else {
+                using Batch = xsimd::batch<Scalar>;
+                constexpr std::size_t kWidth = Batch::size;
+                alignas(Batch) std::array<Scalar, kWidth> ramp;
+                for (std::size_t l = 0; l < kWidth; ++l) {
+                    ramp[l] = static_cast<Scalar>(l) * step;
+                }
+                const Batch offsets = Batch::load_aligned(ramp.data());
+                std::size_t i = 0;
+                for (; i + kWidth <= frame_count_; i += kWidth) {
+                    const Batch gain =
+                        Batch(start_gain + static_cast<Scalar>(i) * step) +
+                        offsets;
+                    (Batch::load_unaligned(samples + i) * gain)
+                        .store_unaligned(samples + i);
+                }
+                for (; i < frame_count_; ++i) {
+                    samples[i] *= start_gain + static_cast<Scalar>(i) * step;
+                }
+            }
+        }
+    }
+
+    /** The largest absolute sample (over all lanes) in channel. */
+    [[nodiscard]] Scalar getPeak(std::size_t channel) const noexcept {
+        if constexpr (std::same_as<Scalar, float>) {
+            return getLevels(channel).peak;
+        }
+        Scalar peak{};
+        reduce(channel, [&peak](auto b) {
+            if constexpr (std::is_same_v<decltype(b), Scalar>) {
+                peak = std::max(peak, std::abs(b));
+            } else {
+                peak = std::max(peak, xsimd::reduce_max(xsimd::abs(b)));
+            }
+        });
+        return peak;
+    }
+
+    /** The largest absolute sample over every channel. */
+    [[nodiscard]] Scalar getPeak() const noexcept {
+        Scalar peak{};
+        for (std::size_t ch = 0; ch < active_channels_; ++ch) {
+            peak = std::max(peak, getPeak(ch));
+        }
+        return peak;
+    }
+
+    /** The root mean square of channel's samples (over all lanes). */
+    [[nodiscard]] Scalar getRms(std::size_t channel) const noexcept {
+        if constexpr (std::same_as<Scalar, float>) {
+            return getLevels(channel).rms;
+        }
+        const std::size_t count = scalarsPerChannel();
+        if (count == 0) return Scalar{};
+        using Batch = xsimd::batch<Scalar>;
+        Batch sum_batch(Scalar{});
+        Scalar sum{};
+        reduce(channel, [&](auto b) {
+            if constexpr (std::is_same_v<decltype(b), Scalar>) {
+                sum += b * b;
+            } else {
+                sum_batch += b * b;
+            }
+        });
+        sum += xsimd::reduce_add(sum_batch);
+        return std::sqrt(sum / static_cast<Scalar>(count));
+    }
+
+    /** A channel's peak and RMS, as returned by getPeak() and getRms(). */
+    struct Levels {
+        Scalar peak{};
+        Scalar rms{};
+    };
+
+    /**
+     * getPeak() and getRms() of channel in a single pass, for meters that
+     * want both every block.
+     */
+    [[nodiscard]] Levels getLevels(std::size_t channel) const noexcept {
+        const std::size_t count = scalarsPerChannel();
+        if (count == 0) return {};
+        if constexpr (std::same_as<Scalar, float>) {
+            float peak = 0.0f;
+            float sum = 0.0f;
+            simd::kernels().levels(
+                reinterpret_cast<const float*>(channelSamples(channel)), count,
+                peak, sum);
+            return {peak, std::sqrt(sum / static_cast<float>(count))};
+        }
+        using Batch = xsimd::batch<Scalar>;
+        Batch peak_batch(Scalar{});
+        Batch sum_batch(Scalar{});
+        Scalar peak{};
+        Scalar sum{};
+        reduce(channel, [&](auto b) {
+            if constexpr (std::is_same_v<decltype(b), Scalar>) {
+                peak = std::max(peak, std::abs(b));
+                sum += b * b;
+            } else {
+                peak_batch = xsimd::max(peak_batch, xsimd::abs(b));
+                sum_batch += b * b;
+            }
+        });
+        peak = std::max(peak, xsimd::reduce_max(peak_batch));
+        sum += xsimd::reduce_add(sum_batch);
+        return {peak, std::sqrt(sum / static_cast<Scalar>(count))};
+    }
+
     [[nodiscard]] ChannelView channel(std::size_t ch) noexcept {
         return ChannelView(channelSamples(ch), frame_count_);
     }
@@ -387,11 +625,178 @@ public:
     }
 
 private:
+    template <typename T>
+    static bool isBatchAligned(const T* p) noexcept {
+        return reinterpret_cast<std::uintptr_t>(p) %
+                   xsimd::default_arch::alignment() ==
+               0;
+    }
+
+    /** dst[i] = f(dst[i], src[i]) over n scalars; f takes batches and scalars. */
+    template <typename F>
+    static void transform(Scalar* dst, const Scalar* src, std::size_t n,
+                          F f) noexcept {
+        using Batch = xsimd::batch<Scalar>;
+        std::size_t i = 0;
+        if (isBatchAligned(dst) && isBatchAligned(src)) {
+            for (; i + Batch::size <= n; i += Batch::size) {
+                f(Batch::load_aligned(dst + i), Batch::load_aligned(src + i))
+                    .store_aligned(dst + i);
+            }
+        } else {
+            for (; i + Batch::size <= n; i += Batch::size) {
+                f(Batch::load_unaligned(dst + i),
+                  Batch::load_unaligned(src + i))
+                    .store_unaligned(dst + i);
+            }
+        }
+        for (; i < n; ++i) dst[i] = f(dst[i], src[i]);
+    }
+
+    template <typename OtherSample, std::size_t OtherChannels, typename F>
+    void combine(const BufferView<OtherSample, OtherChannels>& src,
+                 F f) const noexcept {
+        combineBlocks(src, [f](Scalar* dst, const Scalar* from,
+                               std::size_t n) { transform(dst, from, n, f); });
+    }
+
+    /** Calls kernel(dst, src, n) on each pair of channels' scalars. */
+    template <typename OtherSample, std::size_t OtherChannels, typename F>
+    void combineBlocks(const BufferView<OtherSample, OtherChannels>& src,
+                       F kernel) const noexcept {
+        ASSERT(src.numFrames() == frame_count_,
+               "BufferView: source frame count mismatch");
+        const std::size_t channels =
+            std::min(active_channels_, src.numChannels());
+        for (std::size_t ch = 0; ch < channels; ++ch) {
+            kernel(reinterpret_cast<Scalar*>(channel_ptrs_[ch]),
+                   reinterpret_cast<const Scalar*>(src.channelSamples(ch)),
+                   scalarsPerChannel());
+        }
+    }
+
+    /** Calls f on channel's scalars, as batches and then a scalar tail. */
+    template <typename F>
+    void reduce(std::size_t channel, F f) const noexcept {
+        using Batch = xsimd::batch<Scalar>;
+        const Scalar* data =
+            reinterpret_cast<const Scalar*>(channelSamples(channel));
+        const std::size_t n = scalarsPerChannel();
+        std::size_t i = 0;
+        if (isBatchAligned(data)) {
+            for (; i + Batch::size <= n; i += Batch::size) {
+                f(Batch::load_aligned(data + i));
+            }
+        } else {
+            for (; i + Batch::size <= n; i += Batch::size) {
+                f(Batch::load_unaligned(data + i));
+            }
+        }
+        for (; i < n; ++i) f(data[i]);
+    }
+
     std::size_t frame_count_ = 0;
     std::size_t active_channels_ = 0;
     std::array<Sample*, MaxChannels> channel_ptrs_{};
 };
 
+/**
+ * A run of `count` scalars split at SIMD batch boundaries:
+ * [0, head) are scalars before the first aligned batch, [head, head + body)
+ * are whole aligned batches and the last `tail` are scalars after them.
+ */
+struct SimdSplit {
+    std::size_t head = 0;
+    std::size_t body = 0;
+    std::size_t tail = 0;
+};
+
+/**
+ * Splits `count` scalars starting at `data` into a scalar head, an aligned
+ * batch body and a scalar tail. A pointer that isn't even aligned to T
+ * gets no body at all.
+ */
+template <Scalar T>
+[[nodiscard]] SimdSplit splitForSimd(const T* data,
+                                     std::size_t count) noexcept {
+    using Batch = xsimd::batch<T>;
+    constexpr std::size_t alignment = xsimd::default_arch::alignment();
+    const auto address = reinterpret_cast<std::uintptr_t>(data);
+    if (address % sizeof(T) != 0) return {count, 0, 0};
+
+    const std::size_t misalignment = address % alignment;
+    const std::size_t head = std::min(
+        count, misalignment == 0 ? 0 : (alignment - misalignment) / sizeof(T));
+    const std::size_t body =
+        (count - head) / Batch::size * Batch::size;
+    return {head, body, count - head - body};
+}
+
+/**
+ * One step of forEachSimdChunk(): Value is T for head and tail samples and
+ * xsimd::batch<T> for the body. load() and store() are aligned for any
+ * pointer at the same offset as the split data; use the unaligned versions
+ * for other buffers.
+ */
+template <Scalar T, typename V>
+struct SimdChunk {
+    using Value = V;
+    static constexpr std::size_t width = sampleWidth<V>();
+
+    static Value load(const T* p) noexcept {
+        if constexpr (SimdBatch<V>) {
+            return V::load_aligned(p);
+        } else {
+            return *p;
+        }
+    }
+    static Value loadUnaligned(const T* p) noexcept {
+        if constexpr (SimdBatch<V>) {
+            return V::load_unaligned(p);
+        } else {
+            return *p;
+        }
+    }
+    static void store(T* p, const Value& v) noexcept {
+        if constexpr (SimdBatch<V>) {
+            v.store_aligned(p);
+        } else {
+            *p = v;
+        }
+    }
+    static void storeUnaligned(T* p, const Value& v) noexcept {
+        if constexpr (SimdBatch<V>) {
+            v.store_unaligned(p);
+        } else {
+            *p = v;
+        }
+    }
+};
+
+/**
+ * Walks `count` scalars starting at `data`, calling f(offset, chunk) once per
+ * head sample, once per aligned batch and once per tail sample, in order.
+ * `chunk` is a SimdChunk, so one generic lambda serves all three parts:
+ *
+ * @code
+ * forEachSimdChunk(out, n, [&](std::size_t i, auto chunk) {
+ *     using V = typename decltype(chunk)::Value;
+ *     chunk.store(out + i, chunk.load(out + i) * V(gain));
+ * });
+ * @endcode
+ */
+template <Scalar T, typename F>
+void forEachSimdChunk(const T* data, std::size_t count, F&& f) {
+    using Batch = xsimd::batch<T>;
+    const SimdSplit split = splitForSimd(data, count);
+    std::size_t i = 0;
+    for (; i < split.head; ++i) f(i, SimdChunk<T, T>{});
+    for (const std::size_t end = i + split.body; i < end; i += Batch::size) {
+        f(i, SimdChunk<T, Batch>{});
+    }
+    for (; i < count; ++i) f(i, SimdChunk<T, T>{});
+}
+
 // Common buffer type aliases for convenience
 using MonoBuffer = BufferView<float, 1>;
 using StereoBuffer = BufferView<float, 2>;
@@ -0,0 +1,341 @@
+#include "Convolver.h"
+
+#include <applause/util/SampleType.h>
+#include <applause/util/SharedTables.h>
+
+#include <algorithm>
+#include <bit>
+#include <tuple>
+#include <utility>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+namespace {
+using Batch = xsimd::batch<float>;
+
+// Bins per thread-pool task when the tail's multiply-accumulate is split
+constexpr size_t kTailBinsPerTask = 256;
+
+// acc += x * h over bins [first, last) of split-complex spectra laid out as [re (stride) | im (stride)]
+void multiplyAccumulate(float* acc, const float* x, const float* h, size_t stride, size_t first, size_t last) noexcept {
+    float* acc_re = acc;
+    float* acc_im = acc + stride;
+    const float* x_re = x;
+    const float* x_im = x + stride;
+    const float* h_re = h;
+    const float* h_im = h + stride;
+    for (size_t i = first; i < last; i += Batch::size) {
+        const Batch xr = Batch::load_unaligned(x_re + i);
+        const Batch xi = Batch::load_unaligned(x_im + i);
+        const Batch hr = Batch::load_unaligned(h_re + i);
+        const Batch hi = Batch::load_unaligned(h_im + i);
+        const Batch re = applause::fma(xr, hr, applause::fma(-xi, hi, Batch::load_unaligned(acc_re + i)));
+        const Batch im = applause::fma(xr, hi, applause::fma(xi, hr, Batch::load_unaligned(acc_im + i)));
+        re.store_unaligned(acc_re + i);
+        im.store_unaligned(acc_im + i);
+    }
+}
+
+// Transforms consecutive block-sized partitions of response, each zero-padded to 2 * block, into out
+void transformPartitions(std::span<const float> response, size_t block, size_t count, float* out) {
+    FFT fft(2 * block);
+    const size_t stride = ConvolverKernel::binStride(block);
+    std::vector<float> padded(2 * block);
+    for (size_t p = 0; p < count; ++p) {
+        std::fill(padded.begin(), padded.end(), 0.0f);
+        const size_t start = std::min(p * block, response.size());
+        const size_t length = std::min(block, response.size() - start);
+        std::copy_n(response.begin() + static_cast<std::ptrdiff_t>(start), length, padded.begin());
+        float* spectrum = out + p * 2 * stride;
+        fft.forward(padded.data(), spectrum, spectrum + stride);
+    }
+}
+
+size_t divideRoundingUp(size_t a, size_t b) { return (a + b - 1) / b; }
+
+// Head and tail partition counts for a response of length samples
+std::pair<size_t, size_t> partitionCounts(const ConvolverLayout& layout, size_t length) {
+    if (!layout.hasTail()) return {divideRoundingUp(length, layout.head_block), 0};
+    const size_t offset = layout.tailOffset();
+    return {divideRoundingUp(std::min(length, offset), layout.head_block),
+            length > offset ? divideRoundingUp(length - offset, layout.tail_block) : 0};
+}
+}  // namespace
+
+ConvolverKernel::ConvolverKernel(const ConvolverLayout& layout, std::span<const std::span<const float>> channels)
+    : layout_(layout), num_channels_(channels.size()) {
+    ASSERT(num_channels_ > 0, "ConvolverKernel: needs at least one channel");
+    ASSERT(std::has_single_bit(layout.head_block), "ConvolverKernel: head block must be a power of two");
+    ASSERT(!layout.hasTail() || (std::has_single_bit(layout.tail_block) && layout.tail_block > layout.head_block),
+           "ConvolverKernel: tail block must be a power of two larger than the head block");
+    for (const auto& channel : channels) length_ = std::max(length_, channel.size());
+    std::tie(num_head_, num_tail_) = partitionCounts(layout, length_);
+
+    const size_t head_size = num_head_ * 2 * binStride(layout.head_block);
+    head_.assign(num_channels_ * head_size, 0.0f);
+    const size_t tail_size = num_tail_ * 2 * (layout.hasTail() ? binStride(layout.tail_block) : 0);
+    tail_.assign(num_channels_ * tail_size, 0.0f);
+
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+        const std::span<const float> response = channels[ch];
+        const size_t head_length = layout.hasTail() ? std::min(response.size(), layout.tailOffset()) : response.size();
+        transformPartitions(response.first(head_length), layout.head_block, num_head_, head_.data() + ch * head_size);
+        if (num_tail_ > 0) {
+            transformPartitions(response.subspan(head_length), layout.tail_block, num_tail_,
+                                tail_.data() + ch * tail_size);
+        }
+    }
+}
+
+ConvolverKernel::ConvolverKernel(const ConvolverLayout& layout, std::span<const float> impulse_response)
+    : ConvolverKernel(layout, std::span<const std::span<const float>>(&impulse_response, 1)) {}
+
+std::shared_ptr<const ConvolverKernel> ConvolverKernel::shared(const ConvolverLayout& layout,
+                                                               std::span<const std::span<const float>> channels) {
+    ContentHasher hasher;
+    hasher.add(layout.head_block).add(layout.tail_block).add(channels.size());
+    for (const auto& channel : channels) hasher.add(channel);
+    return SharedTables::getOrBuild<ConvolverKernel>(
+        hasher.value(), [&] { return std::make_shared<ConvolverKernel>(layout, channels); });
+}
+
+std::shared_ptr<const ConvolverKernel> ConvolverKernel::shared(const ConvolverLayout& layout,
+                                                               std::span<const float> impulse_response) {
+    return shared(layout, std::span<const std::span<const float>>(&impulse_response, 1));
+}
+
+Convolver::~Convolver() { finishTail(); }
+
+void Convolver::setTailMode(ConvolverTailMode mode, ThreadPoolExtension* pool) noexcept {
+    ASSERT(mode != ConvolverTailMode::ThreadPool || pool != nullptr, "Convolver: ThreadPool mode needs a pool");
+    tail_mode_ = mode;
+    pool_ = pool;
+}
+
+void Convolver::activate(const ConvolverLayout& layout, size_t num_channels, size_t max_length) {
+    ASSERT(num_channels >= 1 && num_channels <= kMaxChannels, "Convolver: unsupported channel count");
+    ASSERT(std::has_single_bit(layout.head_block), "Convolver: head block must be a power of two");
+    ASSERT(!layout.hasTail() || (std::has_single_bit(layout.tail_block) && layout.tail_block > layout.head_block),
+           "Convolver: tail block must be a power of two larger than the head block");
+    finishTail();
+    layout_ = layout;
+    num_channels_ = num_channels;
+    max_length_ = max_length;
+    std::tie(max_head_, max_tail_) = partitionCounts(layout, std::max<size_t>(max_length, 1));
+
+    const size_t head_block = layout.head_block;
+    head_fft_ = std::make_unique<FFT>(2 * head_block);
+    head_stride_ = ConvolverKernel::binStride(head_block);
+    head_frame_.assign(num_channels * 2 * head_block, 0.0f);
+    head_fdl_.assign(num_channels * max_head_ * 2 * head_stride_, 0.0f);
+    head_out_.assign(num_channels * head_block, 0.0f);
+    head_acc_.assign(2 * head_stride_, 0.0f);
+    head_scratch_.assign(2 * head_block, 0.0f);
+
+    const size_t tail_block = layout.tail_block;
+    tail_fft_ = layout.hasTail() ? std::make_unique<FFT>(2 * tail_block) : nullptr;
+    tail_stride_ = layout.hasTail() ? ConvolverKernel::binStride(tail_block) : 0;
+    blocks_per_tail_ = layout.hasTail() ? tail_block / head_block : 0;
+    for (auto& buffer : tail_in_) buffer.assign(num_channels * tail_block, 0.0f);
+    for (auto& buffer : tail_out_) buffer.assign(num_channels * tail_block, 0.0f);
+    tail_frame_.assign(num_channels * 2 * tail_block, 0.0f);
+    tail_fdl_.assign(num_channels * max_tail_ * 2 * tail_stride_, 0.0f);
+    tail_acc_.assign(num_channels * 2 * tail_stride_, 0.0f);
+    tail_scratch_.assign(2 * tail_block, 0.0f);
+    job_bin_chunks_ = std::max<size_t>(1, divideRoundingUp(tail_stride_, kTailBinsPerTask));
+
+    reset();
+}
+
+void Convolver::reset() noexcept {
+    finishTail();
+    for (auto* buffer : {&head_frame_, &head_fdl_, &head_out_, &tail_frame_, &tail_fdl_}) {
+        std::fill(buffer->begin(), buffer->end(), 0.0f);
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        std::fill(tail_in_[i].begin(), tail_in_[i].end(), 0.0f);
+        std::fill(tail_out_[i].begin(), tail_out_[i].end(), 0.0f);
+    }
+    head_slot_ = head_pos_ = 0;
+    tail_slot_ = tail_phase_ = tail_parity_ = 0;
+}
+
+void Convolver::setKernel(std::shared_ptr<const ConvolverKernel> kernel) {
+    if (kernel && num_channels_ > 0 && !(kernel->layout() == layout_)) {
+        LOG_ERR("Convolver: kernel layout doesn't match the activated layout");
+        return;
+    }
+    // A null kernel publishes nothing, as before: it only drops a kernel still waiting for the audio thread
+    kernels_.publish(kernel ? std::make_unique<std::shared_ptr<const ConvolverKernel>>(std::move(kernel)) : nullptr);
+}
+
+const ConvolverKernel* Convolver::usableKernel() const noexcept {
+    const auto* held = kernels_.get();
+    const ConvolverKernel* kernel = held ? held->get() : nullptr;
+    return kernel && kernel->layout() == layout_ ? kernel : nullptr;
+}
+
+void Convolver::processChannels(float* const* channels, size_t num_channels, size_t num_frames) noexcept {
+    if (num_channels_ == 0) return;
+    // A background tail job may still read the current kernel until the next tail-block boundary
+    if (!layout_.hasTail() || !kernels_.get()) kernels_.update();
+
+    const size_t block = layout_.head_block;
+    size_t done = 0;
+    while (done < num_frames) {
+        const size_t count = std::min(num_frames - done, block - head_pos_);
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+            float* io = channels[ch] + done;
+            std::copy_n(io, count, head_frame_.data() + ch * 2 * block + block + head_pos_);
+            std::copy_n(head_out_.data() + ch * block + head_pos_, count, io);
+        }
+        for (size_t ch = num_channels; ch < num_channels_; ++ch) {
+            std::fill_n(head_frame_.data() + ch * 2 * block + block + head_pos_, count, 0.0f);
+        }
+        head_pos_ += count;
+        done += count;
+        if (head_pos_ == block) {
+            processHeadBlock();
+            head_pos_ = 0;
+        }
+    }
+}
+
+void Convolver::processHeadBlock() noexcept {
+    const size_t block = layout_.head_block;
+    const ConvolverKernel* kernel = usableKernel();
+    const size_t num_partitions = kernel ? std::min(kernel->numHeadPartitions(), max_head_) : 0;
+
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+        float* frame = head_frame_.data() + ch * 2 * block;
+        float* slot = headSlot(ch, head_slot_);
+        head_fft_->forward(frame, slot, slot + head_stride_);
+
+        std::fill(head_acc_.begin(), head_acc_.end(), 0.0f);
+        const size_t kernel_channel = kernel ? std::min(ch, kernel->numChannels() - 1) : 0;
+        for (size_t p = 0; p < num_partitions; ++p) {
+            const float* input = headSlot(ch, (head_slot_ + max_head_ - p) % max_head_);
+            multiplyAccumulate(head_acc_.data(), input, kernel->headPartition(kernel_channel, p), head_stride_, 0,
+                               head_stride_);
+        }
+        head_fft_->inverse(head_acc_.data(), head_acc_.data() + head_stride_, head_scratch_.data());
+
+        // Overlap-save keeps the second half; the tail block two tail blocks back lands on top of it
+        float* out = head_out_.data() + ch * block;
+        std::copy_n(head_scratch_.data() + block, block, out);
+        if (layout_.hasTail()) {
+            const float* tail = tail_out_[tail_parity_].data() + ch * layout_.tail_block + tail_phase_ * block;
+            for (size_t i = 0; i < block; ++i) out[i] += tail[i];
+            float* tail_in = tail_in_[tail_parity_].data() + ch * layout_.tail_block + tail_phase_ * block;
+            std::copy_n(frame + block, block, tail_in);
+        }
+        std::copy_n(frame + block, block, frame);
+    }
+    head_slot_ = (head_slot_ + 1) % max_head_;
+
+    if (layout_.hasTail() && ++tail_phase_ == blocks_per_tail_) {
+        // The previous tail block is due from the next head block on, and this one's inputs are complete
+        finishTail();
+        kernels_.update();
+        scheduleTail();
+        tail_parity_ ^= 1;
+        tail_phase_ = 0;
+    }
+}
+
+void Convolver::scheduleTail() noexcept {
+    job_kernel_ = usableKernel();
+    job_parity_ = tail_parity_;
+    switch (tail_mode_) {
+        case ConvolverTailMode::Background:
+            tail_state_.store(kTailPending, std::memory_order_release);
+            return;
+        case ConvolverTailMode::ThreadPool: {
+            const size_t num_tasks = num_channels_ * job_bin_chunks_;
+            if (pool_ && job_kernel_ && num_tasks > 1 && pool_->hasParallelSupport()) {
+                for (size_t ch = 0; ch < num_channels_; ++ch) transformTailInput(ch);
+                auto previous = pool_->exchangeCallback([this](uint32_t task) {
+                    const size_t first = (task % job_bin_chunks_) * kTailBinsPerTask;
+                    accumulateTail(task / job_bin_chunks_, first, std::min(first + kTailBinsPerTask, tail_stride_));
+                });
+                const bool done = pool_->requestExec(static_cast<uint32_t>(num_tasks));
+                pool_->exchangeCallback(std::move(previous));
+                if (!done) {
+                    for (size_t ch = 0; ch < num_channels_; ++ch) accumulateTail(ch, 0, tail_stride_);
+                }
+                for (size_t ch = 0; ch < num_channels_; ++ch) inverseTail(ch);
+                tail_slot_ = (tail_slot_ + 1) % std::max<size_t>(max_tail_, 1);
+                return;
+            }
+            runTail();
+            return;
+        }
+        case ConvolverTailMode::Inline:
+            runTail();
+            return;
+    }
+}
+
+void Convolver::finishTail() noexcept {
+    uint8_t expected = kTailPending;
+    if (tail_state_.compare_exchange_strong(expected, kTailRunning, std::memory_order_acquire)) {
+        // The background thread hasn't started this one: it's due, so compute it here
+        runTail();
+        tail_state_.store(kTailIdle, std::memory_order_release);
+        return;
+    }
+    while (tail_state_.load(std::memory_order_acquire) != kTailIdle) {
+        // The background thread is computing it; it had a whole tail block, so this wait is short
+    }
+}
+
+bool Convolver::processTail() noexcept {
+    uint8_t expected = kTailPending;
+    if (!tail_state_.compare_exchange_strong(expected, kTailRunning, std::memory_order_acquire)) return false;
+    runTail();
+    tail_state_.store(kTailIdle, std::memory_order_release);
+    return true;
+}
+
+void Convolver::runTail() noexcept {
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+        transformTailInput(ch);
+        accumulateTail(ch, 0, tail_stride_);
+        inverseTail(ch);
+    }
+    tail_slot_ = (tail_slot_ + 1) % std::max<size_t>(max_tail_, 1);
+}
+
+void Convolver::transformTailInput(size_t ch) noexcept {
+    const size_t block = layout_.tail_block;
+    float* frame = tail_frame_.data() + ch * 2 * block;
+    std::copy_n(frame + block, block, frame);
+    std::copy_n(tail_in_[job_parity_].data() + ch * block, block, frame + block);
+    if (max_tail_ == 0) return;
+    float* slot = tailSlot(ch, tail_slot_);
+    tail_fft_->forward(frame, slot, slot + tail_stride_);
+}
+
+void Convolver::accumulateTail(size_t ch, size_t first_bin, size_t last_bin) noexcept {
+    float* acc = tail_acc_.data() + ch * 2 * tail_stride_;
+    std::fill(acc + first_bin, acc + last_bin, 0.0f);
+    std::fill(acc + tail_stride_ + first_bin, acc + tail_stride_ + last_bin, 0.0f);
+    if (!job_kernel_ || max_tail_ == 0) return;
+    const size_t num_partitions = std::min(job_kernel_->numTailPartitions(), max_tail_);
+    const size_t kernel_channel = std::min(ch, job_kernel_->numChannels() - 1);
+    for (size_t p = 0; p < num_partitions; ++p) {
+        const float* input = tailSlot(ch, (tail_slot_ + max_tail_ - p) % max_tail_);
+        const float* partition = job_kernel_->tailPartition(kernel_channel, p);
+        multiplyAccumulate(acc, input, partition, tail_stride_, first_bin, last_bin);
+    }
+}
+
+void Convolver::inverseTail(size_t ch) noexcept {
+    const size_t block = layout_.tail_block;
+    float* acc = tail_acc_.data() + ch * 2 * tail_stride_;
+    tail_fft_->inverse(acc, acc + tail_stride_, tail_scratch_.data());
+    std::copy_n(tail_scratch_.data() + block, block, tail_out_[job_parity_].data() + ch * block);
+}
+
+}  // namespace applause
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/FFT.h>
+#include <applause/extensions/ThreadPoolExtension.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/RealtimeSwap.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace applause {
+
+/** How a Convolver splits its impulse response into partitions. */
+struct ConvolverLayout {
+    size_t head_block = 128;  ///< Partition size of the head, which is also the convolver's latency; a power of two
+    size_t tail_block = 0;    ///< Partition size of the tail, a larger power of two; 0 for a uniform convolver
+
+    [[nodiscard]] bool hasTail() const noexcept { return tail_block > 0; }
+
+    /** Where the tail starts in the impulse response; the head covers everything before it. */
+    [[nodiscard]] size_t tailOffset() const noexcept { return 2 * tail_block; }
+
+    bool operator==(const ConvolverLayout&) const = default;
+};
+
+/**
+ * @brief An impulse response cut into partitions and transformed for a Convolver with the same layout.
+ *
+ * Building one runs an FFT per partition and allocates, so do it off the audio thread and hand it over with
+ * Convolver::setKernel(). It's read-only afterwards, so one kernel can serve any number of convolvers; shared()
+ * builds each distinct response once per process. A kernel holds one response per channel; a mono kernel is applied
+ * to every channel.
+ */
+class ConvolverKernel {
+public:
+    ConvolverKernel(const ConvolverLayout& layout, std::span<const std::span<const float>> channels);
+
+    /** A mono kernel, applied to every channel. */
+    ConvolverKernel(const ConvolverLayout& layout, std::span<const float> impulse_response);
+
+    /**
+     * The kernel for channels shared by every convolver in the process with the same layout and response (see
+     * SharedTables), e.g. one factory IR loaded by many instances. Main or background thread.
+     */
+    [[nodiscard]] static std::shared_ptr<const ConvolverKernel> shared(
+        const ConvolverLayout& layout, std::span<const std::span<const float>> channels);
+
+    /** The shared mono kernel for impulse_response. */
+    [[nodiscard]] static std::shared_ptr<const ConvolverKernel> shared(const ConvolverLayout& layout,
+                                                                       std::span<const float> impulse_response);
+
+    [[nodiscard]] const ConvolverLayout& layout() const noexcept { return layout_; }
+
+    [[nodiscard]] size_t numChannels() const noexcept { return num_channels_; }
+
+    [[nodiscard]] size_t length() const noexcept { return length_; }
+
+    [[nodiscard]] size_t numHeadPartitions() const noexcept { return num_head_; }
+
+    [[nodiscard]] size_t numTailPartitions() const noexcept { return num_tail_; }
+
+    /** Partition p's spectrum for channel: binStride(head_block) real parts, then as many imaginary parts. */
+    [[nodiscard]] const float* headPartition(size_t channel, size_t p) const noexcept {
+        return head_.data() + (channel * num_head_ + p) * 2 * binStride(layout_.head_block);
+    }
+
+    [[nodiscard]] const float* tailPartition(size_t channel, size_t p) const noexcept {
+        return tail_.data() + (channel * num_tail_ + p) * 2 * binStride(layout_.tail_block);
+    }
+
+    /** Bins per spectrum for partitions of block samples, padded to whole cache lines for SIMD. */
+    [[nodiscard]] static constexpr size_t binStride(size_t block) noexcept { return (block + 1 + 15) / 16 * 16; }
+
+private:
+    ConvolverLayout layout_;
+    size_t num_channels_ = 0;
+    size_t length_ = 0;
+    size_t num_head_ = 0;
+    size_t num_tail_ = 0;
+    std::vector<float> head_;  // [channel][partition][re | im]
+    std::vector<float> tail_;
+};
+
+/** Where a Convolver computes its tail partitions. */
+enum class ConvolverTailMode : uint8_t {
+    Inline,      ///< On the audio thread, in the block that completes each tail block
+    ThreadPool,  ///< Split across ThreadPoolExtension's workers (host or fallback pool), else Inline
+    Background,  ///< On a thread of the plugin's own that calls processTail()
+};
+
+/**
+ * @brief Partitioned FFT convolution for long impulse responses (cabinets, reverbs) at a fixed, low latency.
+ *
+ * The head of the impulse response is convolved by uniformly partitioned overlap-save: every head_block samples,
+ * the newest input block is transformed into a frequency-domain delay line, and each partition's spectrum is
+ * multiplied into it with SIMD complex multiply-accumulates. Latency is head_block samples (getLatency()).
+ *
+ * With a tail_block, the response is partitioned non-uniformly: the head covers its first 2 * tail_block samples,
+ * and a second, tail_block-sized stage convolves the rest. Each tail block of input gets a whole tail block of time
+ * before its output is due, so the tail's work can be split across host thread-pool workers, or moved to a
+ * background thread, instead of landing on the audio thread in one piece. Even Inline, the tail's cost arrives once
+ * per tail block rather than once per head block.
+ *
+ * Impulse responses are swapped without locks: setKernel() publishes a ConvolverKernel through a RealtimeSwap, and
+ * the audio thread picks it up at its next tail-block boundary (every head block for a uniform convolver). The input
+ * history carries over, so the new response applies to past input straight away.
+ *
+ * process() replaces the signal with the convolved (wet) signal; mix the dry signal back in delayed by
+ * getLatency().
+ *
+ * @code
+ * // activate()
+ * convolver_.setTailMode(ConvolverTailMode::ThreadPool, &thread_pool_);
+ * convolver_.activate({.head_block = 128, .tail_block = 2048}, 2, 10 * 48000);
+ * latency_.setLatency(convolver_.getLatency());
+ *
+ * // Main thread, after loading an IR
+ * convolver_.setKernel(std::make_unique<ConvolverKernel>(convolver_.layout(), channels));
+ *
+ * // process()
+ * convolver_.process(buffer);
+ * @endcode
+ */
+class Convolver {
+public:
+    static constexpr size_t kMaxChannels = 8;
+
+    Convolver() = default;
+    ~Convolver();
+    Convolver(const Convolver&) = delete;
+    Convolver& operator=(const Convolver&) = delete;
+
+    /**
+     * Main thread: sets the tail's execution; call before activate(). pool is required for ThreadPool and must
+     * outlive the convolver.
+     */
+    void setTailMode(ConvolverTailMode mode, ThreadPoolExtension* pool = nullptr) noexcept;
+
+    /**
+     * Main thread: prepares for num_channels channels of responses up to max_length samples, and clears the input
+     * history. Longer responses are truncated.
+     */
+    void activate(const ConvolverLayout& layout, size_t num_channels, size_t max_length);
+
+    /** Audio thread: clears the input history and any output still pending. */
+    void reset() noexcept;
+
+    /**
+     * Main thread: queues kernel, whose layout must match layout(), to replace the current one. The convolver holds a
+     * reference, so a shared kernel stays alive while in use; a std::unique_ptr converts.
+     */
+    void setKernel(std::shared_ptr<const ConvolverKernel> kernel);
+
+    /** Main thread: releases kernels the audio thread has replaced; call now and then, e.g. from a timer. */
+    void collect() { kernels_.collect(); }
+
+    [[nodiscard]] const ConvolverLayout& layout() const noexcept { return layout_; }
+
+    [[nodiscard]] uint32_t getLatency() const noexcept { return static_cast<uint32_t>(layout_.head_block); }
+
+    /** How long output continues after the input stops: the longest response activate() allows, plus the latency. */
+    [[nodiscard]] uint32_t getTailSamples() const noexcept {
+        return static_cast<uint32_t>(max_length_ + layout_.head_block);
+    }
+
+    /** Audio thread: convolves buffer in place. Channels past the activated count are left alone. */
+    template <size_t MaxChannels>
+    void process(BufferView<float, MaxChannels> buffer) noexcept {
+        std::array<float*, MaxChannels> channels{};
+        const size_t count = std::min(buffer.numChannels(), num_channels_);
+        for (size_t ch = 0; ch < count; ++ch) channels[ch] = buffer.channelSamples(ch);
+        processChannels(channels.data(), count, buffer.numFrames());
+    }
+
+    /**
+     * Background thread, under ConvolverTailMode::Background: computes the pending tail block, if any. Returns
+     * whether there was one. Call it often enough to finish well within a tail block, e.g. every millisecond.
+     */
+    bool processTail() noexcept;
+
+private:
+    enum TailState : uint8_t { kTailIdle, kTailPending, kTailRunning };
+
+    void processChannels(float* const* channels, size_t num_channels, size_t num_frames) noexcept;
+    void processHeadBlock() noexcept;
+    void scheduleTail() noexcept;
+    void finishTail() noexcept;
+    void runTail() noexcept;
+    void transformTailInput(size_t ch) noexcept;
+    void accumulateTail(size_t ch, size_t first_bin, size_t last_bin) noexcept;
+    void inverseTail(size_t ch) noexcept;
+    [[nodiscard]] const ConvolverKernel* usableKernel() const noexcept;
+
+    [[nodiscard]] float* headSlot(size_t ch, size_t slot) noexcept {
+        return head_fdl_.data() + (ch * max_head_ + slot) * 2 * head_stride_;
+    }
+    [[nodiscard]] float* tailSlot(size_t ch, size_t slot) noexcept {
+        return tail_fdl_.data() + (ch * max_tail_ + slot) * 2 * tail_stride_;
+    }
+
+    ConvolverLayout layout_{};
+    size_t num_channels_ = 0;
+    size_t max_length_ = 0;
+    ConvolverTailMode tail_mode_ = ConvolverTailMode::Inline;
+    ThreadPoolExtension* pool_ = nullptr;
+    // The audio thread only swaps the holders, so dropping a reference, and maybe the kernel, stays on the main thread
+    RealtimeSwap<std::shared_ptr<const ConvolverKernel>> kernels_;
+
+    // Head: overlap-save frames ([previous block | current block]), frequency-domain delay line, output block
+    std::unique_ptr<FFT> head_fft_;
+    size_t head_stride_ = 0;
+    size_t max_head_ = 0;
+    size_t head_slot_ = 0;
+    size_t head_pos_ = 0;
+    std::vector<float> head_frame_;
+    std::vector<float> head_fdl_;
+    std::vector<float> head_out_;
+    std::vector<float> head_acc_;
+    std::vector<float> head_scratch_;
+
+    // Tail: input and output blocks are double-buffered between the audio thread and the tail job
+    std::unique_ptr<FFT> tail_fft_;
+    size_t tail_stride_ = 0;
+    size_t max_tail_ = 0;
+    size_t tail_slot_ = 0;
+    size_t blocks_per_tail_ = 0;
+    size_t tail_phase_ = 0;   // Head blocks into the current tail block
+    size_t tail_parity_ = 0;  // Which input and output buffers the current tail block uses
+    std::array<std::vector<float>, 2> tail_in_;
+    std::array<std::vector<float>, 2> tail_out_;
+    std::vector<float> tail_frame_;
+    std::vector<float> tail_fdl_;
+    std::vector<float> tail_acc_;
+    std::vector<float> tail_scratch_;
+
+    // The tail job in flight: a single producer (the audio thread) and one consumer at a time
+    std::atomic<uint8_t> tail_state_{kTailIdle};
+    const ConvolverKernel* job_kernel_ = nullptr;
+    size_t job_parity_ = 0;
+    size_t job_bin_chunks_ = 0;
+};
+
+}  // namespace applause
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
+#include <applause/util/SampleType.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/** How a DelayLine reads between whole samples. */
+enum class DelayInterpolation : uint8_t {
+    None,      ///< The nearest whole sample; for fixed delays and lo-fi effects
+    Linear,    ///< Two taps; cheap, but dulls the highs at fractional delays, which is fine for chorus
+    Hermite,   ///< Four-tap Catmull-Rom cubic; flat to well above Linear, for flangers and pitch shifting
+    Lagrange,  ///< Four-tap third-order Lagrange; maximally flat group delay, for tuned combs and physical models
+};
+
+/**
+ * @brief A multichannel delay line for chorus, flanger, comb and echo voices, read at modulated fractional delays.
+ *
+ * The buffer holds a power-of-two number of frames per channel, so positions wrap with a mask rather than a
+ * modulo, and every frame is written twice, to i and i + capacity(). Reads therefore never wrap: any window of up to
+ * capacity() frames ending at the newest sample is contiguous, so a fixed-delay block read is one copy and an
+ * interpolator's taps are plain neighbouring loads, with no branch per sample.
+ *
+ * Buffers are carved from a MemoryArena in activate(); nothing is allocated while processing.
+ *
+ * Time runs in frames. Per sample, write() the current frame and read() at delays relative to it (delay 0 is the
+ * frame just written), then advance(); a feedback comb reads before it writes, so its shortest delay is 1. Per
+ * block, write() appends a whole BufferView and read() / readModulated() then line up with that block: output frame
+ * i is read relative to input frame i. Delays are clamped to [minDelay(), maxDelay()].
+ *
+ * Samples may be SIMD batches whose lanes are voices (see BufferView): each lane is its own delay line, and the
+ * batch overloads of read() and readModulated() take a delay per lane.
+ *
+ * @code
+ * // activate()
+ * arena_.clear();
+ * delay_.activate(arena_, 2, static_cast<size_t>(0.05 * sample_rate), info.max_frame_size);
+ *
+ * // process(): a chorus, with one LFO-swept delay per frame
+ * delay_.write(input);
+ * for (size_t ch = 0; ch < 2; ++ch) {
+ *     delay_.readModulated<DelayInterpolation::Hermite>(ch, delays_[ch].data(), wet_[ch].data(), num_frames);
+ * }
+ * @endcode
+ *
+ * @tparam S The sample type: float, double, or an xsimd batch of either
+ * @tparam MaxChannels The number of channels the delay line can be activated with
+ */
+template <Sample S = float, size_t MaxChannels = 2>
+class DelayLine {
+public:
+    using Value = S;
+    using Scalar = scalar_t<S>;
+    static constexpr size_t kWidth = sampleWidth<S>();
+
+    /** Frames of capacity activate() needs for these settings. */
+    [[nodiscard]] static constexpr size_t capacityFor(size_t max_delay, size_t max_frames) noexcept {
+        return std::bit_ceil(max_delay + std::max<size_t>(max_frames, 1) + kTapPadding);
+    }
+
+    /** Arena bytes activate() needs for these settings, including alignment padding. */
+    [[nodiscard]] static constexpr size_t requiredArenaBytes(size_t num_channels, size_t max_delay,
+                                                             size_t max_frames) noexcept {
+        constexpr size_t line = defaultByteAlignment;
+        const size_t per_channel = (2 * capacityFor(max_delay, max_frames) * sizeof(S) + line - 1) / line * line;
+        return line - 1 + num_channels * per_channel;
+    }
+
+    /**
+     * Carves num_channels lines from arena, long enough for delays up to max_delay frames with blocks of up to
+     * max_frames (0 for per-sample use only), and clears them.
+     */
+    void activate(MemoryArena& arena, size_t num_channels, size_t max_delay, size_t max_frames = 0) {
+        ASSERT(num_channels <= MaxChannels, "DelayLine: too many channels");
+        num_channels_ = num_channels;
+        max_delay_ = max_delay;
+        max_frames_ = max_frames;
+        capacity_ = capacityFor(max_delay, max_frames);
+        mask_ = capacity_ - 1;
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+            lines_[ch] = arena.allocate<S>(2 * capacity_, defaultByteAlignment);
+            ASSERT(lines_[ch] != nullptr, "Arena too small for DelayLine buffers; see requiredArenaBytes()");
+        }
+        reset();
+    }
+
+    /** Clears the lines to silence. */
+    void reset() noexcept {
+        for (size_t ch = 0; ch < num_channels_; ++ch) std::fill_n(lines_[ch], 2 * capacity_, S(Scalar(0)));
+        pos_ = 0;
+    }
+
+    [[nodiscard]] size_t numChannels() const noexcept { return num_channels_; }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] size_t maxDelay() const noexcept { return max_delay_; }
+
+    /** The shortest delay Mode can read: its newest tap must already be written. */
+    template <DelayInterpolation Mode>
+    [[nodiscard]] static constexpr Scalar minDelay() noexcept {
+        return Mode == DelayInterpolation::Hermite || Mode == DelayInterpolation::Lagrange ? Scalar(1) : Scalar(0);
+    }
+
+    // ---- Per sample -------------------------------------------------------------------------------------------
+
+    /** Stores the current frame of channel. */
+    void write(size_t channel, S sample) noexcept {
+        ASSERT(channel < num_channels_, "DelayLine: channel out of range");
+        lines_[channel][pos_] = sample;
+        lines_[channel][pos_ + capacity_] = sample;
+    }
+
+    /** Moves on to the next frame, once every channel's current frame is written. */
+    void advance() noexcept { pos_ = (pos_ + 1) & mask_; }
+
+    /** Reads channel delay frames before the current frame. */
+    template <DelayInterpolation Mode = DelayInterpolation::Linear>
+    [[nodiscard]] S read(size_t channel, Scalar delay) const noexcept {
+        ASSERT(channel < num_channels_, "DelayLine: channel out of range");
+        return readAt<Mode>(lines_[channel], pos_ + capacity_, delay);
+    }
+
+    /** Reads each lane of channel at its own delay. */
+    template <DelayInterpolation Mode = DelayInterpolation::Linear>
+        requires SimdBatch<S>
+    [[nodiscard]] S read(size_t channel, S delay) const noexcept {
+        ASSERT(channel < num_channels_, "DelayLine: channel out of range");
+        return readLanes<Mode>(lines_[channel], pos_ + capacity_, delay);
+    }
+
+    // ---- Per block --------------------------------------------------------------------------------------------
+
+    /** Appends input to the lines and advances past it. */
+    void write(BufferView<const S, MaxChannels> input) noexcept {
+        ASSERT(input.numChannels() <= num_channels_, "DelayLine: more channels than activated");
+        ASSERT(input.numFrames() <= std::max<size_t>(max_frames_, 1), "DelayLine: block longer than activated");
+        const size_t num_frames = input.numFrames();
+        const size_t first = std::min(num_frames, capacity_ - pos_);
+        for (size_t ch = 0; ch < input.numChannels(); ++ch) {
+            const S* src = input.channelSamples(ch);
+            S* line = lines_[ch];
+            std::copy_n(src, first, line + pos_);
+            std::copy_n(src, first, line + pos_ + capacity_);
+            std::copy_n(src + first, num_frames - first, line);
+            std::copy_n(src + first, num_frames - first, line + capacity_);
+        }
+        pos_ = (pos_ + num_frames) & mask_;
+    }
+
+    /** Reads the block last written, delayed by a whole number of frames, into output. */
+    void read(BufferView<S, MaxChannels> output, size_t delay) const noexcept {
+        ASSERT(output.numChannels() <= num_channels_, "DelayLine: more channels than activated");
+        const size_t num_frames = output.numFrames();
+        delay = std::min(delay, max_delay_);
+        for (size_t ch = 0; ch < output.numChannels(); ++ch) {
+            std::copy_n(lines_[ch] + blockStart(num_frames) - delay, num_frames, output.channelSamples(ch));
+        }
+    }
+
+    /**
+     * Reads num_frames frames of channel into output, frame i delayed by delays[i] relative to frame i of the
+     * num_frames frames last written. For batches, each lane of delays[i] is that lane's delay.
+     *
+     * Scalar lines compute a batch of output frames at a time: the positions, fractions and interpolation run in
+     * SIMD, and only the taps are loaded one lane at a time.
+     */
+    template <DelayInterpolation Mode = DelayInterpolation::Linear>
+    void readModulated(size_t channel, const S* delays, S* output, size_t num_frames) const noexcept {
+        ASSERT(channel < num_channels_, "DelayLine: channel out of range");
+        const S* line = lines_[channel];
+        const size_t start = blockStart(num_frames);
+        if constexpr (SimdBatch<S>) {
+            for (size_t i = 0; i < num_frames; ++i) output[i] = readLanes<Mode>(line, start + i, delays[i]);
+        } else {
+            using Batch = xsimd::batch<S>;
+            constexpr size_t kLanes = Batch::size;
+            size_t i = 0;
+            for (; i + kLanes <= num_frames; i += kLanes) {
+                const Batch delay = Batch::load_unaligned(delays + i);
+                std::array<size_t, kLanes> current{};
+                for (size_t l = 0; l < kLanes; ++l) current[l] = start + i + l;
+                readBatch<Mode, 1>(line, current, delay).store_unaligned(output + i);
+            }
+            for (; i < num_frames; ++i) output[i] = readAt<Mode>(line, start + i, delays[i]);
+        }
+    }
+
+private:
+    // Frames past max_delay + max_frames that the interpolators' outermost taps may reach
+    static constexpr size_t kTapPadding = 3;
+
+    template <DelayInterpolation Mode, typename V>
+    [[nodiscard]] static V interpolate(V newer, V y0, V y1, V older, V frac) noexcept {
+        // y0 and y1 are the whole-sample taps either side of the read position, frac of the way from y0 to y1
+        if constexpr (Mode == DelayInterpolation::Linear) {
+            return applause::fma(frac, y1 - y0, y0);
+        } else if constexpr (Mode == DelayInterpolation::Hermite) {
+            const V c1 = V(Scalar(0.5)) * (y1 - newer);
+            const V c2 = newer - V(Scalar(2.5)) * y0 + V(Scalar(2)) * y1 - V(Scalar(0.5)) * older;
+            const V c3 = V(Scalar(0.5)) * (older - newer) + V(Scalar(1.5)) * (y0 - y1);
+            return applause::fma(applause::fma(applause::fma(c3, frac, c2), frac, c1), frac, y0);
+        } else {
+            const V one(Scalar(1));
+            const V below = frac - one;
+            const V above = frac + one;
+            const V two_below = frac - V(Scalar(2));
+            const V sixth(Scalar(1.0 / 6.0));
+            const V half(Scalar(0.5));
+            const V w_newer = -sixth * frac * below * two_below;
+            const V w_y0 = half * above * below * two_below;
+            const V w_y1 = -half * above * frac * two_below;
+            const V w_older = sixth * above * frac * below;
+            return w_newer * newer + w_y0 * y0 + w_y1 * y1 + w_older * older;
+        }
+    }
+
+    // First mirrored index of the num_frames frames last written
+    [[nodiscard]] size_t blockStart(size_t num_frames) const noexcept { return pos_ + capacity_ - num_frames; }
+
+    template <DelayInterpolation Mode>
+    [[nodiscard]] Scalar clampDelay(Scalar delay) const noexcept {
+        return std::clamp(delay, minDelay<Mode>(), static_cast<Scalar>(max_delay_));
+    }
+
+    // One delay for every lane; current is the mirrored index of the frame delays are relative to
+    template <DelayInterpolation Mode>
+    [[nodiscard]] S readAt(const S* line, size_t current, Scalar delay) const noexcept {
+        delay = clampDelay<Mode>(delay);
+        if constexpr (Mode == DelayInterpolation::None) {
+            return line[current - static_cast<size_t>(delay + Scalar(0.5))];
+        } else {
+            const Scalar whole = std::floor(delay);
+            const S* tap = line + (current - static_cast<size_t>(whole));
+            const S frac(delay - whole);
+            if constexpr (Mode == DelayInterpolation::Linear) {
+                return interpolate<Mode>(tap[0], tap[0], tap[-1], tap[-1], frac);
+            } else {
+                return interpolate<Mode>(tap[1], tap[0], tap[-1], tap[-2], frac);
+            }
+        }
+    }
+
+    // A batch of reads from scalar taps: lane l is relative to scalar index current[l], one frame being Stride
+    // scalars apart
+    template <DelayInterpolation Mode, size_t Stride, typename Batch>
+    [[nodiscard]] Batch readBatch(const Scalar* line, const std::array<size_t, Batch::size>& current,
+                                  Batch delay) const noexcept {
+        constexpr size_t kLanes = Batch::size;
+        delay = xsimd::clip(delay, Batch(minDelay<Mode>()), Batch(static_cast<Scalar>(max_delay_)));
+        const Batch whole = Mode == DelayInterpolation::None ? xsimd::round(delay) : xsimd::floor(delay);
+        const Batch frac = delay - whole;
+
+        alignas(Batch::arch_type::alignment()) std::array<Scalar, kLanes> offsets{};
+        whole.store_aligned(offsets.data());
+        alignas(Batch::arch_type::alignment()) std::array<std::array<Scalar, kLanes>, 4> taps{};
+        for (size_t l = 0; l < kLanes; ++l) {
+            const Scalar* tap = line + (current[l] - static_cast<size_t>(offsets[l]) * Stride);
+            taps[1][l] = tap[0];
+            if constexpr (Mode != DelayInterpolation::None) taps[2][l] = tap[-ptrdiff_t(Stride)];
+            if constexpr (Mode == DelayInterpolation::Hermite || Mode == DelayInterpolation::Lagrange) {
+                taps[0][l] = tap[Stride];
+                taps[3][l] = tap[-2 * ptrdiff_t(Stride)];
+            }
+        }
+        if constexpr (Mode == DelayInterpolation::None) {
+            return Batch::load_aligned(taps[1].data());
+        } else {
+            return interpolate<Mode>(Batch::load_aligned(taps[0].data()), Batch::load_aligned(taps[1].data()),
+                                     Batch::load_aligned(taps[2].data()), Batch::load_aligned(taps[3].data()), frac);
+        }
+    }
+
+    // Batch line, one delay per lane: lane l of frame f is scalar f * kWidth + l, and reads its own voice's line
+    template <DelayInterpolation Mode>
+    [[nodiscard]] S readLanes(const S* line, size_t current, S delay) const noexcept {
+        std::array<size_t, kWidth> indices{};
+        for (size_t l = 0; l < kWidth; ++l) indices[l] = current * kWidth + l;
+        return readBatch<Mode, kWidth>(reinterpret_cast<const Scalar*>(line), indices, delay);
+    }
+
+    std::array<S*, MaxChannels> lines_{};
+    size_t num_channels_ = 0;
+    size_t max_delay_ = 0;
+    size_t max_frames_ = 0;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    size_t pos_ = 0;
+};
+
+}  // namespace applause
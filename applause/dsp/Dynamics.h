@@ -0,0 +1,523 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/DelayLine.h>
+#include <applause/dsp/FastMath.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+namespace dynamics_detail {
+using Batch = xsimd::batch<float>;
+inline constexpr size_t kLanes = Batch::size;
+inline constexpr float kDbPerLog2 = 6.02059991f;  // 20 * log10(2)
+inline constexpr float kMinLevel = 1e-9f;         // -180 dB; keeps log2 on normal floats
+
+inline float timeCoefficient(float ms, float sample_rate) noexcept {
+    return ms > 0.0f ? std::exp(-1000.0f / (ms * sample_rate)) : 0.0f;
+}
+
+inline float dbToGain(float db) noexcept { return std::pow(10.0f, db / 20.0f); }
+
+// Frame frame of channels [group * kLanes, ...) in lanes; missing channels read as silence
+template <typename S, size_t MaxChannels>
+Batch gatherFrame(const BufferView<S, MaxChannels>& buffer, size_t group, size_t frame) noexcept {
+    alignas(Batch) std::array<float, kLanes> lanes{};
+    const size_t first = group * kLanes;
+    const size_t count = std::min(kLanes, buffer.numChannels() - std::min(first, buffer.numChannels()));
+    for (size_t l = 0; l < count; ++l) lanes[l] = buffer.channelSamples(first + l)[frame];
+    return Batch::load_aligned(lanes.data());
+}
+
+template <size_t MaxChannels>
+void scatterFrame(BufferView<float, MaxChannels>& buffer, size_t group, size_t frame, Batch values) noexcept {
+    alignas(Batch) std::array<float, kLanes> lanes;
+    values.store_aligned(lanes.data());
+    const size_t first = group * kLanes;
+    const size_t count = std::min(kLanes, buffer.numChannels() - std::min(first, buffer.numChannels()));
+    for (size_t l = 0; l < count; ++l) buffer.channelSamples(first + l)[frame] = lanes[l];
+}
+}  // namespace dynamics_detail
+
+/** What an EnvelopeFollower follows. */
+enum class EnvelopeDetector : uint8_t {
+    Peak,  ///< |x|, for limiting and transient work
+    Rms,   ///< sqrt of the smoothed x^2, for program-level compression and meters
+};
+
+/**
+ * @brief Attack / release envelope followers for up to MaxChannels channels, with the channels in SIMD lanes.
+ *
+ * Each frame loads one sample of every channel into a batch (kLanes channels per batch), so eight channels cost
+ * about what one does on AVX. The smoothing is a one-pole per channel with separate attack and release poles,
+ * chosen per lane by whether the input is above the envelope.
+ *
+ * @code
+ * follower_.prepare(sample_rate, 10.0f, 150.0f);
+ * follower_.process(input, envelope);  // envelope: a BufferView shaped like input, e.g. from the arena
+ * @endcode
+ */
+template <size_t MaxChannels = 2>
+class EnvelopeFollower {
+public:
+    using Batch = dynamics_detail::Batch;
+    static constexpr size_t kLanes = dynamics_detail::kLanes;
+    static constexpr size_t kNumGroups = (MaxChannels + kLanes - 1) / kLanes;
+
+    explicit EnvelopeFollower(EnvelopeDetector detector = EnvelopeDetector::Peak) : detector_(detector) { reset(); }
+
+    /** Times are for a 1 - 1/e (63%) approach; 0 follows instantly. */
+    void prepare(float sample_rate, float attack_ms, float release_ms) noexcept {
+        ASSERT(sample_rate > 0.0f, "EnvelopeFollower: sample rate must be positive");
+        attack_ = dynamics_detail::timeCoefficient(attack_ms, sample_rate);
+        release_ = dynamics_detail::timeCoefficient(release_ms, sample_rate);
+    }
+
+    void reset() noexcept { state_.fill(Batch(0.0f)); }
+
+    /** Follows input, writing each channel's envelope to the same channel of envelope (which may alias input). */
+    template <typename S>
+    void process(const BufferView<S, MaxChannels>& input, BufferView<float, MaxChannels> envelope) noexcept {
+        ASSERT(envelope.numFrames() >= input.numFrames(), "EnvelopeFollower: envelope buffer too short");
+        const size_t groups = (input.numChannels() + kLanes - 1) / kLanes;
+        for (size_t g = 0; g < groups; ++g) {
+            for (size_t i = 0; i < input.numFrames(); ++i) {
+                const Batch value = step(g, dynamics_detail::gatherFrame(input, g, i));
+                dynamics_detail::scatterFrame(envelope, g, i, value);
+            }
+        }
+    }
+
+    /** Advances group g's channels by one frame of x and returns their envelopes. */
+    Batch step(size_t group, Batch x) noexcept {
+        const Batch level = detector_ == EnvelopeDetector::Peak ? xsimd::abs(x) : x * x;
+        Batch& state = state_[group];
+        const Batch coefficient = xsimd::select(level > state, Batch(attack_), Batch(release_));
+        state = level + coefficient * (state - level);
+        return detector_ == EnvelopeDetector::Peak ? state : xsimd::sqrt(state);
+    }
+
+    /** channel's envelope after the last frame processed. */
+    [[nodiscard]] float getEnvelope(size_t channel) const noexcept {
+        ASSERT(channel < MaxChannels, "EnvelopeFollower: channel out of range");
+        alignas(Batch) std::array<float, kLanes> lanes;
+        state_[channel / kLanes].store_aligned(lanes.data());
+        const float value = lanes[channel % kLanes];
+        return detector_ == EnvelopeDetector::Peak ? value : std::sqrt(value);
+    }
+
+private:
+    EnvelopeDetector detector_;
+    float attack_ = 0.0f;
+    float release_ = 0.0f;
+    std::array<Batch, kNumGroups> state_;
+};
+
+/** Settings of a Compressor; levels in dB. */
+struct CompressorParameters {
+    float threshold_db = -18.0f;
+    float ratio = 4.0f;         ///< Input dB over the threshold per output dB over it; >= 1
+    float knee_db = 6.0f;       ///< Width of the soft knee around the threshold; 0 for a hard knee
+    float attack_ms = 10.0f;    ///< Gain reduction rising
+    float release_ms = 120.0f;  ///< Gain reduction falling
+    float makeup_db = 0.0f;
+    bool linked = true;  ///< One gain for every channel, from the loudest, so the image doesn't shift
+};
+
+/**
+ * @brief A feed-forward compressor for up to MaxChannels channels, with the channels in SIMD lanes.
+ *
+ * Per frame and lane: the peak level in dB, a soft-knee static curve, and the gain reduction smoothed in the dB
+ * domain with its own attack and release (the "smooth decoupled" detector, which doesn't let the release drag
+ * on the attack). Logs and exponentials are the fast::log2 / exp2 over whole batches. Linked, the loudest channel
+ * drives one gain for all of them; unlinked, each lane keeps its own.
+ *
+ * Carries no latency and needs no arena: all its state is a few batches.
+ *
+ * @code
+ * compressor_.prepare(sample_rate);
+ * compressor_.setParameters({.threshold_db = -24.0f, .ratio = 3.0f});
+ * compressor_.process(buffer);             // In place
+ * compressor_.process(buffer, sidechain);  // Or keyed from another signal
+ * @endcode
+ */
+template <size_t MaxChannels = 2>
+class Compressor {
+public:
+    using Batch = dynamics_detail::Batch;
+    static constexpr size_t kLanes = dynamics_detail::kLanes;
+    static constexpr size_t kNumGroups = (MaxChannels + kLanes - 1) / kLanes;
+
+    explicit Compressor(const CompressorParameters& parameters = {}) : parameters_(parameters) { reset(); }
+
+    void prepare(float sample_rate) noexcept {
+        ASSERT(sample_rate > 0.0f, "Compressor: sample rate must be positive");
+        sample_rate_ = sample_rate;
+        updateCoefficients();
+    }
+
+    /** Takes effect at the next process(); the gain reduction carries on from where it is. */
+    void setParameters(const CompressorParameters& parameters) noexcept {
+        ASSERT(parameters.ratio >= 1.0f, "Compressor: ratio must be at least 1");
+        parameters_ = parameters;
+        updateCoefficients();
+    }
+
+    [[nodiscard]] const CompressorParameters& getParameters() const noexcept { return parameters_; }
+
+    void reset() noexcept { reduction_.fill(Batch(0.0f)); }
+
+    /** Compresses buffer in place, detecting on buffer itself. */
+    void process(BufferView<float, MaxChannels> buffer) noexcept { process(buffer, buffer); }
+
+    /** Compresses buffer by the level of sidechain (same channel count, at least as many frames). */
+    template <typename S>
+    void process(BufferView<float, MaxChannels> buffer, const BufferView<S, MaxChannels>& sidechain) noexcept {
+        ASSERT(sidechain.numFrames() >= buffer.numFrames(), "Compressor: sidechain shorter than the buffer");
+        const size_t groups = (buffer.numChannels() + kLanes - 1) / kLanes;
+        std::array<Batch, kNumGroups> levels;
+        for (size_t i = 0; i < buffer.numFrames(); ++i) {
+            for (size_t g = 0; g < groups; ++g) levels[g] = xsimd::abs(dynamics_detail::gatherFrame(sidechain, g, i));
+            if (parameters_.linked) {
+                float loudest = 0.0f;
+                for (size_t g = 0; g < groups; ++g) loudest = std::max(loudest, xsimd::reduce_max(levels[g]));
+                const Batch gain = step(0, Batch(loudest));
+                for (size_t g = 0; g < groups; ++g) {
+                    dynamics_detail::scatterFrame(buffer, g, i, dynamics_detail::gatherFrame(buffer, g, i) * gain);
+                }
+            } else {
+                for (size_t g = 0; g < groups; ++g) {
+                    const Batch gain = step(g, levels[g]);
+                    dynamics_detail::scatterFrame(buffer, g, i, dynamics_detail::gatherFrame(buffer, g, i) * gain);
+                }
+            }
+        }
+    }
+
+    /** Current gain reduction of channel in dB (<= 0), for meters; linked, every channel reports the same. */
+    [[nodiscard]] float getGainReductionDb(size_t channel) const noexcept {
+        ASSERT(channel < MaxChannels, "Compressor: channel out of range");
+        alignas(Batch) std::array<float, kLanes> lanes;
+        const size_t lane = parameters_.linked ? 0 : channel;
+        reduction_[lane / kLanes].store_aligned(lanes.data());
+        return lanes[lane % kLanes];
+    }
+
+    /** The static curve: output level in dB for a steady input level, without makeup. */
+    [[nodiscard]] Batch staticCurve(Batch level_db) const noexcept {
+        const float threshold = parameters_.threshold_db;
+        const float knee = std::max(parameters_.knee_db, 1e-3f);
+        const float slope = 1.0f / parameters_.ratio - 1.0f;
+        const Batch over = level_db - Batch(threshold);
+        const Batch in_knee = over + Batch(0.5f * knee);
+        const Batch soft = level_db + Batch(slope / (2.0f * knee)) * in_knee * in_knee;
+        const Batch hard = level_db + Batch(slope) * over;
+        const Batch curve = xsimd::select(over > Batch(0.5f * knee), hard, soft);
+        return xsimd::select(over < Batch(-0.5f * knee), level_db, curve);
+    }
+
+private:
+    // Gain for one frame of group's peak levels
+    Batch step(size_t group, Batch level) noexcept {
+        using namespace dynamics_detail;
+        const Batch level_db = Batch(kDbPerLog2) * math::log2(xsimd::max(level, Batch(kMinLevel)));
+        const Batch target = staticCurve(level_db) - level_db;
+        Batch& reduction = reduction_[group];
+        const Batch coefficient = xsimd::select(target < reduction, Batch(attack_), Batch(release_));
+        reduction = target + coefficient * (reduction - target);
+        return math::exp2((reduction + Batch(parameters_.makeup_db)) * Batch(1.0f / kDbPerLog2));
+    }
+
+    void updateCoefficients() noexcept {
+        attack_ = dynamics_detail::timeCoefficient(parameters_.attack_ms, sample_rate_);
+        release_ = dynamics_detail::timeCoefficient(parameters_.release_ms, sample_rate_);
+    }
+
+    CompressorParameters parameters_;
+    float sample_rate_ = 44100.0f;
+    float attack_ = 0.0f;
+    float release_ = 0.0f;
+    std::array<Batch, kNumGroups> reduction_;  // Smoothed gain reduction in dB, per lane
+};
+
+/**
+ * @brief The maximum of the last window values pushed, in O(1) amortized per push.
+ *
+ * A monotonic queue: values that can never be the maximum again (an older one no larger than a newer one) are
+ * dropped as the newer arrives, so the front is always the window's maximum and each value is queued and dropped
+ * once. The queue is a ring carved from a MemoryArena in activate().
+ */
+class SlidingWindowMax {
+public:
+    /** Arena bytes activate() needs for a window, including alignment padding. */
+    [[nodiscard]] static constexpr size_t requiredArenaBytes(size_t window) noexcept {
+        return alignof(Entry) - 1 + std::max<size_t>(window, 1) * sizeof(Entry);
+    }
+
+    void activate(MemoryArena& arena, size_t window) {
+        window_ = std::max<size_t>(window, 1);
+        entries_ = arena.allocate<Entry>(window_, alignof(Entry));
+        ASSERT(entries_ != nullptr, "Arena too small for SlidingWindowMax; see requiredArenaBytes()");
+        reset();
+    }
+
+    void reset() noexcept {
+        position_ = 0;
+        head_ = 0;
+        size_ = 0;
+    }
+
+    [[nodiscard]] size_t window() const noexcept { return window_; }
+
+    /** Adds value and returns the maximum of the last window() values, it included. */
+    float push(float value) noexcept {
+        while (size_ > 0 && entries_[(head_ + size_ - 1) % window_].value <= value) --size_;
+        if (size_ > 0 && entries_[head_].position + window_ <= position_) {
+            head_ = (head_ + 1) % window_;
+            --size_;
+        }
+        entries_[(head_ + size_) % window_] = {position_++, value};
+        ++size_;
+        return entries_[head_].value;
+    }
+
+private:
+    struct Entry {
+        uint64_t position;
+        float value;
+    };
+
+    Entry* entries_ = nullptr;
+    size_t window_ = 1;
+    uint64_t position_ = 0;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief A linked lookahead brickwall limiter for up to MaxChannels channels, with optional true-peak detection.
+ *
+ * The detector takes the loudest channel's peak each frame; with true peak on, also the peaks between samples, by
+ * 4x windowed-sinc interpolation (channels in SIMD lanes, as in the ITU-R BS.1770 meter). The gain each peak needs
+ * is held over the lookahead window by a SlidingWindowMax, released exponentially, and averaged over the lookahead,
+ * so the gain ramps down smoothly and reaches what a peak needs by the time the delayed audio gets there. The audio
+ * is delayed by getLatency() frames, which the plugin reports through LatencyExtension.
+ *
+ * Buffers are carved from a MemoryArena in activate(); nothing is allocated while processing.
+ *
+ * @code
+ * // activate()
+ * arena_.clear();
+ * limiter_.activate(arena_, 2, info.max_frame_size, info.sample_rate);
+ * latency_.setLatency(limiter_.getLatency());
+ *
+ * // process()
+ * limiter_.process(buffer);
+ * @endcode
+ */
+template <size_t MaxChannels = 2>
+class LookaheadLimiter {
+public:
+    using Batch = dynamics_detail::Batch;
+    static constexpr size_t kLanes = dynamics_detail::kLanes;
+    static constexpr size_t kNumGroups = (MaxChannels + kLanes - 1) / kLanes;
+    static constexpr size_t kTruePeakTaps = 8;   // Per interpolated phase
+    static constexpr size_t kTruePeakPhases = 4;
+
+    /** Lookahead in frames for lookahead_ms at sample_rate. */
+    [[nodiscard]] static size_t lookaheadFrames(float sample_rate, float lookahead_ms) noexcept {
+        return std::max<size_t>(1, static_cast<size_t>(std::lround(lookahead_ms * 0.001f * sample_rate)));
+    }
+
+    /** Arena bytes activate() needs for these settings, including alignment padding. */
+    [[nodiscard]] static size_t requiredArenaBytes(size_t num_channels, size_t max_frames, float sample_rate,
+                                                   float lookahead_ms = 1.5f) noexcept {
+        constexpr size_t line = defaultByteAlignment;
+        const size_t lookahead = lookaheadFrames(sample_rate, lookahead_ms);
+        const size_t delay = lookahead + (kTruePeakTaps / 2);
+        return SlidingWindowMax::requiredArenaBytes(lookahead + 1) +
+               DelayLine<float, MaxChannels>::requiredArenaBytes(num_channels, delay, max_frames) +
+               2 * (line - 1 + std::max<size_t>(std::max(lookahead, max_frames), 1) * sizeof(float));
+    }
+
+    /** @param true_peak detect the peaks between samples too, at the cost of kTruePeakTaps / 2 frames more latency */
+    explicit LookaheadLimiter(float ceiling_db = -1.0f, float release_ms = 60.0f, bool true_peak = true)
+        : ceiling_db_(ceiling_db), release_ms_(release_ms), true_peak_(true_peak) {
+        designTruePeakFilter();
+    }
+
+    /** Takes effect at once. */
+    void setCeilingDb(float ceiling_db) noexcept {
+        ceiling_db_ = ceiling_db;
+        ceiling_ = dynamics_detail::dbToGain(ceiling_db);
+    }
+
+    /** Takes effect at once. */
+    void setReleaseMs(float release_ms) noexcept {
+        release_ms_ = release_ms;
+        release_ = dynamics_detail::timeCoefficient(release_ms, sample_rate_);
+    }
+
+    /** Changes the detector, and so the latency; takes effect at the next activate(). */
+    void setTruePeak(bool true_peak) noexcept { true_peak_ = true_peak; }
+
+    /**
+     * Carves the buffers for num_channels channels in blocks of up to max_frames from arena, and clears the state.
+     * The arena must have requiredArenaBytes() free and outlive the limiter's use.
+     */
+    void activate(MemoryArena& arena, size_t num_channels, size_t max_frames, float sample_rate,
+                  float lookahead_ms = 1.5f) {
+        ASSERT(num_channels <= MaxChannels, "LookaheadLimiter: too many channels");
+        ASSERT(sample_rate > 0.0f, "LookaheadLimiter: sample rate must be positive");
+        num_channels_ = num_channels;
+        max_frames_ = std::max<size_t>(max_frames, 1);
+        sample_rate_ = sample_rate;
+        lookahead_ = lookaheadFrames(sample_rate, lookahead_ms);
+        detector_delay_ = true_peak_ ? kTruePeakTaps / 2 : 0;
+        active_true_peak_ = true_peak_;
+
+        hold_.activate(arena, lookahead_ + 1);
+        delay_.activate(arena, num_channels, lookahead_ + detector_delay_, max_frames_);
+        average_ = arena.allocate<float>(lookahead_, defaultByteAlignment);
+        gains_ = arena.allocate<float>(max_frames_, defaultByteAlignment);
+        ASSERT(average_ != nullptr && gains_ != nullptr,
+               "Arena too small for LookaheadLimiter buffers; see requiredArenaBytes()");
+        setCeilingDb(ceiling_db_);
+        setReleaseMs(release_ms_);
+        reset();
+    }
+
+    /** Clears the delay, the detector and the gain, e.g. on a transport jump. */
+    void reset() noexcept {
+        hold_.reset();
+        delay_.reset();
+        std::fill_n(average_, lookahead_, 1.0f);
+        average_sum_ = static_cast<double>(lookahead_);
+        average_pos_ = 0;
+        release_state_ = 1.0f;
+        gain_ = 1.0f;
+        history_.fill({});
+    }
+
+    /** Frames the audio is delayed by: the lookahead, plus the true-peak interpolator's delay. */
+    [[nodiscard]] uint32_t getLatency() const noexcept {
+        return static_cast<uint32_t>(lookahead_ + detector_delay_);
+    }
+
+    /** The gain applied to the last frame, in dB (<= 0), for meters. */
+    [[nodiscard]] float getGainReductionDb() const noexcept {
+        return 20.0f * std::log10(std::max(gain_, dynamics_detail::kMinLevel));
+    }
+
+    /** Limits buffer in place, at most the max_frames given to activate(). */
+    void process(BufferView<float, MaxChannels> buffer) noexcept {
+        ASSERT(buffer.numChannels() <= num_channels_, "LookaheadLimiter: more channels than activated");
+        ASSERT(buffer.numFrames() <= max_frames_, "LookaheadLimiter: block longer than activated");
+        const size_t num_frames = std::min(buffer.numFrames(), max_frames_);
+        const size_t groups = (buffer.numChannels() + kLanes - 1) / kLanes;
+
+        for (size_t i = 0; i < num_frames; ++i) {
+            float peak = 0.0f;
+            for (size_t g = 0; g < groups; ++g) {
+                peak = std::max(peak, detect(g, dynamics_detail::gatherFrame(buffer, g, i)));
+            }
+
+            // The gain this frame's peak needs, held over the lookahead and released...
+            const float needed = peak > ceiling_ ? ceiling_ / peak : 1.0f;
+            const float held = 1.0f / hold_.push(1.0f / needed);
+            release_state_ = held < release_state_ ? held : held + release_ * (release_state_ - held);
+
+            // ... then averaged over it, so it has ramped all the way down when the delayed peak comes out
+            average_sum_ += static_cast<double>(release_state_) - average_[average_pos_];
+            average_[average_pos_] = release_state_;
+            average_pos_ = average_pos_ + 1 == lookahead_ ? 0 : average_pos_ + 1;
+            gains_[i] = std::min(1.0f, static_cast<float>(average_sum_ / static_cast<double>(lookahead_)));
+        }
+        if (num_frames > 0) gain_ = gains_[num_frames - 1];
+
+        delay_.write(BufferView<const float, MaxChannels>(buffer));
+        delay_.read(buffer, getLatency());
+        for (size_t ch = 0; ch < buffer.numChannels(); ++ch) {
+            float* samples = buffer.channelSamples(ch);
+            size_t i = 0;
+            for (; i + kLanes <= num_frames; i += kLanes) {
+                (Batch::load_unaligned(samples + i) * Batch::load_aligned(gains_ + i)).store_unaligned(samples + i);
+            }
+            for (; i < num_frames; ++i) samples[i] *= gains_[i];
+        }
+    }
+
+private:
+    // The loudest of group's channels at this frame: the sample, or with true peak the sample kTruePeakTaps / 2
+    // frames back and the three interpolated points after it
+    float detect(size_t group, Batch x) noexcept {
+        if (!active_true_peak_) return xsimd::reduce_max(xsimd::abs(x));
+        auto& history = history_[group];
+        std::copy(history.begin() + 1, history.end(), history.begin());
+        history.back() = x;
+        Batch peak = xsimd::abs(history[kTruePeakTaps - 1 - kTruePeakTaps / 2]);
+        for (size_t p = 1; p < kTruePeakPhases; ++p) {
+            Batch sum(0.0f);
+            for (size_t k = 0; k < kTruePeakTaps; ++k) {
+                sum = xsimd::fma(history[kTruePeakTaps - 1 - k], Batch(true_peak_taps_[p][k]), sum);
+            }
+            peak = xsimd::max(peak, xsimd::abs(sum));
+        }
+        return xsimd::reduce_max(peak);
+    }
+
+    // Hann-windowed sinc for the points a quarter, half and three quarters of a frame after the delayed sample,
+    // normalized to unity gain at DC; tap k weighs the input k frames back. Phase 0 is the sample itself.
+    void designTruePeakFilter() noexcept {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double half = kTruePeakTaps / 2.0;
+        for (size_t p = 1; p < kTruePeakPhases; ++p) {
+            const double phase = static_cast<double>(p) / kTruePeakPhases;
+            std::array<double, kTruePeakTaps> taps;
+            double sum = 0.0;
+            for (size_t k = 0; k < kTruePeakTaps; ++k) {
+                const double t = static_cast<double>(k) - half + phase;
+                const double sinc = std::sin(kPi * t) / (kPi * t);
+                taps[k] = sinc * 0.5 * (1.0 + std::cos(kPi * t / (half + 1.0)));
+                sum += taps[k];
+            }
+            for (size_t k = 0; k < kTruePeakTaps; ++k) true_peak_taps_[p][k] = static_cast<float>(taps[k] / sum);
+        }
+    }
+
+    float ceiling_db_;
+    float release_ms_;
+    bool true_peak_;
+    bool active_true_peak_ = false;
+    float ceiling_ = 1.0f;
+    float release_ = 0.0f;
+    float sample_rate_ = 44100.0f;
+
+    size_t num_channels_ = 0;
+    size_t max_frames_ = 1;
+    size_t lookahead_ = 1;
+    size_t detector_delay_ = 0;
+
+    SlidingWindowMax hold_;  // Of 1 / needed gain, so the window's maximum is its deepest reduction
+    DelayLine<float, MaxChannels> delay_;
+    float* average_ = nullptr;  // The last lookahead_ released gains
+    double average_sum_ = 0.0;
+    size_t average_pos_ = 0;
+    float release_state_ = 1.0f;
+    float* gains_ = nullptr;  // This block's gain per frame
+    float gain_ = 1.0f;
+
+    std::array<std::array<float, kTruePeakTaps>, kTruePeakPhases> true_peak_taps_{};
+    std::array<std::array<Batch, kTruePeakTaps>, kNumGroups> history_{};  // Oldest first, per channel group
+};
+
+}  // namespace applause
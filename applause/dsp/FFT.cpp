@@ -0,0 +1,137 @@
+#include "FFT.h"
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/SampleType.h>
+
+#include <bit>
+#include <cmath>
+#include <numbers>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+FFT::FFT(size_t size) : size_(size), half_(size / 2) {
+    ASSERT(size >= 4 && std::has_single_bit(size), "FFT: size must be a power of two >= 4");
+    const int bits = std::countr_zero(half_);
+    bit_reverse_.resize(half_);
+    for (size_t i = 0; i < half_; ++i) {
+        uint32_t reversed = 0;
+        for (int b = 0; b < bits; ++b) reversed |= static_cast<uint32_t>((i >> b) & 1) << (bits - 1 - b);
+        bit_reverse_[i] = reversed;
+    }
+
+    twiddle_re_.resize(half_);
+    twiddle_im_.resize(half_);
+    for (size_t h = 1; h < half_; h <<= 1) {
+        for (size_t k = 0; k < h; ++k) {
+            const double angle = -std::numbers::pi * static_cast<double>(k) / static_cast<double>(h);
+            twiddle_re_[h - 1 + k] = static_cast<float>(std::cos(angle));
+            twiddle_im_[h - 1 + k] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    real_twiddle_re_.resize(half_ + 1);
+    real_twiddle_im_.resize(half_ + 1);
+    for (size_t k = 0; k <= half_; ++k) {
+        const double angle = -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(size_);
+        real_twiddle_re_[k] = static_cast<float>(std::cos(angle));
+        real_twiddle_im_[k] = static_cast<float>(std::sin(angle));
+    }
+
+    work_re_.resize(half_);
+    work_im_.resize(half_);
+}
+
+void FFT::transform() noexcept {
+    using Batch = xsimd::batch<float>;
+    constexpr size_t kLanes = Batch::size;
+    float* re = work_re_.data();
+    float* im = work_im_.data();
+
+    for (size_t h = 1; h < half_; h <<= 1) {
+        const float* w_re = twiddle_re_.data() + h - 1;
+        const float* w_im = twiddle_im_.data() + h - 1;
+        for (size_t start = 0; start < half_; start += 2 * h) {
+            size_t k = 0;
+            if (h >= kLanes) {
+                for (; k < h; k += kLanes) {
+                    const size_t a = start + k;
+                    const size_t b = a + h;
+                    const Batch wr = Batch::load_unaligned(w_re + k);
+                    const Batch wi = Batch::load_unaligned(w_im + k);
+                    const Batch br = Batch::load_unaligned(re + b);
+                    const Batch bi = Batch::load_unaligned(im + b);
+                    const Batch tr = applause::fma(br, wr, -(bi * wi));
+                    const Batch ti = applause::fma(br, wi, bi * wr);
+                    const Batch ar = Batch::load_unaligned(re + a);
+                    const Batch ai = Batch::load_unaligned(im + a);
+                    (ar - tr).store_unaligned(re + b);
+                    (ai - ti).store_unaligned(im + b);
+                    (ar + tr).store_unaligned(re + a);
+                    (ai + ti).store_unaligned(im + a);
+                }
+            }
+            for (; k < h; ++k) {
+                const size_t a = start + k;
+                const size_t b = a + h;
+                const float tr = re[b] * w_re[k] - im[b] * w_im[k];
+                const float ti = re[b] * w_im[k] + im[b] * w_re[k];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+void FFT::forward(const float* input, float* re, float* im) noexcept {
+    // z[n] = x[2n] + i x[2n + 1]
+    for (size_t n = 0; n < half_; ++n) {
+        work_re_[bit_reverse_[n]] = input[2 * n];
+        work_im_[bit_reverse_[n]] = input[2 * n + 1];
+    }
+    transform();
+
+    // Z = E + iO, where E and O are the spectra of the even and odd samples; X[k] = E[k] + W^k O[k]
+    for (size_t k = 0; k <= half_; ++k) {
+        const size_t a = k % half_;
+        const size_t b = (half_ - k) % half_;
+        const float even_re = 0.5f * (work_re_[a] + work_re_[b]);
+        const float even_im = 0.5f * (work_im_[a] - work_im_[b]);
+        const float odd_re = 0.5f * (work_im_[a] + work_im_[b]);
+        const float odd_im = -0.5f * (work_re_[a] - work_re_[b]);
+        const float wr = real_twiddle_re_[k];
+        const float wi = real_twiddle_im_[k];
+        re[k] = even_re + wr * odd_re - wi * odd_im;
+        im[k] = even_im + wr * odd_im + wi * odd_re;
+    }
+}
+
+void FFT::inverse(const float* re, const float* im, float* output) noexcept {
+    // Rebuild Z = E + iO from X, with re and im swapped so the forward transform computes the inverse
+    for (size_t k = 0; k < half_; ++k) {
+        const size_t m = half_ - k;
+        const float even_re = 0.5f * (re[k] + re[m]);
+        const float even_im = 0.5f * (im[k] - im[m]);
+        const float diff_re = 0.5f * (re[k] - re[m]);
+        const float diff_im = 0.5f * (im[k] + im[m]);
+        // O = diff * W^-k
+        const float wr = real_twiddle_re_[k];
+        const float wi = -real_twiddle_im_[k];
+        const float odd_re = diff_re * wr - diff_im * wi;
+        const float odd_im = diff_re * wi + diff_im * wr;
+        work_re_[bit_reverse_[k]] = even_im + odd_re;
+        work_im_[bit_reverse_[k]] = even_re - odd_im;
+    }
+    transform();
+
+    const float scale = 1.0f / static_cast<float>(half_);
+    for (size_t n = 0; n < half_; ++n) {
+        output[2 * n] = work_im_[n] * scale;
+        output[2 * n + 1] = work_re_[n] * scale;
+    }
+}
+
+}  // namespace applause
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace applause {
+
+/**
+ * @brief Real-input FFT of a fixed power-of-two size, with spectra in split-complex form.
+ *
+ * forward() turns size() real samples into numBins() = size() / 2 + 1 bins, stored as separate real and imaginary
+ * arrays so spectral code (e.g. Convolver's complex multiply-accumulate) can run on them with plain SIMD loads.
+ * inverse() is scaled so inverse(forward(x)) == x.
+ *
+ * The real transform packs even and odd samples into one complex FFT of half the size, whose butterflies run in
+ * SIMD once a stage is at least a batch wide. Twiddles and the bit-reversal table are computed in the constructor,
+ * which allocates; forward() and inverse() don't, but share internal scratch, so each thread needs its own FFT.
+ */
+class FFT {
+public:
+    /** @param size Number of real samples; a power of two, at least 4 */
+    explicit FFT(size_t size);
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] size_t numBins() const noexcept { return half_ + 1; }
+
+    /** Transforms size() samples of input into numBins() bins of re and im. */
+    void forward(const float* input, float* re, float* im) noexcept;
+
+    /** Transforms numBins() bins of re and im back into size() samples of output. */
+    void inverse(const float* re, const float* im, float* output) noexcept;
+
+private:
+    // In-place forward complex FFT of half_ points over work_, whose input is already in bit-reversed order
+    void transform() noexcept;
+
+    size_t size_;
+    size_t half_;
+    std::vector<uint32_t> bit_reverse_;
+    std::vector<float> twiddle_re_;  // Stage with half-length h uses entries [h - 1, 2h - 1)
+    std::vector<float> twiddle_im_;
+    std::vector<float> real_twiddle_re_;  // e^(-2 pi i k / size), k in [0, half_]
+    std::vector<float> real_twiddle_im_;
+    std::vector<float> work_re_;
+    std::vector<float> work_im_;
+};
+
+}  // namespace applause
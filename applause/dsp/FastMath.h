@@ -0,0 +1,328 @@
+#pragma once
+
+#include <applause/util/SampleType.h>
+
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+
+#include <xsimd/xsimd.hpp>
+
+// Route applause::math:: to the fast:: approximations; build with APPLAUSE_FAST_MATH=0 for the exact functions
+#ifndef APPLAUSE_FAST_MATH
+#define APPLAUSE_FAST_MATH 1
+#endif
+
+namespace applause {
+
+/**
+ * Fast approximations of transcendental functions for float samples (scalar or SIMD batch).
+ *
+ * These replace libm calls in hot loops where a few ulps of error are inaudible. Each function documents its
+ * valid input range and error bound; outside the valid range results are unspecified (but never trap).
+ * The exact std:: / xsimd:: functions remain the reference, and tests check the approximations against them.
+ */
+namespace fast {
+
+namespace detail {
+// p * 2^n for a whole-valued n in [-126, 127], written straight into the exponent bits
+template <Sample S>
+inline S scaleByPow2(S p, S n) noexcept {
+    if constexpr (SimdBatch<S>) {
+        using IntBatch = xsimd::batch<int32_t, typename S::arch_type>;
+        const IntBatch bits = (xsimd::batch_cast<int32_t>(n) + IntBatch(127)) << 23;
+        return p * xsimd::bitwise_cast<float>(bits);
+    } else {
+        const int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+        return p * std::bit_cast<float>(bits);
+    }
+}
+
+template <Sample S>
+inline S round(S x) noexcept {
+    if constexpr (SimdBatch<S>)
+        return xsimd::round(x);
+    else
+        return std::round(x);
+}
+}  // namespace detail
+
+/**
+ * 2^x. Splits x into a rounded integer part, applied directly to the float exponent bits, and a fraction in
+ * [-0.5, 0.5] evaluated with a degree-6 polynomial.
+ *
+ * Valid for x in [-126, 126] (inputs are clamped to that range). Relative error < 3e-7.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S exp2(S x) noexcept {
+    x = applause::min(applause::max(x, S(-126.0f)), S(126.0f));
+
+    const S xi = detail::round(x);
+    const S f = x - xi;
+
+    // Taylor coefficients of 2^f = e^(f ln2); on |f| <= 0.5 the truncation error is below float precision
+    S p = S(1.5403530393381606e-4f);
+    p = p * f + S(1.3333558146428443e-3f);
+    p = p * f + S(9.6181291076284772e-3f);
+    p = p * f + S(5.5504108664821580e-2f);
+    p = p * f + S(2.4022650695910071e-1f);
+    p = p * f + S(6.9314718055994531e-1f);
+    p = p * f + S(1.0f);
+
+    return detail::scaleByPow2(p, xi);
+}
+
+/**
+ * log2(x). Takes the exponent from the float bits and evaluates log2 of the mantissa, re-centered to
+ * [sqrt(0.5), sqrt(2)), with an odd atanh series in t = (m - 1) / (m + 1).
+ *
+ * Valid for positive, normal x. Absolute error < 2e-7 plus one ulp of the result.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S log2(S x) noexcept {
+    constexpr float kSqrt2 = 1.41421356237f;
+
+    S m;
+    S e;
+    if constexpr (SimdBatch<S>) {
+        using IntBatch = xsimd::batch<int32_t, typename S::arch_type>;
+        const IntBatch bits = xsimd::bitwise_cast<int32_t>(x);
+        const IntBatch exponent = ((bits >> 23) & IntBatch(0xFF)) - IntBatch(127);
+        m = xsimd::bitwise_cast<float>((bits & IntBatch(0x7FFFFF)) | IntBatch(0x3F800000));
+        const auto big = m > S(kSqrt2);
+        m = xsimd::select(big, m * S(0.5f), m);
+        e = xsimd::batch_cast<float>(exponent) + xsimd::select(big, S(1.0f), S(0.0f));
+    } else {
+        const auto bits = std::bit_cast<int32_t>(x);
+        const int32_t exponent = ((bits >> 23) & 0xFF) - 127;
+        m = std::bit_cast<float>((bits & 0x7FFFFF) | 0x3F800000);
+        e = static_cast<float>(exponent);
+        if (m > kSqrt2) {
+            m *= 0.5f;
+            e += 1.0f;
+        }
+    }
+
+    // log2(m) = 2/ln2 * atanh(t), t in [-0.172, 0.172]
+    const S t = (m - S(1.0f)) / (m + S(1.0f));
+    const S t2 = t * t;
+    S p = S(3.2059889797532523e-1f);
+    p = p * t2 + S(4.1219858311113244e-1f);
+    p = p * t2 + S(5.7707801635558536e-1f);
+    p = p * t2 + S(9.6179669392597560e-1f);
+    p = p * t2 + S(2.8853900817779268f);
+    return e + t * p;
+}
+
+/**
+ * tan(x) for the bilinear prewarp, tan(pi * f / fs) with f below Nyquist. Evaluates the Cephes odd polynomial on
+ * [0, pi/4] and reflects the upper half through tan(x) = 1 / tan(pi/2 - x), so accuracy holds up to the pole.
+ *
+ * Valid for x in [0, pi/2). Relative error < 5e-7.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S tan(S x) noexcept {
+    constexpr float kPiOver4 = 0.785398163397f;
+    // pi/2 split in two floats: kPiOver2 - x is exact, and the low part restores the bits the float lost, which
+    // matter once pi/2 - x gets small
+    constexpr float kPiOver2 = 1.57079637050628662109375f;
+    constexpr float kPiOver2Low = -4.37113900018624283e-8f;
+
+    const auto reflect = x > S(kPiOver4);
+    S y;
+    if constexpr (SimdBatch<S>)
+        y = xsimd::select(reflect, (S(kPiOver2) - x) + S(kPiOver2Low), x);
+    else
+        y = reflect ? (kPiOver2 - x) + kPiOver2Low : x;
+
+    const S z = y * y;
+    S p = S(9.38540185543e-3f);
+    p = p * z + S(3.11992232697e-3f);
+    p = p * z + S(2.44301354525e-2f);
+    p = p * z + S(5.34112807005e-2f);
+    p = p * z + S(1.33387994085e-1f);
+    p = p * z + S(3.33331568548e-1f);
+    const S t = applause::fma(p * z, y, y);
+
+    if constexpr (SimdBatch<S>)
+        return xsimd::select(reflect, S(1.0f) / t, t);
+    else
+        return reflect ? 1.0f / t : t;
+}
+
+/**
+ * e^x, for the curvature of exponential segments and envelope coefficients. Splits x = n ln2 + r with a two-part
+ * ln2, so r in [-ln2/2, ln2/2] is exact, evaluates e^r with a degree-7 polynomial and applies 2^n to the exponent
+ * bits.
+ *
+ * Valid for x in [-87, 88] (inputs are clamped to that range). Relative error < 3e-7.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S exp(S x) noexcept {
+    constexpr float kLog2e = 1.44269504089f;
+    constexpr float kLn2High = 0.693359375f;  // Few mantissa bits, so n * kLn2High is exact
+    constexpr float kLn2Low = -2.12194440e-4f;
+
+    x = applause::min(applause::max(x, S(-87.0f)), S(88.0f));
+    const S n = detail::round(x * S(kLog2e));
+    S r = applause::fma(n, S(-kLn2High), x);
+    r = applause::fma(n, S(-kLn2Low), r);
+
+    S p = S(1.0f / 5040.0f);
+    p = applause::fma(p, r, S(1.0f / 720.0f));
+    p = applause::fma(p, r, S(1.0f / 120.0f));
+    p = applause::fma(p, r, S(1.0f / 24.0f));
+    p = applause::fma(p, r, S(1.0f / 6.0f));
+    p = applause::fma(p, r, S(0.5f));
+    p = applause::fma(p, r, S(1.0f));
+    p = applause::fma(p, r, S(1.0f));
+    return detail::scaleByPow2(p, n);
+}
+
+/**
+ * sin(x), for oscillators, LFOs and constant-power pans. Reduces x by the nearest multiple n of pi, using a
+ * three-part pi so the reduction stays exact, and evaluates the degree-11 odd Taylor polynomial on [-pi/2, pi/2],
+ * negated for odd n.
+ *
+ * Valid for |x| <= 8192. Absolute error < 2e-7.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S sin(S x) noexcept {
+    constexpr float kInvPi = 0.318309886184f;
+    constexpr float kPi1 = 3.140625f;
+    constexpr float kPi2 = 9.67502593994140625e-4f;
+    constexpr float kPi3 = 1.509957990978376432e-7f;
+
+    const S n = detail::round(x * S(kInvPi));
+    S r = applause::fma(n, S(-kPi1), x);
+    r = applause::fma(n, S(-kPi2), r);
+    r = applause::fma(n, S(-kPi3), r);
+
+    const S r2 = r * r;
+    S p = S(-2.5052108385441720e-8f);
+    p = applause::fma(p, r2, S(2.7557319223985893e-6f));
+    p = applause::fma(p, r2, S(-1.9841269841269841e-4f));
+    p = applause::fma(p, r2, S(8.3333333333333333e-3f));
+    p = applause::fma(p, r2, S(-1.6666666666666667e-1f));
+    const S s = applause::fma(p * r2, r, r);
+
+    // (-1)^n without integer ops: n / 2 has a fractional part of 0.5 exactly when n is odd
+    const S half = n * S(0.5f);
+    S parity;
+    if constexpr (SimdBatch<S>)
+        parity = half - xsimd::floor(half);
+    else
+        parity = half - std::floor(half);
+    return s * (S(1.0f) - S(4.0f) * parity);
+}
+
+/**
+ * tanh(x), for saturators and soft clippers. Evaluates 1 - 2 / (e^2x + 1) through fast::exp, with its Taylor
+ * series below |x| = 1/16, where that form would lose the small result to cancellation.
+ *
+ * Valid for all finite x; |x| >= 10 returns +-1. Absolute error < 3e-7, relative error < 3e-6.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S tanh(S x) noexcept {
+    const S clamped = applause::min(applause::max(x, S(-10.0f)), S(10.0f));
+    const S large = S(1.0f) - S(2.0f) / (fast::exp(clamped * S(2.0f)) + S(1.0f));
+
+    const S x2 = x * x;
+    S p = S(-17.0f / 315.0f);
+    p = applause::fma(p, x2, S(2.0f / 15.0f));
+    p = applause::fma(p, x2, S(-1.0f / 3.0f));
+    const S small = applause::fma(p * x2, x, x);
+
+    if constexpr (SimdBatch<S>)
+        return xsimd::select(xsimd::abs(x) < S(0.0625f), small, large);
+    else
+        return std::abs(x) < 0.0625f ? small : large;
+}
+
+}  // namespace fast
+
+/**
+ * The transcendental functions the framework's hot paths call. With APPLAUSE_FAST_MATH (the default) float and
+ * float-batch arguments go to the fast:: approximations above; without it, and for double, they're the exact
+ * std:: / xsimd:: functions, to rule the approximations out when chasing a numerical problem.
+ */
+namespace math {
+
+template <Sample S>
+inline constexpr bool use_fast_math_v = APPLAUSE_FAST_MATH && std::same_as<scalar_t<S>, float>;
+
+template <Sample S>
+inline S exp2(S x) noexcept {
+    if constexpr (use_fast_math_v<S>) {
+        return fast::exp2(x);
+    } else {
+        using std::exp2;
+        using xsimd::exp2;
+        return exp2(x);
+    }
+}
+
+template <Sample S>
+inline S log2(S x) noexcept {
+    if constexpr (use_fast_math_v<S>) {
+        return fast::log2(x);
+    } else {
+        using std::log2;
+        using xsimd::log2;
+        return log2(x);
+    }
+}
+
+template <Sample S>
+inline S exp(S x) noexcept {
+    if constexpr (use_fast_math_v<S>) {
+        return fast::exp(x);
+    } else {
+        using std::exp;
+        using xsimd::exp;
+        return exp(x);
+    }
+}
+
+template <Sample S>
+inline S tan(S x) noexcept {
+    if constexpr (use_fast_math_v<S>) {
+        return fast::tan(x);
+    } else {
+        using std::tan;
+        using xsimd::tan;
+        return tan(x);
+    }
+}
+
+template <Sample S>
+inline S sin(S x) noexcept {
+    if constexpr (use_fast_math_v<S>) {
+        return fast::sin(x);
+    } else {
+        using std::sin;
+        using xsimd::sin;
+        return sin(x);
+    }
+}
+
+template <Sample S>
+inline S tanh(S x) noexcept {
+    if constexpr (use_fast_math_v<S>) {
+        return fast::tanh(x);
+    } else {
+        using std::tanh;
+        using xsimd::tanh;
+        return tanh(x);
+    }
+}
+
+}  // namespace math
+}  // namespace applause
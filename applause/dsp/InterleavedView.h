@@ -0,0 +1,215 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/SampleType.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * @brief Non-owning view over interleaved audio: frame i holds channel 0..numChannels()-1 at data()[i * numChannels()].
+ *
+ * The counterpart to BufferView for hosts and scratch buffers that keep frames together. A stereo view's memory is
+ * packed L/R pairs, so loading it as xsimd::batch<T> gives registers of alternating left and right samples, and
+ * stereoFrames() reinterprets it as StereoSample<T> frames without copying. interleave() and deinterleave() convert
+ * from and to a planar BufferView at the edges; packLanes() and unpackLanes() do the same for SIMD batches whose
+ * lanes are channels.
+ */
+template <typename T>
+    requires Scalar<std::remove_const_t<T>>
+class InterleavedView {
+public:
+    using Value = std::remove_const_t<T>;
+
+    constexpr InterleavedView() noexcept = default;
+
+    constexpr InterleavedView(T* data, size_t channel_count, size_t frame_count) noexcept {
+        if (data == nullptr && channel_count != 0 && frame_count != 0) {
+            LOG_ERR("InterleavedView: null data pointer with nonzero channel and frame counts");
+            return;
+        }
+        data_ = data;
+        channel_count_ = channel_count;
+        frame_count_ = frame_count;
+    }
+
+    /** Views StereoSample frames as two interleaved channels. */
+    constexpr explicit InterleavedView(std::span<std::conditional_t<std::is_const_v<T>, const StereoSample<Value>,
+                                                                    StereoSample<Value>>> frames) noexcept
+        : InterleavedView(reinterpret_cast<T*>(frames.data()), 2, frames.size()) {}
+
+    /** Converts a writable view to a read-only one. */
+    template <typename Other>
+        requires std::is_const_v<T> && std::same_as<Other, Value>
+    constexpr InterleavedView(const InterleavedView<Other>& other) noexcept
+        : data_(other.data()), channel_count_(other.numChannels()), frame_count_(other.numFrames()) {}
+
+    [[nodiscard]] constexpr T* data() const noexcept { return data_; }
+    [[nodiscard]] constexpr size_t numChannels() const noexcept { return channel_count_; }
+    [[nodiscard]] constexpr size_t numFrames() const noexcept { return frame_count_; }
+    [[nodiscard]] constexpr size_t numScalars() const noexcept { return channel_count_ * frame_count_; }
+
+    [[nodiscard]] T* framePtr(size_t frame) const noexcept {
+        ASSERT(frame < frame_count_, "InterleavedView: frame out of range");
+        return data_ + frame * channel_count_;
+    }
+
+    [[nodiscard]] Value load(size_t channel, size_t frame) const noexcept {
+        ASSERT(channel < channel_count_, "InterleavedView: channel out of range");
+        return framePtr(frame)[channel];
+    }
+
+    void store(size_t channel, size_t frame, Value value) const noexcept
+        requires(!std::is_const_v<T>) {
+        ASSERT(channel < channel_count_, "InterleavedView: channel out of range");
+        framePtr(frame)[channel] = value;
+    }
+
+    /** Frames [start_frame, end_frame) of this view. */
+    [[nodiscard]] InterleavedView getSubView(size_t start_frame, size_t end_frame) const noexcept {
+        ASSERT(start_frame <= end_frame && end_frame <= frame_count_, "InterleavedView: invalid frame range");
+        return {data_ ? data_ + start_frame * channel_count_ : nullptr, channel_count_, end_frame - start_frame};
+    }
+
+    /** This stereo view's frames as StereoSample<T>, without copying. */
+    [[nodiscard]] auto stereoFrames() const noexcept {
+        using Frame = std::conditional_t<std::is_const_v<T>, const StereoSample<Value>, StereoSample<Value>>;
+        static_assert(sizeof(StereoSample<Value>) == 2 * sizeof(Value), "StereoSample must be two packed scalars");
+        ASSERT(channel_count_ == 2, "InterleavedView::stereoFrames: view isn't stereo");
+        return std::span<Frame>(reinterpret_cast<Frame*>(data_), frame_count_);
+    }
+
+    void clear() const noexcept
+        requires(!std::is_const_v<T>) {
+        std::fill_n(data_, numScalars(), Value{});
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t channel_count_ = 0;
+    size_t frame_count_ = 0;
+};
+
+namespace detail {
+// Fixed channel counts let the compiler turn these into unpack/zip (SSE/AVX) or st2/st4 and ld2/ld4 (NEON)
+// shuffles; other counts fall back to a strided loop per channel
+template <size_t Channels, typename T>
+void interleaveFixed(const T* const* planar, T* __restrict out, size_t frames) noexcept {
+    std::array<const T*, Channels> in;
+    std::copy_n(planar, Channels, in.begin());
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t c = 0; c < Channels; ++c) out[i * Channels + c] = in[c][i];
+    }
+}
+
+template <size_t Channels, typename T>
+void deinterleaveFixed(const T* __restrict in, T* const* planar, size_t frames) noexcept {
+    std::array<T*, Channels> out;
+    std::copy_n(planar, Channels, out.begin());
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t c = 0; c < Channels; ++c) out[c][i] = in[i * Channels + c];
+    }
+}
+
+template <typename T>
+void interleaveChannels(const T* const* planar, size_t channels, T* out, size_t stride, size_t frames) noexcept {
+    if (stride == channels) {
+        switch (channels) {
+        case 1: std::copy_n(planar[0], frames, out); return;
+        case 2: interleaveFixed<2>(planar, out, frames); return;
+        case 4: interleaveFixed<4>(planar, out, frames); return;
+        case 8: interleaveFixed<8>(planar, out, frames); return;
+        default: break;
+        }
+    }
+    for (size_t c = 0; c < channels; ++c) {
+        const T* in = planar[c];
+        for (size_t i = 0; i < frames; ++i) out[i * stride + c] = in[i];
+    }
+}
+
+template <typename T>
+void deinterleaveChannels(const T* in, size_t stride, T* const* planar, size_t channels, size_t frames) noexcept {
+    if (stride == channels) {
+        switch (channels) {
+        case 1: std::copy_n(in, frames, planar[0]); return;
+        case 2: deinterleaveFixed<2>(in, planar, frames); return;
+        case 4: deinterleaveFixed<4>(in, planar, frames); return;
+        case 8: deinterleaveFixed<8>(in, planar, frames); return;
+        default: break;
+        }
+    }
+    for (size_t c = 0; c < channels; ++c) {
+        T* out = planar[c];
+        for (size_t i = 0; i < frames; ++i) out[i] = in[i * stride + c];
+    }
+}
+
+template <typename S, size_t MaxChannels>
+std::array<S*, MaxChannels> channelPointers(const BufferView<S, MaxChannels>& view) noexcept {
+    std::array<S*, MaxChannels> ptrs{};
+    for (size_t ch = 0; ch < view.numChannels(); ++ch) ptrs[ch] = view.channelSamples(ch);
+    return ptrs;
+}
+}  // namespace detail
+
+/** Copies planar's channels into out's frames. Channel and frame counts must match. */
+template <typename S, size_t MaxChannels, Scalar T>
+    requires std::same_as<std::remove_const_t<S>, T>
+void interleave(const BufferView<S, MaxChannels>& planar, InterleavedView<T> out) noexcept {
+    ASSERT(planar.numChannels() == out.numChannels(), "interleave: channel count mismatch");
+    ASSERT(planar.numFrames() == out.numFrames(), "interleave: frame count mismatch");
+    if (out.numScalars() == 0) return;
+    const auto in = detail::channelPointers(planar);
+    detail::interleaveChannels<T>(in.data(), out.numChannels(), out.data(), out.numChannels(), out.numFrames());
+}
+
+/** Copies in's frames into planar's channels. Channel and frame counts must match. */
+template <typename U, Scalar T, size_t MaxChannels>
+    requires std::same_as<std::remove_const_t<U>, T>
+void deinterleave(InterleavedView<U> in, const BufferView<T, MaxChannels>& planar) noexcept {
+    ASSERT(planar.numChannels() == in.numChannels(), "deinterleave: channel count mismatch");
+    ASSERT(planar.numFrames() == in.numFrames(), "deinterleave: frame count mismatch");
+    if (in.numScalars() == 0) return;
+    const auto out = detail::channelPointers(planar);
+    detail::deinterleaveChannels<T>(in.data(), in.numChannels(), out.data(), in.numChannels(), in.numFrames());
+}
+
+/**
+ * Packs planar's channels into the lanes of out, one batch per frame: lane c of out[i] is channel c's frame i, and
+ * lanes past the channel count are zeroed. Lets a per-channel filter run every channel in one register.
+ */
+template <typename S, size_t MaxChannels, SimdBatch Batch>
+    requires std::same_as<std::remove_const_t<S>, scalar_t<Batch>>
+void packLanes(const BufferView<S, MaxChannels>& planar, std::span<Batch> out) noexcept {
+    using T = scalar_t<Batch>;
+    ASSERT(planar.numChannels() <= Batch::size, "packLanes: more channels than lanes");
+    ASSERT(out.size() == planar.numFrames(), "packLanes: frame count mismatch");
+    if (out.empty()) return;
+    T* lanes = reinterpret_cast<T*>(out.data());
+    if (planar.numChannels() < Batch::size) std::fill_n(lanes, out.size() * Batch::size, T{});
+    const auto in = detail::channelPointers(planar);
+    detail::interleaveChannels<T>(in.data(), planar.numChannels(), lanes, Batch::size, out.size());
+}
+
+/** The inverse of packLanes(): lane c of in[i] goes to planar's channel c, frame i. */
+template <SimdBatch Batch, typename T, size_t MaxChannels>
+    requires std::same_as<T, scalar_t<Batch>>
+void unpackLanes(std::span<const Batch> in, const BufferView<T, MaxChannels>& planar) noexcept {
+    ASSERT(planar.numChannels() <= Batch::size, "unpackLanes: more channels than lanes");
+    ASSERT(in.size() == planar.numFrames(), "unpackLanes: frame count mismatch");
+    if (in.empty()) return;
+    const auto out = detail::channelPointers(planar);
+    detail::deinterleaveChannels<T>(reinterpret_cast<const T*>(in.data()), Batch::size, out.data(),
+                                    planar.numChannels(), in.size());
+}
+
+}  // namespace applause
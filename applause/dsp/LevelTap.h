@@ -0,0 +1,109 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/ScopeBuffer.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace applause {
+
+/**
+ * Audio-side half of a level meter. push() reduces each block to one peak and one mean square per channel (a single
+ * SIMD pass through BufferView::getLevels()) and hands just those summaries to the UI through a ScopeBuffer; the
+ * samples themselves never cross threads. readLevels() on the UI thread combines the newest summaries into the peak
+ * and RMS over a window of its choosing.
+ *
+ * A tap costs a few floats per channel and block, so a mixer-style UI can meter dozens of points.
+ */
+class LevelTap {
+public:
+    struct Level {
+        float peak = 0.0f;
+        float rms = 0.0f;
+    };
+
+    /**
+     * @param num_channels channels of the blocks pushed
+     * @param history_blocks block summaries kept; bounds how long a window readLevels() can cover
+     */
+    explicit LevelTap(uint32_t num_channels, uint32_t history_blocks = 256)
+        : num_channels_(num_channels),
+          summaries_(2 * num_channels + 1, history_blocks),
+          scratch_(static_cast<size_t>(summaries_.getNumChannels()) * summaries_.getCapacity()),
+          scratch_ptrs_(summaries_.getNumChannels()) {
+        for (uint32_t i = 0; i < summaries_.getNumChannels(); ++i) {
+            scratch_ptrs_[i] = scratch_.data() + static_cast<size_t>(i) * summaries_.getCapacity();
+        }
+    }
+
+    /** Audio thread: summarizes one block. Extra channels in block are ignored, missing ones count as silent. */
+    template <typename S, std::size_t MaxChannels>
+    void push(const BufferView<S, MaxChannels>& block) noexcept {
+        static_assert(!BufferView<S, MaxChannels>::is_simd, "LevelTap meters scalar buffers");
+        ASSERT(num_channels_ <= MaxChannels, "LevelTap has more channels than the BufferView can hold");
+        if (num_channels_ > MaxChannels) return;
+
+        // Summary frame: peaks, then mean squares, then the block's length to weight it by
+        std::array<float, 2 * MaxChannels + 1> summary{};
+        std::array<const float*, 2 * MaxChannels + 1> channels{};
+        const uint32_t active = std::min<uint32_t>(num_channels_, static_cast<uint32_t>(block.numChannels()));
+        for (uint32_t ch = 0; ch < active; ++ch) {
+            const auto levels = block.getLevels(ch);
+            summary[ch] = static_cast<float>(levels.peak);
+            summary[num_channels_ + ch] = static_cast<float>(levels.rms * levels.rms);
+        }
+        summary[2 * num_channels_] = static_cast<float>(block.numFrames());
+        for (uint32_t i = 0; i <= 2 * num_channels_; ++i) channels[i] = &summary[i];
+        summaries_.push(channels.data(), 1);
+    }
+
+    /**
+     * UI thread: the peak and RMS per channel over the newest blocks covering at least window_frames frames (or all
+     * kept blocks, if fewer). levels needs getNumChannels() entries. Returns the frames the window covers, 0 before
+     * the first block.
+     */
+    uint64_t readLevels(std::span<Level> levels, uint32_t window_frames) {
+        ASSERT(levels.size() >= num_channels_, "LevelTap::readLevels needs one Level per channel");
+        const uint32_t available = summaries_.readLatest(scratch_ptrs_.data(), summaries_.getCapacity());
+
+        const float* frames = scratch_ptrs_[2 * num_channels_];
+        uint64_t covered = 0;
+        uint32_t first = available;
+        while (first > 0 && covered < window_frames) covered += static_cast<uint64_t>(frames[--first]);
+
+        for (uint32_t ch = 0; ch < num_channels_; ++ch) {
+            const float* peaks = scratch_ptrs_[ch];
+            const float* mean_squares = scratch_ptrs_[num_channels_ + ch];
+            float peak = 0.0f;
+            double energy = 0.0;
+            for (uint32_t i = first; i < available; ++i) {
+                peak = std::max(peak, peaks[i]);
+                energy += static_cast<double>(mean_squares[i]) * frames[i];
+            }
+            levels[ch].peak = peak;
+            levels[ch].rms = covered > 0 ? static_cast<float>(std::sqrt(energy / static_cast<double>(covered))) : 0.0f;
+        }
+        return covered;
+    }
+
+    /** Blocks pushed so far; lets the UI skip work when nothing new arrived. */
+    [[nodiscard]] uint64_t getBlockCount() const noexcept { return summaries_.getWritePosition(); }
+
+    [[nodiscard]] uint32_t getNumChannels() const noexcept { return num_channels_; }
+
+private:
+    const uint32_t num_channels_;
+    ScopeBuffer summaries_;
+
+    // Reader only
+    std::vector<float> scratch_;
+    std::vector<float*> scratch_ptrs_;
+};
+
+}  // namespace applause
@@ -0,0 +1,290 @@
+#pragma once
+#include <clap/events.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace applause {
+
+/** How MidiDecoder interprets channel messages. */
+struct MidiDecoderConfig {
+    /** Semitones of a full pitch bend outside MPE. */
+    double pitch_bend_range = 2.0;
+
+    /**
+     * Treat channels as MPE member channels: channel pressure, pitch bend and CC 74 on a member channel shape the
+     * note playing on it. The same messages on the master channel combine with every channel's own: pitch bends
+     * add, master pressure adds to the member's (up to 1) and master CC 74 offsets it from its centre. Other
+     * messages on the master channel apply to every channel.
+     */
+    bool mpe = false;
+
+    /** Semitones of a full pitch bend on MPE member channels and of MIDI 2.0 per-note pitch bend. */
+    double mpe_pitch_bend_range = 48.0;
+
+    /** The MPE master channel: 0 for the lower zone, 15 for the upper one. */
+    int16_t mpe_master_channel = 0;
+};
+
+/**
+ * Translates raw MIDI (CLAP_EVENT_MIDI) and MIDI 2.0 (CLAP_EVENT_MIDI2) events into CLAP note events, so code
+ * written against the CLAP note model, such as Synthesizer, plays hosts that deliver MIDI as well.
+ *
+ * decode() builds the equivalent CLAP event on the stack and hands it straight to a callback; nothing is queued
+ * or allocated, so decoding fits inline into the pass that consumes the block's events. The only state kept is
+ * each channel's last MPE pitch bend, pressure and CC 74, to combine them with the master channel's. The
+ * translation:
+ *
+ * - Note on and off become CLAP_EVENT_NOTE_ON and CLAP_EVENT_NOTE_OFF (a MIDI 1.0 note on with velocity 0 is a
+ *   note off), All Notes Off (CC 123) a note off and All Sound Off (CC 120) a choke for every key on the channel.
+ * - Pitch bend, channel and poly pressure, CC 11 and CC 74 become note expressions (tuning, pressure, expression,
+ *   brightness) on the matching notes: every note on the channel, or just the key for poly pressure. With
+ *   MidiDecoderConfig::mpe that's the note on a member channel, and all notes for the master channel; see
+ *   MidiDecoderConfig::mpe for how the two combine.
+ * - MIDI 2.0 also has per-note pitch bend and the registered per-note controllers for pitch (7.25), pan and
+ *   timbre; UMP-wrapped MIDI 1.0 channel voice messages are decoded like CLAP_EVENT_MIDI.
+ *
+ * SysEx and anything else without a counterpart in the CLAP note model (program changes, most CCs) is ignored.
+ * Notes from MIDI have no note_id (-1), so later messages address them by port, channel and key.
+ */
+class MidiDecoder {
+public:
+    explicit MidiDecoder(MidiDecoderConfig config = {}) noexcept : config_(config) {}
+
+    /** Replaces the config and forgets the channels' MPE expressions. */
+    void setConfig(const MidiDecoderConfig& config) noexcept {
+        config_ = config;
+        reset();
+    }
+
+    /** Forgets the channels' MPE expressions, e.g. from clap_plugin::reset(). */
+    void reset() noexcept {
+        channels_.fill({});
+        master_ = {};
+    }
+
+    [[nodiscard]] const MidiDecoderConfig& getConfig() const noexcept { return config_; }
+
+    /** Whether the event is a MIDI message of any format. */
+    [[nodiscard]] static bool isMidi(const clap_event_header_t& event) noexcept {
+        return event.space_id == CLAP_CORE_EVENT_SPACE_ID &&
+               (event.type == CLAP_EVENT_MIDI || event.type == CLAP_EVENT_MIDI2 || event.type == CLAP_EVENT_MIDI_SYSEX);
+    }
+
+    /** Whether the event is a MIDI note on that starts a note (velocity above 0 for MIDI 1.0). */
+    [[nodiscard]] static bool isNoteOn(const clap_event_header_t& event) noexcept {
+        if (event.space_id != CLAP_CORE_EVENT_SPACE_ID) return false;
+        if (event.type == CLAP_EVENT_MIDI) {
+            const auto& midi = reinterpret_cast<const clap_event_midi_t&>(event);
+            return (midi.data[0] & 0xF0) == 0x90 && midi.data[2] > 0;
+        }
+        if (event.type == CLAP_EVENT_MIDI2) {
+            const uint32_t word = reinterpret_cast<const clap_event_midi2_t&>(event).data[0];
+            const uint32_t type = word >> 28;
+            if (type == 0x4) return ((word >> 20) & 0xF) == 0x9;
+            if (type == 0x2) return ((word >> 20) & 0xF) == 0x9 && (word & 0x7F) > 0;
+        }
+        return false;
+    }
+
+    /**
+     * Translates event, if it is a MIDI message with a CLAP counterpart, and calls f(const clap_event_header_t&)
+     * with the translated event, which carries the original's time and port. The event passed to f only lives
+     * for the call; an MPE master channel message calls f once per channel. Returns whether f was called.
+     */
+    template <typename F>
+    bool decode(const clap_event_header_t& event, F&& f) {
+        if (event.space_id != CLAP_CORE_EVENT_SPACE_ID) return false;
+        if (event.type == CLAP_EVENT_MIDI) {
+            const auto& midi = reinterpret_cast<const clap_event_midi_t&>(event);
+            return decodeMidi1(event.time, static_cast<int16_t>(midi.port_index), midi.data[0], midi.data[1] & 0x7F,
+                               midi.data[2] & 0x7F, f);
+        }
+        if (event.type == CLAP_EVENT_MIDI2) {
+            const auto& midi = reinterpret_cast<const clap_event_midi2_t&>(event);
+            return decodeUmp(event.time, static_cast<int16_t>(midi.port_index), midi.data[0], midi.data[1], f);
+        }
+        return false;
+    }
+
+private:
+    static constexpr double kMidi2Max = 4294967295.0;
+
+    template <typename F>
+    bool decodeMidi1(uint32_t time, int16_t port, uint8_t status, uint8_t data1, uint8_t data2, F& f) {
+        const auto channel = static_cast<int16_t>(status & 0x0F);
+        switch (status & 0xF0) {
+            case 0x90:
+                return note(data2 > 0 ? CLAP_EVENT_NOTE_ON : CLAP_EVENT_NOTE_OFF, time, port, channel, data1,
+                            data2 / 127.0, f);
+            case 0x80:
+                return note(CLAP_EVENT_NOTE_OFF, time, port, channel, data1, data2 / 127.0, f);
+            case 0xA0:
+                return expression(CLAP_NOTE_EXPRESSION_PRESSURE, time, port, channel, data1, data2 / 127.0, f);
+            case 0xD0:
+                return expression(CLAP_NOTE_EXPRESSION_PRESSURE, time, port, channel, -1, data1 / 127.0, f);
+            case 0xE0: {
+                const double bend = ((data2 << 7 | data1) - 8192) / 8192.0;
+                return expression(CLAP_NOTE_EXPRESSION_TUNING, time, port, channel, -1, bend * bendRange(channel), f);
+            }
+            case 0xB0:
+                return controlChange(time, port, channel, data1, data2 / 127.0, f);
+            default:
+                return false;
+        }
+    }
+
+    template <typename F>
+    bool decodeUmp(uint32_t time, int16_t port, uint32_t word0, uint32_t word1, F& f) {
+        const uint32_t type = word0 >> 28;
+        if (type == 0x2) {
+            // MIDI 1.0 channel voice message in a 32-bit packet
+            return decodeMidi1(time, port, static_cast<uint8_t>(word0 >> 16), (word0 >> 8) & 0x7F, word0 & 0x7F, f);
+        }
+        if (type != 0x4) return false;
+
+        const auto channel = static_cast<int16_t>((word0 >> 16) & 0xF);
+        const auto index = static_cast<int16_t>((word0 >> 8) & 0x7F);
+        const double value = word1 / kMidi2Max;
+        switch ((word0 >> 20) & 0xF) {
+            case 0x9:
+                return note(CLAP_EVENT_NOTE_ON, time, port, channel, index, (word1 >> 16) / 65535.0, f);
+            case 0x8:
+                return note(CLAP_EVENT_NOTE_OFF, time, port, channel, index, (word1 >> 16) / 65535.0, f);
+            case 0xA:
+                return expression(CLAP_NOTE_EXPRESSION_PRESSURE, time, port, channel, index, value, f);
+            case 0xD:
+                return expression(CLAP_NOTE_EXPRESSION_PRESSURE, time, port, channel, -1, value, f);
+            case 0xE:
+                return expression(CLAP_NOTE_EXPRESSION_TUNING, time, port, channel, -1,
+                                  centered(word1) * bendRange(channel), f);
+            case 0x6:  // Per-note pitch bend
+                return expression(CLAP_NOTE_EXPRESSION_TUNING, time, port, channel, index,
+                                  centered(word1) * config_.mpe_pitch_bend_range, f);
+            case 0x0:  // Registered per-note controller
+                switch (word0 & 0xFF) {
+                    case 3:  // Pitch 7.25: the absolute pitch in semitones
+                        return expression(CLAP_NOTE_EXPRESSION_TUNING, time, port, channel, index,
+                                          word1 / 33554432.0 - index, f);
+                    case 10:
+                        return expression(CLAP_NOTE_EXPRESSION_PAN, time, port, channel, index, value, f);
+                    case 74:
+                        return expression(CLAP_NOTE_EXPRESSION_BRIGHTNESS, time, port, channel, index, value, f);
+                    default:
+                        return false;
+                }
+            case 0xB:
+                return controlChange(time, port, channel, index, value, f);
+            default:
+                return false;
+        }
+    }
+
+    template <typename F>
+    bool controlChange(uint32_t time, int16_t port, int16_t channel, int16_t controller, double value, F& f) {
+        switch (controller) {
+            case 11:
+                return expression(CLAP_NOTE_EXPRESSION_EXPRESSION, time, port, channel, -1, value, f);
+            case 74:
+                return expression(CLAP_NOTE_EXPRESSION_BRIGHTNESS, time, port, channel, -1, value, f);
+            case 120:
+                return note(CLAP_EVENT_NOTE_CHOKE, time, port, channel, -1, 0.0, f);
+            case 123:
+                return note(CLAP_EVENT_NOTE_OFF, time, port, channel, -1, 0.0, f);
+            default:
+                return false;
+        }
+    }
+
+    [[nodiscard]] static double centered(uint32_t value) noexcept {
+        return (static_cast<double>(value) - 2147483648.0) / 2147483648.0;
+    }
+
+    [[nodiscard]] bool isMasterChannel(int16_t channel) const noexcept {
+        return config_.mpe && channel == config_.mpe_master_channel;
+    }
+
+    [[nodiscard]] double bendRange(int16_t channel) const noexcept {
+        return config_.mpe && !isMasterChannel(channel) ? config_.mpe_pitch_bend_range : config_.pitch_bend_range;
+    }
+
+    template <typename F>
+    bool note(uint16_t type, uint32_t time, int16_t port, int16_t channel, int16_t key, double velocity, F& f) const {
+        clap_event_note_t event{};
+        event.header = {sizeof(event), time, CLAP_CORE_EVENT_SPACE_ID, type, 0};
+        event.note_id = -1;
+        event.port_index = port;
+        event.channel = channel;
+        event.key = key;
+        event.velocity = velocity;
+        f(event.header);
+        return true;
+    }
+
+    // The MPE dimensions of one channel, as last received
+    struct ChannelExpressions {
+        double tuning = 0.0;
+        double pressure = 0.0;
+        double brightness = 0.5;
+    };
+
+    [[nodiscard]] static double* dimension(ChannelExpressions& channel, clap_note_expression id) noexcept {
+        switch (id) {
+            case CLAP_NOTE_EXPRESSION_TUNING: return &channel.tuning;
+            case CLAP_NOTE_EXPRESSION_PRESSURE: return &channel.pressure;
+            case CLAP_NOTE_EXPRESSION_BRIGHTNESS: return &channel.brightness;
+            default: return nullptr;
+        }
+    }
+
+    [[nodiscard]] static double combine(clap_note_expression id, double member, double master) noexcept {
+        switch (id) {
+            case CLAP_NOTE_EXPRESSION_TUNING: return member + master;
+            case CLAP_NOTE_EXPRESSION_PRESSURE: return std::min(member + master, 1.0);
+            default: return std::clamp(member + master - 0.5, 0.0, 1.0);
+        }
+    }
+
+    template <typename F>
+    bool expression(clap_note_expression id, uint32_t time, int16_t port, int16_t channel, int16_t key, double value,
+                    F& f) {
+        // A channel-wide MPE dimension: each channel plays its own value combined with the master channel's
+        double* master = config_.mpe && key == -1 ? dimension(master_, id) : nullptr;
+        if (master != nullptr && isMasterChannel(channel)) {
+            *master = value;
+            for (int16_t c = 0; c < static_cast<int16_t>(channels_.size()); ++c) {
+                emitExpression(id, time, port, c, key, combine(id, *dimension(channels_[c], id), value), f);
+            }
+            return true;
+        }
+        if (master != nullptr) {
+            *dimension(channels_[channel & 0xF], id) = value;
+            emitExpression(id, time, port, channel, key, combine(id, value, *master), f);
+            return true;
+        }
+
+        emitExpression(id, time, port, isMasterChannel(channel) ? int16_t{-1} : channel, key, value, f);
+        return true;
+    }
+
+    template <typename F>
+    static void emitExpression(clap_note_expression id, uint32_t time, int16_t port, int16_t channel, int16_t key,
+                               double value, F& f) {
+        clap_event_note_expression_t event{};
+        event.header = {sizeof(event), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_NOTE_EXPRESSION, 0};
+        event.expression_id = id;
+        event.note_id = -1;
+        event.port_index = port;
+        event.channel = channel;
+        event.key = key;
+        event.value = value;
+        f(event.header);
+    }
+
+    MidiDecoderConfig config_;
+    std::array<ChannelExpressions, 16> channels_{};  // Member channels; the master channel's entry stays neutral
+    ChannelExpressions master_;
+};
+
+}  // namespace applause
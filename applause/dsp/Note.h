@@ -34,9 +34,12 @@ struct Note {
     int16_t channel = 0;  // MIDI channel 0-15
     int16_t key = 0;  // MIDI note number 0-127 (60 = Middle C)
 
+    // Velocities and expressions are stored as float, which is plenty for 0..1 controls and for tuning to well
+    // under a cent, and keeps a Note to 48 bytes; the events' doubles are narrowed as they're applied.
+
     // Immutable velocities. These are directly translated from original MIDI, and never change over a note's lifetime.
-    double note_on_velocity = 0.0;  // 0..1, set at note on
-    double note_off_velocity = 0.0;  // 0..1, set at note off
+    float note_on_velocity = 0.0f;  // 0..1, set at note on
+    float note_off_velocity = 0.0f;  // 0..1, set at note off
 
     // The CLAP spec defines several note expressions, which can change during the lifetime of a note.
     // Some of these are similar to MPE expressions, and map neatly to those parameters.
@@ -45,30 +48,30 @@ struct Note {
 
     // Each CLAP note has a volume that can be updated while a note is active (unlike velocity)
     // 0 < volume <= 4 (1.0 = unity, 2.0 = +6dB, logarithmic)
-    double volume = 1.0;
+    float volume = 1.0f;
 
     // 0..1 (0=left, 0.5=center, 1=right)
-    double pan = 0.5;
+    float pan = 0.5f;
 
     // -120...+120 semitones relative to key
     // This changes when the tuning is modulated, either via A MPE "slide" or through a MIDI 1.0 pitch bend wheel event.
     // In the latter case, a "wildcard" message is sent from the host to Applause, indicating that all notes
     // should be tuned by the same amount. Meanwhile, MPE notes will be tuned individually.
-    double tuning = 0.0;
+    float tuning = 0.0f;
 
     // 0..1
-    double vibrato = 0.0;
+    float vibrato = 0.0f;
 
     // 0..1 (like MIDI CC 11)
     // Old school expression, not used by MPE (despite the name), but it's part of the CLAP note spec
     // Often used to shape amplitude via a foot pedal or something similar.
-    double expression = 0.0;
+    float expression = 0.0f;
 
     // 0..1 (timbre/Y-axis in MPE)
-    double brightness = 0.5;
+    float brightness = 0.5f;
 
     // 0..1 (aftertouch/Z-axis in MPE)
-    double pressure = 0.0;
+    float pressure = 0.0f;
 
     /**
      * Create a Note from a CLAP note on event.
@@ -79,14 +82,14 @@ struct Note {
         note.port_index = event->port_index;
         note.channel = event->channel;
         note.key = event->key;
-        note.note_on_velocity = event->velocity;
+        note.note_on_velocity = static_cast<float>(event->velocity);
         return note;
     }
 
     /**
      * Update the note off velocity from a CLAP note off event.
      */
-    void setNoteOff(const clap_event_note_t* event) { note_off_velocity = event->velocity; }
+    void setNoteOff(const clap_event_note_t* event) { note_off_velocity = static_cast<float>(event->velocity); }
 
     /**
      * Calculate the frequency in Hz, accounting for the base key and tuning expression.
@@ -113,7 +116,8 @@ struct Note {
     /**
      * Apply a CLAP note expression to this note.
      */
-    void applyExpression(Expression expression_id, double value) {
+    void applyExpression(Expression expression_id, double expression_value) {
+        const auto value = static_cast<float>(expression_value);
         switch (expression_id) {
         case Expression::Volume:
             volume = value;
@@ -147,7 +151,7 @@ struct Note {
      * CLAP volume is linear amplitude where 1.0 = unity.
      */
     double getVolumeDb() const {
-        if (volume <= 0.0) return -100.0;  // Effectively -infinity
+        if (volume <= 0.0f) return -100.0;  // Effectively -infinity
         return 20.0 * std::log10(volume);
     }
 };
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
+#include <applause/util/SampleType.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * @brief 2x, 4x or 8x oversampling around a nonlinear stage, e.g. a hard-driven filter or a waveshaper.
+ *
+ * Each factor of two is a polyphase half-band FIR stage: upsampling filters the two output phases of every input
+ * sample separately (one of them is a pure delay, since every other half-band tap is zero), and downsampling splits
+ * its input into even and odd phases the same way, so nothing is computed for the samples a plain FIR would discard.
+ * The symmetric taps are folded, and each stage's FIR evaluates kLanes output samples at once with xsimd.
+ *
+ * The first stage, which sits right against the audio band, uses 63 taps; the later stages only have to reject
+ * images far above it and use 23. Both are Kaiser-windowed for about 80 dB of stopband rejection.
+ *
+ * All buffers, including the filter state, are carved from a MemoryArena in activate(); nothing is allocated while
+ * processing. The round trip delays the signal by getLatency() samples at the base rate, which the plugin reports
+ * through LatencyExtension (and compensates in any dry path it mixes back in).
+ *
+ * @code
+ * // activate()
+ * arena_.clear();
+ * oversampler_.activate(arena_, 2, info.max_frame_size);
+ * latency_.setLatency(oversampler_.getLatency());
+ *
+ * // process()
+ * oversampler_.process(buffer, [&](BufferView<float, 2> oversampled) { shaper_.process(oversampled); });
+ * @endcode
+ *
+ * @tparam S The scalar sample type (float or double)
+ * @tparam MaxChannels The number of channels the oversampler can be activated with
+ */
+template <Scalar S = float, size_t MaxChannels = 2>
+class Oversampler {
+public:
+    using Batch = xsimd::batch<S>;
+    static constexpr size_t kLanes = Batch::size;
+    static constexpr size_t kMaxFactor = 8;
+
+    /** @param factor 1 (a pass-through), 2, 4 or 8 */
+    explicit Oversampler(size_t factor = 2) {
+        setFactor(factor);
+        for (size_t s = 0; s < kMaxStages; ++s) stages_[s].design(stageHalfLength(s));
+    }
+
+    /** Changes the factor; takes effect at the next activate(). */
+    void setFactor(size_t factor) {
+        ASSERT(factor == 1 || factor == 2 || factor == 4 || factor == 8, "Oversampler: factor must be 1, 2, 4 or 8");
+        factor_ = factor;
+    }
+
+    /** Arena bytes activate() needs for these settings, including alignment padding. */
+    [[nodiscard]] static constexpr size_t requiredArenaBytes(size_t factor, size_t num_channels, size_t max_frames) {
+        constexpr size_t line = defaultByteAlignment;
+        size_t bytes = line - 1;
+        const auto add = [&bytes](size_t n) { bytes += (n * sizeof(S) + line - 1) / line * line; };
+        add(num_channels * max_frames * factor);      // Oversampled buffer
+        add(num_channels * max_frames * factor / 2);  // Intermediate rates, ping-ponged with the oversampled buffer
+        add(max_frames * factor / 2);                 // Even output phase of an upsampling stage
+        for (size_t s = 0; s < numStages(factor); ++s) {
+            const size_t half_length = stageHalfLength(s);
+            const size_t frames = max_frames << s;
+            for (size_t ch = 0; ch < num_channels; ++ch) {
+                add(2 * half_length - 1 + frames);  // Upsampler input
+                add(2 * half_length - 1 + frames);  // Downsampler even phase
+                add(half_length + frames);          // Downsampler odd phase
+            }
+        }
+        return bytes;
+    }
+
+    /**
+     * Carves the buffers for num_channels channels of up to max_frames base-rate frames from arena and clears the
+     * filter state. The arena must have requiredArenaBytes() free and outlive the oversampler's use.
+     */
+    void activate(MemoryArena& arena, size_t num_channels, size_t max_frames) {
+        ASSERT(num_channels <= MaxChannels, "Oversampler: too many channels");
+        num_channels_ = num_channels;
+        max_frames_ = max_frames;
+        num_stages_ = numStages(factor_);
+
+        const auto carve = [&arena](size_t n) {
+            S* data = arena.allocate<S>(n, defaultByteAlignment);
+            ASSERT(data != nullptr, "Arena too small for Oversampler buffers; see requiredArenaBytes()");
+            return data;
+        };
+        S* oversampled = carve(num_channels * max_frames * factor_);
+        S* intermediate = carve(num_channels * max_frames * factor_ / 2);
+        even_scratch_ = carve(max_frames * factor_ / 2);
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+            oversampled_[ch] = oversampled + ch * max_frames * factor_;
+            intermediate_[ch] = intermediate + ch * max_frames * factor_ / 2;
+        }
+        for (size_t s = 0; s < num_stages_; ++s) {
+            Stage& stage = stages_[s];
+            const size_t frames = max_frames << s;
+            for (size_t ch = 0; ch < num_channels; ++ch) {
+                stage.up[ch] = carve(stage.history() + frames);
+                stage.down_even[ch] = carve(stage.history() + frames);
+                stage.down_odd[ch] = carve(stage.half_length + frames);
+            }
+            stage.max_frames = frames;
+        }
+        reset();
+    }
+
+    /** Clears the filter state, e.g. on a transport jump. */
+    void reset() {
+        for (size_t s = 0; s < num_stages_; ++s) {
+            Stage& stage = stages_[s];
+            const size_t frames = stage.max_frames;
+            for (size_t ch = 0; ch < num_channels_; ++ch) {
+                std::fill_n(stage.up[ch], stage.history() + frames, S(0));
+                std::fill_n(stage.down_even[ch], stage.history() + frames, S(0));
+                std::fill_n(stage.down_odd[ch], stage.half_length + frames, S(0));
+            }
+        }
+    }
+
+    [[nodiscard]] size_t getFactor() const noexcept { return factor_; }
+
+    /** The round-trip delay of upsample() and downsample() in base-rate samples, rounded to the nearest sample. */
+    [[nodiscard]] uint32_t getLatency() const noexcept { return static_cast<uint32_t>(std::lround(getExactLatency())); }
+
+    /**
+     * The delay of downsample() alone, in base-rate samples: half the round trip, for a source that renders at the
+     * oversampled rate itself into oversampledBuffer().
+     */
+    [[nodiscard]] uint32_t getDownsampleLatency() const noexcept {
+        return static_cast<uint32_t>(std::lround(getExactLatency() / 2.0));
+    }
+
+    /** Output that follows the last input: the filters ring for about as long as they delay. */
+    [[nodiscard]] uint32_t getTailSamples() const noexcept {
+        return static_cast<uint32_t>(std::ceil(getExactLatency()));
+    }
+
+    /**
+     * The exact round-trip delay in base-rate samples. Each stage delays by its centre tap both ways, which isn't a
+     * whole number of base-rate samples past the first stage (e.g. 36.5 at 4x).
+     */
+    [[nodiscard]] double getExactLatency() const noexcept {
+        double latency = 0.0;
+        for (size_t s = 0; s < numStages(factor_); ++s) {
+            latency += static_cast<double>(2 * stageHalfLength(s) - 1) / static_cast<double>(size_t(1) << s);
+        }
+        return latency;
+    }
+
+    /**
+     * Upsamples input into the oversampler's own buffer and returns a view of it, getFactor() times as many frames
+     * long. The view stays valid until the next upsample() or downsample().
+     */
+    [[nodiscard]] BufferView<S, MaxChannels> upsample(BufferView<const S, MaxChannels> input) noexcept {
+        ASSERT(input.numChannels() <= num_channels_, "Oversampler: more channels than activated");
+        ASSERT(input.numFrames() <= max_frames_, "Oversampler: block longer than activated");
+        const size_t num_frames = input.numFrames();
+        for (size_t ch = 0; ch < input.numChannels(); ++ch) {
+            const S* src = input.channelSamples(ch);
+            if (num_stages_ == 0) std::copy_n(src, num_frames, oversampled_[ch]);
+            for (size_t s = 0; s < num_stages_; ++s) {
+                S* dst = level(s + 1, ch);
+                stages_[s].upsample(ch, src, dst, num_frames << s, even_scratch_);
+                src = dst;
+            }
+        }
+        return {oversampled_.data(), input.numChannels(), num_frames * factor_};
+    }
+
+    /**
+     * The oversampled buffer for num_frames base-rate frames (getFactor() times as many oversampled ones), for a
+     * source that renders at the oversampled rate instead of going through upsample(), e.g. Synthesizer voices. Fill
+     * it, then downsample(). The view stays valid until the next upsample() or downsample().
+     */
+    [[nodiscard]] BufferView<S, MaxChannels> oversampledBuffer(size_t num_channels, size_t num_frames) noexcept {
+        ASSERT(num_channels <= num_channels_, "Oversampler: more channels than activated");
+        ASSERT(num_frames <= max_frames_, "Oversampler: block longer than activated");
+        return {oversampled_.data(), num_channels, num_frames * factor_};
+    }
+
+    /** Filters the oversampled buffer back down into output, reading getFactor() frames per output frame. */
+    void downsample(BufferView<S, MaxChannels> output) noexcept {
+        ASSERT(output.numChannels() <= num_channels_, "Oversampler: more channels than activated");
+        ASSERT(output.numFrames() <= max_frames_, "Oversampler: block longer than activated");
+        const size_t num_frames = output.numFrames();
+        for (size_t ch = 0; ch < output.numChannels(); ++ch) {
+            S* out = output.channelSamples(ch);
+            if (num_stages_ == 0) std::copy_n(oversampled_[ch], num_frames, out);
+            for (size_t s = num_stages_; s-- > 0;) {
+                S* dst = s == 0 ? out : level(s, ch);
+                stages_[s].downsample(ch, level(s + 1, ch), dst, num_frames << s);
+            }
+        }
+    }
+
+    /** Upsamples buffer, runs fn on the oversampled view, and downsamples the result back into buffer. */
+    template <typename Fn>
+        requires std::invocable<Fn&, BufferView<S, MaxChannels>>
+    void process(BufferView<S, MaxChannels> buffer, Fn&& fn) {
+        fn(upsample(buffer));
+        downsample(buffer);
+    }
+
+private:
+    static constexpr size_t kMaxStages = 3;
+    static constexpr size_t kMaxHalfLength = 16;
+
+    [[nodiscard]] static constexpr size_t numStages(size_t factor) noexcept {
+        return factor >= 8 ? 3 : factor >= 4 ? 2 : factor >= 2 ? 1 : 0;
+    }
+
+    // Nonzero off-centre taps on each side of a stage's centre; the filter is 4 * half_length - 1 taps long
+    [[nodiscard]] static constexpr size_t stageHalfLength(size_t stage) noexcept {
+        return stage == 0 ? kMaxHalfLength : 6;
+    }
+
+    // The buffer holding channel ch at rate 2^rate_level. Adjacent levels alternate, so no stage overwrites its input.
+    [[nodiscard]] S* level(size_t rate_level, size_t ch) const noexcept {
+        return (num_stages_ - rate_level) % 2 == 0 ? oversampled_[ch] : intermediate_[ch];
+    }
+
+    /**
+     * One half-band stage. Its taps are 0.5 at the centre, zero at every even offset from it, and taps[j] at offsets
+     * +-(2j + 1). Each work buffer holds history() samples of history followed by the block being processed.
+     */
+    struct Stage {
+        std::array<S, kMaxHalfLength> taps{};
+        size_t half_length = 0;
+        size_t max_frames = 0;
+        std::array<S*, MaxChannels> up{};
+        std::array<S*, MaxChannels> down_even{};
+        std::array<S*, MaxChannels> down_odd{};
+
+        [[nodiscard]] size_t history() const noexcept { return 2 * half_length - 1; }
+
+        // Kaiser-windowed sinc at a quarter of the output rate, normalized to unity gain at DC
+        void design(size_t length) {
+            ASSERT(length <= kMaxHalfLength, "Oversampler: half-band stage too long");
+            half_length = length;
+            constexpr double beta = 7.857;  // ~80 dB stopband
+            const auto bessel_i0 = [](double x) {
+                double sum = 1.0, term = 1.0;
+                for (int k = 1; k < 32; ++k) {
+                    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                    sum += term;
+                }
+                return sum;
+            };
+            const auto edge = static_cast<double>(2 * length);
+            double sum = 0.0;
+            std::array<double, kMaxHalfLength> h{};
+            for (size_t j = 0; j < length; ++j) {
+                const auto offset = static_cast<double>(2 * j + 1);
+                const double ratio = offset / edge;
+                const double window = bessel_i0(beta * std::sqrt(1.0 - ratio * ratio)) / bessel_i0(beta);
+                h[j] = std::sin(std::numbers::pi * offset / 2.0) / (std::numbers::pi * offset) * window;
+                sum += h[j];
+            }
+            // The centre tap is 0.5 and the off-centre taps come in pairs, so they must sum to 0.25
+            for (size_t j = 0; j < length; ++j) taps[j] = static_cast<S>(h[j] * 0.25 / sum);
+        }
+
+        // sum_j taps[j] * scale * (base[i + 1 + j] + base[i - j]), for kLanes consecutive i when V is a batch
+        template <typename V>
+        [[nodiscard]] V foldedFir(const S* base, size_t i, S scale) const noexcept {
+            const auto load = [](const S* p) {
+                if constexpr (std::same_as<V, S>) return *p;
+                else return V::load_unaligned(p);
+            };
+            V acc(S(0));
+            for (size_t j = 0; j < half_length; ++j) {
+                acc = applause::fma(V(taps[j] * scale), load(base + i + 1 + j) + load(base + i - j), acc);
+            }
+            return acc;
+        }
+
+        // in: num_frames samples; out: 2 * num_frames samples
+        void upsample(size_t ch, const S* in, S* out, size_t num_frames, S* even) noexcept {
+            if (num_frames == 0) return;
+            S* work = up[ch];
+            const size_t hist = history();
+            std::copy_n(in, num_frames, work + hist);
+
+            // Output 2i is the filtered even phase (taps doubled for the zero-stuffing); 2i + 1 is the centre tap
+            const S* base = work + hist - half_length;
+            size_t i = 0;
+            for (; i + kLanes <= num_frames; i += kLanes) {
+                foldedFir<Batch>(base, i, S(2)).store_unaligned(even + i);
+            }
+            for (; i < num_frames; ++i) even[i] = foldedFir<S>(base, i, S(2));
+            for (i = 0; i < num_frames; ++i) {
+                out[2 * i] = even[i];
+                out[2 * i + 1] = base[i + 1];
+            }
+            std::copy(work + num_frames, work + num_frames + hist, work);
+        }
+
+        // in: 2 * num_frames samples; out: num_frames samples
+        void downsample(size_t ch, const S* in, S* out, size_t num_frames) noexcept {
+            if (num_frames == 0) return;
+            S* even = down_even[ch];
+            S* odd = down_odd[ch];
+            const size_t hist = history();
+            for (size_t i = 0; i < num_frames; ++i) {
+                even[hist + i] = in[2 * i];
+                odd[half_length + i] = in[2 * i + 1];
+            }
+
+            // Even phase through the off-centre taps, odd phase through the centre tap
+            const S* base = even + hist - half_length;
+            size_t i = 0;
+            for (; i + kLanes <= num_frames; i += kLanes) {
+                const Batch centre = Batch::load_unaligned(odd + i) * Batch(S(0.5));
+                (foldedFir<Batch>(base, i, S(1)) + centre).store_unaligned(out + i);
+            }
+            for (; i < num_frames; ++i) out[i] = foldedFir<S>(base, i, S(1)) + S(0.5) * odd[i];
+            std::copy(even + num_frames, even + num_frames + hist, even);
+            std::copy(odd + num_frames, odd + num_frames + half_length, odd);
+        }
+    };
+
+    std::array<Stage, kMaxStages> stages_{};
+    std::array<S*, MaxChannels> oversampled_{};
+    std::array<S*, MaxChannels> intermediate_{};
+    S* even_scratch_ = nullptr;
+    size_t factor_ = 2;
+    size_t num_stages_ = 0;
+    size_t num_channels_ = 0;
+    size_t max_frames_ = 0;
+};
+
+}  // namespace applause
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/FastMath.h>
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/** One SplitMix64 step: advances state and returns the next well-mixed 64-bit value. Seeds the generators below. */
+inline uint64_t splitMix64(uint64_t& state) noexcept {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief xoshiro128+ run in every lane of a SIMD batch: kLanes independent generators stepped by one xorshift pass.
+ *
+ * Each lane is seeded from SplitMix64 over (seed, stream), so the same pair always gives the same numbers and
+ * different streams (voices, channels) don't overlap in practice. Only the top 24 bits of an output are used for
+ * floats, which sidesteps xoshiro128+'s weak low bits.
+ */
+class XoshiroBatch {
+public:
+    using Batch = xsimd::batch<float>;
+    using Bits = xsimd::batch<uint32_t>;
+    static constexpr size_t kLanes = Batch::size;
+
+    explicit XoshiroBatch(uint64_t seed = 1, uint64_t stream = 0) noexcept { reseed(seed, stream); }
+
+    void reseed(uint64_t seed, uint64_t stream = 0) noexcept {
+        uint64_t state = seed ^ (0xD1B54A32D192ED03ull * (stream + 1));
+        std::array<std::array<uint32_t, kLanes>, 4> words{};
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            for (size_t w = 0; w < 4; w += 2) {
+                const uint64_t value = splitMix64(state);
+                words[w][lane] = static_cast<uint32_t>(value);
+                words[w + 1][lane] = static_cast<uint32_t>(value >> 32);
+            }
+            // xoshiro's one forbidden state
+            if ((words[0][lane] | words[1][lane] | words[2][lane] | words[3][lane]) == 0) words[0][lane] = 1;
+        }
+        for (size_t w = 0; w < 4; ++w) s_[w] = Bits::load_unaligned(words[w].data());
+    }
+
+    /** 32 random bits per lane. */
+    Bits next() noexcept {
+        const Bits result = s_[0] + s_[3];
+        const Bits t = s_[1] << 9;
+        s_[2] = s_[2] ^ s_[0];
+        s_[3] = s_[3] ^ s_[1];
+        s_[1] = s_[1] ^ s_[2];
+        s_[0] = s_[0] ^ s_[3];
+        s_[2] = s_[2] ^ t;
+        s_[3] = (s_[3] << 11) | (s_[3] >> 21);
+        return result;
+    }
+
+    /** Uniform in [0, 1), in steps of 2^-24. */
+    Batch uniform() noexcept { return top24() * Batch(0x1.0p-24f); }
+
+    /** Uniform in [-1, 1), in steps of 2^-23. */
+    Batch bipolar() noexcept { return top24() * Batch(0x1.0p-23f) - Batch(1.0f); }
+
+private:
+    Batch top24() noexcept { return xsimd::batch_cast<float>(xsimd::bitwise_cast<int32_t>(next() >> 8)); }
+
+    std::array<Bits, 4> s_;
+};
+
+/**
+ * @brief Block noise for oscillators, exciters and dither: fills BufferView blocks with uniform, gaussian or pink
+ * noise, kLanes values per generator step.
+ *
+ * Every channel has its own stream, seeded from (seed, first_stream + channel), so two generators built with the
+ * same arguments produce the same noise, and per-voice generators stay independent when each gets its own
+ * first_stream. A stream hands out its values in order whatever the block sizes: a partly used step is kept for
+ * the next call, so splitting a block doesn't change the noise.
+ *
+ * Scalar buffers (float or double) take consecutive values in time, one SIMD step every kLanes frames. Buffers of
+ * xsimd::batch<float> samples are one voice per lane, as in WavetableOscillator: each frame is one step, and lane l
+ * of every frame follows generator lane l, an independent stream of its own.
+ *
+ * @code
+ * NoiseGenerator breath_{1, seed, voice_index};  // One stream for this voice
+ * breath_.fillGaussian(scratch, 0.1f);
+ * @endcode
+ *
+ * Construction allocates; reseed() and the fills don't.
+ */
+class NoiseGenerator {
+public:
+    using Batch = XoshiroBatch::Batch;
+    static constexpr size_t kLanes = XoshiroBatch::kLanes;
+
+    explicit NoiseGenerator(uint32_t num_channels = 2, uint64_t seed = 1, uint64_t first_stream = 0)
+        : streams_(num_channels), seed_(seed), first_stream_(first_stream) {
+        reseed(seed);
+    }
+
+    /** Restarts every channel's stream from seed, and clears the pink filters. */
+    void reseed(uint64_t seed) noexcept {
+        seed_ = seed;
+        for (size_t ch = 0; ch < streams_.size(); ++ch) {
+            Stream& stream = streams_[ch];
+            stream.rng.reseed(seed, first_stream_ + ch);
+            stream.spare_kind = Kind::None;
+            stream.spare_pos = stream.spare_end = 0;
+            stream.pink.fill(0.0f);
+            stream.pink_lanes.fill(Batch(0.0f));
+        }
+    }
+
+    /** Restarts from the current seed, e.g. on reset(), so a render repeats exactly. */
+    void reset() noexcept { reseed(seed_); }
+
+    [[nodiscard]] uint64_t getSeed() const noexcept { return seed_; }
+    [[nodiscard]] uint32_t getNumChannels() const noexcept { return static_cast<uint32_t>(streams_.size()); }
+
+    /** Uniform white noise in [-amplitude, amplitude). */
+    template <typename S, std::size_t MaxChannels>
+    void fillUniform(BufferView<S, MaxChannels>& out, float amplitude = 1.0f) noexcept {
+        fill(out, Kind::Uniform, amplitude);
+    }
+
+    /** Gaussian white noise with standard deviation sigma, by Box-Muller; values stay within about 5.8 sigma. */
+    template <typename S, std::size_t MaxChannels>
+    void fillGaussian(BufferView<S, MaxChannels>& out, float sigma = 1.0f) noexcept {
+        fill(out, Kind::Gaussian, sigma);
+    }
+
+    /**
+     * Pink (-3 dB/octave) noise: the uniform stream through Paul Kellet's three-pole economy filter, scaled to the
+     * RMS of uniform noise of the same amplitude. The filter runs once per frame (per lane, for batch samples), so
+     * this one is vectorized across voices rather than across time.
+     */
+    template <typename S, std::size_t MaxChannels>
+    void fillPink(BufferView<S, MaxChannels>& out, float amplitude = 1.0f) noexcept {
+        using Value = std::remove_const_t<S>;
+        static_assert(!SimdBatch<Value> || std::same_as<Value, Batch>, "NoiseGenerator fills float batches");
+        constexpr size_t width = SimdBatch<Value> ? kLanes : 1;
+        constexpr uint32_t kChunk = 64;
+        const size_t channels = checkedChannels(out);
+        const float gain = amplitude * kPinkGain;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            Stream& stream = streams_[ch];
+            S* samples = out.channelSamples(ch);
+            alignas(Batch) std::array<float, kChunk * width> white;
+            for (uint32_t first = 0; first < out.numFrames(); first += kChunk) {
+                const uint32_t count = std::min<uint32_t>(kChunk, static_cast<uint32_t>(out.numFrames()) - first);
+                fillValues(stream, Kind::Uniform, white.data(), count * width, 1.0f);
+                for (uint32_t i = 0; i < count; ++i) {
+                    if constexpr (SimdBatch<Value>) {
+                        samples[first + i] = pinkStep(stream.pink_lanes, Batch::load_aligned(&white[i * kLanes])) *
+                                             Batch(gain);
+                    } else {
+                        samples[first + i] = static_cast<Value>(pinkStep(stream.pink, white[i]) * gain);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    enum class Kind : uint8_t { None, Uniform, Gaussian };
+
+    // Kellet's filter's gain for white noise is sqrt(8.87); this brings pink back to the white input's RMS
+    static constexpr float kPinkGain = 0.33568f;
+
+    struct Stream {
+        XoshiroBatch rng;
+        alignas(Batch) std::array<float, 2 * kLanes> spare{};  // The rest of a partly used step, unscaled
+        Kind spare_kind = Kind::None;
+        uint32_t spare_pos = 0;
+        uint32_t spare_end = 0;
+        std::array<float, 3> pink{};       // Filter state for scalar buffers
+        std::array<Batch, 3> pink_lanes{};  // ... and for batch buffers, per lane
+    };
+
+    template <typename V>
+    static V pinkStep(std::array<V, 3>& b, V white) noexcept {
+        b[0] = V(0.99765f) * b[0] + white * V(0.0990460f);
+        b[1] = V(0.96300f) * b[1] + white * V(0.2965164f);
+        b[2] = V(0.57000f) * b[2] + white * V(1.0526913f);
+        return b[0] + b[1] + b[2] + white * V(0.1848f);
+    }
+
+    template <typename S, std::size_t MaxChannels>
+    size_t checkedChannels(const BufferView<S, MaxChannels>& out) const noexcept {
+        ASSERT(out.numChannels() <= streams_.size(), "NoiseGenerator: more channels than streams");
+        return std::min(out.numChannels(), streams_.size());
+    }
+
+    template <typename S, std::size_t MaxChannels>
+    void fill(BufferView<S, MaxChannels>& out, Kind kind, float scale) noexcept {
+        using Value = std::remove_const_t<S>;
+        static_assert(!SimdBatch<Value> || std::same_as<Value, Batch>, "NoiseGenerator fills float batches");
+        constexpr size_t width = SimdBatch<Value> ? kLanes : 1;
+        const size_t channels = checkedChannels(out);
+        for (size_t ch = 0; ch < channels; ++ch) {
+            // A batch frame is kLanes consecutive values, lane l of each step landing in lane l
+            auto* values = reinterpret_cast<scalar_t<Value>*>(out.channelSamples(ch));
+            fillValues(streams_[ch], kind, values, out.numFrames() * width, scale);
+        }
+    }
+
+    // One generator step, unscaled: one batch of values, or two for Gaussian
+    static uint32_t generate(Stream& stream, Kind kind, std::array<Batch, 2>& step) noexcept {
+        if (kind == Kind::Uniform) {
+            step[0] = stream.rng.bipolar();
+            return 1;
+        }
+        constexpr float kPi = 3.14159265359f;
+        constexpr float kMinusTwoLn2 = -1.38629436112f;
+        // 1 - u keeps the log's argument in (0, 1]
+        const Batch u1 = Batch(1.0f) - stream.rng.uniform();
+        const Batch theta = stream.rng.uniform() * Batch(2.0f * kPi) - Batch(kPi);
+        const Batch radius = xsimd::sqrt(Batch(kMinusTwoLn2) * math::log2(u1));
+        step[0] = radius * math::sin(theta);
+        step[1] = radius * math::sin(theta + Batch(0.5f * kPi));
+        return 2;
+    }
+
+    template <typename T>
+    static void fillValues(Stream& stream, Kind kind, T* out, size_t count, float scale) noexcept {
+        size_t i = 0;
+        const auto takeSpare = [&] {
+            if (stream.spare_kind != kind) return;
+            for (; i < count && stream.spare_pos < stream.spare_end; ++i) {
+                out[i] = static_cast<T>(stream.spare[stream.spare_pos++] * scale);
+            }
+        };
+        takeSpare();
+
+        const size_t step_values = kind == Kind::Gaussian ? 2 * kLanes : kLanes;
+        std::array<Batch, 2> step;
+        for (; i + step_values <= count; i += step_values) {
+            const uint32_t batches = generate(stream, kind, step);
+            for (uint32_t b = 0; b < batches; ++b) {
+                const Batch scaled = step[b] * Batch(scale);
+                if constexpr (std::same_as<T, float>) {
+                    scaled.store_unaligned(out + i + b * kLanes);
+                } else {
+                    alignas(Batch) std::array<float, kLanes> lanes;
+                    scaled.store_aligned(lanes.data());
+                    std::copy(lanes.begin(), lanes.end(), out + i + b * kLanes);
+                }
+            }
+        }
+
+        if (i < count) {
+            const uint32_t batches = generate(stream, kind, step);
+            for (uint32_t b = 0; b < batches; ++b) step[b].store_aligned(stream.spare.data() + b * kLanes);
+            stream.spare_kind = kind;
+            stream.spare_pos = 0;
+            stream.spare_end = static_cast<uint32_t>(batches * kLanes);
+            takeSpare();
+        }
+    }
+
+    std::vector<Stream> streams_;
+    uint64_t seed_;
+    uint64_t first_stream_;
+};
+
+}  // namespace applause
@@ -0,0 +1 @@
+#include "SimdSynthesizer.h"
\ No newline at end of file
@@ -0,0 +1,206 @@
+#pragma once
+#include <applause/dsp/Synthesizer.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+template <Scalar T, size_t MaxChannels>
+class SynthesizerVoiceGroup;
+
+/**
+ * The voice type a SimdSynthesizer allocates notes to. It holds one lane's note and voice state, and forwards
+ * note events to the lane of the group that renders it; it renders nothing itself.
+ */
+template <Scalar T, size_t MaxChannels>
+class SynthesizerVoiceLane : public SynthesizerVoice<T, MaxChannels> {
+public:
+    void process(BufferView<T, MaxChannels>, int, int) override {}
+
+    void noteOn() override { group_->noteOn(lane_); }
+
+    void noteOff(bool terminate_now) override { group_->noteOff(lane_, terminate_now); }
+
+    void onExpressionChange(Note::Expression expression_id, double value) override {
+        group_->onExpressionChange(lane_, expression_id, value);
+    }
+
+private:
+    template <Scalar, size_t, size_t, typename>
+    friend class SimdSynthesizer;
+
+    SynthesizerVoiceGroup<T, MaxChannels>* group_ = nullptr;
+    size_t lane_ = 0;
+};
+
+/**
+ * Renders several voices at once, one voice per SIMD lane: for example, eight sine oscillators in one AVX
+ * register. Extend this instead of SynthesizerVoice for voices whose DSP vectorizes across voices, and keep
+ * per-voice DSP state in lane-wide batches.
+ *
+ * Note events arrive per lane. Each lane's note data and voice state are available through note(lane) and
+ * state(lane), and a lane that has finished releasing calls terminateLane(lane), just as a scalar voice calls
+ * terminateVoice().
+ *
+ * @tparam T The scalar sample type (float or double); lanes are xsimd::batch<T>.
+ * @tparam MaxChannels The maximum number of channels supported by the DSP system
+ */
+template <Scalar T, size_t MaxChannels>
+class SynthesizerVoiceGroup {
+public:
+    using Batch = xsimd::batch<T>;
+    using Lane = SynthesizerVoiceLane<T, MaxChannels>;
+    using State = typename SynthesizerVoice<T, MaxChannels>::State;
+    static constexpr size_t kLanes = Batch::size;
+
+    virtual ~SynthesizerVoiceGroup() = default;
+
+    /**
+     * Renders every lane into buffer, which covers exactly the current sub-block: frames [0, num_samples).
+     * Each frame holds one sample per lane. active_lanes has bit i set for each lane that holds a note; whatever
+     * the other lanes render is discarded, so they can run unmasked through the DSP.
+     */
+    virtual void process(BufferView<Batch, MaxChannels> buffer, uint32_t active_lanes, int num_samples) = 0;
+
+    /** Called when lane starts a new note; note(lane) already holds it. */
+    virtual void noteOn(size_t lane) {}
+
+    /**
+     * Called when lane's note is released, or with terminate_now when the lane is stolen or choked; then the
+     * lane must call terminateLane() before returning.
+     */
+    virtual void noteOff(size_t lane, bool terminate_now) {
+        if (terminate_now) {
+            terminateLane(lane);
+        }
+    }
+
+    /** Called when a note expression changes for lane's note. */
+    virtual void onExpressionChange(size_t lane, Note::Expression expression_id, double value) {}
+
+    /** Releases lane back into the voice pool. Fade its output out first! */
+    void terminateLane(size_t lane) { lanes_[lane]->terminateVoice(); }
+
+    [[nodiscard]] const Note& note(size_t lane) const noexcept { return lanes_[lane]->note_; }
+
+    [[nodiscard]] State state(size_t lane) const noexcept { return lanes_[lane]->getState(); }
+
+    [[nodiscard]] double getSampleRate() const noexcept { return sample_rate_; }
+
+    void setSampleRate(double sample_rate) noexcept { sample_rate_ = sample_rate; }
+
+protected:
+    double sample_rate_ = 44100.0;
+
+private:
+    template <Scalar, size_t, size_t, typename>
+    friend class SimdSynthesizer;
+
+    // Lanes past the synthesizer's last voice stay null and are never active
+    std::array<Lane*, kLanes> lanes_{};
+};
+
+/**
+A Synthesizer whose voices render in SIMD lane groups. Voice i is lane i % kLanes of group i / kLanes; the groups
+are GroupType instances, which must derive from SynthesizerVoiceGroup. Note handling, voice allocation and
+stealing are the Synthesizer's own. Each sub-block, groups with no active lane are skipped, and the others render
+into a lane-wide scratch buffer whose active lanes are then summed into the output. Voices that start or end
+mid-block are handled by the sub-block split at every note event: a lane is active only in the sub-blocks after
+its note-on and up to the one in which it terminates.
+
+The scratch buffer is sized in activate(); sub-blocks longer than its max_frame_size are rendered in several
+slices.
+
+@tparam T The sample type (float or double)
+@tparam MaxChannels Maximum number of audio channels
+@tparam NumVoices Maximum number of polyphonic voices; need not be a multiple of the lane count
+@tparam GroupType The concrete voice group class (must derive from SynthesizerVoiceGroup)
+*/
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename GroupType>
+class SimdSynthesizer : public Synthesizer<T, MaxChannels, NumVoices, SynthesizerVoiceLane<T, MaxChannels>> {
+    static_assert(std::is_base_of_v<SynthesizerVoiceGroup<T, MaxChannels>, GroupType>,
+                  "GroupType must derive from SynthesizerVoiceGroup<T, MaxChannels>");
+
+    using Base = Synthesizer<T, MaxChannels, NumVoices, SynthesizerVoiceLane<T, MaxChannels>>;
+    using Batch = xsimd::batch<T>;
+
+public:
+    static constexpr size_t kLanes = Batch::size;
+    static constexpr size_t kNumGroups = (NumVoices + kLanes - 1) / kLanes;
+    static_assert(kLanes <= 32, "Lane masks are 32 bits wide");
+
+    SimdSynthesizer() {
+        auto voices = this->getVoices();
+        for (size_t v = 0; v < NumVoices; ++v) {
+            auto& group = groups_[v / kLanes];
+            voices[v].group_ = &group;
+            voices[v].lane_ = v % kLanes;
+            group.lanes_[v % kLanes] = &voices[v];
+        }
+    }
+    // Lanes and groups point at each other
+    SimdSynthesizer(const SimdSynthesizer&) = delete;
+    SimdSynthesizer& operator=(const SimdSynthesizer&) = delete;
+
+    void activate(ProcessInfo info) {
+        Base::activate(info);
+        // Groups render at the rate the base class gave its voices, oversampled or not
+        for (auto& group : groups_) {
+            group.setSampleRate(info.sample_rate * static_cast<double>(this->getOversampling()));
+        }
+        scratch_frames_ = info.max_frame_size;
+        scratch_.assign(MaxChannels * scratch_frames_, Batch(T(0)));
+    }
+
+    [[nodiscard]] std::span<GroupType> getGroups() noexcept { return groups_; }
+
+protected:
+    void renderSubBlock(BufferView<T, MaxChannels> buffer, int start_sample, int num_samples) override {
+        ASSERT(scratch_frames_ > 0, "SimdSynthesizer: activate() before processing");
+        if (scratch_frames_ == 0) return;
+
+        const auto status = this->getVoiceStatus();
+        for (size_t g = 0; g < kNumGroups; ++g) {
+            uint32_t active_lanes = 0;
+            alignas(Batch) std::array<T, kLanes> lane_gates{};
+            for (size_t lane = 0; lane < kLanes && g * kLanes + lane < NumVoices; ++lane) {
+                if (status[g * kLanes + lane].active) {
+                    active_lanes |= 1u << lane;
+                    lane_gates[lane] = T(1);
+                }
+            }
+            if (active_lanes == 0) continue;
+            const auto active = Batch::load_aligned(lane_gates.data()) != Batch(T(0));
+
+            for (int offset = 0; offset < num_samples; offset += static_cast<int>(scratch_frames_)) {
+                const auto slice = std::min<size_t>(scratch_frames_, static_cast<size_t>(num_samples - offset));
+                const BufferView<Batch, MaxChannels> lanes(reinterpret_cast<T*>(scratch_.data()),
+                                                           buffer.numChannels(), slice);
+                lanes.clear();
+                groups_[g].process(lanes, active_lanes, static_cast<int>(slice));
+
+                for (size_t ch = 0; ch < buffer.numChannels(); ++ch) {
+                    T* out = buffer.channelSamples(ch);
+                    if (!out) continue;
+                    out += start_sample + offset;
+                    const Batch* in = lanes.channelSamples(ch);
+                    for (size_t i = 0; i < slice; ++i) {
+                        out[i] += xsimd::reduce_add(xsimd::select(active, in[i], Batch(T(0))));
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    std::array<GroupType, kNumGroups> groups_;
+    std::vector<Batch> scratch_;  // MaxChannels planes of scratch_frames_ lane-wide samples
+    size_t scratch_frames_ = 0;
+};
+
+}  // namespace applause
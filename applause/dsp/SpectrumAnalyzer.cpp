@@ -0,0 +1,143 @@
+#include "SpectrumAnalyzer.h"
+
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+
+namespace applause {
+
+SpectrumAnalyzer::SpectrumAnalyzer(ScopeBuffer& source, uint32_t channel, double sample_rate,
+                                   SpectrumAnalyzerConfig config)
+    : source_(source),
+      channel_(channel),
+      sample_rate_(sample_rate / source.getDecimation()),
+      config_(config),
+      fft_(config.fft_size),
+      input_(static_cast<size_t>(source.getNumChannels()) * config.fft_size),
+      input_ptrs_(source.getNumChannels()),
+      window_(config.fft_size),
+      windowed_(config.fft_size),
+      re_(fft_.numBins()),
+      im_(fft_.numBins()),
+      bins_db_(config.num_bins, config.floor_db),
+      bin_frequencies_(config.num_bins),
+      bin_edges_(config.num_bins + 1),
+      output_db_(config.num_bins, config.floor_db) {
+    ASSERT(channel < source.getNumChannels(), "SpectrumAnalyzer channel out of range");
+    ASSERT(config.overlap > 0 && config.num_bins > 0, "SpectrumAnalyzer needs an overlap and bins");
+    ASSERT(config.min_frequency > 0.0f && config.max_frequency > config.min_frequency,
+           "SpectrumAnalyzer frequency range must be positive and increasing");
+    if (source.getCapacity() < config.fft_size) {
+        LOG_WARN("SpectrumAnalyzer: source keeps {} frames, fewer than the FFT size {}", source.getCapacity(),
+                 config.fft_size);
+    }
+
+    for (uint32_t ch = 0; ch < source.getNumChannels(); ++ch) {
+        input_ptrs_[ch] = input_.data() + static_cast<size_t>(ch) * config.fft_size;
+    }
+
+    // Periodic Hann window; the gain correction makes a full-scale sine read 0 dB
+    double window_sum = 0.0;
+    for (uint32_t i = 0; i < config.fft_size; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * i / config.fft_size));
+        window_sum += window_[i];
+    }
+    power_to_db_offset_ = static_cast<float>(-20.0 * std::log10(window_sum / 2.0));
+
+    // Log-spaced bins: centre frequencies, and edges halfway (geometrically) between them
+    const double bin_hz = sample_rate_ / config.fft_size;
+    const double ratio = std::log(config.max_frequency / config.min_frequency);
+    const double step = config.num_bins > 1 ? ratio / (config.num_bins - 1) : 0.0;
+    for (uint32_t b = 0; b < config.num_bins; ++b) {
+        bin_frequencies_[b] = static_cast<float>(config.min_frequency * std::exp(step * b));
+    }
+    for (uint32_t b = 0; b <= config.num_bins; ++b) {
+        const double edge = config.min_frequency * std::exp(step * (static_cast<double>(b) - 0.5));
+        bin_edges_[b] = static_cast<float>(edge / bin_hz);
+    }
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() { stop(); }
+
+void SpectrumAnalyzer::start() {
+    if (thread_.joinable()) return;
+    stop_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this] { run(); });
+}
+
+void SpectrumAnalyzer::stop() {
+    if (!thread_.joinable()) return;
+    stop_.store(true, std::memory_order_relaxed);
+    thread_.join();
+}
+
+void SpectrumAnalyzer::run() {
+    // Check for new input twice per hop, but at most every millisecond
+    const double hop_seconds = config_.fft_size / static_cast<double>(config_.overlap) / sample_rate_;
+    const auto interval = std::max(std::chrono::microseconds(1000),
+                                   std::chrono::microseconds(static_cast<int64_t>(hop_seconds * 0.5e6)));
+    while (!stop_.load(std::memory_order_relaxed)) {
+        if (!analyze()) std::this_thread::sleep_for(interval);
+    }
+}
+
+bool SpectrumAnalyzer::analyze() {
+    const uint64_t position = source_.getWritePosition();
+    const uint32_t hop = std::max(1u, config_.fft_size / config_.overlap);
+    if (position == 0 || (analyzed_ && position - analyzed_position_ < hop)) return false;
+
+    const uint32_t count = source_.readLatest(input_ptrs_.data(), config_.fft_size);
+    if (count == 0) return false;  // overwritten while copying; try again
+
+    // Until fft_size frames arrived, the newest frames sit at the end of a zero-padded window
+    const float* input = input_ptrs_[channel_];
+    const uint32_t pad = config_.fft_size - count;
+    std::fill_n(windowed_.begin(), pad, 0.0f);
+    for (uint32_t i = 0; i < count; ++i) windowed_[pad + i] = input[i] * window_[pad + i];
+    fft_.forward(windowed_.data(), re_.data(), im_.data());
+
+    const auto num_fft_bins = static_cast<uint32_t>(re_.size());
+    auto power = [&](uint32_t k) { return re_[k] * re_[k] + im_[k] * im_[k]; };
+    for (uint32_t b = 0; b < config_.num_bins; ++b) {
+        const float lo = bin_edges_[b];
+        const float hi = bin_edges_[b + 1];
+        float p = 0.0f;
+        const auto first = static_cast<uint32_t>(std::ceil(lo));
+        const auto last = std::min(num_fft_bins - 1, static_cast<uint32_t>(std::floor(hi)));
+        if (first <= last && first < num_fft_bins) {
+            for (uint32_t k = first; k <= last; ++k) p = std::max(p, power(k));
+        } else {
+            // Narrower than an FFT bin: interpolate at the centre
+            const float centre = std::clamp(std::sqrt(lo * hi), 0.0f, static_cast<float>(num_fft_bins - 1));
+            const auto k = std::min(static_cast<uint32_t>(centre), num_fft_bins - 2);
+            const float t = centre - static_cast<float>(k);
+            p = power(k) * (1.0f - t) + power(k + 1) * t;
+        }
+
+        const float db = std::max(config_.floor_db, 10.0f * std::log10(p + 1e-30f) + power_to_db_offset_);
+        float& smoothed = bins_db_[b];
+        smoothed = (!analyzed_ || db >= smoothed) ? db : smoothed * config_.release + db * (1.0f - config_.release);
+    }
+    analyzed_ = true;
+    analyzed_position_ = position;
+
+    {
+        std::lock_guard lock{output_mutex_};
+        std::copy(bins_db_.begin(), bins_db_.end(), output_db_.begin());
+        version_.fetch_add(1, std::memory_order_release);
+    }
+    return true;
+}
+
+uint64_t SpectrumAnalyzer::readSpectrum(std::span<float> magnitudes_db) const {
+    ASSERT(magnitudes_db.size() >= output_db_.size(), "SpectrumAnalyzer::readSpectrum needs getNumBins() entries");
+    std::lock_guard lock{output_mutex_};
+    const uint64_t version = version_.load(std::memory_order_relaxed);
+    if (version > 0) std::copy(output_db_.begin(), output_db_.end(), magnitudes_db.begin());
+    return version;
+}
+
+}  // namespace applause
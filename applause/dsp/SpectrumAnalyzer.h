@@ -0,0 +1,122 @@
+#pragma once
+
+#include <applause/dsp/FFT.h>
+#include <applause/util/ScopeBuffer.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace applause {
+
+/** How SpectrumAnalyzer measures and presents a spectrum. */
+struct SpectrumAnalyzerConfig {
+    uint32_t fft_size = 4096;  ///< Power of two, at least 4
+    uint32_t overlap = 4;  ///< Analyses per fft_size frames of input
+    uint32_t num_bins = 256;  ///< Output bins, spaced logarithmically from min_frequency to max_frequency
+    float min_frequency = 20.0f;
+    float max_frequency = 20000.0f;
+    float floor_db = -120.0f;  ///< Magnitudes are clamped to at least this
+    /** Weight of the previous analysis in a bin that is falling; rises are shown immediately. 0 disables. */
+    float release = 0.8f;
+};
+
+/**
+ * Turns audio from a ScopeBuffer into a smoothed, log-frequency magnitude spectrum for display, on a thread of
+ * its own so neither the audio thread nor the UI thread pays for the FFT.
+ *
+ * Each analysis takes the newest fft_size frames of one channel, applies a Hann window and transforms it; an
+ * analysis runs whenever fft_size / overlap new frames arrived. The power spectrum is reduced to num_bins bins
+ * centred on getBinFrequencies() (the loudest FFT bin in each, or an interpolation between FFT bins where bins are
+ * narrower than the FFT's resolution), converted to dB, where a full-scale sine reads 0 dB, and smoothed so falling
+ * bins decay. The UI then only copies the finished bins with readSpectrum().
+ *
+ * The source should be written at full rate; with a decimating ScopeBuffer the frequencies are those of the
+ * decimated signal.
+ *
+ * @code
+ * // Plugin: one ScopeBuffer the audio thread pushes into, and an analyzer reading it
+ * ScopeBuffer tap_{1, 8192};
+ * SpectrumAnalyzer analyzer_{tap_, 0, sample_rate};
+ * analyzer_.start();
+ *
+ * // Editor, overlaying an EQ curve at the same frequencies
+ * magnitudeResponseDb(bands, sample_rate, analyzer_.getBinFrequencies(), curve_db);
+ * @endcode
+ */
+class SpectrumAnalyzer {
+public:
+    SpectrumAnalyzer(ScopeBuffer& source, uint32_t channel, double sample_rate, SpectrumAnalyzerConfig config = {});
+
+    /** Stops the thread. */
+    ~SpectrumAnalyzer();
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    /** Starts analyzing on a background thread; does nothing if it's already running. */
+    void start();
+
+    /** Stops and joins the background thread. */
+    void stop();
+
+    [[nodiscard]] bool isRunning() const noexcept { return thread_.joinable(); }
+
+    /**
+     * Runs one analysis if enough new input arrived since the last one and publishes it. The background thread
+     * calls this in a loop; call it directly only while the thread isn't running, e.g. from a test. Returns
+     * whether it published.
+     */
+    bool analyze();
+
+    /**
+     * Copies the newest spectrum, in dB, into magnitudes_db (getNumBins() entries) and returns its version, which
+     * increases with every analysis; 0 means nothing was analyzed yet and magnitudes_db is left alone.
+     */
+    uint64_t readSpectrum(std::span<float> magnitudes_db) const;
+
+    /** Version of the newest spectrum, as returned by readSpectrum(); cheap to poll. */
+    [[nodiscard]] uint64_t getVersion() const noexcept { return version_.load(std::memory_order_acquire); }
+
+    /** The centre frequency of each output bin, in Hz. */
+    [[nodiscard]] std::span<const float> getBinFrequencies() const noexcept { return bin_frequencies_; }
+
+    [[nodiscard]] uint32_t getNumBins() const noexcept { return config_.num_bins; }
+
+    [[nodiscard]] const SpectrumAnalyzerConfig& getConfig() const noexcept { return config_; }
+
+private:
+    void run();
+
+    ScopeBuffer& source_;
+    const uint32_t channel_;
+    const double sample_rate_;  // of the source, after its decimation
+    const SpectrumAnalyzerConfig config_;
+    FFT fft_;
+
+    // Analysis state, owned by whichever thread calls analyze()
+    std::vector<float> input_;  // every channel of the source, as readLatest() needs them
+    std::vector<float*> input_ptrs_;
+    std::vector<float> window_;
+    std::vector<float> windowed_;
+    std::vector<float> re_;
+    std::vector<float> im_;
+    std::vector<float> bins_db_;
+    std::vector<float> bin_frequencies_;
+    std::vector<float> bin_edges_;  // num_bins + 1 edges in FFT bin units
+    float power_to_db_offset_ = 0.0f;
+    uint64_t analyzed_position_ = 0;
+    bool analyzed_ = false;
+
+    mutable std::mutex output_mutex_;
+    std::vector<float> output_db_;
+    std::atomic<uint64_t> version_{0};
+
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+}  // namespace applause
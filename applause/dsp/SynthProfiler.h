@@ -0,0 +1,92 @@
+#pragma once
+#include <applause/util/thirdparty/readerwriterqueue.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Set APPLAUSE_ENABLE_PROFILING to 1 (CMake option APPLAUSE_ENABLE_PROFILING) to compile in Synthesizer
+ * instrumentation. When it's 0, SynthProfiler can still be constructed and attached, but nothing ever records
+ * into it, and the instrumented code paths compile to what they were without it.
+ */
+#ifndef APPLAUSE_ENABLE_PROFILING
+#define APPLAUSE_ENABLE_PROFILING 0
+#endif
+
+namespace applause {
+
+inline constexpr bool kProfilingEnabled = APPLAUSE_ENABLE_PROFILING != 0;
+
+/**
+ * A cheap, monotonic cycle counter: the time-stamp counter on x86, the virtual counter on ARM64, and steady clock
+ * nanoseconds elsewhere. Only differences between readings on the same machine are meaningful.
+ */
+inline uint64_t readCycleCounter() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+}
+
+/** One record from an instrumented Synthesizer. */
+struct SynthProfileEvent {
+    enum class Type : uint8_t {
+        Voice,     ///< One voice's process() calls within a sub-block
+        SubBlock,  ///< One renderSubBlock() call
+        Block,     ///< One Synthesizer::process() call; sub_blocks counts its renderSubBlock() calls
+        Steal,     ///< A voice was stolen for a new note
+    };
+
+    Type type;
+    uint16_t voice = 0;          ///< Voice and Steal: the voice index
+    uint32_t sub_blocks = 0;     ///< Block: number of sub-blocks rendered
+    uint32_t start_sample = 0;   ///< Voice and SubBlock: start of the sub-block within the block
+    uint32_t num_samples = 0;    ///< Voice, SubBlock and Block: frames covered
+    uint64_t cycles = 0;         ///< Voice, SubBlock and Block: readCycleCounter() ticks spent
+    uint64_t block_index = 0;    ///< Which process() call, counted from the first profiled one
+};
+
+/**
+ * Collects SynthProfileEvents from one Synthesizer (Synthesizer::setProfiler()) for a UI or logging thread.
+ *
+ * The audio thread pushes into a fixed-capacity lock-free single-producer, single-consumer queue and never
+ * allocates; when the reader falls behind, new events are dropped and counted instead.
+ */
+class SynthProfiler {
+public:
+    explicit SynthProfiler(size_t capacity = 4096) : queue_(capacity) {}
+
+    /** Audio thread: records an event, or counts it as dropped when the queue is full. */
+    void record(const SynthProfileEvent& event) noexcept {
+        if (!queue_.try_enqueue(event)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Reader thread: pops the oldest event into event. Returns false when there is none. */
+    bool tryPop(SynthProfileEvent& event) noexcept { return queue_.try_dequeue(event); }
+
+    /** Number of events dropped because the queue was full. */
+    [[nodiscard]] uint64_t getDroppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    ReaderWriterQueue<SynthProfileEvent> queue_;
+    std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace applause
@@ -1,18 +1,65 @@
 #pragma once
+#include <applause/core/ModMatrix.h>
+#include <applause/core/ProcessContext.h>
 #include <applause/core/ProcessInfo.h>
+#include <applause/util/MemoryArena.h>
 #include <applause/util/SampleType.h>
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
 #include <span>
 #include <type_traits>
+#include <vector>
 
 #include <clap/events.h>
+#include <xsimd/xsimd.hpp>
 
 #include <applause/dsp/BufferView.h>
+#include <applause/dsp/MidiDecoder.h>
 #include <applause/dsp/Note.h>
+#include <applause/dsp/Oversampler.h>
+#include <applause/dsp/SynthProfiler.h>
+#include <applause/extensions/ThreadPoolExtension.h>
 
 namespace applause {
+
+/** Where a voice is in its note's lifetime. */
+enum class VoiceState : uint8_t {
+    Idle,       // the voice is idle and ready to play a note
+    KeyDown,    // the note is actively playing a note, and the corresponding key is down
+    Sustained,  // the voice is no longer playing a note, but the sustain pedal is still down
+    Released,   // the voice is still playing a note, but the corresponding key is released (e.g. release phase)
+};
+
+/**
+ * What Synthesizer needs to know about a voice to manage it: whether and how it sounds, how old its note is, and
+ * the identifiers note events are matched against.
+ *
+ * Synthesizer keeps one per voice in a dense array next to, not inside, the voice objects (which hold the Note,
+ * its expressions and all the DSP state), so finding free voices, matching note-offs and expressions, picking
+ * steal victims and reclaiming finished voices read 16 bytes per voice instead of a cache line or more of each.
+ */
+struct VoiceStatus {
+    int32_t note_id = -1;
+    int32_t play_order = 0;
+    int16_t key = 0;
+    int16_t channel = 0;
+    int16_t port_index = 0;
+    VoiceState state = VoiceState::Idle;
+    bool active = false;
+
+    /** Note::matches() over the copied identifiers. */
+    [[nodiscard]] bool matches(int16_t event_key, int32_t event_note_id, int16_t event_port,
+                               int16_t event_channel) const noexcept {
+        return (event_key == -1 || event_key == key) && (event_note_id == -1 || event_note_id == note_id) &&
+               (event_port == -1 || event_port == port_index) && (event_channel == -1 || event_channel == channel);
+    }
+};
+static_assert(sizeof(VoiceStatus) == 16, "VoiceStatus should stay four to a cache line");
+
 /**
  *
  * The voice is templated with both the sample type (float/double) and the
@@ -31,8 +78,28 @@ namespace applause {
 template <Scalar T, size_t MaxChannels>
 class SynthesizerVoice {
 public:
+    using State = VoiceState;
+
+    SynthesizerVoice() = default;
     virtual ~SynthesizerVoice() = default;
 
+    // A copy takes the status along but not the table slot it lives in; the owning Synthesizer rebinds it
+    SynthesizerVoice(const SynthesizerVoice& other) noexcept
+        : note_(other.note_),
+          sample_rate_(other.sample_rate_),
+          own_status_(*other.status_),
+          mod_matrix_(other.mod_matrix_),
+          voice_index_(other.voice_index_) {}
+
+    SynthesizerVoice& operator=(const SynthesizerVoice& other) noexcept {
+        note_ = other.note_;
+        sample_rate_ = other.sample_rate_;
+        *status_ = *other.status_;
+        mod_matrix_ = other.mod_matrix_;
+        voice_index_ = other.voice_index_;
+        return *this;
+    }
+
     virtual void process(BufferView<T, MaxChannels> buffer, int start_sample, int num_samples) = 0;
     /**
      * Terminates the voice immediately, releasing it back into the pool
@@ -86,20 +153,56 @@ public:
         // Default: do nothing (voice implementation may recalculate per-sample instead)
     }
 
+    /**
+     * A cheap estimate of this voice's current output level (e.g. its envelope value), used by
+     * VoiceStealPolicy::CostAware to steal quiet voices first. The default treats every voice as full level.
+     */
+    [[nodiscard]] virtual float getAmplitudeEstimate() const { return 1.0f; }
+
     /**
      * Mark this voice as finished with the current note, releasing it back into
      * the pool for reuse. Voices should call this function when (a) the corresponding key is
      * released and (b) the voice is no longer producing any audio.
      */
     void terminateVoice() {
-        active_ = false;
-        state_ = State::Idle;
+        status_->active = false;
+        status_->state = State::Idle;
     }
 
+    /** Whether this voice holds a note: from note-on until it terminates, released or not. */
+    [[nodiscard]] bool isActive() const noexcept { return status_->active; }
+
+    [[nodiscard]] State getState() const noexcept { return status_->state; }
+
+    /** The order notes started in; a voice with a lower play order holds an older note. */
+    [[nodiscard]] int getPlayOrder() const noexcept { return status_->play_order; }
+
     double getSampleRate() const noexcept { return sample_rate_; }
 
     void setSampleRate(double sample_rate) noexcept { sample_rate_ = sample_rate; }
 
+    /**
+     * Called before each sub-block while this voice is sounding and its Synthesizer has a ModMatrix bound
+     * (Synthesizer::setModMatrix()). Write this voice's poly source values here, e.g.
+     * matrix.setPolySourceValue(env_src, getVoiceIndex(), env_.getValue()).
+     */
+    virtual void updateModSources(ModMatrix& matrix, int start_sample, int num_samples) {}
+
+    /** The bound ModMatrix, or nullptr. */
+    [[nodiscard]] ModMatrix* getModMatrix() const noexcept { return mod_matrix_; }
+
+    /** This voice's index in the voice pool, which is also its voice index in the bound ModMatrix. */
+    [[nodiscard]] uint16_t getVoiceIndex() const noexcept { return voice_index_; }
+
+    /**
+     * This voice's handle for a poly destination of the bound ModMatrix. Handles stay valid while the matrix is
+     * bound, so voices can fetch them once, e.g. in noteOn().
+     */
+    [[nodiscard]] ModParamHandle getModHandle(uint16_t dst_index) const {
+        ASSERT(mod_matrix_, "No ModMatrix bound to this voice's Synthesizer");
+        return mod_matrix_->getModHandle(dst_index, voice_index_);
+    }
+
     /**
      * The note data for this voice, including all CLAP note expressions.
      * Voice implementations can access note_.key, note_.getFrequency(),
@@ -107,21 +210,26 @@ public:
      */
     Note note_;
 
-    // Voice management state (separate from note data)
-    bool active_ = false;
-    int play_order_ = 0;
+protected:
+    double sample_rate_ = 44100.0;
 
-    enum class State {
-        Idle,  // the voice is idle and ready to play a note
-        KeyDown,  // the note is actively playing a note, and the corresponding key is down
-        Sustained,  // the voice is no longer playing a note, but the sustain pedal is still down
-        Released,  // the voice is still playing a note, but the corresponding key is released (e.g. release phase)
-    };
+private:
+    template <Scalar, size_t, size_t, typename>
+    friend class Synthesizer;
 
-    State state_ = State::Idle;
+    // Voice management state lives in the Synthesizer's dense VoiceStatus table; own_status_ only stands in
+    // until a Synthesizer binds the voice to its slot
+    VoiceStatus own_status_;
+    VoiceStatus* status_ = &own_status_;
+    ModMatrix* mod_matrix_ = nullptr;
+    uint16_t voice_index_ = 0;
+};
 
-protected:
-    double sample_rate_ = 44100.0;
+/** How Synthesizer::stealVoice() picks the voice to take over when every voice is sounding. */
+enum class VoiceStealPolicy : uint8_t {
+    Oldest,         ///< The voice whose note started first
+    ReleasedFirst,  ///< Released voices before held ones, oldest first within each
+    CostAware,      ///< Released voices before held ones, then the quietest (getAmplitudeEstimate()), then the oldest
 };
 
 /**
@@ -129,7 +237,7 @@ A simple synthesizer that does everything you need and nothing that you don't.
 To use, extend SynthesizerVoice and add your own DSP code. Supports both
 standard MIDI and MPE.
 
-This class is designed for performance and does not do heap allocations.
+This class is designed for performance and does not do heap allocations while processing.
 Many parameters, such as the maximum number of voices and audio channels,
 are templated at compile time. Sorry!
 
@@ -145,7 +253,10 @@ class Synthesizer {
                   "VoiceType must derive from SynthesizerVoice<T, MaxChannels>");
 
 public:
-    Synthesizer() = default;
+    Synthesizer() {
+        resetVoiceTables();
+        for (size_t v = 0; v < NumVoices; ++v) voices_.voices[v].voice_index_ = static_cast<uint16_t>(v);
+    }
     Synthesizer(const Synthesizer&) = default;
     Synthesizer(Synthesizer&&) = default;
     Synthesizer& operator=(const Synthesizer&) = default;
@@ -154,14 +265,160 @@ public:
 
     [[nodiscard]] int getNumVoices() const noexcept { return NumVoices; }
 
+    /**
+     * Sets how voices are stolen under voice pressure (CostAware by default). Candidates are ordered in a heap
+     * built once per chord: when several note-ons arrive at the same time and there aren't enough free voices,
+     * the victims for all of them are chosen together.
+     */
+    void setStealPolicy(VoiceStealPolicy policy) noexcept { steal_policy_ = policy; }
+
+    [[nodiscard]] VoiceStealPolicy getStealPolicy() const noexcept { return steal_policy_; }
+
+    /**
+     * Renders every voice at factor times the sample rate (1, the default, 2, 4 or 8) and filters their sum back
+     * down with one Oversampler, so anti-aliasing costs one decimator per channel however many voices are sounding.
+     * Voices get the oversampled rate in setSampleRate() and render factor times as many frames, at event positions
+     * scaled to match; voice code doesn't change. Takes effect at the next activate(). The decimator delays the
+     * output by getLatency() samples, which the plugin reports through LatencyExtension.
+     */
+    void setOversampling(size_t factor) {
+        ASSERT(factor == 1 || factor == 2 || factor == 4 || factor == 8, "Synthesizer: factor must be 1, 2, 4 or 8");
+        oversampling_ = factor;
+    }
+
+    [[nodiscard]] size_t getOversampling() const noexcept { return oversampling_; }
+
+    /** The output delay of the oversampling decimator, in samples at the host's rate; 0 without oversampling. */
+    [[nodiscard]] uint32_t getLatency() const noexcept {
+        return render_factor_ > 1 ? oversampler_.getDownsampleLatency() : 0;
+    }
+
     void activate(ProcessInfo info);
     void noteOn(const clap_event_note_t* event);
     void noteOff(const clap_event_note_t* event);
     void noteChoke(const clap_event_note_t* event);
     VoiceType& findFreeVoice();
     VoiceType& stealVoice();
-    void process(BufferView<T, MaxChannels> buffer, const clap_input_events_t* events);
-    [[nodiscard]] std::span<VoiceType> getVoices() noexcept { return voices_; }
+
+    /**
+     * Renders one block, applying events at their time. With out_events, every note that stops sounding during
+     * the block (the voice called terminateVoice() or was stolen or choked) is reported to the host as a
+     * CLAP_EVENT_NOTE_END, so it stops sending modulation and expressions for it. A voice that finishes inside a
+     * sub-block is reported at that sub-block's end. NOTE_ENDs are pushed in time order; ProcessContext's
+     * outputEvents() batch sorts them among whatever else the plugin pushes during the block.
+     */
+    void process(BufferView<T, MaxChannels> buffer, const clap_input_events_t* events,
+                 const clap_output_events_t* out_events = nullptr);
+
+    /**
+     * Same as process(), but renders the voices on the pool's threads, each task handling voices_per_task
+     * active voices. Every voice renders into its own scratch buffer, and the scratch buffers are summed into the
+     * output in voice order, so the result is the same whether the tasks run in parallel or processParallel() falls
+     * back to rendering serially (neither the host nor ThreadPoolExtension::enableFallbackPool() provides a pool,
+     * the host refuses the request, or there is only one task's worth of voices).
+     *
+     * Voices must not share mutable state in process(). The scratch buffers are sized in activate(); blocks longer
+     * than its max_frame_size are rendered serially straight into the output. For the duration of the call the
+     * pool's task callback is replaced with the synthesizer's own, then restored. Subclasses that override
+     * renderSubBlock() replace this rendering path too.
+     */
+    void processParallel(BufferView<T, MaxChannels> buffer, const clap_input_events_t* events,
+                         ThreadPoolExtension& pool, uint32_t voices_per_task = 2,
+                         const clap_output_events_t* out_events = nullptr);
+
+    [[nodiscard]] std::span<VoiceType> getVoices() noexcept { return voices_.voices; }
+
+    /** Every voice's bookkeeping, indexed like getVoices(), without touching the voices themselves. */
+    [[nodiscard]] std::span<const VoiceStatus, NumVoices> getVoiceStatus() const noexcept { return voices_.status; }
+
+    /**
+     * Sets the shortest sub-block process() renders between events. An event less than frames after the start of
+     * the pending sub-block is applied at that start instead of splitting the block, so dense expression streams
+     * don't turn into runs of one-sample renderSubBlock() calls. The default of 1 keeps every event
+     * sample-accurate. The block's last sub-block may still be shorter.
+     */
+    void setMinSubBlockSize(uint32_t frames) noexcept { min_sub_block_ = std::max<uint32_t>(frames, 1); }
+
+    [[nodiscard]] uint32_t getMinSubBlockSize() const noexcept { return min_sub_block_; }
+
+    /**
+     * When enabled (the default), note-ons always split the block at their exact time, regardless of the minimum
+     * sub-block size; only the other events are quantized.
+     */
+    void setSampleAccurateNoteOns(bool enabled) noexcept { sample_accurate_note_ons_ = enabled; }
+
+    /**
+     * Sets how process() reads raw MIDI events (pitch bend range, MPE). CLAP_EVENT_MIDI and CLAP_EVENT_MIDI2 are
+     * decoded with MidiDecoder as process() reaches them and play exactly like the CLAP note events they
+     * translate to, so a plugin whose note port accepts MIDI or MPE needs no translation of its own.
+     */
+    void setMidiConfig(const MidiDecoderConfig& config) noexcept { midi_decoder_.setConfig(config); }
+
+    [[nodiscard]] const MidiDecoderConfig& getMidiConfig() const noexcept { return midi_decoder_.getConfig(); }
+
+    /**
+     * Binds a ModMatrix to the voice pool, or unbinds it with nullptr. While bound, the synthesizer drives the
+     * matrix itself: voice i is voice i in the matrix and is notified on and off as notes start and voices
+     * finish, and before every sub-block each sounding voice's updateModSources() runs, then the matrix's
+     * process(). Voices read their modulated values through getModHandle(), and only sounding voices are ever
+     * evaluated. With ramp_outputs, handles ramp across each sub-block.
+     *
+     * Mono sources and base values are still the plugin's to set before process(). Voices already sounding are
+     * moved over to the new matrix. The matrix must have at least NumVoices voices and outlive the binding.
+     *
+     * If the matrix was built with Config::host_modulation and registerFromParamsExtension(), process() also
+     * routes per-note CLAP_EVENT_PARAM_MOD events for polyphonic parameters to the matching voices' rows. Call
+     * ParamsExtension::setPerNoteModulation(true) as well, so the host offers per-note modulation at all.
+     */
+    void setModMatrix(ModMatrix* matrix);
+
+    [[nodiscard]] ModMatrix* getModMatrix() const noexcept { return mod_matrix_; }
+
+    /**
+     * Enables output silence detection: process() then tracks how long the output has stayed below threshold
+     * (absolute peak), and getProcessStatus() lets the host stop processing once every sounding voice is in its
+     * release and the output has been quiet for hold_frames. A threshold of 0 disables detection (the default).
+     */
+    void setSilenceThreshold(T threshold, uint32_t hold_frames) noexcept {
+        silence_threshold_ = threshold;
+        silence_hold_frames_ = hold_frames;
+        quiet_frames_ = 0;
+    }
+
+    /** Whether any voice is sounding, including released voices that haven't finished. */
+    [[nodiscard]] bool hasActiveVoices() const noexcept { return num_active_ > 0; }
+
+    /**
+     * Whether the last process() call left the output all zeros: no voice was sounding at any point of the block,
+     * and with oversampling the decimator had stopped ringing. The plugin can then flag the output as constant
+     * (ProcessContext::setConstantMask()).
+     */
+    [[nodiscard]] bool isOutputSilent() const noexcept { return output_silent_; }
+
+    /**
+     * What the plugin can return from process() for the synthesizer's output, after the last process() call:
+     * Sleep when no voice is sounding (nor the oversampling decimator ringing); ContinueIfNotQuiet when silence
+     * detection is enabled, every sounding voice is released and the output has been quiet for the hold time;
+     * Continue otherwise.
+     */
+    [[nodiscard]] ProcessStatus getProcessStatus() const noexcept;
+
+    /**
+     * Attaches a profiler that records per-voice and per-sub-block cycle counts, per-block sub-block counts and
+     * voice steals, or detaches it with nullptr. Only has an effect when the library is built with
+     * APPLAUSE_ENABLE_PROFILING; otherwise the instrumentation isn't compiled in at all. SimdSynthesizer and other
+     * renderSubBlock() overrides get sub-block and block events, but no per-voice ones.
+     */
+    void setProfiler(SynthProfiler* profiler) noexcept { profiler_ = profiler; }
+
+    /** Number of renderSubBlock() calls made by process() so far. */
+    [[nodiscard]] uint64_t getSubBlockCount() const noexcept { return sub_block_count_; }
+
+    /** Number of events process() applied early, at the start of a sub-block, because of the minimum size. */
+    [[nodiscard]] uint64_t getQuantizedEventCount() const noexcept { return quantized_event_count_; }
+
+    /** Number of voices currently holding a note (including released voices that are still sounding). */
+    [[nodiscard]] int getNumActiveVoices() const noexcept { return static_cast<int>(num_active_); }
 
 protected:
     /**
@@ -177,82 +434,464 @@ protected:
     virtual void renderSubBlock(BufferView<T, MaxChannels> buffer, int start_sample, int num_samples);
 
 private:
-    std::array<VoiceType, NumVoices> voices_;
+    /*
+     * Voice lookup tables, so note events don't scan every voice.
+     *
+     * Sounding voices are linked into two bucket tables: one hashed by note_id, one indexed by (channel, key).
+     * An event with a note_id walks its id bucket; an event with a key and channel walks its key bucket; only events
+     * that wildcard the key or channel fall back to walking the active list. Every candidate is still checked
+     * with Note::matches, so bucket collisions and wildcard ports behave exactly as a full scan would.
+     *
+     * Voices terminate themselves (terminateVoice()) from inside process(), so the tables learn about finished
+     * voices lazily: after each sub-block, and whenever a voice is needed and none is free.
+     */
+    static constexpr uint16_t kNoVoice = 0xFFFF;
+    static constexpr size_t kIdBuckets = std::bit_ceil(2 * NumVoices);
+    static constexpr size_t kKeyBuckets = 16 * 128;
+    static_assert(NumVoices < kNoVoice, "Too many voices");
+
+    struct VoiceLinks {
+        uint16_t id_prev = kNoVoice;
+        uint16_t id_next = kNoVoice;
+        uint16_t key_prev = kNoVoice;
+        uint16_t key_next = kNoVoice;
+        uint16_t id_bucket = kNoVoice;  // kNoVoice: note has no note_id, so it isn't in the id table
+        uint16_t key_bucket = 0;
+        bool listed = false;  // in the tables and the active list
+    };
+
+    // Candidate voices collected for one event, before any of them is touched
+    struct VoiceSet {
+        std::array<uint16_t, NumVoices> voices;
+        size_t size = 0;
+    };
+
+    static size_t idBucket(int32_t note_id) noexcept {
+        // Fibonacci hashing: host note ids are often sequential, so take the well-mixed high bits
+        constexpr int kShift = 32 - std::countr_zero(kIdBuckets);
+        return static_cast<size_t>((static_cast<uint32_t>(note_id) * 2654435769u) >> kShift) & (kIdBuckets - 1);
+    }
+    static size_t keyBucket(int16_t channel, int16_t key) noexcept {
+        return (static_cast<size_t>(channel) & 15) * 128 + (static_cast<size_t>(key) & 127);
+    }
+
+    /**
+     * The voices and, apart from them, their VoiceStatus table. Copies point the copied voices at the copy's
+     * table, so Synthesizer itself stays copyable with the defaults.
+     */
+    struct VoicePool {
+        std::array<VoiceType, NumVoices> voices;
+        std::array<VoiceStatus, NumVoices> status{};
+
+        VoicePool() { bind(); }
+        VoicePool(const VoicePool& other) : voices(other.voices), status(other.status) { bind(); }
+        VoicePool& operator=(const VoicePool& other) {
+            voices = other.voices;  // Writes each voice's status through its own slot
+            status = other.status;
+            return *this;
+        }
+
+        VoiceType& operator[](size_t v) noexcept { return voices[v]; }
+        const VoiceType& operator[](size_t v) const noexcept { return voices[v]; }
+        auto begin() noexcept { return voices.begin(); }
+        auto end() noexcept { return voices.end(); }
+
+        void bind() noexcept {
+            for (size_t v = 0; v < NumVoices; ++v) voices[v].status_ = &status[v];
+        }
+    };
+
+    [[nodiscard]] uint16_t indexOf(const VoiceType& voice) const noexcept {
+        return static_cast<uint16_t>(&voice - voices_.voices.data());
+    }
+
+    [[nodiscard]] static bool isFinished(const VoiceStatus& status) noexcept {
+        return !status.active || status.state == VoiceState::Idle;
+    }
+
+    // One sub-block: modulation, rendering, then picking up voices that finished
+    void renderChunk(BufferView<T, MaxChannels> buffer, int start_sample, int num_samples);
+    void updateSilence(BufferView<T, MaxChannels> buffer) noexcept;
+
+    [[nodiscard]] bool profiling() const noexcept {
+        if constexpr (kProfilingEnabled) {
+            return profiler_ != nullptr;
+        } else {
+            return false;
+        }
+    }
+    // Renders one voice, timing it when profiling
+    void renderVoice(uint16_t v, BufferView<T, MaxChannels> buffer, int start_sample, int num_samples);
+    void renderVoicesParallel(BufferView<T, MaxChannels> buffer, int start_sample, int num_samples);
+    void renderScratchVoices(uint32_t first, uint32_t last);
+    [[nodiscard]] BufferView<T, MaxChannels> scratchView(uint16_t v) noexcept {
+        return {scratch_.data() + v * MaxChannels * scratch_frames_, parallel_channels_, parallel_frames_};
+    }
+    static void addSamples(T* dst, const T* src, size_t count) noexcept;
+
+    // Lower keys are stolen first
+    struct StealKey {
+        uint8_t tier;  // 0 for released voices under the policies that prefer them
+        float amplitude;
+        int play_order;
+        auto operator<=>(const StealKey&) const = default;
+    };
+
+    [[nodiscard]] StealKey stealKey(uint16_t v) const;
+    // Picks the next num_victims voices to steal, best first, into steal_queue_
+    void planSteals(size_t num_victims);
+    [[nodiscard]] static bool startsNote(const clap_event_header_t& header) noexcept {
+        return (header.space_id == CLAP_CORE_EVENT_SPACE_ID && header.type == CLAP_EVENT_NOTE_ON) ||
+               MidiDecoder::isNoteOn(header);
+    }
+    [[nodiscard]] static size_t countNoteOnsAt(const clap_input_events_t* events, uint32_t first, uint32_t time);
+
+    void resetVoiceTables();
+    void listVoice(uint16_t v);
+    void unlistVoice(uint16_t v);
+    void reclaimFinishedVoices();
+    void pushNoteEnd(const VoiceStatus& status) const noexcept;
+    // Applies one CLAP note, expression or per-note modulation event at the current position
+    void applyEvent(const clap_event_header_t& header);
+
+    /**
+     * Collects the voices matching an event's (key, note_id, port, channel) under CLAP wildcard rules that also
+     * satisfy eligible. With first_only and a specific note_id, keeps only the lowest-indexed match, as the
+     * break-on-first-match scan over voices_ did.
+     */
+    template <typename Eligible>
+    VoiceSet findMatchingVoices(int16_t key, int32_t note_id, int16_t port, int16_t channel, bool first_only,
+                                Eligible&& eligible);
+
+    VoicePool voices_;
     int notes_played_ = 0;  // count the number of notes; used for finding the
     // oldest voice during voice stealing
+
+    std::array<VoiceLinks, NumVoices> links_;
+    std::array<uint16_t, kIdBuckets> id_heads_;
+    std::array<uint16_t, kKeyBuckets> key_heads_;
+    std::array<uint16_t, NumVoices> free_voices_;  // stack; the top is handed out next
+    size_t num_free_ = 0;
+    std::array<uint16_t, NumVoices> active_voices_;  // listed voices in note-on order, oldest first
+    size_t num_active_ = 0;
+
+    VoiceStealPolicy steal_policy_ = VoiceStealPolicy::CostAware;
+    std::array<uint16_t, NumVoices> steal_queue_;  // planned victims; only valid until the next sub-block
+    std::array<int, NumVoices> steal_play_orders_;  // each victim's play_order when planned
+    size_t num_steals_ = 0;
+    size_t next_steal_ = 0;
+
+    ModMatrix* mod_matrix_ = nullptr;
+    SynthProfiler* profiler_ = nullptr;
+    std::array<uint64_t, NumVoices> voice_cycles_{};  // this sub-block, while profiling; 0 = not rendered
+    uint64_t profiled_blocks_ = 0;
+    uint32_t min_sub_block_ = 1;
+    bool sample_accurate_note_ons_ = true;
+    uint64_t sub_block_count_ = 0;
+    T silence_threshold_ = T(0);
+    uint32_t silence_hold_frames_ = 0;
+    uint64_t quiet_frames_ = 0;  // consecutive frames with output below silence_threshold_
+    bool output_silent_ = true;
+    uint64_t quantized_event_count_ = 0;
+
+    // Set only during process(): where NOTE_ENDs go, and the time they're stamped with
+    const clap_output_events_t* out_events_ = nullptr;
+    uint32_t note_end_time_ = 0;
+
+    MidiDecoder midi_decoder_;
+
+    // Oversampled rendering: voices render into the block's oversampled view, which one decimator brings back down
+    size_t oversampling_ = 1;
+    size_t render_factor_ = 1;  // oversampling_ as of the last activate()
+    std::vector<std::byte> oversampler_storage_;
+    Oversampler<T, MaxChannels> oversampler_;
+    BufferView<T, MaxChannels> oversampled_block_;
+    uint64_t decimator_quiet_frames_ = 0;  // frames decimated since the voices last sounded; stops at the tail
+
+    [[nodiscard]] bool isDecimatorRinging() const noexcept {
+        return render_factor_ > 1 && decimator_quiet_frames_ < oversampler_.getTailSamples();
+    }
+    void decimate(BufferView<T, MaxChannels> buffer) noexcept;
+
+    // Parallel rendering: one MaxChannels x scratch_frames_ plane per voice, allocated in activate()
+    std::vector<T> scratch_;
+    size_t scratch_frames_ = 0;
+    ThreadPoolExtension* parallel_pool_ = nullptr;  // set only during processParallel()
+    uint32_t parallel_voices_per_task_ = 1;
+    // The current sub-block, shared with the pool's tasks
+    std::array<uint16_t, NumVoices> parallel_voices_;  // in voice order
+    uint32_t parallel_count_ = 0;
+    size_t parallel_channels_ = 0;
+    size_t parallel_frames_ = 0;
+    int parallel_start_ = 0;
+    int parallel_num_samples_ = 0;
 };
 
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::resetVoiceTables() {
+    links_.fill({});
+    id_heads_.fill(kNoVoice);
+    key_heads_.fill(kNoVoice);
+    num_active_ = 0;
+    num_free_ = NumVoices;
+    // Reversed, so voice 0 is handed out first
+    for (size_t i = 0; i < NumVoices; ++i) free_voices_[i] = static_cast<uint16_t>(NumVoices - 1 - i);
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::listVoice(uint16_t v) {
+    auto& link = links_[v];
+    const VoiceStatus& note = voices_.status[v];
+
+    link.key_bucket = static_cast<uint16_t>(keyBucket(note.channel, note.key));
+    link.key_prev = kNoVoice;
+    link.key_next = key_heads_[link.key_bucket];
+    if (link.key_next != kNoVoice) links_[link.key_next].key_prev = v;
+    key_heads_[link.key_bucket] = v;
+
+    link.id_bucket = kNoVoice;
+    if (note.note_id != -1) {
+        link.id_bucket = static_cast<uint16_t>(idBucket(note.note_id));
+        link.id_prev = kNoVoice;
+        link.id_next = id_heads_[link.id_bucket];
+        if (link.id_next != kNoVoice) links_[link.id_next].id_prev = v;
+        id_heads_[link.id_bucket] = v;
+    }
+
+    active_voices_[num_active_++] = v;
+    link.listed = true;
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::unlistVoice(uint16_t v) {
+    auto& link = links_[v];
+    if (!link.listed) return;
+
+    (link.key_prev != kNoVoice ? links_[link.key_prev].key_next : key_heads_[link.key_bucket]) = link.key_next;
+    if (link.key_next != kNoVoice) links_[link.key_next].key_prev = link.key_prev;
+
+    if (link.id_bucket != kNoVoice) {
+        (link.id_prev != kNoVoice ? links_[link.id_prev].id_next : id_heads_[link.id_bucket]) = link.id_next;
+        if (link.id_next != kNoVoice) links_[link.id_next].id_prev = link.id_prev;
+    }
+
+    // Keep the active list in note-on order, so its front stays the oldest voice
+    const auto end = active_voices_.begin() + static_cast<std::ptrdiff_t>(num_active_);
+    const auto it = std::find(active_voices_.begin(), end, v);
+    std::copy(it + 1, end, it);
+    --num_active_;
+
+    free_voices_[num_free_++] = v;
+    link.listed = false;
+    if (mod_matrix_) mod_matrix_->notifyVoiceOff(v);
+    if (out_events_) pushNoteEnd(voices_.status[v]);
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::pushNoteEnd(const VoiceStatus& note) const noexcept {
+    clap_event_note_t event{};
+    event.header = {sizeof(event), note_end_time_, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_NOTE_END, 0};
+    event.note_id = note.note_id;
+    event.port_index = note.port_index;
+    event.channel = note.channel;
+    event.key = note.key;
+    if (!out_events_->try_push(out_events_, &event.header)) LOG_WARN("Synthesizer: host dropped a NOTE_END event");
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::reclaimFinishedVoices() {
+    size_t i = 0;
+    while (i < num_active_) {
+        const uint16_t v = active_voices_[i];
+        if (isFinished(voices_.status[v])) {
+            unlistVoice(v);  // shifts the rest of the list down, so don't advance
+        } else {
+            ++i;
+        }
+    }
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+template <typename Eligible>
+typename Synthesizer<T, MaxChannels, NumVoices, VoiceType>::VoiceSet
+Synthesizer<T, MaxChannels, NumVoices, VoiceType>::findMatchingVoices(int16_t key, int32_t note_id, int16_t port,
+                                                                     int16_t channel, bool first_only,
+                                                                     Eligible&& eligible) {
+    VoiceSet found;
+    const auto consider = [&](uint16_t v) {
+        const VoiceStatus& status = voices_.status[v];
+        if (eligible(status) && status.matches(key, note_id, port, channel)) found.voices[found.size++] = v;
+    };
+
+    if (note_id != -1) {
+        for (uint16_t v = id_heads_[idBucket(note_id)]; v != kNoVoice; v = links_[v].id_next) consider(v);
+        if (first_only && found.size > 1) {
+            found.voices[0] = *std::min_element(found.voices.begin(), found.voices.begin() + found.size);
+            found.size = 1;
+        }
+    } else if (key != -1 && channel != -1) {
+        for (uint16_t v = key_heads_[keyBucket(channel, key)]; v != kNoVoice; v = links_[v].key_next) consider(v);
+    } else {
+        for (size_t i = 0; i < num_active_; ++i) consider(active_voices_[i]);
+    }
+    return found;
+}
+
 template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::activate(ProcessInfo info) {
+    render_factor_ = oversampling_;
     for (auto& voice : voices_) {
-        voice.setSampleRate(info.sample_rate);
+        voice.setSampleRate(info.sample_rate * static_cast<double>(render_factor_));
+    }
+    scratch_frames_ = info.max_frame_size * render_factor_;
+    scratch_.assign(NumVoices * MaxChannels * scratch_frames_, T(0));
+
+    if (render_factor_ > 1) {
+        oversampler_.setFactor(render_factor_);
+        oversampler_storage_.resize(
+            Oversampler<T, MaxChannels>::requiredArenaBytes(render_factor_, MaxChannels, info.max_frame_size));
+        MemoryArena arena{oversampler_storage_.data(), oversampler_storage_.size()};
+        oversampler_.activate(arena, MaxChannels, info.max_frame_size);
+    } else {
+        oversampler_storage_ = {};
     }
+    oversampled_block_ = {};
+    decimator_quiet_frames_ = oversampler_.getTailSamples();
 }
 
 template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 VoiceType& Synthesizer<T, MaxChannels, NumVoices, VoiceType>::findFreeVoice() {
-    for (auto& voice : voices_) {
-        if (!voice.active_ || voice.state_ == SynthesizerVoice<T, MaxChannels>::State::Idle) {
-            return voice;
-        }
-    }
+    // Voices may have finished since the last sweep; pick them up before resorting to stealing
+    if (num_free_ == 0) reclaimFinishedVoices();
+    if (num_free_ > 0) return voices_[free_voices_[num_free_ - 1]];
 
     return stealVoice();
 }
 
 template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 VoiceType& Synthesizer<T, MaxChannels, NumVoices, VoiceType>::stealVoice() {
-    VoiceType* oldest = &voices_[0];
-    for (auto& voice : voices_) {
-        if (voice.play_order_ < oldest->play_order_) {
-            oldest = &voice;
-        }
+    // Planned victims may have finished or been choked since, and their voices even reused by a later note of the
+    // chord; a voice still playing the note it was planned for keeps the play_order it had then
+    const auto planned = [this](size_t i) {
+        const uint16_t v = steal_queue_[i];
+        return links_[v].listed && voices_.status[v].play_order == steal_play_orders_[i];
+    };
+    while (next_steal_ < num_steals_ && !planned(next_steal_)) ++next_steal_;
+    if (next_steal_ == num_steals_) planSteals(1);
+
+    const uint16_t v = next_steal_ < num_steals_ ? steal_queue_[next_steal_++] : 0;
+    VoiceType& victim = voices_[v];
+    if (profiling()) profiler_->record({SynthProfileEvent::Type::Steal, v, 0, 0, 0, 0, profiled_blocks_});
+
+    victim.noteOff(true);
+    unlistVoice(v);
+    return victim;
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+typename Synthesizer<T, MaxChannels, NumVoices, VoiceType>::StealKey
+Synthesizer<T, MaxChannels, NumVoices, VoiceType>::stealKey(uint16_t v) const {
+    const VoiceStatus& status = voices_.status[v];
+    const auto tier = static_cast<uint8_t>(status.state == VoiceState::Released ? 0 : 1);
+    switch (steal_policy_) {
+        case VoiceStealPolicy::Oldest: return {0, 0.0f, status.play_order};
+        case VoiceStealPolicy::ReleasedFirst: return {tier, 0.0f, status.play_order};
+        // Only this policy asks the voice itself
+        default: return {tier, voices_[v].getAmplitudeEstimate(), status.play_order};
     }
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::planSteals(size_t num_victims) {
+    num_steals_ = next_steal_ = 0;
+    num_victims = std::min(num_victims, num_active_);
+    if (num_victims == 0) return;
 
-    oldest->noteOff(true);
-    return *oldest;
+    // A min-heap over the active voices, popped once per victim
+    std::array<StealKey, NumVoices> keys;
+    std::array<uint16_t, NumVoices> heap;
+    for (size_t i = 0; i < num_active_; ++i) {
+        heap[i] = active_voices_[i];
+        keys[heap[i]] = stealKey(heap[i]);
+    }
+    const auto later = [&](uint16_t a, uint16_t b) { return keys[b] < keys[a]; };
+    auto end = heap.begin() + static_cast<std::ptrdiff_t>(num_active_);
+    std::make_heap(heap.begin(), end, later);
+    while (num_steals_ < num_victims) {
+        std::pop_heap(heap.begin(), end--, later);
+        steal_play_orders_[num_steals_] = voices_.status[*end].play_order;
+        steal_queue_[num_steals_++] = *end;
+    }
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+size_t Synthesizer<T, MaxChannels, NumVoices, VoiceType>::countNoteOnsAt(const clap_input_events_t* events,
+                                                                        uint32_t first,
+                                                                        uint32_t time) {
+    size_t count = 0;
+    const uint32_t event_count = events->size(events);
+    for (uint32_t i = first; i < event_count && count < NumVoices; ++i) {
+        const clap_event_header_t* header = events->get(events, i);
+        if (!header) continue;
+        if (header->time != time) break;
+        if (startsNote(*header)) ++count;
+    }
+    return count;
 }
 
 template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::noteOn(const clap_event_note_t* event) {
     VoiceType& voice = findFreeVoice();
+    const uint16_t v = indexOf(voice);
+
+    // Take the voice off the free stack; findFreeVoice() hands out the top, but a subclass might not
+    unlistVoice(v);
+    const auto free_end = free_voices_.begin() + static_cast<std::ptrdiff_t>(num_free_);
+    if (num_free_ > 0 && free_voices_[num_free_ - 1] == v) {
+        --num_free_;
+    } else if (const auto it = std::find(free_voices_.begin(), free_end, v); it != free_end) {
+        std::copy(it + 1, free_end, it);
+        --num_free_;
+    }
 
-    // Use Note struct to store all note data with full precision
     voice.note_ = Note::fromNoteOn(event);
-    voice.play_order_ = notes_played_++;
-    voice.state_ = SynthesizerVoice<T, MaxChannels>::State::KeyDown;
-    voice.active_ = true;
+    VoiceStatus& status = voices_.status[v];
+    status.note_id = event->note_id;
+    status.key = event->key;
+    status.channel = event->channel;
+    status.port_index = event->port_index;
+    status.play_order = notes_played_++;
+    status.state = VoiceState::KeyDown;
+    status.active = true;
+    listVoice(v);
+    if (mod_matrix_) mod_matrix_->notifyVoiceOn(v);
 
     voice.noteOn();
 }
 
 template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::noteOff(const clap_event_note_t* event) {
-    for (auto& voice : voices_) {
-        if (voice.active_ && voice.state_ == SynthesizerVoice<T, MaxChannels>::State::KeyDown) {
-            // Use CLAP wildcard matching: (port, channel, key, note_id)
-            if (voice.note_.matches(event->key, event->note_id, event->port_index, event->channel)) {
-                voice.note_.setNoteOff(event);
-                voice.noteOff(false);
-                voice.state_ = SynthesizerVoice<T, MaxChannels>::State::Released;
-                // If specific note_id provided, only release that one voice
-                if (event->note_id != -1) break;
-            }
-        }
+    // Use CLAP wildcard matching: (port, channel, key, note_id). A specific note_id releases only one voice.
+    const auto found = findMatchingVoices(event->key, event->note_id, event->port_index, event->channel, true,
+                                          [](const VoiceStatus& status) {
+                                              return status.active && status.state == VoiceState::KeyDown;
+                                          });
+    for (size_t i = 0; i < found.size; ++i) {
+        auto& voice = voices_[found.voices[i]];
+        voice.note_.setNoteOff(event);
+        voice.noteOff(false);
+        voices_.status[found.voices[i]].state = VoiceState::Released;
     }
 }
 
 template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::noteChoke(const clap_event_note_t* event) {
-    for (auto& voice : voices_) {
-        if (voice.active_) {
-            // Use CLAP wildcard matching: (port, channel, key, note_id)
-            if (voice.note_.matches(event->key, event->note_id, event->port_index, event->channel)) {
-                voice.noteOff(true);  // Terminate immediately
-                // If specific note_id provided, only choke that one voice
-                if (event->note_id != -1) break;
-            }
-        }
+    // Use CLAP wildcard matching: (port, channel, key, note_id). A specific note_id chokes only one voice.
+    const auto found = findMatchingVoices(event->key, event->note_id, event->port_index, event->channel, true,
+                                          [](const VoiceStatus& status) { return status.active; });
+    for (size_t i = 0; i < found.size; ++i) {
+        voices_[found.voices[i]].noteOff(true);  // Terminate immediately
+        unlistVoice(found.voices[i]);
     }
 }
 
@@ -260,20 +899,86 @@ template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::renderSubBlock(BufferView<T, MaxChannels> buffer,
                                                                       int start_sample,
                                                                       int num_samples) {
-    for (auto& voice : voices_) {
-        if (voice.active_) {
-            voice.process(buffer, start_sample, num_samples);
+    if (parallel_pool_ && buffer.numFrames() <= scratch_frames_) {
+        renderVoicesParallel(buffer, start_sample, num_samples);
+        return;
+    }
+    for (uint16_t v = 0; v < NumVoices; ++v) {
+        if (voices_.status[v].active) {
+            renderVoice(v, buffer, start_sample, num_samples);
+        }
+    }
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::renderVoice(uint16_t v, BufferView<T, MaxChannels> buffer,
+                                                                   int start_sample,
+                                                                   int num_samples) {
+    if (!profiling()) {
+        voices_[v].process(buffer, start_sample, num_samples);
+        return;
+    }
+    // Written by whichever thread renders v; renderChunk() reads it back on the audio thread
+    const uint64_t start = readCycleCounter();
+    voices_[v].process(buffer, start_sample, num_samples);
+    voice_cycles_[v] = std::max<uint64_t>(readCycleCounter() - start, 1);
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::applyEvent(const clap_event_header_t& header) {
+    if (header.type == CLAP_EVENT_NOTE_ON) {
+        noteOn(reinterpret_cast<const clap_event_note_t*>(&header));
+    } else if (header.type == CLAP_EVENT_NOTE_OFF) {
+        noteOff(reinterpret_cast<const clap_event_note_t*>(&header));
+    } else if (header.type == CLAP_EVENT_NOTE_CHOKE) {
+        noteChoke(reinterpret_cast<const clap_event_note_t*>(&header));
+    } else if (header.type == CLAP_EVENT_NOTE_EXPRESSION) {
+        const auto* expr_event = reinterpret_cast<const clap_event_note_expression_t*>(&header);
+        // Apply expression to all matching voices (supports wildcards)
+        const auto found = findMatchingVoices(expr_event->key, expr_event->note_id, expr_event->port_index,
+                                              expr_event->channel, false,
+                                              [](const VoiceStatus& status) { return status.active; });
+        // Cast from CLAP expression ID to our enum (values match by design)
+        const auto expression_id = static_cast<Note::Expression>(expr_event->expression_id);
+        for (size_t v = 0; v < found.size; ++v) {
+            auto& voice = voices_[found.voices[v]];
+            // Update note data
+            voice.note_.applyExpression(expression_id, expr_event->value);
+            // Notify voice so it can update cached values (e.g. phase increment)
+            voice.onExpressionChange(expression_id, expr_event->value);
+        }
+    } else if (header.type == CLAP_EVENT_PARAM_MOD && mod_matrix_) {
+        // Per-note host modulation becomes a per-voice offset in the matrix; global modulation is the
+        // ParamsExtension's
+        const auto* mod_event = reinterpret_cast<const clap_event_param_mod_t*>(&header);
+        if (const auto dst = mod_matrix_->findHostModDestination(*mod_event)) {
+            const auto found = findMatchingVoices(mod_event->key, mod_event->note_id, mod_event->port_index,
+                                                  mod_event->channel, false,
+                                                  [](const VoiceStatus& status) { return status.active; });
+            for (size_t v = 0; v < found.size; ++v) {
+                mod_matrix_->setHostPolyModulation(*dst, found.voices[v], static_cast<float>(mod_event->amount));
+            }
         }
     }
 }
 
 template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
 void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::process(BufferView<T, MaxChannels> buffer,
-                                                                const clap_input_events_t* events) {
+                                                                const clap_input_events_t* events,
+                                                                const clap_output_events_t* out_events) {
+    const uint64_t block_start = profiling() ? readCycleCounter() : 0;
+    const uint64_t first_sub_block = sub_block_count_;
     buffer.clear();
+    output_silent_ = true;
+    if (render_factor_ > 1) {
+        oversampled_block_ = oversampler_.oversampledBuffer(buffer.numChannels(), buffer.numFrames());
+        oversampled_block_.clear();
+    }
 
     const uint32_t total_frames = buffer.numFrames();
     uint32_t current_sample = 0;
+    out_events_ = out_events;
+    note_end_time_ = 0;
 
     if (events) {
         const uint32_t event_count = events->size(events);
@@ -285,48 +990,218 @@ void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::process(BufferView<T, Ma
             }
 
             const uint32_t event_time = std::min(header->time, total_frames);
+            const bool note_on = startsNote(*header);
 
-            // Render chunk before this event
+            // Render chunk before this event. Events closer than min_sub_block_ to the start of the pending
+            // chunk are applied at its start instead, unless they're note-ons and those stay sample-accurate.
             if (event_time > current_sample) {
-                const int num_samples = event_time - current_sample;
-                renderSubBlock(buffer, static_cast<int>(current_sample), num_samples);
-            }
-
-            // Handle note events
-            if (header->type == CLAP_EVENT_NOTE_ON) {
-                const auto* note_event = reinterpret_cast<const clap_event_note_t*>(header);
-                noteOn(note_event);
-            } else if (header->type == CLAP_EVENT_NOTE_OFF) {
-                const auto* note_event = reinterpret_cast<const clap_event_note_t*>(header);
-                noteOff(note_event);
-            } else if (header->type == CLAP_EVENT_NOTE_CHOKE) {
-                const auto* note_event = reinterpret_cast<const clap_event_note_t*>(header);
-                noteChoke(note_event);
-            } else if (header->type == CLAP_EVENT_NOTE_EXPRESSION) {
-                const auto* expr_event = reinterpret_cast<const clap_event_note_expression_t*>(header);
-                // Apply expression to all matching voices (supports wildcards)
-                for (auto& voice : voices_) {
-                    if (voice.active_ &&
-                        voice.note_.matches(expr_event->key, expr_event->note_id, expr_event->port_index,
-                                            expr_event->channel)) {
-                        // Cast from CLAP expression ID to our enum (values match by design)
-                        auto expression_id = static_cast<Note::Expression>(expr_event->expression_id);
-                        // Update note data
-                        voice.note_.applyExpression(expression_id, expr_event->value);
-                        // Notify voice so it can update cached values (e.g. phase increment)
-                        voice.onExpressionChange(expression_id, expr_event->value);
-                    }
+                const bool exact = sample_accurate_note_ons_ && note_on;
+                if (event_time - current_sample >= min_sub_block_ || exact) {
+                    renderChunk(buffer, static_cast<int>(current_sample),
+                                static_cast<int>(event_time - current_sample));
+                    current_sample = event_time;
+                } else {
+                    ++quantized_event_count_;
                 }
             }
+            // Voices freed by this event (steals, chokes) end where it is applied
+            note_end_time_ = std::min(current_sample, total_frames > 0 ? total_frames - 1 : 0);
 
-            current_sample = event_time;
+            // A chord at full polyphony: choose all its victims from one candidate heap
+            if (note_on && num_free_ == 0 && next_steal_ == num_steals_) {
+                reclaimFinishedVoices();
+                const size_t chord = countNoteOnsAt(events, i, header->time);
+                if (chord > num_free_) planSteals(chord - num_free_);
+            }
+            if (MidiDecoder::isMidi(*header)) {
+                midi_decoder_.decode(*header, [this](const clap_event_header_t& note_event) { applyEvent(note_event); });
+            } else {
+                applyEvent(*header);
+            }
         }
     }
 
     // Render remaining samples after last event
     if (current_sample < total_frames) {
-        const int num_samples = total_frames - current_sample;
-        renderSubBlock(buffer, static_cast<int>(current_sample), num_samples);
+        renderChunk(buffer, static_cast<int>(current_sample), static_cast<int>(total_frames - current_sample));
+    }
+    if (render_factor_ > 1) decimate(buffer);
+    updateSilence(buffer);
+    out_events_ = nullptr;
+
+    if (profiling()) {
+        profiler_->record({SynthProfileEvent::Type::Block, 0, static_cast<uint32_t>(sub_block_count_ - first_sub_block),
+                           0, total_frames, readCycleCounter() - block_start, profiled_blocks_++});
+    }
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::renderChunk(BufferView<T, MaxChannels> buffer,
+                                                                   int start_sample,
+                                                                   int num_samples) {
+    // Voices see positions in the buffer they render into; NOTE_END times stay at the host's rate
+    const auto factor = static_cast<int>(render_factor_);
+    const BufferView<T, MaxChannels> target = factor > 1 ? oversampled_block_ : buffer;
+    const int render_start = start_sample * factor;
+    const int render_samples = num_samples * factor;
+    if (mod_matrix_) {
+        for (size_t i = 0; i < num_active_; ++i) {
+            const uint16_t v = active_voices_[i];
+            if (!isFinished(voices_.status[v])) {
+                voices_[v].updateModSources(*mod_matrix_, render_start, render_samples);
+            }
+        }
+        if (parallel_pool_) {
+            mod_matrix_->processParallel(*parallel_pool_);
+        } else {
+            mod_matrix_->process();
+        }
+    }
+    num_steals_ = next_steal_ = 0;  // voice states move on, so plans don't outlive their chord
+
+    // With no voice sounding the cleared output is already right, so idle instances skip rendering entirely
+    if (num_active_ == 0) return;
+    output_silent_ = false;
+    if (!profiling()) {
+        renderSubBlock(target, render_start, render_samples);
+    } else {
+        const uint64_t start = readCycleCounter();
+        renderSubBlock(target, render_start, render_samples);
+        const uint64_t cycles = readCycleCounter() - start;
+        const auto start_u = static_cast<uint32_t>(render_start);
+        const auto num_u = static_cast<uint32_t>(render_samples);
+        for (uint16_t v = 0; v < NumVoices; ++v) {
+            if (voice_cycles_[v] == 0) continue;
+            profiler_->record(
+                {SynthProfileEvent::Type::Voice, v, 0, start_u, num_u, voice_cycles_[v], profiled_blocks_});
+            voice_cycles_[v] = 0;
+        }
+        profiler_->record({SynthProfileEvent::Type::SubBlock, 0, 0, start_u, num_u, cycles, profiled_blocks_});
+    }
+    ++sub_block_count_;
+    // Event times must lie inside the block, so voices that finish in the last sub-block end on its last frame
+    note_end_time_ = static_cast<uint32_t>(std::min<size_t>(start_sample + num_samples, buffer.numFrames() - 1));
+    reclaimFinishedVoices();
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::decimate(BufferView<T, MaxChannels> buffer) noexcept {
+    // Once the voices have been quiet for the filters' tail, their history is all zeros and so is the output
+    if (!output_silent_) decimator_quiet_frames_ = 0;
+    if (!isDecimatorRinging()) return;
+    oversampler_.downsample(buffer);
+    decimator_quiet_frames_ += buffer.numFrames();
+    output_silent_ = false;
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::updateSilence(BufferView<T, MaxChannels> buffer) noexcept {
+    if (silence_threshold_ <= T(0)) return;
+    if (!output_silent_) {
+        T peak = T(0);
+        for (size_t ch = 0; ch < buffer.numChannels(); ++ch) {
+            for (const T sample : buffer.channelSampleSpan(ch)) peak = std::max(peak, std::abs(sample));
+        }
+        if (peak >= silence_threshold_) {
+            quiet_frames_ = 0;
+            return;
+        }
+    }
+    quiet_frames_ += buffer.numFrames();
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+ProcessStatus Synthesizer<T, MaxChannels, NumVoices, VoiceType>::getProcessStatus() const noexcept {
+    if (num_active_ == 0) return isDecimatorRinging() ? ProcessStatus::Continue : ProcessStatus::Sleep;
+    if (silence_threshold_ <= T(0) || quiet_frames_ < silence_hold_frames_) return ProcessStatus::Continue;
+    for (size_t i = 0; i < num_active_; ++i) {
+        if (voices_.status[active_voices_[i]].state != VoiceState::Released) {
+            return ProcessStatus::Continue;
+        }
+    }
+    return ProcessStatus::ContinueIfNotQuiet;
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::setModMatrix(ModMatrix* matrix) {
+    ASSERT(!matrix || matrix->getConfig().num_voices >= NumVoices, "ModMatrix has fewer voices than the Synthesizer");
+    if (matrix == mod_matrix_) return;
+    for (size_t i = 0; i < num_active_; ++i) {
+        if (mod_matrix_) mod_matrix_->notifyVoiceOff(active_voices_[i]);
+        if (matrix) matrix->notifyVoiceOn(active_voices_[i]);
+    }
+    mod_matrix_ = matrix;
+    for (auto& voice : voices_) voice.mod_matrix_ = matrix;
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::processParallel(BufferView<T, MaxChannels> buffer,
+                                                                        const clap_input_events_t* events,
+                                                                        ThreadPoolExtension& pool,
+                                                                        uint32_t voices_per_task,
+                                                                        const clap_output_events_t* out_events) {
+    ASSERT(voices_per_task > 0, "voices_per_task must be positive");
+    parallel_pool_ = &pool;
+    parallel_voices_per_task_ = voices_per_task;
+    auto previous = pool.exchangeCallback([this](uint32_t task) {
+        const uint32_t first = task * parallel_voices_per_task_;
+        renderScratchVoices(first, std::min(first + parallel_voices_per_task_, parallel_count_));
+    });
+    process(buffer, events, out_events);
+    pool.exchangeCallback(std::move(previous));
+    parallel_pool_ = nullptr;
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::renderVoicesParallel(BufferView<T, MaxChannels> buffer,
+                                                                            int start_sample,
+                                                                            int num_samples) {
+    parallel_count_ = 0;
+    for (uint16_t v = 0; v < NumVoices; ++v) {
+        if (voices_.status[v].active) parallel_voices_[parallel_count_++] = v;
+    }
+    if (parallel_count_ == 0) return;
+
+    parallel_channels_ = buffer.numChannels();
+    parallel_frames_ = buffer.numFrames();
+    parallel_start_ = start_sample;
+    parallel_num_samples_ = num_samples;
+
+    const uint32_t num_tasks = (parallel_count_ + parallel_voices_per_task_ - 1) / parallel_voices_per_task_;
+    const bool done = num_tasks > 1 && parallel_pool_->hasParallelSupport() && parallel_pool_->requestExec(num_tasks);
+    if (!done) renderScratchVoices(0, parallel_count_);
+
+    // Sum in voice order whichever thread rendered each voice, so the output doesn't depend on the schedule
+    const auto start = static_cast<size_t>(start_sample);
+    const auto count = static_cast<size_t>(num_samples);
+    for (size_t ch = 0; ch < parallel_channels_; ++ch) {
+        T* out = buffer.channelSamples(ch);
+        if (!out) continue;
+        for (uint32_t i = 0; i < parallel_count_; ++i) {
+            addSamples(out + start, scratchView(parallel_voices_[i]).channelSamples(ch) + start, count);
+        }
+    }
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::renderScratchVoices(uint32_t first, uint32_t last) {
+    for (uint32_t i = first; i < last; ++i) {
+        const uint16_t v = parallel_voices_[i];
+        const auto scratch = scratchView(v);
+        for (size_t ch = 0; ch < parallel_channels_; ++ch) {
+            std::fill_n(scratch.channelSamples(ch) + parallel_start_, parallel_num_samples_, T(0));
+        }
+        renderVoice(v, scratch, parallel_start_, parallel_num_samples_);
+    }
+}
+
+template <Scalar T, size_t MaxChannels, size_t NumVoices, typename VoiceType>
+void Synthesizer<T, MaxChannels, NumVoices, VoiceType>::addSamples(T* dst, const T* src, size_t count) noexcept {
+    using Batch = xsimd::batch<T>;
+    size_t i = 0;
+    for (; i + Batch::size <= count; i += Batch::size) {
+        (Batch::load_unaligned(dst + i) + Batch::load_unaligned(src + i)).store_unaligned(dst + i);
     }
+    for (; i < count; ++i) dst[i] += src[i];
 }
 }  // namespace applause
@@ -0,0 +1 @@
+#include "UnisonVoice.h"
\ No newline at end of file
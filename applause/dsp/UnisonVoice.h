@@ -0,0 +1,131 @@
+#pragma once
+#include <applause/dsp/Synthesizer.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <span>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * A voice that plays its note as a stack of unison sub-voices, e.g. a supersaw. The note, its expressions, and
+ * whatever the voice computes at control rate (envelopes, modulation, filter coefficients) are shared by the whole
+ * stack and computed once per sub-block in updateControl(). The sub-voices only differ in detune and pan.
+ *
+ * Sub-voices are packed one per SIMD lane: sub-voice i is lane i % kLanes of stack batch i / kLanes, and
+ * renderStack() renders a whole batch of them at once. UnisonVoice then pans each lane and sums the stack into
+ * the output's first two channels (or the first, for mono outputs). Lanes past the unison count are silenced, so
+ * renderStack() can run every lane unmasked.
+ *
+ * Use it as a Synthesizer's VoiceType like any other voice: the Synthesizer still allocates one voice per note.
+ *
+ * @tparam T The sample type (float or double)
+ * @tparam MaxChannels The maximum number of channels supported by the DSP system
+ * @tparam MaxUnison The largest unison count the voice supports
+ */
+template <Scalar T, size_t MaxChannels, size_t MaxUnison>
+class UnisonVoice : public SynthesizerVoice<T, MaxChannels> {
+public:
+    using Batch = xsimd::batch<T>;
+    static constexpr size_t kLanes = Batch::size;
+    static constexpr size_t kNumBatches = (MaxUnison + kLanes - 1) / kLanes;
+    static_assert(MaxUnison > 0, "MaxUnison must be positive");
+
+    UnisonVoice() { setUnison(1, T(0), T(0)); }
+
+    /**
+     * Sets the stack: count sub-voices, detuned evenly across +-detune_semitones and panned evenly across
+     * +-stereo_spread (0 = all centered, 1 = outermost sub-voices hard left and right). Takes effect immediately;
+     * call from noteOn() or between blocks.
+     */
+    void setUnison(size_t count, T detune_semitones, T stereo_spread) {
+        ASSERT(count > 0 && count <= MaxUnison, "Unison count out of range");
+        unison_count_ = std::clamp<size_t>(count, 1, MaxUnison);
+
+        // Equal-power pan law, normalized so a lone centered voice has unity gain and a stack of uncorrelated
+        // sub-voices keeps roughly the same loudness as the count changes
+        const T norm = std::numbers::sqrt2_v<T> / std::sqrt(static_cast<T>(unison_count_));
+        for (size_t i = 0; i < kNumBatches * kLanes; ++i) {
+            if (i >= unison_count_) {
+                ratios_[i] = T(1);
+                gains_left_[i] = gains_right_[i] = T(0);
+                continue;
+            }
+            const T position = unison_count_ > 1 ? T(2) * static_cast<T>(i) / static_cast<T>(unison_count_ - 1) - T(1)
+                                                 : T(0);
+            ratios_[i] = std::exp2(position * detune_semitones / T(12));
+            const T angle = (position * stereo_spread + T(1)) * std::numbers::pi_v<T> / T(4);
+            gains_left_[i] = std::cos(angle) * norm;
+            gains_right_[i] = std::sin(angle) * norm;
+        }
+    }
+
+    [[nodiscard]] size_t getUnisonCount() const noexcept { return unison_count_; }
+
+    /** Number of stack batches renderStack() is called for: the unison count in lanes, rounded up. */
+    [[nodiscard]] size_t getNumStackBatches() const noexcept { return (unison_count_ + kLanes - 1) / kLanes; }
+
+    /** Frequency ratio of each sub-voice in a stack batch, relative to the note's frequency. */
+    [[nodiscard]] Batch getDetuneRatios(size_t batch) const noexcept {
+        return Batch::load_aligned(&ratios_[batch * kLanes]);
+    }
+
+    void process(BufferView<T, MaxChannels> buffer, int start_sample, int num_samples) final {
+        if (buffer.numChannels() == 0) return;
+        updateControl(start_sample, num_samples);
+
+        const size_t num_batches = getNumStackBatches();
+        const bool stereo = buffer.numChannels() > 1;
+        T* left = buffer.channelSamples(0) + start_sample;
+        T* right = stereo ? buffer.channelSamples(1) + start_sample : nullptr;
+
+        for (int offset = 0; offset < num_samples; offset += static_cast<int>(kChunk)) {
+            const auto frames = std::min<size_t>(kChunk, static_cast<size_t>(num_samples - offset));
+            for (size_t b = 0; b < num_batches; ++b) {
+                const std::span<Batch> out(scratch_.data(), frames);
+                std::fill(out.begin(), out.end(), Batch(T(0)));
+                renderStack(b, out);
+
+                const auto gain_left = Batch::load_aligned(&gains_left_[b * kLanes]);
+                const auto gain_right = Batch::load_aligned(&gains_right_[b * kLanes]);
+                for (size_t i = 0; i < frames; ++i) {
+                    if (stereo) {
+                        left[offset + i] += xsimd::reduce_add(out[i] * gain_left);
+                        right[offset + i] += xsimd::reduce_add(out[i] * gain_right);
+                    } else {
+                        left[offset + i] += xsimd::reduce_add(out[i] * (gain_left + gain_right)) * T(0.5);
+                    }
+                }
+            }
+        }
+    }
+
+protected:
+    /**
+     * Computes the stack's shared control-rate state for the sub-block starting at start_sample, once per
+     * sub-block however many sub-voices there are. Voices that call terminateVoice() usually do so here.
+     */
+    virtual void updateControl(int start_sample, int num_samples) {}
+
+    /**
+     * Renders stack batch batch: out[i] holds one frame for the batch's sub-voices, one per lane. out covers the
+     * next out.size() frames of the sub-block; the sub-block is rendered in several calls when it's longer than
+     * the voice's internal chunk. Per-sub-voice state (e.g. oscillator phases) belongs in per-batch Batch members.
+     */
+    virtual void renderStack(size_t batch, std::span<Batch> out) = 0;
+
+private:
+    static constexpr size_t kChunk = 64;
+
+    size_t unison_count_ = 1;
+    alignas(Batch) std::array<T, kNumBatches * kLanes> ratios_{};
+    alignas(Batch) std::array<T, kNumBatches * kLanes> gains_left_{};
+    alignas(Batch) std::array<T, kNumBatches * kLanes> gains_right_{};
+    std::array<Batch, kChunk> scratch_{};
+};
+
+}  // namespace applause
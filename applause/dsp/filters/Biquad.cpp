@@ -0,0 +1,158 @@
+#include "Biquad.h"
+
+#include <applause/dsp/FastMath.h>
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+BiquadCoefficients BiquadCoefficients::design(const BiquadBand& band, double sample_rate) noexcept {
+    ASSERT(sample_rate > 0.0, "Sample rate must be positive");
+    ASSERT(band.q > 0.0, "Q must be positive");
+    if (!band.enabled) return {};
+
+    const double frequency = std::clamp(band.frequency, 1e-3, sample_rate * 0.4999);
+    const double w0 = 2.0 * std::numbers::pi * frequency / sample_rate;
+    const double cos_w0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * band.q);
+    const double a = std::pow(10.0, band.gain_db / 40.0);
+    const double shelf = 2.0 * std::sqrt(a) * alpha;
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+    switch (band.type) {
+    case BiquadType::Peak:
+        b0 = 1.0 + alpha * a;
+        b1 = -2.0 * cos_w0;
+        b2 = 1.0 - alpha * a;
+        a0 = 1.0 + alpha / a;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha / a;
+        break;
+    case BiquadType::LowShelf:
+        b0 = a * ((a + 1.0) - (a - 1.0) * cos_w0 + shelf);
+        b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cos_w0);
+        b2 = a * ((a + 1.0) - (a - 1.0) * cos_w0 - shelf);
+        a0 = (a + 1.0) + (a - 1.0) * cos_w0 + shelf;
+        a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cos_w0);
+        a2 = (a + 1.0) + (a - 1.0) * cos_w0 - shelf;
+        break;
+    case BiquadType::HighShelf:
+        b0 = a * ((a + 1.0) + (a - 1.0) * cos_w0 + shelf);
+        b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cos_w0);
+        b2 = a * ((a + 1.0) + (a - 1.0) * cos_w0 - shelf);
+        a0 = (a + 1.0) - (a - 1.0) * cos_w0 + shelf;
+        a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cos_w0);
+        a2 = (a + 1.0) - (a - 1.0) * cos_w0 - shelf;
+        break;
+    case BiquadType::Lowpass:
+        b0 = (1.0 - cos_w0) / 2.0;
+        b1 = 1.0 - cos_w0;
+        b2 = b0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
+        break;
+    case BiquadType::Highpass:
+        b0 = (1.0 + cos_w0) / 2.0;
+        b1 = -(1.0 + cos_w0);
+        b2 = b0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
+        break;
+    case BiquadType::Bandpass:
+        b0 = alpha;
+        b2 = -alpha;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
+        break;
+    case BiquadType::Notch:
+        b0 = 1.0;
+        b1 = -2.0 * cos_w0;
+        b2 = 1.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
+        break;
+    case BiquadType::Allpass:
+        b0 = 1.0 - alpha;
+        b1 = -2.0 * cos_w0;
+        b2 = 1.0 + alpha;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
+        break;
+    }
+    return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+}
+
+double BiquadCoefficients::magnitudeSquared(double frequency, double sample_rate) const noexcept {
+    const double w = 2.0 * std::numbers::pi * frequency / sample_rate;
+    const double cos_w = std::cos(w);
+    const double cos_2w = std::cos(2.0 * w);
+    const double num = b0 * b0 + b1 * b1 + b2 * b2 + 2.0 * (b0 * b1 + b1 * b2) * cos_w + 2.0 * b0 * b2 * cos_2w;
+    const double den = 1.0 + a1 * a1 + a2 * a2 + 2.0 * (a1 + a1 * a2) * cos_w + 2.0 * a2 * cos_2w;
+    return num / den;
+}
+
+namespace {
+// |H|^2 as polynomials in phi = sin^2(w / 2): (n0 + n1 phi + n2 phi^2) / (d0 + d1 phi + d2 phi^2). Expanded in
+// double once per band, this keeps the cancellation of e.g. a highpass far below its cutoff out of the float sums.
+struct PowerTerms {
+    float n0, n1, n2, d0, d1, d2;
+};
+
+template <typename V>
+V responseDb(std::span<const PowerTerms> terms, V frequency, float radians_per_hz) noexcept {
+    const V s = math::sin(frequency * V(0.5f * radians_per_hz));
+    const V phi = s * s;
+    constexpr float kFloor = 1e-30f;  // -300 dB
+    V log2_power(0.0f);
+    for (const auto& t : terms) {
+        const V num = applause::fma(applause::fma(V(t.n2), phi, V(t.n1)), phi, V(t.n0));
+        const V den = applause::fma(applause::fma(V(t.d2), phi, V(t.d1)), phi, V(t.d0));
+        log2_power += math::log2(applause::max(num / den, V(kFloor)));
+    }
+    constexpr float kDbPerLog2Power = 3.01029995664f;  // 10 log10(2)
+    return applause::max(log2_power * V(kDbPerLog2Power), V(-300.0f));
+}
+}  // namespace
+
+void magnitudeResponseDb(std::span<const BiquadCoefficients> bands, double sample_rate,
+                         std::span<const float> frequencies, std::span<float> magnitudes_db) noexcept {
+    ASSERT(magnitudes_db.size() >= frequencies.size(), "magnitudeResponseDb: output shorter than frequencies");
+    constexpr size_t kMaxTerms = 64;
+    std::array<PowerTerms, kMaxTerms> storage{};
+    size_t count = 0;
+    for (const auto& c : bands) {
+        if (c == BiquadCoefficients{}) continue;
+        ASSERT(count < kMaxTerms, "magnitudeResponseDb: too many bands");
+        const double b_sum = c.b0 + c.b1 + c.b2;
+        const double a_sum = 1.0 + c.a1 + c.a2;
+        storage[count++] = {static_cast<float>(b_sum * b_sum),
+                            static_cast<float>(-4.0 * (c.b0 * c.b1 + c.b1 * c.b2 + 4.0 * c.b0 * c.b2)),
+                            static_cast<float>(16.0 * c.b0 * c.b2),
+                            static_cast<float>(a_sum * a_sum),
+                            static_cast<float>(-4.0 * (c.a1 + c.a1 * c.a2 + 4.0 * c.a2)),
+                            static_cast<float>(16.0 * c.a2)};
+    }
+    const std::span<const PowerTerms> terms(storage.data(), count);
+    const auto radians_per_hz = static_cast<float>(2.0 * std::numbers::pi / sample_rate);
+
+    using Batch = xsimd::batch<float>;
+    size_t i = 0;
+    for (; i + Batch::size <= frequencies.size(); i += Batch::size) {
+        responseDb(terms, Batch::load_unaligned(frequencies.data() + i), radians_per_hz)
+            .store_unaligned(magnitudes_db.data() + i);
+    }
+    for (; i < frequencies.size(); ++i) magnitudes_db[i] = responseDb(terms, frequencies[i], radians_per_hz);
+}
+
+}  // namespace applause
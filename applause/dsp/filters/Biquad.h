@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace applause {
+
+/** The response of one biquad band, after the RBJ Audio EQ Cookbook. */
+enum class BiquadType : uint8_t {
+    Peak,       ///< Bell boosting or cutting gain_db around frequency
+    LowShelf,   ///< Boosts or cuts gain_db below frequency
+    HighShelf,  ///< Boosts or cuts gain_db above frequency
+    Lowpass,
+    Highpass,
+    Bandpass,   ///< Unity gain at frequency
+    Notch,
+    Allpass,
+};
+
+/** One band's parameters, in plain units. */
+struct BiquadBand {
+    BiquadType type = BiquadType::Peak;
+    double frequency = 1000.0;  ///< Hz; clamped to just below Nyquist
+    double q = 0.70710678118654752440;
+    double gain_db = 0.0;  ///< Peak and shelf bands only
+    bool enabled = true;   ///< A disabled band passes its input through
+
+    bool operator==(const BiquadBand&) const = default;
+};
+
+/**
+ * @brief Normalized biquad coefficients: H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+ *
+ * design() is what BiquadCascade runs on the audio thread, so an editor that designs the same bands gets bit-identical
+ * coefficients, and magnitudeResponseDb() draws exactly what the DSP does.
+ */
+struct BiquadCoefficients {
+    double b0 = 1.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+
+    /** Designs band at sample_rate. Doesn't allocate; safe on the audio thread. */
+    [[nodiscard]] static BiquadCoefficients design(const BiquadBand& band, double sample_rate) noexcept;
+
+    /** |H|^2 at frequency in Hz. */
+    [[nodiscard]] double magnitudeSquared(double frequency, double sample_rate) const noexcept;
+
+    bool operator==(const BiquadCoefficients&) const = default;
+};
+
+/**
+ * Writes the cascade's magnitude response in dB at each of frequencies (Hz) to magnitudes_db, e.g. for an EQ curve.
+ * Evaluated in SIMD over the frequencies with math::sin and math::log2, to within 1e-3 dB; fine for a few hundred
+ * points per frame. Responses are floored at -300 dB.
+ */
+void magnitudeResponseDb(std::span<const BiquadCoefficients> bands, double sample_rate,
+                         std::span<const float> frequencies, std::span<float> magnitudes_db) noexcept;
+
+}  // namespace applause
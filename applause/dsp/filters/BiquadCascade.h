@@ -0,0 +1,281 @@
+#pragma once
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/filters/Biquad.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/SampleType.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * @brief Up to MaxBands biquads in series, such as a parametric EQ, shared by up to MaxChannels channels.
+ *
+ * Each band is a transposed direct form II biquad, designed from a BiquadBand with BiquadCoefficients::design().
+ * Bands run one after another over a whole chunk of the block, so each band's coefficients stay in registers and
+ * only its two state values are loop-carried.
+ *
+ * With float or double samples, processBlock() packs the channels into SIMD lanes, a frame per batch, so a
+ * multichannel EQ costs about as much as a mono one (the pattern StateVariableFilter::processBlock() uses). With a
+ * SIMD sample type the lanes are already voices, and the channels run one after another. A band's series
+ * dependency keeps bands themselves out of the lanes.
+ *
+ * setBand() takes effect at the next processBlock(), whose coefficients ramp linearly from the old band to the new
+ * one across the block. The stability region of (a1, a2) is a triangle, so every coefficient set on the way between
+ * two stable bands is stable too, and sweeps don't click. Bands that are disabled and settled are skipped.
+ *
+ * magnitudeResponseDb() draws the response from the coefficients being ramped to; an editor can equally design the
+ * same bands itself and call the free magnitudeResponseDb(), without touching the audio thread's cascade.
+ *
+ * @code
+ * // activate()
+ * eq_.init(sample_rate);
+ *
+ * // process(), after reading the parameters
+ * for (size_t b = 0; b < 8; ++b) eq_.setBand(b, {.type = types[b], .frequency = hz[b], .q = q[b], .gain_db = db[b]});
+ * eq_.processBlock(context.output<float, 2>());
+ * @endcode
+ *
+ * @tparam S The sample type (scalar or SIMD batch)
+ * @tparam MaxBands The most bands the cascade can hold
+ * @tparam MaxChannels The number of independent channels of filter state
+ */
+template <Sample S = float, size_t MaxBands = 16, size_t MaxChannels = 2>
+class BiquadCascade {
+public:
+    using SampleType = S;
+    using ScalarType = scalar_t<S>;
+
+    static constexpr size_t max_band_count = MaxBands;
+    static constexpr size_t max_channel_count = MaxChannels;
+
+    static_assert(MaxBands >= 1, "The cascade needs at least one band");
+
+    BiquadCascade() {
+        for (auto& band : bands_) band.enabled = false;
+        reset();
+    }
+
+    /** Sets the sample rate, redesigns every band, snaps the coefficients to it, and clears the filter state. */
+    void init(double sample_rate) {
+        ASSERT(sample_rate > 0.0, "Sample rate must be positive");
+        sample_rate_ = sample_rate;
+        for (size_t b = 0; b < MaxBands; ++b) {
+            target_[b] = BiquadCoefficients::design(bands_[b], sample_rate_);
+            current_[b] = toStage(target_[b]);
+        }
+        ramping_ = false;
+        reset();
+    }
+
+    void reset() {
+        for (auto& channel : z1_) channel.fill(S(ScalarType(0)));
+        for (auto& channel : z2_) channel.fill(S(ScalarType(0)));
+    }
+
+    /** Replaces band b's parameters, ramping to them over the next processBlock(). */
+    void setBand(size_t b, const BiquadBand& band) noexcept {
+        ASSERT(b < MaxBands, "Band index out of range");
+        if (band == bands_[b]) return;
+        bands_[b] = band;
+        num_bands_ = std::max(num_bands_, b + 1);
+        if (sample_rate_ > 0.0) {
+            target_[b] = BiquadCoefficients::design(band, sample_rate_);
+            ramping_ = true;
+        }
+    }
+
+    [[nodiscard]] const BiquadBand& getBand(size_t b) const noexcept {
+        ASSERT(b < MaxBands, "Band index out of range");
+        return bands_[b];
+    }
+
+    /** The coefficients band b is at, or ramping to. */
+    [[nodiscard]] const BiquadCoefficients& getCoefficients(size_t b) const noexcept {
+        ASSERT(b < MaxBands, "Band index out of range");
+        return target_[b];
+    }
+
+    /** Bands up to the highest one ever set; the rest pass their input through. */
+    [[nodiscard]] size_t numBands() const noexcept { return num_bands_; }
+
+    /** Writes the cascade's response in dB at each of frequencies (Hz) to magnitudes_db. */
+    void magnitudeResponseDb(std::span<const float> frequencies, std::span<float> magnitudes_db) const noexcept {
+        applause::magnitudeResponseDb(std::span(target_.data(), num_bands_), sample_rate_, frequencies,
+                                      magnitudes_db);
+    }
+
+    /** Filters buffer in place through every band. */
+    void processBlock(BufferView<S, MaxChannels> buffer) noexcept {
+        ASSERT(sample_rate_ > 0.0, "BiquadCascade: call init() before processing");
+        const size_t num_frames = buffer.numFrames();
+        if (num_frames == 0) return;
+
+        std::array<Ramp, MaxBands> ramps{};
+        for (size_t b = 0; b < num_bands_; ++b) ramps[b] = makeRamp(b, num_frames);
+
+        const size_t num_channels = buffer.numChannels();
+        if constexpr (SimdBatch<SampleType>) {
+            for (size_t ch = 0; ch < num_channels; ++ch) {
+                S* samples = buffer.channelSamples(ch);
+                std::array<Ramp, MaxBands> channel_ramps = ramps;
+                for (size_t b = 0; b < num_bands_; ++b) {
+                    if (channel_ramps[b].active) runBand(channel_ramps[b], samples, num_frames, z1_[ch][b], z2_[ch][b]);
+                }
+            }
+        } else {
+            using Batch = xsimd::batch<ScalarType>;
+            constexpr size_t lanes = Batch::size;
+            for (size_t ch = 0; ch < num_channels; ch += lanes) {
+                processLanes<Batch>(buffer, ramps, ch, std::min(lanes, num_channels - ch));
+            }
+        }
+
+        // Land exactly on the targets, rather than wherever the increments summed to
+        if (ramping_) {
+            for (size_t b = 0; b < num_bands_; ++b) current_[b] = toStage(target_[b]);
+            ramping_ = false;
+        }
+    }
+
+private:
+    static constexpr size_t kChunkFrames = 64;
+
+    struct Stage {
+        ScalarType b0 = ScalarType(1), b1 = ScalarType(0), b2 = ScalarType(0), a1 = ScalarType(0), a2 = ScalarType(0);
+    };
+
+    // A band's coefficients for this block: start values, and per-sample increments while ramping
+    struct Ramp {
+        Stage start;
+        Stage step;
+        bool ramping = false;
+        bool active = false;
+    };
+
+    [[nodiscard]] static Stage toStage(const BiquadCoefficients& c) noexcept {
+        return {static_cast<ScalarType>(c.b0), static_cast<ScalarType>(c.b1), static_cast<ScalarType>(c.b2),
+                static_cast<ScalarType>(c.a1), static_cast<ScalarType>(c.a2)};
+    }
+
+    [[nodiscard]] Ramp makeRamp(size_t b, size_t num_frames) const noexcept {
+        Ramp ramp;
+        ramp.start = current_[b];
+        const Stage target = toStage(target_[b]);
+        const auto identity = [](const Stage& s) {
+            return s.b0 == ScalarType(1) && s.b1 == ScalarType(0) && s.b2 == ScalarType(0) && s.a1 == ScalarType(0)
+                   && s.a2 == ScalarType(0);
+        };
+        if (ramping_) {
+            const auto n = static_cast<ScalarType>(num_frames);
+            ramp.step = {(target.b0 - ramp.start.b0) / n, (target.b1 - ramp.start.b1) / n,
+                         (target.b2 - ramp.start.b2) / n, (target.a1 - ramp.start.a1) / n,
+                         (target.a2 - ramp.start.a2) / n};
+            ramp.ramping = ramp.step.b0 != ScalarType(0) || ramp.step.b1 != ScalarType(0)
+                           || ramp.step.b2 != ScalarType(0) || ramp.step.a1 != ScalarType(0)
+                           || ramp.step.a2 != ScalarType(0);
+        }
+        ramp.active = ramp.ramping || !identity(ramp.start);
+        return ramp;
+    }
+
+    // One band over samples, in place. V is SampleType, or a batch of channels packed into lanes. The ramp carries
+    // over between chunks of a block.
+    template <typename V>
+    static void runBand(Ramp& ramp, V* samples, size_t num_frames, V& z1, V& z2) noexcept {
+        Stage& c = ramp.start;
+        V s1 = z1;
+        V s2 = z2;
+        if (ramp.ramping) {
+            const Stage& d = ramp.step;
+            for (size_t i = 0; i < num_frames; ++i) {
+                c.b0 += d.b0;
+                c.b1 += d.b1;
+                c.b2 += d.b2;
+                c.a1 += d.a1;
+                c.a2 += d.a2;
+                const V x = samples[i];
+                const V y = applause::fma(V(c.b0), x, s1);
+                s1 = applause::fma(V(c.b1), x, applause::fma(V(-c.a1), y, s2));
+                s2 = applause::fma(V(c.b2), x, V(-c.a2) * y);
+                samples[i] = y;
+            }
+        } else {
+            const V b0(c.b0), b1(c.b1), b2(c.b2), na1(-c.a1), na2(-c.a2);
+            for (size_t i = 0; i < num_frames; ++i) {
+                const V x = samples[i];
+                const V y = applause::fma(b0, x, s1);
+                s1 = applause::fma(b1, x, applause::fma(na1, y, s2));
+                s2 = applause::fma(b2, x, na2 * y);
+                samples[i] = y;
+            }
+        }
+        z1 = s1;
+        z2 = s2;
+    }
+
+    // Filters count (<= Batch::size) channels starting at first, one per lane, a chunk of frames at a time.
+    // Lanes past count run on zeros and are never written back.
+    template <typename Batch>
+    void processLanes(BufferView<S, MaxChannels>& buffer, const std::array<Ramp, MaxBands>& block_ramps,
+                      size_t first, size_t count) noexcept {
+        constexpr size_t lanes = Batch::size;
+        std::array<S*, lanes> channels{};
+        for (size_t lane = 0; lane < count; ++lane) channels[lane] = buffer.channelSamples(first + lane);
+
+        std::array<Batch, MaxBands> z1;
+        std::array<Batch, MaxBands> z2;
+        alignas(64) std::array<ScalarType, lanes> gather{};
+        for (size_t b = 0; b < num_bands_; ++b) {
+            for (size_t lane = 0; lane < count; ++lane) gather[lane] = z1_[first + lane][b];
+            z1[b] = Batch::load_aligned(gather.data());
+            for (size_t lane = 0; lane < count; ++lane) gather[lane] = z2_[first + lane][b];
+            z2[b] = Batch::load_aligned(gather.data());
+        }
+
+        std::array<Ramp, MaxBands> ramps = block_ramps;
+        alignas(64) std::array<Batch, kChunkFrames> frames;
+        alignas(64) std::array<ScalarType, lanes> frame{};
+        const size_t num_frames = buffer.numFrames();
+        for (size_t start = 0; start < num_frames; start += kChunkFrames) {
+            const size_t chunk = std::min(kChunkFrames, num_frames - start);
+            for (size_t i = 0; i < chunk; ++i) {
+                for (size_t lane = 0; lane < count; ++lane) frame[lane] = channels[lane][start + i];
+                frames[i] = Batch::load_aligned(frame.data());
+            }
+            for (size_t b = 0; b < num_bands_; ++b) {
+                if (ramps[b].active) runBand(ramps[b], frames.data(), chunk, z1[b], z2[b]);
+            }
+            for (size_t i = 0; i < chunk; ++i) {
+                frames[i].store_aligned(frame.data());
+                for (size_t lane = 0; lane < count; ++lane) channels[lane][start + i] = frame[lane];
+            }
+        }
+
+        for (size_t b = 0; b < num_bands_; ++b) {
+            z1[b].store_aligned(gather.data());
+            for (size_t lane = 0; lane < count; ++lane) z1_[first + lane][b] = gather[lane];
+            z2[b].store_aligned(gather.data());
+            for (size_t lane = 0; lane < count; ++lane) z2_[first + lane][b] = gather[lane];
+        }
+    }
+
+    double sample_rate_ = 0.0;
+    size_t num_bands_ = 0;
+    bool ramping_ = false;
+    std::array<BiquadBand, MaxBands> bands_{};
+    std::array<BiquadCoefficients, MaxBands> target_{};
+    std::array<Stage, MaxBands> current_{};
+
+    // Per-channel, per-band TDF-II state
+    std::array<std::array<S, MaxBands>, MaxChannels> z1_;
+    std::array<std::array<S, MaxBands>, MaxChannels> z2_;
+};
+
+}  // namespace applause
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <applause/core/ModMatrix.h>
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/filters/StateVariableFilter.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/SampleType.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * @brief NumVoices state variable filters filtered side by side, one voice per SIMD lane.
+ *
+ * Voice v is lane v % kLanes of group v / kLanes, the packing SimdSynthesizer uses for its voice groups, so group
+ * g of a bank sized like the synthesizer filters exactly the lanes SimdSynthesizer hands to its group g. Each group
+ * is a StateVariableFilter over xsimd batches: coefficients and state are stored voice-interleaved, and one tick
+ * filters kLanes voices with per-lane cutoff and Q.
+ *
+ * Per-voice parameters are set with setCutoffFrequency() and setQValue(), or read for all voices at once from
+ * ModMatrix poly destinations with loadFromModMatrix(). Either way the coefficients are recomputed lazily, for
+ * all lanes of a group at once, by update(); call it once per block after changing parameters.
+ *
+ * @code
+ * // Once per block, after mod_matrix_.process()
+ * filters_.loadFromModMatrix(mod_matrix_, cutoff_dst_, resonance_dst_);
+ * filters_.update();
+ *
+ * // In group g's process(), after rendering the oscillators into buffer
+ * filters_.process(g, buffer);
+ * @endcode
+ *
+ * @tparam S The scalar sample type (float or double); lanes are xsimd::batch<S>.
+ * @tparam NumVoices Number of voices; need not be a multiple of the lane count
+ * @tparam Type The filter type, shared by all voices
+ * @tparam MaxChannels The number of independent channels of filter state per voice
+ */
+template <Scalar S, size_t NumVoices, StateVariableFilterType Type = StateVariableFilterType::Lowpass,
+          size_t MaxChannels = 2>
+class SVFBank {
+public:
+    using Batch = xsimd::batch<S>;
+    using Filter = StateVariableFilter<Batch, Type, false, MaxChannels>;
+
+    static constexpr StateVariableFilterType filter_type = Type;
+    static constexpr size_t kLanes = Batch::size;
+    static constexpr size_t kNumGroups = (NumVoices + kLanes - 1) / kLanes;
+
+    static_assert(NumVoices >= 1, "The bank needs at least one voice");
+
+    SVFBank() {
+        cutoff_.fill(S(1000.0));
+        q_.fill(S(0.70710678118654752440));
+        mode_.fill(S(0.0));
+    }
+
+    /** Sets the sample rate of every group, updates coefficients, and clears the filter state. */
+    void init(double sample_rate) {
+        for (auto& filter : filters_) filter.init(sample_rate);
+        max_cutoff_ = std::nextafter(static_cast<S>(sample_rate * 0.4999), S(0.0));
+        dirty_ = true;
+        update();
+    }
+
+    void reset() {
+        for (auto& filter : filters_) filter.reset();
+    }
+
+    /** Clears one voice's state, e.g. on its note-on, without touching the other voices. */
+    void resetVoice(size_t voice) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        filters_[voice / kLanes].resetLane(voice % kLanes);
+    }
+
+    /** Sets a voice's cutoff in Hz; values at or above Nyquist are clamped just below it. Takes effect in update(). */
+    void setCutoffFrequency(size_t voice, S frequency) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        ASSERT(frequency >= S(0.0), "Frequency must be non-negative");
+        cutoff_[voice] = frequency;
+        dirty_ = true;
+    }
+
+    /** Sets a voice's Q. Takes effect in update(). */
+    void setQValue(size_t voice, S q) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        ASSERT(q > S(0.0), "Q must be positive");
+        q_[voice] = q;
+        dirty_ = true;
+    }
+
+    /** Sets a voice's response, see StateVariableFilter::setMode(). Takes effect in update(). */
+    void setMode(size_t voice, S mode)
+        requires (Type == StateVariableFilterType::MultiMode)
+    {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        ASSERT(mode >= S(0.0) && mode <= S(1.0), "Mode must be in [0, 1]");
+        mode_[voice] = mode;
+        dirty_ = true;
+    }
+
+    [[nodiscard]] S getCutoffFrequency(size_t voice) const noexcept { return cutoff_[voice]; }
+
+    [[nodiscard]] S getResonance(size_t voice) const noexcept { return q_[voice]; }
+
+    /**
+     * Reads every voice's cutoff, and optionally Q, from the modulated values of ModMatrix poly destinations, in
+     * plain units. Bank voice v reads matrix voice first_voice + v; voices past the matrix's voice count keep their
+     * parameters. Call after ModMatrix::process(). Takes effect in update().
+     */
+    void loadFromModMatrix(const ModMatrix& matrix, uint16_t cutoff_dst, std::optional<uint16_t> q_dst = {},
+                           uint16_t first_voice = 0) {
+        const size_t num_voices = matrix.getConfig().num_voices;
+        const size_t count = first_voice < num_voices ? std::min(NumVoices, num_voices - first_voice) : 0;
+        for (size_t v = 0; v < count; ++v) {
+            const auto voice = static_cast<uint16_t>(first_voice + v);
+            cutoff_[v] = std::max(static_cast<S>(matrix.getPolyModValue(cutoff_dst, voice)), S(0.0));
+            if (q_dst) {
+                const auto q = static_cast<S>(matrix.getPolyModValue(*q_dst, voice));
+                ASSERT(q > S(0.0), "Q must be positive");
+                q_[v] = q;
+            }
+        }
+        dirty_ = dirty_ || count > 0;
+    }
+
+    /** Recomputes the coefficients of every group if a parameter changed since the last update. */
+    void update() {
+        if (!dirty_ || max_cutoff_ <= S(0.0)) return;
+        dirty_ = false;
+        for (size_t g = 0; g < kNumGroups; ++g) {
+            const size_t first = g * kLanes;
+            auto& filter = filters_[g];
+            filter.template setQValue<false>(Batch::load_aligned(q_.data() + first));
+            filter.setCutoffFrequency(xsimd::min(Batch::load_aligned(cutoff_.data() + first), Batch(max_cutoff_)));
+            if constexpr (Type == StateVariableFilterType::MultiMode) {
+                filter.setMode(Batch::load_aligned(mode_.data() + first));
+            }
+        }
+    }
+
+    /** Filters group's voices in place, one frame of kLanes voices per sample. */
+    void process(size_t group, BufferView<Batch, MaxChannels> buffer) noexcept {
+        ASSERT(group < kNumGroups, "Group index out of range");
+        ASSERT(!dirty_, "SVFBank: call update() after changing parameters");
+        auto& filter = filters_[group];
+        const size_t num_frames = buffer.numFrames();
+        for (size_t ch = 0; ch < buffer.numChannels(); ++ch) {
+            Batch* samples = buffer.channelSamples(ch);
+            filter.process(ch, samples, samples, num_frames);
+        }
+    }
+
+    /** The filter behind group, e.g. for its per-sample modulated process() overload. */
+    [[nodiscard]] Filter& getGroup(size_t group) noexcept {
+        ASSERT(group < kNumGroups, "Group index out of range");
+        return filters_[group];
+    }
+
+private:
+    std::array<Filter, kNumGroups> filters_;
+
+    // Per-voice parameters, padded to whole groups; the padding lanes keep their valid defaults
+    alignas(64) std::array<S, kNumGroups * kLanes> cutoff_;
+    alignas(64) std::array<S, kNumGroups * kLanes> q_;
+    alignas(64) std::array<S, kNumGroups * kLanes> mode_;
+
+    S max_cutoff_ = S(0.0);
+    bool dirty_ = true;
+};
+
+}  // namespace applause
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/FastMath.h>
 #include <applause/util/SampleType.h>
 #include <applause/util/DebugHelpers.h>
 #include <algorithm>
@@ -64,6 +66,21 @@ public:
         s2_.fill(SampleType(0.0));
     }
 
+    /** Clears one SIMD lane's state on every channel, leaving the other lanes running. */
+    void resetLane(size_t lane) noexcept
+        requires SimdBatch<SampleType>
+    {
+        ASSERT(lane < SampleType::size, "Lane index out of range");
+        alignas(64) std::array<ScalarType, SampleType::size> keep;
+        keep.fill(ScalarType(1.0));
+        keep[lane] = ScalarType(0.0);
+        const auto mask = SampleType::load_aligned(keep.data()) != SampleType(0.0);
+        for (size_t ch = 0; ch < MaxChannels; ++ch) {
+            s1_[ch] = xsimd::select(mask, s1_[ch], SampleType(0.0));
+            s2_[ch] = xsimd::select(mask, s2_[ch], SampleType(0.0));
+        }
+    }
+
     template <bool should_update = true>
     void setCutoffFrequency(SampleType frequency) {
         if constexpr (SimdBatch<SampleType>) {
@@ -78,9 +95,7 @@ public:
         cutoff_ = frequency;
         const ScalarType pi_over_sr = ScalarType(M_PI) / ScalarType(sample_rate_);
 
-        using std::tan;
-        using xsimd::tan;
-        g_ = tan(cutoff_ * pi_over_sr);
+        g_ = math::tan(cutoff_ * pi_over_sr);
         if constexpr (should_update)
             update();
     }
@@ -134,31 +149,7 @@ public:
      */
     [[nodiscard]] SampleType getPeakGain() const noexcept
         requires (Type != StateVariableFilterType::MultiMode) {
-        constexpr ScalarType inv_sqrt_two = ScalarType(0.70710678118654752440);
-
-        if constexpr (filter_type == StateVariableFilterType::Lowpass ||
-                      filter_type == StateVariableFilterType::Highpass) {
-            using std::sqrt;
-            using xsimd::sqrt;
-            if constexpr (SimdBatch<SampleType>) {
-                const auto has_resonance = q_ > SampleType(inv_sqrt_two);
-                const auto k2 = k_ * k_;
-                const auto safe_k2 = xsimd::select(has_resonance, k2, SampleType(1.0));
-                const auto peak = SampleType(2.0)
-                                / (safe_k2 * sqrt(SampleType(4.0) / safe_k2 - SampleType(1.0)));
-                return xsimd::select(has_resonance, peak, SampleType(1.0));
-            } else {
-                if (q_ > inv_sqrt_two) {
-                    const auto k2 = k_ * k_;
-                    return ScalarType(2.0) / (k2 * sqrt(ScalarType(4.0) / k2 - ScalarType(1.0)));
-                }
-                return SampleType(1.0);
-            }
-        } else if constexpr (filter_type == StateVariableFilterType::Bandpass) {
-            return q_;
-        } else {
-            return SampleType(1.0);
-        }
+        return computePeakGain(q_, k_);
     }
 
     [[nodiscard]] SampleType getCutoffFrequency() const noexcept {
@@ -274,9 +265,7 @@ public:
 
         const ScalarType pi_over_sr = ScalarType(M_PI) / ScalarType(sample_rate_);
 
-        using std::tan;
-        using xsimd::tan;
-        g_ = tan(cutoff_ * pi_over_sr);
+        g_ = math::tan(cutoff_ * pi_over_sr);
 
         if constexpr (should_update)
             update();
@@ -297,13 +286,13 @@ public:
 
     /** Processes one sample on channel 0. */
     [[nodiscard]] SampleType processSample(SampleType input) noexcept {
-        return processSampleInternal(input, s1_[0], s2_[0]);
+        return makeKernel<SampleType>().tick(input, s1_[0], s2_[0]);
     }
 
     /** Processes one sample on the given channel. All channels share the same coefficients. */
     [[nodiscard]] SampleType processSample(size_t channel, SampleType input) noexcept {
         ASSERT(channel < MaxChannels, "Channel index out of range");
-        return processSampleInternal(input, s1_[channel], s2_[channel]);
+        return makeKernel<SampleType>().tick(input, s1_[channel], s2_[channel]);
     }
 
     /** Processes a block of samples on channel 0. In-place processing (input == output) is allowed. */
@@ -317,15 +306,90 @@ public:
         // Run the loop on local copies of the state: the compiler can't prove
         // that `output` never aliases `this`, so going through the members
         // would force the state back to memory on every sample.
+        const auto kernel = makeKernel<SampleType>();
         SampleType s1 = s1_[channel];
         SampleType s2 = s2_[channel];
         for (size_t i = 0; i < num_frames; ++i) {
-            output[i] = processSampleInternal(input[i], s1, s2);
+            output[i] = kernel.tick(input[i], s1, s2);
         }
         s1_[channel] = s1;
         s2_[channel] = s2;
     }
 
+    /**
+     * Processes a block on the given channel with the cutoff, and optionally Q,
+     * changing every sample, for audio-rate or smoothed modulation. cutoff holds
+     * frequencies in Hz, clamped to [0, Nyquist); q, if given, holds positive Q
+     * values, otherwise the current Q is used throughout. In-place processing
+     * (input == output) is allowed.
+     *
+     * Float filters prewarp through math::tan(), which is fast::tan() unless
+     * APPLAUSE_FAST_MATH is off, instead of a libm call per sample. Its
+     * relative error is below 5e-7, which keeps the output within about 1e-6
+     * of recomputing the exact coefficients every sample at full scale input.
+     * double filters use the exact tan.
+     *
+     * The filter's own cutoff, Q and coefficients are left as they were.
+     */
+    void process(size_t channel, const S* input, S* output, size_t num_frames,
+                 const S* cutoff, const S* q = nullptr) noexcept {
+        ASSERT(channel < MaxChannels, "Channel index out of range");
+        ASSERT(cutoff != nullptr, "Cutoff buffer must not be null");
+
+        const auto pi_over_sr = SampleType(ScalarType(M_PI) / ScalarType(sample_rate_));
+        const auto max_cutoff = SampleType(std::nextafter(nyquist_limit_, ScalarType(0.0)));
+        auto kernel = makeKernel<SampleType>();
+        SampleType k = k_;
+        SampleType s1 = s1_[channel];
+        SampleType s2 = s2_[channel];
+        for (size_t i = 0; i < num_frames; ++i) {
+            const auto w = applause::min(applause::max(cutoff[i], SampleType(0.0)), max_cutoff) * pi_over_sr;
+            const SampleType g = math::tan(w);
+            if (q) {
+                k = SampleType(1.0) / q[i];
+                if constexpr (UnityGain) kernel.gain = SampleType(1.0) / computePeakGain(q[i], k);
+            }
+            kernel.setCoefficients(g, k);
+            output[i] = kernel.tick(input[i], s1, s2);
+        }
+        s1_[channel] = s1;
+        s2_[channel] = s2;
+    }
+
+    /**
+     * Processes every channel of buffer in place.
+     *
+     * With a scalar sample type, the channels are filtered side by side in the
+     * lanes of one xsimd batch: each frame is gathered across the channels, run
+     * through a single vector tick, and scattered back, so stereo or 8-channel
+     * material costs about as much as one channel. A trailing channel that
+     * doesn't share a batch with another one takes the scalar path. With a SIMD
+     * sample type the lanes are already in use, and the channels run one after
+     * another.
+     */
+    void processBlock(BufferView<S, MaxChannels> buffer) noexcept {
+        const size_t num_channels = buffer.numChannels();
+        const size_t num_frames = buffer.numFrames();
+
+        if constexpr (SimdBatch<SampleType>) {
+            for (size_t ch = 0; ch < num_channels; ++ch) {
+                S* samples = buffer.channelSamples(ch);
+                process(ch, samples, samples, num_frames);
+            }
+        } else {
+            using Batch = xsimd::batch<ScalarType>;
+            constexpr size_t lanes = Batch::size;
+            size_t ch = 0;
+            for (; ch + 1 < num_channels; ch += lanes) {
+                processLanes<Batch>(buffer, ch, std::min(lanes, num_channels - ch));
+            }
+            if (ch < num_channels) {
+                S* samples = buffer.channelSamples(ch);
+                process(ch, samples, samples, num_frames);
+            }
+        }
+    }
+
     /**
      * Returns the phase delay of the filter at the given frequency, in samples.
      *
@@ -372,41 +436,137 @@ public:
     }
 
 private:
-    [[nodiscard]] __attribute__((always_inline)) SampleType
-    processSampleInternal(SampleType x, SampleType& s1, SampleType& s2) noexcept {
-        // Simper's "tick parallel": both integrator increments (t1, t2) come
-        // straight off the input and the previous state through premultiplied
-        // coefficients, so the loop-carried dependency chain is ~3 FLOPs
-        // instead of the serial form's ~8; the extra multiplies run on FP
-        // units the recurrence leaves idle.
-        const auto t0 = x - s2;
-        const auto t1 = gt1_ * t0 - gk1_ * s1;
-        const auto t2 = gt2_ * t0 + gt1_ * s1;
-
-        SampleType output;
-        if constexpr (filter_type == StateVariableFilterType::Lowpass) {
-            output = t2 + s2;
+    [[nodiscard]] static SampleType computePeakGain(SampleType q, SampleType k) noexcept
+        requires (Type != StateVariableFilterType::MultiMode) {
+        constexpr ScalarType inv_sqrt_two = ScalarType(0.70710678118654752440);
+
+        if constexpr (filter_type == StateVariableFilterType::Lowpass ||
+                      filter_type == StateVariableFilterType::Highpass) {
+            using std::sqrt;
+            using xsimd::sqrt;
+            if constexpr (SimdBatch<SampleType>) {
+                const auto has_resonance = q > SampleType(inv_sqrt_two);
+                const auto k2 = k * k;
+                const auto safe_k2 = xsimd::select(has_resonance, k2, SampleType(1.0));
+                const auto peak = SampleType(2.0)
+                                / (safe_k2 * sqrt(SampleType(4.0) / safe_k2 - SampleType(1.0)));
+                return xsimd::select(has_resonance, peak, SampleType(1.0));
+            } else {
+                if (q > inv_sqrt_two) {
+                    const auto k2 = k * k;
+                    return ScalarType(2.0) / (k2 * sqrt(ScalarType(4.0) / k2 - ScalarType(1.0)));
+                }
+                return SampleType(1.0);
+            }
         } else if constexpr (filter_type == StateVariableFilterType::Bandpass) {
-            output = t1 + s1;
-        } else if constexpr (filter_type == StateVariableFilterType::Highpass) {
-            output = gt0_ * t0 - gk0_ * s1;
-        } else if constexpr (filter_type == StateVariableFilterType::MultiMode) {
-            const auto yhp = gt0_ * t0 - gk0_ * s1;
-            const auto ybp = t1 + s1;
-            const auto ylp = t2 + s2;
-            output = applause::fma(mix_.lp, ylp, applause::fma(mix_.bp, ybp, mix_.hp * yhp));
+            return q;
         } else {
-            LOG_ERR("Unknown filter type; this should never happen!");
-            return SampleType(0);
+            return SampleType(1.0);
         }
+    }
 
-        s1 = s1 + SampleType(2.0) * t1;
-        s2 = s2 + SampleType(2.0) * t2;
+    /**
+     * The per-sample recurrence, with the coefficients held as V: SampleType
+     * for the regular paths, or a batch of broadcast scalars when processBlock()
+     * packs channels into lanes.
+     */
+    template <typename V>
+    struct Kernel {
+        V gt0, gk0, gt1, gk1, gt2;
+        V lp, bp, hp;  // MultiMode blend
+        V gain;        // 1 / peak gain, UnityGain only
+
+        // Same as update(), for a cutoff and Q that change every sample
+        __attribute__((always_inline)) void setCoefficients(V g, V k) noexcept {
+            const auto gk = g + k;
+            gt0 = V(ScalarType(1.0)) / (V(ScalarType(1.0)) + g * gk);
+            gk0 = gk * gt0;
+            gt1 = g * gt0;
+            gk1 = g * gk0;
+            gt2 = g * gt1;
+        }
 
-        if constexpr (UnityGain) {
-            return output * one_over_peak_gain_;
-        } else {
-            return output;
+        [[nodiscard]] __attribute__((always_inline)) V tick(V x, V& s1, V& s2) const noexcept {
+            // Simper's "tick parallel": both integrator increments (t1, t2) come
+            // straight off the input and the previous state through premultiplied
+            // coefficients, so the loop-carried dependency chain is ~3 FLOPs
+            // instead of the serial form's ~8; the extra multiplies run on FP
+            // units the recurrence leaves idle.
+            const auto t0 = x - s2;
+            const auto t1 = gt1 * t0 - gk1 * s1;
+            const auto t2 = gt2 * t0 + gt1 * s1;
+
+            V output;
+            if constexpr (filter_type == StateVariableFilterType::Lowpass) {
+                output = t2 + s2;
+            } else if constexpr (filter_type == StateVariableFilterType::Bandpass) {
+                output = t1 + s1;
+            } else if constexpr (filter_type == StateVariableFilterType::Highpass) {
+                output = gt0 * t0 - gk0 * s1;
+            } else if constexpr (filter_type == StateVariableFilterType::MultiMode) {
+                const auto yhp = gt0 * t0 - gk0 * s1;
+                const auto ybp = t1 + s1;
+                const auto ylp = t2 + s2;
+                output = applause::fma(lp, ylp, applause::fma(bp, ybp, hp * yhp));
+            } else {
+                LOG_ERR("Unknown filter type; this should never happen!");
+                return V(ScalarType(0));
+            }
+
+            s1 = s1 + V(ScalarType(2.0)) * t1;
+            s2 = s2 + V(ScalarType(2.0)) * t2;
+
+            if constexpr (UnityGain) {
+                return output * gain;
+            } else {
+                return output;
+            }
+        }
+    };
+
+    template <typename V>
+    [[nodiscard]] __attribute__((always_inline)) Kernel<V> makeKernel() const noexcept {
+        Kernel<V> kernel{V(gt0_), V(gk0_), V(gt1_), V(gk1_), V(gt2_),
+                         V(ScalarType(1.0)), V(ScalarType(0.0)), V(ScalarType(0.0)),
+                         V(one_over_peak_gain_)};
+        if constexpr (filter_type == StateVariableFilterType::MultiMode) {
+            kernel.lp = V(mix_.lp);
+            kernel.bp = V(mix_.bp);
+            kernel.hp = V(mix_.hp);
+        }
+        return kernel;
+    }
+
+    // Filters count (<= Batch::size) channels starting at first, one per lane.
+    // Lanes past count run on zeros and are never written back.
+    template <typename Batch>
+    void processLanes(BufferView<S, MaxChannels>& buffer, size_t first, size_t count) noexcept {
+        constexpr size_t lanes = Batch::size;
+        std::array<S*, lanes> channels{};
+        alignas(64) std::array<ScalarType, lanes> s1{};
+        alignas(64) std::array<ScalarType, lanes> s2{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            channels[lane] = buffer.channelSamples(first + lane);
+            s1[lane] = s1_[first + lane];
+            s2[lane] = s2_[first + lane];
+        }
+
+        const auto kernel = makeKernel<Batch>();
+        auto s1_lanes = Batch::load_aligned(s1.data());
+        auto s2_lanes = Batch::load_aligned(s2.data());
+        alignas(64) std::array<ScalarType, lanes> frame{};
+        const size_t num_frames = buffer.numFrames();
+        for (size_t i = 0; i < num_frames; ++i) {
+            for (size_t lane = 0; lane < count; ++lane) frame[lane] = channels[lane][i];
+            kernel.tick(Batch::load_aligned(frame.data()), s1_lanes, s2_lanes).store_aligned(frame.data());
+            for (size_t lane = 0; lane < count; ++lane) channels[lane][i] = frame[lane];
+        }
+
+        s1_lanes.store_aligned(s1.data());
+        s2_lanes.store_aligned(s2.data());
+        for (size_t lane = 0; lane < count; ++lane) {
+            s1_[first + lane] = s1[lane];
+            s2_[first + lane] = s2[lane];
         }
     }
 
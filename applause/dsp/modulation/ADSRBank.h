@@ -0,0 +1,231 @@
+#pragma once
+
+#include <applause/core/ModMatrix.h>
+#include <applause/dsp/FastMath.h>
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/** Shape of an ADSRBank's envelopes. Times are in seconds, sustain is a level in [0, 1]. */
+struct ADSRParameters {
+    float attack = 0.005f;  ///< Time from 0 to 1
+    float decay = 0.2f;     ///< Time from 1 to 0 at the decay rate; reaching the sustain level takes less
+    float sustain = 0.7f;
+    float release = 0.3f;         ///< Time from 1 to 0; releasing from a lower level takes less
+    float attack_curve = 0.3f;    ///< Overshoot of the attack's exponential target; larger is more linear
+    float release_curve = 1e-3f;  ///< Undershoot of the decay and release targets; larger is more linear
+};
+
+/**
+ * @brief One ADSR shape shared by NumVoices voices, with every voice's envelope advanced in SIMD.
+ *
+ * Replaces a per-sample scalar ADSR per voice. Each segment is an analog-style exponential approach to a target
+ * just past its end level, so a voice's value after n samples has the closed form
+ * target + (value - target) * coef^n, and process() advances a whole block at once: per group of kLanes voices it
+ * computes where each lane's segment ends, takes the shorter of that and the block, and moves on to the next
+ * segment for the rest. Voices are laid out as in MSEGBank (voice v is lane v % kLanes of group v / kLanes), and
+ * groups without a sounding voice are skipped.
+ *
+ * Values are sampled once per process() call, like any other ModMatrix source. writeTo() stores them straight
+ * into a poly source row.
+ *
+ * @code
+ * // In the Synthesizer voice
+ * void noteOn() override { env_bank_.noteOn(getVoiceIndex()); }
+ * void noteOff(bool terminate_now) override {
+ *     env_bank_.noteOff(getVoiceIndex());
+ *     if (terminate_now) terminateVoice();
+ * }
+ * // ... and once the release is done: if (!env_bank_.isActive(getVoiceIndex())) terminateVoice();
+ *
+ * // Once per block, before mod_matrix_.process()
+ * env_bank_.process(num_frames);
+ * env_bank_.writeTo(mod_matrix_, env_source_.index);
+ * @endcode
+ */
+template <size_t NumVoices>
+class ADSRBank {
+public:
+    using Batch = xsimd::batch<float>;
+    static constexpr size_t kLanes = Batch::size;
+    static constexpr size_t kNumGroups = (NumVoices + kLanes - 1) / kLanes;
+    static_assert(NumVoices >= 1, "The bank needs at least one voice");
+    static_assert(kLanes <= 32, "Lane masks are 32 bits wide");
+
+    enum class Stage : uint8_t { Idle, Attack, Decay, Sustain, Release };
+
+    explicit ADSRBank(const ADSRParameters& parameters = {}, float sample_rate = 44100.0f)
+        : parameters_(parameters), sample_rate_(sample_rate) {
+        ASSERT(sample_rate > 0.0f, "ADSRBank: sample rate must be positive");
+        updateRates();
+        reset();
+    }
+
+    void setSampleRate(float sample_rate) {
+        ASSERT(sample_rate > 0.0f, "ADSRBank: sample rate must be positive");
+        sample_rate_ = sample_rate;
+        updateRates();
+    }
+
+    /** Takes effect at the next process(); voices carry on from their current value. */
+    void setParameters(const ADSRParameters& parameters) {
+        parameters_ = parameters;
+        updateRates();
+    }
+
+    [[nodiscard]] const ADSRParameters& getParameters() const noexcept { return parameters_; }
+
+    /** Starts voice's attack from its current value, so a retriggered or stolen voice doesn't click. */
+    void noteOn(size_t voice) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        stage_[voice] = static_cast<float>(Stage::Attack);
+        active_[voice / kLanes] |= 1u << (voice % kLanes);
+    }
+
+    /** Starts voice's release; it becomes inactive once its value reaches 0. */
+    void noteOff(size_t voice) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        if (isActive(voice)) stage_[voice] = static_cast<float>(Stage::Release);
+    }
+
+    /** Silences voice at once. */
+    void kill(size_t voice) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        stage_[voice] = static_cast<float>(Stage::Idle);
+        value_[voice] = 0.0f;
+        active_[voice / kLanes] &= ~(1u << (voice % kLanes));
+    }
+
+    void reset() {
+        stage_.fill(static_cast<float>(Stage::Idle));
+        value_.fill(0.0f);
+        active_.fill(0);
+    }
+
+    /** Advances every sounding voice by num_samples, crossing as many segment boundaries as the block holds. */
+    void process(int num_samples) {
+        const Batch samples(static_cast<float>(num_samples));
+        for (size_t g = 0; g < kNumGroups; ++g) {
+            if (active_[g] == 0) continue;
+            const size_t first = g * kLanes;
+            Batch stage = Batch::load_aligned(stage_.data() + first);
+            Batch value = Batch::load_aligned(value_.data() + first);
+            advance(stage, value, samples);
+            stage.store_aligned(stage_.data() + first);
+            value.store_aligned(value_.data() + first);
+
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                if (stage_[first + lane] == static_cast<float>(Stage::Idle)) active_[g] &= ~(1u << lane);
+            }
+        }
+    }
+
+    /**
+     * Writes every voice's value into srcIdx's poly row of matrix; bank voice v is matrix voice first_voice + v.
+     * Voices past the matrix's voice count are skipped. Call after process() and before ModMatrix::process().
+     */
+    void writeTo(ModMatrix& matrix, uint16_t srcIdx, uint16_t first_voice = 0) const {
+        const ModPolySourceRow row = matrix.getPolySourceRow(srcIdx);
+        if (first_voice >= row.num_voices) return;
+        const size_t count = std::min(NumVoices, row.num_voices - first_voice);
+        if (row.isContiguous()) {
+            float* out = row.data + first_voice;
+            size_t v = 0;
+            for (; v + kLanes <= count; v += kLanes) {
+                Batch::load_aligned(value_.data() + v).store_unaligned(out + v);
+            }
+            std::copy(value_.begin() + v, value_.begin() + count, out + v);
+        } else {
+            for (size_t v = 0; v < count; ++v) row[first_voice + v] = value_[v];
+        }
+    }
+
+    [[nodiscard]] float value(size_t voice) const { return value_[voice]; }
+    [[nodiscard]] Stage stage(size_t voice) const { return static_cast<Stage>(stage_[voice]); }
+    /** False once a released voice has faded out; the voice can terminate then. */
+    [[nodiscard]] bool isActive(size_t voice) const { return active_[voice / kLanes] & (1u << (voice % kLanes)); }
+
+private:
+    // Attack and then Decay can both end within one block; Sustain doesn't end by itself
+    static constexpr int kMaxSegmentsPerBlock = 2;
+
+    /** coef is chosen so that a segment over the full range with overshoot `curve` takes `seconds`. */
+    float log2Rate(float seconds, float curve) const {
+        const float samples = std::max(seconds * sample_rate_, 1.0f);
+        return std::log2(curve / (1.0f + curve)) / samples;
+    }
+
+    void updateRates() {
+        ASSERT(parameters_.attack_curve > 0.0f && parameters_.release_curve > 0.0f,
+               "ADSRBank: curves must be positive");
+        parameters_.sustain = std::clamp(parameters_.sustain, 0.0f, 1.0f);
+        attack_log2_rate_ = log2Rate(parameters_.attack, parameters_.attack_curve);
+        decay_log2_rate_ = log2Rate(parameters_.decay, parameters_.release_curve);
+        release_log2_rate_ = log2Rate(parameters_.release, parameters_.release_curve);
+    }
+
+    void advance(Batch& stage, Batch& value, Batch left) const {
+        const Batch attack(static_cast<float>(Stage::Attack));
+        const Batch decay(static_cast<float>(Stage::Decay));
+        const Batch sustain(static_cast<float>(Stage::Sustain));
+        const Batch release(static_cast<float>(Stage::Release));
+        const Batch idle(static_cast<float>(Stage::Idle));
+        const Batch sustain_level(parameters_.sustain);
+        const Batch never(std::numeric_limits<float>::infinity());
+
+        for (int segment = 0; segment < kMaxSegmentsPerBlock; ++segment) {
+            const auto in_attack = stage == attack;
+            const auto in_decay = stage == decay;
+            const auto in_release = stage == release;
+            const auto moving = in_attack | in_decay | in_release;
+            if (xsimd::none(moving)) break;
+
+            // Each moving segment heads for a target just past its end level, which it reaches in finite time
+            const Batch end = xsimd::select(in_attack, Batch(1.0f), xsimd::select(in_decay, sustain_level, idle));
+            const Batch target = xsimd::select(
+                in_attack, Batch(1.0f + parameters_.attack_curve), end - Batch(parameters_.release_curve));
+            const Batch log2_rate = xsimd::select(
+                in_attack, Batch(attack_log2_rate_),
+                xsimd::select(in_decay, Batch(decay_log2_rate_), Batch(release_log2_rate_)));
+            const Batch next = xsimd::select(in_attack, decay, xsimd::select(in_decay, sustain, idle));
+
+            // Samples until the end level: (end - target) / (value - target) = coef^n. A lane already past it, e.g.
+            // after the sustain level was raised, ends at once
+            const auto past = (in_attack & (value >= end)) | (!in_attack & (value <= end));
+            const Batch ratio = xsimd::select(moving & !past, (end - target) / (value - target), Batch(1.0f));
+            const Batch to_end = xsimd::select(moving, math::log2(ratio) / log2_rate, never);
+            const auto ends = moving & (to_end <= left);
+            const Batch step = xsimd::select(ends, to_end, left);
+
+            const Batch moved = applause::fma(value - target, math::exp2(step * log2_rate), target);
+            value = xsimd::select(ends, end, xsimd::select(moving, moved, value));
+            stage = xsimd::select(ends, next, stage);
+            left = left - step;
+        }
+
+        // Sustaining lanes follow the sustain level; idle ones stay silent
+        value = xsimd::select(stage == sustain, sustain_level, xsimd::select(stage == idle, Batch(0.0f), value));
+    }
+
+    ADSRParameters parameters_;
+    float sample_rate_;
+    float attack_log2_rate_ = 0.0f;  // log2(coef) per sample for each segment
+    float decay_log2_rate_ = 0.0f;
+    float release_log2_rate_ = 0.0f;
+
+    // Per-voice state, padded to whole groups. Stages are stored as floats so they can be selected on in SIMD
+    alignas(64) std::array<float, kNumGroups * kLanes> stage_;
+    alignas(64) std::array<float, kNumGroups * kLanes> value_;
+    std::array<uint32_t, kNumGroups> active_;  // Bit i: lane i of the group isn't Idle
+};
+
+}  // namespace applause
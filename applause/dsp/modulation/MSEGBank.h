@@ -0,0 +1,181 @@
+#pragma once
+
+#include <applause/core/ModMatrix.h>
+#include <applause/dsp/modulation/MSEGCurve.h>
+#include <applause/dsp/modulation/MSEGCurveHandoff.h>
+#include <applause/dsp/modulation/MSEGTable.h>
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * @brief One MSEG shared by NumVoices voices, with every voice's phase advanced and evaluated in SIMD.
+ *
+ * Replaces one MSEGModulator per voice for free-running poly MSEGs. Phases, rates and values are stored per voice
+ * in lane-wide arrays (voice v is lane v % kLanes of group v / kLanes, as in SimdSynthesizer), and each process()
+ * only touches groups with an active voice. Reading from a baked MSEGTable keeps the evaluation in SIMD apart from
+ * the per-lane table reads; without one, each active voice evaluates the curve itself.
+ *
+ * writeTo() stores the values straight into a ModMatrix poly source row instead of calling setPolySourceValue() per
+ * voice; under ModVoiceLayout::VoiceLanes that's one SIMD store per group.
+ *
+ * @code
+ * // Note on/off, from the voice
+ * mseg_bank_.noteOn(voice_index);
+ *
+ * // Once per block, before mod_matrix_.process()
+ * mseg_handoff_.update();
+ * mseg_bank_.process(num_frames);
+ * mseg_bank_.writeTo(mod_matrix_, mseg_source_.index);
+ * @endcode
+ */
+template <size_t NumVoices>
+class MSEGBank {
+public:
+    using Batch = xsimd::batch<float>;
+    static constexpr size_t kLanes = Batch::size;
+    static constexpr size_t kNumGroups = (NumVoices + kLanes - 1) / kLanes;
+    static_assert(NumVoices >= 1, "The bank needs at least one voice");
+    static_assert(kLanes <= 32, "Lane masks are 32 bits wide");
+
+    explicit MSEGBank(const MSEGCurve<>* curve = nullptr, float sample_rate = 44100.0f)
+        : curve_(curve), sample_rate_(sample_rate) {
+        increment_.fill(1.0f / sample_rate);
+        reset();
+    }
+
+    void setCurve(const MSEGCurve<>* curve) { curve_ = curve; }
+
+    /** Reads the curve from a baked table instead, as MSEGModulator::setTable(). */
+    void setTable(const MSEGTable* table) { table_ = table; }
+
+    /** Reads curve and table from handoff's current snapshot at every process(), as MSEGModulator::setHandoff(). */
+    void setHandoff(const MSEGCurveHandoff* handoff) { handoff_ = handoff; }
+
+    /** Changes the sample rate, keeping every voice's rate in Hz. */
+    void setSampleRate(float sample_rate) {
+        ASSERT(sample_rate > 0.0f, "MSEGBank: sample rate must be positive");
+        const float ratio = sample_rate_ / sample_rate;
+        for (float& increment : increment_) increment *= ratio;
+        sample_rate_ = sample_rate;
+    }
+
+    /** Sets every voice's rate in Hz. */
+    void setRate(float hz) { increment_.fill(hz / sample_rate_); }
+
+    /** Sets one voice's rate in Hz, e.g. for key tracking. */
+    void setRate(size_t voice, float hz) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        increment_[voice] = hz / sample_rate_;
+    }
+
+    /** Restarts voice's cycle and includes it in process(). */
+    void noteOn(size_t voice) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        phase_[voice] = 0.0f;
+        active_[voice / kLanes] |= 1u << (voice % kLanes);
+    }
+
+    /** Stops processing voice; its last value is kept. */
+    void noteOff(size_t voice) {
+        ASSERT(voice < NumVoices, "Voice index out of range");
+        active_[voice / kLanes] &= ~(1u << (voice % kLanes));
+    }
+
+    void reset() {
+        phase_.fill(0.0f);
+        value_.fill(0.0f);
+        active_.fill(0);
+    }
+
+    /** Advances every active voice by num_samples and evaluates the curve at its new phase. */
+    void process(int num_samples) {
+        pickUpHandoff();
+        if (!curve_ && !table_) return;
+        const bool loops = table_ ? table_->loops() : curve_->loop;
+        const Batch samples(static_cast<float>(num_samples));
+
+        for (size_t g = 0; g < kNumGroups; ++g) {
+            const uint32_t active = active_[g];
+            if (active == 0) continue;
+            const size_t first = g * kLanes;
+
+            // Inactive lanes advance too, harmlessly: noteOn() resets their phase before they're used
+            Batch phase = Batch::load_aligned(phase_.data() + first)
+                        + Batch::load_aligned(increment_.data() + first) * samples;
+            phase = loops ? phase - xsimd::floor(phase) : xsimd::min(phase, Batch(1.0f));
+            phase.store_aligned(phase_.data() + first);
+
+            if (table_) {
+                const Batch value = table_->evaluate(phase);
+                if (active == kAllLanes) {
+                    value.store_aligned(value_.data() + first);
+                    continue;
+                }
+                alignas(64) std::array<float, kLanes> values;
+                value.store_aligned(values.data());
+                for (size_t lane = 0; lane < kLanes; ++lane) {
+                    if (active & (1u << lane)) value_[first + lane] = values[lane];
+                }
+            } else {
+                for (size_t lane = 0; lane < kLanes; ++lane) {
+                    if (active & (1u << lane)) value_[first + lane] = curve_->evaluate(phase_[first + lane]);
+                }
+            }
+        }
+    }
+
+    /**
+     * Writes every voice's value into srcIdx's poly row of matrix; bank voice v is matrix voice first_voice + v.
+     * Voices past the matrix's voice count are skipped. Call after process() and before ModMatrix::process().
+     */
+    void writeTo(ModMatrix& matrix, uint16_t srcIdx, uint16_t first_voice = 0) const {
+        const ModPolySourceRow row = matrix.getPolySourceRow(srcIdx);
+        if (first_voice >= row.num_voices) return;
+        const size_t count = std::min(NumVoices, row.num_voices - first_voice);
+        if (row.isContiguous()) {
+            float* out = row.data + first_voice;
+            size_t v = 0;
+            for (; v + kLanes <= count; v += kLanes) {
+                Batch::load_aligned(value_.data() + v).store_unaligned(out + v);
+            }
+            std::copy(value_.begin() + v, value_.begin() + count, out + v);
+        } else {
+            for (size_t v = 0; v < count; ++v) row[first_voice + v] = value_[v];
+        }
+    }
+
+    [[nodiscard]] float phase(size_t voice) const { return phase_[voice]; }
+    [[nodiscard]] float value(size_t voice) const { return value_[voice]; }
+    [[nodiscard]] bool isActive(size_t voice) const { return active_[voice / kLanes] & (1u << (voice % kLanes)); }
+
+private:
+    static constexpr uint32_t kAllLanes = kLanes == 32 ? ~0u : (1u << kLanes) - 1;
+
+    void pickUpHandoff() {
+        if (!handoff_) return;
+        const MSEGSnapshot& snapshot = handoff_->get();
+        curve_ = &snapshot.curve;
+        table_ = snapshot.table.isBaked() ? &snapshot.table : nullptr;
+    }
+
+    const MSEGCurve<>* curve_ = nullptr;
+    const MSEGTable* table_ = nullptr;
+    const MSEGCurveHandoff* handoff_ = nullptr;
+    float sample_rate_;
+
+    // Per-voice state, padded to whole groups
+    alignas(64) std::array<float, kNumGroups * kLanes> phase_;
+    alignas(64) std::array<float, kNumGroups * kLanes> increment_;  // Phase step per sample
+    alignas(64) std::array<float, kNumGroups * kLanes> value_;
+    std::array<uint32_t, kNumGroups> active_;  // Bit i: lane i of the group holds a note
+};
+
+}  // namespace applause
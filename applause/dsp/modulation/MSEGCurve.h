@@ -1,5 +1,7 @@
 #pragma once
 
+#include <applause/dsp/FastMath.h>
+
 #include <array>
 #include <cmath>
 #include <utility>
@@ -15,6 +17,9 @@ struct MSEGCurve {
     int num_points = 0;
     bool loop = true;
 
+    /// Curvature below this magnitude is treated as linear.
+    static constexpr float kMinPower = 0.01f;
+
     /// Attempt to evaluate the curve at a given phase. If the phase falls outside
     /// the bounds of the curve, returns the value of the nearest endpoint.
     float evaluate(float phase) const {
@@ -24,21 +29,31 @@ struct MSEGCurve {
         if (phase <= points[0].first) return points[0].second;
         if (phase >= points[num_points - 1].first) return points[num_points - 1].second;
 
-        // Find the segment containing this phase
-        int seg = 0;
-        for (int i = 0; i < num_points - 1; i++) {
-            if (phase < points[i + 1].first) { seg = i; break; }
-        }
+        const int seg = segmentAt(phase);
+        const float x0 = points[seg].first;
+        float dx = points[seg + 1].first - x0;
+        if (dx <= 0.0f) return points[seg].second;
 
-        const auto& [x0, y0] = points[seg];
-        const auto& [x1, y1] = points[seg + 1];
-        float dx = x1 - x0;
-        if (dx <= 0.0f) return y0;
+        return evaluateSegment(seg, (phase - x0) / dx);
+    }
 
-        float t = (phase - x0) / dx;
+    /// Evaluates segment seg at t in [0, 1] of its width, without searching for
+    /// the segment, for callers that walk a known segment (e.g. drawing it).
+    float evaluateSegment(int seg, float t) const {
+        const float y0 = points[seg].second;
+        const float y1 = points[seg + 1].second;
         // apply curvature scaling
-        t = powerScale(t, curvature_power[seg]);
-        return y0 + t * (y1 - y0);
+        return y0 + powerScale(t, curvature_power[seg]) * (y1 - y0);
+    }
+
+    /// Returns the index of the segment containing phase, i.e. the last point at
+    /// or before it. phase must lie within the curve's bounds. The search starts
+    /// at hint when that point isn't past phase, so callers walking forward
+    /// through the curve find the next segment in a step or two.
+    int segmentAt(float phase, int hint = 0) const {
+        int seg = (hint > 0 && hint < num_points - 1 && points[hint].first <= phase) ? hint : 0;
+        while (seg < num_points - 2 && phase >= points[seg + 1].first) seg++;
+        return seg;
     }
 
 private:
@@ -46,10 +61,9 @@ private:
     /// curvature of the interpolation. When power is near zero, the value
     /// is returned unchanged (linear interpolation).
     static float powerScale(float value, float power) {
-        constexpr float kMinPower = 0.01f;
         if (std::abs(power) < kMinPower) return value;
-        float numerator = std::exp(power * value) - 1.0f;
-        float denominator = std::exp(power) - 1.0f;
+        float numerator = math::exp(power * value) - 1.0f;
+        float denominator = math::exp(power) - 1.0f;
         return numerator / denominator;
     }
 };
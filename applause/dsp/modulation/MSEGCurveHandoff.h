@@ -0,0 +1,64 @@
+#pragma once
+
+#include <applause/dsp/modulation/MSEGCurve.h>
+#include <applause/dsp/modulation/MSEGTable.h>
+#include <applause/util/RealtimeSwap.h>
+
+#include <memory>
+
+namespace applause {
+
+/** A self-contained copy of an MSEG curve, with its baked table, as the audio thread sees it. */
+struct MSEGSnapshot {
+    MSEGCurve<> curve;
+    MSEGTable table;  // Left unbaked to have modulators evaluate the curve itself
+};
+
+/**
+ * @brief Hands edited MSEG curves from the UI thread to MSEGModulators on the audio thread without locks.
+ *
+ * The UI edits its own MSEGCurve and publish()es a copy after every change, baked into an MSEGTable on the UI
+ * thread. The audio thread calls update() once per block, before running any modulator that reads from the
+ * handoff, and modulators pick up the new snapshot from get() in their next process call. Modulators never hold on
+ * to a snapshot between calls, so any number of voices can share one handoff. The exchange itself is a
+ * RealtimeSwap: no locks, no torn reads, and nothing is allocated or freed on the audio thread.
+ *
+ * @code
+ * // UI thread
+ * mseg_display_.setHandoff(&processor.mseg_handoff_);
+ *
+ * // Audio thread, at the start of process()
+ * mseg_handoff_.update();
+ * for (auto& voice : voices_) voice.mseg.processBlock(voice.mod_buffer, num_frames);
+ * @endcode
+ */
+class MSEGCurveHandoff {
+public:
+    /** Starts from an unbaked flat curve, so get() is never null. */
+    MSEGCurveHandoff() : swap_(std::make_unique<MSEGSnapshot>()) {}
+
+    /** UI thread: publishes a copy of curve, baked at table_resolution entries (0 to skip baking). */
+    void publish(const MSEGCurve<>& curve, size_t table_resolution = MSEGTable::kDefaultResolution) {
+        auto snapshot = std::make_unique<MSEGSnapshot>();
+        snapshot->curve = curve;
+        if (table_resolution > 0) snapshot->table.bake(curve, table_resolution);
+        publish(std::move(snapshot));
+    }
+
+    /** UI thread: publishes a snapshot built by the caller, e.g. baked with MSEGTable::bakeWithin(). */
+    void publish(std::unique_ptr<MSEGSnapshot> snapshot) { swap_.publish(std::move(snapshot)); }
+
+    /** UI thread: frees the snapshot the audio thread last replaced; call now and then, e.g. from a timer. */
+    void collect() { swap_.collect(); }
+
+    /** Audio thread: picks up the last published snapshot at a block boundary. Returns whether it changed. */
+    bool update() noexcept { return swap_.update(); }
+
+    /** Audio thread: the current snapshot, valid until the next update(). */
+    [[nodiscard]] const MSEGSnapshot& get() const noexcept { return *swap_.get(); }
+
+private:
+    RealtimeSwap<MSEGSnapshot> swap_;
+};
+
+}  // namespace applause
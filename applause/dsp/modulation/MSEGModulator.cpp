@@ -1 +1,104 @@
 #include "MSEGModulator.h"
+
+#include <limits>
+
+namespace applause {
+
+void MSEGModulator::processBlock(float* out, int num_samples) {
+    if (num_samples <= 0) return;
+    pickUpHandoff();
+
+    if (sync_ == MSEGSync::Free) {
+        renderBlock(out, num_samples, rate_ / sample_rate_);
+        return;
+    }
+    renderBlock(out, num_samples, static_cast<float>(beatsPerSample() / sync_length_));
+    beats_ += beatsPerSample() * num_samples;
+    phase_ = phaseFromBeats();
+}
+
+void MSEGModulator::renderBlock(float* out, int num_samples, float increment) {
+    if (table_) {
+        for (int i = 0; i < num_samples; ++i) {
+            phase_ += increment;
+            if (phase_ >= 1.0f) phase_ = table_->loops() ? phase_ - std::floor(phase_) : 1.0f;
+            out[i] = table_->evaluate(phase_);
+        }
+        value_ = out[num_samples - 1];
+        return;
+    }
+
+    seekCursor(increment);
+    for (int i = 0; i < num_samples; ++i) {
+        phase_ += increment;
+        if (phase_ >= 1.0f) {
+            if (!curve_->loop) {
+                // Finished: the rest of the block holds the end value
+                phase_ = 1.0f;
+                std::fill(out + i, out + num_samples, curve_->evaluate(phase_));
+                value_ = out[num_samples - 1];
+                return;
+            }
+            phase_ -= std::floor(phase_);
+            seekCursor(increment);
+        } else if (phase_ >= cursor_.end) {
+            seekCursor(increment);
+        } else {
+            cursor_.shape = cursor_.shape * cursor_.ratio + cursor_.step;
+        }
+        out[i] = static_cast<float>(cursor_.base + cursor_.scale * cursor_.shape);
+    }
+    value_ = out[num_samples - 1];
+}
+
+void MSEGModulator::seekCursor(float increment) {
+    constexpr float kNever = std::numeric_limits<float>::infinity();
+    const auto& curve = *curve_;
+    cursor_.scale = 0.0;
+    cursor_.shape = 0.0;
+    cursor_.ratio = 1.0;
+    cursor_.step = 0.0;
+
+    if (curve.num_points < 2) {
+        cursor_.base = 0.0;
+        cursor_.end = kNever;
+        return;
+    }
+    const auto& [first_x, first_y] = curve.points[0];
+    const auto& [last_x, last_y] = curve.points[curve.num_points - 1];
+    if (phase_ < first_x) {
+        cursor_.base = first_y;
+        cursor_.end = first_x;
+        return;
+    }
+    if (phase_ >= last_x) {
+        cursor_.base = last_y;
+        cursor_.end = kNever;
+        return;
+    }
+
+    const int seg = curve.segmentAt(phase_, cursor_.segment);
+    const auto& [x0, y0] = curve.points[seg];
+    const auto& [x1, y1] = curve.points[seg + 1];
+    const double dx = x1 - x0;
+    const double position = (phase_ - x0) / dx;
+    const double position_step = increment / dx;
+    const float power = curve.curvature_power[seg];
+    cursor_.segment = seg;
+    cursor_.end = x1;
+
+    if (std::abs(power) < MSEGCurve<>::kMinPower) {
+        cursor_.base = y0;
+        cursor_.scale = y1 - y0;
+        cursor_.shape = position;
+        cursor_.step = position_step;
+    } else {
+        // y0 + (y1 - y0) * (e^(p*u) - 1) / (e^p - 1), with e^(p*u) advancing by a constant factor per sample
+        cursor_.scale = (y1 - y0) / std::expm1(static_cast<double>(power));
+        cursor_.base = y0 - cursor_.scale;
+        cursor_.shape = std::exp(power * position);
+        cursor_.ratio = std::exp(power * position_step);
+    }
+}
+
+}  // namespace applause
@@ -1,11 +1,25 @@
 #pragma once
 
 #include <applause/dsp/modulation/MSEGCurve.h>
+#include <applause/dsp/modulation/MSEGCurveHandoff.h>
+#include <applause/dsp/modulation/MSEGTable.h>
+#include <applause/util/DebugHelpers.h>
+
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+
+#include <clap/events.h>
 
 namespace applause {
 
+/** Where an MSEGModulator's phase comes from. */
+enum class MSEGSync : uint8_t {
+    Free,       ///< Cycles at setRate() Hz; retrigger() restarts the cycle
+    Tempo,      ///< One cycle per setSyncLength() beats at the host tempo, counted from the last retrigger()
+    Transport,  ///< Locked to the host's song position, one cycle per setSyncLength() beats from beat 0
+};
+
 /**
  * The audio-thread part of the MSEG modulation source system.
  *
@@ -15,41 +29,156 @@ class MSEGModulator {
 public:
     MSEGModulator() = default;
 
-    MSEGModulator(MSEGCurve<>* curve, float sample_rate)
+    MSEGModulator(const MSEGCurve<>* curve, float sample_rate)
         : curve_(curve), sample_rate_(sample_rate) {}
 
     float process(int num_samples) {
+        pickUpHandoff();
         advancePhase(num_samples);
-        value_ = curve_->evaluate(phase_);
+        value_ = table_ ? table_->evaluate(phase_) : curve_->evaluate(phase_);
         return value_;
     }
 
+    /**
+     * Renders num_samples per-sample values into out, for audio-rate envelopes. out[i] is the value after i + 1
+     * samples, so a block ends on the phase and value process(num_samples) would reach.
+     *
+     * A segment cursor carries over between calls. Within a segment the output steps by recurrence, an add for
+     * linear segments and a multiply for curved ones, so exp() only runs when the cursor enters a segment. The
+     * cursor is re-seeded from the curve at the start of every block, so curve and rate changes take effect on the
+     * next block and rounding can't accumulate across blocks. With a table set, each sample is a table read instead.
+     * In the synced modes the phase is re-derived from the beat position at the end of the block.
+     */
+    void processBlock(float* out, int num_samples);
+
     void reset() {
         phase_ = 0.0f;
         value_ = 0.0f;
+        beats_ = 0.0;
+        cursor_ = {};
+    }
+
+    /**
+     * Restarts the cycle, e.g. on note-on for poly modulators. Under MSEGSync::Transport the phase stays locked
+     * to the song position and this does nothing.
+     */
+    void retrigger() {
+        if (sync_ == MSEGSync::Transport) return;
+        phase_ = 0.0f;
+        beats_ = 0.0;
+    }
+
+    /**
+     * Takes the host tempo and, under MSEGSync::Transport while playing, the song position for this block; call
+     * once per block before processing, with ProcessContext::transport(). The phase is then derived from the beat
+     * position in double precision instead of integrated, so it doesn't drift from the timeline and follows seeks
+     * and loops. Without a transport, or while stopped, the beat position runs on at the last known tempo.
+     */
+    void syncToTransport(const clap_event_transport_t* transport) {
+        if (sync_ == MSEGSync::Free || !transport) return;
+        pickUpHandoff();  // phaseFromBeats() reads the curve, which an edit may have just retired
+        if (transport->flags & CLAP_TRANSPORT_HAS_TEMPO) tempo_ = transport->tempo;
+        if (sync_ == MSEGSync::Transport && (transport->flags & CLAP_TRANSPORT_HAS_BEATS_TIMELINE)
+            && (transport->flags & CLAP_TRANSPORT_IS_PLAYING)) {
+            beats_ = static_cast<double>(transport->song_pos_beats) / static_cast<double>(CLAP_BEATTIME_FACTOR);
+            phase_ = phaseFromBeats();
+        }
     }
 
+    void setSyncMode(MSEGSync sync) { sync_ = sync; }
+
+    /** Cycle length in beats for the synced modes. */
+    void setSyncLength(double beats) {
+        ASSERT(beats > 0.0, "MSEGModulator: sync length must be positive");
+        sync_length_ = beats;
+    }
+
+    /** Tempo for the synced modes until syncToTransport() reports one. */
+    void setTempo(double bpm) { tempo_ = bpm; }
+
+    [[nodiscard]] MSEGSync syncMode() const { return sync_; }
+
     void setRate(float hz) { rate_ = hz; }
     void setSampleRate(float sr) { sample_rate_ = sr; }
-    void setCurve(MSEGCurve<>* curve) { curve_ = curve; }
+    void setCurve(const MSEGCurve<>* curve) { curve_ = curve; }
+
+    /**
+     * Reads the curve from a baked table instead of evaluating it; nullptr goes back to the curve. The table's
+     * loop flag replaces the curve's. The table must stay alive, and unchanged, while it's set.
+     */
+    void setTable(const MSEGTable* table) { table_ = table; }
+
+    /**
+     * Reads the curve, and its table if baked, from handoff's current snapshot at the start of every process call,
+     * replacing setCurve() and setTable(); nullptr detaches. See MSEGCurveHandoff for the threading rules.
+     */
+    void setHandoff(const MSEGCurveHandoff* handoff) { handoff_ = handoff; }
 
     [[nodiscard]] float phase() const { return phase_; }
     [[nodiscard]] float value() const { return value_; }
 
 private:
     void advancePhase(int num_samples) {
+        if (sync_ != MSEGSync::Free) {
+            beats_ += beatsPerSample() * num_samples;
+            phase_ = phaseFromBeats();
+            return;
+        }
         phase_ += (rate_ / sample_rate_) * static_cast<float>(num_samples);
-        if (curve_->loop)
+        if (loops())
             phase_ = std::fmod(phase_, 1.0f);
         else
             phase_ = std::min(phase_, 1.0f);
     }
 
-    MSEGCurve<>* curve_ = nullptr;
+    [[nodiscard]] double beatsPerSample() const { return tempo_ / (60.0 * sample_rate_); }
+
+    // The synced phase at beats_; the only wrap per block
+    [[nodiscard]] float phaseFromBeats() const {
+        const double cycles = beats_ / sync_length_;
+        if (!loops()) return static_cast<float>(std::clamp(cycles, 0.0, 1.0));
+        return static_cast<float>(cycles - std::floor(cycles));
+    }
+
+    // processBlock() with a phase step of increment per sample
+    void renderBlock(float* out, int num_samples, float increment);
+
+    void pickUpHandoff() {
+        if (!handoff_) return;
+        const MSEGSnapshot& snapshot = handoff_->get();
+        curve_ = &snapshot.curve;
+        table_ = snapshot.table.isBaked() ? &snapshot.table : nullptr;
+    }
+
+    [[nodiscard]] bool loops() const { return table_ ? table_->loops() : curve_->loop; }
+
+    // Points the cursor at the part of the curve containing phase_, stepping by increment per sample
+    void seekCursor(float increment);
+
+    // value = base + scale * shape; each sample, shape = shape * ratio + step
+    struct SegmentCursor {
+        int segment = 0;  // Also the hint for the next seek
+        float end = 0.0f; // Phase at which the cursor has to move on
+        double base = 0.0;
+        double scale = 0.0;
+        double shape = 0.0;
+        double ratio = 1.0;
+        double step = 0.0;
+    };
+
+    const MSEGCurve<>* curve_ = nullptr;
+    const MSEGTable* table_ = nullptr;
+    const MSEGCurveHandoff* handoff_ = nullptr;
+    SegmentCursor cursor_;
     float phase_ = 0.0f;
     float rate_ = 1.0f;
     float sample_rate_ = 44100.0f;
     float value_ = 0.0f;
+
+    MSEGSync sync_ = MSEGSync::Free;
+    double sync_length_ = 1.0;
+    double tempo_ = 120.0;
+    double beats_ = 0.0;  // Beats since the last retrigger (Tempo) or song position (Transport)
 };
 
 } // namespace applause
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <applause/dsp/modulation/MSEGCurve.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/SampleType.h>
+#include <applause/util/SharedTables.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * An MSEGCurve baked into a fixed-resolution table over phase [0, 1], read back with linear interpolation.
+ *
+ * Evaluating a baked curve costs a multiply, two table reads and a lerp, whatever its point count or
+ * curvature, which pays off when many modulators share a curve (e.g. a poly MSEG in every voice). Rebake whenever
+ * the curve's points change, off the audio thread: bake() allocates. The table is then read-only and can be
+ * shared by any number of modulators.
+ *
+ * Resolution is the accuracy knob. Linear interpolation is exact on linear segments, and its error grows with the
+ * square of the curvature but shrinks with the square of the resolution. Corners between segments, where the
+ * slope jumps, dominate in practice: they're rounded off within one table interval, so that error only halves as
+ * the resolution doubles, and a step (two points at the same phase) is smeared over one interval. bake() reports
+ * the worst interpolation error it measured, and bakeWithin() raises the resolution until that error fits a
+ * tolerance.
+ *
+ * @code
+ * // UI thread, e.g. from MSEGDisplay::on_curve_changed
+ * table.bakeWithin(curve, 1e-4f);
+ *
+ * // Audio thread
+ * modulator.setTable(&table);
+ * @endcode
+ */
+class MSEGTable {
+public:
+    static constexpr size_t kDefaultResolution = 2048;
+    static constexpr size_t kMaxResolution = size_t(1) << 16;
+
+    /**
+     * Samples curve at resolution evenly spaced phases. Returns the largest difference from the exact curve found
+     * halfway between table entries, where linear interpolation is least accurate.
+     */
+    template <int MaxPoints>
+    float bake(const MSEGCurve<MaxPoints>& curve, size_t resolution = kDefaultResolution) {
+        ASSERT(resolution >= 2, "MSEGTable: resolution must be at least 2");
+        resolution = std::clamp<size_t>(resolution, 2, kMaxResolution);
+
+        values_.resize(resolution);
+        const auto last = static_cast<double>(resolution - 1);
+        for (size_t i = 0; i < resolution; ++i) {
+            values_[i] = curve.evaluate(static_cast<float>(static_cast<double>(i) / last));
+        }
+        scale_ = static_cast<float>(last);
+        loop_ = curve.loop;
+
+        float error = 0.0f;
+        for (size_t i = 0; i + 1 < resolution; ++i) {
+            const float mid = curve.evaluate(static_cast<float>((static_cast<double>(i) + 0.5) / last));
+            error = std::max(error, std::abs(0.5f * (values_[i] + values_[i + 1]) - mid));
+        }
+        return error;
+    }
+
+    /**
+     * Bakes at the lowest power-of-two resolution, from min_resolution up to kMaxResolution, whose interpolation
+     * error is within tolerance. Returns the error reached, which exceeds tolerance only if kMaxResolution
+     * wasn't enough, e.g. for a step in the curve.
+     */
+    template <int MaxPoints>
+    float bakeWithin(const MSEGCurve<MaxPoints>& curve, float tolerance, size_t min_resolution = 256) {
+        size_t resolution = std::clamp<size_t>(std::bit_ceil(min_resolution), 2, kMaxResolution);
+        float error = bake(curve, resolution);
+        while (error > tolerance && resolution < kMaxResolution) {
+            resolution *= 2;
+            error = bake(curve, resolution);
+        }
+        return error;
+    }
+
+    /**
+     * The table bakeWithin(curve, tolerance, min_resolution) produces, shared by every instance in the process that
+     * bakes the same curve (see SharedTables), e.g. a factory MSEG preset. Main or background thread.
+     */
+    template <int MaxPoints>
+    [[nodiscard]] static std::shared_ptr<const MSEGTable> bakeShared(const MSEGCurve<MaxPoints>& curve,
+                                                                     float tolerance, size_t min_resolution = 256) {
+        const auto count = static_cast<size_t>(std::max(curve.num_points, 0));
+        ContentHasher hasher;
+        for (size_t i = 0; i < count; ++i) hasher.add(curve.points[i].first).add(curve.points[i].second);
+        hasher.add(std::span<const float>(curve.curvature_power.data(), count));
+        const uint64_t key = hasher.add(curve.loop).add(tolerance).add(min_resolution).value();
+        return SharedTables::getOrBuild<MSEGTable>(key, [&] {
+            auto table = std::make_shared<MSEGTable>();
+            table->bakeWithin(curve, tolerance, min_resolution);
+            return table;
+        });
+    }
+
+    [[nodiscard]] bool isBaked() const noexcept { return !values_.empty(); }
+
+    [[nodiscard]] size_t getResolution() const noexcept { return values_.size(); }
+
+    /** Whether the baked curve loops; copied from MSEGCurve::loop. */
+    [[nodiscard]] bool loops() const noexcept { return loop_; }
+
+    /** The baked curve at phase, clamped to [0, 1]. 0 until baked. */
+    [[nodiscard]] float evaluate(float phase) const noexcept {
+        if (values_.size() < 2) return 0.0f;
+        const float position = std::clamp(phase, 0.0f, 1.0f) * scale_;
+        const size_t index = std::min(static_cast<size_t>(position), values_.size() - 2);
+        const float frac = position - static_cast<float>(index);
+        return values_[index] + frac * (values_[index + 1] - values_[index]);
+    }
+
+    /** evaluate() for a batch of phases, e.g. one voice per lane; the table reads are per lane. */
+    template <SimdBatch B>
+        requires std::same_as<scalar_t<B>, float>
+    [[nodiscard]] B evaluate(B phase) const noexcept {
+        if (values_.size() < 2) return B(0.0f);
+        const B position = xsimd::clip(phase, B(0.0f), B(1.0f)) * B(scale_);
+        const B index = xsimd::min(xsimd::floor(position), B(static_cast<float>(values_.size() - 2)));
+        const B frac = position - index;
+
+        alignas(64) float indices[B::size];
+        alignas(64) float lower[B::size];
+        alignas(64) float upper[B::size];
+        index.store_aligned(indices);
+        for (size_t lane = 0; lane < B::size; ++lane) {
+            const auto i = static_cast<size_t>(indices[lane]);
+            lower[lane] = values_[i];
+            upper[lane] = values_[i + 1];
+        }
+        const B a = B::load_aligned(lower);
+        return a + frac * (B::load_aligned(upper) - a);
+    }
+
+private:
+    std::vector<float> values_;
+    float scale_ = 0.0f;  // Phase to table position
+    bool loop_ = true;
+};
+
+}  // namespace applause
@@ -0,0 +1,63 @@
+#include "Wavetable.h"
+
+#include <applause/dsp/FFT.h>
+#include <applause/util/SharedTables.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace applause {
+std::shared_ptr<const Wavetable> Wavetable::shared(std::span<const float> samples, size_t frame_size) {
+    const uint64_t key = ContentHasher().add(samples).add(frame_size).value();
+    return SharedTables::getOrBuild<Wavetable>(key, [&] { return std::make_shared<Wavetable>(samples, frame_size); });
+}
+
+Wavetable::Wavetable(std::span<const float> samples, size_t frame_size)
+    : frame_size_(frame_size),
+      num_frames_(frame_size ? samples.size() / frame_size : 0),
+      num_levels_(frame_size ? static_cast<size_t>(std::countr_zero(frame_size)) : 0) {
+    ASSERT(frame_size >= 4 && std::has_single_bit(frame_size), "Wavetable: frame size must be a power of two >= 4");
+    ASSERT(num_frames_ > 0 && samples.size() % frame_size == 0, "Wavetable: samples must hold whole frames");
+    data_.resize(num_levels_ * num_frames_ * stride());
+
+    FFT fft(frame_size);
+    std::vector<float> re(fft.numBins());
+    std::vector<float> im(fft.numBins());
+    std::vector<float> filtered_re(fft.numBins());
+    std::vector<float> filtered_im(fft.numBins());
+    for (size_t frame = 0; frame < num_frames_; ++frame) {
+        fft.forward(samples.data() + frame * frame_size, re.data(), im.data());
+
+        for (size_t level = 0; level < num_levels_; ++level) {
+            // Keep DC and harmonics 1..maxHarmonic(level); never Nyquist
+            const size_t keep = std::min(maxHarmonic(level), frame_size / 2 - 1);
+            std::fill(filtered_re.begin(), filtered_re.end(), 0.0f);
+            std::fill(filtered_im.begin(), filtered_im.end(), 0.0f);
+            std::copy_n(re.begin(), keep + 1, filtered_re.begin());
+            std::copy_n(im.begin(), keep + 1, filtered_im.begin());
+
+            auto* out = data_.data() + (level * num_frames_ + frame) * stride();
+            fft.inverse(filtered_re.data(), filtered_im.data(), out);
+            out[frame_size] = out[0];
+        }
+    }
+}
+
+float Wavetable::evaluate(float phase, float morph, size_t level) const noexcept {
+    const float position = phase * static_cast<float>(frame_size_);
+    const size_t index = std::min(static_cast<size_t>(position), frame_size_ - 1);
+    const float frac = position - static_cast<float>(index);
+
+    const float frame_position = std::clamp(morph, 0.0f, 1.0f) * static_cast<float>(num_frames_ - 1);
+    const size_t frame = std::min(static_cast<size_t>(frame_position), num_frames_ > 1 ? num_frames_ - 2 : 0);
+    const float mix = frame_position - static_cast<float>(frame);
+
+    const float* a = table(level, frame);
+    const float sample_a = a[index] + frac * (a[index + 1] - a[index]);
+    if (num_frames_ == 1) return sample_a;
+    const float* b = table(level, frame + 1);
+    const float sample_b = b[index] + frac * (b[index + 1] - b[index]);
+    return sample_a + mix * (sample_b - sample_a);
+}
+
+}  // namespace applause
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <applause/util/DebugHelpers.h>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace applause {
+
+/**
+ * @brief A band-limited, mipmapped wavetable: a sequence of single-cycle frames, each precomputed at one
+ * band-limited copy per octave.
+ *
+ * Mip level l keeps harmonics up to frameSize() >> (l + 1) and drops everything above, so a voice playing at any
+ * pitch reads the richest level that has no harmonic past Nyquist (see levelFor()). Level 0 is the frame itself
+ * without its Nyquist bin; the last level is a pure fundamental.
+ *
+ * Building a Wavetable runs an FFT per frame and allocates every level, so construct it off the audio thread and
+ * hand it over through a RealtimeSwap<Wavetable>, as MSEGCurveHandoff does for MSEG curves. Once built it's
+ * read-only and shared by every oscillator that plays it. Memory is numLevels() * numFrames() * (frameSize() + 1)
+ * floats; each table repeats its first sample at the end so interpolation never wraps. shared() builds each distinct
+ * table once per process, however many plugin instances load it.
+ *
+ * @code
+ * // Background thread: a 256-frame table of 2048-sample cycles, baked to 11 levels per frame
+ * wavetable_swap_.publish(std::make_unique<Wavetable>(samples, 2048));
+ *
+ * // Audio thread, once per block
+ * wavetable_swap_.update();
+ * const Wavetable& table = *wavetable_swap_.get();
+ * @endcode
+ */
+class Wavetable {
+public:
+    /**
+     * Builds every mip level of the frames in samples, which holds samples.size() / frame_size consecutive
+     * single-cycle frames.
+     * @param frame_size Samples per frame; a power of two, at least 4
+     */
+    Wavetable(std::span<const float> samples, size_t frame_size);
+
+    /**
+     * The Wavetable of samples shared by every instance in the process (see SharedTables): built here the first
+     * time, then reused while anyone holds it. Main or background thread.
+     */
+    [[nodiscard]] static std::shared_ptr<const Wavetable> shared(std::span<const float> samples, size_t frame_size);
+
+    [[nodiscard]] size_t frameSize() const noexcept { return frame_size_; }
+
+    [[nodiscard]] size_t numFrames() const noexcept { return num_frames_; }
+
+    [[nodiscard]] size_t numLevels() const noexcept { return num_levels_; }
+
+    /** The highest harmonic level keeps. */
+    [[nodiscard]] size_t maxHarmonic(size_t level) const noexcept { return frame_size_ >> (level + 1); }
+
+    /**
+     * The richest level that doesn't alias at increment cycles per sample (frequency / sample rate), i.e. whose
+     * highest harmonic stays at or below Nyquist.
+     */
+    [[nodiscard]] size_t levelFor(float increment) const noexcept {
+        const float harmonics = static_cast<float>(frame_size_) * increment;
+        size_t level = 0;
+        while (level + 1 < num_levels_ && static_cast<float>(size_t(1) << level) < harmonics) ++level;
+        return level;
+    }
+
+    /** The frameSize() + 1 samples of frame at level; the last repeats the first. */
+    [[nodiscard]] const float* table(size_t level, size_t frame) const noexcept {
+        ASSERT(level < num_levels_ && frame < num_frames_, "Wavetable: level or frame out of range");
+        return data_.data() + (level * num_frames_ + frame) * stride();
+    }
+
+    /**
+     * The table read at phase in [0, 1) and frame position morph in [0, 1], interpolating linearly along the
+     * cycle and between the two nearest frames.
+     */
+    [[nodiscard]] float evaluate(float phase, float morph, size_t level) const noexcept;
+
+private:
+    [[nodiscard]] size_t stride() const noexcept { return frame_size_ + 1; }
+
+    size_t frame_size_ = 0;
+    size_t num_frames_ = 0;
+    size_t num_levels_ = 0;
+    std::vector<float> data_;  // [level][frame][sample]
+};
+
+}  // namespace applause
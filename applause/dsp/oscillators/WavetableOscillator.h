@@ -0,0 +1,168 @@
+#pragma once
+
+#include <applause/core/ModMatrix.h>
+#include <applause/dsp/oscillators/Wavetable.h>
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/SampleType.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause {
+
+/**
+ * @brief Plays a Wavetable with frame morphing, one voice per SIMD lane.
+ *
+ * With V = float this is one voice, for a SynthesizerVoice. With V = xsimd::batch<float> every lane is a voice,
+ * for a SynthesizerVoiceGroup: phases and morph positions advance in SIMD, and only the table reads are per lane.
+ * Each process() call picks every lane's mip level once from its frequency, reads the cycle with linear
+ * interpolation, and crossfades between the two frames nearest its morph position, which ramps linearly across the
+ * block.
+ *
+ * Pitch and morph usually come from ModMatrix handles, once per block:
+ *
+ * @code
+ * // SynthesizerVoice::process()
+ * osc_.setModulation(note_.getFrequency(), pitch_handle_, morph_handle_);
+ * osc_.process(*wavetable_, scratch_.data(), num_samples);
+ * @endcode
+ *
+ * @tparam V float, or xsimd::batch<float> for one voice per lane
+ */
+template <typename V = float>
+    requires Sample<V> && std::same_as<scalar_t<V>, float>
+class WavetableOscillator {
+public:
+    static constexpr size_t kLanes = sampleWidth<V>();
+
+    void setSampleRate(double sample_rate) {
+        ASSERT(sample_rate > 0.0, "WavetableOscillator: sample rate must be positive");
+        const auto ratio = static_cast<float>(sample_rate_ / sample_rate);
+        increment_ *= V(ratio);
+        sample_rate_ = sample_rate;
+    }
+
+    /** Sets the frequency in Hz, per lane. */
+    void setFrequency(V hz) noexcept { increment_ = hz * V(static_cast<float>(1.0 / sample_rate_)); }
+
+    /** Sets the frame position in [0, 1], per lane, for the next process() calls. */
+    void setMorph(V morph) noexcept { morph_start_ = morph_end_ = morph; }
+
+    /** Ramps the frame position from start to end across the next process() call. */
+    void setMorph(V start, V end) noexcept {
+        morph_start_ = start;
+        morph_end_ = end;
+    }
+
+    /**
+     * Sets one voice's pitch and morph from ModMatrix handles: base_hz transposed by pitch's value in semitones,
+     * and morph ramped across the block from the handle's start value to its value.
+     */
+    void setModulation(double base_hz, const ModParamHandle& pitch, const ModParamHandle& morph) noexcept
+        requires (kLanes == 1)
+    {
+        setFrequency(static_cast<float>(base_hz * std::exp2(pitch.getValue() / 12.0)));
+        setMorph(morph.getStartValue(), morph.getValue());
+    }
+
+    /** setModulation() for every lane; lanes whose handles are null play base_hz unmodulated at morph 0. */
+    void setModulation(std::span<const double, kLanes> base_hz, std::span<const ModParamHandle, kLanes> pitch,
+                       std::span<const ModParamHandle, kLanes> morph) noexcept
+        requires (kLanes > 1)
+    {
+        alignas(64) std::array<float, kLanes> hz;
+        alignas(64) std::array<float, kLanes> start;
+        alignas(64) std::array<float, kLanes> end;
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            const double semitones = pitch[lane].value_ ? pitch[lane].getValue() : 0.0;
+            hz[lane] = static_cast<float>(base_hz[lane] * std::exp2(semitones / 12.0));
+            start[lane] = morph[lane].value_ ? morph[lane].getStartValue() : 0.0f;
+            end[lane] = morph[lane].value_ ? morph[lane].getValue() : 0.0f;
+        }
+        setFrequency(V::load_aligned(hz.data()));
+        setMorph(V::load_aligned(start.data()), V::load_aligned(end.data()));
+    }
+
+    /** Restarts the cycle, e.g. on note-on; phase is in [0, 1). */
+    void resetPhase(V phase = V(0.0f)) noexcept { phase_ = phase; }
+
+    [[nodiscard]] V getPhase() const noexcept { return phase_; }
+
+    /** Renders num_samples samples of table into out, overwriting it. */
+    void process(const Wavetable& table, V* out, int num_samples) noexcept {
+        if (num_samples <= 0) return;
+        const size_t frame_size = table.frameSize();
+        const size_t num_frames = table.numFrames();
+        const auto frame_range = static_cast<float>(num_frames - 1);
+
+        // One mip level per lane for the whole block
+        alignas(64) std::array<float, kLanes> increments;
+        std::array<size_t, kLanes> levels;
+        store_aligned(increment_, increments.data());
+        for (size_t lane = 0; lane < kLanes; ++lane) levels[lane] = table.levelFor(std::abs(increments[lane]));
+
+        const V morph_step = (morph_end_ - morph_start_) / V(static_cast<float>(num_samples));
+        V morph = morph_start_;
+        V phase = phase_;
+        const V size(static_cast<float>(frame_size));
+
+        alignas(64) std::array<float, kLanes> positions;
+        alignas(64) std::array<float, kLanes> frame_positions;
+        alignas(64) std::array<float, kLanes> a0, a1, b0, b1;
+        for (int i = 0; i < num_samples; ++i) {
+            const V position = phase * size;
+            const V frame_position = clampUnit(morph) * V(frame_range);
+            const V index = floor(position);
+            const V frame = applause::min(floor(frame_position), V(std::max(frame_range - 1.0f, 0.0f)));
+            store_aligned(index, positions.data());
+            store_aligned(frame, frame_positions.data());
+
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                const auto sample = std::min(static_cast<size_t>(positions[lane]), frame_size - 1);
+                const auto f = static_cast<size_t>(frame_positions[lane]);
+                const float* a = table.table(levels[lane], f);
+                const float* b = num_frames > 1 ? table.table(levels[lane], f + 1) : a;
+                a0[lane] = a[sample];
+                a1[lane] = a[sample + 1];
+                b0[lane] = b[sample];
+                b1[lane] = b[sample + 1];
+            }
+
+            const V frac = position - index;
+            const V mix = frame_position - frame;
+            const V sample_a = lerp(load_aligned<V>(a0.data()), load_aligned<V>(a1.data()), frac);
+            const V sample_b = lerp(load_aligned<V>(b0.data()), load_aligned<V>(b1.data()), frac);
+            out[i] = lerp(sample_a, sample_b, mix);
+
+            phase += increment_;
+            phase -= floor(phase);
+            morph += morph_step;
+        }
+        phase_ = phase;
+        morph_start_ = morph_end_;
+    }
+
+private:
+    static V floor(V x) noexcept {
+        if constexpr (SimdBatch<V>) return xsimd::floor(x);
+        else return std::floor(x);
+    }
+
+    static V clampUnit(V x) noexcept { return applause::min(applause::max(x, V(0.0f)), V(1.0f)); }
+
+    static V lerp(V a, V b, V t) noexcept { return applause::fma(t, b - a, a); }
+
+    double sample_rate_ = 44100.0;
+    V phase_ = V(0.0f);
+    V increment_ = V(0.0f);  // Cycles per sample
+    V morph_start_ = V(0.0f);
+    V morph_end_ = V(0.0f);
+};
+
+}  // namespace applause
@@ -0,0 +1,153 @@
+#include "SampleStreamer.h"
+
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace applause {
+SampleStream::SampleStream(size_t max_channels, size_t ring_frames)
+    : max_channels_(std::max<size_t>(max_channels, 1)),
+      ring_frames_(std::bit_ceil(std::max<size_t>(ring_frames, 2))),
+      ring_(max_channels_ * ring_frames_, 0.0f),
+      fill_channels_(max_channels_) {}
+
+void SampleStream::start(const StreamingSample& sample, size_t start_frame) noexcept {
+    local_generation_ = (local_generation_ + 1) & 0xffff;
+    sample_ = &sample;
+    local_disk_start_ = std::max(start_frame, sample.headFrames());
+    local_consumed_ = 0;
+
+    // The streamer reads these after seeing the new generation
+    shared_sample_.store(&sample, std::memory_order_relaxed);
+    disk_start_.store(local_disk_start_, std::memory_order_relaxed);
+    consumed_.store(tag(local_generation_, 0), std::memory_order_relaxed);
+    generation_.store(local_generation_, std::memory_order_release);
+}
+
+void SampleStream::stop() noexcept {
+    if (!sample_) return;
+    local_generation_ = (local_generation_ + 1) & 0xffff;
+    sample_ = nullptr;
+    shared_sample_.store(nullptr, std::memory_order_relaxed);
+    generation_.store(local_generation_, std::memory_order_release);
+}
+
+bool SampleStream::read(size_t first, size_t count, float* const* out, size_t num_out_channels) noexcept {
+    const size_t out_channels =
+        sample_ ? std::min({num_out_channels, sample_->numChannels(), max_channels_}) : num_out_channels;
+    if (!sample_) {
+        for (size_t ch = 0; ch < out_channels; ++ch) std::fill_n(out[ch], count, 0.0f);
+        return true;
+    }
+
+    // Everything before first has been played; let the streamer reuse its slots
+    if (first > local_disk_start_ && first - local_disk_start_ > local_consumed_) {
+        local_consumed_ = first - local_disk_start_;
+        consumed_.store(tag(local_generation_, local_consumed_), std::memory_order_release);
+    }
+
+    const uint64_t written = written_.load(std::memory_order_acquire);
+    const uint64_t fetched = generationOf(written) == local_generation_ ? (written & kFrameMask) : 0;
+    const size_t head = sample_->headFrames();
+    const size_t end = sample_->numFrames();
+    bool complete = true;
+
+    for (size_t ch = 0; ch < out_channels; ++ch) {
+        float* dst = out[ch];
+        const float* head_samples = sample_->head(ch);
+        const float* ring = ringChannel(ch);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t frame = first + i;
+            if (frame < head) {
+                dst[i] = head_samples[frame];
+            } else if (frame >= end || frame < local_disk_start_) {
+                dst[i] = 0.0f;
+            } else if (const size_t offset = frame - local_disk_start_; offset < fetched) {
+                dst[i] = ring[offset & (ring_frames_ - 1)];
+            } else {
+                dst[i] = 0.0f;
+                complete = false;
+            }
+        }
+    }
+    if (!complete) underruns_.fetch_add(1, std::memory_order_relaxed);
+    return complete;
+}
+
+size_t SampleStream::fill(size_t max_frames) noexcept {
+    const uint32_t generation = generation_.load(std::memory_order_acquire);
+    const StreamingSample* sample = shared_sample_.load(std::memory_order_relaxed);
+    const size_t disk_start = disk_start_.load(std::memory_order_relaxed);
+    const uint64_t consumed = consumed_.load(std::memory_order_acquire);
+    // Restarted while reading the above; the next pass sees the whole new request
+    if (!sample || generationOf(consumed) != generation || generation_.load(std::memory_order_acquire) != generation) {
+        return 0;
+    }
+
+    const uint64_t written = written_.load(std::memory_order_relaxed);
+    uint64_t fetched = generationOf(written) == generation ? (written & kFrameMask) : 0;
+    const uint64_t played = consumed & kFrameMask;
+    fetched = std::max(fetched, played);  // After an underrun the audio thread is ahead; skip what it passed
+
+    const size_t total = sample->numFrames() > disk_start ? sample->numFrames() - disk_start : 0;
+    const size_t room = ring_frames_ - static_cast<size_t>(fetched - played);
+    const size_t count = std::min({max_frames, room, total > fetched ? total - static_cast<size_t>(fetched) : 0});
+    if (count == 0) return 0;
+
+    // Decode in at most two runs, around the ring's wrap
+    size_t done = 0;
+    while (done < count) {
+        const size_t slot = static_cast<size_t>(fetched + done) & (ring_frames_ - 1);
+        const size_t run = std::min(count - done, ring_frames_ - slot);
+        for (size_t ch = 0; ch < max_channels_; ++ch) fill_channels_[ch] = ringChannel(ch) + slot;
+        sample->decode(disk_start + static_cast<size_t>(fetched) + done, run, fill_channels_.data(), max_channels_);
+        done += run;
+    }
+    written_.store(tag(generation, fetched + count), std::memory_order_release);
+    return count;
+}
+
+SampleStreamer::SampleStreamer(const SampleStreamerConfig& config) : config_(config) {
+    ASSERT(config.chunk_frames > 0, "SampleStreamer: chunk_frames must be positive");
+    config_.chunk_frames = std::max<size_t>(config.chunk_frames, 1);
+    streams_.reserve(config.num_streams);
+    for (size_t i = 0; i < config.num_streams; ++i) {
+        streams_.push_back(std::make_unique<SampleStream>(config.max_channels, config.ring_frames));
+    }
+}
+
+SampleStreamer::~SampleStreamer() { stop(); }
+
+void SampleStreamer::start() {
+    if (thread_.joinable()) return;
+    stop_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this] { run(); });
+}
+
+void SampleStreamer::stop() {
+    if (!thread_.joinable()) return;
+    stop_.store(true, std::memory_order_relaxed);
+    thread_.join();
+}
+
+void SampleStreamer::run() {
+    while (!stop_.load(std::memory_order_relaxed)) {
+        if (service() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+size_t SampleStreamer::service() noexcept {
+    size_t fetched = 0;
+    for (auto& stream : streams_) fetched += stream->fill(config_.chunk_frames);
+    return fetched;
+}
+
+uint64_t SampleStreamer::getUnderruns() const noexcept {
+    uint64_t total = 0;
+    for (const auto& stream : streams_) total += stream->getUnderruns();
+    return total;
+}
+
+}  // namespace applause
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <applause/dsp/sampler/StreamingSample.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace applause {
+
+/**
+ * @brief One voice's playback of a StreamingSample: the sample's resident head, then a lock-free ring buffer that
+ * SampleStreamer's thread keeps filled from the file.
+ *
+ * The audio thread start()s a stream and read()s frames from it in order; nothing it calls locks, allocates or
+ * touches the file. Frames before headFrames() come straight from the head, so a voice that starts at frame 0
+ * sounds immediately, and the streamer thread has until the head runs out to fetch what follows. A voice starting
+ * past the head plays silence until its first frames arrive.
+ *
+ * Frames that aren't in the ring when read() wants them are an underrun: read() returns silence for them and
+ * counts it, and playback keeps its timing, so the stream skips ahead rather than falling behind. Underruns mean
+ * the head is too short for the disk, or the ring too small for the playback rate.
+ *
+ * Single producer, single consumer: the stream's owner (a voice) on the audio thread, and SampleStreamer.
+ */
+class SampleStream {
+public:
+    SampleStream(size_t max_channels, size_t ring_frames);
+
+    SampleStream(const SampleStream&) = delete;
+    SampleStream& operator=(const SampleStream&) = delete;
+
+    /** Audio thread: plays sample from start_frame, abandoning whatever played before. Never blocks. */
+    void start(const StreamingSample& sample, size_t start_frame = 0) noexcept;
+
+    /** Audio thread: stops playback; the streamer stops fetching for this stream. */
+    void stop() noexcept;
+
+    [[nodiscard]] bool isPlaying() const noexcept { return sample_ != nullptr; }
+
+    /** Audio thread: the sample playing, or nullptr. */
+    [[nodiscard]] const StreamingSample* sample() const noexcept { return sample_; }
+
+    /**
+     * Audio thread: copies frames [first, first + count) into out, one array per channel, up to the sample's and the
+     * stream's channel counts. Frames past the sample's end are silent. Reading at first also tells the streamer
+     * that every frame before it has been played, so read in increasing order, and at most ringFrames() frames at a
+     * time. Returns false if some frames weren't fetched in time; they're left silent and counted as one underrun.
+     */
+    bool read(size_t first, size_t count, float* const* out, size_t num_out_channels) noexcept;
+
+    /** Underruns since this stream was created. Any thread. */
+    [[nodiscard]] uint32_t getUnderruns() const noexcept { return underruns_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t ringFrames() const noexcept { return ring_frames_; }
+
+    /** Channels the ring holds. */
+    [[nodiscard]] size_t numChannels() const noexcept { return max_channels_; }
+
+private:
+    friend class SampleStreamer;
+
+    // The producer and consumer positions carry the generation they belong to in their top bits, so positions left
+    // over from before a start() are told apart from the new playback's without a lock
+    static constexpr int kGenerationShift = 48;
+    static constexpr uint64_t kFrameMask = (uint64_t(1) << kGenerationShift) - 1;
+    static constexpr uint64_t tag(uint32_t generation, uint64_t frames) noexcept {
+        return (static_cast<uint64_t>(generation) << kGenerationShift) | (frames & kFrameMask);
+    }
+    static constexpr uint32_t generationOf(uint64_t tagged) noexcept {
+        return static_cast<uint32_t>(tagged >> kGenerationShift);
+    }
+
+    /** Streamer thread: fetches up to max_frames more frames if there is room. Returns the frames fetched. */
+    size_t fill(size_t max_frames) noexcept;
+
+    [[nodiscard]] float* ringChannel(size_t ch) noexcept { return ring_.data() + ch * ring_frames_; }
+
+    const size_t max_channels_;
+    const size_t ring_frames_;  // A power of two
+    std::vector<float> ring_;   // [channel][frame], frames relative to disk_start_ modulo ring_frames_
+    std::vector<float*> fill_channels_;
+
+    // Audio thread only
+    const StreamingSample* sample_ = nullptr;
+    uint32_t local_generation_ = 0;
+    size_t local_disk_start_ = 0;
+    uint64_t local_consumed_ = 0;
+
+    // Published by the audio thread for the streamer: what to fetch, and what has been played
+    std::atomic<uint32_t> generation_{0};
+    std::atomic<const StreamingSample*> shared_sample_{nullptr};
+    std::atomic<size_t> disk_start_{0};  // The first frame the ring holds; everything before comes from the head
+    std::atomic<uint64_t> consumed_{0};  // Tagged frame count past disk_start_ the audio thread no longer needs
+
+    // Published by the streamer for the audio thread
+    std::atomic<uint64_t> written_{0};  // Tagged frame count past disk_start_ fetched into the ring
+    std::atomic<uint32_t> underruns_{0};
+};
+
+/** How SampleStreamer sizes its streams. */
+struct SampleStreamerConfig {
+    size_t num_streams = 16;    ///< One per voice that can play a streamed sample
+    size_t max_channels = 2;    ///< Channels fetched per stream; further channels of a sample are ignored
+    size_t ring_frames = 32768;  ///< Ring buffer per stream and channel, rounded up to a power of two
+    size_t chunk_frames = 4096;  ///< Frames fetched per stream per pass, so every stream gets a turn
+};
+
+/**
+ * @brief The background side of disk streaming: owns one SampleStream per voice and a thread that keeps their ring
+ * buffers filled from the samples' memory-mapped files.
+ *
+ * Each pass gives every playing stream one chunk of up to chunk_frames frames, round robin, so a voice that just
+ * started doesn't wait for another's ring to fill; passes repeat until every ring is full or at its sample's end,
+ * then the thread sleeps for a millisecond. The rings take max_channels * ring_frames floats per stream, allocated
+ * once in the constructor.
+ *
+ * @code
+ * // Plugin members: a stream per voice, handed to the voices once
+ * SampleStreamer streamer_{{.num_streams = 64}};
+ * for (auto& voice : synth_.getVoices()) voice.setStream(&streamer_.stream(voice.getVoiceIndex()));
+ *
+ * // activate() / deactivate()
+ * streamer_.start();
+ * streamer_.stop();
+ * @endcode
+ */
+class SampleStreamer {
+public:
+    explicit SampleStreamer(const SampleStreamerConfig& config = {});
+
+    /** Stops the thread. */
+    ~SampleStreamer();
+
+    SampleStreamer(const SampleStreamer&) = delete;
+    SampleStreamer& operator=(const SampleStreamer&) = delete;
+
+    /** Starts fetching on a background thread; does nothing if it's already running. */
+    void start();
+
+    /** Stops and joins the background thread. */
+    void stop();
+
+    [[nodiscard]] bool isRunning() const noexcept { return thread_.joinable(); }
+
+    /**
+     * Gives every playing stream one chunk, if its ring has room. The background thread calls this in a loop; call
+     * it directly only while the thread isn't running, e.g. from a test. Returns the frames fetched.
+     */
+    size_t service() noexcept;
+
+    [[nodiscard]] size_t numStreams() const noexcept { return streams_.size(); }
+
+    [[nodiscard]] SampleStream& stream(size_t index) noexcept { return *streams_[index]; }
+
+    /** Underruns across every stream. Any thread. */
+    [[nodiscard]] uint64_t getUnderruns() const noexcept;
+
+private:
+    void run();
+
+    SampleStreamerConfig config_;
+    std::vector<std::unique_ptr<SampleStream>> streams_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+}  // namespace applause
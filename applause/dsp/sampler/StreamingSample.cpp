@@ -0,0 +1,135 @@
+#include "StreamingSample.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace applause {
+namespace {
+
+uint16_t readU16(const uint8_t* p) noexcept { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+uint32_t readU32(const uint8_t* p) noexcept {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+constexpr uint16_t kWavePcm = 1;
+constexpr uint16_t kWaveFloat = 3;
+constexpr uint16_t kWaveExtensible = 0xfffe;
+
+}  // namespace
+
+std::optional<SampleFormat> parseWavFormat(std::span<const uint8_t> file) {
+    if (file.size() < 12 || std::memcmp(file.data(), "RIFF", 4) != 0 || std::memcmp(file.data() + 8, "WAVE", 4) != 0) {
+        return std::nullopt;
+    }
+
+    SampleFormat format;
+    bool have_fmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= file.size()) {
+        const uint8_t* chunk = file.data() + pos;
+        const size_t size = readU32(chunk + 4);
+        const size_t body = pos + 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (size < 16 || body + size > file.size()) return std::nullopt;
+            const uint8_t* fmt = file.data() + body;
+            uint16_t tag = readU16(fmt);
+            if (tag == kWaveExtensible && size >= 26) tag = readU16(fmt + 24);  // The sub-format GUID's first field
+            const uint16_t bits = readU16(fmt + 14);
+
+            if (tag == kWavePcm && bits == 16) {
+                format.encoding = SampleEncoding::Int16;
+            } else if (tag == kWavePcm && bits == 24) {
+                format.encoding = SampleEncoding::Int24;
+            } else if (tag == kWaveFloat && bits == 32) {
+                format.encoding = SampleEncoding::Float32;
+            } else {
+                return std::nullopt;
+            }
+            format.num_channels = readU16(fmt + 2);
+            format.sample_rate = readU32(fmt + 4);
+            if (format.num_channels == 0 || format.sample_rate <= 0.0) return std::nullopt;
+            have_fmt = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt) return std::nullopt;
+            format.data_offset = body;
+            const size_t bytes = std::min(size, file.size() - body);
+            format.num_frames = bytes / format.bytesPerFrame();
+            return format;
+        }
+        pos = body + size + (size & 1);  // Chunks are padded to even sizes
+    }
+    return std::nullopt;
+}
+
+bool StreamingSample::open(const std::filesystem::path& path, size_t head_frames) {
+    *this = StreamingSample();
+    if (!file_.open(path)) return false;
+    const auto format = parseWavFormat(file_.bytes());
+    if (!format) return false;
+    format_ = *format;
+    return load(head_frames);
+}
+
+bool StreamingSample::open(const std::filesystem::path& path, const SampleFormat& format, size_t head_frames) {
+    *this = StreamingSample();
+    if (format.num_channels == 0 || !file_.open(path)) return false;
+    format_ = format;
+    const size_t available = format.data_offset < file_.size() ? file_.size() - format.data_offset : 0;
+    format_.num_frames = std::min(format.num_frames, available / format.bytesPerFrame());
+    return load(head_frames);
+}
+
+bool StreamingSample::load(size_t head_frames) {
+    head_frames_ = std::min(head_frames, format_.num_frames);
+    head_.assign(head_frames_ * format_.num_channels, 0.0f);
+    std::vector<float*> channels(format_.num_channels);
+    for (size_t ch = 0; ch < channels.size(); ++ch) channels[ch] = head_.data() + ch * head_frames_;
+    decode(0, head_frames_, channels.data(), channels.size());
+    return true;
+}
+
+size_t StreamingSample::decode(size_t first, size_t count, float* const* out, size_t num_out_channels) const noexcept {
+    if (first >= format_.num_frames) return 0;
+    count = std::min(count, format_.num_frames - first);
+    const size_t out_channels = std::min<size_t>(num_out_channels, format_.num_channels);
+    const size_t frame_bytes = format_.bytesPerFrame();
+    const uint8_t* frames = file_.data() + format_.data_offset + first * frame_bytes;
+
+    // One loop per encoding, so the switch stays out of the per-sample path
+    const auto convert = [&](size_t sample_bytes, auto&& read) {
+        for (size_t ch = 0; ch < out_channels; ++ch) {
+            const uint8_t* in = frames + ch * sample_bytes;
+            float* dst = out[ch];
+            for (size_t i = 0; i < count; ++i, in += frame_bytes) dst[i] = read(in);
+        }
+    };
+    switch (format_.encoding) {
+        case SampleEncoding::Int16:
+            convert(2, [](const uint8_t* p) {
+                return static_cast<float>(static_cast<int16_t>(readU16(p))) * (1.0f / 32768.0f);
+            });
+            break;
+        case SampleEncoding::Int24:
+            // Assembled in the top 24 bits, so the shift back sign-extends
+            convert(3, [](const uint8_t* p) {
+                const auto s = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                                    (static_cast<uint32_t>(p[1]) << 16) |
+                                                    (static_cast<uint32_t>(p[2]) << 24));
+                return static_cast<float>(s >> 8) * (1.0f / 8388608.0f);
+            });
+            break;
+        case SampleEncoding::Float32:
+            convert(4, [](const uint8_t* p) {
+                float value;
+                std::memcpy(&value, p, 4);
+                return value;
+            });
+            break;
+    }
+    return count;
+}
+
+}  // namespace applause
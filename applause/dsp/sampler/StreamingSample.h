@@ -0,0 +1,107 @@
+#pragma once
+
+#include <applause/util/MappedFile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace applause {
+
+/** How the interleaved PCM frames of a sample file are stored. */
+enum class SampleEncoding : uint8_t {
+    Int16,    ///< 16-bit signed little-endian
+    Int24,    ///< 24-bit signed little-endian, packed in 3 bytes
+    Float32,  ///< 32-bit IEEE float
+};
+
+/** Where a sample's frames are in its file, and how to read them. */
+struct SampleFormat {
+    size_t data_offset = 0;  ///< Byte offset of the first frame
+    size_t num_frames = 0;
+    uint16_t num_channels = 0;
+    SampleEncoding encoding = SampleEncoding::Int16;
+    double sample_rate = 44100.0;
+
+    [[nodiscard]] size_t bytesPerFrame() const noexcept {
+        const size_t bytes = encoding == SampleEncoding::Int16 ? 2 : encoding == SampleEncoding::Int24 ? 3 : 4;
+        return bytes * num_channels;
+    }
+};
+
+/**
+ * Reads the format of a RIFF/WAVE file: 16- or 24-bit PCM or 32-bit float, including WAVE_FORMAT_EXTENSIBLE.
+ * nullopt for anything else, or if the fmt or data chunk is missing; a data chunk cut short by the end of the file
+ * is clamped to the frames present.
+ */
+[[nodiscard]] std::optional<SampleFormat> parseWavFormat(std::span<const uint8_t> file);
+
+/**
+ * @brief One sample of a streamed instrument: its file memory-mapped, and its first headFrames() frames decoded
+ * and resident.
+ *
+ * The head is what a voice plays while SampleStreamer's thread fetches the rest into the voice's SampleStream, so
+ * it has to outlast the prefetch latency; the default, 16384 frames, gives the thread about a third of a second at
+ * 48 kHz. A library of thousands of samples then costs its heads in memory, and the rest only the pages of the
+ * mapping that are being read: the file is never read on the audio thread, so page faults land on the streamer's
+ * thread.
+ *
+ * Open samples on the main or a background thread. A sample must outlive every SampleStream playing it: replace a
+ * library only while no voice plays from it, e.g. between deactivate() and activate().
+ *
+ * @code
+ * StreamingSample piano_c4;
+ * if (!piano_c4.open(library / "C4.wav")) LOG_ERR("Couldn't open C4.wav");
+ * @endcode
+ */
+class StreamingSample {
+public:
+    static constexpr size_t kDefaultHeadFrames = 16384;
+
+    StreamingSample() = default;
+    StreamingSample(StreamingSample&&) noexcept = default;
+    StreamingSample& operator=(StreamingSample&&) noexcept = default;
+    StreamingSample(const StreamingSample&) = delete;
+    StreamingSample& operator=(const StreamingSample&) = delete;
+
+    /** Maps the WAV file at path and decodes its head; false if it can't be opened or has an unsupported format. */
+    bool open(const std::filesystem::path& path, size_t head_frames = kDefaultHeadFrames);
+
+    /** Maps a headerless file whose frames are laid out as format says, and decodes its head. */
+    bool open(const std::filesystem::path& path, const SampleFormat& format, size_t head_frames = kDefaultHeadFrames);
+
+    [[nodiscard]] bool isOpen() const noexcept { return format_.num_channels > 0; }
+
+    [[nodiscard]] const SampleFormat& format() const noexcept { return format_; }
+
+    [[nodiscard]] size_t numFrames() const noexcept { return format_.num_frames; }
+
+    [[nodiscard]] size_t numChannels() const noexcept { return format_.num_channels; }
+
+    [[nodiscard]] double sampleRate() const noexcept { return format_.sample_rate; }
+
+    /** Frames resident in memory; all of them for a sample shorter than the head. */
+    [[nodiscard]] size_t headFrames() const noexcept { return head_frames_; }
+
+    /** The resident head of channel, headFrames() samples. Safe on the audio thread. */
+    [[nodiscard]] const float* head(size_t channel) const noexcept { return head_.data() + channel * head_frames_; }
+
+    /**
+     * Decodes count frames from first (clamped to the sample) into out, one array per channel up to numChannels();
+     * returns the frames decoded. Reads the mapping, which may fault pages in from disk: never on the audio thread.
+     */
+    size_t decode(size_t first, size_t count, float* const* out, size_t num_out_channels) const noexcept;
+
+private:
+    bool load(size_t head_frames);
+
+    MappedFile file_;
+    SampleFormat format_{};
+    size_t head_frames_ = 0;
+    std::vector<float> head_;  // [channel][frame]
+};
+
+}  // namespace applause
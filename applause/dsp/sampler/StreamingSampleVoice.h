@@ -0,0 +1,156 @@
+#pragma once
+#include <applause/dsp/Synthesizer.h>
+#include <applause/dsp/sampler/SampleStreamer.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace applause {
+
+/**
+ * A Synthesizer voice that plays a StreamingSample through its SampleStream, resampled to the note's pitch with
+ * linear interpolation.
+ *
+ * Derive from it and pick the sample in noteOn(), e.g. from a key map, then call startSample(); starting only
+ * publishes the request to the streamer, so it never blocks, and the sample's head plays while the rest streams
+ * in. The voice finishes at the end of the sample, or after a linear fade of getReleaseTime() once released.
+ * Missing frames play as silence and show up in SampleStream::getUnderruns().
+ *
+ * A mono sample plays on every output channel; otherwise sample channel i goes to output channel i.
+ *
+ * @code
+ * class PianoVoice : public StreamingSampleVoice<float, 2> {
+ * public:
+ *     void noteOn() override {
+ *         const Zone& zone = zoneFor(note_.key, note_.velocity);
+ *         startSample(zone.sample, zone.root_frequency, 0, zone.gain);
+ *     }
+ * };
+ * @endcode
+ */
+template <Scalar T, size_t MaxChannels>
+class StreamingSampleVoice : public SynthesizerVoice<T, MaxChannels> {
+public:
+    /** The fastest playback, as a ratio of the sample's own rate: three octaves up. */
+    static constexpr double kMaxRate = 8.0;
+
+    /** Sets the stream this voice plays through, usually streamer.stream(getVoiceIndex()); once, at setup. */
+    void setStream(SampleStream* stream) noexcept { stream_ = stream; }
+
+    [[nodiscard]] SampleStream* getStream() const noexcept { return stream_; }
+
+    /** Sets the fade applied on release; takes effect at the next release. */
+    void setReleaseTime(double seconds) noexcept { release_seconds_ = std::max(seconds, 0.0); }
+
+    [[nodiscard]] double getReleaseTime() const noexcept { return release_seconds_; }
+
+    /**
+     * Audio thread, usually from noteOn(): plays sample from start_frame at the note's frequency, where
+     * root_frequency is the pitch the sample was recorded at.
+     */
+    void startSample(const StreamingSample& sample, double root_frequency, size_t start_frame = 0,
+                     T gain = T(1)) noexcept {
+        ASSERT(stream_, "StreamingSampleVoice: no stream set");
+        if (!stream_) return;
+        stream_->start(sample, start_frame);
+        root_frequency_ = root_frequency > 0.0 ? root_frequency : 440.0;
+        position_ = static_cast<double>(start_frame);
+        gain_ = gain;
+        level_ = T(1);
+        release_step_ = T(0);
+        updateRate();
+    }
+
+    void noteOff(bool terminate_now) override {
+        if (terminate_now || release_seconds_ <= 0.0) {
+            finish();
+            return;
+        }
+        release_step_ = static_cast<T>(1.0 / (release_seconds_ * this->getSampleRate()));
+    }
+
+    void onExpressionChange(Note::Expression expression_id, double value) override {
+        if (expression_id == Note::Expression::Tuning) updateRate();
+    }
+
+    [[nodiscard]] float getAmplitudeEstimate() const override { return static_cast<float>(gain_ * level_); }
+
+    void process(BufferView<T, MaxChannels> buffer, int start_sample, int num_samples) override {
+        if (!stream_ || !stream_->isPlaying()) {
+            if (this->isActive()) this->terminateVoice();
+            return;
+        }
+        const StreamingSample& sample = *stream_->sample();
+        const size_t sample_channels = std::min({sample.numChannels(), stream_->numChannels(), MaxChannels});
+        const size_t out_channels = buffer.numChannels();
+        std::array<float*, MaxChannels> scratch{};
+        for (size_t ch = 0; ch < sample_channels; ++ch) scratch[ch] = scratch_[ch].data();
+
+        for (int offset = 0; offset < num_samples; offset += static_cast<int>(kChunk)) {
+            if (position_ >= static_cast<double>(sample.numFrames())) {
+                finish();
+                return;
+            }
+            const auto frames = std::min<size_t>(kChunk, static_cast<size_t>(num_samples - offset));
+            const auto first = static_cast<size_t>(position_);
+            const auto last = static_cast<size_t>(position_ + rate_ * static_cast<double>(frames - 1)) + 1;
+            stream_->read(first, last - first + 1, scratch.data(), sample_channels);
+
+            // Linear fade while released; the voice ends when it reaches zero
+            T level = level_;
+            for (size_t ch = 0; ch < out_channels; ++ch) {
+                if (sample_channels > 1 && ch >= sample_channels) break;
+                const float* src = scratch[sample_channels > 1 ? ch : 0];
+                T* out = buffer.channelSamples(ch) + start_sample + offset;
+                level = level_;
+                double phase = position_ - static_cast<double>(first);
+                for (size_t i = 0; i < frames; ++i, phase += rate_) {
+                    const auto index = static_cast<size_t>(phase);
+                    const auto frac = static_cast<T>(phase - static_cast<double>(index));
+                    const T a = src[index];
+                    out[i] += (a + frac * (static_cast<T>(src[index + 1]) - a)) * gain_ * level;
+                    level = std::max(level - release_step_, T(0));
+                }
+            }
+            level_ = level;
+            position_ += rate_ * static_cast<double>(frames);
+            if (release_step_ > T(0) && level_ <= T(0)) {
+                finish();
+                return;
+            }
+        }
+    }
+
+protected:
+    /** Stops streaming and releases the voice. */
+    void finish() noexcept {
+        if (stream_) stream_->stop();
+        this->terminateVoice();
+    }
+
+    /** Call when the pitch changes other than through the note's tuning, e.g. from a pitch parameter. */
+    void updateRate() noexcept {
+        if (!stream_ || !stream_->isPlaying()) return;
+        const double ratio = this->note_.getFrequency() / root_frequency_;
+        rate_ = std::clamp(ratio * stream_->sample()->sampleRate() / this->getSampleRate(), 0.0, kMaxRate);
+    }
+
+private:
+    static constexpr size_t kChunk = 64;
+    // Source frames one chunk reads at kMaxRate, plus the interpolation's extra frame
+    static constexpr size_t kScratchFrames = static_cast<size_t>(kChunk * kMaxRate) + 2;
+
+    SampleStream* stream_ = nullptr;
+    double root_frequency_ = 440.0;
+    double position_ = 0.0;  // In sample frames
+    double rate_ = 1.0;      // Sample frames per output frame
+    double release_seconds_ = 0.01;
+    T gain_ = T(1);
+    T level_ = T(1);
+    T release_step_ = T(0);
+    std::array<std::array<float, kScratchFrames>, MaxChannels> scratch_{};
+};
+
+}  // namespace applause
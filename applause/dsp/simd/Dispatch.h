@@ -0,0 +1,23 @@
+#pragma once
+
+#include <applause/dsp/simd/Kernels.h>
+
+#include <span>
+
+namespace applause::simd {
+
+/**
+ * Runtime selection of the kernel table, from applause_simd_dispatch. Link that library to use it:
+ * add_applause_plugin(... SIMD_DISPATCH) does, and calls selectKernels() from the generated clap_entry's init().
+ *
+ * The wider tables are only built for x86-64 (AVX2 with FMA3, and AVX-512F); elsewhere, and on CPUs without
+ * them, selectKernels() keeps the baseline.
+ */
+
+/** The tables this CPU can run, narrowest (the baseline) first. */
+[[nodiscard]] std::span<const Kernels* const> supportedKernels() noexcept;
+
+/** Installs the widest supported table with useKernels() and returns it. */
+const Kernels& selectKernels() noexcept;
+
+}  // namespace applause::simd
@@ -0,0 +1,32 @@
+#include "Kernels.h"
+
+#include "KernelsImpl.h"
+
+namespace applause::simd {
+
+namespace {
+constexpr Kernels kBaselineKernels = detail::KernelsFor<xsimd::default_arch, true>::table(IsaLevel::Baseline);
+}  // namespace
+
+namespace detail {
+std::atomic<const Kernels*> active_kernels{&kBaselineKernels};
+}  // namespace detail
+
+const char* isaName(IsaLevel isa) noexcept {
+    switch (isa) {
+    case IsaLevel::Avx2: return "avx2";
+    case IsaLevel::Avx512: return "avx512";
+    case IsaLevel::Baseline:
+    default: return "baseline";
+    }
+}
+
+const Kernels& baselineKernels() noexcept {
+    return kBaselineKernels;
+}
+
+void useKernels(const Kernels& table) noexcept {
+    detail::active_kernels.store(&table, std::memory_order_relaxed);
+}
+
+}  // namespace applause::simd
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace applause {
+struct ValueScaleInfo;
+enum class ScalingPrecision : uint8_t;
+}  // namespace applause
+
+namespace applause::simd {
+
+/** The instruction set a kernel table was compiled for. */
+enum class IsaLevel : uint8_t {
+    Baseline,  // The plugin's own compile flags (SSE2 on x86-64 by default, NEON on arm64)
+    Avx2,      // AVX2 with FMA3
+    Avx512,    // AVX-512F
+};
+
+[[nodiscard]] const char* isaName(IsaLevel isa) noexcept;
+
+/**
+ * @brief The framework's float SIMD kernels, as one table of function pointers per instruction set.
+ *
+ * BufferView's float block operations and ModMatrix's VoiceLanes voice passes call through kernels(), the table
+ * selected for this plugin binary. That is the baseline table, compiled with the plugin's own flags, unless the
+ * plugin links applause_simd_dispatch (add_applause_plugin(... SIMD_DISPATCH)), whose selectKernels() swaps in the
+ * widest table the CPU supports once, at plugin load; see Dispatch.h.
+ *
+ * Every kernel works on n contiguous floats with no alignment requirement. Wider tables may round differently from
+ * the baseline (fused multiply-adds, summation order), within a few ulps.
+ *
+ * The header-only templates (StateVariableFilter, SVFBank, FastMath over xsimd::batch<float>) keep compiling for
+ * the plugin's baseline, because their batch width is part of the types plugins instantiate. FastMath is
+ * dispatched where the kernels use it, in maskedScale()'s frequency and time scales.
+ */
+struct Kernels {
+    IsaLevel isa;
+
+    // BufferView
+
+    /** data[i] *= gain */
+    void (*gain)(float* data, std::size_t n, float gain) noexcept;
+    /** data[i] *= start + i * step */
+    void (*gainRamp)(float* data, std::size_t n, float start, float step) noexcept;
+    /** dst[i] += src[i] */
+    void (*add)(float* dst, const float* src, std::size_t n) noexcept;
+    /** dst[i] += src[i] * gain */
+    void (*mixWithGain)(float* dst, const float* src, std::size_t n, float gain) noexcept;
+    /** dst[i] *= src[i] */
+    void (*multiply)(float* dst, const float* src, std::size_t n) noexcept;
+    /** The largest |data[i]| and the sum of data[i]^2; peak is 0 for n == 0 */
+    void (*levels)(const float* data, std::size_t n, float& peak, float& sum_squares) noexcept;
+
+    // ModMatrix VoiceLanes rows
+
+    /**
+     * dst[i] = fma(s[i], d[i], dst[i]), one modulation connection over one lane row. s[i] is src[i] through the
+     * connection's polarity, or src_value when src is null (already through it); d[i] is depth[i], or
+     * depth_value when depth is null. With both null the contribution src_value * depth_value is just added.
+     */
+    void (*modAccumulate)(float* dst, const float* src, float src_value, const float* depth, float depth_value,
+                          bool src_bipolar, bool bipolar, std::size_t n) noexcept;
+    /** dst[i] = value where mask[i] != 0 */
+    void (*maskedFill)(float* dst, const float* mask, std::size_t n, float value) noexcept;
+    /** dst[i] = fromNormalized(info, norm[i], precision) where mask[i] != 0 */
+    void (*maskedScale)(float* dst, const float* norm, const float* mask, std::size_t n, const ValueScaleInfo& info,
+                        ScalingPrecision precision) noexcept;
+    /** dst[i] = clamp(dst[i] + offset[i], lo, hi) where mask[i] != 0 */
+    void (*maskedClampAdd)(float* dst, const float* offset, const float* mask, std::size_t n, float lo,
+                           float hi) noexcept;
+};
+
+namespace detail {
+extern std::atomic<const Kernels*> active_kernels;
+}  // namespace detail
+
+/** The table compiled with the plugin's own flags. */
+[[nodiscard]] const Kernels& baselineKernels() noexcept;
+
+/** The table in use. Cheap enough to call once per block operation. */
+[[nodiscard]] inline const Kernels& kernels() noexcept {
+    return *detail::active_kernels.load(std::memory_order_relaxed);
+}
+
+/**
+ * Makes table the one kernels() returns. Call it before any plugin instance processes, as selectKernels() does
+ * from clap_entry's init(); tests use it to run code against each table.
+ */
+void useKernels(const Kernels& table) noexcept;
+
+}  // namespace applause::simd
@@ -0,0 +1,243 @@
+#pragma once
+
+// The kernel bodies behind Kernels.h, written once over xsimd::batch<float, Arch> and instantiated per
+// instruction set: by Kernels.cpp for the baseline and by the sources in dispatch/ for the wider tables.
+//
+// The dispatch/ sources are compiled with -mavx2 and the like, so anything they instantiate that isn't tagged
+// with Arch (scalar helpers, std:: algorithms) would be emitted with the wider instructions too, and the linker
+// is free to keep that copy for the baseline callers. The variant instantiations (kBaseline == false) therefore
+// only run whole batches through xsimd and hand their scalar tails, and ScalingPrecision::Exact, to the baseline
+// table.
+
+#include <applause/dsp/simd/Kernels.h>
+#include <applause/util/ValueScalingBatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause::simd::detail {
+
+template <class Arch, bool kBaseline>
+struct KernelsFor {
+    using Batch = xsimd::batch<float, Arch>;
+    static constexpr std::size_t kWidth = Batch::size;
+
+    /** The whole-batch part of n floats */
+    static constexpr std::size_t body(std::size_t n) noexcept { return n / kWidth * kWidth; }
+
+    template <typename S>
+    static S polarity(S s, bool src_bipolar, bool bipolar) noexcept {
+        if (src_bipolar) s = (s + S(1.0f)) * S(0.5f);  // [-1,+1] -> [0,1]
+        if (bipolar) s -= S(0.5f);                     // [0,1]   -> [-0.5,+0.5]
+        return s;
+    }
+
+    static void gain(float* data, std::size_t n, float gain) noexcept {
+        const std::size_t end = body(n);
+        const Batch g(gain);
+        for (std::size_t i = 0; i < end; i += kWidth) (Batch::load_unaligned(data + i) * g).store_unaligned(data + i);
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) data[i] *= gain;
+        } else {
+            baselineKernels().gain(data + end, n - end, gain);
+        }
+    }
+
+    static void gainRamp(float* data, std::size_t n, float start, float step) noexcept {
+        const std::size_t end = body(n);
+        alignas(64) float ramp[kWidth];
+        for (std::size_t l = 0; l < kWidth; ++l) ramp[l] = static_cast<float>(l) * step;
+        const Batch offsets = Batch::load_aligned(ramp);
+        for (std::size_t i = 0; i < end; i += kWidth) {
+            const Batch g = Batch(start + static_cast<float>(i) * step) + offsets;
+            (Batch::load_unaligned(data + i) * g).store_unaligned(data + i);
+        }
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) data[i] *= start + static_cast<float>(i) * step;
+        } else {
+            baselineKernels().gainRamp(data + end, n - end, start + static_cast<float>(end) * step, step);
+        }
+    }
+
+    static void add(float* dst, const float* src, std::size_t n) noexcept {
+        const std::size_t end = body(n);
+        for (std::size_t i = 0; i < end; i += kWidth) {
+            (Batch::load_unaligned(dst + i) + Batch::load_unaligned(src + i)).store_unaligned(dst + i);
+        }
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) dst[i] += src[i];
+        } else {
+            baselineKernels().add(dst + end, src + end, n - end);
+        }
+    }
+
+    static void mixWithGain(float* dst, const float* src, std::size_t n, float gain) noexcept {
+        const std::size_t end = body(n);
+        const Batch g(gain);
+        for (std::size_t i = 0; i < end; i += kWidth) {
+            (Batch::load_unaligned(dst + i) + Batch::load_unaligned(src + i) * g).store_unaligned(dst + i);
+        }
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) dst[i] += src[i] * gain;
+        } else {
+            baselineKernels().mixWithGain(dst + end, src + end, n - end, gain);
+        }
+    }
+
+    static void multiply(float* dst, const float* src, std::size_t n) noexcept {
+        const std::size_t end = body(n);
+        for (std::size_t i = 0; i < end; i += kWidth) {
+            (Batch::load_unaligned(dst + i) * Batch::load_unaligned(src + i)).store_unaligned(dst + i);
+        }
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) dst[i] *= src[i];
+        } else {
+            baselineKernels().multiply(dst + end, src + end, n - end);
+        }
+    }
+
+    static void levels(const float* data, std::size_t n, float& peak, float& sum_squares) noexcept {
+        const std::size_t end = body(n);
+        Batch peak_batch(0.0f);
+        Batch sum_batch(0.0f);
+        for (std::size_t i = 0; i < end; i += kWidth) {
+            const Batch b = Batch::load_unaligned(data + i);
+            peak_batch = xsimd::max(peak_batch, xsimd::abs(b));
+            sum_batch += b * b;
+        }
+        float tail_peak = 0.0f;
+        float tail_sum = 0.0f;
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) {
+                tail_peak = std::max(tail_peak, std::abs(data[i]));
+                tail_sum += data[i] * data[i];
+            }
+        } else {
+            baselineKernels().levels(data + end, n - end, tail_peak, tail_sum);
+        }
+        const float body_peak = xsimd::reduce_max(peak_batch);
+        peak = body_peak > tail_peak ? body_peak : tail_peak;
+        sum_squares = xsimd::reduce_add(sum_batch) + tail_sum;
+    }
+
+    static void modAccumulate(float* dst, const float* src, float src_value, const float* depth, float depth_value,
+                              bool src_bipolar, bool bipolar, std::size_t n) noexcept {
+        const std::size_t end = body(n);
+        if (!src && !depth) {
+            const Batch contribution(src_value * depth_value);
+            for (std::size_t i = 0; i < end; i += kWidth) {
+                (Batch::load_unaligned(dst + i) + contribution).store_unaligned(dst + i);
+            }
+        } else if (!src) {
+            const Batch s(src_value);
+            for (std::size_t i = 0; i < end; i += kWidth) {
+                xsimd::fma(s, Batch::load_unaligned(depth + i), Batch::load_unaligned(dst + i))
+                    .store_unaligned(dst + i);
+            }
+        } else if (!depth) {
+            const Batch d(depth_value);
+            for (std::size_t i = 0; i < end; i += kWidth) {
+                const Batch s = polarity(Batch::load_unaligned(src + i), src_bipolar, bipolar);
+                xsimd::fma(s, d, Batch::load_unaligned(dst + i)).store_unaligned(dst + i);
+            }
+        } else {
+            for (std::size_t i = 0; i < end; i += kWidth) {
+                const Batch s = polarity(Batch::load_unaligned(src + i), src_bipolar, bipolar);
+                xsimd::fma(s, Batch::load_unaligned(depth + i), Batch::load_unaligned(dst + i))
+                    .store_unaligned(dst + i);
+            }
+        }
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) {
+                const float s = src ? polarity(src[i], src_bipolar, bipolar) : src_value;
+                dst[i] += s * (depth ? depth[i] : depth_value);
+            }
+        } else {
+            baselineKernels().modAccumulate(dst + end, src ? src + end : nullptr, src_value,
+                                            depth ? depth + end : nullptr, depth_value, src_bipolar, bipolar,
+                                            n - end);
+        }
+    }
+
+    static void maskedFill(float* dst, const float* mask, std::size_t n, float value) noexcept {
+        const std::size_t end = body(n);
+        const Batch zero(0.0f);
+        const Batch v(value);
+        for (std::size_t i = 0; i < end; i += kWidth) {
+            const auto active = Batch::load_unaligned(mask + i) != zero;
+            xsimd::select(active, v, Batch::load_unaligned(dst + i)).store_unaligned(dst + i);
+        }
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) {
+                if (mask[i] != 0.0f) dst[i] = value;
+            }
+        } else {
+            baselineKernels().maskedFill(dst + end, mask + end, n - end, value);
+        }
+    }
+
+    static void maskedScale(float* dst, const float* norm, const float* mask, std::size_t n,
+                            const ValueScaleInfo& info, ScalingPrecision precision) noexcept {
+        std::size_t end = 0;
+        if constexpr (kBaseline) {
+            end = body(n);
+            const Batch zero(0.0f);
+            for (std::size_t i = 0; i < end; i += kWidth) {
+                const Batch scaled = fromNormalized(info, Batch::load_unaligned(norm + i), precision);
+                const auto active = Batch::load_unaligned(mask + i) != zero;
+                xsimd::select(active, scaled, Batch::load_unaligned(dst + i)).store_unaligned(dst + i);
+            }
+            for (std::size_t i = end; i < n; ++i) {
+                if (mask[i] != 0.0f) dst[i] = fromNormalized(info, norm[i], precision);
+            }
+        } else {
+            // The exact conversion is scalar per value anyway, and lives outside this translation unit
+            if (precision == ScalingPrecision::Fast) {
+                end = body(n);
+                const Batch zero(0.0f);
+                const Batch one(1.0f);
+                for (std::size_t i = 0; i < end; i += kWidth) {
+                    const Batch x = xsimd::min(xsimd::max(Batch::load_unaligned(norm + i), zero), one);
+                    const Batch scaled = scaling_detail::fastFromNormalized(
+                        info.scaling.type, x, Batch(info.min), Batch(info.max), Batch(info.scaling.a),
+                        Batch(info.scaling.b));
+                    const auto active = Batch::load_unaligned(mask + i) != zero;
+                    xsimd::select(active, scaled, Batch::load_unaligned(dst + i)).store_unaligned(dst + i);
+                }
+            }
+            baselineKernels().maskedScale(dst + end, norm + end, mask + end, n - end, info, precision);
+        }
+    }
+
+    static void maskedClampAdd(float* dst, const float* offset, const float* mask, std::size_t n, float lo,
+                               float hi) noexcept {
+        const std::size_t end = body(n);
+        const Batch zero(0.0f);
+        const Batch lo_batch(lo);
+        const Batch hi_batch(hi);
+        for (std::size_t i = 0; i < end; i += kWidth) {
+            const Batch out = Batch::load_unaligned(dst + i);
+            const Batch modulated =
+                xsimd::min(xsimd::max(out + Batch::load_unaligned(offset + i), lo_batch), hi_batch);
+            const auto active = Batch::load_unaligned(mask + i) != zero;
+            xsimd::select(active, modulated, out).store_unaligned(dst + i);
+        }
+        if constexpr (kBaseline) {
+            for (std::size_t i = end; i < n; ++i) {
+                if (mask[i] != 0.0f) dst[i] = std::min(std::max(dst[i] + offset[i], lo), hi);
+            }
+        } else {
+            baselineKernels().maskedClampAdd(dst + end, offset + end, mask + end, n - end, lo, hi);
+        }
+    }
+
+    static constexpr Kernels table(IsaLevel isa) noexcept {
+        return {isa,    gain,          gainRamp,   add,         mixWithGain, multiply,
+                levels, modAccumulate, maskedFill, maskedScale, maskedClampAdd};
+    }
+};
+
+}  // namespace applause::simd::detail
@@ -0,0 +1,27 @@
+// Compiled with AVX2 and FMA3 enabled; see KernelsImpl.h for what may be instantiated here.
+
+#include <applause/dsp/simd/KernelsImpl.h>
+
+namespace applause::simd::detail {
+
+#if XSIMD_WITH_AVX2
+namespace {
+#if XSIMD_WITH_FMA3_AVX2
+using Arch = xsimd::fma3<xsimd::avx2>;
+#else
+using Arch = xsimd::avx2;  // Compilers that don't advertise FMA3 alongside AVX2
+#endif
+constexpr Kernels kAvx2Kernels = KernelsFor<Arch, false>::table(IsaLevel::Avx2);
+}  // namespace
+
+const Kernels* avx2Kernels() noexcept {
+    return &kAvx2Kernels;
+}
+#else
+// Built without the flags, e.g. the arm64 half of a universal binary
+const Kernels* avx2Kernels() noexcept {
+    return nullptr;
+}
+#endif
+
+}  // namespace applause::simd::detail
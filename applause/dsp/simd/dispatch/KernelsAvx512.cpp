@@ -0,0 +1,22 @@
+// Compiled with AVX-512F enabled; see KernelsImpl.h for what may be instantiated here.
+
+#include <applause/dsp/simd/KernelsImpl.h>
+
+namespace applause::simd::detail {
+
+#if XSIMD_WITH_AVX512F
+namespace {
+constexpr Kernels kAvx512Kernels = KernelsFor<xsimd::avx512f, false>::table(IsaLevel::Avx512);
+}  // namespace
+
+const Kernels* avx512Kernels() noexcept {
+    return &kAvx512Kernels;
+}
+#else
+// Built without the flags, e.g. the arm64 half of a universal binary
+const Kernels* avx512Kernels() noexcept {
+    return nullptr;
+}
+#endif
+
+}  // namespace applause::simd::detail
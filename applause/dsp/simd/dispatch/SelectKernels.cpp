@@ -0,0 +1,49 @@
+#include <applause/dsp/simd/Dispatch.h>
+
+#include <array>
+
+#include <xsimd/xsimd.hpp>
+
+namespace applause::simd {
+
+namespace detail {
+// From the per-ISA sources next to this one; null when built without the ISA's flags
+const Kernels* avx2Kernels() noexcept;
+const Kernels* avx512Kernels() noexcept;
+}  // namespace detail
+
+namespace {
+
+struct Supported {
+    std::array<const Kernels*, 3> tables{};
+    size_t count = 0;
+};
+
+Supported detect() noexcept {
+    const auto cpu = xsimd::available_architectures();
+    Supported supported;
+    supported.tables[supported.count++] = &baselineKernels();
+    if (cpu.fma3_avx2) {
+        if (const Kernels* table = detail::avx2Kernels()) supported.tables[supported.count++] = table;
+        // Every AVX-512 CPU has FMA3 as well; the AVX-512 table relies on both
+        if (cpu.avx512f) {
+            if (const Kernels* table = detail::avx512Kernels()) supported.tables[supported.count++] = table;
+        }
+    }
+    return supported;
+}
+
+}  // namespace
+
+std::span<const Kernels* const> supportedKernels() noexcept {
+    static const Supported supported = detect();
+    return {supported.tables.data(), supported.count};
+}
+
+const Kernels& selectKernels() noexcept {
+    const Kernels& widest = *supportedKernels().back();
+    useKernels(widest);
+    return widest;
+}
+
+}  // namespace applause::simd
@@ -0,0 +1,79 @@
+#include "AudioPortsConfigExtension.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <applause/core/PluginBase.h>
+
+namespace applause {
+namespace {
+void fillMainPort(const std::vector<AudioPortConfig>& ports, bool& has_main, uint32_t& channels, const char*& type) {
+    has_main = !ports.empty() && (ports.front().flags & CLAP_AUDIO_PORT_IS_MAIN) != 0;
+    channels = has_main ? ports.front().channel_count : 0;
+    type = has_main ? AudioPortsExtension::clapPortType(ports.front().port_type) : nullptr;
+}
+}  // namespace
+
+void AudioPortsConfigExtension::onHostReady() noexcept {
+    host_ports_config_ = nullptr;
+    if (host_) {
+        host_ports_config_ = static_cast<const clap_host_audio_ports_config_t*>(
+            host_->get_extension(host_, CLAP_EXT_AUDIO_PORTS_CONFIG));
+    }
+}
+
+AudioPortsConfigExtension& AudioPortsConfigExtension::addLayout(AudioPortsLayout layout) {
+    if (layout.id == CLAP_INVALID_ID) layout.id = next_id_++;
+    for (const auto* ports : {&layout.inputs, &layout.outputs}) {
+        for (const auto& port : *ports) max_channels_ = std::max(max_channels_, port.channel_count);
+    }
+    layouts_.push_back(std::move(layout));
+    if (layouts_.size() == 1) selectLayout(layouts_.front().id);
+    if (host_ports_config_ && host_ports_config_->rescan) host_ports_config_->rescan(host_);
+    return *this;
+}
+
+bool AudioPortsConfigExtension::selectLayout(clap_id layout_id) {
+    const auto it = std::find_if(layouts_.begin(), layouts_.end(),
+                                 [layout_id](const AudioPortsLayout& layout) { return layout.id == layout_id; });
+    if (it == layouts_.end()) {
+        LOG_WARN("AudioPortsConfigExtension: no layout with ID {}", layout_id);
+        return false;
+    }
+    selected_ = static_cast<size_t>(it - layouts_.begin());
+    ports_.setPorts(it->inputs, it->outputs);
+    return true;
+}
+
+const AudioPortsLayout* AudioPortsConfigExtension::getSelectedLayout() const noexcept {
+    return layouts_.empty() ? nullptr : &layouts_[selected_];
+}
+
+uint32_t AudioPortsConfigExtension::clap_count(const clap_plugin_t* plugin) noexcept {
+    auto* ext = PluginBase::findExtension<AudioPortsConfigExtension>(plugin);
+    return ext ? static_cast<uint32_t>(ext->layouts_.size()) : 0;
+}
+
+bool AudioPortsConfigExtension::clap_get(const clap_plugin_t* plugin, uint32_t index,
+                                         clap_audio_ports_config_t* config) noexcept {
+    auto* ext = PluginBase::findExtension<AudioPortsConfigExtension>(plugin);
+    if (!ext || !config || index >= ext->layouts_.size()) return false;
+
+    const auto& layout = ext->layouts_[index];
+    config->id = layout.id;
+    strncpy(config->name, layout.name.c_str(), CLAP_NAME_SIZE - 1);
+    config->name[CLAP_NAME_SIZE - 1] = '\0';
+    config->input_port_count = static_cast<uint32_t>(layout.inputs.size());
+    config->output_port_count = static_cast<uint32_t>(layout.outputs.size());
+    fillMainPort(layout.inputs, config->has_main_input, config->main_input_channel_count,
+                 config->main_input_port_type);
+    fillMainPort(layout.outputs, config->has_main_output, config->main_output_channel_count,
+                 config->main_output_port_type);
+    return true;
+}
+
+bool AudioPortsConfigExtension::clap_select(const clap_plugin_t* plugin, clap_id config_id) noexcept {
+    auto* ext = PluginBase::findExtension<AudioPortsConfigExtension>(plugin);
+    return ext && ext->selectLayout(config_id);
+}
+}  // namespace applause
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <clap/ext/audio-ports-config.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <applause/core/Extension.h>
+#include <applause/extensions/AudioPortsExtension.h>
+
+namespace applause {
+
+/**
+ * @brief One selectable set of audio ports, e.g. "Mono", "Stereo" or "5.1".
+ */
+struct AudioPortsLayout {
+    std::string name;                      ///< Display name for the layout
+    std::vector<AudioPortConfig> inputs;   ///< Input ports, the main one first
+    std::vector<AudioPortConfig> outputs;  ///< Output ports, the main one first
+    clap_id id = CLAP_INVALID_ID;          ///< Layout ID (CLAP_INVALID_ID = auto-generate)
+
+    /**
+     * @brief An effect layout: one main input and one main output with the same channel count.
+     * @param type Port type; defaults to CLAP_PORT_MONO or CLAP_PORT_STEREO for one or two channels
+     */
+    static AudioPortsLayout effect(std::string_view name, uint32_t channels, std::string_view type = "") {
+        AudioPortConfig port = mainPort(channels, type);
+        port.name = "Input";
+        AudioPortsLayout layout{.name = std::string(name), .inputs = {port}, .outputs = {}};
+        port.name = "Output";
+        layout.outputs = {port};
+        return layout;
+    }
+
+    /**
+     * @brief An instrument layout: a single main output.
+     * @param type Port type; defaults to CLAP_PORT_MONO or CLAP_PORT_STEREO for one or two channels
+     */
+    static AudioPortsLayout instrument(std::string_view name, uint32_t channels, std::string_view type = "") {
+        AudioPortConfig port = mainPort(channels, type);
+        port.name = "Output";
+        return {.name = std::string(name), .inputs = {}, .outputs = {port}};
+    }
+
+private:
+    static AudioPortConfig mainPort(uint32_t channels, std::string_view type) {
+        std::string port_type(type);
+        if (port_type.empty() && channels == 1) port_type = CLAP_PORT_MONO;
+        if (port_type.empty() && channels == 2) port_type = CLAP_PORT_STEREO;
+        return {.name = {}, .channel_count = channels, .port_type = port_type, .flags = CLAP_AUDIO_PORT_IS_MAIN};
+    }
+};
+
+/**
+ * @brief Offers the host a choice of audio port layouts (clap.audio-ports-config), e.g. mono, stereo and surround
+ * versions of an effect.
+ *
+ * The selected layout is written into the plugin's AudioPortsExtension, which the host then reads as usual; the
+ * first layout added is selected until the host chooses another. The host only switches while the plugin is
+ * deactivated, but a switch shouldn't cost a rebuild: size every channel-dependent DSP object once for
+ * getMaxChannelCount(), the most channels any port of any layout has, and let each block's buffers (whose
+ * numChannels() follows the selected layout) decide how many channels actually run. Switching then touches
+ * nothing but the port list.
+ *
+ * @code
+ * // Constructor
+ * ports_config_.addLayout(AudioPortsLayout::effect("Mono", 1))
+ *              .addLayout(AudioPortsLayout::effect("Stereo", 2))
+ *              .addLayout(AudioPortsLayout::effect("5.1", 6, "surround"));
+ * registerExtension(audio_ports_);
+ * registerExtension(ports_config_);
+ *
+ * // activate(): the same size whichever layout is selected
+ * delay_.activate(arena_, ports_config_.getMaxChannelCount(), max_delay);
+ *
+ * // process(): only the channel count of the buffers changes
+ * delay_.process(context.output<float, 8>(0), ...);
+ * @endcode
+ */
+class AudioPortsConfigExtension : public IExtension {
+public:
+    static constexpr const char* ID = CLAP_EXT_AUDIO_PORTS_CONFIG;
+
+    /** ports outlives the extension and is registered with the same plugin. */
+    explicit AudioPortsConfigExtension(AudioPortsExtension& ports) : ports_(ports) {}
+
+    void onHostReady() noexcept override;
+
+    const char* id() const override { return ID; }
+
+    const void* getClapExtensionStruct() const override { return &clap_struct_; }
+
+    /**
+     * @brief Main thread: adds a layout, selecting it if it's the first. Tells the host to rescan the list when
+     * added after init().
+     * @return Reference to this extension for chaining
+     */
+    AudioPortsConfigExtension& addLayout(AudioPortsLayout layout);
+
+    /**
+     * @brief Main thread, while deactivated: makes the layout with the given ID current and writes its ports into
+     * the AudioPortsExtension. The host calls this through select(). Returns false for an unknown ID.
+     */
+    bool selectLayout(clap_id layout_id);
+
+    [[nodiscard]] const std::vector<AudioPortsLayout>& getLayouts() const noexcept { return layouts_; }
+
+    /** The current layout, or nullptr before the first addLayout(). */
+    [[nodiscard]] const AudioPortsLayout* getSelectedLayout() const noexcept;
+
+    /** The most channels of any port in any layout: the channel count to size DSP state for. */
+    [[nodiscard]] uint32_t getMaxChannelCount() const noexcept { return max_channels_; }
+
+private:
+    static uint32_t clap_count(const clap_plugin_t* plugin) noexcept;
+    static bool clap_get(const clap_plugin_t* plugin, uint32_t index, clap_audio_ports_config_t* config) noexcept;
+    static bool clap_select(const clap_plugin_t* plugin, clap_id config_id) noexcept;
+
+    static constexpr clap_plugin_audio_ports_config_t clap_struct_ = {
+        .count = clap_count,
+        .get = clap_get,
+        .select = clap_select,
+    };
+
+    AudioPortsExtension& ports_;
+    const clap_host_audio_ports_config_t* host_ports_config_ = nullptr;
+    std::vector<AudioPortsLayout> layouts_;
+    size_t selected_ = 0;
+    clap_id next_id_ = 0;
+    uint32_t max_channels_ = 0;
+};
+}  // namespace applause
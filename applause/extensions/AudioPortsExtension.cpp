@@ -24,7 +24,7 @@ bool AudioPortsExtension::clap_audio_ports_get(const clap_plugin_t* plugin, uint
 
     // Fill in the info structure
     info->id = port.id;
-    info->flags = port.flags;
+    info->flags = port.flags | ext->sample_size_flags_;
     info->channel_count = port.channel_count;
     info->in_place_pair = port.in_place_pair;
 
@@ -32,19 +32,9 @@ bool AudioPortsExtension::clap_audio_ports_get(const clap_plugin_t* plugin, uint
     strncpy(info->name, port.name.c_str(), CLAP_NAME_SIZE - 1);
     info->name[CLAP_NAME_SIZE - 1] = '\0';
 
-    // Set port type - convert std::string to const char*
-    // Note: This is safe because CLAP expects port_type to point to a static
-    // string (like CLAP_PORT_STEREO) or null. We store common types as
-    // std::string but they match the CLAP constants.
-    if (port.port_type.empty()) {
-        info->port_type = nullptr;
-    } else if (port.port_type == CLAP_PORT_STEREO) {
-        info->port_type = CLAP_PORT_STEREO;
-    } else if (port.port_type == CLAP_PORT_MONO) {
-        info->port_type = CLAP_PORT_MONO;
-    } else {
-        info->port_type = port.port_type.c_str();
-    }
+    // CLAP expects port_type to point to a static string (like CLAP_PORT_STEREO) or null. We store common types
+    // as std::string, but they match the CLAP constants.
+    info->port_type = clapPortType(port.port_type);
 
     return true;
 }
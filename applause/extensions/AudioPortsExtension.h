@@ -2,6 +2,7 @@
 
 #include <clap/ext/audio-ports.h>
 
+#include <algorithm>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -118,6 +119,7 @@ private:
     std::vector<PortInfo> input_ports_;
     std::vector<PortInfo> output_ports_;
     clap_id next_id_ = 0;
+    uint32_t sample_size_flags_ = 0;
 
     // CLAP C callbacks
     static uint32_t clap_audio_ports_count(const clap_plugin_t* plugin, bool is_input) noexcept;
@@ -159,6 +161,57 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Replace every port with the given ones, assigning IDs as addInput() and addOutput() would.
+     *
+     * Main thread, while deactivated; AudioPortsConfigExtension calls this when the host selects a layout.
+     */
+    AudioPortsExtension& setPorts(const std::vector<AudioPortConfig>& inputs,
+                                  const std::vector<AudioPortConfig>& outputs) {
+        input_ports_.clear();
+        output_ports_.clear();
+        next_id_ = 0;
+        for (const auto& config : inputs) addInput(config);
+        for (const auto& config : outputs) addOutput(config);
+        return *this;
+    }
+
+    /**
+     * @brief The largest channel count of any input or output port.
+     */
+    uint32_t maxChannelCount() const {
+        uint32_t channels = 0;
+        for (const auto& port : input_ports_) channels = std::max(channels, port.channel_count);
+        for (const auto& port : output_ports_) channels = std::max(channels, port.channel_count);
+        return channels;
+    }
+
+    /**
+     * @brief The port type as CLAP expects it: a static string for mono and stereo, nullptr for none, and type
+     * itself otherwise (valid as long as the port).
+     */
+    static const char* clapPortType(const std::string& type) noexcept {
+        if (type.empty()) return nullptr;
+        if (type == CLAP_PORT_STEREO) return CLAP_PORT_STEREO;
+        if (type == CLAP_PORT_MONO) return CLAP_PORT_MONO;
+        return type.c_str();
+    }
+
+    /**
+     * @brief Declare 64-bit support on every port.
+     *
+     * Adds CLAP_AUDIO_PORT_SUPPORTS_64BITS (and CLAP_AUDIO_PORT_PREFERS_64BITS when prefer is set) to each port's
+     * flags. The plugin can then ask ProcessContext for double buffers regardless of what the host supplies: a
+     * port that arrives in 32-bit is converted through the scratch arena, and vice versa.
+     *
+     * @param prefer Ask the host for 64-bit buffers whenever it can provide them
+     * @return Reference to this extension for chaining
+     */
+    AudioPortsExtension& enable64Bit(bool prefer = true) {
+        sample_size_flags_ = CLAP_AUDIO_PORT_SUPPORTS_64BITS | (prefer ? static_cast<uint32_t>(CLAP_AUDIO_PORT_PREFERS_64BITS) : 0u);
+        return *this;
+    }
+
     /**
      * @brief Get the number of input ports.
      */
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <applause/extensions/LatencyExtension.h>
+#include <applause/extensions/TailExtension.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace applause {
+
+/**
+ * @brief Adds up the latency and tail of the DSP blocks in a plugin's signal path and reports the totals.
+ *
+ * Each plugin instance keeps one DelayReport next to its LatencyExtension and TailExtension. Whenever the chain is
+ * (re)configured, start over with begin(), add() every block in series, and publish(): the extensions only notify
+ * the host when a total actually changed. add() picks up a block's getLatency() and getTailSamples() where it has
+ * them (Oversampler, Convolver), and addLatency() and addTail() cover everything else, e.g. a lookahead limiter or
+ * a delay line's feedback decay.
+ *
+ * Latency may only change while the plugin activates, so publish() from activate(); to change it afterwards ask
+ * the host to restart the plugin first. A tail may be republished at any time, including from process(); the host
+ * hears of a new tail after the next process() block.
+ *
+ * @code
+ * // activate()
+ * delays_.begin().add(oversampler_).add(convolver_).addLatency(lookahead_samples).publish();
+ * @endcode
+ */
+class DelayReport {
+public:
+    /** Either extension may be nullptr if the plugin doesn't register it. */
+    DelayReport(LatencyExtension* latency, TailExtension* tail) noexcept : latency_ext_(latency), tail_ext_(tail) {}
+
+    /** Clears the totals before the blocks are added again. */
+    DelayReport& begin() noexcept {
+        latency_ = 0;
+        tail_ = 0;
+        return *this;
+    }
+
+    /** Adds a block's latency and tail, for the methods it has. */
+    template <typename Block>
+    DelayReport& add(const Block& block) noexcept {
+        if constexpr (requires { block.getLatency(); }) addLatency(static_cast<uint32_t>(block.getLatency()));
+        if constexpr (requires { block.getTailSamples(); }) addTail(static_cast<uint32_t>(block.getTailSamples()));
+        return *this;
+    }
+
+    DelayReport& addLatency(uint32_t samples) noexcept {
+        latency_ = saturatingAdd(latency_, samples);
+        return *this;
+    }
+
+    /** Adds a tail in samples; TailExtension::kInfiniteTail (or anything that sums past it) makes the total infinite. */
+    DelayReport& addTail(uint32_t samples) noexcept {
+        tail_ = std::min(saturatingAdd(tail_, samples), TailExtension::kInfiniteTail);
+        return *this;
+    }
+
+    /**
+     * Hands the totals to the extensions, which tell the host if they changed: the latency right away, the tail from
+     * the audio thread after the next process().
+     */
+    void publish() const noexcept {
+        if (latency_ext_) latency_ext_->setLatency(latency_);
+        if (tail_ext_) tail_ext_->setTail(tail_);
+    }
+
+    [[nodiscard]] uint32_t getLatency() const noexcept { return latency_; }
+    [[nodiscard]] uint32_t getTail() const noexcept { return tail_; }
+
+private:
+    static uint32_t saturatingAdd(uint32_t a, uint32_t b) noexcept {
+        return a > UINT32_MAX - b ? UINT32_MAX : a + b;
+    }
+
+    LatencyExtension* latency_ext_ = nullptr;
+    TailExtension* tail_ext_ = nullptr;
+    uint32_t latency_ = 0;
+    uint32_t tail_ = 0;
+};
+}  // namespace applause
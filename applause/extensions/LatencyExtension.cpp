@@ -0,0 +1,33 @@
+#include "LatencyExtension.h"
+
+#include <applause/core/PluginBase.h>
+
+namespace applause {
+void LatencyExtension::onHostReady() noexcept {
+    host_latency_ = nullptr;
+    if (host_) {
+        host_latency_ = static_cast<const clap_host_latency_t*>(host_->get_extension(host_, CLAP_EXT_LATENCY));
+    }
+}
+
+void LatencyExtension::setLatency(uint32_t samples) noexcept {
+    if (samples == latency_) return;
+    latency_ = samples;
+    if (host_latency_ && host_latency_->changed) {
+        host_latency_->changed(host_);
+    }
+}
+
+void LatencyExtension::setFrameworkLatency(uint32_t samples) noexcept {
+    if (samples == framework_latency_) return;
+    framework_latency_ = samples;
+    if (host_latency_ && host_latency_->changed) {
+        host_latency_->changed(host_);
+    }
+}
+
+uint32_t LatencyExtension::clap_get(const clap_plugin_t* plugin) noexcept {
+    auto* ext = PluginBase::findExtension<LatencyExtension>(plugin);
+    return ext ? ext->getLatency() : 0;
+}
+}  // namespace applause
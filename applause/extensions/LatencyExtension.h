@@ -0,0 +1,53 @@
+#pragma once
+
+#include <applause/core/Extension.h>
+#include <clap/ext/latency.h>
+
+#include <cstdint>
+
+namespace applause {
+
+/**
+ * @brief Reports the plugin's processing latency to the host, so it can delay the other tracks to match.
+ *
+ * CLAP only lets the latency change while the plugin is being activated: set it from activate(), e.g. to an
+ * Oversampler's getLatency(). To change it while active, ask the host to restart the plugin
+ * (`host->request_restart()`) and set the new value in the activate() that follows.
+ */
+class LatencyExtension : public IExtension {
+public:
+    static constexpr const char* ID = CLAP_EXT_LATENCY;
+
+    LatencyExtension() = default;
+
+    void onHostReady() noexcept override;
+
+    const char* id() const override { return ID; }
+
+    const void* getClapExtensionStruct() const override { return &clap_struct_; }
+
+    /**
+     * @brief Sets the latency reported to the host and tells the host if it changed.
+     * @param samples The delay from input to output, in samples at the activated sample rate.
+     */
+    void setLatency(uint32_t samples) noexcept;
+
+    /**
+     * @brief Sets latency the framework adds on top of the plugin's, which PluginBase does at activation for
+     * FixedBlockMode::Latency. Tells the host if the total changed.
+     */
+    void setFrameworkLatency(uint32_t samples) noexcept;
+
+    /** The latency reported to the host: the plugin's setLatency() plus the framework's. */
+    [[nodiscard]] uint32_t getLatency() const noexcept { return latency_ + framework_latency_; }
+
+private:
+    static uint32_t clap_get(const clap_plugin_t* plugin) noexcept;
+
+    static constexpr clap_plugin_latency_t clap_struct_ = {.get = clap_get};
+
+    const clap_host_latency_t* host_latency_ = nullptr;
+    uint32_t latency_ = 0;
+    uint32_t framework_latency_ = 0;
+};
+}  // namespace applause
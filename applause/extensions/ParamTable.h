@@ -0,0 +1,174 @@
+#pragma once
+
+#include <clap/id.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include <applause/util/ValueScaling.h>
+
+namespace applause {
+
+/**
+ * @brief How ParamsExtension::processSmoothing() ramps a parameter's plain value towards its target.
+ */
+enum class ParamSmoothing : uint8_t {
+    None,        ///< Not smoothed; the parameter has no smoothed values
+    Linear,      ///< Straight ramp that reaches the target after the smoothing time
+    Exponential  ///< One-pole smoother that covers 1 - 1/e of a step change after the smoothing time
+};
+
+/**
+ * FNV-1a hash of a parameter's path, "module/string_id" or just string_id without a module. Barring collisions,
+ * this is the stable CLAP id ParamsExtension assigns; with an empty module it's also the key ParamTable sorts
+ * string ids by.
+ */
+constexpr uint32_t paramIdHash(std::string_view module, std::string_view string_id) noexcept {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](std::string_view text) {
+        for (const char c : text) {
+            hash ^= static_cast<uint32_t>(c);
+            hash *= 16777619u;
+        }
+    };
+    mix(module);
+    if (!module.empty()) mix("/");
+    mix(string_id);
+    return hash;
+}
+
+/**
+ * @brief Compile-time counterpart of ParamConfig, for parameters declared in a ParamTable.
+ *
+ * Strings are views, so declarations can live in constexpr tables; ParamsExtension copies them on registration.
+ * Custom text converters aren't available here: set them on the registered ParamInfo if needed.
+ */
+struct ParamDecl {
+    std::string_view string_id;   /// String identifier for the parameter (required, unique within the table)
+    std::string_view name;        /// Display name (if empty, uses string_id)
+    std::string_view module;      /// Module path for hierarchical grouping (e.g. "Filter/Envelope")
+    std::string_view short_name;  /// Short display name (e.g., "Cutoff")
+    std::string_view unit;        /// Unit string (e.g., "Hz", "dB")
+    float min_value = 0.0f;
+    float max_value = 1.0f;
+    float default_value = 0.5f;
+    bool is_stepped = false;
+    bool is_internal = false;
+    bool is_hidden = false;
+    bool is_polyphonic = false;
+
+    ValueScaling scaling = ValueScaling::linear();
+    float smoothing_ms = 0.0f;
+    ParamSmoothing value_smoothing = ParamSmoothing::None;
+    float value_smoothing_ms = 0.0f;
+};
+
+/** A lookup key (CLAP id or string id hash) and the index of the parameter it belongs to. */
+struct ParamIdEntry {
+    uint32_t key;
+    uint32_t index;
+
+    friend constexpr bool operator<(const ParamIdEntry& a, const ParamIdEntry& b) noexcept { return a.key < b.key; }
+};
+
+/** The entries of a key-sorted span whose key equals key; more than one only for string id hash collisions. */
+constexpr std::span<const ParamIdEntry> findParamIdEntries(std::span<const ParamIdEntry> sorted,
+                                                           uint32_t key) noexcept {
+    const auto [first, last] = std::equal_range(sorted.begin(), sorted.end(), ParamIdEntry{key, 0});
+    return {first, last};
+}
+
+/**
+ * @brief A parameter list declared at compile time, with its CLAP ids and lookup tables computed by the compiler.
+ *
+ * @code
+ * inline constexpr applause::ParamTable kParams({
+ *     {.string_id = "cutoff", .unit = "Hz", .min_value = 20.0f, .max_value = 20000.0f, .default_value = 500.0f},
+ *     {.string_id = "resonance", .min_value = 0.1f, .max_value = 10.0f, .default_value = 0.71f},
+ * });
+ *
+ * params_.registerParams(kParams);
+ * cutoff_ = &params_.getHandleAt(kParams.index("cutoff"));  // resolved at compile time
+ * @endcode
+ *
+ * Ids are assigned exactly as registering the same parameters one by one with ParamsExtension::registerParam()
+ * would, so moving a plugin to a table keeps its saved states and host automation valid. Duplicate or empty
+ * string ids, bad default values and lookups of unknown ids fail to compile.
+ */
+template <size_t N>
+class ParamTable {
+public:
+    static constexpr uint32_t kNotFound = ~uint32_t{0};
+
+    consteval explicit ParamTable(const ParamDecl (&decls)[N]) {
+        for (uint32_t i = 0; i < N; ++i) {
+            const ParamDecl& decl = decls_[i] = decls[i];
+            if (decl.string_id.empty()) throw "ParamTable: string_id is required";
+            if (decl.default_value < decl.min_value || decl.default_value > decl.max_value)
+                throw "ParamTable: default value not between min and max value";
+            if (decl.is_stepped && decl.value_smoothing != ParamSmoothing::None)
+                throw "ParamTable: stepped parameters can't use value smoothing";
+            for (uint32_t j = 0; j < i; ++j) {
+                if (decls_[j].string_id == decl.string_id) throw "ParamTable: duplicate string_id";
+            }
+
+            // Same linear probing as ParamsExtension::registerParam()
+            const uint32_t original = paramIdHash(decl.module, decl.string_id);
+            clap_id id = original;
+            for (uint32_t probe = 1; std::find(clap_ids_.begin(), clap_ids_.begin() + i, id) != clap_ids_.begin() + i;
+                 ++probe) {
+                id = original + probe;
+            }
+            clap_ids_[i] = id;
+            by_clap_id_[i] = {id, i};
+            by_string_id_[i] = {paramIdHash({}, decl.string_id), i};
+        }
+        std::sort(by_clap_id_.begin(), by_clap_id_.end());
+        std::sort(by_string_id_.begin(), by_string_id_.end());
+    }
+
+    [[nodiscard]] static constexpr size_t size() noexcept { return N; }
+
+    [[nodiscard]] constexpr const ParamDecl& operator[](size_t index) const noexcept { return decls_[index]; }
+
+    /** Index of the parameter with the given string id, or kNotFound. */
+    [[nodiscard]] constexpr uint32_t find(std::string_view string_id) const noexcept {
+        for (const auto& entry : findParamIdEntries(by_string_id_, paramIdHash({}, string_id))) {
+            if (decls_[entry.index].string_id == string_id) return entry.index;
+        }
+        return kNotFound;
+    }
+
+    /** Index of the parameter with the given string id; unknown ids don't compile. */
+    [[nodiscard]] consteval uint32_t index(std::string_view string_id) const {
+        const uint32_t found = find(string_id);
+        if (found == kNotFound) throw "ParamTable: unknown string_id";
+        return found;
+    }
+
+    /** CLAP id of the parameter with the given string id; unknown ids don't compile. */
+    [[nodiscard]] consteval clap_id clapId(std::string_view string_id) const { return clap_ids_[index(string_id)]; }
+
+    [[nodiscard]] constexpr clap_id clapIdAt(size_t index) const noexcept { return clap_ids_[index]; }
+
+    [[nodiscard]] constexpr std::span<const ParamDecl> decls() const noexcept { return decls_; }
+    [[nodiscard]] constexpr std::span<const clap_id> clapIds() const noexcept { return clap_ids_; }
+
+    /** (CLAP id, index) pairs sorted by CLAP id. */
+    [[nodiscard]] constexpr std::span<const ParamIdEntry> byClapId() const noexcept { return by_clap_id_; }
+
+    /** (string id hash, index) pairs sorted by hash; see paramIdHash(). */
+    [[nodiscard]] constexpr std::span<const ParamIdEntry> byStringId() const noexcept { return by_string_id_; }
+
+private:
+    std::array<ParamDecl, N> decls_{};
+    std::array<clap_id, N> clap_ids_{};
+    std::array<ParamIdEntry, N> by_clap_id_{};
+    std::array<ParamIdEntry, N> by_string_id_{};
+};
+
+}  // namespace applause
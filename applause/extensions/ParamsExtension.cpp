@@ -2,24 +2,64 @@
 
 #include <clap/events.h>
 
+#include <array>
 #include <cctype>
 #include <cerrno>
+#include <charconv>
 #include <cmath>
 #include <cstring>
-#include <iomanip>
-#include <sstream>
+#include <memory>
 
+#include <applause/core/EventRouter.h>
 #include <applause/core/PluginBase.h>
 #include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
+
+#include <xsimd/xsimd.hpp>
 
 namespace applause {
-// This default converter function tries to fit the number into five digits,
-// using no more than two digits of decimal precision (1/100ths).
-std::string ParamsExtension::defaultValueToText(float value, const ParamInfo& info) {
-    std::ostringstream stream;
+namespace {
+void pushParamValue(const clap_output_events_t* out, clap_id param_id, double value) {
+    clap_event_param_value_t event = {};
+    event.header.size = sizeof(clap_event_param_value_t);
+    event.header.time = 0;  // Process at start of buffer
+    event.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+    event.header.type = CLAP_EVENT_PARAM_VALUE;
+    event.header.flags = 0;
+
+    event.param_id = param_id;
+    event.cookie = nullptr;  // hosts route plugin output by param_id, not cookie
+    event.note_id = -1;     // Wildcard - not note-specific
+    event.port_index = -1;  // Wildcard
+    event.channel = -1;     // Wildcard
+    event.key = -1;         // Wildcard
+    event.value = value;
+
+    out->try_push(out, &event.header);
+}
+
+void pushParamGesture(const clap_output_events_t* out, uint16_t type, clap_id param_id) {
+    clap_event_param_gesture_t event = {};
+    event.header.size = sizeof(clap_event_param_gesture_t);
+    event.header.time = 0;  // Process at start of buffer
+    event.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+    event.header.type = type;
+    event.header.flags = 0;
+
+    event.param_id = param_id;
+
+    out->try_push(out, &event.header);
+}
+
+// The number part of the default text, into digits; returns its length. It tries to fit the number into five
+// digits, using no more than two digits of decimal precision (1/100ths).
+size_t formatDefaultNumber(float value, const ParamInfo& info, std::array<char, 64>& digits) noexcept {
+    char* const first = digits.data();
+    char* const last = digits.data() + digits.size();
+    std::to_chars_result result;
 
     if (info.stepped) {
-        stream << static_cast<int>(value);
+        result = std::to_chars(first, last, static_cast<int>(value));
     } else {
         const int max_chars = 5;
         const int max_decimals = 2;
@@ -29,25 +69,34 @@ std::string ParamsExtension::defaultValueToText(float value, const ParamInfo& in
         int sign_chars = (value < 0) ? 1 : 0;
         int used_chars = integer_digits + sign_chars;
 
-        if (used_chars >= max_chars) {
-            stream << std::fixed << std::setprecision(0) << value;
-        } else {
+        int decimals_to_show = 0;
+        if (used_chars < max_chars) {
             int available_for_decimal = max_chars - used_chars;
-            if (available_for_decimal >= 2) {
-                int decimals_to_show = std::min(max_decimals, available_for_decimal - 1);
-                stream << std::fixed << std::setprecision(decimals_to_show) << value;
-            } else {
-                stream << std::fixed << std::setprecision(0) << value;
-            }
+            if (available_for_decimal >= 2) decimals_to_show = std::min(max_decimals, available_for_decimal - 1);
         }
+        result = std::to_chars(first, last, value, std::chars_format::fixed, decimals_to_show);
     }
+    return result.ec == std::errc{} ? static_cast<size_t>(result.ptr - first) : 0;
+}
+}  // namespace
 
-    // Append unit if present
-    if (!info.unit.empty()) {
-        stream << "" << info.unit;
-    }
+std::string ParamsExtension::defaultValueToText(float value, const ParamInfo& info) {
+    std::array<char, 64> digits;
+    std::string text(digits.data(), formatDefaultNumber(value, info, digits));
+    text += info.unit;
+    return text;
+}
 
-    return stream.str();
+size_t ParamsExtension::defaultValueToText(float value, const ParamInfo& info, char* out, size_t capacity) noexcept {
+    if (!out || capacity == 0) return 0;
+    std::array<char, 64> digits;
+    size_t length = std::min(formatDefaultNumber(value, info, digits), capacity - 1);
+    std::memcpy(out, digits.data(), length);
+    const size_t unit = std::min(info.unit.size(), capacity - 1 - length);
+    std::memcpy(out + length, info.unit.data(), unit);
+    length += unit;
+    out[length] = '\0';
+    return length;
 }
 
 std::optional<float> ParamsExtension::defaultTextToValue(const std::string& text, const ParamInfo& info) {
@@ -89,12 +138,24 @@ float ParamInfo::getValue() const noexcept { return handle_->getValue(); }
 void ParamInfo::setValueNotifyingHost(float value) const noexcept {
     value = std::clamp(value, minValue, maxValue);
 
-    // Queue message to audio thread if message queue exists (GUI is present)
-    if (registry_->message_queue_) {
-        registry_->message_queue_->toAudio().enqueue({ParamMessageQueue::PARAM_VALUE, clapId, value});
+    const auto index = static_cast<uint32_t>(handle_ - registry_->handles_.get());
+    registry_->storeValue(index, value);
+    registry_->user_changed_.set(index);
+    registry_->markDirty(index);
+
+    // Inside a bulk change the value is only flagged; endBulkChange() sends the host all of them at once
+    if (registry_->message_queue_ && registry_->bulk_depth_ > 0) {
+        registry_->bulk_values_.set(index);
+        on_value_changed(value);
+        return;
     }
 
-    handle_->value_->store(value, std::memory_order_relaxed);
+    // Queue message to audio thread if message queue exists (GUI is present). When the queue is full, the next
+    // processEvents() sends the host the latest value instead.
+    if (registry_->message_queue_ &&
+        !registry_->message_queue_->sendToAudio({ParamMessageQueue::PARAM_VALUE, clapId, value})) {
+        registry_->unsent_values_.set(index);
+    }
 
     // Immediately notify all UI listeners for instant synchronization
     on_value_changed(value);
@@ -106,13 +167,26 @@ void ParamInfo::setValueNotifyingHost(float value) const noexcept {
 }
 
 void ParamInfo::setValueSilently(float value) const noexcept {
-    handle_->value_->store(std::clamp(value, minValue, maxValue), std::memory_order_relaxed);
+    const auto index = static_cast<uint32_t>(handle_ - registry_->handles_.get());
+    registry_->storeValue(index, std::clamp(value, minValue, maxValue));
+    registry_->markDirty(index);
 }
 
 void ParamInfo::beginGesture() const noexcept {
-    // Queue message to audio thread if message queue exists (GUI is present)
+    // Queue message to audio thread if message queue exists (GUI is present). A begin that doesn't fit is dropped
+    // along with its end, so the host never sees half a gesture.
     if (registry_->message_queue_) {
-        registry_->message_queue_->toAudio().enqueue({ParamMessageQueue::BEGIN_GESTURE, clapId, 0.0f});
+        const auto index = static_cast<uint32_t>(handle_ - registry_->handles_.get());
+        auto& state = registry_->gesture_state_[index];
+        if (state == ParamsExtension::GestureState::EndPending) {
+            // The previous gesture's end is still waiting; if it hasn't gone out yet, that gesture just continues
+            state = registry_->unsent_gesture_ends_.consumeOne(index) ? ParamsExtension::GestureState::Open
+                                                                       : ParamsExtension::GestureState::Closed;
+        }
+        if (state == ParamsExtension::GestureState::Open) return;
+        if (registry_->message_queue_->sendToAudio({ParamMessageQueue::BEGIN_GESTURE, clapId, 0.0f})) {
+            state = ParamsExtension::GestureState::Open;
+        }
     }
 
     // Request flush from host if available
@@ -122,9 +196,18 @@ void ParamInfo::beginGesture() const noexcept {
 }
 
 void ParamInfo::endGesture() const noexcept {
-    // Queue message to audio thread if message queue exists (GUI is present)
+    // Queue message to audio thread if message queue exists (GUI is present). Only a gesture whose begin went out
+    // gets an end; one that doesn't fit is sent by the next processEvents() instead.
     if (registry_->message_queue_) {
-        registry_->message_queue_->toAudio().enqueue({ParamMessageQueue::END_GESTURE, clapId, 0.0f});
+        const auto index = static_cast<uint32_t>(handle_ - registry_->handles_.get());
+        auto& state = registry_->gesture_state_[index];
+        if (state != ParamsExtension::GestureState::Open) return;
+        if (registry_->message_queue_->sendToAudio({ParamMessageQueue::END_GESTURE, clapId, 0.0f})) {
+            state = ParamsExtension::GestureState::Closed;
+        } else {
+            registry_->unsent_gesture_ends_.set(index);
+            state = ParamsExtension::GestureState::EndPending;
+        }
     }
 
     // Request flush from host if available
@@ -133,7 +216,19 @@ void ParamInfo::endGesture() const noexcept {
     }
 }
 
-std::string ParamInfo::valueToText(float value) const noexcept { return value_to_text_(value, *this); }
+std::string ParamInfo::valueToText(float value) const noexcept {
+    return value_to_text_ ? value_to_text_(value, *this) : ParamsExtension::defaultValueToText(value, *this);
+}
+
+size_t ParamInfo::valueToText(float value, char* out, size_t capacity) const noexcept {
+    if (!value_to_text_) return ParamsExtension::defaultValueToText(value, *this, out, capacity);
+    if (!out || capacity == 0) return 0;
+    const std::string text = value_to_text_(value, *this);
+    const size_t length = std::min(text.size(), capacity - 1);
+    std::memcpy(out, text.data(), length);
+    out[length] = '\0';
+    return length;
+}
 
 std::optional<float> ParamInfo::textToValue(const std::string& text) const noexcept {
     return text_to_value_(text, *this);
@@ -173,6 +268,14 @@ bool ParamsExtension::clap_params_get_info(const clap_plugin_t* plugin, uint32_t
     param_info->flags = 0;
     if (info.stepped) param_info->flags |= CLAP_PARAM_IS_STEPPED;
     if (info.hidden) param_info->flags |= CLAP_PARAM_IS_HIDDEN;
+    if (info.polyphonic) {
+        param_info->flags |= CLAP_PARAM_IS_MODULATABLE;
+        // Per-note events are only worth sending when something hands them to the voices
+        if (ext->per_note_modulation_) {
+            param_info->flags |= CLAP_PARAM_IS_MODULATABLE_PER_NOTE_ID | CLAP_PARAM_IS_MODULATABLE_PER_KEY |
+                                 CLAP_PARAM_IS_MODULATABLE_PER_CHANNEL | CLAP_PARAM_IS_MODULATABLE_PER_PORT;
+        }
+    }
 
     // All parameters are automatable by default
     param_info->flags |= CLAP_PARAM_IS_AUTOMATABLE;
@@ -185,10 +288,9 @@ bool ParamsExtension::clap_params_get_value(const clap_plugin_t* plugin, clap_id
     if (!ext || !out_value) return false;
 
     // Look up parameter by CLAP ID
-    auto it = ext->clap_id_to_index_.find(param_id);
-    if (it == ext->clap_id_to_index_.end()) return false;
+    const uint32_t index = ext->indexOfClapId(param_id);
+    if (index == kNoParam) return false;
 
-    uint32_t index = it->second;
     *out_value = static_cast<double>(ext->values_[index].load(std::memory_order_relaxed));
 
     return true;
@@ -199,14 +301,27 @@ bool ParamsExtension::clap_params_value_to_text(const clap_plugin_t* plugin, cla
     auto* ext = PluginBase::findExtension<ParamsExtension>(plugin);
     if (!ext || !out_buffer || out_buffer_capacity == 0) return false;
 
-    auto it = ext->clap_id_to_index_.find(param_id);
-    if (it == ext->clap_id_to_index_.end()) return false;
+    const uint32_t index = ext->indexOfClapId(param_id);
+    if (index == kNoParam) return false;
 
-    const ParamInfo& info = ext->infos_[it->second];
-    std::string text = info.valueToText(static_cast<float>(value));
-    std::strncpy(out_buffer, text.c_str(), out_buffer_capacity - 1);
-    out_buffer[out_buffer_capacity - 1] = '\0';
+    // Hosts mostly ask for the current value, over and over: that one's text is kept until the value is written
+    const float plain = static_cast<float>(value);
+    auto& cached = ext->cached_text_[index];
+    if (ext->text_stale_.consumeOne(index)) cached.valid = false;
+    if (cached.valid && cached.value == plain && cached.length < out_buffer_capacity) {
+        std::memcpy(out_buffer, cached.text.data(), cached.length + size_t{1});
+        return true;
+    }
 
+    const size_t length = ext->infos_[index].valueToText(plain, out_buffer, out_buffer_capacity);
+    // Truncated text isn't kept, nor text for any other value
+    if (length + 1 < out_buffer_capacity && length < CachedText::kCapacity &&
+        plain == ext->values_[index].load(std::memory_order_relaxed)) {
+        std::memcpy(cached.text.data(), out_buffer, length + 1);
+        cached.length = static_cast<uint8_t>(length);
+        cached.value = plain;
+        cached.valid = true;
+    }
     return true;
 }
 
@@ -215,10 +330,10 @@ bool ParamsExtension::clap_params_text_to_value(const clap_plugin_t* plugin, cla
     auto* ext = PluginBase::findExtension<ParamsExtension>(plugin);
     if (!ext || !param_value_text || !out_value) return false;
 
-    auto it = ext->clap_id_to_index_.find(param_id);
-    if (it == ext->clap_id_to_index_.end()) return false;
+    const uint32_t index = ext->indexOfClapId(param_id);
+    if (index == kNoParam) return false;
 
-    const ParamInfo& info = ext->infos_[it->second];
+    const ParamInfo& info = ext->infos_[index];
     auto parsed = info.textToValue(param_value_text);
     if (!parsed.has_value()) return false;
 
@@ -244,10 +359,43 @@ ParamsExtension::ParamsExtension(uint32_t max_params) : message_queue_(nullptr)
     clap_struct_.flush = clap_params_flush;
 
     max_params_ = max_params;
-    values_ = std::make_unique<std::atomic<float>[]>(max_params_);
+    carveHotStorage();
     handles_ = std::make_unique<ParamHandle[]>(max_params_);
     infos_ = std::make_unique<ParamInfo[]>(max_params_);
-    scale_info_ = std::make_unique<ValueScaleInfo[]>(max_params_);
+    timelines_ = std::make_unique<ParamTimeline[]>(max_params_);
+    automated_.reserve(max_params_);
+    dirty_ = AtomicBitset(max_params_);
+    host_changed_ = AtomicBitset(max_params_);
+    snapshot_changed_ = AtomicBitset(max_params_);
+    user_changed_ = AtomicBitset(max_params_);
+    text_stale_ = AtomicBitset(max_params_);
+    cached_text_ = std::make_unique<CachedText[]>(max_params_);
+    unsent_values_ = AtomicBitset(max_params_);
+    unsent_gesture_ends_ = AtomicBitset(max_params_);
+    gesture_state_ = std::make_unique<GestureState[]>(max_params_);
+    bulk_values_ = AtomicBitset(max_params_);
+    bulk_batch_.reserve(max_params_);
+}
+
+void ParamsExtension::carveHotStorage() {
+    const size_t n = max_params_;
+    const auto lineBytes = [](size_t bytes) {
+        return (bytes + defaultByteAlignment - 1) / defaultByteAlignment * defaultByteAlignment;
+    };
+    hot_storage_.resize(defaultByteAlignment + 2 * lineBytes(n * sizeof(std::atomic<float>)) +
+                        lineBytes(n * sizeof(ValueScaleInfo)) + lineBytes(n * sizeof(float)) + lineBytes(n));
+
+    MemoryArena arena(hot_storage_.data(), hot_storage_.size());
+    const auto carve = [&]<typename T>(T*& array) {
+        array = arena.allocate<T>(n, defaultByteAlignment);
+        ASSERT(array != nullptr || n == 0, "Parameter storage too small");
+        std::uninitialized_value_construct_n(array, n);
+    };
+    carve(values_);
+    carve(normalized_);
+    carve(scale_info_);
+    carve(mod_amounts_);
+    carve(flags_);
 }
 
 void ParamsExtension::onHostReady() noexcept {
@@ -264,6 +412,57 @@ void ParamsExtension::onHostReady() noexcept {
 }
 
 void ParamsExtension::registerParam(const ParamConfig& config) {
+    // Generate stable CLAP ID using FNV-1a hash, with linear probing on collisions
+    const uint32_t original_id = paramIdHash(config.module, config.string_id);
+    clap_id id = original_id;
+    for (uint32_t probe = 1; indexOfClapId(id) != kNoParam; ++probe) {
+        id = original_id + probe;
+    }
+
+    const uint32_t index = param_count_;
+    addParam(config, id);
+
+    // Update lookup structures
+    clap_id_to_index_[id] = index;
+    string_id_to_index_[config.string_id] = index;
+}
+
+void ParamsExtension::registerTable(std::span<const ParamDecl> decls, std::span<const clap_id> clap_ids,
+                                    std::span<const ParamIdEntry> by_clap_id,
+                                    std::span<const ParamIdEntry> by_string_id) {
+    ASSERT(param_count_ == 0, "A ParamTable must be registered before any other parameter");
+
+    for (size_t i = 0; i < decls.size(); ++i) {
+        const ParamDecl& decl = decls[i];
+        addParam(ParamConfig{
+                     .string_id = std::string(decl.string_id),
+                     .name = std::string(decl.name),
+                     .module = std::string(decl.module),
+                     .short_name = std::string(decl.short_name),
+                     .unit = std::string(decl.unit),
+                     .min_value = decl.min_value,
+                     .max_value = decl.max_value,
+                     .default_value = decl.default_value,
+                     .is_stepped = decl.is_stepped,
+                     .is_internal = decl.is_internal,
+                     .is_hidden = decl.is_hidden,
+                     .is_polyphonic = decl.is_polyphonic,
+                     .scaling = decl.scaling,
+                     .smoothing_ms = decl.smoothing_ms,
+                     .value_smoothing = decl.value_smoothing,
+                     .value_smoothing_ms = decl.value_smoothing_ms,
+                     .value_to_text = {},
+                     .text_to_value = {},
+                 },
+                 clap_ids[i]);
+    }
+
+    // The table's ids are already sorted; keep them instead of building the maps
+    table_by_clap_id_.assign(by_clap_id.begin(), by_clap_id.end());
+    table_by_string_id_.assign(by_string_id.begin(), by_string_id.end());
+}
+
+void ParamsExtension::addParam(const ParamConfig& config, clap_id id) {
     ASSERT(param_count_ < max_params_,
            "Too many parameters registered! Allocate more through the "
            "ParamRegistry constructor.");
@@ -271,6 +470,12 @@ void ParamsExtension::registerParam(const ParamConfig& config) {
     ASSERT(config.default_value >= config.min_value && config.default_value <= config.max_value,
            "Default value not between min and max value!");
 
+    ASSERT(config.value_smoothing == ParamSmoothing::None || !config.is_stepped,
+           "Stepped parameter '{}' can't use value smoothing", config.string_id);
+
+    ASSERT(config.value_smoothing == ParamSmoothing::None || smoothing_frames_ == 0,
+           "Smoothed parameter '{}' registered after activate()", config.string_id);
+
     // Create ParamInfo from ParamConfig
     ParamInfo info;
     info.name = config.name.empty() ? config.string_id : config.name;
@@ -285,60 +490,40 @@ void ParamsExtension::registerParam(const ParamConfig& config) {
     info.hidden = config.is_hidden;
     info.scaling_ = config.scaling;
     info.polyphonic = config.is_polyphonic;
+    info.smoothingMs = config.smoothing_ms;
+    info.valueSmoothing = config.value_smoothing;
+    info.valueSmoothingMs = config.value_smoothing_ms;
     info.stringId = config.string_id;
-
-    std::string id;
-
-    if (config.module.empty()) {
-        id = config.string_id;
-    } else {
-        id = config.module + "/" + config.string_id;
-    }
-
-    // Generate stable CLAP ID using FNV-1a hash
-    {
-        const char* str = id.c_str();
-        uint32_t hash = 2166136261u;
-        while (*str) {
-            hash ^= static_cast<uint32_t>(*str++);
-            hash *= 16777619u;
-        }
-        info.clapId = hash;
-    }
-
-    // Check for hash collisions
-    if (clap_id_to_index_.count(info.clapId) > 0) {
-        // Simple collision resolution: linear probing
-        uint32_t originalId = info.clapId;
-        uint32_t probe = 1;
-        while (clap_id_to_index_.count(info.clapId) > 0) {
-            info.clapId = originalId + probe;
-            probe++;
-        }
-    }
+    info.clapId = id;
 
     // Store in dense arrays using current count as index
     uint32_t index = param_count_;
-    values_[index].store(info.defaultValue);
+    scale_info_[index] = ValueScaleInfo{
+        config.min_value,
+        config.max_value,
+        config.scaling
+    };
+    flags_[index] = static_cast<uint8_t>((info.stepped ? kParamStepped : 0) | (info.internal ? kParamInternal : 0) |
+                                         (info.polyphonic ? kParamPolyphonic : 0) |
+                                         (info.valueSmoothing != ParamSmoothing::None ? kParamSmoothed : 0));
+    storeValue(index, info.defaultValue);
+    markDirty(index);
     handles_[index].value_ = &values_[index];
+    handles_[index].normalized_ = &normalized_[index];
+    handles_[index].timeline_ = &timelines_[index];
+    handles_[index].modulation_ = &mod_amounts_[index];
+    timelines_[index].value_ = &values_[index];
     info.handle_ = &handles_[index];
     infos_[index] = info;
     infos_[index].registry_ = this;
 
     // Use custom converters if provided, otherwise use defaults
-    infos_[index].value_to_text_ = config.value_to_text ? config.value_to_text : defaultValueToText;
+    infos_[index].value_to_text_ = config.value_to_text;
     infos_[index].text_to_value_ = config.text_to_value ? config.text_to_value : defaultTextToValue;
 
-    // Populate DSP-safe scale info array
-    scale_info_[index] = ValueScaleInfo{
-        config.min_value,
-        config.max_value,
-        config.scaling
-    };
-
-    // Update lookup structures
-    clap_id_to_index_[info.clapId] = index;
-    string_id_to_index_[config.string_id] = index;
+    if (info.valueSmoothing != ParamSmoothing::None) {
+        smoothers_.push_back({.index = index, .mode = info.valueSmoothing});
+    }
 
     // Track external parameters for host enumeration
     if (!info.internal) {
@@ -349,32 +534,45 @@ void ParamsExtension::registerParam(const ParamConfig& config) {
     param_count_++;
 }
 
+uint32_t ParamsExtension::indexOfClapId(clap_id id) const noexcept {
+    if (const auto entries = findParamIdEntries(table_by_clap_id_, id); !entries.empty()) return entries[0].index;
+    const auto it = clap_id_to_index_.find(id);
+    return it != clap_id_to_index_.end() ? it->second : kNoParam;
+}
+
+uint32_t ParamsExtension::indexOfStringId(std::string_view string_id) const noexcept {
+    for (const auto& entry : findParamIdEntries(table_by_string_id_, paramIdHash({}, string_id))) {
+        if (infos_[entry.index].stringId == string_id) return entry.index;
+    }
+    if (string_id_to_index_.empty()) return kNoParam;
+    const auto it = string_id_to_index_.find(std::string(string_id));
+    return it != string_id_to_index_.end() ? it->second : kNoParam;
+}
+
 ParamHandle& ParamsExtension::getHandle(clap_id paramId) {
-    auto it = clap_id_to_index_.find(paramId);
-    ASSERT(it != clap_id_to_index_.end(), "Parameter with CLAP ID {} not found", paramId);
-    uint32_t index = it->second;
+    const uint32_t index = indexOfClapId(paramId);
+    ASSERT(index != kNoParam, "Parameter with CLAP ID {} not found", paramId);
     ASSERT(handles_[index].value_ != nullptr, "Parameter handle not initialized for ID: {}", paramId);
     return handles_[index];
 }
 
 ParamHandle& ParamsExtension::getHandle(std::string_view stringId) {
-    auto it = string_id_to_index_.find(std::string(stringId));
-    ASSERT(it != string_id_to_index_.end(), "Parameter with string ID '{}' not found", stringId);
-    uint32_t index = it->second;
+    const uint32_t index = indexOfStringId(stringId);
+    ASSERT(index != kNoParam, "Parameter with string ID '{}' not found", stringId);
     ASSERT(handles_[index].value_ != nullptr, "Parameter handle not initialized for string ID: {}", stringId);
     return handles_[index];
 }
 
 ParamInfo& ParamsExtension::getInfo(clap_id paramId) {
-    auto it = clap_id_to_index_.find(paramId);
-    ASSERT(it != clap_id_to_index_.end(), "Parameter with CLAP ID {} not found", paramId);
-    return infos_[it->second];
+    const uint32_t index = indexOfClapId(paramId);
+    ASSERT(index != kNoParam, "Parameter with CLAP ID {} not found", paramId);
+    return infos_[index];
 }
 
 ParamInfo& ParamsExtension::getInfo(std::string_view stringId) {
-    auto it = string_id_to_index_.find(std::string(stringId));
-    ASSERT(it != string_id_to_index_.end(), "Parameter with string ID '{}' not found", stringId);
-    return infos_[it->second];
+    const uint32_t index = indexOfStringId(stringId);
+    ASSERT(index != kNoParam, "Parameter with string ID '{}' not found", stringId);
+    return infos_[index];
 }
 
 std::span<ParamInfo> ParamsExtension::getAllParameters() const noexcept {
@@ -382,7 +580,20 @@ std::span<ParamInfo> ParamsExtension::getAllParameters() const noexcept {
 }
 
 void ParamsExtension::processEvents(const clap_input_events_t* in, const clap_output_events_t* out) {
-    if (in) {
+    for (const uint32_t index : automated_) {
+        timelines_[index].reset();
+    }
+    automated_.clear();
+
+    // A state loaded while active takes effect here, all at once, before the block's events
+    if (staged_state_.update()) applyStagedState(*staged_state_.get());
+
+    // Behind ProcessContext::inputEvents() the router already knows whether the block has anything for us
+    const EventRouter* router = EventRouter::fromInputEvents(in);
+    const bool has_param_events =
+        !router || router->hasType(CLAP_EVENT_PARAM_VALUE) || router->hasType(CLAP_EVENT_PARAM_MOD);
+
+    if (in && has_param_events) {
         uint32_t event_count = in->size(in);
 
         for (uint32_t i = 0; i < event_count; ++i) {
@@ -402,9 +613,8 @@ void ParamsExtension::processEvents(const clap_input_events_t* in, const clap_ou
                     ASSERT(index < param_count_ && infos_[index].clapId == param_id,
                            "Cookie for parameter ID {} does not match registry", param_id);
                 } else {
-                    auto it = clap_id_to_index_.find(param_id);
-                    ASSERT(it != clap_id_to_index_.end(), "Parameter ID {} not found in registry", param_id);
-                    index = it->second;
+                    index = indexOfClapId(param_id);
+                    ASSERT(index != kNoParam, "Parameter ID {} not found in registry", param_id);
                 }
                 const auto& param_info = infos_[index];
                 ASSERT(!param_info.internal,
@@ -422,11 +632,26 @@ void ParamsExtension::processEvents(const clap_input_events_t* in, const clap_ou
                     new_value = static_cast<float>(static_cast<int>(new_value));
                 }
 
-                values_[index].store(new_value, std::memory_order_relaxed);
+                auto& timeline = timelines_[index];
+                if (timeline.empty()) automated_.push_back(index);
+                timeline.add(header->time, new_value);
+                storeValue(index, new_value);
+                markHostChanged(index);
+            } else if (header->type == CLAP_EVENT_PARAM_MOD) {
+                const auto* mod_event = reinterpret_cast<const clap_event_param_mod_t*>(header);
+
+                // Per-note modulation targets voices, not the parameter
+                if (mod_event->note_id != -1 || mod_event->key != -1 || mod_event->channel != -1 ||
+                    mod_event->port_index != -1) {
+                    continue;
+                }
+
+                const uint32_t index = findParamIndex(mod_event->cookie, mod_event->param_id);
+                ASSERT(index != kNoParam, "Parameter ID {} not found in registry", mod_event->param_id);
+                if (index == kNoParam) continue;
 
-                // Notify UI of parameter change from host
-                if (message_queue_)
-                    message_queue_->toUi().enqueue({ParamMessageQueue::PARAM_VALUE, param_id, new_value});
+                mod_amounts_[index] = static_cast<float>(mod_event->amount);
+                markDirty(index);
             }
         }
     }
@@ -438,55 +663,219 @@ void ParamsExtension::processEvents(const clap_input_events_t* in, const clap_ou
         while (message_queue_->toAudio().try_dequeue(message)) {
             switch (message.type) {
                 case ParamMessageQueue::PARAM_VALUE: {
-                    clap_event_param_value_t event = {};
-                    event.header.size = sizeof(clap_event_param_value_t);
-                    event.header.time = 0;  // Process at start of buffer
-                    event.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
-                    event.header.type = CLAP_EVENT_PARAM_VALUE;
-                    event.header.flags = 0;
-
-                    event.param_id = message.paramId;
-                    event.cookie = nullptr;  // hosts route plugin output by param_id, not cookie
-                    event.note_id = -1;     // Wildcard - not note-specific
-                    event.port_index = -1;  // Wildcard
-                    event.channel = -1;     // Wildcard
-                    event.key = -1;         // Wildcard
-                    event.value = message.value;
-
-                    out->try_push(out, &event.header);
+                    pushParamValue(out, message.paramId, message.value);
                     break;
                 }
 
                 case ParamMessageQueue::BEGIN_GESTURE: {
-                    clap_event_param_gesture_t event = {};
-                    event.header.size = sizeof(clap_event_param_gesture_t);
-                    event.header.time = 0;  // Process at start of buffer
-                    event.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
-                    event.header.type = CLAP_EVENT_PARAM_GESTURE_BEGIN;
-                    event.header.flags = 0;
-
-                    event.param_id = message.paramId;
-
-                    out->try_push(out, &event.header);
+                    pushParamGesture(out, CLAP_EVENT_PARAM_GESTURE_BEGIN, message.paramId);
                     break;
                 }
 
                 case ParamMessageQueue::END_GESTURE: {
-                    clap_event_param_gesture_t event = {};
-                    event.header.size = sizeof(clap_event_param_gesture_t);
-                    event.header.time = 0;  // Process at start of buffer
-                    event.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
-                    event.header.type = CLAP_EVENT_PARAM_GESTURE_END;
-                    event.header.flags = 0;
-
-                    event.param_id = message.paramId;
-
-                    out->try_push(out, &event.header);
+                    pushParamGesture(out, CLAP_EVENT_PARAM_GESTURE_END, message.paramId);
                     break;
                 }
             }
         }
+
+        // Finished bulk changes go out as one gesture over all their parameters: every begin, then each
+        // parameter's latest value once, then every end, all in parameter order
+        if (bulk_ends_.exchange(0, std::memory_order_acquire) > 0) {
+            bulk_batch_.clear();
+            bulk_values_.consume(param_count_, [this](uint32_t index) { bulk_batch_.push_back(index); });
+            for (const uint32_t index : bulk_batch_) {
+                pushParamGesture(out, CLAP_EVENT_PARAM_GESTURE_BEGIN, infos_[index].clapId);
+            }
+            for (const uint32_t index : bulk_batch_) {
+                pushParamValue(out, infos_[index].clapId, values_[index].load(std::memory_order_relaxed));
+            }
+            for (const uint32_t index : bulk_batch_) {
+                pushParamGesture(out, CLAP_EVENT_PARAM_GESTURE_END, infos_[index].clapId);
+            }
+        }
+
+        // UI changes that overflowed the queue go out coalesced, one event per parameter with its latest value
+        unsent_values_.consume(param_count_, [&](uint32_t index) {
+            pushParamValue(out, infos_[index].clapId, values_[index].load(std::memory_order_relaxed));
+        });
+
+        // Then the ends of gestures that overflowed it, after their begin and values
+        unsent_gesture_ends_.consume(param_count_, [&](uint32_t index) {
+            pushParamGesture(out, CLAP_EVENT_PARAM_GESTURE_END, infos_[index].clapId);
+        });
+    }
+}
+
+void ParamsExtension::beginBulkChange() noexcept { ++bulk_depth_; }
+
+void ParamsExtension::endBulkChange() noexcept {
+    ASSERT(bulk_depth_ > 0, "endBulkChange() without beginBulkChange()");
+    if (--bulk_depth_ > 0) return;
+
+    bulk_ends_.fetch_add(1, std::memory_order_release);
+    if (host_params_ && host_params_->request_flush) host_params_->request_flush(host_);
+}
+
+uint32_t ParamsExtension::dispatchHostChanges() {
+    staged_state_.collect();
+    uint32_t count = 0;
+    host_changed_.consume(param_count_, [this, &count](uint32_t index) {
+        const auto& info = infos_[index];
+        info.on_value_changed(info.getValue());
+        ++count;
+    });
+    return count;
+}
+
+void ParamsExtension::setUiWakeCallback(std::function<void()> wake) {
+    ui_wake_ = std::move(wake);
+    if (!ui_wake_) ui_wake_armed_.store(false, std::memory_order_relaxed);
+}
+
+bool ParamsExtension::armUiWake() noexcept {
+    if (!ui_wake_) return false;
+    ui_wake_armed_.store(true);
+    // A change flagged before the store above didn't see the wake armed
+    if (host_changed_.any(param_count_, std::memory_order_seq_cst) && ui_wake_armed_.exchange(false)) return false;
+    return true;
+}
+
+void ParamsExtension::requestUiWake() noexcept {
+    ui_wake_requested_.store(true, std::memory_order_release);
+    if (host_ && host_->request_callback) host_->request_callback(host_);
+}
+
+void ParamsExtension::onMainThread() noexcept {
+    if (ui_wake_requested_.exchange(false, std::memory_order_acquire) && ui_wake_) ui_wake_();
+}
+
+void ParamsExtension::activate(const ProcessInfo& info) {
+    ASSERT(info.sample_rate > 0.0 && info.max_frame_size > 0, "Invalid process info");
+    smoothing_frames_ = info.max_frame_size;
+    smoothed_values_.assign(smoothers_.size() * smoothing_frames_, 0.0f);
+
+    for (size_t i = 0; i < smoothers_.size(); ++i) {
+        auto& smoother = smoothers_[i];
+        const auto& param = infos_[smoother.index];
+        const double samples = std::max(0.0, static_cast<double>(param.valueSmoothingMs) * 0.001 * info.sample_rate);
+
+        smoother.ramp_samples = std::max<uint32_t>(1, static_cast<uint32_t>(std::lround(samples)));
+        smoother.coeff = samples > 0.0 ? static_cast<float>(std::exp(-1.0 / samples)) : 0.0f;
+        smoother.epsilon = 1e-5f * (param.maxValue - param.minValue);
+        smoother.current = smoother.target = values_[smoother.index].load(std::memory_order_relaxed);
+        smoother.remaining = 0;
+        smoother.values = smoothed_values_.data() + i * smoothing_frames_;
+        std::fill_n(smoother.values, smoothing_frames_, smoother.current);
+        smoother.flat_from = 0;
+        handles_[smoother.index].smoothed_ = smoother.values;
+    }
+    active_ = true;
+}
+
+void ParamsExtension::deactivate() {
+    active_ = false;
+
+    // No more blocks are coming to pick up a staged state, so apply it here
+    if (staged_state_.update()) applyStagedState(*staged_state_.get());
+    staged_state_.collect();
+}
+
+void ParamsExtension::commitStagedState(std::unique_ptr<StagedState> state) {
+    if (active_) {
+        staged_state_.publish(std::move(state));
+        // The host then runs process() or flush(), either of which applies it, even while the plugin sleeps
+        if (host_params_ && host_params_->request_flush) {
+            host_params_->request_flush(host_);
+        } else if (host_ && host_->request_process) {
+            host_->request_process(host_);
+        }
+    } else {
+        applyStagedState(*state);
+    }
+}
+
+void ParamsExtension::applyStagedState(const StagedState& state) noexcept {
+    for (const auto& [index, value] : state.values) {
+        storeValue(index, value);
+        markHostChanged(index);
+    }
+}
+
+void ParamsExtension::processSmoothing(uint32_t start_sample, uint32_t num_frames) noexcept {
+    if (smoothers_.empty()) return;
+    ASSERT(start_sample + num_frames <= smoothing_frames_, "Smoothing past max_frame_size; call activate() first");
+    if (start_sample + num_frames > smoothing_frames_) return;
+
+    for (auto& smoother : smoothers_) {
+        const auto& timeline = timelines_[smoother.index];
+
+        // Settled and not automated: the values are already flat, at most a tail from the last ramp is left
+        if (timeline.empty() && smoother.current == smoother.target && timeline.getValueAt(0) == smoother.target) {
+            if (start_sample < smoother.flat_from) {
+                std::fill(smoother.values + start_sample, smoother.values + smoother.flat_from, smoother.target);
+                smoother.flat_from = start_sample;
+            }
+            continue;
+        }
+
+        timeline.forEachSegment(start_sample, num_frames, [&](uint32_t start, uint32_t length, float target) {
+            renderSmoothing(smoother, target, smoother.values + start, length);
+        });
+        smoother.flat_from = smoothing_frames_;
+    }
+}
+
+void ParamsExtension::renderSmoothing(Smoother& smoother, float target, float* out, uint32_t num_frames) noexcept {
+    using Batch = xsimd::batch<float>;
+    constexpr uint32_t kLanes = Batch::size;
+
+    if (target != smoother.target) {
+        smoother.target = target;
+        if (smoother.mode == ParamSmoothing::Linear) {
+            smoother.remaining = smoother.ramp_samples;
+            smoother.step = (target - smoother.current) / static_cast<float>(smoother.ramp_samples);
+        }
+    }
+
+    uint32_t i = 0;
+    if (smoother.mode == ParamSmoothing::Linear) {
+        const uint32_t ramp = std::min(smoother.remaining, num_frames);
+        const float base = smoother.current;
+        alignas(Batch) std::array<float, kLanes> steps{};
+        for (uint32_t lane = 0; lane < kLanes; ++lane) steps[lane] = static_cast<float>(lane + 1);
+        const auto lane_steps = Batch::load_aligned(steps.data());
+
+        for (; i + kLanes <= ramp; i += kLanes) {
+            xsimd::fma(Batch(smoother.step), lane_steps + Batch(static_cast<float>(i)), Batch(base))
+                .store_unaligned(out + i);
+        }
+        for (; i < ramp; ++i) out[i] = base + smoother.step * static_cast<float>(i + 1);
+
+        smoother.remaining -= ramp;
+        smoother.current = smoother.remaining == 0 ? target : base + smoother.step * static_cast<float>(ramp);
+    } else {
+        // The distance to the target decays by coeff per sample; a batch covers kLanes consecutive samples
+        float distance = smoother.current - target;
+        if (std::abs(distance) > smoother.epsilon) {
+            alignas(Batch) std::array<float, kLanes> powers{};
+            float power = 1.0f;
+            for (uint32_t lane = 0; lane < kLanes; ++lane) powers[lane] = power *= smoother.coeff;
+            const auto lane_powers = Batch::load_aligned(powers.data());
+
+            for (; i + kLanes <= num_frames && std::abs(distance) > smoother.epsilon; i += kLanes) {
+                xsimd::fma(Batch(distance), lane_powers, Batch(target)).store_unaligned(out + i);
+                distance *= power;
+            }
+            for (; i < num_frames && std::abs(distance) > smoother.epsilon; ++i) {
+                distance *= smoother.coeff;
+                out[i] = target + distance;
+            }
+        }
+        if (std::abs(distance) <= smoother.epsilon) distance = 0.0f;
+        smoother.current = target + distance;
     }
+    std::fill(out + i, out + num_frames, smoother.current);
 }
 
 void ParamsExtension::flush(const clap_input_events_t* in, const clap_output_events_t* out) noexcept {
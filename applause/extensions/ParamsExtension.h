@@ -5,19 +5,29 @@
 #include <clap/host.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <span>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <applause/core/Extension.h>
+#include <applause/core/ProcessInfo.h>
+#include <applause/extensions/ParamTable.h>
+#include <applause/util/AtomicBitset.h>
 #include <applause/util/DebugHelpers.h>
 #include <applause/util/Json.h>
 #include <applause/util/ParamMessageQueue.h>
+#include <applause/util/RealtimeSwap.h>
 #include <applause/util/thirdparty/rocket.hpp>
 #include <applause/util/ValueScaling.h>
 
@@ -25,6 +35,16 @@ namespace applause {
 class ParamsExtension;
 class ParamInfo;
 
+/**
+ * @brief Bits of ParamsExtension::getFlagsArray(), mirroring the parameter's ParamConfig.
+ */
+enum ParamFlag : uint8_t {
+    kParamStepped = 1 << 0,
+    kParamInternal = 1 << 1,
+    kParamPolyphonic = 1 << 2,
+    kParamSmoothed = 1 << 3,  ///< Has a value_smoothing
+};
+
 /**
  * @brief Configuration structure for a parameter.
  */
@@ -44,12 +64,105 @@ struct ParamConfig {
                                  ///   for example: osc tuning in a synth would be poly, but master out gain might not
 
     ValueScaling scaling = ValueScaling::linear();  /// Parameter scaling for normalization (default: linear)
+    float smoothing_ms = 0.0f;   /// Modulated-output smoothing time used by ModMatrix (0 = no smoothing)
+    ParamSmoothing value_smoothing = ParamSmoothing::None;  /// Per-sample smoothing of the plain value
+    float value_smoothing_ms = 0.0f;                        /// Time of value_smoothing (see ParamSmoothing)
 
     // Optional custom converters (default to nullptr)
     std::function<std::string(float value, const ParamInfo& info)> value_to_text;
     std::function<std::optional<float>(const std::string& text, const ParamInfo& info)> text_to_value;
 };
 
+/**
+ * The host automation a parameter received during the current block, as a time-sorted list of value changes.
+ *
+ * ParamsExtension::processEvents() fills one timeline per parameter from the block's CLAP_EVENT_PARAM_VALUE
+ * events, keeping each event's sample offset. The parameter's plain value (ParamHandle::getValue()) still jumps
+ * straight to the last of them; DSP code that wants sample-accurate automation reads the timeline instead, via
+ * getValueAt() or forEachSegment(), without splitting its block at every event.
+ *
+ * A timeline is valid from one processEvents() call until the next, and only on the audio thread. Without events
+ * in the block it is empty and reports the parameter's current value everywhere.
+ */
+class ParamTimeline {
+    friend class ParamsExtension;
+
+public:
+    /** Changes kept per parameter per block; further events in a full block overwrite the last change. */
+    static constexpr uint32_t kCapacity = 16;
+
+    struct Point {
+        uint32_t time;  ///< Sample offset within the block
+        float value;    ///< Plain value from this offset on
+    };
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] uint32_t size() const noexcept { return size_; }
+
+    /** The block's value changes, sorted by time. */
+    [[nodiscard]] std::span<const Point> points() const noexcept { return {points_.data(), size_}; }
+
+    /** The parameter's value at the start of the block, before any of its changes. */
+    [[nodiscard]] float getStartValue() const noexcept {
+        return empty() ? value_->load(std::memory_order_relaxed) : start_value_;
+    }
+
+    /** The parameter's value at sample offset sample within the block. */
+    [[nodiscard]] float getValueAt(uint32_t sample) const noexcept {
+        if (empty()) return value_->load(std::memory_order_relaxed);
+        const auto end = points_.begin() + size_;
+        const auto next = std::upper_bound(points_.begin(), end, sample,
+                                           [](uint32_t time, const Point& point) { return time < point.time; });
+        return next == points_.begin() ? start_value_ : std::prev(next)->value;
+    }
+
+    /**
+     * Splits [0, num_frames) into the runs of constant value and calls fn(start, length, value) for each, in
+     * order. Changes at or past num_frames are ignored.
+     */
+    template <typename Fn>
+    void forEachSegment(uint32_t num_frames, Fn&& fn) const {
+        forEachSegment(0, num_frames, std::forward<Fn>(fn));
+    }
+
+    /** As forEachSegment(num_frames, fn), for the sub-block [start_sample, start_sample + num_frames). */
+    template <typename Fn>
+    void forEachSegment(uint32_t start_sample, uint32_t num_frames, Fn&& fn) const {
+        const uint32_t end = start_sample + num_frames;
+        uint32_t start = start_sample;
+        float value = getValueAt(start_sample);
+        for (uint32_t i = 0; i < size_ && points_[i].time < end; ++i) {
+            if (points_[i].time <= start_sample) continue;
+            fn(start, points_[i].time - start, value);
+            start = points_[i].time;
+            value = points_[i].value;
+        }
+        if (end > start) fn(start, end - start, value);
+    }
+
+private:
+    void reset() noexcept { size_ = 0; }
+
+    // Hosts must deliver a block's events sorted by time, so changes are appended; a change at the same offset as
+    // the last one replaces it
+    void add(uint32_t time, float value) noexcept {
+        if (empty()) start_value_ = value_->load(std::memory_order_relaxed);
+        if (size_ > 0 && time <= points_[size_ - 1].time) {
+            points_[size_ - 1].value = value;
+        } else if (size_ < kCapacity) {
+            points_[size_++] = {time, value};
+        } else {
+            points_[size_ - 1] = {time, value};
+        }
+    }
+
+    const std::atomic<float>* value_ = nullptr;
+    float start_value_ = 0.0f;
+    uint32_t size_ = 0;
+    std::array<Point, kCapacity> points_{};
+};
+
 /**
  * Provides a lightweight, efficient, and thread-safe handle
  * for interacting with a parameter's value.
@@ -62,10 +175,36 @@ struct ParamHandle {
     friend class ParamInfo;
 
 private:
-    std::atomic<float>* value_ = nullptr;
+    const std::atomic<float>* value_ = nullptr;
+    const std::atomic<float>* normalized_ = nullptr;
+    const ParamTimeline* timeline_ = nullptr;
+    const float* smoothed_ = nullptr;
+    const float* modulation_ = nullptr;
 
 public:
     [[nodiscard]] float getValue() const noexcept { return value_->load(std::memory_order_relaxed); }
+
+    /** The value normalized to [0, 1] with the parameter's scaling; cached on write, so reading it is cheap. */
+    [[nodiscard]] float getNormalizedValue() const noexcept { return normalized_->load(std::memory_order_relaxed); }
+
+    /** The parameter's value at sample offset sample within the current block, following host automation. */
+    [[nodiscard]] float getValueAt(uint32_t sample) const noexcept { return timeline_->getValueAt(sample); }
+
+    /** The host automation received for the current block. See ParamTimeline. */
+    [[nodiscard]] const ParamTimeline& getTimeline() const noexcept { return *timeline_; }
+
+    /**
+     * The current block's smoothed values, indexed by sample offset within the block. Only parameters registered
+     * with a value_smoothing have them, once ParamsExtension::activate() has run; otherwise this is nullptr.
+     * Valid for the samples ParamsExtension::processSmoothing() has covered so far in the block.
+     */
+    [[nodiscard]] const float* getSmoothedValues() const noexcept { return smoothed_; }
+
+    /**
+     * The host's global (not per-note) modulation of the parameter, in plain units on top of getValue().
+     * Audio thread only. Per-note modulation is routed to voices by a Synthesizer with a ModMatrix instead.
+     */
+    [[nodiscard]] float getModulation() const noexcept { return *modulation_; }
 };
 
 /**
@@ -140,9 +279,24 @@ public:
     /**
      * If true, the parameter supports polyphonic modulation (per-voice values).
      * For example, oscillator tuning would be polyphonic, but master volume might not.
+     * Polyphonic parameters are also offered to the host for modulation: globally, and per note once
+     * ParamsExtension::setPerNoteModulation() says something routes it to the voices.
      */
     bool polyphonic = false;
 
+    /**
+     * Smoothing time in milliseconds that a ModMatrix applies to this parameter's modulated output
+     * (0 = no smoothing). Only honored by matrices configured with smooth_outputs.
+     */
+    float smoothingMs = 0.0f;
+
+    /**
+     * How ParamsExtension::processSmoothing() smooths the plain value, and over how many milliseconds.
+     * DSP code reads the result through ParamHandle::getSmoothedValues().
+     */
+    ParamSmoothing valueSmoothing = ParamSmoothing::None;
+    float valueSmoothingMs = 0.0f;
+
     /**
      * The original string identifier used during registration.
      * Used for modulation destination registration and state serialization.
@@ -150,7 +304,8 @@ public:
     std::string stringId;
 
     /**
-     * Signal emitted when the parameter value changes from the host side.
+     * Signal emitted when the parameter value changes from the host side (see
+     * ParamsExtension::dispatchHostChanges()) or through setValueNotifyingHost().
      * UI components can connect to this to update their visual state.
      */
     mutable rocket::signal<void(float)> on_value_changed;
@@ -185,6 +340,9 @@ public:
      * Notify the host that parameter gesture has ended (e.g., user released
      * slider). This should be called when the user finishes interacting with a
      * parameter control.
+     *
+     * Begins and ends reach the host in pairs: a second begin while the gesture is open is ignored, an end without
+     * a begin the host saw is dropped, and an end that doesn't fit the message queue goes out with the next block.
      */
     void endGesture() const noexcept;
 
@@ -197,6 +355,14 @@ public:
      */
     std::string valueToText(float value) const noexcept;
 
+    /**
+     * As valueToText(), writing the text into out (NUL-terminated, truncated to capacity) instead. With the default
+     * formatting this doesn't allocate; a custom converter's string is copied in.
+     *
+     * @return The length of the text written, without the NUL
+     */
+    size_t valueToText(float value, char* out, size_t capacity) const noexcept;
+
     /**
      * Parse user input text to extract a numeric value for this parameter.
      *
@@ -247,7 +413,7 @@ private:
     // for this.
     ParamsExtension* registry_ = nullptr;
 
-    // Custom converters (following member naming convention)
+    // Custom converters (following member naming convention); empty for the default ones
     std::function<std::string(float value, const ParamInfo& info)> value_to_text_;
     std::function<std::optional<float>(const std::string& text, const ParamInfo& info)> text_to_value_;
 
@@ -278,7 +444,9 @@ private:
  * the audio thread. If your plugin has a GUI, you'll need to make sure that
  * both the ParamsExtension and the GUI share a pointer to a ParamMessageQueue.
  * The applause GUIExtension comes with a ParamMessageQueue that you can plug
- * directly into your ParamsExtension during construction.
+ * directly into your ParamsExtension during construction. Changes made by the
+ * host travel the other way without the queue: the UI picks them up, coalesced,
+ * through dispatchHostChanges().
  */
 class ParamsExtension : public IExtension {
     friend struct ParamHandle;
@@ -301,11 +469,129 @@ private:
     void flush(const clap_input_events_t* in, const clap_output_events_t* out) noexcept;
 
     ParamMessageQueue* message_queue_;
+    bool per_note_modulation_ = false;
     const clap_host_params_t* host_params_ = nullptr;
-    std::unique_ptr<std::atomic<float>[]> values_;
+
+    // Audio-thread state: parallel arrays carved from one allocation, each starting on its own cache line, so DSP
+    // reads of a parameter field touch only that array's lines instead of striding over the UI-side ParamInfos
+    std::vector<std::byte> hot_storage_;
+    std::atomic<float>* values_ = nullptr;
+    std::atomic<float>* normalized_ = nullptr;  // Cache of values_ normalized, updated by storeValue()
+    ValueScaleInfo* scale_info_ = nullptr;      // DSP-safe scaling info
+    float* mod_amounts_ = nullptr;              // Host's global modulation, plain units
+    uint8_t* flags_ = nullptr;                  // ParamFlag bits
+
     std::unique_ptr<ParamHandle[]> handles_;
     std::unique_ptr<ParamInfo[]> infos_;
-    std::unique_ptr<ValueScaleInfo[]> scale_info_;  // DSP-safe scaling info (parallel to values_)
+    std::unique_ptr<ParamTimeline[]> timelines_;    // Current block's automation (parallel to values_)
+    std::vector<uint32_t> automated_;               // Indices of non-empty timelines, reset every processEvents()
+    mutable AtomicBitset dirty_;  // One bit per parameter, set whenever its value is written
+    AtomicBitset host_changed_;   // One bit per parameter, set when the host or a state load writes its value
+    mutable AtomicBitset snapshot_changed_;  // Like dirty_, for consumeSnapshotChanges()
+    mutable AtomicBitset user_changed_;      // UI thread: values written through setValueNotifyingHost()
+    AtomicBitset text_stale_;                // Like dirty_, for the value text cache
+
+    // Main thread: each parameter's text for its current value, as last given to the host's value_to_text(), which
+    // hosts poll for every visible lane and strip. Dropped once the parameter's text_stale_ bit is raised.
+    struct CachedText {
+        static constexpr size_t kCapacity = 48;
+        bool valid = false;
+        uint8_t length = 0;
+        float value = 0.0f;
+        std::array<char, kCapacity> text{};
+    };
+    std::unique_ptr<CachedText[]> cached_text_;
+    AtomicBitset unsent_values_;  // UI value changes that didn't fit the message queue, sent by processEvents()
+    AtomicBitset unsent_gesture_ends_;  // Gesture ends that didn't fit the message queue, sent by processEvents()
+
+    // UI thread: where each parameter's gesture stands, so begins and ends reach the host in pairs
+    enum class GestureState : uint8_t {
+        Closed,
+        Open,        ///< Begin queued, end not yet
+        EndPending,  ///< End waiting in unsent_gesture_ends_
+    };
+    std::unique_ptr<GestureState[]> gesture_state_;
+    AtomicBitset bulk_values_;    // UI value changes made inside a bulk change
+    std::atomic<uint32_t> bulk_ends_{0};  // Bulk changes ended since processEvents() last sent them
+    std::vector<uint32_t> bulk_batch_;    // Audio-thread scratch for sending a bulk change
+    uint32_t bulk_depth_ = 0;             // UI thread: nesting of beginBulkChange()
+
+    // Parameter values of a loaded state, applied together by the audio thread
+    struct StagedState {
+        std::vector<std::pair<uint32_t, float>> values;  // Parameter index, clamped plain value
+    };
+    RealtimeSwap<StagedState> staged_state_;
+    bool active_ = false;  // Main thread: between activate() and deactivate()
+
+    // The idle UI's wake-up: armed by armUiWake(), fired by the next host change through request_callback()
+    std::function<void()> ui_wake_;
+    std::atomic<bool> ui_wake_armed_{false};
+    std::atomic<bool> ui_wake_requested_{false};
+
+    void commitStagedState(std::unique_ptr<StagedState> state);
+    void applyStagedState(const StagedState& state) noexcept;
+
+    // One per parameter registered with a value_smoothing
+    struct Smoother {
+        uint32_t index;             // Parameter index
+        ParamSmoothing mode;
+        float current = 0.0f;       // Last smoothed value
+        float target = 0.0f;
+        float step = 0.0f;          // Linear: per-sample increment of the running ramp
+        uint32_t remaining = 0;     // Linear: samples left in the running ramp
+        uint32_t ramp_samples = 1;  // Linear: length of a full ramp
+        float coeff = 0.0f;         // Exponential: per-sample pole
+        float epsilon = 0.0f;       // Exponential: distance from the target at which the smoother snaps to it
+        uint32_t flat_from = 0;     // The smoothed values from here to the end of the buffer all equal target
+        float* values = nullptr;    // smoothing_frames_ smoothed values
+    };
+    std::vector<Smoother> smoothers_;
+    std::vector<float> smoothed_values_;
+    uint32_t smoothing_frames_ = 0;
+
+    static void renderSmoothing(Smoother& smoother, float target, float* out, uint32_t num_frames) noexcept;
+
+    // Stores a parameter's plain value and refreshes its normalized cache, from any thread. When two threads
+    // write at once, whichever stores the cache last re-checks it against the value, so the two can't stay apart.
+    void storeValue(uint32_t index, float plain) noexcept {
+        values_[index].store(plain);
+        const auto& s = scale_info_[index];
+        for (float stored = plain;;) {
+            normalized_[index].store(s.scaling.toNormalized(stored, s.min, s.max));
+            const float current = values_[index].load();
+            if (current == stored) break;
+            stored = current;
+        }
+    }
+
+    // Call after storing the new value, from any thread
+    void markDirty(uint32_t index) noexcept {
+        dirty_.set(index);
+        snapshot_changed_.set(index);
+        text_stale_.set(index);
+    }
+
+    // As markDirty(), for values the UI hasn't seen yet
+    void markHostChanged(uint32_t index) noexcept {
+        markDirty(index);
+        // Sequentially consistent against armUiWake(), which raises the flag and then checks the bits, so one of
+        // the two always sees the other
+        host_changed_.set(index, std::memory_order_seq_cst);
+        if (ui_wake_armed_.load() && ui_wake_armed_.exchange(false)) requestUiWake();
+    }
+
+    void requestUiWake() noexcept;
+
+    void carveHotStorage();
+    void addParam(const ParamConfig& config, clap_id id);
+    void registerTable(std::span<const ParamDecl> decls, std::span<const clap_id> clap_ids,
+                       std::span<const ParamIdEntry> by_clap_id, std::span<const ParamIdEntry> by_string_id);
+    [[nodiscard]] uint32_t indexOfClapId(clap_id id) const noexcept;
+    [[nodiscard]] uint32_t indexOfStringId(std::string_view string_id) const noexcept;
+
+    // Sorted id tables of parameters registered through a ParamTable, searched before the maps
+    std::vector<ParamIdEntry> table_by_clap_id_;
+    std::vector<ParamIdEntry> table_by_string_id_;
 
     // Lookup structures for O(1) access
     std::unordered_map<clap_id, uint32_t> clap_id_to_index_;
@@ -320,6 +606,7 @@ public:
     static constexpr const char* ID = CLAP_EXT_PARAMS;
 
     void onHostReady() noexcept override;
+    void onMainThread() noexcept override;
 
     /**
      * @brief Construct the parameters extension with space for up to
@@ -329,6 +616,8 @@ public:
 
     // Default converter functions (static members)
     static std::string defaultValueToText(float value, const ParamInfo& info);
+    /** As defaultValueToText(), into out without allocating; returns the length written, as ParamInfo's. */
+    static size_t defaultValueToText(float value, const ParamInfo& info, char* out, size_t capacity) noexcept;
     static std::optional<float> defaultTextToValue(const std::string& text, const ParamInfo& info);
 
     const char* id() const override { return ID; }
@@ -343,6 +632,15 @@ public:
      */
     void setMessageQueue(ParamMessageQueue* queue) { message_queue_ = queue; }
 
+    /**
+     * @brief Offer the host per-note modulation of polyphonic parameters, i.e. the MODULATABLE_PER_* flags.
+     * Enable it only when per-note CLAP_EVENT_PARAM_MOD events reach the voices, e.g. through a Synthesizer bound
+     * to a ModMatrix built with Config::host_modulation; otherwise polyphonic parameters only take global
+     * modulation. Call before the host scans the parameters, or rescan(CLAP_PARAM_RESCAN_INFO) after.
+     * @note Main thread only
+     */
+    void setPerNoteModulation(bool enabled) noexcept { per_note_modulation_ = enabled; }
+
     /**
      * @brief Register a new parameter with the extension.
      * @param config ParamConfig containing the parameter configuration
@@ -352,6 +650,18 @@ public:
      */
     void registerParam(const ParamConfig& config);
 
+    /**
+     * @brief Register every parameter of a compile-time ParamTable, in table order.
+     * Parameter indices equal table indices, so handles can be resolved at compile time with
+     * getHandleAt(table.index("...")). The CLAP ids and sorted lookup tables come precomputed from the table, so
+     * no hash maps are built: getHandle(), getInfo() and host lookups binary-search the table.
+     * @note Call before registering any other parameter; registerParam() may add more afterwards.
+     */
+    template <size_t N>
+    void registerParams(const ParamTable<N>& table) {
+        registerTable(table.decls(), table.clapIds(), table.byClapId(), table.byStringId());
+    }
+
     /**
      * @brief Get a lightweight handle for real-time (audio thread) parameter
      * read-only access.
@@ -395,6 +705,22 @@ public:
      */
     ParamInfo& getInfo(std::string_view stringId);
 
+    /**
+     * @brief Get the handle of the parameter at index, e.g. a ParamTable::index().
+     */
+    ParamHandle& getHandleAt(uint32_t index) {
+        ASSERT(index < param_count_, "Parameter index {} out of range", index);
+        return handles_[index];
+    }
+
+    /**
+     * @brief Get the info of the parameter at index, e.g. a ParamTable::index().
+     */
+    ParamInfo& getInfoAt(uint32_t index) {
+        ASSERT(index < param_count_, "Parameter index {} out of range", index);
+        return infos_[index];
+    }
+
     /**
      * @brief Get a span of all registered parameters.
      * @return std::span containing all ParamInfo objects
@@ -407,9 +733,7 @@ public:
      * Get normalized value for parameter at index (DSP-safe).
      */
     [[nodiscard]] float getNormalizedAt(uint32_t index) const noexcept {
-        float plain = values_[index].load(std::memory_order_relaxed);
-        const auto& s = scale_info_[index];
-        return s.scaling.toNormalized(plain, s.min, s.max);
+        return normalized_[index].load(std::memory_order_relaxed);
     }
 
     /**
@@ -420,18 +744,135 @@ public:
         return s.scaling.fromNormalized(norm, s.min, s.max);
     }
 
+    /**
+     * Get the current block's automation timeline for parameter at index (DSP-safe).
+     */
+    [[nodiscard]] const ParamTimeline& getTimelineAt(uint32_t index) const noexcept {
+        return timelines_[index];
+    }
+
+    /**
+     * Call fn(index) for every parameter whose value was written since the last call, and clear their dirty
+     * bits (DSP-safe, lock-free).
+     *
+     * Values written by processEvents(), the UI (ParamInfo::setValueNotifyingHost() and setValueSilently()),
+     * loadFromJson() and registration all mark their parameter dirty, so bulk consumers like
+     * ModMatrix::loadParamBaseValues() can convert only what changed instead of every parameter each block.
+     * An index may be reported although its value ended up unchanged. Bits are consumed, so each extension
+     * should have a single consumer.
+     */
+    template <typename Fn>
+    void consumeChangedParams(Fn&& fn) const noexcept {
+        dirty_.consume(param_count_, std::forward<Fn>(fn));
+    }
+
+    /**
+     * As consumeChangedParams(), but with a set of bits of its own, for a second consumer on the UI side such as
+     * UndoHistory, which records what an edit changed. Calls fn(index, by_user) for every value written, where
+     * by_user tells ParamInfo::setValueNotifyingHost() (the UI, including bulk changes) apart from host
+     * automation, global modulation, setValueSilently() and state loads.
+     * @note UI thread only
+     */
+    template <typename Fn>
+    void consumeSnapshotChanges(Fn&& fn) const noexcept {
+        snapshot_changed_.consume(param_count_,
+                                  [&](uint32_t index) { fn(index, user_changed_.consumeOne(index)); });
+    }
+
+    /**
+     * @brief Emit ParamInfo::on_value_changed for every parameter the host or loadFromJson() changed since the
+     * last call, once each and with its latest value.
+     * processEvents() only flags host changes instead of queueing one UI message per event, so dense automation
+     * costs the UI at most one update per parameter per call, however many events arrived in between. The
+     * ApplauseEditor calls this once per display frame while it is awake.
+     * @return The number of parameters notified
+     * @note UI thread only
+     */
+    uint32_t dispatchHostChanges();
+
+    /**
+     * @brief Set what an idle UI runs to wake up when the host changes a parameter, or clear it with nullptr.
+     * The callback runs on the main thread, from the host's on_main_thread() callback, after armUiWake().
+     * @note UI thread only
+     */
+    void setUiWakeCallback(std::function<void()> wake);
+
+    /**
+     * @brief Ask for one call of the wake callback at the next host parameter change, so a UI with nothing
+     * left to show can stop polling dispatchHostChanges() until there's news.
+     * The audio thread asks the host for a main-thread callback (clap_host::request_callback()) and the
+     * callback runs from there. If a change arrived since the last dispatchHostChanges(), nothing is armed.
+     * @return Whether the UI can go idle: false when changes are already waiting or no wake callback is set
+     * @note UI thread only
+     */
+    bool armUiWake() noexcept;
+
+    /**
+     * @brief Group the following ParamInfo::setValueNotifyingHost() calls, e.g. of a preset morph or randomize,
+     * into one change for the host.
+     * Until the matching endBulkChange(), values are stored and UI listeners notified as usual, but nothing is
+     * queued for the audio thread. The next processEvents() after endBulkChange() then sends the host, for all
+     * parameters that changed, their gesture begins, one value each (the latest) and their gesture ends, so
+     * hundreds of writes cost the host's automation recorder a single gesture per parameter. Calls may nest; only
+     * the outermost pair counts.
+     * @note UI thread only; requires a message queue, like setValueNotifyingHost()
+     */
+    void beginBulkChange() noexcept;
+
+    /**
+     * @brief Finish the bulk change started by beginBulkChange() and ask the host for a flush to send it.
+     */
+    void endBulkChange() noexcept;
+
+    /**
+     * Get the host's global modulation amounts, in plain units and parallel to the values array (DSP-safe bulk
+     * access; audio thread only).
+     */
+    [[nodiscard]] const float* getModulationArray() const noexcept {
+        return mod_amounts_;
+    }
+
+    static constexpr uint32_t kNoParam = ~uint32_t{0};
+
+    /**
+     * Find the index of the parameter a CLAP event refers to (DSP-safe). Uses the event's cookie when the host
+     * echoes it, which is a pointer difference; only cookie-less events fall back to looking up param_id.
+     * @return The parameter index, or kNoParam if there is no such parameter
+     */
+    [[nodiscard]] uint32_t findParamIndex(const void* cookie, clap_id param_id) const noexcept {
+        if (cookie) [[likely]] {
+            const auto index = static_cast<uint32_t>(static_cast<const ParamHandle*>(cookie) - handles_.get());
+            return index < param_count_ && infos_[index].clapId == param_id ? index : kNoParam;
+        }
+        return indexOfClapId(param_id);
+    }
+
     /**
      * Get raw values array pointer (DSP-safe bulk access).
      */
     [[nodiscard]] const std::atomic<float>* getValuesArray() const noexcept {
-        return values_.get();
+        return values_;
+    }
+
+    /**
+     * Get the normalized values array pointer, a cache kept in sync with the values array (DSP-safe bulk access).
+     */
+    [[nodiscard]] const std::atomic<float>* getNormalizedArray() const noexcept {
+        return normalized_;
     }
 
     /**
      * Get scale info array pointer (DSP-safe bulk access).
      */
     [[nodiscard]] const ValueScaleInfo* getScaleInfoArray() const noexcept {
-        return scale_info_.get();
+        return scale_info_;
+    }
+
+    /**
+     * Get the ParamFlag bits array pointer (DSP-safe bulk access).
+     */
+    [[nodiscard]] const uint8_t* getFlagsArray() const noexcept {
+        return flags_;
     }
 
     /**
@@ -446,11 +887,41 @@ public:
      * If you use the ParamsExtension, you MUST call this in your process()
      * function so that the extension can respond to parameter events and send
      * outgoing parameter changes to the host.
+     *
+     * Each call starts a new block: the previous block's ParamTimelines are cleared and refilled from this
+     * block's parameter events, keeping their sample offsets. Global CLAP_EVENT_PARAM_MOD events set the
+     * parameter's modulation amount (ParamHandle::getModulation()); per-note ones are left to the Synthesizer.
+     * Given ProcessContext::inputEvents(), blocks without parameter events skip the event loop entirely.
      * @param in The CLAP input event struct from process()
      * @param out the CLAP output event struct from process()
      */
     void processEvents(const clap_input_events_t* in, const clap_output_events_t* out);
 
+    /**
+     * @brief Prepare value smoothing and staged state loads for processing.
+     * Call this from your plugin's activate(), and deactivate() from its deactivate(). It sizes the smoothed
+     * value buffers for info.max_frame_size, converts smoothing times to per-sample rates and settles every
+     * smoother at its parameter's current value, and makes state loads take effect at a block boundary (see
+     * loadFromJson()).
+     * @note Register all parameters before the first call; allocates, so never call it from the audio thread
+     */
+    void activate(const ProcessInfo& info);
+
+    /**
+     * @brief End processing started by activate(). Call this from your plugin's deactivate().
+     * Between activate() and deactivate(), loadFromJson() and loadFromBinary() only stage the loaded values, and
+     * the next processEvents() applies them all at once at the block boundary.
+     */
+    void deactivate();
+
+    /**
+     * @brief Advance every smoothed parameter over [start_sample, start_sample + num_frames) of the block.
+     * Call after processEvents(), either once for the whole block or once per sub-block, in order. Smoothers
+     * follow the block's automation timelines sample-accurately and the current value otherwise, and write one
+     * value per sample into their ParamHandle::getSmoothedValues(). Settled parameters cost nothing after a block.
+     */
+    void processSmoothing(uint32_t start_sample, uint32_t num_frames) noexcept;
+
     /**
      * @brief Request the host to rescan parameter info. This allows the host to know that parameter metadata,
      * e.g. display name, has changed.
@@ -480,11 +951,67 @@ public:
      * (useful when loading older states or states from different plugin
      * versions).
      *
+     * While the extension is active (see activate()), the values are parsed into a staged state and handed to
+     * the audio thread, which applies them together at the start of the next processEvents(), so a block never
+     * sees half a preset; the host is asked for a flush, so a sleeping plugin applies them too. Otherwise they're
+     * applied right away.
+     *
      * @param json The JSON object containing parameter data
      * @return true on success, false on error
      * @note Call this from your StateExtension load callback
      */
-    bool loadFromJson(const applause::json& json) noexcept;
+    bool loadFromJson(const applause::json& json);
+
+    /**
+     * @brief Save all parameter values as one compact binary value.
+     *
+     * Stores the parameter count, then every parameter's CLAP id and value as little-endian 32-bit words, as a
+     * applause::json::binary(). Meant for StateExtension's StateFormat::Binary, which stores it as a raw byte
+     * string; JSON text spells binary values out as a byte array.
+     *
+     * @param json The JSON value to save parameters into (typically json["params"])
+     * @return true on success, false on error
+     * @note Call this from your StateExtension save callback
+     */
+    bool saveToBinary(applause::json& json) noexcept;
+
+    /**
+     * @brief Load parameter values saved by saveToBinary(), or by saveToJson() in states that predate it.
+     * Staged like loadFromJson().
+     *
+     * @param json The JSON value containing parameter data
+     * @return true on success, false on error
+     * @note Call this from your StateExtension load callback
+     */
+    bool loadFromBinary(const applause::json& json) noexcept;
+
+    /**
+     * @brief Append all parameter values to bytes, in the layout saveToBinary() uses.
+     * For containers that store the block themselves, e.g. PresetBank.
+     */
+    bool saveToBytes(std::vector<uint8_t>& bytes) noexcept;
+
+    /**
+     * @brief Load parameter values from a block written by saveToBytes() or saveToBinary(), straight from
+     * wherever it's stored, e.g. a memory-mapped PresetBank. Staged like loadFromJson().
+     *
+     * @param bytes The block; extra bytes after it are ignored
+     * @return true on success, false if the block is truncated
+     */
+    bool loadFromBytes(std::span<const uint8_t> bytes) noexcept;
+
+private:
+    // Adds a value loaded from a state to staged; false if there's no such parameter
+    bool stageStateValue(StagedState& staged, clap_id param_id, float value) {
+        const uint32_t index = indexOfClapId(param_id);
+        if (index == kNoParam) {
+            LOG_DBG("Parameter with ID {} not found in current plugin", param_id);
+            return false;
+        }
+        const auto& info = infos_[index];
+        staged.values.emplace_back(index, std::clamp(value, info.minValue, info.maxValue));
+        return true;
+    }
 };
 
 // Inline implementations for JSON serialization
@@ -519,13 +1046,15 @@ inline bool ParamsExtension::saveToJson(applause::json& json) noexcept {
     }
 }
 
-inline bool ParamsExtension::loadFromJson(const applause::json& json) noexcept {
+inline bool ParamsExtension::loadFromJson(const applause::json& json) {
     try {
         if (!json.is_array()) {
             LOG_WARN("Parameters JSON is not an array; skipping parameter load");
             return true;  // Not a fatal error — ignore unexpected shapes
         }
 
+        auto staged = std::make_unique<StagedState>();
+        staged->values.reserve(json.size());
         [[maybe_unused]] size_t loaded_count = 0;
         [[maybe_unused]] size_t missing_count = 0;
 
@@ -541,24 +1070,13 @@ inline bool ParamsExtension::loadFromJson(const applause::json& json) noexcept {
             const float value = param_obj.value("value", 0.0f);
 
             // Apply the value if we have this parameter
-            auto it = clap_id_to_index_.find(param_id);
-            if (it != clap_id_to_index_.end()) {
-                uint32_t index = it->second;
-                const auto& info = infos_[index];
-                const float clamped = std::clamp(value, info.minValue, info.maxValue);
-                values_[index].store(clamped, std::memory_order_relaxed);
-
-                // Notify UI of parameter change if message queue exists
-                if (message_queue_) {
-                    message_queue_->toUi().enqueue({ParamMessageQueue::PARAM_VALUE, param_id, clamped});
-                }
-
+            if (stageStateValue(*staged, param_id, value)) {
                 loaded_count++;
             } else {
                 missing_count++;
-                LOG_DBG("Parameter with ID {} not found in current plugin", param_id);
             }
         }
+        commitStagedState(std::move(staged));
 
         LOG_DBG("Loaded {} parameters from JSON state ({} missing/removed)", loaded_count, missing_count);
         return true;
@@ -570,4 +1088,101 @@ inline bool ParamsExtension::loadFromJson(const applause::json& json) noexcept {
         return false;
     }
 }
+
+inline bool ParamsExtension::saveToBinary(applause::json& json) noexcept {
+    applause::json::binary_t bytes;
+    if (!saveToBytes(bytes)) return false;
+    try {
+        json = applause::json::binary(std::move(bytes));
+        return true;
+    } catch (...) {
+        LOG_ERR("Failed to save parameters to binary: out of memory");
+        return false;
+    }
+}
+
+inline bool ParamsExtension::loadFromBinary(const applause::json& json) noexcept {
+    // States saved before switching to binary hold the JSON array
+    if (json.is_array()) return loadFromJson(json);
+
+    if (json.is_binary()) return loadFromBytes(json.get_binary());
+
+    try {
+        // Binary values survive only binary formats; JSON text spells them as {"bytes": [...], "subtype": ...}
+        if (!json.is_object() || !json.contains("bytes")) {
+            LOG_WARN("Parameters state is neither binary nor a JSON array; skipping parameter load");
+            return true;  // Not a fatal error — ignore unexpected shapes
+        }
+        const auto spelled = json.at("bytes").get<std::vector<uint8_t>>();
+        return loadFromBytes(spelled);
+    } catch (const std::exception& e) {
+        LOG_ERR("Failed to load parameters from binary: {}", e.what());
+        return false;
+    } catch (...) {
+        LOG_ERR("Failed to load parameters from binary: unknown exception");
+        return false;
+    }
+}
+
+inline bool ParamsExtension::saveToBytes(std::vector<uint8_t>& bytes) noexcept {
+    try {
+        bytes.reserve(bytes.size() + 4 + 8 * size_t{param_count_});
+        const auto put32 = [&bytes](uint32_t word) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                bytes.push_back(static_cast<uint8_t>(word >> shift));
+            }
+        };
+
+        put32(param_count_);
+        for (uint32_t i = 0; i < param_count_; ++i) {
+            put32(infos_[i].clapId);
+            put32(std::bit_cast<uint32_t>(values_[i].load(std::memory_order_relaxed)));
+        }
+
+        LOG_DBG("Saved {} parameter values to binary state", param_count_);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERR("Failed to save parameters to binary: {}", e.what());
+        return false;
+    } catch (...) {
+        LOG_ERR("Failed to save parameters to binary: unknown exception");
+        return false;
+    }
+}
+
+inline bool ParamsExtension::loadFromBytes(std::span<const uint8_t> bytes) noexcept {
+    try {
+        const auto get32 = [&bytes](size_t offset) {
+            uint32_t word = 0;
+            for (size_t i = 0; i < 4; ++i) {
+                word |= static_cast<uint32_t>(bytes[offset + i]) << (8 * i);
+            }
+            return word;
+        };
+
+        const size_t count = bytes.size() >= 4 ? get32(0) : 0;
+        if (bytes.size() < 4 || (bytes.size() - 4) / 8 < count) {
+            LOG_WARN("Parameters binary state is truncated; skipping parameter load");
+            return false;
+        }
+
+        auto staged = std::make_unique<StagedState>();
+        staged->values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const float value = std::bit_cast<float>(get32(8 + 8 * i));
+            if (std::isfinite(value)) stageStateValue(*staged, get32(4 + 8 * i), value);
+        }
+        [[maybe_unused]] const size_t loaded_count = staged->values.size();
+        commitStagedState(std::move(staged));
+
+        LOG_DBG("Loaded {} parameters from binary state ({} missing/removed)", loaded_count, count - loaded_count);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERR("Failed to load parameters from binary: {}", e.what());
+        return false;
+    } catch (...) {
+        LOG_ERR("Failed to load parameters from binary: unknown exception");
+        return false;
+    }
+}
 }  // namespace applause
@@ -0,0 +1,199 @@
+#include "PresetDiscoveryFactory.h"
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/PresetIndex.h>
+
+#include <chrono>
+#include <cstring>
+#include <system_error>
+
+namespace applause {
+namespace {
+// Seconds since the Unix epoch of a PresetIndexEntry::modified time. file_clock's epoch is unspecified, so this
+// goes through the current time of both clocks
+clap_timestamp toClapTimestamp(int64_t modified) {
+    using namespace std::chrono;
+    const std::filesystem::file_time_type file_time{std::filesystem::file_time_type::duration{modified}};
+    const auto since_epoch = duration_cast<seconds>(file_time - std::filesystem::file_time_type::clock::now() +
+                                                    system_clock::now().time_since_epoch());
+    return since_epoch.count() > 0 ? static_cast<clap_timestamp>(since_epoch.count()) : CLAP_TIMESTAMP_UNKNOWN;
+}
+}  // namespace
+
+/**
+ * One provider per host indexing session, with its own PresetIndex; the host may run several concurrently.
+ */
+class PresetDiscoveryFactory::Provider {
+public:
+    Provider(const PresetDiscoveryFactory& factory, const clap_preset_discovery_indexer_t* indexer)
+        : factory_(factory), indexer_(indexer), index_(factory.config_.file_extension) {
+        clap_.desc = &factory.descriptor_;
+        clap_.provider_data = this;
+        clap_.init = clap_init;
+        clap_.destroy = clap_destroy;
+        clap_.get_metadata = clap_get_metadata;
+        clap_.get_extension = clap_get_extension;
+    }
+
+    const clap_preset_discovery_provider_t* clapProvider() const noexcept { return &clap_; }
+
+private:
+    static Provider* self(const clap_preset_discovery_provider_t* provider) {
+        return static_cast<Provider*>(provider->provider_data);
+    }
+
+    static bool clap_init(const clap_preset_discovery_provider_t* provider) noexcept {
+        try {
+            return self(provider)->init();
+        } catch (...) {
+            return false;
+        }
+    }
+
+    static void clap_destroy(const clap_preset_discovery_provider_t* provider) noexcept {
+        auto* provider_self = self(provider);
+        try {
+            provider_self->saveIndex();
+        } catch (...) {
+        }
+        delete provider_self;
+    }
+
+    static bool clap_get_metadata(const clap_preset_discovery_provider_t* provider, uint32_t location_kind,
+                                  const char* location,
+                                  const clap_preset_discovery_metadata_receiver_t* receiver) noexcept {
+        if (location_kind != CLAP_PRESET_DISCOVERY_LOCATION_FILE || !location || !receiver) return false;
+        try {
+            return self(provider)->getMetadata(pathFromUtf8(location), receiver);
+        } catch (const std::exception& e) {
+            receiver->on_error(receiver, 0, e.what());
+            return false;
+        }
+    }
+
+    static const void* clap_get_extension(const clap_preset_discovery_provider_t*, const char*) noexcept {
+        return nullptr;
+    }
+
+    bool init() {
+        const PresetDiscoveryConfig& config = factory_.config_;
+        if (!config.index_file.empty()) index_.load(config.index_file);
+
+        const clap_preset_discovery_filetype_t filetype{
+            .name = config.filetype_name.c_str(),
+            .description = nullptr,
+            .file_extension = config.file_extension.c_str(),
+        };
+        if (!indexer_->declare_filetype(indexer_, &filetype)) return false;
+
+        location_paths_.reserve(config.locations.size());
+        for (const PresetLocation& location : config.locations) {
+            const std::string& path = location_paths_.emplace_back(pathToUtf8(location.path));
+            const clap_preset_discovery_location_t declared{
+                .flags = location.flags,
+                .name = location.name.c_str(),
+                .kind = CLAP_PRESET_DISCOVERY_LOCATION_FILE,
+                .location = path.c_str(),
+            };
+            if (!indexer_->declare_location(indexer_, &declared)) return false;
+        }
+        return true;
+    }
+
+    void saveIndex() {
+        const auto& index_file = factory_.config_.index_file;
+        if (!index_file.empty() && index_.isDirty()) index_.save(index_file);
+    }
+
+    bool getMetadata(const std::filesystem::path& location,
+                     const clap_preset_discovery_metadata_receiver_t* receiver) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(location, ec)) {
+            const PresetIndexStats stats = index_.refresh(location);
+            LOG_DBG("Preset scan of {}: {} cached, {} read, {} removed", pathToUtf8(location), stats.reused,
+                    stats.read, stats.removed);
+
+            const std::string prefix = PresetIndex::keyOfDirectory(location);
+            for (const PresetIndexEntry* entry : index_.entriesIn(location)) {
+                const std::string load_key = entry->path.substr(prefix.size());
+                if (!report(*entry, load_key.c_str(), receiver)) break;
+            }
+            return true;
+        }
+
+        const PresetIndexEntry* entry = index_.refreshFile(location);
+        if (!entry) {
+            receiver->on_error(receiver, 0, "Not a readable preset file");
+            return false;
+        }
+        report(*entry, nullptr, receiver);
+        return true;
+    }
+
+    bool report(const PresetIndexEntry& entry, const char* load_key,
+                const clap_preset_discovery_metadata_receiver_t* receiver) const {
+        const PresetMetadata& metadata = entry.metadata;
+        const std::string name =
+            metadata.name.empty() ? pathToUtf8(pathFromUtf8(entry.path).stem()) : metadata.name;
+        if (!receiver->begin_preset(receiver, name.c_str(), load_key)) return false;
+
+        const clap_universal_plugin_id_t plugin_id{.abi = "clap", .id = factory_.config_.plugin_id.c_str()};
+        receiver->add_plugin_id(receiver, &plugin_id);
+        receiver->set_flags(receiver, flagsOf(entry));
+        if (!metadata.creator.empty()) receiver->add_creator(receiver, metadata.creator.c_str());
+        if (!metadata.description.empty()) receiver->set_description(receiver, metadata.description.c_str());
+        receiver->set_timestamps(receiver, CLAP_TIMESTAMP_UNKNOWN, toClapTimestamp(entry.modified));
+        for (const std::string& tag : metadata.tags) receiver->add_feature(receiver, tag.c_str());
+        return true;
+    }
+
+    // Flags of the configured location the preset lives in
+    uint32_t flagsOf(const PresetIndexEntry& entry) const {
+        for (const PresetLocation& location : factory_.config_.locations) {
+            if (entry.path.starts_with(PresetIndex::keyOfDirectory(location.path))) return location.flags;
+        }
+        return CLAP_PRESET_DISCOVERY_IS_USER_CONTENT;
+    }
+
+    clap_preset_discovery_provider_t clap_{};
+    const PresetDiscoveryFactory& factory_;
+    const clap_preset_discovery_indexer_t* indexer_;
+    PresetIndex index_;
+    std::vector<std::string> location_paths_;
+};
+
+PresetDiscoveryFactory::PresetDiscoveryFactory(PresetDiscoveryConfig config) : config_(std::move(config)) {
+    descriptor_.clap_version = CLAP_VERSION;
+    descriptor_.id = config_.provider_id.c_str();
+    descriptor_.name = config_.name.c_str();
+    descriptor_.vendor = config_.vendor.c_str();
+
+    factory_.clap.count = clap_count;
+    factory_.clap.get_descriptor = clap_get_descriptor;
+    factory_.clap.create = clap_create;
+    factory_.self = this;
+}
+
+uint32_t PresetDiscoveryFactory::clap_count(const clap_preset_discovery_factory_t*) noexcept { return 1; }
+
+const clap_preset_discovery_provider_descriptor_t* PresetDiscoveryFactory::clap_get_descriptor(
+    const clap_preset_discovery_factory_t* factory, uint32_t index) noexcept {
+    const auto* self = reinterpret_cast<const ClapFactory*>(factory)->self;
+    return index == 0 ? &self->descriptor_ : nullptr;
+}
+
+const clap_preset_discovery_provider_t* PresetDiscoveryFactory::clap_create(
+    const clap_preset_discovery_factory_t* factory, const clap_preset_discovery_indexer_t* indexer,
+    const char* provider_id) noexcept {
+    const auto* self = reinterpret_cast<const ClapFactory*>(factory)->self;
+    if (!indexer || !provider_id || std::strcmp(provider_id, self->config_.provider_id.c_str()) != 0) {
+        return nullptr;
+    }
+    try {
+        return (new Provider(*self, indexer))->clapProvider();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+}  // namespace applause
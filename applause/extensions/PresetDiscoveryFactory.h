@@ -0,0 +1,99 @@
+#pragma once
+
+#include <clap/factory/preset-discovery.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <applause/util/PresetFile.h>
+
+namespace applause {
+
+/** A directory of preset files a PresetDiscoveryFactory declares to the host. */
+struct PresetLocation {
+    std::string name{};                                      /// Display name, e.g. "Factory Presets"
+    std::filesystem::path path{};                            /// Directory, searched recursively
+    uint32_t flags = CLAP_PRESET_DISCOVERY_IS_USER_CONTENT;  /// clap_preset_discovery_flags
+};
+
+/** Describes the presets a PresetDiscoveryFactory provides. */
+struct PresetDiscoveryConfig {
+    std::string provider_id{};  /// Unique provider id, e.g. "com.vendor.synth.presets"
+    std::string name{};         /// Display name of the provider
+    std::string vendor{};
+    std::string plugin_id{};    /// CLAP id of the plugin the presets belong to
+    std::string file_extension = kPresetFileExtension;
+    std::string filetype_name = "Preset";
+    std::vector<PresetLocation> locations{};
+
+    /**
+     * Where providers keep their PresetIndex between scans, e.g. in the user's cache directory. Without one every
+     * scan reads every preset header.
+     */
+    std::filesystem::path index_file{};
+};
+
+/**
+ * @brief Implements CLAP's preset discovery factory for preset files written by PresetLoadExtension.
+ *
+ * Hosts use it to index presets without instantiating the plugin. Each provider the host creates declares the
+ * configured locations and answers metadata queries from a PresetIndex stored in index_file, so only new and
+ * changed presets are opened on later scans. Queried for a directory, a provider reports every preset below it with
+ * its relative path as the load key, which PresetLoadExtension resolves.
+ *
+ * Return it from the plugin entry's get_factory():
+ *
+ * @code
+ * static const applause::PresetDiscoveryFactory preset_factory({
+ *     .provider_id = "com.vendor.synth.presets",
+ *     .name = "Synth Presets",
+ *     .vendor = "Vendor",
+ *     .plugin_id = "com.vendor.synth",
+ *     .locations = {{.name = "User Presets", .path = userPresetDirectory()}},
+ *     .index_file = userCacheDirectory() / "preset-index.cbor",
+ * });
+ *
+ * static const void* clap_get_factory(const char* factory_id) {
+ *     if (std::strcmp(factory_id, CLAP_PLUGIN_FACTORY_ID) == 0) return &plugin_factory;
+ *     if (std::strcmp(factory_id, CLAP_PRESET_DISCOVERY_FACTORY_ID) == 0 ||
+ *         std::strcmp(factory_id, CLAP_PRESET_DISCOVERY_FACTORY_ID_COMPAT) == 0)
+ *         return preset_factory.clapFactory();
+ *     return nullptr;
+ * }
+ * @endcode
+ */
+class PresetDiscoveryFactory {
+public:
+    explicit PresetDiscoveryFactory(PresetDiscoveryConfig config);
+
+    PresetDiscoveryFactory(const PresetDiscoveryFactory&) = delete;
+    PresetDiscoveryFactory& operator=(const PresetDiscoveryFactory&) = delete;
+
+    [[nodiscard]] const clap_preset_discovery_factory_t* clapFactory() const noexcept { return &factory_.clap; }
+
+    [[nodiscard]] const PresetDiscoveryConfig& getConfig() const noexcept { return config_; }
+
+private:
+    class Provider;
+
+    // The clap struct comes first, so callbacks can get back to the factory from its address
+    struct ClapFactory {
+        clap_preset_discovery_factory_t clap;
+        const PresetDiscoveryFactory* self;
+    };
+
+    static uint32_t clap_count(const clap_preset_discovery_factory_t* factory) noexcept;
+    static const clap_preset_discovery_provider_descriptor_t* clap_get_descriptor(
+        const clap_preset_discovery_factory_t* factory, uint32_t index) noexcept;
+    static const clap_preset_discovery_provider_t* clap_create(const clap_preset_discovery_factory_t* factory,
+                                                               const clap_preset_discovery_indexer_t* indexer,
+                                                               const char* provider_id) noexcept;
+
+    PresetDiscoveryConfig config_;
+    clap_preset_discovery_provider_descriptor_t descriptor_{};
+    ClapFactory factory_{};
+};
+
+}  // namespace applause
@@ -0,0 +1,99 @@
+#include "PresetLoadExtension.h"
+
+#include <applause/core/PluginBase.h>
+#include <applause/util/DebugHelpers.h>
+
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace applause {
+PresetLoadExtension::PresetLoadExtension(StateExtension& state) : state_(state) {}
+
+void PresetLoadExtension::onHostReady() noexcept {
+    host_preset_load_ = nullptr;
+    if (host_) {
+        host_preset_load_ =
+            static_cast<const clap_host_preset_load_t*>(host_->get_extension(host_, CLAP_EXT_PRESET_LOAD));
+    }
+}
+
+bool PresetLoadExtension::savePreset(const std::filesystem::path& file, const PresetMetadata& metadata) const {
+    std::error_code ec;
+    if (file.has_parent_path()) std::filesystem::create_directories(file.parent_path(), ec);
+
+    // Written next to the preset and renamed over it, so a failed save never leaves half a preset behind
+    std::filesystem::path temp_file = file;
+    temp_file += ".tmp";
+    try {
+        std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        writePresetHeader(out, metadata);
+        const bool saved = state_.saveToStream(out, StateFormat::Binary);
+        out.flush();
+        if (!saved || !out) {
+            out.close();
+            std::filesystem::remove(temp_file, ec);
+            return false;
+        }
+    } catch (const std::exception& e) {
+        LOG_WARN("Couldn't save preset {}: {}", pathToUtf8(file), e.what());
+        std::filesystem::remove(temp_file, ec);
+        return false;
+    }
+
+    std::filesystem::rename(temp_file, file, ec);
+    if (ec) {
+        LOG_WARN("Couldn't save preset {}: {}", pathToUtf8(file), ec.message());
+        std::filesystem::remove(temp_file, ec);
+        return false;
+    }
+    return true;
+}
+
+bool PresetLoadExtension::loadPreset(const std::filesystem::path& file, PresetMetadata* metadata) const {
+    try {
+        std::ifstream in(file, std::ios::binary);
+        if (!in) return false;
+
+        PresetMetadata header;
+        if (!readPresetHeader(in, header) || !state_.loadFromStream(in)) return false;
+
+        if (loaded_callback_) loaded_callback_(header);
+        if (metadata) *metadata = std::move(header);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_WARN("Couldn't load preset {}: {}", pathToUtf8(file), e.what());
+        return false;
+    }
+}
+
+bool PresetLoadExtension::clap_from_location(const clap_plugin_t* plugin, uint32_t location_kind,
+                                             const char* location, const char* load_key) noexcept {
+    auto* ext = PluginBase::findExtension<PresetLoadExtension>(plugin);
+    if (!ext) return false;
+
+    auto onError = [&](const char* message) {
+        if (ext->host_preset_load_ && ext->host_preset_load_->on_error) {
+            ext->host_preset_load_->on_error(ext->host_, location_kind, location, load_key, 0, message);
+        }
+        return false;
+    };
+
+    // Presets are files; the plugin has no built-in ones
+    if (location_kind != CLAP_PRESET_DISCOVERY_LOCATION_FILE || !location) {
+        return onError("Unsupported preset location");
+    }
+
+    // PresetDiscoveryFactory reports the presets of a directory location by their path relative to it
+    std::filesystem::path file = pathFromUtf8(location);
+    if (load_key && *load_key) file /= pathFromUtf8(load_key);
+
+    if (!ext->loadPreset(file)) return onError("Couldn't load preset");
+
+    if (ext->host_preset_load_ && ext->host_preset_load_->loaded) {
+        ext->host_preset_load_->loaded(ext->host_, location_kind, location, load_key);
+    }
+    return true;
+}
+}  // namespace applause
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <clap/ext/preset-load.h>
+
+#include <filesystem>
+#include <functional>
+
+#include <applause/core/Extension.h>
+#include <applause/extensions/StateExtension.h>
+#include <applause/util/PresetFile.h>
+
+namespace applause {
+
+/**
+ * @brief Loads presets the host picked in its browser, and saves the plugin's state as preset files.
+ *
+ * A preset file is a small metadata header (see writePresetHeader()) followed by the plugin state, always in
+ * StateFormat::Binary and written and read through the StateExtension's callbacks. Loading a preset is therefore
+ * exactly a state load, with the same cost and threading rules; the header is skipped without being parsed.
+ *
+ * Pair it with a PresetDiscoveryFactory exported from the plugin entry, so hosts can index the presets without
+ * instantiating the plugin.
+ *
+ * @code
+ * state_.setLoadCallback(...);
+ * presets_.setLoadedCallback([this](const PresetMetadata& preset) { preset_name_ = preset.name; });
+ * registerExtension(state_);
+ * registerExtension(presets_);
+ *
+ * presets_.savePreset(user_presets / "Warm Pad.aplp", {.name = "Warm Pad", .tags = {"pad"}});
+ * @endcode
+ */
+class PresetLoadExtension : public IExtension {
+public:
+    static constexpr const char* ID = CLAP_EXT_PRESET_LOAD;
+
+    using LoadedCallback = std::function<void(const PresetMetadata& metadata)>;
+
+    explicit PresetLoadExtension(StateExtension& state);
+
+    const char* id() const override { return ID; }
+
+    const void* getClapExtensionStruct() const override { return &clap_struct_; }
+
+    void onHostReady() noexcept override;
+
+    /**
+     * @brief Sets a handler called on the main thread after a preset loaded, e.g. to show its name.
+     */
+    void setLoadedCallback(LoadedCallback callback) { loaded_callback_ = std::move(callback); }
+
+    /**
+     * @brief Writes the current plugin state to a preset file, replacing it atomically if it exists.
+     * @return false if the state couldn't be saved or the file couldn't be written.
+     */
+    bool savePreset(const std::filesystem::path& file, const PresetMetadata& metadata) const;
+
+    /**
+     * @brief Loads a preset file into the plugin through the StateExtension's load callback.
+     * @param metadata If not null, receives the preset's metadata.
+     * @return false if the file isn't a readable preset or the load callback failed.
+     */
+    bool loadPreset(const std::filesystem::path& file, PresetMetadata* metadata = nullptr) const;
+
+private:
+    static bool clap_from_location(const clap_plugin_t* plugin, uint32_t location_kind, const char* location,
+                                   const char* load_key) noexcept;
+
+    static constexpr clap_plugin_preset_load_t clap_struct_ = {.from_location = clap_from_location};
+
+    StateExtension& state_;
+    LoadedCallback loaded_callback_;
+    const clap_host_preset_load_t* host_preset_load_ = nullptr;
+};
+
+}  // namespace applause
@@ -0,0 +1,25 @@
+#include "RenderExtension.h"
+
+#include <applause/core/PluginBase.h>
+
+namespace applause {
+bool RenderExtension::clap_has_hard_realtime_requirement(const clap_plugin_t* plugin) noexcept {
+    auto* ext = PluginBase::findExtension<RenderExtension>(plugin);
+    return ext && ext->isHardRealtime();
+}
+
+bool RenderExtension::clap_set(const clap_plugin_t* plugin, clap_plugin_render_mode mode) noexcept {
+    auto* ext = PluginBase::findExtension<RenderExtension>(plugin);
+    if (!ext) return false;
+    if (mode == CLAP_RENDER_OFFLINE) {
+        if (ext->hard_realtime_) return false;
+        ext->offline_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    if (mode == CLAP_RENDER_REALTIME) {
+        ext->offline_.store(false, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+}  // namespace applause
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <applause/core/Extension.h>
+#include <applause/core/QualityTier.h>
+#include <clap/ext/render.h>
+
+#include <atomic>
+
+namespace applause {
+
+/**
+ * @brief Lets the host switch the plugin between real-time and offline rendering.
+ *
+ * While the host renders offline, every process() call runs at QualityTier::Offline (see currentQualityTier()),
+ * since blocks no longer have to finish in time. Plugins that must always run in real time, e.g. because they
+ * talk to external hardware, call setHardRealtime(true), and the host then never renders them offline.
+ */
+class RenderExtension : public IExtension {
+public:
+    static constexpr const char* ID = CLAP_EXT_RENDER;
+
+    RenderExtension() = default;
+
+    const char* id() const override { return ID; }
+
+    const void* getClapExtensionStruct() const override { return &clap_struct_; }
+
+    /** @brief Main thread: declares whether the plugin may only be rendered in real time. */
+    void setHardRealtime(bool hard_realtime) noexcept { hard_realtime_ = hard_realtime; }
+
+    [[nodiscard]] bool isHardRealtime() const noexcept { return hard_realtime_; }
+
+    /** @brief Whether the host is currently rendering offline. Safe from any thread. */
+    [[nodiscard]] bool isOffline() const noexcept { return offline_.load(std::memory_order_relaxed); }
+
+    /** @brief The tier process() runs at under the current render mode. */
+    [[nodiscard]] QualityTier getQualityTier() const noexcept {
+        return isOffline() ? QualityTier::Offline : QualityTier::Realtime;
+    }
+
+private:
+    static bool clap_has_hard_realtime_requirement(const clap_plugin_t* plugin) noexcept;
+    static bool clap_set(const clap_plugin_t* plugin, clap_plugin_render_mode mode) noexcept;
+
+    static constexpr clap_plugin_render_t clap_struct_ = {
+        .has_hard_realtime_requirement = clap_has_hard_realtime_requirement,
+        .set = clap_set,
+    };
+
+    bool hard_realtime_ = false;
+    std::atomic<bool> offline_{false};  // Set on the main thread, read by process()
+};
+}  // namespace applause
@@ -1,8 +1,13 @@
 #include "StateExtension.h"
 
 #include <applause/core/PluginBase.h>
+#include <applause/util/ClapStreamBuf.h>
 #include <applause/util/DebugHelpers.h>
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+
 namespace applause {
 StateExtension::StateExtension() {
     clap_struct_ = {};
@@ -10,30 +15,76 @@ StateExtension::StateExtension() {
     clap_struct_.load = clap_state_load;
 }
 
-bool StateExtension::clap_state_save(const clap_plugin_t* plugin, const clap_ostream_t* stream) noexcept {
-    auto* ext = PluginBase::findExtension<StateExtension>(plugin);
-    if (!ext || !ext->save_callback_) return false;
+bool StateExtension::saveToStream(std::ostream& out, StateFormat format) const {
+    if (stream_save_callback_) return stream_save_callback_(out);
+    if (!save_callback_) return false;
 
-    try {
-        applause::json state;
+    applause::json state;
 
-        // Let plugin populate the state
-        if (!ext->save_callback_(state)) {
-            return false;
+    // Let plugin populate the state
+    if (!save_callback_(state)) {
+        return false;
+    }
+
+    // Serialized straight into the stream, one chunk at a time
+    if (format == StateFormat::Binary) {
+        out.write(kBinaryStateMagic, sizeof(kBinaryStateMagic));
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.put(static_cast<char>((kBinaryStateVersion >> shift) & 0xff));
         }
-        std::string json_str = state.dump();
+        applause::json::to_cbor(state, out);
+    } else {
+        out << state;
+    }
+    return true;
+}
 
-        const char* ptr = json_str.data();
-        size_t remaining = json_str.size();
+bool StateExtension::loadFromStream(std::istream& in) const {
+    if (stream_load_callback_) return stream_load_callback_(in);
+    if (!load_callback_) return false;
 
-        while (remaining > 0) {
-            int64_t written = stream->write(stream, ptr, remaining);
-            if (written <= 0) return false;
-            ptr += written;
-            remaining -= written;
+    applause::json state;
+    if (!parseState(in, state)) return false;
+    return load_callback_(state);
+}
+
+bool StateExtension::parseState(std::istream& in, applause::json& state) {
+    // Parsed straight from the stream, one chunk at a time. Binary states are told apart by their magic
+    if (in.peek() == kBinaryStateMagic[0]) {
+        std::array<char, sizeof(kBinaryStateMagic) + 4> header{};
+        if (!in.read(header.data(), header.size()) ||
+            !std::equal(std::begin(kBinaryStateMagic), std::end(kBinaryStateMagic), header.begin())) {
+            LOG_WARN("State has an invalid binary header");
+            return false;
         }
+        uint32_t version = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            const auto byte = static_cast<uint8_t>(header[sizeof(kBinaryStateMagic) + i]);
+            version |= static_cast<uint32_t>(byte) << (8 * i);
+        }
+        if (version > kBinaryStateVersion) {
+            LOG_WARN("State was saved in binary format version {}, which is newer than this build's {}", version,
+                     kBinaryStateVersion);
+            return false;
+        }
+        state = applause::json::from_cbor(in);
+    } else {
+        state = applause::json::parse(in);
+    }
+    return true;
+}
 
-        return true;
+bool StateExtension::clap_state_save(const clap_plugin_t* plugin, const clap_ostream_t* stream) noexcept {
+    auto* ext = PluginBase::findExtension<StateExtension>(plugin);
+    if (!ext || !(ext->save_callback_ || ext->stream_save_callback_)) return false;
+
+    try {
+        ClapOutStreamBuf buffer(stream);
+        std::ostream out(&buffer);
+        if (!ext->saveToStream(out, ext->format_)) return false;
+
+        out.flush();
+        return !out.fail();
     } catch (...) {
         return false;
     }
@@ -41,25 +92,22 @@ bool StateExtension::clap_state_save(const clap_plugin_t* plugin, const clap_ost
 
 bool StateExtension::clap_state_load(const clap_plugin_t* plugin, const clap_istream_t* stream) noexcept {
     auto* ext = PluginBase::findExtension<StateExtension>(plugin);
-    if (!ext || !ext->load_callback_) return false;
+    if (!ext || !(ext->load_callback_ || ext->stream_load_callback_)) return false;
 
     try {
-        std::vector<char> buffer;
-        constexpr size_t CHUNK_SIZE = 4096;
-        char chunk[CHUNK_SIZE];
-
-        while (true) {
-            int64_t bytes_read = stream->read(stream, chunk, CHUNK_SIZE);
-            if (bytes_read < 0) return false;
-            if (bytes_read == 0) break;
-            buffer.insert(buffer.end(), chunk, chunk + bytes_read);
-        }
+        ClapInStreamBuf buffer(stream);
+        std::istream in(&buffer);
 
-        auto state = applause::json::parse(buffer.begin(), buffer.end());
+        if (ext->stream_load_callback_) {
+            const bool loaded = ext->stream_load_callback_(in);
+            return loaded && !buffer.hasError();
+        }
 
+        applause::json state;
+        if (!parseState(in, state) || buffer.hasError()) return false;
         return ext->load_callback_(state);
     } catch (...) {
         return false;
     }
 }
-}  // namespace applause
\ No newline at end of file
+}  // namespace applause
@@ -0,0 +1,32 @@
+#include "TailExtension.h"
+
+#include <applause/core/PluginBase.h>
+
+#include <algorithm>
+
+namespace applause {
+void TailExtension::onHostReady() noexcept {
+    host_tail_ = nullptr;
+    if (host_) {
+        host_tail_ = static_cast<const clap_host_tail_t*>(host_->get_extension(host_, CLAP_EXT_TAIL));
+    }
+}
+
+void TailExtension::setTail(uint32_t samples) noexcept {
+    samples = std::min(samples, kInfiniteTail);
+    if (tail_.exchange(samples, std::memory_order_relaxed) == samples) return;
+    changed_.store(true, std::memory_order_release);
+}
+
+void TailExtension::notifyHost() noexcept {
+    if (!changed_.load(std::memory_order_relaxed) || !changed_.exchange(false, std::memory_order_acquire)) return;
+    if (host_tail_ && host_tail_->changed) {
+        host_tail_->changed(host_);
+    }
+}
+
+uint32_t TailExtension::clap_get(const clap_plugin_t* plugin) noexcept {
+    auto* ext = PluginBase::findExtension<TailExtension>(plugin);
+    return ext ? ext->getTail() : 0;
+}
+}  // namespace applause
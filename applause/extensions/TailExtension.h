@@ -0,0 +1,59 @@
+#pragma once
+
+#include <applause/core/Extension.h>
+#include <clap/ext/tail.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace applause {
+
+/**
+ * @brief Reports how long the plugin keeps producing output after its input goes silent, so the host can stop
+ * processing it once a reverb or delay has rung out instead of running it forever.
+ *
+ * Unlike latency, the tail may change at any time, including from process(). CLAP only takes the change notice on
+ * the audio thread, so setTail() stores the value and PluginBase tells the host at the end of the next process().
+ * Report kInfiniteTail for plugins that never go quiet on their own, e.g. a self-oscillating filter.
+ */
+class TailExtension : public IExtension {
+public:
+    static constexpr const char* ID = CLAP_EXT_TAIL;
+
+    /** CLAP treats any tail of INT32_MAX samples or more as infinite. */
+    static constexpr uint32_t kInfiniteTail = INT32_MAX;
+
+    TailExtension() = default;
+
+    void onHostReady() noexcept override;
+
+    const char* id() const override { return ID; }
+
+    const void* getClapExtensionStruct() const override { return &clap_struct_; }
+
+    /**
+     * @brief Sets the tail reported to the host; if it changed, the host hears of it after the next process().
+     * @param samples Output samples that follow the last non-silent input, at the activated sample rate.
+     * @note Any thread
+     */
+    void setTail(uint32_t samples) noexcept;
+
+    /**
+     * @brief Calls host_tail.changed() if the tail changed since the last call. PluginBase runs this after every
+     * process() block.
+     * @note Audio thread only
+     */
+    void notifyHost() noexcept;
+
+    [[nodiscard]] uint32_t getTail() const noexcept { return tail_.load(std::memory_order_relaxed); }
+
+private:
+    static uint32_t clap_get(const clap_plugin_t* plugin) noexcept;
+
+    static constexpr clap_plugin_tail_t clap_struct_ = {.get = clap_get};
+
+    const clap_host_tail_t* host_tail_ = nullptr;
+    std::atomic<uint32_t> tail_{0};  // Set from the audio or main thread, read by the host on either
+    std::atomic<bool> changed_{false};  // The host hasn't been told about tail_ yet
+};
+}  // namespace applause
@@ -10,11 +10,23 @@ void ThreadPoolExtension::onHostReady() noexcept {
     }
 }
 
+void ThreadPoolExtension::enableFallbackPool(size_t num_workers) {
+    fallback_pool_.reset();
+    auto pool = std::make_unique<WorkerPool>(num_workers > 0 ? num_workers : WorkerPool::defaultNumWorkers());
+    if (pool->numWorkers() > 0) {
+        fallback_pool_ = std::move(pool);
+    }
+}
+
 bool ThreadPoolExtension::requestExec(uint32_t num_tasks) const noexcept {
-    if (!hasHostSupport()) {
-        return false;
+    if (hasHostSupport()) {
+        return host_pool_->request_exec(host_, num_tasks);
+    }
+    if (fallback_pool_) {
+        fallback_pool_->parallelFor(num_tasks, [this](uint32_t task) { exec(task); });
+        return true;
     }
-    return host_pool_->request_exec(host_, num_tasks);
+    return false;
 }
 
 void ThreadPoolExtension::clap_exec(const clap_plugin_t* plugin, uint32_t task_index) noexcept {
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <applause/core/Extension.h>
+#include <applause/util/WorkerPool.h>
 #include <clap/ext/thread-pool.h>
 
 #include <functional>
+#include <memory>
 
 namespace applause {
 
@@ -12,6 +14,8 @@ namespace applause {
  *
  * ThreadPoolExtension exposes the host-provided `clap_host_thread_pool_t`
  * interface and allows plugins to run work on the host's background threads.
+ * After enableFallbackPool(), requestExec() runs the tasks on a framework-owned
+ * WorkerPool whenever the host has no thread pool of its own.
  */
 class ThreadPoolExtension : public IExtension {
 public:
@@ -27,6 +31,25 @@ public:
      */
     bool hasHostSupport() const noexcept { return host_pool_ && host_pool_->request_exec; }
 
+    /**
+     * @brief Checks whether requestExec() can run tasks in parallel, on the host's pool or the fallback pool.
+     */
+    bool hasParallelSupport() const noexcept { return hasHostSupport() || fallback_pool_ != nullptr; }
+
+    /**
+     * @brief Starts a WorkerPool that requestExec() uses when the host has no thread pool.
+     *
+     * Main thread only, outside activation. num_workers = 0 picks WorkerPool::defaultNumWorkers(); a pool that
+     * ends up with no workers isn't kept, since it couldn't run anything in parallel.
+     */
+    void enableFallbackPool(size_t num_workers = 0);
+
+    /** @brief Stops the fallback pool's workers. Main thread only, outside activation. */
+    void disableFallbackPool() noexcept { fallback_pool_.reset(); }
+
+    /** @brief The fallback pool, or nullptr; plugins can also submit their own fork/join work to it. */
+    [[nodiscard]] WorkerPool* getFallbackPool() const noexcept { return fallback_pool_.get(); }
+
     const char* id() const override { return ID; }
 
     const void* getClapExtensionStruct() const override { return &clap_struct_; }
@@ -37,6 +60,15 @@ public:
      */
     void setCallback(std::function<void(uint32_t)> callback) { callback_ = std::move(callback); }
 
+    /**
+     * @brief Installs a callback and returns the previous one, so a caller can borrow the pool and restore it.
+     * Moves only; safe on the audio thread as long as neither callback is copied.
+     */
+    std::function<void(uint32_t)> exchangeCallback(std::function<void(uint32_t)> callback) noexcept {
+        std::swap(callback_, callback);
+        return callback;
+    }
+
     /**
      * @brief Executes the registered callback for the given task.
      * @param task_index Task identifier provided by the host scheduler.
@@ -56,5 +88,6 @@ private:
 
     const clap_host_thread_pool_t* host_pool_ = nullptr;
     std::function<void(uint32_t)> callback_;
+    std::unique_ptr<WorkerPool> fallback_pool_;
 };
 }  // namespace applause
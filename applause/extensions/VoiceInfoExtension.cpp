@@ -0,0 +1,38 @@
+#include "VoiceInfoExtension.h"
+
+#include <applause/core/PluginBase.h>
+
+#include <algorithm>
+
+namespace applause {
+void VoiceInfoExtension::onHostReady() noexcept {
+    host_voice_info_ = nullptr;
+    if (host_) {
+        host_voice_info_ =
+            static_cast<const clap_host_voice_info_t*>(host_->get_extension(host_, CLAP_EXT_VOICE_INFO));
+    }
+}
+
+void VoiceInfoExtension::setVoiceCount(uint32_t voice_count, uint32_t voice_capacity, bool overlapping_notes) noexcept {
+    const clap_voice_info_t info{
+        .voice_count = voice_count,
+        .voice_capacity = std::max(voice_capacity, voice_count),
+        .flags = overlapping_notes ? uint64_t{CLAP_VOICE_INFO_SUPPORTS_OVERLAPPING_NOTES} : uint64_t{0},
+    };
+    if (info.voice_count == info_.voice_count && info.voice_capacity == info_.voice_capacity &&
+        info.flags == info_.flags) {
+        return;
+    }
+    info_ = info;
+    if (host_voice_info_ && host_voice_info_->changed) {
+        host_voice_info_->changed(host_);
+    }
+}
+
+bool VoiceInfoExtension::clap_get(const clap_plugin_t* plugin, clap_voice_info_t* info) noexcept {
+    auto* ext = PluginBase::findExtension<VoiceInfoExtension>(plugin);
+    if (!ext || !info) return false;
+    *info = ext->getVoiceInfo();
+    return true;
+}
+}  // namespace applause
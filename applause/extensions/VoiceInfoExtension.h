@@ -0,0 +1,49 @@
+#pragma once
+
+#include <applause/core/Extension.h>
+#include <clap/ext/voice-info.h>
+
+#include <cstdint>
+
+namespace applause {
+
+/**
+ * @brief Tells hosts that support polyphonic modulation how many voices the plugin has, so they can size their
+ * per-voice routing.
+ *
+ * Set it from the Synthesizer that renders the voices, e.g. setVoiceCount(synth_.getNumVoices()). Pair it with
+ * passing the block's output events to Synthesizer::process(), which reports every note that stops sounding as a
+ * CLAP_EVENT_NOTE_END, so the host stops sending modulation to dead voices.
+ */
+class VoiceInfoExtension : public IExtension {
+public:
+    static constexpr const char* ID = CLAP_EXT_VOICE_INFO;
+
+    VoiceInfoExtension() = default;
+
+    void onHostReady() noexcept override;
+
+    const char* id() const override { return ID; }
+
+    const void* getClapExtensionStruct() const override { return &clap_struct_; }
+
+    /**
+     * @brief Main thread: sets the voice count reported to the host and tells the host if it changed.
+     * @param voice_count Voices currently available, e.g. a user-set polyphony.
+     * @param voice_capacity The most voices the plugin can ever have; 0 means the same as voice_count.
+     * @param overlapping_notes Whether a key that is already sounding can start another voice, as every note-on
+     * does in Synthesizer.
+     */
+    void setVoiceCount(uint32_t voice_count, uint32_t voice_capacity = 0, bool overlapping_notes = true) noexcept;
+
+    [[nodiscard]] const clap_voice_info_t& getVoiceInfo() const noexcept { return info_; }
+
+private:
+    static bool clap_get(const clap_plugin_t* plugin, clap_voice_info_t* info) noexcept;
+
+    static constexpr clap_plugin_voice_info_t clap_struct_ = {.get = clap_get};
+
+    const clap_host_voice_info_t* host_voice_info_ = nullptr;
+    clap_voice_info_t info_{.voice_count = 1, .voice_capacity = 1, .flags = CLAP_VOICE_INFO_SUPPORTS_OVERLAPPING_NOTES};
+};
+}  // namespace applause
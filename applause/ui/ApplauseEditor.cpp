@@ -2,8 +2,10 @@
 
 #include <applause/ui/ApplauseUI.h>
 
+#include <applause/ui/FontCache.h>
 #include <applause/ui/Tooltip.h>
 #include <applause/util/DebugHelpers.h>
+#include <applause/util/inspector/DrawProfiler.h>
 
 #ifndef NDEBUG
 #include <applause/util/inspector/InspectorWindow.h>
@@ -17,10 +19,12 @@ ApplauseEditor::ApplauseEditor(ParamsExtension* params) : params_(params) {
     palette_.initWithDefaults();
     setPalette(&palette_);
 
-    // If params provided, connect our message queue and start the timer
+    // If params provided, connect our message queue and let host changes wake
+    // the frame pump
     if (params_) {
         params_->setMessageQueue(&message_queue_);
-        startTimer(30);
+        params_->setUiWakeCallback([this] { wake(); });
+        wake();
     } else {
         LOG_WARN(
             "ApplauseEditor instantiated without ParamsExtension! Parameter "
@@ -58,6 +62,7 @@ ApplauseEditor::ApplauseEditor(ParamsExtension* params) : params_(params) {
 
 ApplauseEditor::~ApplauseEditor() {
     if (params_) {
+        params_->setUiWakeCallback(nullptr);
         params_->setMessageQueue(nullptr);
     }
 }
@@ -68,6 +73,9 @@ ParamsExtension* ApplauseEditor::getParamsExtension() { return params_; }
 
 void ApplauseEditor::show(void* parent_window) {
     applause::ApplicationWindow::show(parent_window);
+    // The window knows its display scale now; load the glyphs of every font the components asked for before the
+    // first draw needs them. Editors opened later in the process find them already loaded.
+    FontCache::warmUp(dpiScale());
 }
 
 void ApplauseEditor::close() { applause::ApplicationWindow::close(); }
@@ -98,8 +106,30 @@ float ApplauseEditor::getAspectRatio() const {
 }
 
 void ApplauseEditor::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
     canvas.setColor(0xff111115);
     canvas.fill(0, 0, width(), height());
+
+    if (!awake_) return;
+    if (pumpUpdates()) {
+        idle_frames_ = 0;
+    } else {
+        ++idle_frames_;
+    }
+    // Sleep once nothing has changed for a while, unless a host change is
+    // already waiting (armUiWake() fails then)
+    if (idle_frames_ >= kIdleFrames && (!params_ || params_->armUiWake())) {
+        awake_ = false;
+        return;
+    }
+    redraw();  // Come back next frame
+}
+
+void ApplauseEditor::wake() {
+    idle_frames_ = 0;
+    if (awake_) return;
+    awake_ = true;
+    redraw();
 }
 
 void* ApplauseEditor::getNativeHandle() {
@@ -123,18 +153,24 @@ void ApplauseEditor::processPosixFdEvents() {
 }
 #endif
 
-void ApplauseEditor::timerCallback() {
-    // Only process messages if we have params
-    if (!params_) return;
-
-    ParamMessageQueue::Message msg{};
-    while (message_queue_.toUi().try_dequeue(msg)) {
-        if (msg.type == ParamMessageQueue::MessageType::PARAM_VALUE) {
-            auto& param = params_->getInfo(msg.paramId);
-            param.on_value_changed(msg.value);
-        } else {
-            ASSERT_FALSE("ApplauseEditor received unexpected message type");
+bool ApplauseEditor::pumpUpdates() {
+    bool changed = false;
+    if (params_) {
+        // Host automation arrives coalesced: one update per changed parameter, with its latest value
+        changed = params_->dispatchHostChanges() > 0;
+
+        ParamMessageQueue::Message msg{};
+        while (message_queue_.toUi().try_dequeue(msg)) {
+            if (msg.type == ParamMessageQueue::MessageType::PARAM_VALUE) {
+                auto& param = params_->getInfo(msg.paramId);
+                param.on_value_changed(msg.value);
+                changed = true;
+            } else {
+                ASSERT_FALSE("ApplauseEditor received unexpected message type");
+            }
         }
     }
+    on_frame_update();
+    return changed;
 }
 }  // namespace applause
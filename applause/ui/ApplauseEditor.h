@@ -7,6 +7,7 @@
 #include <applause/ui/IEditor.h>
 #include <applause/extensions/ParamsExtension.h>
 #include <applause/util/ParamMessageQueue.h>
+#include <applause/util/thirdparty/rocket.hpp>
 
 namespace applause {
 class TooltipDisplay;
@@ -24,10 +25,18 @@ namespace inspector { class InspectorWindow; }
  *
  * For custom GUI frameworks, implement IEditor directly instead of using this
  * class.
+ *
+ * Parameter changes reach the UI from the editor's own draw(), once per
+ * display frame: while anything changes, the editor asks for the next frame
+ * with redraw() and delivers updates from there, so they land in step with
+ * the refresh instead of on a fixed timer. After kIdleFrames frames without
+ * a change it stops asking, and the next host parameter change (through
+ * ParamsExtension::armUiWake()) or a call to wake() starts it again, so an
+ * editor with nothing to show doesn't wake at all. Subclasses that override
+ * draw() must call ApplauseEditor::draw() to keep the updates coming.
  */
 class ApplauseEditor : public IEditor,
-                       public applause::ApplicationWindow,
-                       public applause::EventTimer {
+                       public applause::ApplicationWindow {
 public:
     /**
      * @brief Construct an ApplauseEditor with parameter extension support.
@@ -58,7 +67,32 @@ public:
     void processPosixFdEvents() override;
 #endif
 
-    void timerCallback() override;
+    /** Frames without a change after which the editor stops updating. */
+    static constexpr uint32_t kIdleFrames = 30;
+
+    /**
+     * @brief Deliver pending parameter changes and fire on_frame_update.
+     * draw() calls this every frame while the editor is awake.
+     * @return Whether any parameter changed
+     */
+    bool pumpUpdates();
+
+    /**
+     * @brief Resume per-frame updates if the editor went idle, and restart
+     * its idle count. Call this when something besides the parameters
+     * changes, e.g. from an on_frame_update listener that polled new data.
+     */
+    void wake();
+
+    /** @brief Whether the editor is updating every frame. */
+    bool isAwake() const { return awake_; }
+
+    /**
+     * Fires once per frame while the editor is awake, for components that
+     * poll the audio thread themselves (meters, modulation snapshots).
+     * Listeners that need more frames call wake() to keep them coming.
+     */
+    rocket::signal<void()> on_frame_update;
 
     TooltipDisplay& tooltipDisplay() { return *tooltip_display_; }
 
@@ -83,6 +117,8 @@ private:
     // tears those down before the palette they point at.
     applause::Palette palette_;
     std::unique_ptr<TooltipDisplay> tooltip_display_;
+    bool awake_ = false;
+    uint32_t idle_frames_ = 0;  // frames in a row in which pumpUpdates() found nothing
 #ifndef NDEBUG
     std::unique_ptr<inspector::InspectorWindow> inspector_window_;
 #endif
@@ -0,0 +1,71 @@
+#include "FontCache.h"
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace applause {
+
+namespace {
+
+// Size, file data and display scale; 0 is the unscaled font components hold
+using FontKey = std::tuple<float, const unsigned char*, float>;
+
+struct Fonts {
+    std::map<FontKey, std::unique_ptr<applause::Font>> fonts;
+    std::map<float, size_t> warmed;  // fonts (unscaled) already warmed at each display scale
+};
+
+Fonts& cache() {
+    // Deliberately leaked: the fonts must outlive every static editor or component, and destroying them during static
+    // destruction could run after Visage's own font cache is gone
+    static auto* fonts = new Fonts();
+    return *fonts;
+}
+
+const std::u32string& warmUpGlyphs() {
+    static const std::u32string glyphs = [] {
+        std::u32string s;
+        for (char32_t c = 0x20; c < 0x7f; ++c) s += c;
+        return s;
+    }();
+    return glyphs;
+}
+
+}  // namespace
+
+const applause::Font& FontCache::get(float size, const applause::EmbeddedFile& file) {
+    auto& fonts = cache().fonts;
+    auto& font = fonts[{size, file.data, 0.0f}];
+    if (!font) font = std::make_unique<applause::Font>(size, file);
+    return *font;
+}
+
+void FontCache::warmUp(float dpi_scale) {
+    if (dpi_scale <= 0.0f) return;
+    auto& c = cache();
+
+    // Collect first: warming inserts the scaled fonts into the same map
+    std::vector<applause::Font*> unscaled;
+    for (auto& [key, font] : c.fonts) {
+        if (std::get<2>(key) == 0.0f) unscaled.push_back(font.get());
+    }
+    size_t& warmed = c.warmed[dpi_scale];
+    if (warmed == unscaled.size()) return;
+
+    const auto& glyphs = warmUpGlyphs();
+    for (applause::Font* font : unscaled) {
+        auto& scaled = c.fonts[{font->size(), font->fontData(), dpi_scale}];
+        if (scaled) continue;
+        scaled = std::make_unique<applause::Font>(font->withDpiScale(dpi_scale));
+        // Measuring packs each glyph into the shared atlas, so the first draw finds them there
+        scaled->stringWidth(glyphs.c_str(), static_cast<int>(glyphs.size()));
+    }
+    warmed = unscaled.size();
+}
+
+}  // namespace applause
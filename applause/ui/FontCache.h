@@ -0,0 +1,36 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+namespace applause {
+
+/**
+ * Process-wide store for the fonts the framework's components draw with.
+ *
+ * Visage shares a font's packed glyph atlas between all Font objects of the same size and data, but only while one of
+ * them is alive: components that construct their Font in draw(), or an editor closing, drop the atlas, and the next
+ * draw rasterizes every glyph again. FontCache keeps one Font per size and file for the lifetime of the process, so
+ * every editor instance (including the next one opened on another track) reuses the same atlases.
+ *
+ * warmUp() additionally loads the printable ASCII glyphs of every font requested so far at a display scale, which
+ * ApplauseEditor does in show() before its first draw. Since components request their fonts in their constructors,
+ * that covers exactly the fonts the editor is about to draw.
+ *
+ * UI thread only.
+ *
+ * @code
+ * MyLabel::MyLabel() : text_("", FontCache::get(12, applause::fonts::Jost_Regular_ttf)) {}
+ * @endcode
+ */
+class FontCache {
+public:
+    FontCache() = delete;
+
+    /** The shared font of this size and file, created on first use. The reference stays valid for good. */
+    static const applause::Font& get(float size, const applause::EmbeddedFile& file);
+
+    /** Loads the printable ASCII glyphs of every cached font at dpi_scale. Cheap after the first call per scale. */
+    static void warmUp(float dpi_scale);
+};
+
+}  // namespace applause
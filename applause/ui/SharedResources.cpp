@@ -0,0 +1,13 @@
+#include "SharedResources.h"
+
+#include <applause/ui/ApplauseUI.h>
+
+namespace applause {
+
+std::shared_ptr<const applause::Svg> SharedResources::svg(const applause::EmbeddedFile& file) {
+    // Embedded files are unique by their data, not their names, which can repeat across resource groups
+    static SharedCache<const unsigned char*, applause::Svg> cache;
+    return cache.getOrCreate(file.data, [&] { return std::make_shared<applause::Svg>(file.data, file.size); });
+}
+
+}  // namespace applause
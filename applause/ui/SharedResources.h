@@ -0,0 +1,46 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/util/SharedCache.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace applause {
+
+/**
+ * Process-wide, reference-counted UI resources, so the editors of many plugin instances in one host process share
+ * one copy of each instead of loading their own.
+ *
+ * Fonts live in FontCache, which keeps them for the whole process. Everything here is freed with its last holder:
+ * parsed SVG icons through svg(), and any resource of a plugin's own (decoded images, wavetable previews, parsed
+ * layouts) through get(). Keep the returned shared_ptr for as long as the component draws with it.
+ *
+ * Visage compiles its shader programs once per process already, so there's nothing to share for those.
+ *
+ * UI thread or not, like SharedCache; resources must not be modified once created.
+ *
+ * @code
+ * MyEditor::MyEditor(...) : logo_(SharedResources::svg(resources::logo_svg)), logo_button_(*logo_) {}
+ *
+ * preview_ = SharedResources::get<WavetablePreview>(path, [&] { return WavetablePreview::render(path); });
+ * @endcode
+ */
+class SharedResources {
+public:
+    SharedResources() = delete;
+
+    /** The parsed SVG of an embedded file, shared by everyone drawing it. */
+    static std::shared_ptr<const applause::Svg> svg(const applause::EmbeddedFile& file);
+
+    /** The shared T for key, built by factory() (returning a shared_ptr to T) if no live one exists. */
+    template <typename T, typename Factory>
+    static std::shared_ptr<const T> get(const std::string& key, Factory&& factory) {
+        static SharedCache<std::string, T> cache;
+        return cache.getOrCreate(key, std::forward<Factory>(factory));
+    }
+};
+
+}  // namespace applause
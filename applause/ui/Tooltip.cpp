@@ -3,6 +3,8 @@
 #include <applause/ui/ApplauseUI.h>
 
 #include <applause/ui/ApplauseEditor.h>
+#include <applause/ui/FontCache.h>
+#include <applause/util/inspector/DrawProfiler.h>
 
 #include <embedded/applause_fonts.h>
 
@@ -24,7 +26,7 @@ std::unordered_map<applause::Frame*, TooltipBinding> tooltip_bindings;
 
 }  // namespace
 
-TooltipDisplay::TooltipDisplay() : text_("", applause::Font(kFontSize, applause::fonts::Jost_Regular_ttf)) {
+TooltipDisplay::TooltipDisplay() : text_("", FontCache::get(kFontSize, applause::fonts::Jost_Regular_ttf)) {
     setIgnoresMouseEvents(true, false);
     opacity_.setSourceValue(0.0f);
     opacity_.setTargetValue(1.0f);
@@ -102,6 +104,7 @@ void TooltipDisplay::timerCallback() {
 }
 
 void TooltipDisplay::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
     if (state_ == State::kIdle || state_ == State::kWaiting) return;
 
     const auto& bounds = tooltip_bounds_;
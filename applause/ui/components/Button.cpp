@@ -24,7 +24,9 @@
 #include <applause/ui/ApplauseUI.h>
 
 #include <applause/ui/ApplauseEditor.h>
+#include <applause/ui/FontCache.h>
 #include <applause/ui/NativePopupMenu.h>
+#include <applause/util/inspector/DrawProfiler.h>
 
 #include <embedded/applause_fonts.h>
 
@@ -72,6 +74,7 @@ APPLAUSE_THEME_IMPLEMENT_COLOR(ToggleTextButton, ApplauseToggleTextButtonBorderO
 APPLAUSE_THEME_IMPLEMENT_COLOR(ToggleTextButton, ApplauseToggleTextButtonBorderOnHover, 0xddaa77ff);
 
 void Button::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
     float hover = active_ ? hover_amount_.update() : 0.0f;
     draw(canvas, hover);
 
@@ -123,7 +126,7 @@ void Button::mouseUp(const applause::MouseEvent& e) {
     }
 }
 
-UiButton::UiButton(const std::string& text) : text_(text, applause::Font(12, applause::fonts::Jost_Regular_ttf)) {}
+UiButton::UiButton(const std::string& text) : text_(text, FontCache::get(12, applause::fonts::Jost_Regular_ttf)) {}
 
 UiButton::UiButton(const std::string& text, const applause::Font& font) : text_(text, font) {}
 
@@ -238,7 +241,7 @@ void ToggleIconButton::draw(applause::Canvas& canvas, float hover_amount) {
 }
 
 ToggleTextButton::ToggleTextButton(const std::string& name) :
-    ToggleButton(name), text_(name, applause::Font(12, applause::fonts::Jost_Regular_ttf)) {}
+    ToggleButton(name), text_(name, FontCache::get(12, applause::fonts::Jost_Regular_ttf)) {}
 
 ToggleTextButton::ToggleTextButton(const std::string& name, const applause::Font& font) :
     ToggleButton(name), text_(name, font) {}
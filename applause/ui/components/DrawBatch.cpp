@@ -0,0 +1,118 @@
+#include "DrawBatch.h"
+
+#include <algorithm>
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/inspector/DrawProfiler.h>
+
+namespace applause {
+
+BatchableFrame::~BatchableFrame() {
+    if (batch_) batch_->remove(*this);
+}
+
+void BatchableFrame::setDrawBatch(DrawBatch* batch) {
+    if (batch == batch_) return;
+    if (batch_) batch_->remove(*this);
+    if (batch) batch->add(*this);
+}
+
+void BatchableFrame::requestRedraw() {
+    if (batch_)
+        batch_->redraw();
+    else
+        redraw();
+}
+
+void BatchableFrame::draw(applause::Canvas& canvas) {
+    if (batch_) return;  // the batch draws us
+
+    APPLAUSE_PROFILE_DRAW();
+    prepareDraw(canvas);
+    const int passes = numDrawPasses();
+    for (int pass = 0; pass < passes; ++pass) drawPass(canvas, pass);
+}
+
+DrawBatch::DrawBatch() {
+    setIgnoresMouseEvents(true, false);
+}
+
+DrawBatch::~DrawBatch() {
+    for (Group& group : groups_) {
+        for (BatchableFrame* member : group.members) {
+            member->batch_ = nullptr;
+            member->redraw();
+        }
+    }
+}
+
+void DrawBatch::add(BatchableFrame& member) {
+    if (member.batch_ == this) return;
+    if (member.batch_) member.batch_->remove(member);
+
+    const std::type_index type(typeid(member));
+    auto group = std::find_if(groups_.begin(), groups_.end(), [&](const Group& g) { return g.type == type; });
+    if (group == groups_.end()) group = groups_.insert(groups_.end(), Group{type, {}});
+    group->members.push_back(&member);
+
+    member.batch_ = this;
+    member.redraw();  // clears what it drew itself
+    redraw();
+}
+
+void DrawBatch::remove(BatchableFrame& member) {
+    ASSERT(member.batch_ == this, "DrawBatch::remove called for a frame in another batch");
+    if (member.batch_ != this) return;
+
+    for (auto group = groups_.begin(); group != groups_.end(); ++group) {
+        auto it = std::find(group->members.begin(), group->members.end(), &member);
+        if (it == group->members.end()) continue;
+        group->members.erase(it);
+        if (group->members.empty()) groups_.erase(group);
+        break;
+    }
+
+    member.batch_ = nullptr;
+    member.redraw();
+    redraw();
+}
+
+size_t DrawBatch::size() const {
+    size_t count = 0;
+    for (const Group& group : groups_) count += group.members.size();
+    return count;
+}
+
+bool DrawBatch::isShown(const BatchableFrame& member) const {
+    // Up to the batch's parent; above that, the batch is hidden along with the members
+    for (const applause::Frame* frame = &member; frame && frame != parent(); frame = frame->parent()) {
+        if (!frame->isVisible()) return false;
+    }
+    return true;
+}
+
+void DrawBatch::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
+    const applause::Point origin = positionInWindow();
+
+    for (Group& group : groups_) {
+        drawn_.clear();
+        for (BatchableFrame* member : group.members) {
+            if (!isShown(*member) || member->width() <= 0 || member->height() <= 0) continue;
+            member->prepareDraw(canvas);
+            drawn_.emplace_back(member, member->positionInWindow() - origin);
+        }
+        if (drawn_.empty()) continue;
+
+        const int passes = drawn_.front().first->numDrawPasses();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (const auto& [member, offset] : drawn_) {
+                canvas.setPosition(offset.x, offset.y);
+                member->drawPass(canvas, pass);
+            }
+        }
+    }
+    canvas.setPosition(0, 0);
+}
+
+}  // namespace applause
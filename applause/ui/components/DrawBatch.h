@@ -0,0 +1,99 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace applause {
+
+class DrawBatch;
+
+/**
+ * A widget whose drawing is split into numbered passes (shadow, body, arc, ...) so that a DrawBatch can draw many of
+ * them together. On its own it draws every pass in order, exactly like a plain Frame. It is the base of Knob and
+ * Slider; a custom widget derives from it the same way and implements drawPass().
+ *
+ * Frame::redraw() isn't virtual, so batchable widgets call requestRedraw() instead, which repaints the batch while
+ * the widget is in one.
+ */
+class BatchableFrame : public applause::Frame {
+public:
+    ~BatchableFrame() override;
+
+    /** Hands drawing over to batch, or takes it back with nullptr. Same as batch->add(*this). */
+    void setDrawBatch(DrawBatch* batch);
+    [[nodiscard]] DrawBatch* getDrawBatch() const { return batch_; }
+
+    /** Redraws this widget, or its batch if it's in one. */
+    void requestRedraw();
+
+    void draw(applause::Canvas& canvas) final;
+
+protected:
+    /** Passes drawPass() is called with, 0 to numDrawPasses() - 1. The same for every instance of a type. */
+    [[nodiscard]] virtual int numDrawPasses() const = 0;
+
+    /** Called once per draw before the passes: update animations, ask providers for what to show. */
+    virtual void prepareDraw(applause::Canvas& canvas) {}
+
+    /** Draws one pass in the widget's own coordinates. A batch has already positioned the canvas. */
+    virtual void drawPass(applause::Canvas& canvas, int pass) = 0;
+
+private:
+    friend class DrawBatch;
+
+    DrawBatch* batch_ = nullptr;
+};
+
+/**
+ * Draws a group of BatchableFrames (usually the dozens of knobs or sliders of one page) from a single frame, pass by
+ * pass across all of them: every knob shadow, then every knob body, then every track, and so on. Visage merges
+ * consecutive shapes of one kind into one instanced draw call, so a page of 100 knobs redrawn by a preset change
+ * costs a draw call per pass instead of a region and several draw calls per knob. The members still handle their
+ * own mouse events; only their drawing moves.
+ *
+ * The batch covers the area it draws in: give it the same parent as the members (or a common ancestor of theirs),
+ * add it before them so it draws beneath their labels, and keep it sized to that parent. Members draw at their
+ * positions relative to it, without their own clipping, and with the batch's palette. Members are skipped while they
+ * or an ancestor are hidden. A member that moves without a change of value should redraw the batch.
+ *
+ * @code
+ * addChild(&knob_batch_);  // first, so it draws beneath the knobs' labels
+ * for (auto& knob : knobs_) {
+ *     addChild(knob.get());
+ *     knob->setDrawBatch(&knob_batch_);
+ * }
+ * // in resized()
+ * knob_batch_.setBounds(localBounds());
+ * @endcode
+ */
+class DrawBatch : public applause::Frame {
+public:
+    DrawBatch();
+    ~DrawBatch() override;
+
+    DrawBatch(const DrawBatch&) = delete;
+    DrawBatch& operator=(const DrawBatch&) = delete;
+
+    void add(BatchableFrame& member);
+    void remove(BatchableFrame& member);
+
+    [[nodiscard]] size_t size() const;
+
+    void draw(applause::Canvas& canvas) override;
+
+private:
+    struct Group {
+        std::type_index type;
+        std::vector<BatchableFrame*> members;
+    };
+
+    bool isShown(const BatchableFrame& member) const;
+
+    std::vector<Group> groups_;  // one per widget type, so each type draws its passes back to back
+    std::vector<std::pair<BatchableFrame*, applause::Point>> drawn_;  // scratch for draw()
+};
+
+}  // namespace applause
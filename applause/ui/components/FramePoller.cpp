@@ -0,0 +1,35 @@
+#include "FramePoller.h"
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/ui/ApplauseEditor.h>
+
+#include <utility>
+
+namespace applause {
+
+FramePoller::FramePoller(applause::Frame& view, Poll poll) : view_(view), poll_(std::move(poll)) {}
+
+void FramePoller::hookFrameUpdates() {
+    for (applause::Frame* frame = view_.parent(); frame; frame = frame->parent()) {
+        editor_ = dynamic_cast<ApplauseEditor*>(frame);
+        if (!editor_) continue;
+        frame_conn_ = editor_->on_frame_update.connect([this] {
+            // The producing thread can't wake the editor itself, so new data asks for the next frame
+            if (poll_()) editor_->wake();
+        });
+        editor_->wake();
+        return;
+    }
+}
+
+void FramePoller::onDraw() {
+    if (!editor_) hookFrameUpdates();
+    if (!editor_) {
+        // Outside an ApplauseEditor there's no frame signal: poll from our own redraws instead
+        poll_();
+        view_.redraw();
+    }
+}
+
+}  // namespace applause
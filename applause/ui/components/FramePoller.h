@@ -0,0 +1,54 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/util/thirdparty/rocket.hpp>
+
+#include <functional>
+
+namespace applause {
+class ApplauseEditor;
+
+/**
+ * Drives a view that shows data another thread produces (Meter, Scope, SpectrumDisplay): once per frame of the
+ * enclosing ApplauseEditor it calls the view's poll function, which copies whatever is new and returns whether
+ * anything changed.
+ *
+ * Only a poll that found something wakes the editor for the next frame, so a view whose source went quiet lets an
+ * otherwise idle editor sleep; the view catches up at the editor's next wake. Outside an ApplauseEditor there's no
+ * frame signal, and the view polls from its own redraws instead.
+ *
+ * @code
+ * class Meter : public applause::Frame {
+ *     ...
+ *     void draw(applause::Canvas& canvas) override {
+ *         poller_.onDraw();
+ *         ...
+ *     }
+ *
+ *     FramePoller poller_{*this, [this] { return update(); }};
+ * };
+ * @endcode
+ */
+class FramePoller {
+public:
+    using Poll = std::function<bool()>;
+
+    FramePoller(applause::Frame& view, Poll poll);
+
+    FramePoller(const FramePoller&) = delete;
+    FramePoller& operator=(const FramePoller&) = delete;
+
+    /** Call at the start of the view's draw(): finds the editor once the view is in one, or polls without one. */
+    void onDraw();
+
+private:
+    void hookFrameUpdates();
+
+    applause::Frame& view_;
+    Poll poll_;
+    ApplauseEditor* editor_ = nullptr;
+    rocket::scoped_connection frame_conn_;
+};
+
+}  // namespace applause
@@ -2,20 +2,24 @@
 
 #include <applause/ui/ApplauseUI.h>
 
+#include <applause/ui/FontCache.h>
 #include <embedded/applause_fonts.h>
 
 #include <algorithm>
+#include <cmath>
 
 #include <applause/util/DebugHelpers.h>
+#include <applause/util/inspector/DrawProfiler.h>
 
 using namespace applause::dimension;
 
 namespace applause {
-GenericParameterEntry::GenericParameterEntry(ParamInfo& paramInfo) : paramInfo_(paramInfo), paramSlider_(paramInfo) {
+GenericParameterEntry::GenericParameterEntry(ParamInfo& paramInfo) : paramInfo_(&paramInfo), paramSlider_(paramInfo) {
     addChild(&paramSlider_);
 }
 
 void GenericParameterEntry::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
     // Calculate text area bounds (left side of the component)
     // Full width minus padding only on the right (between text and slider)
     float textX = 0;
@@ -24,9 +28,9 @@ void GenericParameterEntry::draw(applause::Canvas& canvas) {
     float textHeight = height();
 
     // Draw the parameter name (right-aligned)
-    const applause::Font font(13, applause::fonts::Jost_Regular_ttf);
+    const applause::Font& font = FontCache::get(13, applause::fonts::Jost_Regular_ttf);
     canvas.setColor(0xFFCCCCCC);
-    canvas.text(paramInfo_.name, font, applause::Font::kRight, textX, textY, textWidth, textHeight);
+    canvas.text(paramInfo_->name, font, applause::Font::kRight, textX, textY, textWidth, textHeight);
 }
 
 void GenericParameterEntry::resized() {
@@ -43,51 +47,77 @@ void GenericParameterEntry::setLabelWidth(float labelWidth) {
     redraw();
 }
 
+void GenericParameterEntry::setParameter(ParamInfo& paramInfo) {
+    paramInfo_ = &paramInfo;
+    paramSlider_.setParameter(paramInfo);
+    redraw();
+}
+
+void GenericParameterEntry::disconnect() { paramSlider_.disconnect(); }
+
 GenericParameterUI::GenericParameterUI() {
-    // Configure scrollable vertical flex layout
-    scrollableLayout().setFlex(true);
-    scrollableLayout().setFlexRows(true);
-    scrollableLayout().setFlexGap(kEntryGap);
-    scrollableLayout().setPadding(kPadding);
-    scrollableLayout().setFlexItemAlignment(applause::Layout::ItemAlignment::Stretch);
+    onScroll() += [this](applause::ScrollableFrame*) { updateVisibleEntries(); };
 }
 
 void GenericParameterUI::draw(applause::Canvas& canvas) {}
 
 void GenericParameterUI::resized() {
     ScrollableFrame::resized();
+    layoutEntries();
+}
 
-    // Let flex layout compute positions first
-    computeLayout();
+void GenericParameterUI::addParameter(ParamInfo& paramInfo) {
+    LOG_DBG("Adding parameter {}", paramInfo.name);
+    params_.push_back(&paramInfo);
+    layoutEntries();
+}
 
-    // Then get actual content height from computed layout
-    // oddly enough there is not a function to get the width/height that a flex
-    // layout would consume
+void GenericParameterUI::layoutEntries() {
     float contentHeight = 0;
-    if (!entries_.empty()) {
-        // Find the bottom-most child position
-        for (auto& entry : entries_) {
-            contentHeight = std::max(contentHeight, entry->bottom());
-        }
-        // Add bottom padding from layout
-        contentHeight += scrollableLayout().paddingBottom().amount;
+    if (!params_.empty()) {
+        contentHeight = 2.0f * kPadding + params_.size() * kEntryHeight + (params_.size() - 1) * kEntryGap;
     }
-
     setScrollableHeight(contentHeight);
+    updateVisibleEntries();
 }
 
-void GenericParameterUI::addParameter(ParamInfo& paramInfo) {
-    LOG_DBG("Adding parameter {}", paramInfo.name);
-
-    auto entry = std::make_unique<GenericParameterEntry>(paramInfo);
-    entry->layout().setHeight(kEntryHeight);
-    entry->layout().setFlexGrow(0.0f);
-    entry->layout().setFlexShrink(0.0f);
-
-    addScrolledChild(entry.get());
-    entries_.push_back(std::move(entry));
+void GenericParameterUI::updateVisibleEntries() {
+    // Entries [first, last) overlap the view; entry i starts at kPadding + i * pitch
+    constexpr float pitch = kEntryHeight + kEntryGap;
+    const float view_top = yPosition() - kPadding;
+    const auto first = static_cast<size_t>(std::max(0.0f, std::floor((view_top - kEntryHeight) / pitch)));
+    const size_t last = std::min(params_.size(), static_cast<size_t>(std::ceil((view_top + height()) / pitch)));
+
+    // Release entries that scrolled out of view
+    for (auto it = bound_entries_.begin(); it != bound_entries_.end();) {
+        if (it->first < first || it->first >= last) {
+            it->second->disconnect();
+            it->second->setVisible(false);
+            free_entries_.push_back(it->second);
+            it = bound_entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    computeLayout();
-    resized();
+    const float entryWidth = std::max(0.0f, width() - 2.0f * kPadding);
+    for (size_t i = first; i < last; ++i) {
+        GenericParameterEntry* entry;
+        if (auto it = bound_entries_.find(i); it != bound_entries_.end()) {
+            entry = it->second;
+        } else if (!free_entries_.empty()) {
+            entry = free_entries_.back();
+            free_entries_.pop_back();
+            entry->setParameter(*params_[i]);
+            entry->setVisible(true);
+            bound_entries_.emplace(i, entry);
+        } else {
+            entries_.push_back(std::make_unique<GenericParameterEntry>(*params_[i]));
+            entry = entries_.back().get();
+            addScrolledChild(entry);
+            bound_entries_.emplace(i, entry);
+        }
+        entry->setBounds(kPadding, kPadding + i * pitch, entryWidth, kEntryHeight);
+    }
 }
 }  // namespace applause
@@ -3,6 +3,7 @@
 #include <applause/ui/ApplauseUI.h>
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <applause/ui/components/ParamSlider.h>
@@ -25,14 +26,27 @@ public:
 
     void setLabelWidth(float labelWidth);
 
+    /** Shows paramInfo instead, e.g. when a recycled entry is rebound. */
+    void setParameter(ParamInfo& paramInfo);
+
+    /** Stops listening to the parameter until the next setParameter(). */
+    void disconnect();
+
 private:
     static constexpr int kLabelPadding = 10;
 
-    ParamInfo& paramInfo_;
+    ParamInfo* paramInfo_;
     ParamSlider paramSlider_;
     float labelWidth_ = 100.0;
 };
 
+/**
+ * A scrolling list of GenericParameterEntry rows, one per added parameter.
+ *
+ * The list is virtual: entries exist only for the rows in view and are rebound to other parameters as the list
+ * scrolls, so only visible parameters have widgets and on_value_changed listeners. That keeps opening an editor
+ * with hundreds of parameters cheap.
+ */
 class GenericParameterUI : public applause::ScrollableFrame {
 public:
     GenericParameterUI();
@@ -48,6 +62,14 @@ private:
     static constexpr float kEntryGap = 16.0f;
     static constexpr float kEntryHeight = 26.0f;
 
-    std::vector<std::unique_ptr<GenericParameterEntry>> entries_;
+    // Sizes the scroll area, then materializes the visible entries
+    void layoutEntries();
+    // Binds pooled entries to the parameters in view and releases the rest
+    void updateVisibleEntries();
+
+    std::vector<ParamInfo*> params_;
+    std::vector<std::unique_ptr<GenericParameterEntry>> entries_;  // Every entry created so far; never shrinks
+    std::vector<GenericParameterEntry*> free_entries_;  // Pooled entries not bound to a parameter
+    std::unordered_map<size_t, GenericParameterEntry*> bound_entries_;  // Materialized entries by parameter index
 };
 }  // namespace applause
@@ -6,6 +6,7 @@
 #include <cmath>
 
 #include <applause/util/DebugHelpers.h>
+#include <applause/util/inspector/DrawProfiler.h>
 
 namespace applause {
 
@@ -28,124 +29,154 @@ Knob::Knob() {
 
 void Knob::setValue(float value) {
     value_ = std::clamp(value, 0.0f, 1.0f);
-    redraw();
+    APPLAUSE_PROFILE_REDRAW("value");
+    requestRedraw();
 }
 
 void Knob::setDefaultValue(float value) {
     default_value_ = std::clamp(value, 0.0f, 1.0f);
-    redraw();
+    requestRedraw();
 }
 
 void Knob::setIndicatorProvider(
-    std::function<void(std::vector<float>&, float&, float&)> provider) {
+    std::function<std::span<const float>(float&, float&)> provider) {
     indicator_provider_ = std::move(provider);
-    redraw();
+    requestRedraw();
 }
 
-void Knob::draw(applause::Canvas& canvas) {
-    float size = std::min(width(), height());
-    float centerX = width() * 0.5f;
-    float centerY = height() * 0.5f;
-    float radius = size * 0.5f;
-
+Knob::Geometry Knob::geometry(applause::Canvas& canvas) const {
     constexpr float kTopCenter = 1.5f * static_cast<float>(M_PI);  // 270° = 3π/2
-    float sweep = canvas.value(ApplauseKnobSweep);
-    float arcThickness = canvas.value(ApplauseKnobArcThickness);
-    float trackCenter = radius - canvas.value(ApplauseKnobTrackInset);
-    float halfSweep = sweep * 0.5f;
-    float startAngle = kTopCenter - halfSweep;
-    float bodyRadius = radius - 6.0f;
-    float bodyDiameter = bodyRadius * 2.0f;
-
-    // Drop shadow beneath knob body
-    float shadowOffset = 4.0f;
-    float shadowPad = 3.0f;
-    float shadowDiameter = bodyDiameter + shadowPad * 2.0f;
-    canvas.setColor(ApplauseKnobShadow);
-    canvas.fadeCircle(centerX - bodyRadius - shadowPad, centerY - bodyRadius - shadowPad + shadowOffset, shadowDiameter,
-                      10.0f);
-
-    // Draw knob body
-    float bodyX = centerX - bodyRadius;
-    float bodyY = centerY - bodyRadius;
-    auto sample = [&](auto id) { return canvas.color(id).gradient().sample(0.0f); };
-    canvas.setColor(applause::Brush::vertical(sample(ApplauseKnobBodyTop), sample(ApplauseKnobBodyBottom)));
-    canvas.circle(bodyX, bodyY, bodyDiameter);
-    canvas.setColor(ApplauseKnobBodyBorder);
-    canvas.ring(bodyX, bodyY, bodyDiameter, 1.0f);
+    Geometry g;
+    g.center_x = width() * 0.5f;
+    g.center_y = height() * 0.5f;
+    g.radius = std::min(width(), height()) * 0.5f;
+    g.sweep = canvas.value(ApplauseKnobSweep);
+    g.arc_thickness = canvas.value(ApplauseKnobArcThickness);
+    g.track_center = g.radius - canvas.value(ApplauseKnobTrackInset);
+    g.half_sweep = g.sweep * 0.5f;
+    g.top_center = kTopCenter;
+    g.start_angle = kTopCenter - g.half_sweep;
+    g.body_radius = g.radius - 6.0f;
+    return g;
+}
 
-    // Animated radial glow over body center
+void Knob::prepareDraw(applause::Canvas& canvas) {
     glow_amount_.update();
-    float glowAlpha = glow_amount_.value();
-    if (glowAlpha > 0.0f) {
+    if (glow_amount_.isAnimating()) {
+        APPLAUSE_PROFILE_REDRAW("animation");
+        requestRedraw();
+    }
+
+    arc_min_ = 1.0f;  // sentinel: arc_min >= arc_max → no range arc
+    arc_max_ = 0.0f;
+    indicators_ = {};
+    if (indicator_provider_) indicators_ = indicator_provider_(arc_min_, arc_max_);
+}
+
+void Knob::drawPass(applause::Canvas& canvas, int pass) {
+    const Geometry g = geometry(canvas);
+    const float bodyDiameter = g.body_radius * 2.0f;
+    const float bodyX = g.center_x - g.body_radius;
+    const float bodyY = g.center_y - g.body_radius;
+    const float trackDiameter = g.track_center * 2.0f;
+    auto sample = [&](auto id) { return canvas.color(id).gradient().sample(0.0f); };
+
+    switch (static_cast<DrawPass>(pass)) {
+    case DrawPass::Shadow: {
+        // Drop shadow beneath knob body
+        float shadowOffset = 4.0f;
+        float shadowPad = 3.0f;
+        float shadowDiameter = bodyDiameter + shadowPad * 2.0f;
+        canvas.setColor(ApplauseKnobShadow);
+        canvas.fadeCircle(g.center_x - g.body_radius - shadowPad, g.center_y - g.body_radius - shadowPad + shadowOffset,
+                          shadowDiameter, 10.0f);
+        break;
+    }
+    case DrawPass::Body:
+        canvas.setColor(applause::Brush::vertical(sample(ApplauseKnobBodyTop), sample(ApplauseKnobBodyBottom)));
+        canvas.circle(bodyX, bodyY, bodyDiameter);
+        break;
+    case DrawPass::Border:
+        canvas.setColor(ApplauseKnobBodyBorder);
+        canvas.ring(bodyX, bodyY, bodyDiameter, 1.0f);
+        break;
+    case DrawPass::Glow: {
+        // Animated radial glow over body center
+        float glowAlpha = glow_amount_.value();
+        if (glowAlpha <= 0.0f) break;
         applause::Color accent = sample(ApplauseKnobAccent);
         applause::Gradient glow;
         glow.addColorStop(accent.withAlpha(glowAlpha * 0.35f), 0.0f);
         glow.addColorStop(accent.withAlpha(glowAlpha * 0.15f), 0.6f);
         glow.addColorStop(accent.withAlpha(glowAlpha * 0.10f), 1.0f);
-        applause::Point center = {centerX, centerY};
-        canvas.setColor(applause::Brush::radial(glow, center, bodyRadius, bodyRadius));
+        applause::Point center = {g.center_x, g.center_y};
+        canvas.setColor(applause::Brush::radial(glow, center, g.body_radius, g.body_radius));
         canvas.circle(bodyX, bodyY, bodyDiameter);
+        break;
     }
-    if (glow_amount_.isAnimating()) redraw();
-
-    // Draw accent arc on body ring from default position to current value
-    if (value_ != default_value_) {
-        float accentCenter = startAngle + (value_ + default_value_) * 0.5f * sweep;
-        float accentHalfSpan = std::abs(value_ - default_value_) * 0.5f * sweep;
+    case DrawPass::RimArc: {
+        // Accent arc on body ring from default position to current value
+        if (value_ == default_value_) break;
+        float accentCenter = g.start_angle + (value_ + default_value_) * 0.5f * g.sweep;
+        float accentHalfSpan = std::abs(value_ - default_value_) * 0.5f * g.sweep;
         canvas.setColor(ApplauseKnobAccent);
         canvas.arc(bodyX, bodyY, bodyDiameter, 1.0f, accentCenter, accentHalfSpan, false);
+        break;
     }
-
-    // Draw arc track
-    canvas.setColor(ApplauseKnobArcTrack);
-    float trackDiameter = trackCenter * 2.0f;
-    canvas.arc(centerX - trackCenter, centerY - trackCenter, trackDiameter, arcThickness, kTopCenter, halfSweep, true);
-
-    indicator_buf_.clear();
-    float arc_min = 1.0f, arc_max = 0.0f;  // sentinel: arc_min >= arc_max → no range arc
-    if (indicator_provider_) indicator_provider_(indicator_buf_, arc_min, arc_max);
-
-    if (arc_min < arc_max) {
-        arc_min = std::clamp(arc_min, 0.0f, 1.0f);
-        arc_max = std::clamp(arc_max, 0.0f, 1.0f);
-        const float ac = startAngle + (arc_min + arc_max) * 0.5f * sweep;
-        const float ah = (arc_max - arc_min) * 0.5f * sweep;
-        canvas.setColor(canvas.color(ApplauseKnobAccent).gradient().sample(0.0f).withAlpha(0.35f));
-        canvas.arc(centerX - trackCenter, centerY - trackCenter, trackDiameter, arcThickness, ac, ah, true);
+    case DrawPass::Track:
+        canvas.setColor(ApplauseKnobArcTrack);
+        canvas.arc(g.center_x - g.track_center, g.center_y - g.track_center, trackDiameter, g.arc_thickness,
+                   g.top_center, g.half_sweep, true);
+        break;
+    case DrawPass::RangeArc: {
+        if (arc_min_ >= arc_max_) break;
+        const float arc_min = std::clamp(arc_min_, 0.0f, 1.0f);
+        const float arc_max = std::clamp(arc_max_, 0.0f, 1.0f);
+        const float ac = g.start_angle + (arc_min + arc_max) * 0.5f * g.sweep;
+        const float ah = (arc_max - arc_min) * 0.5f * g.sweep;
+        canvas.setColor(sample(ApplauseKnobAccent).withAlpha(0.35f));
+        canvas.arc(g.center_x - g.track_center, g.center_y - g.track_center, trackDiameter, g.arc_thickness, ac, ah,
+                   true);
+        break;
     }
+    case DrawPass::Dots: {
+        const float dotDiameter = g.arc_thickness;
+        const float dotTrackRadius = g.track_center - g.arc_thickness * 0.5f;
+        canvas.setColor(ApplauseKnobAccent);
 
-    const float dotDiameter = arcThickness;
-    const float dotTrackRadius = trackCenter - arcThickness * 0.5f;
-    canvas.setColor(ApplauseKnobAccent);
-
-    auto drawDot = [&](float v) {
-        v = std::clamp(v, 0.0f, 1.0f);
-        const float a = startAngle + v * sweep;
-        const float cx = centerX + std::cos(a) * dotTrackRadius;
-        const float cy = centerY + std::sin(a) * dotTrackRadius;
-        canvas.circle(cx - dotDiameter * 0.5f, cy - dotDiameter * 0.5f, dotDiameter);
-    };
-
-    if (indicator_buf_.empty()) {
-        drawDot(value_);
-    } else {
-        for (float v : indicator_buf_) drawDot(v);
-        redraw();
+        auto drawDot = [&](float v) {
+            v = std::clamp(v, 0.0f, 1.0f);
+            const float a = g.start_angle + v * g.sweep;
+            const float cx = g.center_x + std::cos(a) * dotTrackRadius;
+            const float cy = g.center_y + std::sin(a) * dotTrackRadius;
+            canvas.circle(cx - dotDiameter * 0.5f, cy - dotDiameter * 0.5f, dotDiameter);
+        };
+
+        if (indicators_.empty()) {
+            drawDot(value_);
+        } else {
+            for (float v : indicators_) drawDot(v);
+        }
+        break;
     }
+    case DrawPass::Needle: {
+        float angle = g.start_angle + value_ * g.sweep;
 
-    float angle = startAngle + value_ * sweep;
+        float needle_radius = bodyDiameter * 0.5f - 2.0f;
+        float lineEndX = g.center_x + static_cast<float>(std::cos(angle)) * needle_radius;
+        float lineEndY = g.center_y + static_cast<float>(std::sin(angle)) * needle_radius;
 
-    float needle_radius = bodyDiameter * 0.5f - 2.0f;
-    float lineEndX = centerX + static_cast<float>(std::cos(angle)) * needle_radius;
-    float lineEndY = centerY + static_cast<float>(std::sin(angle)) * needle_radius;
-
-    // draw it!
-    float needleStartRadius = 5.0f;
-    float lineStartX = centerX + static_cast<float>(std::cos(angle)) * needleStartRadius;
-    float lineStartY = centerY + static_cast<float>(std::sin(angle)) * needleStartRadius;
-    canvas.setColor(ApplauseKnobAccent);
-    canvas.segment(lineStartX, lineStartY, lineEndX, lineEndY, 3.0f, true);
+        // draw it!
+        float needleStartRadius = 5.0f;
+        float lineStartX = g.center_x + static_cast<float>(std::cos(angle)) * needleStartRadius;
+        float lineStartY = g.center_y + static_cast<float>(std::sin(angle)) * needleStartRadius;
+        canvas.setColor(ApplauseKnobAccent);
+        canvas.segment(lineStartX, lineStartY, lineEndX, lineEndY, 3.0f, true);
+        break;
+    }
+    case DrawPass::Count:
+        break;
+    }
 }
 
 void Knob::mouseDown(const applause::MouseEvent& e) {
@@ -157,7 +188,7 @@ void Knob::mouseDown(const applause::MouseEvent& e) {
             value_ = default_value_;
             onValueChanged.callback(value_);
             onDragEnded.callback();
-            redraw();
+            requestRedraw();
         }
         return;  // do NOT start a drag on the reset click
     }
@@ -167,7 +198,7 @@ void Knob::mouseDown(const applause::MouseEvent& e) {
     drag_start_value_ = value_;
     glow_amount_.target(true);
     onDragStarted.callback();
-    redraw();
+    requestRedraw();
 }
 
 void Knob::mouseDrag(const applause::MouseEvent& e) {
@@ -182,20 +213,22 @@ void Knob::mouseUp(const applause::MouseEvent& e) {
         processDrag(e.position.y);
         onDragEnded.callback();
         if (!hovering_) glow_amount_.target(false);
-        redraw();
+        requestRedraw();
     }
 }
 
 void Knob::mouseEnter(const applause::MouseEvent& e) {
     hovering_ = true;
     glow_amount_.target(true);
-    redraw();
+    APPLAUSE_PROFILE_REDRAW("hover");
+    requestRedraw();
 }
 
 void Knob::mouseExit(const applause::MouseEvent& e) {
     hovering_ = false;
     if (!dragging_) glow_amount_.target(false);
-    redraw();
+    APPLAUSE_PROFILE_REDRAW("hover");
+    requestRedraw();
 }
 
 bool Knob::mouseWheel(const applause::MouseEvent& e) {
@@ -207,7 +240,7 @@ bool Knob::mouseWheel(const applause::MouseEvent& e) {
 
         value_ = newValue;
         onValueChanged.callback(value_);
-        redraw();
+        requestRedraw();
 
         onDragEnded.callback();
 
@@ -226,7 +259,7 @@ void Knob::processDrag(float mouseY) {
     if (newValue != value_) {
         value_ = newValue;
         onValueChanged.callback(value_);
-        redraw();
+        requestRedraw();
     }
 }
 
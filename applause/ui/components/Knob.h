@@ -1,9 +1,10 @@
 #pragma once
 
 #include <applause/ui/ApplauseUI.h>
+#include <applause/ui/components/DrawBatch.h>
 
 #include <functional>
-#include <vector>
+#include <span>
 
 namespace applause {
 
@@ -12,8 +13,10 @@ namespace applause {
  *
  * The Knob doesn't do much on its own. If you want a plug-and-play Knob with a built-in label that
  * attaches to a Parameter, check out ParamKnob.
+ *
+ * Knobs are BatchableFrames: a page with many of them can hand their drawing to one DrawBatch.
  */
-class Knob : public applause::Frame {
+class Knob : public BatchableFrame {
 public:
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseKnobBodyTop);
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseKnobBodyBottom);
@@ -42,19 +45,22 @@ public:
     void setDragSensitivity(float sensitivity) { drag_sensitivity_ = sensitivity; }
     void setWheelSensitivity(float sensitivity) { wheel_sensitivity_ = sensitivity; }
 
-    // Optional modulation hook: the provider fills `out` with normalized [0,1] positions to display,
-    // and writes `arc_min`/`arc_max` in normalized space to draw a sub-arc on the track between those
-    // angles. Leave `arc_min >= arc_max` (the initial sentinel) to suppress the arc.
+    // Optional modulation hook: the provider returns normalized [0,1] positions to display (in storage it
+    // owns, valid until the draw returns), and writes `arc_min`/`arc_max` in normalized space to draw a
+    // sub-arc on the track between those angles. Leave `arc_min >= arc_max` (the initial sentinel) to
+    // suppress the arc. The knob only asks while drawing; the owner calls requestRedraw() when the indicators move.
     // This lets the knob ask a parent class (generally, the ParamKnob) if there are any sort of "modulation" sources
     // being applied to whatever destination this knob represents; then, the knob can draw the modulation as an overlay
     // however it sees fit.
     // We seperate the knob from the DSP/parameter/plugin side of things on purpose... knob is only visual; it doesn't
     // "know" anything about the plugin business.
-    void setIndicatorProvider(
-        std::function<void(std::vector<float>& dots, float& arc_min, float& arc_max)> provider);
+    void setIndicatorProvider(std::function<std::span<const float>(float& arc_min, float& arc_max)> provider);
 
 protected:
-    void draw(applause::Canvas& canvas) override;
+    [[nodiscard]] int numDrawPasses() const override { return static_cast<int>(DrawPass::Count); }
+    void prepareDraw(applause::Canvas& canvas) override;
+    void drawPass(applause::Canvas& canvas, int pass) override;
+
     void mouseDown(const applause::MouseEvent& e) override;
     void mouseDrag(const applause::MouseEvent& e) override;
     void mouseUp(const applause::MouseEvent& e) override;
@@ -63,6 +69,15 @@ protected:
     bool mouseWheel(const applause::MouseEvent& e) override;
 
 private:
+    enum class DrawPass { Shadow, Body, Border, Glow, RimArc, Track, RangeArc, Dots, Needle, Count };
+
+    struct Geometry {
+        float center_x, center_y, radius;
+        float sweep, half_sweep, top_center, start_angle;
+        float arc_thickness, track_center, body_radius;
+    };
+
+    Geometry geometry(applause::Canvas& canvas) const;
     void processDrag(float mouseY);
 
     float value_ = 0.0f;  // normalized value between 0 and 1, not bipolar
@@ -74,8 +89,12 @@ private:
     float drag_sensitivity_ = 0.005f;
     float wheel_sensitivity_ = 0.015f;
     applause::Animation<float> glow_amount_;
-    std::function<void(std::vector<float>&, float&, float&)> indicator_provider_;
-    std::vector<float> indicator_buf_;
+    std::function<std::span<const float>(float&, float&)> indicator_provider_;
+
+    // What the provider returned for the current draw
+    std::span<const float> indicators_;
+    float arc_min_ = 1.0f;
+    float arc_max_ = 0.0f;
 };
 
 }  // namespace applause
@@ -0,0 +1,38 @@
+#include "LazyFrame.h"
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/util/DebugHelpers.h>
+
+namespace applause {
+
+LazyFrame::LazyFrame(Factory factory) : factory_(std::move(factory)) {
+    ASSERT(factory_, "LazyFrame needs a factory");
+}
+
+applause::Frame& LazyFrame::build() {
+    if (!content_) {
+        content_ = factory_();
+        ASSERT(content_, "LazyFrame factory returned no frame");
+        factory_ = nullptr;  // release whatever the factory captured
+        addChild(content_.get());
+        content_->setBounds(localBounds());
+    }
+    return *content_;
+}
+
+void LazyFrame::buildIfShown() {
+    if (!content_ && isVisible() && width() > 0.0f && height() > 0.0f) build();
+}
+
+void LazyFrame::resized() {
+    if (content_) {
+        content_->setBounds(localBounds());
+    } else {
+        buildIfShown();
+    }
+}
+
+void LazyFrame::visibilityChanged() { buildIfShown(); }
+
+}  // namespace applause
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <functional>
+#include <memory>
+
+namespace applause {
+
+/**
+ * Stand-in for a child page that is expensive to build and not necessarily on screen: a tab, a settings page, a
+ * preset browser. It holds a factory and calls it the first time it is visible with a non-empty size, then keeps the
+ * built page filling its bounds. Pages that are never opened are never built, and the editor constructor only pays
+ * for the ones the first frame shows.
+ *
+ * The page stays built once shown; hiding the LazyFrame hides it along with it.
+ *
+ * @code
+ * settings_page_ = std::make_unique<applause::LazyFrame>([this] { return std::make_unique<SettingsPage>(*this); });
+ * addChild(settings_page_.get());
+ * settings_page_->setVisible(false);  // built when the settings tab first shows it
+ * @endcode
+ */
+class LazyFrame : public applause::Frame {
+public:
+    using Factory = std::function<std::unique_ptr<applause::Frame>()>;
+
+    explicit LazyFrame(Factory factory);
+
+    /** Builds the page now if it isn't built yet, e.g. to prepare it during idle time. */
+    applause::Frame& build();
+
+    [[nodiscard]] bool isBuilt() const { return content_ != nullptr; }
+
+    /** The built page, or nullptr before it was first shown. */
+    [[nodiscard]] applause::Frame* content() const { return content_.get(); }
+
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    void buildIfShown();
+
+    Factory factory_;
+    std::unique_ptr<applause::Frame> content_;
+};
+
+}  // namespace applause
@@ -0,0 +1,102 @@
+#include "Meter.h"
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/util/inspector/DrawProfiler.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace applause {
+
+APPLAUSE_THEME_IMPLEMENT_COLOR(Meter, ApplauseMeterBackground, 0xff1a1a1e);
+APPLAUSE_THEME_IMPLEMENT_COLOR(Meter, ApplauseMeterPeak, 0x889966ff);
+APPLAUSE_THEME_IMPLEMENT_COLOR(Meter, ApplauseMeterRms, 0xff9966ff);
+APPLAUSE_THEME_IMPLEMENT_COLOR(Meter, ApplauseMeterHold, 0xffdddddd);
+
+Meter::Meter(LevelTap& tap) :
+    tap_(tap), levels_(tap.getNumChannels()), hold_(tap.getNumChannels(), 0.0f), hold_age_(tap.getNumChannels(), 0) {
+    setIgnoresMouseEvents(true, false);
+}
+
+void Meter::setRange(float min_db, float max_db) {
+    min_db_ = min_db;
+    max_db_ = std::max(max_db, min_db + 1.0f);
+    redraw();
+}
+
+float Meter::levelToY(float level) const {
+    const float db = level > 0.0f ? 20.0f * std::log10(level) : min_db_;
+    const float t = std::clamp((db - min_db_) / (max_db_ - min_db_), 0.0f, 1.0f);
+    return height() * (1.0f - t);
+}
+
+bool Meter::update() {
+    bool changed = false;
+    const uint64_t blocks = tap_.getBlockCount();
+    if (blocks != read_blocks_) {
+        read_blocks_ = blocks;
+        tap_.readLevels(levels_, window_frames_);
+        changed = true;
+    } else {
+        // No audio arrived (e.g. the host stopped processing): fall back instead of freezing
+        for (auto& level : levels_) {
+            if (level.peak == 0.0f && level.rms == 0.0f) continue;
+            level.peak = level.peak > 1e-5f ? level.peak * kFallPerFrame : 0.0f;
+            level.rms = level.rms > 1e-5f ? level.rms * kFallPerFrame : 0.0f;
+            changed = true;
+        }
+    }
+
+    for (size_t ch = 0; ch < levels_.size(); ++ch) {
+        if (levels_[ch].peak >= hold_[ch]) {
+            changed = changed || hold_[ch] != levels_[ch].peak;
+            hold_[ch] = levels_[ch].peak;
+            hold_age_[ch] = 0;
+        } else if (++hold_age_[ch] > kHoldFrames) {
+            hold_[ch] = hold_[ch] > 1e-5f ? hold_[ch] * kFallPerFrame : 0.0f;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        APPLAUSE_PROFILE_REDRAW("meter");
+        redraw();
+    }
+    return changed;
+}
+
+void Meter::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
+    poller_.onDraw();
+
+    const auto channels = static_cast<float>(levels_.size());
+    if (levels_.empty()) return;
+    const float bar_width = (width() - kChannelGap * (channels - 1.0f)) / channels;
+
+    canvas.setColor(ApplauseMeterBackground);
+    for (size_t ch = 0; ch < levels_.size(); ++ch) {
+        canvas.rectangle(ch * (bar_width + kChannelGap), 0, bar_width, height());
+    }
+
+    canvas.setColor(ApplauseMeterPeak);
+    for (size_t ch = 0; ch < levels_.size(); ++ch) {
+        const float y = levelToY(levels_[ch].peak);
+        canvas.rectangle(ch * (bar_width + kChannelGap), y, bar_width, height() - y);
+    }
+
+    canvas.setColor(ApplauseMeterRms);
+    for (size_t ch = 0; ch < levels_.size(); ++ch) {
+        const float y = levelToY(levels_[ch].rms);
+        canvas.rectangle(ch * (bar_width + kChannelGap), y, bar_width, height() - y);
+    }
+
+    canvas.setColor(ApplauseMeterHold);
+    for (size_t ch = 0; ch < levels_.size(); ++ch) {
+        if (hold_[ch] <= 0.0f) continue;
+        const float y = std::min(levelToY(hold_[ch]), height() - kHoldHeight);
+        canvas.rectangle(ch * (bar_width + kChannelGap), y, bar_width, kHoldHeight);
+    }
+}
+
+}  // namespace applause
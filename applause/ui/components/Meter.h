@@ -0,0 +1,63 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/dsp/LevelTap.h>
+#include <applause/ui/components/FramePoller.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace applause {
+
+/**
+ * A level meter showing the peak and RMS of each channel of a LevelTap as vertical bars, with a peak hold line.
+ *
+ * The audio thread only pushes block summaries into the tap; once per frame of the enclosing ApplauseEditor the
+ * meter reads the newest window from it and redraws if anything changed. Each channel is drawn as a handful of
+ * rectangles, which the renderer batches, so dozens of meters cost next to nothing to draw. It keeps the editor
+ * updating while blocks arrive or the display is still falling back (see FramePoller).
+ */
+class Meter : public applause::Frame {
+public:
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseMeterBackground);
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseMeterPeak);
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseMeterRms);
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseMeterHold);
+
+    explicit Meter(LevelTap& tap);
+
+    void draw(applause::Canvas& canvas) override;
+
+    /** The decibel range mapped onto the meter's height; -60 to +6 dB by default. */
+    void setRange(float min_db, float max_db);
+
+    /** Frames the peak and RMS are measured over; 2048 by default. */
+    void setWindow(uint32_t frames) { window_frames_ = frames; }
+
+    /**
+     * Reads the newest levels from the tap, lets the display fall back when no audio arrives, and redraws if
+     * anything moved. Returns whether it redrew.
+     */
+    bool update();
+
+private:
+    [[nodiscard]] float levelToY(float level) const;
+
+    static constexpr float kChannelGap = 2.0f;
+    static constexpr float kHoldHeight = 2.0f;
+    static constexpr int kHoldFrames = 45;  // frames the peak hold line stays before falling
+    static constexpr float kFallPerFrame = 0.85f;  // level multiplier per frame while falling
+
+    LevelTap& tap_;
+    std::vector<LevelTap::Level> levels_;
+    std::vector<float> hold_;
+    std::vector<int> hold_age_;
+    uint64_t read_blocks_ = 0;
+    uint32_t window_frames_ = 2048;
+    float min_db_ = -60.0f;
+    float max_db_ = 6.0f;
+    FramePoller poller_{*this, [this] { return update(); }};
+};
+
+}  // namespace applause
@@ -2,6 +2,8 @@
 
 #include <applause/ui/ApplauseUI.h>
 
+#include <applause/ui/FontCache.h>
+#include <applause/util/inspector/DrawProfiler.h>
 #include <embedded/applause_fonts.h>
 
 namespace applause {
@@ -19,12 +21,13 @@ Panel::Panel() : has_title_(false) {
 }
 
 Panel::Panel(const std::string& title)
-    : title_(title, applause::Font(15, applause::fonts::Jost_Medium_ttf)),
+    : title_(title, FontCache::get(15, applause::fonts::Jost_Medium_ttf)),
       has_title_(true) {
     addChild(&content_);
 }
 
 void Panel::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
     float w = width();
     float h = height();
     float rounding = canvas.value(ApplausePanelRounding);
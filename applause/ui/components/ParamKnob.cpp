@@ -2,9 +2,12 @@
 
 #include <applause/ui/ApplauseUI.h>
 
+#include <applause/ui/FontCache.h>
 #include <applause/util/DebugHelpers.h>
 #include <embedded/applause_fonts.h>
 
+#include <algorithm>
+
 namespace applause {
 
 APPLAUSE_THEME_IMPLEMENT_COLOR(ParamKnob, ApplauseParamKnobText, 0xffcccccc);
@@ -19,7 +22,7 @@ ParamKnob::ParamKnob(ParamInfo& paramInfo, const ModDestination* dst) :
 
     paramNameText_.setMultiLine(false);
     paramNameText_.setJustification(applause::Font::kCenter);
-    paramNameText_.setFont(applause::Font(12, applause::fonts::Jost_Regular_ttf));
+    paramNameText_.setFont(FontCache::get(12, applause::fonts::Jost_Regular_ttf));
     paramNameText_.setActive(false);
     paramNameText_.setText(param_info_.shortName);
     paramNameText_.setIgnoresMouseEvents(true, false);
@@ -59,28 +62,64 @@ ParamKnob::ParamKnob(ParamInfo& paramInfo, const ModDestination* dst) :
     if (dst) {
         ASSERT(dst->matrix);
         destination_ = dst;
-        mod_changed_conn_ = destination_->matrix->on_connections_changed.connect(
-            [this] { knob_.redraw(); });
-        knob_.setIndicatorProvider([this](std::vector<float>& out, float& arc_min, float& arc_max) {
-            ModMatrix* m = destination_->matrix;
-            if (!m->dstIsConnected(destination_->index)) return;
-            const auto normalize = [&](float v) { return param_info_.toNormalized(v); };
-            if (destination_->mode == ModDstMode::Poly) {
-                for (uint16_t voice : m->getActiveVoices())
-                    out.push_back(normalize(m->getPolyModValue(destination_->index, voice)));
-            } else {
-                out.push_back(normalize(m->getModValue(destination_->index)));
-            }
-            const auto [off_min, off_max] = m->getModOffsetRange(destination_->index);
+        dots_.reserve(std::max<uint16_t>(destination_->matrix->getConfig().num_voices, 1));
+        mod_changed_conn_ = destination_->matrix->on_connections_edited.connect(
+            [this](std::span<const ModConnectionChange> changes) {
+                // Only connections targeting this destination affect its indicators and offset arc
+                const bool affected = std::ranges::any_of(changes, [this](const ModConnectionChange& c) {
+                    return !c.is_depth_mod && c.dst_idx == destination_->index;
+                });
+                if (affected) {
+                    connections_edited_ = true;
+                    updateModulation();
+                    redraw();  // restart polling from draw()
+                }
+            });
+        knob_.setIndicatorProvider([this](float& arc_min, float& arc_max) -> std::span<const float> {
+            if (!connected_) return {};
             const float v = param_info_.toNormalized(param_info_.getValue());
-            arc_min = v + off_min;
-            arc_max = v + off_max;
+            arc_min = v + offset_range_.first;
+            arc_max = v + offset_range_.second;
+            return dots_;
         });
+        updateModulation();
+    }
+}
+
+bool ParamKnob::updateModulation() {
+    if (!destination_) return false;
+    ModMatrix* m = destination_->matrix;
+    const ModUiSnapshot& snap = m->acquireUiSnapshot();
+    const uint64_t version = snap.getDstVersion(destination_->index);
+    if (version == drawn_version_ && !connections_edited_) return false;
+
+    drawn_version_ = version;
+    connected_ = m->dstIsConnected(destination_->index);
+    dots_.clear();
+    if (connected_) {
+        const auto normalize = [&](float v) { return param_info_.toNormalized(v); };
+        if (destination_->mode == ModDstMode::Poly) {
+            for (uint16_t voice : snap.getActiveVoices()) {
+                if (dots_.size() == dots_.capacity()) break;
+                dots_.push_back(normalize(snap.getPolyModValue(destination_->index, voice)));
+            }
+        } else {
+            dots_.push_back(normalize(snap.getModValue(destination_->index)));
+        }
+    }
+    // getModOffsetRange() walks the destination's connections, so only after edits
+    if (connections_edited_) {
+        offset_range_ = m->getModOffsetRange(destination_->index);
+        connections_edited_ = false;
     }
+    knob_.requestRedraw();
+    return true;
 }
 
 void ParamKnob::draw(applause::Canvas& canvas) {
     // No direct text drawing; label rendered via TextEditor child
+    // Unconnected there's nothing to poll; a connection edit redraws the knob to start
+    if (connected_) poller_.onDraw();
 }
 
 void ParamKnob::resized() {
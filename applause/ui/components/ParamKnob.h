@@ -4,15 +4,25 @@
 
 #include <applause/core/ModMatrix.h>
 #include <applause/extensions/ParamsExtension.h>
+#include <applause/ui/components/FramePoller.h>
 #include <applause/ui/components/Knob.h>
 #include <applause/ui/components/ParamValueTextBox.h>
 #include <applause/util/thirdparty/rocket.hpp>
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 namespace applause {
 
 /**
  * A component that wraps a Knob with parameter connection and label display.
  * Displays the parameter's shortName below the knob.
+ *
+ * With a modulation destination, the knob shows the destination's modulated
+ * values as dots. While connected it polls the matrix's UI snapshot once per
+ * frame (see FramePoller) and redraws only when the destination's version
+ * (ModUiSnapshot::getDstVersion()) moved or its connections were edited.
  */
 class ParamKnob : public applause::Frame {
 public:
@@ -26,6 +36,15 @@ public:
     void mouseEnter(const applause::MouseEvent& e) override;
     void mouseExit(const applause::MouseEvent& e) override;
 
+    /**
+     * Rereads the destination's modulation from the UI snapshot and redraws
+     * the knob if anything moved. Returns whether it redrew.
+     */
+    bool updateModulation();
+
+    /** Hands the knob's drawing to batch (see DrawBatch), or takes it back with nullptr. */
+    void setDrawBatch(DrawBatch* batch) { knob_.setDrawBatch(batch); }
+
 private:
     static constexpr float kLabelHeight = 20.0f;
     static constexpr float kLabelPadding = 2.0f;
@@ -38,6 +57,14 @@ private:
     rocket::scoped_connection mod_changed_conn_;
     const ModDestination* destination_ = nullptr;
     bool mouseOver_ = false;
+
+    // Modulation indicators, as of the snapshot version drawn last
+    std::vector<float> dots_;  // normalized; reserved for one dot per voice
+    std::pair<float, float> offset_range_{};
+    uint64_t drawn_version_ = UINT64_MAX;
+    bool connected_ = false;
+    bool connections_edited_ = true;  // offset_range_ needs recomputing
+    FramePoller poller_{*this, [this] { return updateModulation(); }};
 };
 
 }  // namespace applause
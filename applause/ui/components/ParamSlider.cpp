@@ -5,36 +5,70 @@
 #include <applause/util/DebugHelpers.h>
 
 namespace applause {
-ParamSlider::ParamSlider(ParamInfo& paramInfo) : param_info_(paramInfo), param_text_box_(param_info_) {
+ParamSlider::ParamSlider(ParamInfo& paramInfo) : param_info_(&paramInfo), param_text_box_(paramInfo) {
     addChild(&slider_);
     addChild(&param_text_box_);
 
-    const float range = param_info_.maxValue - param_info_.minValue;
-    slider_.setDefaultValue((param_info_.defaultValue - param_info_.minValue) / range);
-
-    const float currentValue = param_info_.getValue();
-    const float normalizedValue = (currentValue - param_info_.minValue) / range;
-    slider_.setValue(normalizedValue);
-
     slider_.on_value_changed.add([this](float value) {
+        // The rest of a drag that began on the row's previous parameter changes nothing
+        if (this->drag_detached_) return;
         const float paramValue =
-            this->param_info_.minValue + value * (this->param_info_.maxValue - this->param_info_.minValue);
-        this->param_info_.setValueNotifyingHost(paramValue);
+            this->param_info_->minValue + value * (this->param_info_->maxValue - this->param_info_->minValue);
+        this->param_info_->setValueNotifyingHost(paramValue);
+    });
+
+    slider_.on_drag_started.add([this]() {
+        this->param_info_->beginGesture();
+        this->gesture_active_ = true;
+    });
+
+    slider_.on_drag_ended.add([this]() {
+        if (this->gesture_active_) this->param_info_->endGesture();
+        this->gesture_active_ = false;
+        this->drag_detached_ = false;
     });
 
-    slider_.on_drag_started.add([this]() { this->param_info_.beginGesture(); });
+    connectParameter();
+}
+
+void ParamSlider::connectParameter() {
+    const float range = param_info_->maxValue - param_info_->minValue;
+    slider_.setDefaultValue((param_info_->defaultValue - param_info_->minValue) / range);
 
-    slider_.on_drag_ended.add([this]() { this->param_info_.endGesture(); });
+    const float currentValue = param_info_->getValue();
+    const float normalizedValue = (currentValue - param_info_->minValue) / range;
+    slider_.setValue(normalizedValue);
 
     // Connect to parameter changes from the host
-    param_connection_ = param_info_.on_value_changed.connect([this](float value) {
+    param_connection_ = param_info_->on_value_changed.connect([this](float value) {
         // Update slider when parameter changes externally
         const float normalizedValue =
-            (value - this->param_info_.minValue) / (this->param_info_.maxValue - this->param_info_.minValue);
+            (value - this->param_info_->minValue) / (this->param_info_->maxValue - this->param_info_->minValue);
         this->slider_.setValue(normalizedValue);
     });
 }
 
+void ParamSlider::detachDrag() {
+    // A drag in progress ends on the parameter it started on, not the one the row is rebound to
+    if (!gesture_active_) return;
+    param_info_->endGesture();
+    gesture_active_ = false;
+    drag_detached_ = true;
+}
+
+void ParamSlider::setParameter(ParamInfo& paramInfo) {
+    detachDrag();
+    param_info_ = &paramInfo;
+    param_text_box_.setParameter(paramInfo);
+    connectParameter();
+}
+
+void ParamSlider::disconnect() {
+    detachDrag();
+    param_connection_.disconnect();
+    param_text_box_.disconnect();
+}
+
 void ParamSlider::draw(applause::Canvas& canvas) {}
 
 void ParamSlider::resized() {
@@ -20,14 +20,31 @@ public:
     void resized() override;
     void draw(applause::Canvas& canvas) override;
 
+    /**
+     * Controls paramInfo instead, e.g. when a recycled row is rebound. A drag in progress has its gesture ended on
+     * the previous parameter, and the rest of it is ignored.
+     */
+    void setParameter(ParamInfo& paramInfo);
+
+    /** Stops following the parameter until the next setParameter(), ending a drag's gesture on it. */
+    void disconnect();
+
+    /** Hands the slider's drawing to batch (see DrawBatch), or takes it back with nullptr. */
+    void setDrawBatch(DrawBatch* batch) { slider_.setDrawBatch(batch); }
+
 private:
+    void connectParameter();
+    void detachDrag();
+
     static constexpr int kLabelWidth = 80;
     static constexpr int kLabelPadding = 5;
 
-    ParamInfo& param_info_;
+    ParamInfo* param_info_;
     Slider slider_;
     ParamValueTextBox param_text_box_;
     rocket::scoped_connection param_connection_;
+    bool gesture_active_ = false;  // Between a drag's start and end, with the gesture open on param_info_
+    bool drag_detached_ = false;   // The row was rebound mid-drag; the drag's remaining values are ignored
 };
 
 }  // namespace applause
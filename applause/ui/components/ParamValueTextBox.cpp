@@ -2,6 +2,7 @@
 
 #include <applause/ui/ApplauseUI.h>
 
+#include <applause/ui/FontCache.h>
 #include <embedded/applause_fonts.h>
 
 #include <cmath>
@@ -11,10 +12,10 @@
 
 namespace applause {
 
-ParamValueTextBox::ParamValueTextBox(ParamInfo& paramInfo) : param_info_(paramInfo) {
+ParamValueTextBox::ParamValueTextBox(ParamInfo& paramInfo) : param_info_(&paramInfo) {
     text_editor_.setMultiLine(false);
     text_editor_.setJustification(applause::Font::kCenter);
-    text_editor_.setFont(applause::Font(12, applause::fonts::Jost_Regular_ttf));
+    text_editor_.setFont(FontCache::get(12, applause::fonts::Jost_Regular_ttf));
     text_editor_.setMargin(0, 0);
 
     addChild(&text_editor_);
@@ -26,26 +27,26 @@ ParamValueTextBox::ParamValueTextBox(ParamInfo& paramInfo) : param_info_(paramIn
         if (!is_editing_) return;
 
         // Try to parse the entered text
-        auto parsed_value = param_info_.textToValue(text_editor_.text().toUtf8());
+        auto parsed_value = param_info_->textToValue(text_editor_.text().toUtf8());
 
         if (parsed_value.has_value()) {
             // Valid value entered - apply it
-            param_info_.setValueNotifyingHost(parsed_value.value());
+            param_info_->setValueNotifyingHost(parsed_value.value());
         }
 
         // Update display to show formatted value
         updateTextDisplay();
         is_editing_ = false;
-        param_info_.endGesture();
+        param_info_->endGesture();
     };
 
     // Set up TextEditor callbacks
     text_editor_.onTextChange() += [this]() {
         if (!is_editing_) {
             // Save original value when editing starts
-            original_value_ = param_info_.getValue();
+            original_value_ = param_info_->getValue();
             is_editing_ = true;
-            param_info_.beginGesture();
+            param_info_->beginGesture();
         }
     };
 
@@ -59,16 +60,20 @@ ParamValueTextBox::ParamValueTextBox(ParamInfo& paramInfo) : param_info_(paramIn
 
     text_editor_.onEscapeKey() += [this]() {
         // Restore original value
-        param_info_.setValueNotifyingHost(original_value_);
+        param_info_->setValueNotifyingHost(original_value_);
 
         // Update display to show original value
         updateTextDisplay();
         is_editing_ = false;
-        param_info_.endGesture();
+        param_info_->endGesture();
     };
 
+    connectParameter();
+}
+
+void ParamValueTextBox::connectParameter() {
     // Connect to parameter changes from the host
-    param_connection_ = param_info_.on_value_changed.connect([this](float value) {
+    param_connection_ = param_info_->on_value_changed.connect([this](float value) {
         // Update text display if not currently editing
         if (!this->is_editing_) {
             this->updateTextDisplay();
@@ -76,8 +81,25 @@ ParamValueTextBox::ParamValueTextBox(ParamInfo& paramInfo) : param_info_(paramIn
     });
 }
 
+void ParamValueTextBox::setParameter(ParamInfo& paramInfo) {
+    disconnect();
+    param_info_ = &paramInfo;
+    updateTextDisplay();
+    connectParameter();
+}
+
+void ParamValueTextBox::disconnect() {
+    param_connection_.disconnect();
+    if (is_editing_) {
+        // Drop the uncommitted text rather than applying it to a parameter the user no longer sees
+        is_editing_ = false;
+        param_info_->endGesture();
+        updateTextDisplay();
+    }
+}
+
 void ParamValueTextBox::updateTextDisplay() {
-    std::string formatted = param_info_.valueToText(param_info_.getValue());
+    std::string formatted = param_info_->valueToText(param_info_->getValue());
     text_editor_.setText(formatted);
 }
 
@@ -25,8 +25,16 @@ public:
     /** Force update the displayed text to match the current parameter value */
     void updateTextDisplay();
 
+    /** Shows and edits paramInfo instead, e.g. when a recycled row is rebound. */
+    void setParameter(ParamInfo& paramInfo);
+
+    /** Stops following the parameter until the next setParameter(), ending any edit in progress. */
+    void disconnect();
+
 private:
-    ParamInfo& param_info_;
+    void connectParameter();
+
+    ParamInfo* param_info_;
     applause::TextEditor text_editor_{"param_value"};
     rocket::scoped_connection param_connection_;
 
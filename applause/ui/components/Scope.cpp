@@ -0,0 +1,88 @@
+#include "Scope.h"
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/inspector/DrawProfiler.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace applause {
+
+APPLAUSE_THEME_IMPLEMENT_COLOR(Scope, ApplauseScopeTrace, 0xff9966ff);
+APPLAUSE_THEME_IMPLEMENT_COLOR(Scope, ApplauseScopeCenterLine, 0xff333338);
+
+Scope::Scope(ScopeBuffer& buffer, uint32_t channel) : buffer_(buffer), channel_(channel) {
+    ASSERT(channel < buffer.getNumChannels(), "Scope channel out of range");
+    setIgnoresMouseEvents(true, false);
+    setWindow(std::min(buffer.getCapacity(), 1024u));
+}
+
+void Scope::setWindow(uint32_t frames) {
+    window_frames_ = std::clamp(frames, 1u, buffer_.getCapacity());
+    window_.assign(static_cast<size_t>(window_frames_) * buffer_.getNumChannels(), 0.0f);
+    window_ptrs_.resize(buffer_.getNumChannels());
+    for (uint32_t ch = 0; ch < buffer_.getNumChannels(); ++ch) {
+        window_ptrs_[ch] = window_.data() + static_cast<size_t>(ch) * window_frames_;
+    }
+    num_samples_ = 0;
+    read_position_ = 0;
+    redraw();
+}
+
+void Scope::setAmplitude(float amplitude) {
+    amplitude_ = std::max(amplitude, 1e-6f);
+    redraw();
+}
+
+bool Scope::update() {
+    const uint64_t position = buffer_.getWritePosition();
+    if (position == read_position_) return false;
+    const uint32_t read = buffer_.readLatest(window_ptrs_.data(), window_frames_);
+    if (read == 0) return false;  // overwritten while copying; try again next frame
+    read_position_ = position;
+    num_samples_ = read;
+    APPLAUSE_PROFILE_REDRAW("scope data");
+    redraw();
+    return true;
+}
+
+void Scope::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
+    poller_.onDraw();
+
+    const float mid = height() * 0.5f;
+    const float scale = mid / amplitude_;
+    canvas.setColor(ApplauseScopeCenterLine);
+    canvas.rectangle(0, std::floor(mid), width(), 1);
+
+    const auto columns = static_cast<int>(width());
+    if (num_samples_ == 0 || columns <= 0) return;
+
+    // A window that isn't full yet fills the width from the right, so the newest sample is always at the right edge
+    const float* samples = window_ptrs_[channel_];
+    const float samples_per_column = static_cast<float>(window_frames_) / columns;
+    const float missing = static_cast<float>(window_frames_ - num_samples_);
+
+    canvas.setColor(ApplauseScopeTrace);
+    for (int x = 0; x < columns; ++x) {
+        // Include the last sample of the previous column so steep edges stay connected
+        const float start = x * samples_per_column - missing;
+        const float end = (x + 1) * samples_per_column - missing;
+        if (end <= 0.0f) continue;
+        const auto first = static_cast<uint32_t>(std::max(0.0f, std::floor(start) - 1.0f));
+        const auto last = std::min(num_samples_, static_cast<uint32_t>(std::ceil(end)) + 1);
+        float lo = samples[first];
+        float hi = lo;
+        for (uint32_t i = first + 1; i < last; ++i) {
+            lo = std::min(lo, samples[i]);
+            hi = std::max(hi, samples[i]);
+        }
+        const float top = std::clamp(mid - hi * scale, 0.0f, height());
+        const float bottom = std::clamp(mid - lo * scale, 0.0f, height());
+        canvas.rectangle(x, top, 1, std::max(1.0f, bottom - top));
+    }
+}
+
+}  // namespace applause
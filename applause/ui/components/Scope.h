@@ -0,0 +1,51 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/ui/components/FramePoller.h>
+#include <applause/util/ScopeBuffer.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace applause {
+
+/**
+ * An oscilloscope drawing the newest window of one channel of a ScopeBuffer.
+ *
+ * Once per frame of the enclosing ApplauseEditor it copies the window out of the buffer, if the audio thread
+ * pushed anything since, and redraws. The trace is drawn as one rectangle per pixel column spanning the samples'
+ * minimum to maximum, so the cost depends on the width rather than the number of samples, and the rectangles
+ * batch into a single draw. Draws with a transparent background so the parent can render a grid behind it.
+ */
+class Scope : public applause::Frame {
+public:
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseScopeTrace);
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseScopeCenterLine);
+
+    explicit Scope(ScopeBuffer& buffer, uint32_t channel = 0);
+
+    void draw(applause::Canvas& canvas) override;
+
+    /** Frames (after the buffer's decimation) shown across the width; at most the buffer's capacity. */
+    void setWindow(uint32_t frames);
+
+    /** The amplitude at the top and bottom edges; 1 by default. */
+    void setAmplitude(float amplitude);
+
+    /** Copies the newest window out of the buffer and redraws if anything was pushed. Returns whether it redrew. */
+    bool update();
+
+private:
+    ScopeBuffer& buffer_;
+    uint32_t channel_;
+    float amplitude_ = 1.0f;
+    uint32_t num_samples_ = 0;  // valid samples in the window
+    uint64_t read_position_ = 0;
+    std::vector<float> window_;  // every channel of the buffer, as readLatest() needs them
+    std::vector<float*> window_ptrs_;
+    uint32_t window_frames_ = 0;
+    FramePoller poller_{*this, [this] { return update(); }};
+};
+
+}  // namespace applause
@@ -2,6 +2,8 @@
 
 #include <applause/ui/ApplauseUI.h>
 
+#include <applause/util/inspector/DrawProfiler.h>
+
 #include <algorithm>
 #include <cmath>
 
@@ -31,7 +33,7 @@ void Slider::mouseDown(const applause::MouseEvent& event) {
             value_ = resetValue;
             on_value_changed.callback(value_);
             on_drag_ended.callback();
-            redraw();
+            requestRedraw();
         }
         return;
     }
@@ -40,7 +42,7 @@ void Slider::mouseDown(const applause::MouseEvent& event) {
     glow_amount_.target(true);
     on_drag_started.callback();
     processDrag(event.position.x);
-    redraw();
+    requestRedraw();
 }
 
 void Slider::mouseDrag(const applause::MouseEvent& event) {
@@ -56,7 +58,7 @@ void Slider::mouseUp(const applause::MouseEvent& event) {
     on_drag_ended.callback();
     processDrag(event.position.x);
     if (!hovering_) glow_amount_.target(false);
-    redraw();
+    requestRedraw();
 }
 
 bool Slider::mouseWheel(const applause::MouseEvent& event) {
@@ -69,7 +71,7 @@ bool Slider::mouseWheel(const applause::MouseEvent& event) {
         on_drag_started.callback();
         value_ = newValue;
         on_value_changed.callback(value_);
-        redraw();
+        requestRedraw();
         on_drag_ended.callback();
         return true;
     }
@@ -81,7 +83,8 @@ void Slider::setValue(float value) {
         value_ = std::clamp(value, -1.0f, 1.0f);
     else
         value_ = std::clamp(value, 0.0f, 1.0f);
-    redraw();
+    APPLAUSE_PROFILE_REDRAW("value");
+    requestRedraw();
 }
 
 void Slider::setDefaultValue(float value) {
@@ -89,7 +92,7 @@ void Slider::setDefaultValue(float value) {
         default_value_ = std::clamp(value, -1.0f, 1.0f);
     else
         default_value_ = std::clamp(value, 0.0f, 1.0f);
-    redraw();
+    requestRedraw();
 }
 
 void Slider::setBipolar(bool bipolar) {
@@ -97,7 +100,7 @@ void Slider::setBipolar(bool bipolar) {
         bipolar_ = bipolar;
         value_ = 0.0f;
         default_value_ = std::clamp(default_value_, bipolar_ ? -1.0f : 0.0f, 1.0f);
-        redraw();
+        requestRedraw();
     }
 }
 
@@ -114,26 +117,47 @@ void Slider::processDrag(float raw_drag_pos) {
     }
 
     on_value_changed.callback(value_);
-    redraw();
+    requestRedraw();
 }
 
 void Slider::mouseEnter(const applause::MouseEvent& event) {
     if (!active_) return;
     hovering_ = true;
     glow_amount_.target(true);
-    redraw();
+    APPLAUSE_PROFILE_REDRAW("hover");
+    requestRedraw();
 }
 
 void Slider::mouseExit(const applause::MouseEvent& event) {
     if (!active_) return;
     hovering_ = false;
     if (!dragging_) glow_amount_.target(false);
-    redraw();
+    APPLAUSE_PROFILE_REDRAW("hover");
+    requestRedraw();
+}
+
+void Slider::prepareDraw(applause::Canvas& canvas) {
+    glow_amount_.update();
+    if (glow_amount_.isAnimating()) {
+        APPLAUSE_PROFILE_REDRAW("animation");
+        requestRedraw();
+    }
 }
 
-void Slider::draw(applause::Canvas& canvas) {
+void Slider::drawPass(applause::Canvas& canvas, int pass) {
     auto sample = [&](auto id) { return canvas.color(id).gradient().sample(0.0f); };
 
+    // Inactive sliders draw the same shapes, dimmed, without shadow or glow
+    constexpr float kInactiveDim = 0.2f;
+    const applause::Color black(0xff000000);
+    auto dimmed = [&](auto id) { return sample(id).interpolateWith(black, kInactiveDim); };
+    auto setColor = [&](auto id) {
+        if (active_)
+            canvas.setColor(id);
+        else
+            canvas.setColor(dimmed(id));
+    };
+
     float usable = width() - kThumbDiameter;
     float trackY = (height() - kTrackHeight) * 0.5f;
     float trackRounding = kTrackHeight * 0.5f;
@@ -151,82 +175,56 @@ void Slider::draw(applause::Canvas& canvas) {
     float thumbX = tcx - kThumbRadius;
     float thumbY = centerY - kThumbRadius;
 
-    if (!active_) {
-        constexpr float kInactiveDim = 0.2f;
-        applause::Color black(0xff000000);
-
-        canvas.setColor(sample(ApplauseSliderTrack).interpolateWith(black, kInactiveDim));
+    switch (static_cast<DrawPass>(pass)) {
+    case DrawPass::Track:
+        setColor(ApplauseSliderTrack);
         canvas.roundedRectangle(0, trackY, width(), kTrackHeight, trackRounding);
-
+        break;
+    case DrawPass::Fill:
+        // Accent fill, from the center when bipolar
         if (bipolar_) {
             float centerX = width() * 0.5f;
             float fillW = std::abs(tcx - centerX);
-            if (fillW > 0.0f) {
-                canvas.setColor(sample(ApplauseSliderAccent).interpolateWith(black, kInactiveDim));
+            if (value_ != 0.0f && fillW > 0.0f) {
+                setColor(ApplauseSliderAccent);
                 canvas.roundedRectangle(value_ > 0.0f ? centerX : tcx, trackY, fillW, kTrackHeight, trackRounding);
             }
         } else if (value_ > 0.0f) {
-            canvas.setColor(sample(ApplauseSliderAccent).interpolateWith(black, kInactiveDim));
+            setColor(ApplauseSliderAccent);
             canvas.roundedRectangle(0, trackY, tcx, kTrackHeight, trackRounding);
         }
-
-        canvas.setColor(
-            applause::Brush::vertical(sample(ApplauseSliderThumbTop).interpolateWith(black, kInactiveDim),
-                                    sample(ApplauseSliderThumbBottom).interpolateWith(black, kInactiveDim)));
-        canvas.circle(thumbX, thumbY, kThumbDiameter);
-
-        canvas.setColor(sample(ApplauseSliderThumbBorder).interpolateWith(black, kInactiveDim));
-        canvas.ring(thumbX, thumbY, kThumbDiameter, 1.0f);
-        return;
+        break;
+    case DrawPass::Shadow: {
+        if (!active_) break;
+        // Thumb drop shadow
+        float shadowOffset = 3.0f;
+        float shadowPad = 2.0f;
+        float shadowDiameter = kThumbDiameter + shadowPad * 2.0f;
+        canvas.setColor(0x88000000);
+        canvas.fadeCircle(tcx - shadowDiameter * 0.5f, centerY - shadowDiameter * 0.5f + shadowOffset, shadowDiameter,
+                          8.0f);
+        break;
     }
-
-    // Track background
-    canvas.setColor(ApplauseSliderTrack);
-    canvas.roundedRectangle(0, trackY, width(), kTrackHeight, trackRounding);
-
-    // Accent fill
-    if (bipolar_) {
-        float centerX = width() * 0.5f;
-        if (value_ > 0.0f) {
-            float fillW = tcx - centerX;
-            if (fillW > 0.0f) {
-                canvas.setColor(ApplauseSliderAccent);
-                canvas.roundedRectangle(centerX, trackY, fillW, kTrackHeight, trackRounding);
-            }
-        } else if (value_ < 0.0f) {
-            float fillW = centerX - tcx;
-            if (fillW > 0.0f) {
-                canvas.setColor(ApplauseSliderAccent);
-                canvas.roundedRectangle(tcx, trackY, fillW, kTrackHeight, trackRounding);
-            }
-        }
-    } else {
-        if (value_ > 0.0f) {
-            canvas.setColor(ApplauseSliderAccent);
-            canvas.roundedRectangle(0, trackY, tcx, kTrackHeight, trackRounding);
+    case DrawPass::Thumb:
+        // Thumb body (vertical gradient)
+        if (active_) {
+            canvas.setColor(
+                applause::Brush::vertical(sample(ApplauseSliderThumbTop), sample(ApplauseSliderThumbBottom)));
+        } else {
+            canvas.setColor(
+                applause::Brush::vertical(dimmed(ApplauseSliderThumbTop), dimmed(ApplauseSliderThumbBottom)));
         }
-    }
-
-    // Thumb drop shadow
-    float shadowOffset = 3.0f;
-    float shadowPad = 2.0f;
-    float shadowDiameter = kThumbDiameter + shadowPad * 2.0f;
-    canvas.setColor(0x88000000);
-    canvas.fadeCircle(tcx - shadowDiameter * 0.5f, centerY - shadowDiameter * 0.5f + shadowOffset, shadowDiameter,
-                      8.0f);
-
-    // Thumb body (vertical gradient)
-    canvas.setColor(applause::Brush::vertical(sample(ApplauseSliderThumbTop), sample(ApplauseSliderThumbBottom)));
-    canvas.circle(thumbX, thumbY, kThumbDiameter);
-
-    // Thumb border ring
-    canvas.setColor(ApplauseSliderThumbBorder);
-    canvas.ring(thumbX, thumbY, kThumbDiameter, 1.0f);
-
-    // Animated glow overlay
-    glow_amount_.update();
-    float glowAlpha = glow_amount_.value();
-    if (glowAlpha > 0.0f) {
+        canvas.circle(thumbX, thumbY, kThumbDiameter);
+        break;
+    case DrawPass::Border:
+        // Thumb border ring
+        setColor(ApplauseSliderThumbBorder);
+        canvas.ring(thumbX, thumbY, kThumbDiameter, 1.0f);
+        break;
+    case DrawPass::Glow: {
+        // Animated glow overlay
+        float glowAlpha = glow_amount_.value();
+        if (!active_ || glowAlpha <= 0.0f) break;
         applause::Color accent = sample(ApplauseSliderAccent);
         applause::Gradient glow;
         glow.addColorStop(accent.withAlpha(glowAlpha * 0.35f), 0.0f);
@@ -235,8 +233,11 @@ void Slider::draw(applause::Canvas& canvas) {
         applause::Point center = {tcx, centerY};
         canvas.setColor(applause::Brush::radial(glow, center, kThumbRadius, kThumbRadius));
         canvas.circle(thumbX, thumbY, kThumbDiameter);
+        break;
+    }
+    case DrawPass::Count:
+        break;
     }
-    if (glow_amount_.isAnimating()) redraw();
 }
 
 }  // namespace applause
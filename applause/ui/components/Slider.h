@@ -1,6 +1,7 @@
 #pragma once
 
 #include <applause/ui/ApplauseUI.h>
+#include <applause/ui/components/DrawBatch.h>
 
 namespace applause {
 
@@ -8,8 +9,10 @@ namespace applause {
  * A horizontal slider with a circular thumb and track, styled like a classic JUCE slider.
  * The usable pixel range is inset by the thumb radius on both sides so the thumb
  * never extends past the component bounds.
+ *
+ * Sliders are BatchableFrames: a page with many of them can hand their drawing to one DrawBatch.
  */
-class Slider : public applause::Frame {
+class Slider : public BatchableFrame {
 public:
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseSliderThumbTop);
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseSliderThumbBottom);
@@ -19,7 +22,6 @@ public:
 
     Slider();
 
-    void draw(applause::Canvas& canvas) override;
     void resized() override;
     void mouseDown(const applause::MouseEvent& event) override;
     void mouseDrag(const applause::MouseEvent& event) override;
@@ -39,7 +41,7 @@ public:
 
     void setActive(bool active) {
         active_ = active;
-        redraw();
+        requestRedraw();
     }
     bool isActive() const { return active_; }
 
@@ -47,7 +49,14 @@ public:
     applause::CallbackList<void()> on_drag_started;
     applause::CallbackList<void()> on_drag_ended;
 
+protected:
+    [[nodiscard]] int numDrawPasses() const override { return static_cast<int>(DrawPass::Count); }
+    void prepareDraw(applause::Canvas& canvas) override;
+    void drawPass(applause::Canvas& canvas, int pass) override;
+
 private:
+    enum class DrawPass { Track, Fill, Shadow, Thumb, Border, Glow, Count };
+
     void processDrag(float raw_drag_pos);
 
     bool active_ = true;
@@ -0,0 +1,78 @@
+#include "SpectrumDisplay.h"
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/inspector/DrawProfiler.h>
+
+#include <algorithm>
+
+namespace applause {
+
+APPLAUSE_THEME_IMPLEMENT_COLOR(SpectrumDisplay, ApplauseSpectrumBar, 0xff4a6a8a);
+APPLAUSE_THEME_IMPLEMENT_COLOR(SpectrumDisplay, ApplauseSpectrumOverlay, 0xffffcc66);
+
+SpectrumDisplay::SpectrumDisplay(SpectrumAnalyzer& analyzer)
+    : analyzer_(analyzer), bins_db_(analyzer.getNumBins(), analyzer.getConfig().floor_db) {
+    setIgnoresMouseEvents(true, false);
+}
+
+void SpectrumDisplay::setRange(float min_db, float max_db) {
+    min_db_ = min_db;
+    max_db_ = std::max(max_db, min_db + 1.0f);
+    redraw();
+}
+
+void SpectrumDisplay::setOverlay(std::span<const float> magnitudes_db) {
+    ASSERT(magnitudes_db.empty() || magnitudes_db.size() == bins_db_.size(),
+           "SpectrumDisplay overlay needs one value per analyzer bin");
+    overlay_db_.assign(magnitudes_db.begin(), magnitudes_db.end());
+    redraw();
+}
+
+bool SpectrumDisplay::update() {
+    if (analyzer_.getVersion() == version_) return false;
+    version_ = analyzer_.readSpectrum(bins_db_);
+    APPLAUSE_PROFILE_REDRAW("spectrum");
+    redraw();
+    return true;
+}
+
+float SpectrumDisplay::levelToY(float db) const {
+    const float t = std::clamp((db - min_db_) / (max_db_ - min_db_), 0.0f, 1.0f);
+    return (1.0f - t) * height();
+}
+
+void SpectrumDisplay::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
+    poller_.onDraw();
+
+    const auto num_bins = static_cast<float>(bins_db_.size());
+    if (bins_db_.empty() || width() <= 0.0f) return;
+    const float bin_width = width() / num_bins;
+
+    // Nothing published yet draws no bars, rather than a wall at the floor level
+    if (version_ > 0) {
+        canvas.setColor(ApplauseSpectrumBar);
+        for (size_t b = 0; b < bins_db_.size(); ++b) {
+            const float top = levelToY(bins_db_[b]);
+            if (top >= height()) continue;
+            const float left = static_cast<float>(b) * bin_width;
+            canvas.rectangle(left, top, std::max(1.0f, bin_width - 1.0f), height() - top);
+        }
+    }
+
+    if (overlay_db_.size() < 2) return;
+    canvas.setColor(ApplauseSpectrumOverlay);
+    float prev_x = 0.5f * bin_width;
+    float prev_y = levelToY(overlay_db_[0]);
+    for (size_t b = 1; b < overlay_db_.size(); ++b) {
+        const float x = (static_cast<float>(b) + 0.5f) * bin_width;
+        const float y = levelToY(overlay_db_[b]);
+        canvas.segment(prev_x, prev_y, x, y, 1.5f, true);
+        prev_x = x;
+        prev_y = y;
+    }
+}
+
+}  // namespace applause
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#include <applause/dsp/SpectrumAnalyzer.h>
+#include <applause/ui/components/FramePoller.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace applause {
+
+/**
+ * Draws the newest spectrum of a SpectrumAnalyzer as one bar per analyzer bin, with an optional curve on top (e.g.
+ * an EQ's magnitudeResponseDb() evaluated at getBinFrequencies()).
+ *
+ * The FFT runs on the analyzer's thread; once per frame of the enclosing ApplauseEditor this only polls the
+ * analyzer's version and, when a new spectrum was published, copies the bins and redraws. Bins are spread evenly
+ * across the width, which is logarithmic in frequency because the analyzer spaces them that way.
+ */
+class SpectrumDisplay : public applause::Frame {
+public:
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseSpectrumBar);
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseSpectrumOverlay);
+
+    explicit SpectrumDisplay(SpectrumAnalyzer& analyzer);
+
+    void draw(applause::Canvas& canvas) override;
+
+    /** The levels at the bottom and top edges; -90 to 6 dB by default. */
+    void setRange(float min_db, float max_db);
+
+    /** A curve drawn over the bars, one value in dB per analyzer bin; an empty span removes it. */
+    void setOverlay(std::span<const float> magnitudes_db);
+
+    /** Copies the newest spectrum and redraws if the analyzer published one. Returns whether it redrew. */
+    bool update();
+
+private:
+    [[nodiscard]] float levelToY(float db) const;
+
+    SpectrumAnalyzer& analyzer_;
+    float min_db_ = -90.0f;
+    float max_db_ = 6.0f;
+    uint64_t version_ = 0;
+    std::vector<float> bins_db_;
+    std::vector<float> overlay_db_;
+    FramePoller poller_{*this, [this] { return update(); }};
+};
+
+}  // namespace applause
@@ -334,7 +334,7 @@ void TextEditor::deleteSelected() {
     applause::String before = text_.text().substring(0, selectionStart());
     applause::String after = text_.text().substring(selectionEnd());
     text_.setText(before + after);
-    setLineBreaks();
+    updateLineBreaks(selectionStart(), selectionEnd() - selectionStart(), 0);
     caret_position_ = selectionStart();
     selection_position_ = caret_position_;
     makeCaretVisible();
@@ -342,6 +342,43 @@ void TextEditor::deleteSelected() {
     on_text_change_.callback();
 }
 
+void TextEditor::updateLineBreaks(int start, int removed, int inserted) {
+    if (!text_.multiLine() || !text_.font().packedFont())
+        return;
+    if (width() - 2 * xMargin() != line_break_width_) {
+        setLineBreaks();
+        return;
+    }
+
+    // Lines wrap independently between hard newlines, so only the paragraphs from the one the edit starts in to
+    // the one it ends in can change: from after the newline before the edit through the newline after it
+    const applause::String& text = text_.text();
+    const int length = text.length();
+    int paragraph_start = start;
+    while (paragraph_start > 0 && !applause::Font::isNewLine(text[paragraph_start - 1]))
+        paragraph_start--;
+    int paragraph_end = start + inserted;
+    while (paragraph_end < length && !applause::Font::isNewLine(text[paragraph_end]))
+        paragraph_end++;
+    if (paragraph_end < length)
+        paragraph_end++;
+
+    // Breaks up to the paragraph start are unchanged, the ones past its old end move by the edit's length
+    const int shift = inserted - removed;
+    auto first = std::upper_bound(line_breaks_.begin(), line_breaks_.end(), paragraph_start);
+    auto last = std::upper_bound(first, line_breaks_.end(), paragraph_end - shift);
+    for (auto it = last; it != line_breaks_.end(); ++it)
+        *it += shift;
+
+    std::vector<int> rewrapped = text_.font().lineBreaks(text.c_str() + paragraph_start,
+                                                         paragraph_end - paragraph_start, line_break_width_);
+    for (int& line_break : rewrapped)
+        line_break += paragraph_start;
+
+    first = line_breaks_.erase(first, last);
+    line_breaks_.insert(first, rewrapped.begin(), rewrapped.end());
+}
+
 void TextEditor::makeCaretVisible() {
     if (font().packedFont() == nullptr || width() == 0.0f || height() == 0.0f)
         return;
@@ -888,7 +925,7 @@ void TextEditor::insertTextAtCaret(const applause::String& insert_text) {
 
     applause::String trimmed = text.substring(0, max_text);
     text_.setText(before + trimmed + after);
-    setLineBreaks();
+    updateLineBreaks(before.length(), selectionEnd() - selectionStart(), max_text);
     caret_position_ = before.length() + max_text;
     selection_position_ = caret_position_;
     makeCaretVisible();
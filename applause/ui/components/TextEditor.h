@@ -118,6 +118,7 @@ public:
         applause::Font f = font().withDpiScale(dpiScale());
         text_.setFont(f);
         default_text_.setFont(f);
+        line_break_width_ = -1.0f;  // the next edit rewraps everything
     }
 
     void mouseEnter(const applause::MouseEvent& e) override;
@@ -190,11 +191,15 @@ public:
 
     void setLineBreaks() {
         if (text_.multiLine() && text_.font().packedFont()) {
-            line_breaks_ = text_.font().lineBreaks(text_.text().c_str(), text_.text().length(),
-                                                   width() - 2 * xMargin());
+            line_break_width_ = width() - 2 * xMargin();
+            line_breaks_ = text_.font().lineBreaks(text_.text().c_str(), text_.text().length(), line_break_width_);
         }
     }
 
+    // After replacing `removed` characters at `start` with `inserted` new ones: rewraps only the paragraphs the edit
+    // touched and shifts the line breaks after them, so typing in a long text doesn't rewrap all of it
+    void updateLineBreaks(int start, int removed, int inserted);
+
     void setText(const applause::String& text) {
         if (max_characters_)
             text_.setText(text.substring(0, max_characters_));
@@ -212,6 +217,7 @@ public:
     void setMultiLine(bool multi_line) {
         text_.setMultiLine(multi_line);
         default_text_.setMultiLine(multi_line);
+        line_break_width_ = -1.0f;
         if (multi_line)
             x_position_ = 0;
     }
@@ -303,7 +309,8 @@ protected:
     applause::Text text_;
     applause::Text default_text_;
     std::string filtered_characters_;
-    std::vector<int> line_breaks_;
+    std::vector<int> line_breaks_;  // Index each wrapped line after the first starts at
+    float line_break_width_ = -1.0f;  // Width line_breaks_ was wrapped to
     int caret_position_ = 0;
     int selection_position_ = 0;
     std::pair<float, float> selection_start_point_;
@@ -2,6 +2,8 @@
 
 #include <applause/ui/ApplauseUI.h>
 
+#include <applause/util/inspector/DrawProfiler.h>
+
 #include <algorithm>
 #include <cmath>
 #include <vector>
@@ -14,6 +16,7 @@ APPLAUSE_THEME_IMPLEMENT_COLOR(MSEGDisplay, MSEGDisplayPoint, 0xffdddddd);
 APPLAUSE_THEME_IMPLEMENT_COLOR(MSEGDisplay, MSEGDisplayPointHover, 0xffffffff);
 APPLAUSE_THEME_IMPLEMENT_COLOR(MSEGDisplay, MSEGDisplayMidpoint, 0x99aaaaaa);
 APPLAUSE_THEME_IMPLEMENT_COLOR(MSEGDisplay, MSEGDisplayMidpointHover, 0xccdddddd);
+APPLAUSE_THEME_IMPLEMENT_COLOR(MSEGDisplay, MSEGDisplayPlayhead, 0xaaffffff);
 APPLAUSE_THEME_IMPLEMENT_VALUE(MSEGDisplay, MSEGDisplayLineWidth, 2.0f);
 APPLAUSE_THEME_IMPLEMENT_VALUE(MSEGDisplay, MSEGDisplayPointRadius, 5.0f);
 APPLAUSE_THEME_IMPLEMENT_VALUE(MSEGDisplay, MSEGDisplayMidpointRadius, 3.5f);
@@ -22,7 +25,32 @@ static constexpr int kSamplesPerSegment = 32;
 static constexpr float kPointEpsilon = 0.001f;
 static constexpr float kMaxCurvature = 32.0f;
 
-MSEGDisplay::MSEGDisplay(MSEGCurve<>* curve) : curve_(curve) {}
+MSEGDisplay::MSEGDisplay(MSEGCurve<>* curve) : curve_(curve) {
+    for (applause::Frame* layer : {&playhead_layer_, &handles_layer_}) {
+        layer->setIgnoresMouseEvents(true, false);
+        addChild(layer);
+    }
+    playhead_layer_.onDraw() = [this](applause::Canvas& canvas) { drawPlayhead(canvas); };
+    handles_layer_.onDraw() = [this](applause::Canvas& canvas) { drawHandles(canvas); };
+}
+
+void MSEGDisplay::resized() {
+    playhead_layer_.setBounds(localBounds());
+    handles_layer_.setBounds(localBounds());
+    invalidateCurve();
+}
+
+void MSEGDisplay::invalidateCurve() {
+    tessellation_dirty_ = true;
+    redraw();
+    handles_layer_.redraw();
+}
+
+void MSEGDisplay::setPlayhead(float phase) {
+    if (phase == playhead_) return;
+    playhead_ = phase;
+    playhead_layer_.redraw();
+}
 
 float MSEGDisplay::curveXToScreen(float cx) const {
     return cx * width();
@@ -60,88 +88,96 @@ int MSEGDisplay::hitTestPoint(float sx, float sy) const {
     return -1;
 }
 
-int MSEGDisplay::hitTestMidpoint(float sx, float sy) const {
+int MSEGDisplay::hitTestMidpoint(float sx, float sy) {
     if (!curve_ || curve_->num_points < 2)
         return -1;
+    updateTessellation();
     float hit_radius = paletteValue(MSEGDisplayMidpointRadius) * 1.5f;
     float hit_r2 = hit_radius * hit_radius;
-    for (int s = 0; s < curve_->num_points - 1; s++) {
-        float mid_x = (curve_->points[s].first + curve_->points[s + 1].first) * 0.5f;
-        float mid_y = curve_->evaluate(mid_x);
-        float px = curveXToScreen(mid_x);
-        float py = curveYToScreen(mid_y);
-        float dx = sx - px;
-        float dy = sy - py;
+    for (int s = 0; s < static_cast<int>(midpoints_.size()); s++) {
+        float dx = sx - midpoints_[s].x;
+        float dy = sy - midpoints_[s].y;
         if (dx * dx + dy * dy <= hit_r2)
             return s;
     }
     return -1;
 }
 
-void MSEGDisplay::draw(applause::Canvas& canvas) {
+void MSEGDisplay::updateTessellation() {
+    if (!tessellation_dirty_)
+        return;
+    tessellation_dirty_ = false;
+    samples_.clear();
+    midpoints_.clear();
+    fill_path_ = applause::Path();
     if (!curve_ || curve_->num_points < 2)
         return;
 
+    // Build polyline samples by walking each segment, without searching for it per sample
     int n = curve_->num_points;
-    float line_width = canvas.value(MSEGDisplayLineWidth);
-    float point_radius = canvas.value(MSEGDisplayPointRadius);
-
-    // Build polyline samples by evaluating the curve at many points
-    samples_.clear();
     samples_.reserve((n - 1) * kSamplesPerSegment + 1);
-
+    midpoints_.reserve(n - 1);
     for (int s = 0; s < n - 1; s++) {
         float x0 = curve_->points[s].first;
         float x1 = curve_->points[s + 1].first;
         int start = (s == 0) ? 0 : 1; // avoid duplicating shared endpoints
         for (int i = start; i <= kSamplesPerSegment; i++) {
-            float phase = x0 + (x1 - x0) * (static_cast<float>(i) / kSamplesPerSegment);
-            float y = curve_->evaluate(phase);
-            samples_.emplace_back(curveXToScreen(phase), curveYToScreen(y));
+            float t = static_cast<float>(i) / kSamplesPerSegment;
+            float y = x1 > x0 ? curve_->evaluateSegment(s, t) : curve_->points[s].second;
+            samples_.emplace_back(curveXToScreen(x0 + (x1 - x0) * t), curveYToScreen(y));
         }
+        float mid_y = curve_->evaluate((x0 + x1) * 0.5f);
+        midpoints_.emplace_back(curveXToScreen((x0 + x1) * 0.5f), curveYToScreen(mid_y));
     }
 
+    // Fill under the curve
+    fill_path_.moveTo(samples_[0].x, samples_[0].y);
+    for (size_t i = 1; i < samples_.size(); i++)
+        fill_path_.lineTo(samples_[i].x, samples_[i].y);
+    fill_path_.lineTo(samples_.back().x, static_cast<float>(height()));
+    fill_path_.lineTo(samples_[0].x, static_cast<float>(height()));
+    fill_path_.close();
+}
+
+void MSEGDisplay::draw(applause::Canvas& canvas) {
+    APPLAUSE_PROFILE_DRAW();
+    updateTessellation();
     if (samples_.empty())
         return;
 
-    // Fill under the curve
-    applause::Path fill_path;
-    fill_path.moveTo(samples_[0].x, samples_[0].y);
-    for (size_t i = 1; i < samples_.size(); i++)
-        fill_path.lineTo(samples_[i].x, samples_[i].y);
-    fill_path.lineTo(samples_.back().x, static_cast<float>(height()));
-    fill_path.lineTo(samples_[0].x, static_cast<float>(height()));
-    fill_path.close();
+    float line_width = canvas.value(MSEGDisplayLineWidth);
 
     applause::Color fill_color = canvas.color(MSEGDisplayFill).gradient().sample(0.0f);
     canvas.setColor(applause::Brush::vertical(fill_color, fill_color.withAlpha(0.0f)));
-    canvas.fill(fill_path);
+    canvas.fill(fill_path_);
 
     // Stroke the curve line as segments
     canvas.setColor(MSEGDisplayLine);
     for (size_t i = 0; i + 1 < samples_.size(); i++)
         canvas.segment(samples_[i].x, samples_[i].y, samples_[i + 1].x, samples_[i + 1].y, line_width, true);
+}
+
+void MSEGDisplay::drawHandles(applause::Canvas& canvas) {
+    updateTessellation();
+    if (samples_.empty())
+        return;
 
     // Draw midpoint handles for curvature adjustment
     float midpoint_radius = canvas.value(MSEGDisplayMidpointRadius);
     float midpoint_diameter = midpoint_radius * 2.0f;
-    for (int s = 0; s < n - 1; s++) {
-        float mid_x = (curve_->points[s].first + curve_->points[s + 1].first) * 0.5f;
-        float mid_y = curve_->evaluate(mid_x);
-        float px = curveXToScreen(mid_x);
-        float py = curveYToScreen(mid_y);
-
+    for (int s = 0; s < static_cast<int>(midpoints_.size()); s++) {
         if (s == hovered_midpoint_ || s == dragged_segment_)
             canvas.setColor(MSEGDisplayMidpointHover);
         else
             canvas.setColor(MSEGDisplayMidpoint);
 
-        canvas.circle(px - midpoint_radius, py - midpoint_radius, midpoint_diameter);
+        canvas.circle(midpoints_[s].x - midpoint_radius, midpoints_[s].y - midpoint_radius, midpoint_diameter);
     }
 
     // Draw point handles
+    float point_radius = canvas.value(MSEGDisplayPointRadius);
     float diameter = point_radius * 2.0f;
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < curve_->num_points; i++) {
         float px = curveXToScreen(curve_->points[i].first);
         float py = curveYToScreen(curve_->points[i].second);
 
@@ -154,13 +190,21 @@ void MSEGDisplay::draw(applause::Canvas& canvas) {
     }
 }
 
+void MSEGDisplay::drawPlayhead(applause::Canvas& canvas) {
+    if (playhead_ < 0.0f)
+        return;
+    float line_width = canvas.value(MSEGDisplayLineWidth);
+    canvas.setColor(MSEGDisplayPlayhead);
+    canvas.rectangle(curveXToScreen(playhead_) - line_width * 0.5f, 0.0f, line_width, static_cast<float>(height()));
+}
+
 void MSEGDisplay::mouseMove(const applause::MouseEvent& e) {
     int point_hit = hitTestPoint(e.position.x, e.position.y);
     int mid_hit = point_hit < 0 ? hitTestMidpoint(e.position.x, e.position.y) : -1;
     if (point_hit != hovered_point_ || mid_hit != hovered_midpoint_) {
         hovered_point_ = point_hit;
         hovered_midpoint_ = mid_hit;
-        redraw();
+        handles_layer_.redraw();
     }
 }
 
@@ -168,10 +212,24 @@ void MSEGDisplay::mouseExit(const applause::MouseEvent& e) {
     if (hovered_point_ != -1 || hovered_midpoint_ != -1) {
         hovered_point_ = -1;
         hovered_midpoint_ = -1;
-        redraw();
+        handles_layer_.redraw();
     }
 }
 
+void MSEGDisplay::setHandoff(MSEGCurveHandoff* handoff) {
+    handoff_ = handoff;
+    if (handoff_ && curve_)
+        handoff_->publish(*curve_);
+}
+
+void MSEGDisplay::curveChanged() {
+    if (handoff_) {
+        handoff_->publish(*curve_);
+    }
+    invalidateCurve();
+    on_curve_changed.callback();
+}
+
 void MSEGDisplay::mouseDown(const applause::MouseEvent& e) {
     if (!curve_)
         return;
@@ -191,8 +249,7 @@ void MSEGDisplay::mouseDown(const applause::MouseEvent& e) {
                 curve_->curvature_power[i] = curve_->curvature_power[i + 1];
             curve_->num_points--;
             hovered_point_ = -1;
-            on_curve_changed.callback();
-            redraw();
+            curveChanged();
         } else {
             // Add point
             if (curve_->num_points >= 64)
@@ -221,8 +278,7 @@ void MSEGDisplay::mouseDown(const applause::MouseEvent& e) {
             curve_->curvature_power[insert_idx] = 0.0f;
 
             curve_->num_points++;
-            on_curve_changed.callback();
-            redraw();
+            curveChanged();
         }
         return;
     }
@@ -259,8 +315,7 @@ void MSEGDisplay::mouseDrag(const applause::MouseEvent& e) {
         }
 
         curve_->points[dragged_point_] = {cx, cy};
-        on_curve_changed.callback();
-        redraw();
+        curveChanged();
         return;
     }
 
@@ -279,8 +334,7 @@ void MSEGDisplay::mouseDrag(const applause::MouseEvent& e) {
         float power = 2.0f * std::log((1.0f - u) / u);
         power = std::clamp(power, -kMaxCurvature, kMaxCurvature);
         curve_->curvature_power[dragged_segment_] = power;
-        on_curve_changed.callback();
-        redraw();
+        curveChanged();
     }
 }
 
@@ -288,7 +342,7 @@ void MSEGDisplay::mouseUp(const applause::MouseEvent& e) {
     dragged_point_ = -1;
     dragged_segment_ = -1;
     hovered_point_ = hitTestPoint(e.position.x, e.position.y);
-    redraw();
+    handles_layer_.redraw();
 }
 
 } // namespace applause
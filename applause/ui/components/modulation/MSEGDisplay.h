@@ -3,14 +3,20 @@
 #include <applause/ui/ApplauseUI.h>
 
 #include <applause/dsp/modulation/MSEGCurve.h>
+#include <applause/dsp/modulation/MSEGCurveHandoff.h>
 
 namespace applause {
 
 /// A reusable, context-agnostic MSEG curve editor.
 /// Draws and allows interactive editing of an MSEGCurve. Knows nothing about
 /// what the curve represents (LFO shape, envelope, etc.) — the parent component
-/// provides background grid, axis labels, playhead, and semantic meaning.
+/// provides background grid, axis labels, and semantic meaning.
 /// Draws with a transparent background so the parent can render behind it.
+///
+/// The curve is tessellated once and kept, with its fill path, until the curve,
+/// y range or size changes. Handles and the optional playhead are drawn on
+/// layers of their own, so hovering or a moving playhead doesn't redraw the
+/// curve. Call invalidateCurve() after changing the curve from outside.
 class MSEGDisplay : public applause::Frame {
 public:
     APPLAUSE_THEME_DEFINE_COLOR(MSEGDisplayLine);
@@ -19,6 +25,7 @@ public:
     APPLAUSE_THEME_DEFINE_COLOR(MSEGDisplayPointHover);
     APPLAUSE_THEME_DEFINE_COLOR(MSEGDisplayMidpoint);
     APPLAUSE_THEME_DEFINE_COLOR(MSEGDisplayMidpointHover);
+    APPLAUSE_THEME_DEFINE_COLOR(MSEGDisplayPlayhead);
     APPLAUSE_THEME_DEFINE_VALUE(MSEGDisplayLineWidth);
     APPLAUSE_THEME_DEFINE_VALUE(MSEGDisplayPointRadius);
     APPLAUSE_THEME_DEFINE_VALUE(MSEGDisplayMidpointRadius);
@@ -26,6 +33,7 @@ public:
     explicit MSEGDisplay(MSEGCurve<>* curve = nullptr);
 
     void draw(applause::Canvas& canvas) override;
+    void resized() override;
 
     void mouseDown(const applause::MouseEvent& e) override;
     void mouseDrag(const applause::MouseEvent& e) override;
@@ -33,10 +41,23 @@ public:
     void mouseMove(const applause::MouseEvent& e) override;
     void mouseExit(const applause::MouseEvent& e) override;
 
-    void setCurve(MSEGCurve<>* curve) { curve_ = curve; redraw(); }
+    void setCurve(MSEGCurve<>* curve) { curve_ = curve; invalidateCurve(); }
     MSEGCurve<>* curve() const { return curve_; }
 
-    void setYRange(float min, float max) { y_min_ = min; y_max_ = max; redraw(); }
+    /// Rebuilds the cached drawing at the next redraw. Edits made through the
+    /// display do this themselves.
+    void invalidateCurve();
+
+    /// Shows a playhead at phase (in curve x units); a negative phase hides it.
+    /// Only the playhead's layer redraws when it moves.
+    void setPlayhead(float phase);
+
+    /// Publishes a baked copy of the curve to handoff now and after every edit,
+    /// so modulators on the audio thread never read the curve being edited.
+    /// nullptr stops publishing.
+    void setHandoff(MSEGCurveHandoff* handoff);
+
+    void setYRange(float min, float max) { y_min_ = min; y_max_ = max; invalidateCurve(); }
     void allowAddRemovePoints(bool enabled) { point_editing_enabled_ = enabled; }
 
     applause::CallbackList<void()> on_curve_changed;
@@ -48,12 +69,21 @@ private:
     float screenXToCurve(float sx) const;
     float screenYToCurve(float sy) const;
 
+    // Publishes the edited curve, invalidates the drawing, then notifies on_curve_changed
+    void curveChanged();
+
+    // Rebuilds samples_, midpoints_ and fill_path_ if the curve or size changed
+    void updateTessellation();
+    void drawHandles(applause::Canvas& canvas);
+    void drawPlayhead(applause::Canvas& canvas);
+
     // Returns index of point near (sx, sy), or -1
     int hitTestPoint(float sx, float sy) const;
     // Returns segment index whose midpoint handle is near (sx, sy), or -1
-    int hitTestMidpoint(float sx, float sy) const;
+    int hitTestMidpoint(float sx, float sy);
 
     MSEGCurve<>* curve_ = nullptr;
+    MSEGCurveHandoff* handoff_ = nullptr;
 
     // Display settings
     float y_min_ = 0.0f;
@@ -65,8 +95,17 @@ private:
     int dragged_point_ = -1;
     int dragged_segment_ = -1;
     bool point_editing_enabled_ = true;
+    float playhead_ = -1.0f;
 
+    // Cached tessellation, in screen space
     std::vector<applause::Point> samples_;
+    std::vector<applause::Point> midpoints_;  // curvature handle of each segment
+    applause::Path fill_path_;
+    bool tessellation_dirty_ = true;
+
+    // Overlays above the curve, redrawn on their own
+    applause::Frame playhead_layer_;
+    applause::Frame handles_layer_;
 };
 
 } // namespace applause
\ No newline at end of file
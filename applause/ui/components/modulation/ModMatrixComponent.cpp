@@ -5,8 +5,12 @@
 #include <embedded/applause_fonts.h>
 
 #include <applause/ui/ApplauseEditor.h>
+#include <applause/ui/FontCache.h>
 #include <applause/ui/NativePopupMenu.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace applause::dimension;
 
 namespace applause {
@@ -22,7 +26,7 @@ static std::string connectionLabel(const ModMatrix& matrix, const ModConnection&
     return matrix.getSource(conn.src_idx).name + " -> " + conn.destination()->name;
 }
 
-ModMatrixComponent::Row::Row(ModMatrixComponent& owner, bool is_dummy) : owner_(owner), is_dummy(is_dummy) {
+ModMatrixComponent::Row::Row(ModMatrixComponent& owner) : owner_(owner) {
     setFlexLayout(true);
     layout().setFlexRows(false);
     layout().setFlexGap(paletteValue(ApplauseModMatrixColumnGap));
@@ -35,29 +39,6 @@ ModMatrixComponent::Row::Row(ModMatrixComponent& owner, bool is_dummy) : owner_(
         }
     };
 
-    dst_menu_.on_build_menu_ = [this](NativePopupMenu& menu) {
-        for (uint16_t i = 0; i < owner_.matrix_.getDestinationCount(); ++i) {
-            menu.addOption(i + 1, owner_.matrix_.getDestination(i).name);
-            if (dst_list_id >= 0 && i + 1 == dst_list_id) menu.select(true);
-        }
-
-        bool has_connections = false;
-        for (auto& conn : owner_.matrix_.getConnections()) {
-            if (!conn.isDepthMod()) {
-                has_connections = true;
-                break;
-            }
-        }
-        if (has_connections) {
-            menu.addBreak();
-            auto& sub = menu.addSubMenu("Connections");
-            for (auto& conn : owner_.matrix_.getConnections()) {
-                if (conn.isDepthMod()) continue;
-                sub.addOption(-(static_cast<int>(conn.depth_slot) + 1), connectionLabel(owner_.matrix_, conn));
-            }
-        }
-    };
-
     addChild(&src_menu_);
     src_menu_.layout().setFlexGrow(1.0f);
 
@@ -78,25 +59,70 @@ ModMatrixComponent::Row::Row(ModMatrixComponent& owner, bool is_dummy) : owner_(
     delete_button_.layout().setFlexGrow(0.0f);
     delete_button_.layout().setFlexShrink(0.0f);
 
-    if (is_dummy) {
-        setControlsActive(false);
+    // Handlers are installed once and dispatch on the row's current binding. Handlers of a bound row only edit
+    // the matrix: the change-set it fires updates this row, or releases it if the connection went away.
+    src_menu_.on_item_selected_ += [this](int id) {
+        if (!is_dummy) {
+            owner_.matrix_.reassignSource(conn, owner_.matrix_.getSource(id));
+            return;
+        }
+        src_list_id = id;
+        src_menu_.setText(owner_.matrix_.getSource(id).name);
+        if (src_list_id >= 0 && dst_list_id != 0) owner_.activateRow(this);
+    };
 
-        src_menu_.on_item_selected_ += [this](int id) {
-            src_list_id = id;
-            src_menu_.setText(owner_.matrix_.getSource(id).name);
-            if (src_list_id >= 0 && dst_list_id != 0) owner_.activateRow(this);
-        };
-        dst_menu_.on_item_selected_ += [this](int id) {
-            dst_list_id = id;
-            if (id < 0) {
-                auto slot = static_cast<uint16_t>(-(id + 1));
-                if (auto target = owner_.matrix_.findConnection(slot))
-                    dst_menu_.setText(connectionLabel(owner_.matrix_, *target));
-            } else {
-                dst_menu_.setText(owner_.matrix_.getDestination(id - 1).name);
-            }
-            if (src_list_id >= 0 && dst_list_id != 0) owner_.activateRow(this);
-        };
+    dst_menu_.on_item_selected_ += [this](int id) {
+        if (!is_dummy) {
+            if (id > 0 && !conn.isDepthMod())
+                owner_.matrix_.reassignDestination(conn, owner_.matrix_.getDestination(id - 1));
+            return;
+        }
+        dst_list_id = id;
+        if (id < 0) {
+            auto slot = static_cast<uint16_t>(-(id + 1));
+            if (auto target = owner_.matrix_.findConnection(slot))
+                dst_menu_.setText(connectionLabel(owner_.matrix_, *target));
+        } else {
+            dst_menu_.setText(owner_.matrix_.getDestination(id - 1).name);
+        }
+        if (src_list_id >= 0 && dst_list_id != 0) owner_.activateRow(this);
+    };
+
+    depth_slider_.on_value_changed += [this](float value) {
+        if (!is_dummy) conn.setDepth(value);
+    };
+
+    bipolar_toggle_.onToggle() += [this](Button*, bool on) {
+        if (!is_dummy) conn.setBipolar(on);
+    };
+
+    delete_button_.onToggle() += [this](Button*, bool) {
+        if (!is_dummy) owner_.matrix_.removeConnection(conn);
+    };
+
+    bindToDummy();
+}
+
+void ModMatrixComponent::Row::buildDestinationMenu(NativePopupMenu& menu) {
+    for (uint16_t i = 0; i < owner_.matrix_.getDestinationCount(); ++i) {
+        menu.addOption(i + 1, owner_.matrix_.getDestination(i).name);
+        if (dst_list_id >= 0 && i + 1 == dst_list_id) menu.select(true);
+    }
+
+    bool has_connections = false;
+    for (auto& c : owner_.matrix_.getConnections()) {
+        if (!c.isDepthMod()) {
+            has_connections = true;
+            break;
+        }
+    }
+    if (has_connections) {
+        menu.addBreak();
+        auto& sub = menu.addSubMenu("Connections");
+        for (auto& c : owner_.matrix_.getConnections()) {
+            if (c.isDepthMod()) continue;
+            sub.addOption(-(static_cast<int>(c.depth_slot) + 1), connectionLabel(owner_.matrix_, c));
+        }
     }
 }
 
@@ -105,14 +131,6 @@ void ModMatrixComponent::Row::bindToConnection(const ModConnection& c) {
     conn = c;
     src_list_id = c.src_idx;
 
-    // Drop any handlers left over from the dummy state (or a prior bind) so they
-    // don't re-fire activateRow and stack extra dummy rows on subsequent edits.
-    src_menu_.on_item_selected_.clear();
-    dst_menu_.on_item_selected_.clear();
-    depth_slider_.on_value_changed.clear();
-    bipolar_toggle_.onToggle().clear();
-    delete_button_.onToggle().clear();
-
     src_menu_.setText(owner_.matrix_.getSource(c.src_idx).name);
 
     if (c.isDepthMod()) {
@@ -125,43 +143,27 @@ void ModMatrixComponent::Row::bindToConnection(const ModConnection& c) {
     } else {
         dst_list_id = c.dst_idx + 1;
         dst_menu_.setText(owner_.matrix_.getDestination(c.dst_idx).name);
+        dst_menu_.on_build_menu_ = [this](NativePopupMenu& menu) { buildDestinationMenu(menu); };
     }
 
     depth_slider_.setValue(c.getDepth());
     bipolar_toggle_.setToggled(c.isBipolar());
     setControlsActive(true);
+}
 
-    depth_slider_.on_value_changed += [this](float value) { conn.setDepth(value); };
+void ModMatrixComponent::Row::bindToDummy() {
+    is_dummy = true;
+    conn = {};
+    src_list_id = -1;
+    dst_list_id = 0;
 
-    bipolar_toggle_.onToggle() += [this](Button*, bool on) { conn.setBipolar(on); };
+    src_menu_.setText("—");
+    dst_menu_.setText("—");
+    dst_menu_.on_build_menu_ = [this](NativePopupMenu& menu) { buildDestinationMenu(menu); };
 
-    src_menu_.on_item_selected_ += [this](int id) {
-        const uint16_t prev_slot = conn.depth_slot;
-        conn = owner_.matrix_.reassignSource(conn, owner_.matrix_.getSource(id));
-        if (conn.depth_slot != prev_slot) {  // merged into a peer; rebuild to drop this duplicate row
-            // Defer: rebuildRows would destroy this Row (and the CallbackList we're dispatching from).
-            applause::runOnEventThread([&owner = owner_] { owner.rebuildRows(); });
-            return;
-        }
-        src_list_id = id;
-        src_menu_.setText(owner_.matrix_.getSource(id).name);
-    };
-
-    if (!c.isDepthMod()) {
-        dst_menu_.on_item_selected_ += [this](int id) {
-            if (id <= 0) return;
-            const uint16_t prev_slot = conn.depth_slot;
-            conn = owner_.matrix_.reassignDestination(conn, owner_.matrix_.getDestination(id - 1));
-            if (conn.depth_slot != prev_slot) {
-                applause::runOnEventThread([&owner = owner_] { owner.rebuildRows(); });
-                return;
-            }
-            dst_list_id = id;
-            dst_menu_.setText(owner_.matrix_.getDestination(id - 1).name);
-        };
-    }
-
-    delete_button_.onToggle() += [this](Button*, bool) { owner_.deleteRow(this); };
+    depth_slider_.setValue(0.0f);
+    bipolar_toggle_.setToggled(false);
+    setControlsActive(false);
 }
 
 void ModMatrixComponent::Row::setControlsActive(bool active) {
@@ -171,17 +173,18 @@ void ModMatrixComponent::Row::setControlsActive(bool active) {
 }
 
 ModMatrixComponent::ModMatrixComponent(applause::ModMatrix& matrix) : matrix_(matrix) {
-    scrollableLayout().setFlex(true);
-    scrollableLayout().setFlexRows(true);
-    scrollableLayout().setFlexGap(paletteValue(ApplauseModMatrixRowGap));
-    scrollableLayout().setPaddingLeft(paletteValue(ApplauseModMatrixPadding));
-    scrollableLayout().setPaddingRight(paletteValue(ApplauseModMatrixPadding));
-    scrollableLayout().setFlexItemAlignment(applause::Layout::ItemAlignment::Stretch);
-
     setScrollBarRounding(5.0f);
 
     buildHeader();
     addScrolledChild(&header_);
+
+    dummy_row_ = std::make_unique<Row>(*this);
+    addScrolledChild(dummy_row_.get());
+
+    onScroll() += [this](applause::ScrollableFrame*) { updateVisibleRows(); };
+    edits_connection_ = matrix_.on_connections_edited.connect(
+        [this](std::span<const ModConnectionChange> changes) { applyChanges(changes); });
+
     rebuildRows();
 }
 
@@ -190,16 +193,13 @@ void ModMatrixComponent::buildHeader() {
     header_.layout().setFlexRows(false);
     header_.layout().setFlexGap(paletteValue(ApplauseModMatrixColumnGap));
     header_.layout().setFlexItemAlignment(applause::Layout::ItemAlignment::Stretch);
-    header_.layout().setHeight(paletteValue(ApplauseModMatrixRowHeight));
-    header_.layout().setFlexGrow(0.0f);
-    header_.layout().setFlexShrink(0.0f);
 
     header_.onDraw() = [&h = header_](applause::Canvas& canvas) {
         canvas.setColor(0xff444444);
         canvas.fill(10, h.height() - 4, h.width() - 20, 1);
     };
 
-    applause::Font header_font(11, applause::fonts::Jost_Regular_ttf);
+    const applause::Font& header_font = FontCache::get(11, applause::fonts::Jost_Regular_ttf);
     auto setupLabel = [&](applause::Frame& frame, const char* text) {
         frame.onDraw() = [&frame, text, header_font](applause::Canvas& canvas) {
             canvas.setColor(0xff888888);
@@ -232,22 +232,16 @@ void ModMatrixComponent::buildHeader() {
 }
 
 void ModMatrixComponent::rebuildRows() {
-    for (auto& row : rows_) removeScrolledChild(row.get());
-    rows_.clear();
+    slots_.clear();
+    for (auto& conn : matrix_.getConnections()) slots_.push_back(conn.depth_slot);
 
-    for (auto& conn : matrix_.getConnections()) {
-        auto row = std::make_unique<Row>(*this, false);
-        row->layout().setHeight(paletteValue(ApplauseModMatrixRowHeight));
-        row->layout().setFlexGrow(0.0f);
-        row->layout().setFlexShrink(0.0f);
-        row->bindToConnection(conn);
-        addScrolledChild(row.get());
-        rows_.push_back(std::move(row));
+    for (auto& [slot, row] : bound_rows_) {
+        row->setVisible(false);
+        free_rows_.push_back(row);
     }
+    bound_rows_.clear();
 
-    addDummyRow();
-
-    resized();
+    layoutRows();
 }
 
 void ModMatrixComponent::resized() {
@@ -256,48 +250,128 @@ void ModMatrixComponent::resized() {
     int bar_width = 10;
     scrollBar().setBounds(width() - bar_width, 0, bar_width, height());
 
-    computeLayout();
+    layoutRows();
+}
+
+float ModMatrixComponent::rowTop(size_t index) const {
+    // The header takes the first row; connections follow, then the dummy row
+    const float pitch = paletteValue(ApplauseModMatrixRowHeight) + paletteValue(ApplauseModMatrixRowGap);
+    return static_cast<float>(index + 1) * pitch;
+}
+
+void ModMatrixComponent::layoutRows() {
+    const float padding = paletteValue(ApplauseModMatrixPadding);
+    const float row_height = paletteValue(ApplauseModMatrixRowHeight);
+    const float row_width = std::max(0.0f, width() - 2.0f * padding);
+
+    header_.setBounds(padding, 0, row_width, row_height);
+    dummy_row_->setBounds(padding, rowTop(slots_.size()), row_width, row_height);
+
+    setScrollableHeight(rowTop(slots_.size()) + row_height);
+    updateVisibleRows();
+}
+
+void ModMatrixComponent::updateVisibleRows() {
+    const float padding = paletteValue(ApplauseModMatrixPadding);
+    const float row_height = paletteValue(ApplauseModMatrixRowHeight);
+    const float pitch = row_height + paletteValue(ApplauseModMatrixRowGap);
+    const float row_width = std::max(0.0f, width() - 2.0f * padding);
+
+    // Rows [first, last) overlap the view; rowTop(i) = (i + 1) * pitch
+    const float view_top = yPosition();
+    const auto first = static_cast<size_t>(std::max(0.0f, std::floor((view_top - row_height) / pitch)));
+    const size_t last = std::min(slots_.size(), static_cast<size_t>(std::ceil((view_top + height()) / pitch)));
+
+    // Release rows that scrolled out of view, or whose connection is gone
+    for (auto it = bound_rows_.begin(); it != bound_rows_.end();) {
+        auto pos = std::find(slots_.begin() + std::min(first, last), slots_.begin() + last, it->first);
+        if (pos == slots_.begin() + last) {
+            it->second->setVisible(false);
+            free_rows_.push_back(it->second);
+            it = bound_rows_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    float contentHeight = 0;
-    for (auto& row : rows_) contentHeight = std::max(contentHeight, row->bottom());
-    contentHeight += scrollableLayout().paddingBottom().amount;
+    for (size_t i = first; i < last; ++i) {
+        Row* row;
+        if (auto it = bound_rows_.find(slots_[i]); it != bound_rows_.end()) {
+            row = it->second;
+        } else {
+            if (free_rows_.empty()) {
+                pool_.push_back(std::make_unique<Row>(*this));
+                addScrolledChild(pool_.back().get());
+                free_rows_.push_back(pool_.back().get());
+            }
+            row = free_rows_.back();
+            free_rows_.pop_back();
+            bound_rows_.emplace(slots_[i], row);
+            rebindRow(*row, slots_[i]);
+            row->setVisible(true);
+        }
+        row->setBounds(padding, rowTop(i), row_width, row_height);
+    }
+}
 
-    setScrollableHeight(contentHeight);
+void ModMatrixComponent::rebindRow(Row& row, uint16_t depth_slot) {
+    for (auto& conn : matrix_.getConnections()) {
+        if (conn.depth_slot == depth_slot) {
+            row.bindToConnection(conn);
+            return;
+        }
+    }
 }
 
-void ModMatrixComponent::addDummyRow() {
-    auto row = std::make_unique<Row>(*this, true);
-    row->layout().setHeight(paletteValue(ApplauseModMatrixRowHeight));
-    row->layout().setFlexGrow(0.0f);
-    row->layout().setFlexShrink(0.0f);
+void ModMatrixComponent::applyChanges(std::span<const ModConnectionChange> changes) {
+    bool structure_changed = false;
+    for (const auto& change : changes) {
+        switch (change.kind) {
+            case ModConnectionChange::Kind::Added:
+                if (std::find(slots_.begin(), slots_.end(), change.depth_slot) == slots_.end()) {
+                    slots_.push_back(change.depth_slot);
+                    structure_changed = true;
+                }
+                break;
+            case ModConnectionChange::Kind::Removed:
+                if (auto it = std::find(slots_.begin(), slots_.end(), change.depth_slot); it != slots_.end()) {
+                    slots_.erase(it);
+                    structure_changed = true;
+                }
+                break;
+            case ModConnectionChange::Kind::DepthChanged:
+            case ModConnectionChange::Kind::MappingChanged:
+            case ModConnectionChange::Kind::Rerouted:
+                break;
+        }
+    }
+
+    // Releases rows of removed connections, and binds rows that came into view
+    if (structure_changed) layoutRows();
 
-    addScrolledChild(row.get());
-    rows_.push_back(std::move(row));
+    // Rebind the rows showing a touched connection, and the depth mods labelled with it
+    for (auto& [slot, row] : bound_rows_) {
+        for (const auto& change : changes) {
+            if (slot == change.depth_slot || (row->conn.isDepthMod() && row->conn.dst_idx == change.depth_slot)) {
+                rebindRow(*row, slot);
+                break;
+            }
+        }
+    }
 }
 
 void ModMatrixComponent::activateRow(Row* row) {
+    // The change-set from adding the connection lists it; the dummy row then starts over
     if (row->dst_list_id < 0) {
         auto slot = static_cast<uint16_t>(-(row->dst_list_id + 1));
         auto target = matrix_.findConnection(slot);
         if (!target) return;
 
-        auto conn = matrix_.addDepthModulation(matrix_.getSource(row->src_list_id), *target, 0.0f);
-        row->bindToConnection(conn);
+        matrix_.addDepthModulation(matrix_.getSource(row->src_list_id), *target, 0.0f);
     } else {
-        auto conn = matrix_.addConnection(matrix_.getSource(row->src_list_id),
-                                          matrix_.getDestination(row->dst_list_id - 1), 0.0f);
-        row->bindToConnection(conn);
+        matrix_.addConnection(matrix_.getSource(row->src_list_id), matrix_.getDestination(row->dst_list_id - 1), 0.0f);
     }
-    addDummyRow();
-
-    resized();
-}
-
-void ModMatrixComponent::deleteRow(Row* row) {
-    matrix_.removeConnection(row->conn);
-    // Defer: we are inside the delete button's onToggle CallbackList, and rebuildRows
-    // would destroy the Row that owns it.
-    applause::runOnEventThread([this] { rebuildRows(); });
+    row->bindToDummy();
 }
 
 }  // namespace applause
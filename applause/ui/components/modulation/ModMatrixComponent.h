@@ -8,11 +8,21 @@
 #include <applause/ui/components/Slider.h>
 
 #include <memory>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace applause {
 
+/**
+ * Editable list of a ModMatrix's connections, one row per connection plus a trailing row for adding one.
+ *
+ * The list is virtual: only the rows scrolled into view are materialized, from a small pool of Row frames that are
+ * rebound to whichever connections come into view. The component follows the matrix through
+ * ModMatrix::on_connections_edited, applying each change-set to the affected rows, so edits made here, by undo or
+ * by loading a preset show up without rebuilding the list.
+ */
 class ModMatrixComponent : public applause::ScrollableFrame {
 public:
     APPLAUSE_THEME_DEFINE_VALUE(ApplauseModMatrixRowHeight);
@@ -24,21 +34,24 @@ public:
 
     /**
      * A single row in the mod matrix UI, representing one modulation connection.
-     * Can be a "dummy" row (awaiting user input) or an active row bound to a connection.
+     * Can be a "dummy" row (awaiting user input) or an active row bound to a connection. Rows are recycled, so a
+     * row's controls only ask the matrix for changes; what the row shows comes back through the change-set.
      */
     class Row : public applause::Frame {
     public:
-        Row(ModMatrixComponent& owner, bool is_dummy);
+        explicit Row(ModMatrixComponent& owner);
 
         void bindToConnection(const ModConnection& conn);
+        void bindToDummy();
 
-        bool is_dummy;
+        bool is_dummy = true;
         int src_list_id = -1;  // ModMatrix source index, or -1 if unset
         int dst_list_id = 0;  // 0 = unset, positive = ModMatrix dest index + 1, negative = -(depth_slot + 1)
         ModConnection conn;  // Copied from matrix on bind; only valid when !is_dummy
 
     private:
         void setControlsActive(bool active);
+        void buildDestinationMenu(NativePopupMenu& menu);
 
         ModMatrixComponent& owner_;
 
@@ -51,15 +64,23 @@ public:
 
     explicit ModMatrixComponent(applause::ModMatrix& matrix);
 
+    /** Re-reads every connection from the matrix and rebinds the visible rows. */
     void rebuildRows();
     void resized() override;
 
 private:
-    void addDummyRow();
     void activateRow(Row* row);
-    void deleteRow(Row* row);
     void buildHeader();
 
+    // Applies one on_connections_edited change-set to the list and the rows showing the touched connections
+    void applyChanges(std::span<const ModConnectionChange> changes);
+    // Positions the header and dummy row, sizes the scroll area, then materializes the visible rows
+    void layoutRows();
+    // Binds pooled rows to the connections in view and releases the rest
+    void updateVisibleRows();
+    void rebindRow(Row& row, uint16_t depth_slot);
+    [[nodiscard]] float rowTop(size_t index) const;
+
     applause::ModMatrix& matrix_;
     applause::Frame header_;
     applause::Frame header_source_;
@@ -67,7 +88,13 @@ private:
     applause::Frame header_polarity_;
     applause::Frame header_amount_;
     applause::Frame header_delete_;
-    std::vector<std::unique_ptr<Row>> rows_;
+
+    std::vector<uint16_t> slots_;  // Depth slot of each listed connection, in display order
+    std::vector<std::unique_ptr<Row>> pool_;  // Every row frame created so far; never shrinks
+    std::vector<Row*> free_rows_;  // Pooled rows not bound to a connection
+    std::unordered_map<uint16_t, Row*> bound_rows_;  // Materialized rows by depth slot
+    std::unique_ptr<Row> dummy_row_;  // Always follows the last connection
+    rocket::scoped_connection edits_connection_;
 };
 
 }  // namespace applause
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace applause {
+
+/**
+ * A fixed-size set of flags that any thread can raise and one consumer drains, without locks. Producers set bits
+ * with release semantics after publishing whatever the bit stands for (e.g. storing a parameter value); the
+ * consumer's acquiring drain then sees that data. Bits raised again while being drained are reported next time.
+ */
+class AtomicBitset {
+public:
+    explicit AtomicBitset(size_t size = 0)
+        : words_(std::make_unique<std::atomic<uint64_t>[]>((size + 63) / 64)), num_words_((size + 63) / 64) {}
+
+    /** Raises bit index. Safe from any thread. */
+    void set(size_t index, std::memory_order order = std::memory_order_release) noexcept {
+        words_[index / 64].fetch_or(uint64_t{1} << (index % 64), order);
+    }
+
+    /** Calls fn(index) for every raised bit below size, in increasing order, clearing them. */
+    template <typename Fn>
+    void consume(size_t size, Fn&& fn) noexcept {
+        const size_t words = std::min((size + 63) / 64, num_words_);
+        for (size_t w = 0; w < words; ++w) {
+            if (words_[w].load(std::memory_order_relaxed) == 0) continue;
+            for (uint64_t bits = words_[w].exchange(0, std::memory_order_acquire); bits != 0; bits &= bits - 1) {
+                fn(static_cast<uint32_t>(w * 64 + static_cast<size_t>(std::countr_zero(bits))));
+            }
+        }
+    }
+
+    /** Clears bit index, returning whether it was raised, for a consumer that only cares about the one bit. */
+    bool consumeOne(size_t index) noexcept {
+        const uint64_t mask = uint64_t{1} << (index % 64);
+        if ((words_[index / 64].load(std::memory_order_relaxed) & mask) == 0) return false;
+        return (words_[index / 64].fetch_and(~mask, std::memory_order_acquire) & mask) != 0;
+    }
+
+    /** Whether any bit below size is raised, without clearing it. */
+    [[nodiscard]] bool any(size_t size, std::memory_order order = std::memory_order_acquire) const noexcept {
+        const size_t words = std::min((size + 63) / 64, num_words_);
+        for (size_t w = 0; w < words; ++w) {
+            if (words_[w].load(order) != 0) return true;
+        }
+        return false;
+    }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    size_t num_words_;
+};
+
+}  // namespace applause
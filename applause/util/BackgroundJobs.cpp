@@ -0,0 +1,199 @@
+#include "BackgroundJobs.h"
+
+#include <applause/core/RealtimeSafety.h>
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace applause {
+namespace {
+// Best effort, like WorkerPool's priority raise: where it fails, jobs simply run at normal priority
+void lowerToBackgroundPriority() noexcept {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#elif defined(__linux__)
+    // Linux keeps a nice value per thread
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+}
+}  // namespace
+
+BackgroundJobs::BackgroundJobs(size_t num_threads) {
+    threads_.reserve(std::max<size_t>(num_threads, 1));
+    for (size_t i = 0; i < std::max<size_t>(num_threads, 1); ++i) threads_.emplace_back([this] { run(); });
+}
+
+BackgroundJobs::~BackgroundJobs() {
+    {
+        std::lock_guard lock{mutex_};
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) thread.join();
+}
+
+BackgroundJobs& BackgroundJobs::shared() {
+    static BackgroundJobs jobs{defaultNumThreads()};
+    return jobs;
+}
+
+size_t BackgroundJobs::defaultNumThreads() noexcept {
+    return std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+}
+
+size_t BackgroundJobs::numQueued() const {
+    std::lock_guard lock{mutex_};
+    size_t count = 0;
+    for (const auto& queue : queues_) count += queue.size();
+    return count;
+}
+
+void BackgroundJobs::enqueue(Job job) {
+    {
+        std::lock_guard lock{mutex_};
+        queues_[static_cast<size_t>(job.priority)].push_back(std::move(job));
+    }
+    wake_.notify_one();
+}
+
+size_t BackgroundJobs::removeQueued(const JobGroup& group) {
+    std::vector<Job> removed;
+    {
+        std::lock_guard lock{mutex_};
+        for (auto& queue : queues_) {
+            const auto owned = std::stable_partition(queue.begin(), queue.end(),
+                                                     [&](const Job& job) { return job.group != &group; });
+            std::move(owned, queue.end(), std::back_inserter(removed));
+            queue.erase(owned, queue.end());
+        }
+    }
+    // The jobs' captures go when removed does, outside the lock
+    for (auto& job : removed) job.state->status.store(JobStatus::Cancelled, std::memory_order_release);
+    return removed.size();
+}
+
+void BackgroundJobs::run() {
+    lowerToBackgroundPriority();
+    std::unique_lock lock{mutex_};
+    while (true) {
+        wake_.wait(lock, [&] {
+            return stop_ || std::any_of(std::begin(queues_), std::end(queues_), [](auto& q) { return !q.empty(); });
+        });
+        if (stop_) return;
+        auto& queue = *std::find_if(std::begin(queues_), std::end(queues_), [](auto& q) { return !q.empty(); });
+        Job job = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        JobGroup& group = *job.group;
+        JobStatus status = JobStatus::Cancelled;
+        if (!group.isCancelled(*job.state, job.epoch)) {
+            job.state->status.store(JobStatus::Running, std::memory_order_release);
+            const JobContext context{group, *job.state, job.epoch, job.priority};
+            try {
+                job.work(context);
+                status = context.isCancelled() ? JobStatus::Cancelled : JobStatus::Done;
+            } catch (const std::exception& e) {
+                LOG_ERR("BackgroundJobs: job failed: {}", e.what());
+                status = JobStatus::Failed;
+            } catch (...) {
+                LOG_ERR("BackgroundJobs: job failed with an unknown exception");
+                status = JobStatus::Failed;
+            }
+        }
+        job.work = nullptr;
+        group.finish(job, status);
+
+        lock.lock();
+    }
+}
+
+JobGroup::JobGroup(const clap_host_t* host, BackgroundJobs* jobs) noexcept : host_(host), jobs_(jobs) {}
+
+JobGroup::~JobGroup() { shutdown(); }
+
+JobHandle JobGroup::submit(JobPriority priority, Work work, Completion on_complete) {
+    APPLAUSE_ASSERT_NOT_REALTIME("JobGroup::submit; background jobs lock and allocate");
+    ASSERT(work, "JobGroup: submitted a job without work");
+    if (!work) return {};
+    if (!jobs_) jobs_ = &BackgroundJobs::shared();
+
+    auto state = std::make_shared<JobState>();
+    {
+        std::lock_guard lock{mutex_};
+        ++outstanding_;
+    }
+    jobs_->enqueue({.group = this,
+                    .state = state,
+                    .epoch = cancel_epoch_.load(std::memory_order_acquire),
+                    .priority = priority,
+                    .work = std::move(work),
+                    .on_complete = std::move(on_complete)});
+    return JobHandle{std::move(state)};
+}
+
+void JobGroup::cancelAll() noexcept { cancel_epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+size_t JobGroup::dispatchCompletions() {
+    std::vector<Finished> finished;
+    {
+        std::lock_guard lock{mutex_};
+        finished.swap(finished_);
+    }
+    for (auto& job : finished) job.on_complete(job.status);
+    return finished.size();
+}
+
+void JobGroup::waitIdle() {
+    std::unique_lock lock{mutex_};
+    idle_.wait(lock, [&] { return outstanding_ == 0; });
+}
+
+void JobGroup::shutdown() {
+    cancelAll();
+    const size_t removed = jobs_ ? jobs_->removeQueued(*this) : 0;
+    std::vector<Finished> dropped;
+    {
+        std::unique_lock lock{mutex_};
+        outstanding_ -= removed;
+        idle_.wait(lock, [&] { return outstanding_ == 0; });
+        dropped.swap(finished_);
+    }
+}
+
+size_t JobGroup::numOutstanding() const {
+    std::lock_guard lock{mutex_};
+    return outstanding_;
+}
+
+void JobGroup::finish(BackgroundJobs::Job& job, JobStatus status) {
+    job.state->status.store(status, std::memory_order_release);
+    // Once outstanding_ drops, shutdown() may return and the group go away: nothing of this touches it after that
+    std::lock_guard lock{mutex_};
+    if (job.on_complete) {
+        const bool first = finished_.empty();
+        finished_.push_back({std::move(job.on_complete), status});
+        if (first && host_ && host_->request_callback) host_->request_callback(host_);
+    }
+    if (--outstanding_ == 0) idle_.notify_all();
+}
+
+}  // namespace applause
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <clap/host.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace applause {
+
+class JobGroup;
+
+/** Which queued job a BackgroundJobs thread picks up next: any High job before any Normal one, and so on. */
+enum class JobPriority : uint8_t {
+    High,    ///< Someone is waiting on it, e.g. parsing a state or preset the host just loaded
+    Normal,  ///< Work the plugin needs soon, e.g. baking tables or preparing an impulse response
+    Low,     ///< Work nobody waits on, e.g. indexing the preset library
+};
+
+inline constexpr size_t kNumJobPriorities = 3;
+
+/** Where a job stands; a job ends Done, Cancelled or Failed. */
+enum class JobStatus : uint8_t {
+    Queued,
+    Running,
+    Done,       ///< The work ran to the end
+    Cancelled,  ///< Cancelled before it started, or the work saw isCancelled() and returned early
+    Failed,     ///< The work threw; the exception is logged and dropped
+};
+
+/** Shared between a JobHandle and the queued job. */
+struct JobState {
+    std::atomic<bool> cancelled{false};
+    std::atomic<JobStatus> status{JobStatus::Queued};
+};
+
+/** What a job's work sees while it runs. */
+class JobContext {
+public:
+    /** Long work should check this now and then and return early once it's set. */
+    [[nodiscard]] bool isCancelled() const noexcept;
+
+    [[nodiscard]] JobPriority priority() const noexcept { return priority_; }
+
+private:
+    friend class BackgroundJobs;
+
+    JobContext(const JobGroup& group, const JobState& state, uint32_t epoch, JobPriority priority) noexcept
+        : group_(group), state_(state), epoch_(epoch), priority_(priority) {}
+
+    const JobGroup& group_;
+    const JobState& state_;
+    uint32_t epoch_;
+    JobPriority priority_;
+};
+
+/** Refers to one submitted job; cheap to copy, and dropping it doesn't cancel the job. */
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    /** Cancels the job: it won't start if it hasn't, and its JobContext reports isCancelled() if it has. */
+    void cancel() const noexcept {
+        if (state_) state_->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] JobStatus status() const noexcept {
+        return state_ ? state_->status.load(std::memory_order_acquire) : JobStatus::Cancelled;
+    }
+
+    /** Whether the job has ended, however it ended. Its completion may not have been dispatched yet. */
+    [[nodiscard]] bool isFinished() const noexcept {
+        const JobStatus s = status();
+        return s != JobStatus::Queued && s != JobStatus::Running;
+    }
+
+    [[nodiscard]] bool isValid() const noexcept { return state_ != nullptr; }
+
+private:
+    friend class JobGroup;
+
+    explicit JobHandle(std::shared_ptr<JobState> state) noexcept : state_(std::move(state)) {}
+
+    std::shared_ptr<JobState> state_;
+};
+
+/**
+ * @brief The process-wide pool of background threads for non-real-time work: baking tables, indexing presets,
+ * preparing impulse responses, parsing state, analysis FFTs.
+ *
+ * Every plugin instance in the process shares shared(), so fifty instances loading at once queue their work on a
+ * handful of threads instead of each starting its own and oversubscribing the machine. Threads run below normal
+ * priority where the OS allows it, so the host's audio and UI threads win any contention. Queued jobs run highest
+ * JobPriority first, in submission order within a priority.
+ *
+ * Plugins don't submit here directly but through a JobGroup, usually PluginBase::backgroundJobs(), which delivers
+ * completions on the plugin's main thread and keeps jobs from outliving the instance that submitted them.
+ *
+ * This is not for the audio thread: submitting locks and allocates. Fork/join work inside process() belongs on
+ * ThreadPoolExtension and its WorkerPool, which never sees these jobs.
+ */
+class BackgroundJobs {
+public:
+    /** Starts num_threads threads (at least one). */
+    explicit BackgroundJobs(size_t num_threads);
+
+    /** Stops and joins the threads; jobs still queued are dropped without running. */
+    ~BackgroundJobs();
+
+    BackgroundJobs(const BackgroundJobs&) = delete;
+    BackgroundJobs& operator=(const BackgroundJobs&) = delete;
+
+    /** The pool every instance of the plugin binary shares, started on first use with defaultNumThreads(). */
+    static BackgroundJobs& shared();
+
+    /** Half the hardware threads, between one and four: background work shouldn't crowd out the host. */
+    [[nodiscard]] static size_t defaultNumThreads() noexcept;
+
+    [[nodiscard]] size_t numThreads() const noexcept { return threads_.size(); }
+
+    /** Jobs waiting for a thread, across every group. */
+    [[nodiscard]] size_t numQueued() const;
+
+private:
+    friend class JobGroup;
+
+    struct Job {
+        JobGroup* group = nullptr;
+        std::shared_ptr<JobState> state;
+        uint32_t epoch = 0;  // The group's cancel epoch at submission
+        JobPriority priority = JobPriority::Normal;
+        std::function<void(const JobContext&)> work;
+        std::function<void(JobStatus)> on_complete;
+    };
+
+    void enqueue(Job job);
+
+    /** Removes group's queued jobs; returns how many. */
+    size_t removeQueued(const JobGroup& group);
+
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Job> queues_[kNumJobPriorities];
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+/**
+ * @brief One plugin instance's jobs on the shared BackgroundJobs pool, with completion callbacks delivered on the
+ * main thread.
+ *
+ * submit() queues work for a background thread. When the work ends, however it ends, on_complete is queued for the
+ * main thread and the group asks the host for a main-thread callback (clap_host::request_callback());
+ * dispatchCompletions(), called from the host's on_main_thread(), runs it there, so completions can touch the UI,
+ * the parameters or the plugin's state without locks. PluginBase owns one, backgroundJobs(), and dispatches it for
+ * you.
+ *
+ * shutdown(), also run by the destructor, cancels the group's jobs, drops those still queued and waits for the
+ * running ones to return, so no work runs against a destroyed plugin; PluginBase does so before destroy().
+ *
+ * @code
+ * // Main thread, e.g. once a sample folder is chosen
+ * auto index = std::make_shared<SampleIndex>();
+ * backgroundJobs().submit(JobPriority::Low,
+ *     [=](const JobContext& job) { index->scan(folder, [&] { return job.isCancelled(); }); },
+ *     [this, index](JobStatus status) { if (status == JobStatus::Done) browser_.setIndex(index); });
+ * @endcode
+ */
+class JobGroup {
+public:
+    using Work = std::function<void(const JobContext&)>;
+    using Completion = std::function<void(JobStatus)>;
+
+    /**
+     * Submits to jobs, or to BackgroundJobs::shared() if null, which is only started by the first submit(). host, if
+     * given, is asked for a main-thread callback whenever completions are pending.
+     */
+    explicit JobGroup(const clap_host_t* host = nullptr, BackgroundJobs* jobs = nullptr) noexcept;
+
+    /** shutdown() */
+    ~JobGroup();
+
+    JobGroup(const JobGroup&) = delete;
+    JobGroup& operator=(const JobGroup&) = delete;
+
+    /** Queues work at priority; on_complete, if any, later runs from dispatchCompletions(). Not on the audio thread. */
+    JobHandle submit(JobPriority priority, Work work, Completion on_complete = {});
+
+    /** Cancels every job submitted so far; each still completes, as Cancelled unless it had already finished. */
+    void cancelAll() noexcept;
+
+    /** Main thread: runs the completions of jobs that have ended, in the order they ended. Returns how many ran. */
+    size_t dispatchCompletions();
+
+    /** Blocks until every submitted job has ended; completions still need dispatchCompletions(). Not for the UI. */
+    void waitIdle();
+
+    /**
+     * Cancels everything, drops queued jobs and pending completions, and waits for running jobs to return. The group
+     * takes new jobs again afterwards.
+     */
+    void shutdown();
+
+    /** Jobs submitted that haven't ended yet. */
+    [[nodiscard]] size_t numOutstanding() const;
+
+private:
+    friend class BackgroundJobs;
+    friend class JobContext;
+
+    /** Called by a pool thread once a job's work has returned, or was skipped. */
+    void finish(BackgroundJobs::Job& job, JobStatus status);
+
+    [[nodiscard]] bool isCancelled(const JobState& state, uint32_t epoch) const noexcept {
+        return state.cancelled.load(std::memory_order_relaxed) ||
+               cancel_epoch_.load(std::memory_order_acquire) != epoch;
+    }
+
+    struct Finished {
+        Completion on_complete;
+        JobStatus status;
+    };
+
+    const clap_host_t* host_;
+    BackgroundJobs* jobs_;
+    std::atomic<uint32_t> cancel_epoch_{0};  // Bumped by cancelAll(); jobs from an older epoch are cancelled
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    size_t outstanding_ = 0;
+    std::vector<Finished> finished_;
+};
+
+inline bool JobContext::isCancelled() const noexcept { return group_.isCancelled(state_, epoch_); }
+
+}  // namespace applause
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace applause {
+/**
+ * A growable memory arena for non-real-time code, e.g. the UI, preset loading
+ * or table baking, where many small heap allocations would otherwise pile up.
+ *
+ * Memory comes from a chain of heap blocks. A request that doesn't fit in the
+ * current block moves on to the next one, allocating it (at least
+ * block_size bytes, more for a larger request) if the chain ends there, so
+ * allocateBytes() never fails. Rewinding with clear() or a Frame keeps the
+ * blocks for reuse; release() frees them.
+ *
+ * getPeakBytesUsed() and getNumBlocks() show what a workload actually needs,
+ * e.g. to size a fixed MemoryArena for the same job on the audio thread.
+ */
+class ChainedMemoryArena : public ArenaAllocators<ChainedMemoryArena> {
+public:
+    static constexpr size_t defaultBlockSize = 64 * 1024;
+
+    explicit ChainedMemoryArena(size_t block_size = defaultBlockSize) noexcept
+        : block_size_(std::max<size_t>(block_size, defaultByteAlignment)) {}
+
+    ChainedMemoryArena(const ChainedMemoryArena&) = delete;
+    ChainedMemoryArena& operator=(const ChainedMemoryArena&) = delete;
+
+    ChainedMemoryArena(ChainedMemoryArena&&) noexcept = default;
+    ChainedMemoryArena& operator=(ChainedMemoryArena&&) noexcept = default;
+
+    /**
+     * Allocates a given number of bytes, growing the chain if needed.
+     * The returned memory will be un-initialized, so be sure to clear it
+     * manually if needed.
+     */
+    void* allocateBytes(size_t num_bytes, size_t alignment = 1) {
+        ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0,
+               "ChainedMemoryArena: alignment must be a power of two");
+        while (true) {
+            if (current_ < blocks_.size()) {
+                Block& block = blocks_[current_];
+                std::byte* top = block.data.get() + offset_;
+                std::byte* pointer = snapPointerToAlignment(top, alignment);
+                const auto increment = static_cast<size_t>(pointer + num_bytes - top);
+                if (offset_ + increment <= block.size) {
+                    offset_ += increment;
+                    bytes_used_ += increment;
+                    peak_bytes_used_ = std::max(peak_bytes_used_, bytes_used_);
+                    return pointer;
+                }
+                // Skip blocks the request can't fit in; a later one may be large enough
+                ++current_;
+                offset_ = 0;
+                continue;
+            }
+            const size_t size = std::max(block_size_, num_bytes + alignment);
+            blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});
+            capacity_ += size;
+        }
+    }
+
+    /** Rewinds to empty, keeping every block for reuse. */
+    void clear() noexcept {
+        current_ = 0;
+        offset_ = 0;
+        bytes_used_ = 0;
+    }
+
+    /** Rewinds to empty and frees every block. */
+    void release() noexcept {
+        clear();
+        blocks_.clear();
+        capacity_ = 0;
+    }
+
+    /** Bytes handed out since the last rewind, including alignment padding */
+    [[nodiscard]] size_t getBytesUsed() const noexcept { return bytes_used_; }
+
+    /** The largest getBytesUsed() since construction */
+    [[nodiscard]] size_t getPeakBytesUsed() const noexcept { return peak_bytes_used_; }
+
+    /** Bytes held across all blocks */
+    [[nodiscard]] size_t getCapacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] size_t getNumBlocks() const noexcept { return blocks_.size(); }
+
+    /**
+     * Creates a "frame" for the allocator.
+     * Once the frame goes out of scope, the allocator will be reset
+     * to whatever it's state was at the beginning of the frame.
+     */
+    struct Frame {
+        explicit Frame(ChainedMemoryArena& allocator)
+            : alloc_(&allocator),
+              current_at_start_(allocator.current_),
+              offset_at_start_(allocator.offset_),
+              bytes_used_at_start_(allocator.bytes_used_) {}
+
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+        ~Frame() { alloc_->resetToFrame(*this); }
+
+        ChainedMemoryArena* alloc_ = nullptr;
+        size_t current_at_start_ = 0;
+        size_t offset_at_start_ = 0;
+        size_t bytes_used_at_start_ = 0;
+    };
+
+    /** Creates a frame for this allocator */
+    auto createFrame() { return Frame{*this}; }
+
+    void resetToFrame(const Frame& frame) noexcept {
+        ASSERT(frame.alloc_ == this, "ChainedMemoryArena: frame belongs to another arena");
+        current_ = frame.current_at_start_;
+        offset_ = frame.offset_at_start_;
+        bytes_used_ = frame.bytes_used_at_start_;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    size_t current_ = 0;  // Block being allocated from; blocks_.size() when the chain needs to grow
+    size_t offset_ = 0;   // Bytes used in the current block
+    size_t bytes_used_ = 0;
+    size_t peak_bytes_used_ = 0;
+    size_t capacity_ = 0;
+};
+}  // namespace applause
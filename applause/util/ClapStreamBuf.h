@@ -0,0 +1,99 @@
+#pragma once
+
+#include <clap/stream.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+
+namespace applause {
+
+/** Bytes ClapOutStreamBuf and ClapInStreamBuf buffer between calls into the host's stream. */
+inline constexpr size_t kClapStreamChunkSize = 4096;
+
+/**
+ * A std::streambuf that writes to a host's clap_ostream in fixed-size chunks, so state can be serialized straight
+ * into the stream through a std::ostream instead of into a string first. A write the host rejects fails the
+ * std::ostream; check it after flushing.
+ */
+class ClapOutStreamBuf : public std::streambuf {
+public:
+    explicit ClapOutStreamBuf(const clap_ostream_t* stream) noexcept : stream_(stream) {
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+
+    ClapOutStreamBuf(const ClapOutStreamBuf&) = delete;
+    ClapOutStreamBuf& operator=(const ClapOutStreamBuf&) = delete;
+
+    /** The number of bytes the host has accepted so far. */
+    [[nodiscard]] uint64_t getBytesWritten() const noexcept { return written_; }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!drain()) return traits_type::eof();
+        if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    int sync() override { return drain() ? 0 : -1; }
+
+private:
+    // Hands the buffered bytes to the host, which may accept fewer per call than offered
+    bool drain() noexcept {
+        const char* ptr = pbase();
+        while (ptr < pptr()) {
+            const int64_t written = stream_->write(stream_, ptr, static_cast<uint64_t>(pptr() - ptr));
+            if (written <= 0) return false;
+            ptr += written;
+            written_ += static_cast<uint64_t>(written);
+        }
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return true;
+    }
+
+    const clap_ostream_t* stream_;
+    uint64_t written_ = 0;
+    std::array<char, kClapStreamChunkSize> buffer_;
+};
+
+/**
+ * A std::streambuf that reads from a host's clap_istream in fixed-size chunks, so state can be parsed straight from
+ * the stream through a std::istream instead of being collected into a buffer first. A host read error ends the
+ * stream early and sets hasError().
+ */
+class ClapInStreamBuf : public std::streambuf {
+public:
+    explicit ClapInStreamBuf(const clap_istream_t* stream) noexcept : stream_(stream) {
+        setg(buffer_.data(), buffer_.data(), buffer_.data());
+    }
+
+    ClapInStreamBuf(const ClapInStreamBuf&) = delete;
+    ClapInStreamBuf& operator=(const ClapInStreamBuf&) = delete;
+
+    /** Whether the host reported a read error, as opposed to the end of the stream. */
+    [[nodiscard]] bool hasError() const noexcept { return error_; }
+
+protected:
+    int_type underflow() override {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        if (error_) return traits_type::eof();
+
+        const int64_t read = stream_->read(stream_, buffer_.data(), buffer_.size());
+        if (read <= 0) {
+            error_ = read < 0;
+            return traits_type::eof();
+        }
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + read);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    const clap_istream_t* stream_;
+    bool error_ = false;
+    std::array<char, kClapStreamChunkSize> buffer_;
+};
+
+}  // namespace applause
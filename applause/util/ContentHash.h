@@ -0,0 +1,73 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace applause {
+
+/**
+ * A 64-bit hash of everything a derived table is built from: its source samples and every parameter that changes
+ * the result. Used as the key of SharedTables, so two instances that would build the same table find each other.
+ *
+ * Not cryptographic, but it mixes every byte, so distinct content colliding is as unlikely as for any good 64-bit
+ * hash. Each add() is hashed together with its length, so the value depends on how the content is split into
+ * calls; add the fields of a key in a fixed order.
+ *
+ * @code
+ * const uint64_t key = ContentHasher().add(samples).add(frame_size).value();
+ * @endcode
+ */
+class ContentHasher {
+public:
+    /** Hashes the object representation of values; T must not have padding bytes. */
+    template <typename T>
+        requires std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>
+    ContentHasher& add(std::span<const T> values) noexcept {
+        return addBytes(values.data(), values.size_bytes());
+    }
+
+    template <typename T>
+        requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    ContentHasher& add(T value) noexcept {
+        return addBytes(&value, sizeof(value));
+    }
+
+    ContentHasher& add(std::string_view text) noexcept { return addBytes(text.data(), text.size()); }
+
+    ContentHasher& addBytes(const void* data, size_t size) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            mix(word);
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, bytes + i, size - i);
+        mix(tail ^ (static_cast<uint64_t>(size - i) << 56));
+        mix(static_cast<uint64_t>(size));
+        return *this;
+    }
+
+    [[nodiscard]] uint64_t value() const noexcept {
+        // splitmix64's finalizer, so every state bit reaches every output bit
+        uint64_t z = state_;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    void mix(uint64_t word) noexcept {
+        state_ = std::rotl(state_ ^ (word * 0x9e3779b97f4a7c15ull), 29) * 0xff51afd7ed558ccdull;
+    }
+
+    uint64_t state_ = 0x6a09e667f3bcc909ull;
+};
+
+}  // namespace applause
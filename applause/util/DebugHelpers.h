@@ -5,10 +5,18 @@
 #else
 #include <format>
 #endif
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <iostream>
+#include <mutex>
+#include <string>
 #include <string_view>
+#include <thread>
 
 #if APPLAUSE_USE_FMT
 #define FMT_NAMESPACE fmt
@@ -36,8 +44,7 @@ constexpr std::string_view level_name(const Level level) {
     return "UNKNOWN";
 }
 
-inline std::string timestamp() {
-    const auto now = std::chrono::system_clock::now();
+inline std::string timestamp(std::chrono::system_clock::time_point now) {
     const auto time = std::chrono::system_clock::to_time_t(now);
     const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                         now.time_since_epoch()) %
@@ -48,18 +55,190 @@ inline std::string timestamp() {
                                  tm->tm_min, tm->tm_sec, ms.count());
 }
 
+/**
+ * One log message: the text is formatted into the record on the logging
+ * thread, everything else (timestamp, file name, output) waits for the
+ * thread that drains the queue. file and func must outlive the record, which
+ * __FILE__ and __func__ do.
+ */
+struct LogRecord {
+    static constexpr std::size_t kTextCapacity = 240;
+
+    std::chrono::system_clock::time_point time{};
+    std::string_view file;
+    std::string_view func;
+    int line = 0;
+    Level level = Level::DBG;
+    uint16_t length = 0;
+    bool truncated = false;
+    char text[kTextCapacity];
+};
+
+/**
+ * A bounded lock-free queue of LogRecords. Any number of threads may push()
+ * at once, without allocating or locking; when the queue is full the
+ * message is dropped and counted instead. drain() must only be called from
+ * one thread at a time.
+ */
+template <std::size_t Capacity>
+class LogQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0,
+                  "LogQueue capacity must be a power of two");
+
+public:
+    LogQueue() noexcept {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+
+    bool push(const LogRecord& record) noexcept {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &cells_[pos & (Capacity - 1)];
+            const std::size_t seq =
+                cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                              static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record = record;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Writes every queued message to out; returns how many it wrote. */
+    std::size_t drain(std::ostream& out) {
+        std::size_t written = 0;
+        if (const auto dropped =
+                dropped_.exchange(0, std::memory_order_relaxed)) {
+            out << FMT_NAMESPACE::format("[log] {} messages dropped\n",
+                                         dropped);
+        }
+        while (true) {
+            Cell& cell = cells_[dequeue_pos_ & (Capacity - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) !=
+                dequeue_pos_ + 1) {
+                break;
+            }
+            write(out, cell.record);
+            cell.sequence.store(dequeue_pos_ + Capacity,
+                                std::memory_order_release);
+            ++dequeue_pos_;
+            ++written;
+        }
+        if (written > 0) out.flush();
+        return written;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        LogRecord record;
+    };
+
+    static void write(std::ostream& out, const LogRecord& r) {
+        const auto filename = r.file.substr(r.file.find_last_of("/\\") + 1);
+        out << FMT_NAMESPACE::format(
+            "[{}] {} {}:{} ({}) {}{}\n", timestamp(r.time),
+            level_name(r.level), filename, r.line, r.func,
+            std::string_view(r.text, r.length), r.truncated ? "..." : "");
+    }
+
+    std::array<Cell, Capacity> cells_;
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<std::size_t> dropped_{0};
+    alignas(64) std::size_t dequeue_pos_ = 0;
+};
+
+/**
+ * The process-wide log: LOG_* push into its queue, and a background thread
+ * writes the messages to std::cout, so logging from the audio thread doesn't
+ * allocate, take stdio locks or flush. The thread starts with the first
+ * message; PluginBase creates the logger up front so that never happens on
+ * the audio thread.
+ */
+class Logger {
+public:
+    static constexpr std::size_t kQueueCapacity = 256;
+
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    template <typename... Args>
+    void log(Level level, std::string_view file, int line,
+             std::string_view func,
+             FMT_NAMESPACE::format_string<Args...> fmt, Args&&... args) {
+        LogRecord record;
+        record.time = std::chrono::system_clock::now();
+        record.file = file;
+        record.func = func;
+        record.line = line;
+        record.level = level;
+        const auto result = FMT_NAMESPACE::format_to_n(
+            record.text, LogRecord::kTextCapacity, fmt,
+            std::forward<Args>(args)...);
+        const auto size = static_cast<std::size_t>(result.size);
+        record.truncated = size > LogRecord::kTextCapacity;
+        record.length = static_cast<uint16_t>(
+            record.truncated ? LogRecord::kTextCapacity : size);
+        queue_.push(record);
+    }
+
+    /** Writes out everything queued so far, on the calling thread. */
+    void flush() {
+        std::lock_guard lock{drain_mutex_};
+        queue_.drain(std::cout);
+    }
+
+private:
+    Logger() : thread_([this] { run(); }) {}
+
+    ~Logger() {
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+        flush();
+    }
+
+    void run() {
+        while (!stop_.load(std::memory_order_relaxed)) {
+            flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    LogQueue<kQueueCapacity> queue_;
+    std::mutex drain_mutex_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
 template <typename... Args>
 void log(Level level, std::string_view file, int line, std::string_view func,
          FMT_NAMESPACE::format_string<Args...> fmt, Args&&... args) {
-    auto msg = FMT_NAMESPACE::format(fmt, std::forward<Args>(args)...);
-    auto filename = file.substr(file.find_last_of("/\\") + 1);
-
-    std::cout << FMT_NAMESPACE::format("[{}] {} {}:{} ({}) {}", timestamp(),
-                                       level_name(level), filename, line, func,
-                                       msg)
-              << std::endl;
+    Logger::instance().log(level, file, line, func, fmt,
+                           std::forward<Args>(args)...);
 }
 
+/** Writes out queued log messages now, e.g. before a failed assertion aborts. */
+inline void flushLog() { Logger::instance().flush(); }
+
 template <typename T>
 std::string var_string(std::string_view name, const T& value) {
     return FMT_NAMESPACE::format("[{}={}]", name, value);
@@ -84,6 +263,7 @@ std::string var_string(std::string_view name, const T& value) {
     do {                                                                \
         if (!(condition)) {                                             \
             LOG_ERR("Assertion failed ({}): " __VA_ARGS__, #condition); \
+            debug::flushLog();                                          \
             assert(false);                                              \
         }                                                               \
     } while (0)
@@ -91,6 +271,7 @@ std::string var_string(std::string_view name, const T& value) {
 #define ASSERT_FALSE(...)                          \
     do {                                           \
         LOG_ERR("Assertion failed: " __VA_ARGS__); \
+        debug::flushLog();                         \
         assert(false);                             \
     } while (0)
 
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace applause {
+
+/**
+ * A read-only memory mapping of a whole file. Reading a mapped range only pages in the bytes touched, so jumping
+ * around a large file costs nothing for the parts that aren't read.
+ *
+ * The mapping stays valid until close() or destruction, even if the file is replaced on disk in the meantime
+ * (replace files by renaming over them, as PresetBankWriter does, never by rewriting them in place). Windows
+ * refuses to replace a mapped file at all, so there the mapping has to be closed first.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** Maps the file at path, replacing any current mapping; false if it can't be opened or mapped. */
+    bool open(const std::filesystem::path& path);
+
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return data_ != nullptr || open_empty_; }
+
+    [[nodiscard]] const uint8_t* data() const noexcept { return data_; }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::span<const uint8_t> bytes() const noexcept { return {data_, size_}; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_empty_ = false;  // Empty files can't be mapped, but open fine
+#if defined(_WIN32)
+    void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace applause
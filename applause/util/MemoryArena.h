@@ -24,12 +24,74 @@ static inline Type* snapPointerToAlignment(
 static constexpr int defaultByteAlignment =
     64;  // Cache line size for optimal SIMD performance
 
+/**
+ * The typed allocation helpers shared by MemoryArena and ChainedMemoryArena,
+ * built on the arena's allocateBytes().
+ */
+template <typename Arena>
+struct ArenaAllocators {
+    /**
+     * Allocates space for some number of objects of type T
+     * The returned memory will be un-initialized, so be sure to clear it
+     * manually if needed.
+     */
+    template <typename T, typename IntType>
+    T* allocate(IntType num_Ts, size_t alignment = alignof(T)) {
+        return static_cast<T*>(static_cast<Arena&>(*this).allocateBytes(
+            (size_t)num_Ts * sizeof(T), alignment));
+    }
+
+    /**
+     * Returns a span of type T, and size count.
+     * The returned memory will be un-initialized, so be sure to clear it
+     * manually if needed.
+     */
+    template <typename T, typename IntType>
+    auto makeSpan(IntType count, size_t alignment = defaultByteAlignment) {
+        return std::span{allocate<T>(count, alignment),
+                         static_cast<size_t>(count)};
+    }
+
+    /** Allocates contiguous channel planes and returns a BufferView wrapper. */
+    template <Sample SampleT, std::size_t Channels>
+    [[nodiscard]] BufferView<SampleT, Channels> allocateAudioBuffer(
+        std::size_t frame_count, std::size_t alignment = defaultByteAlignment) {
+        ASSERT(Channels > 0, "Channel count must be positive");
+
+        if (frame_count == 0) {
+            return BufferView<SampleT, Channels>{nullptr, 0};
+        }
+
+        using Scalar = scalar_t<SampleT>;
+
+        constexpr std::size_t sample_alignment = alignof(SampleT);
+        const std::size_t effective_alignment =
+            std::max(alignment, sample_alignment);
+
+        constexpr std::size_t width = sampleWidth<SampleT>();
+
+        ASSERT(frame_count <= std::numeric_limits<std::size_t>::max() / width,
+               "Frame count overflow!");
+        const std::size_t scalars_per_channel = frame_count * width;
+        ASSERT(scalars_per_channel <=
+                   std::numeric_limits<std::size_t>::max() / Channels,
+               "Sample count overflow!");
+        const std::size_t total_scalars = scalars_per_channel * Channels;
+
+        Scalar* storage = allocate<Scalar>(total_scalars, effective_alignment);
+        ASSERT(storage != nullptr,
+               "Storage allocation failed! This should never happen.");
+
+        return BufferView<SampleT, Channels>{storage, frame_count};
+    }
+};
+
 /**
  * A simple memory arena. By default the arena will be
  * backed with a vector of bytes, but the underlying
  * memory resource can be changed via the template argument.
  */
-struct MemoryArena {
+struct MemoryArena : ArenaAllocators<MemoryArena> {
     MemoryArena() = default;
 
     /** Constructs the arena with an initial allocated size. */
@@ -61,6 +123,12 @@ struct MemoryArena {
     /** Returns the number of bytes currently being used */
     [[nodiscard]] size_t getBytesUsed() const noexcept { return bytes_used_; }
 
+    /** Returns the largest number of bytes in use at once since construction */
+    [[nodiscard]] size_t getPeakBytesUsed() const noexcept { return peak_bytes_used_; }
+
+    /** Returns the size of the underlying buffer in bytes */
+    [[nodiscard]] size_t getCapacity() const noexcept { return raw_data_.size(); }
+
     /**
      * Allocates a given number of bytes.
      * The returned memory will be un-initialized, so be sure to clear it
@@ -78,64 +146,10 @@ struct MemoryArena {
         }
 
         bytes_used_ += bytes_increment;
+        peak_bytes_used_ = std::max(peak_bytes_used_, bytes_used_);
         return pointer;
     }
 
-    /**
-     * Allocates space for some number of objects of type T
-     * The returned memory will be un-initialized, so be sure to clear it
-     * manually if needed.
-     */
-    template <typename T, typename IntType>
-    T* allocate(IntType num_Ts, size_t alignment = alignof(T)) {
-        return static_cast<T*>(
-            allocateBytes((size_t)num_Ts * sizeof(T), alignment));
-    }
-
-    /**
-     * Returns a span of type T, and size count.
-     * The returned memory will be un-initialized, so be sure to clear it
-     * manually if needed.
-     */
-    template <typename T, typename IntType>
-    auto makeSpan(IntType count, size_t alignment = defaultByteAlignment) {
-        return std::span{allocate<T>(count, alignment),
-                         static_cast<size_t>(count)};
-    }
-
-    /** Allocates contiguous channel planes and returns a BufferView wrapper. */
-    template <Sample SampleT, std::size_t Channels>
-    [[nodiscard]] BufferView<SampleT, Channels> allocateAudioBuffer(
-        std::size_t frame_count, std::size_t alignment = defaultByteAlignment) {
-        ASSERT(Channels > 0, "Channel count must be positive");
-
-        if (frame_count == 0) {
-            return BufferView<SampleT, Channels>{nullptr, 0};
-        }
-
-        using Scalar = scalar_t<SampleT>;
-
-        constexpr std::size_t sample_alignment = alignof(SampleT);
-        const std::size_t effective_alignment =
-            std::max(alignment, sample_alignment);
-
-        constexpr std::size_t width = sampleWidth<SampleT>();
-
-        ASSERT(frame_count <= std::numeric_limits<std::size_t>::max() / width,
-               "Frame count overflow!");
-        const std::size_t scalars_per_channel = frame_count * width;
-        ASSERT(scalars_per_channel <=
-                   std::numeric_limits<std::size_t>::max() / Channels,
-               "Sample count overflow!");
-        const std::size_t total_scalars = scalars_per_channel * Channels;
-
-        Scalar* storage = allocate<Scalar>(total_scalars, effective_alignment);
-        ASSERT(storage != nullptr,
-               "Storage allocation failed! This should never happen.");
-
-        return BufferView<SampleT, Channels>{storage, frame_count};
-    }
-
     /** Returns a pointer to the internal buffer with a given offset in bytes */
     template <typename T, typename IntType>
     T* data(IntType offset_bytes) noexcept {
@@ -169,5 +183,6 @@ struct MemoryArena {
 
     std::span<std::byte> raw_data_{};
     size_t bytes_used_ = 0;
+    size_t peak_bytes_used_ = 0;
 };
 }  // namespace applause
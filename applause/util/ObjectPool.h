@@ -0,0 +1,142 @@
+#pragma once
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace applause {
+
+/**
+ * A fixed number of T slots that can be acquired and released one object at a time, in O(1) and without locks, so
+ * the audio thread can create and recycle objects without touching new/delete.
+ *
+ * Free slots form an intrusive stack: each one stores the index of the next free slot, and the stack head packs the
+ * top index with a version tag into one 64-bit atomic, so a compare-exchange can't be fooled by a slot that was
+ * taken and returned in between (ABA). acquire() and release() are therefore safe from any thread, e.g. the audio
+ * thread acquires a message payload and the UI thread releases it once it's been read. Slots are padded to a cache
+ * line so objects used by different threads don't share one.
+ *
+ * Unlike MemoryArena, objects come back individually; unlike a heap, the capacity is fixed when the pool is
+ * constructed (on the main thread), and acquire() returns nullptr once every slot is taken.
+ *
+ * @code
+ * ObjectPool<GrainState> grains{64};  // Constructor allocates
+ *
+ * // Audio thread
+ * GrainState* grain = grains.acquire(start, length);
+ * if (grain) { ... }
+ * grains.release(grain);
+ *
+ * // Or with automatic release
+ * auto owned = grains.acquireUnique(start, length);
+ * @endcode
+ */
+template <typename T>
+class ObjectPool {
+public:
+    struct Deleter {
+        ObjectPool* pool = nullptr;
+        void operator()(T* object) const noexcept { pool->release(object); }
+    };
+    using UniquePtr = std::unique_ptr<T, Deleter>;
+
+    /** Allocates capacity slots; call off the audio thread. */
+    explicit ObjectPool(size_t capacity) : slots_(std::make_unique<Slot[]>(capacity)), capacity_(capacity) {
+        ASSERT(capacity < kNil, "ObjectPool: capacity too large");
+        for (size_t i = 0; i < capacity; ++i) {
+            slots_[i].next.store(i + 1 < capacity ? static_cast<uint32_t>(i + 1) : kNil, std::memory_order_relaxed);
+        }
+        head_.store(pack(capacity > 0 ? 0 : kNil, 0), std::memory_order_relaxed);
+        available_.store(capacity, std::memory_order_relaxed);
+    }
+
+    ~ObjectPool() {
+        ASSERT(available() == capacity_, "ObjectPool: destroyed while objects are still acquired");
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /** Constructs a T from args in a free slot. Returns nullptr when the pool is exhausted. */
+    template <typename... Args>
+    [[nodiscard]] T* acquire(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint32_t index = 0;
+        while (true) {
+            index = indexOf(head);
+            if (index == kNil) return nullptr;
+            const uint32_t next = slots_[index].next.load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, pack(next, tagOf(head) + 1), std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+                break;
+            }
+        }
+        available_.fetch_sub(1, std::memory_order_relaxed);
+        return ::new (static_cast<void*>(slots_[index].storage)) T(std::forward<Args>(args)...);
+    }
+
+    /** acquire(), with the object released again when the returned pointer goes away. */
+    template <typename... Args>
+    [[nodiscard]] UniquePtr acquireUnique(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        return UniquePtr(acquire(std::forward<Args>(args)...), Deleter{this});
+    }
+
+    /** Destroys object and returns its slot to the pool. object must come from this pool; nullptr is ignored. */
+    void release(T* object) noexcept {
+        if (object == nullptr) return;
+        ASSERT(owns(object), "ObjectPool: released an object from another pool");
+        object->~T();
+
+        const auto index = static_cast<uint32_t>(slotOf(object) - slots_.get());
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        do {
+            slots_[index].next.store(indexOf(head), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, pack(index, tagOf(head) + 1), std::memory_order_release,
+                                              std::memory_order_relaxed));
+        available_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Whether object lives in one of this pool's slots. */
+    [[nodiscard]] bool owns(const T* object) const noexcept {
+        const auto* slot = reinterpret_cast<const Slot*>(object);
+        return slot >= slots_.get() && slot < slots_.get() + capacity_
+               && reinterpret_cast<const std::byte*>(object) == slot->storage;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    /** Free slots; only a snapshot while other threads acquire or release. */
+    [[nodiscard]] size_t available() const noexcept { return available_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kNil = ~uint32_t{0};
+
+    // The object comes first, so an object pointer is also its slot's address
+    struct alignas(std::max<size_t>(defaultByteAlignment, alignof(T))) Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+        std::atomic<uint32_t> next{kNil};
+    };
+
+    static constexpr uint64_t pack(uint32_t index, uint32_t tag) noexcept {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+    static constexpr uint32_t indexOf(uint64_t head) noexcept { return static_cast<uint32_t>(head); }
+    static constexpr uint32_t tagOf(uint64_t head) noexcept { return static_cast<uint32_t>(head >> 32); }
+
+    static Slot* slotOf(T* object) noexcept { return reinterpret_cast<Slot*>(object); }
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_;
+    alignas(defaultByteAlignment) std::atomic<uint64_t> head_{pack(kNil, 0)};
+    std::atomic<size_t> available_{0};
+};
+
+}  // namespace applause
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
 #include <applause/util/thirdparty/readerwriterqueue.h>
 
 namespace applause {
@@ -11,6 +15,11 @@ namespace applause {
  * The MessageQueue class provides two distinct message queues for bidirectional
  * communication between the UI thread and the audio thread. Messages consist of
  * a type, a parameter ID, and a value.
+ *
+ * Both queues are preallocated for a fixed capacity and never grow: producers
+ * send through sendToAudio() and sendToUi(), which fail instead of allocating
+ * when a queue is full (e.g. while the UI is closed or stalled), and count the
+ * dropped messages for diagnostics. Consumers dequeue from toAudio() and toUi().
  */
 class ParamMessageQueue {
 public:
@@ -22,11 +31,41 @@ public:
         float value;
     };
 
+    static constexpr size_t kDefaultCapacity = 1024;
+
+    /** Preallocates room for at least capacity messages in each direction. */
+    explicit ParamMessageQueue(size_t capacity = kDefaultCapacity) : ui2audio_(capacity), audio2ui_(capacity) {}
+
+    /** Queues a message for the audio thread; returns false and counts a drop when the queue is full. */
+    bool sendToAudio(const Message& message) noexcept { return send(ui2audio_, dropped_to_audio_, message); }
+
+    /** Queues a message for the UI thread; returns false and counts a drop when the queue is full. */
+    bool sendToUi(const Message& message) noexcept { return send(audio2ui_, dropped_to_ui_, message); }
+
+    /** Number of messages sendToAudio() has dropped so far. */
+    [[nodiscard]] uint64_t getDroppedToAudio() const noexcept {
+        return dropped_to_audio_.load(std::memory_order_relaxed);
+    }
+
+    /** Number of messages sendToUi() has dropped so far. */
+    [[nodiscard]] uint64_t getDroppedToUi() const noexcept {
+        return dropped_to_ui_.load(std::memory_order_relaxed);
+    }
+
     applause::ReaderWriterQueue<Message>& toAudio() { return ui2audio_; }
     applause::ReaderWriterQueue<Message>& toUi() { return audio2ui_; }
 
 private:
+    static bool send(applause::ReaderWriterQueue<Message>& queue, std::atomic<uint64_t>& dropped,
+                     const Message& message) noexcept {
+        if (queue.try_enqueue(message)) return true;
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
     applause::ReaderWriterQueue<Message> ui2audio_;
     applause::ReaderWriterQueue<Message> audio2ui_;
+    std::atomic<uint64_t> dropped_to_audio_{0};
+    std::atomic<uint64_t> dropped_to_ui_{0};
 };
 }  // namespace applause
@@ -0,0 +1,173 @@
+#include "PresetBank.h"
+
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+namespace applause {
+namespace {
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kRowSize = 24;
+constexpr size_t kDataAlignment = 8;
+
+uint32_t read32(const uint8_t* bytes) noexcept {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    return value;
+}
+
+uint64_t read64(const uint8_t* bytes) noexcept {
+    return static_cast<uint64_t>(read32(bytes)) | (static_cast<uint64_t>(read32(bytes + 4)) << 32);
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) out.push_back(static_cast<uint8_t>(value >> shift));
+}
+
+void put64(std::vector<uint8_t>& out, uint64_t value) {
+    put32(out, static_cast<uint32_t>(value));
+    put32(out, static_cast<uint32_t>(value >> 32));
+}
+
+size_t alignUp(size_t value) { return (value + kDataAlignment - 1) & ~(kDataAlignment - 1); }
+}  // namespace
+
+bool PresetBank::open(const std::filesystem::path& path) {
+    close();
+    if (!file_.open(path)) return false;
+
+    const auto bytes = file_.bytes();
+    if (bytes.size() < kHeaderSize ||
+        !std::equal(std::begin(kPresetBankMagic), std::end(kPresetBankMagic), bytes.begin())) {
+        LOG_WARN("Not a preset bank: {}", pathToUtf8(path));
+        close();
+        return false;
+    }
+    const uint32_t version = read32(bytes.data() + 4);
+    if (version > kPresetBankVersion) {
+        LOG_WARN("Preset bank was saved in format version {}, which is newer than this build's {}", version,
+                 kPresetBankVersion);
+        close();
+        return false;
+    }
+    const size_t count = read32(bytes.data() + 8);
+    if ((bytes.size() - kHeaderSize) / kRowSize < count) {
+        LOG_WARN("Preset bank {} is truncated", pathToUtf8(path));
+        close();
+        return false;
+    }
+    count_ = count;
+    return true;
+}
+
+void PresetBank::close() noexcept {
+    file_.close();
+    count_ = 0;
+}
+
+bool PresetBank::getEntry(size_t index, PresetBankEntry& entry) const noexcept {
+    if (index >= count_) return false;
+
+    const auto bytes = file_.bytes();
+    const uint8_t* row = bytes.data() + kHeaderSize + index * kRowSize;
+    const uint64_t offset = read64(row);
+    const uint64_t params_size = read32(row + 8);
+    const uint64_t state_size = read32(row + 12);
+    const uint64_t metadata_size = read32(row + 16);
+    const uint64_t total = params_size + state_size + metadata_size;
+    if (offset > bytes.size() || bytes.size() - offset < total) {
+        LOG_WARN("Preset {} of the bank is out of bounds", index);
+        return false;
+    }
+
+    const auto data = bytes.subspan(static_cast<size_t>(offset), static_cast<size_t>(total));
+    entry.params = data.first(static_cast<size_t>(params_size));
+    entry.state = data.subspan(static_cast<size_t>(params_size), static_cast<size_t>(state_size));
+    entry.metadata = data.last(static_cast<size_t>(metadata_size));
+    return true;
+}
+
+bool PresetBank::getMetadata(size_t index, PresetMetadata& metadata) const {
+    PresetBankEntry entry;
+    return getEntry(index, entry) && decodePresetMetadata(entry.metadata, metadata);
+}
+
+void PresetBankWriter::add(const PresetMetadata& metadata, std::span<const uint8_t> params,
+                           std::span<const uint8_t> state) {
+    presets_.push_back({
+        .params = {params.begin(), params.end()},
+        .state = {state.begin(), state.end()},
+        .metadata = encodePresetMetadata(metadata),
+    });
+}
+
+bool PresetBankWriter::write(const std::filesystem::path& file, PresetBank* open_bank) const {
+    // The header and the offset table, laid out ahead of the data they point to
+    std::vector<uint8_t> head;
+    head.reserve(kHeaderSize + kRowSize * presets_.size());
+    head.insert(head.end(), std::begin(kPresetBankMagic), std::end(kPresetBankMagic));
+    put32(head, kPresetBankVersion);
+    put32(head, static_cast<uint32_t>(presets_.size()));
+    put32(head, 0);
+
+    size_t offset = alignUp(kHeaderSize + kRowSize * presets_.size());
+    for (const Preset& preset : presets_) {
+        put64(head, offset);
+        put32(head, static_cast<uint32_t>(preset.params.size()));
+        put32(head, static_cast<uint32_t>(preset.state.size()));
+        put32(head, static_cast<uint32_t>(preset.metadata.size()));
+        put32(head, 0);
+        offset = alignUp(offset + preset.params.size() + preset.state.size() + preset.metadata.size());
+    }
+
+    std::error_code ec;
+    if (file.has_parent_path()) std::filesystem::create_directories(file.parent_path(), ec);
+
+    // Written next to the bank and renamed over it; rewriting a bank in place would change it under its mappings
+    std::filesystem::path temp_file = file;
+    temp_file += ".tmp";
+    {
+        std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        const auto write = [&out](const std::vector<uint8_t>& bytes) {
+            out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        };
+        const auto pad = [&out](size_t written) {
+            for (size_t i = written; i < alignUp(written); ++i) out.put('\0');
+            return alignUp(written);
+        };
+
+        write(head);
+        size_t written = pad(head.size());
+        for (const Preset& preset : presets_) {
+            write(preset.params);
+            write(preset.state);
+            write(preset.metadata);
+            written = pad(written + preset.params.size() + preset.state.size() + preset.metadata.size());
+        }
+        out.flush();
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temp_file, ec);
+            return false;
+        }
+    }
+
+    // Unmapped for the rename, which Windows refuses while the file is mapped
+    const bool reopen = open_bank != nullptr && open_bank->isOpen();
+    if (reopen) open_bank->close();
+    std::filesystem::rename(temp_file, file, ec);
+    const bool renamed = !ec;
+    if (!renamed) {
+        LOG_WARN("Couldn't write preset bank {}: {}", pathToUtf8(file), ec.message());
+        std::filesystem::remove(temp_file, ec);
+    }
+    if (reopen) open_bank->open(file);
+    return renamed;
+}
+
+}  // namespace applause
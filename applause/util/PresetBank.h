@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <applause/util/MappedFile.h>
+#include <applause/util/PresetFile.h>
+
+namespace applause {
+
+/** First bytes of a preset bank. */
+inline constexpr char kPresetBankMagic[4] = {'A', 'P', 'L', 'K'};
+
+/** Version of the preset bank layout written by this build. */
+inline constexpr uint32_t kPresetBankVersion = 1;
+
+/** The parts of one preset in a PresetBank; views into the mapped file. */
+struct PresetBankEntry {
+    std::span<const uint8_t> params;    /// Parameter block for ParamsExtension::loadFromBytes()
+    std::span<const uint8_t> state;     /// Whatever else the plugin stored with the preset; may be empty
+    std::span<const uint8_t> metadata;  /// Encoded metadata; see PresetBank::getMetadata()
+};
+
+/**
+ * @brief Many presets in one memory-mapped file, each reachable through an offset table without reading the others.
+ *
+ * Layout, all integers little-endian:
+ * - Header: kPresetBankMagic, uint32 version, uint32 preset count, uint32 reserved
+ * - Offset table, one 24-byte row per preset: uint64 offset, then uint32 sizes of the parameter block, the state
+ *   and the metadata, and a reserved uint32
+ * - Preset data, each starting 8-byte aligned: parameter block, state, metadata (see encodePresetMetadata())
+ *
+ * Loading preset N reads its table row and its own bytes and nothing else, straight from the mapping:
+ *
+ * @code
+ * PresetBank bank;
+ * bank.open(factory_bank_path);
+ *
+ * // e.g. on every arrow key press while auditioning
+ * PresetBankEntry entry;
+ * if (bank.getEntry(n, entry)) params_.loadFromBytes(entry.params);
+ * @endcode
+ *
+ * Entries are checked against the file size when accessed, so a truncated or corrupt bank fails per preset rather
+ * than crashing. Banks are written by PresetBankWriter.
+ */
+class PresetBank {
+public:
+    /** Maps the bank at path; false if it can't be mapped or isn't a bank this build can read. */
+    bool open(const std::filesystem::path& path);
+
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept { return file_.isOpen(); }
+
+    /** Number of presets in the bank, 0 if none is open. */
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+
+    /** Fills entry with views of preset index; false if index is out of range or the entry is corrupt. */
+    bool getEntry(size_t index, PresetBankEntry& entry) const noexcept;
+
+    /** Decodes the metadata of preset index. */
+    bool getMetadata(size_t index, PresetMetadata& metadata) const;
+
+private:
+    MappedFile file_;
+    size_t count_ = 0;
+};
+
+/**
+ * @brief Collects presets and writes them as a PresetBank.
+ *
+ * @code
+ * PresetBankWriter writer;
+ * std::vector<uint8_t> params;
+ * for (const auto& preset : presets) {
+ *     loadPreset(preset);
+ *     params.clear();
+ *     params_.saveToBytes(params);
+ *     writer.add(preset.metadata, params);
+ * }
+ * writer.write(bank_path);
+ * @endcode
+ */
+class PresetBankWriter {
+public:
+    /** Appends a preset; the data is copied. */
+    void add(const PresetMetadata& metadata, std::span<const uint8_t> params, std::span<const uint8_t> state = {});
+
+    [[nodiscard]] size_t size() const noexcept { return presets_.size(); }
+
+    /**
+     * Writes the bank to file, replacing it atomically, so open PresetBanks keep reading the old one.
+     *
+     * Windows can't replace a file that is mapped, by this process or any other, so there the rename fails while
+     * a PresetBank has file open. Pass that bank as open_bank to have it closed before the rename and reopened on
+     * whichever file is in place afterwards; its earlier entries are invalid from then on, on every platform.
+     */
+    bool write(const std::filesystem::path& file, PresetBank* open_bank = nullptr) const;
+
+private:
+    struct Preset {
+        std::vector<uint8_t> params;
+        std::vector<uint8_t> state;
+        std::vector<uint8_t> metadata;
+    };
+
+    std::vector<Preset> presets_;
+};
+
+}  // namespace applause
@@ -0,0 +1,117 @@
+#include "PresetFile.h"
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/Json.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+
+namespace applause {
+namespace {
+// Bigger headers are taken for corrupt files rather than allocated
+constexpr uint32_t kMaxPresetHeaderSize = 1u << 20;
+
+void writeUint32(std::ostream& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.put(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+uint32_t decodeUint32(const char* bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i])) << (8 * i);
+    }
+    return value;
+}
+}  // namespace
+
+std::vector<uint8_t> encodePresetMetadata(const PresetMetadata& metadata) {
+    const applause::json document = {
+        {"name", metadata.name},
+        {"tags", metadata.tags},
+        {"creator", metadata.creator},
+        {"description", metadata.description},
+    };
+    return applause::json::to_cbor(document);
+}
+
+bool decodePresetMetadata(std::span<const uint8_t> cbor, PresetMetadata& metadata) {
+    const applause::json document = applause::json::from_cbor(cbor.begin(), cbor.end(), true, false);
+    if (!document.is_object()) return false;
+
+    auto text = [&document](const char* key) {
+        const auto it = document.find(key);
+        return it != document.end() && it->is_string() ? it->get<std::string>() : std::string{};
+    };
+    metadata = {};
+    metadata.name = text("name");
+    metadata.creator = text("creator");
+    metadata.description = text("description");
+    if (const auto tags = document.find("tags"); tags != document.end() && tags->is_array()) {
+        for (const auto& tag : *tags) {
+            if (tag.is_string()) metadata.tags.push_back(tag.get<std::string>());
+        }
+    }
+    return true;
+}
+
+void writePresetHeader(std::ostream& out, const PresetMetadata& metadata) {
+    const std::vector<uint8_t> cbor = encodePresetMetadata(metadata);
+
+    out.write(kPresetFileMagic, sizeof(kPresetFileMagic));
+    writeUint32(out, kPresetFileVersion);
+    writeUint32(out, static_cast<uint32_t>(cbor.size()));
+    out.write(reinterpret_cast<const char*>(cbor.data()), static_cast<std::streamsize>(cbor.size()));
+}
+
+bool readPresetHeader(std::istream& in, PresetMetadata& metadata) {
+    std::array<char, sizeof(kPresetFileMagic) + 8> header{};
+    if (!in.read(header.data(), header.size()) ||
+        !std::equal(std::begin(kPresetFileMagic), std::end(kPresetFileMagic), header.begin())) {
+        LOG_WARN("Not a preset file");
+        return false;
+    }
+    const uint32_t version = decodeUint32(header.data() + sizeof(kPresetFileMagic));
+    if (version > kPresetFileVersion) {
+        LOG_WARN("Preset was saved in format version {}, which is newer than this build's {}", version,
+                 kPresetFileVersion);
+        return false;
+    }
+    const uint32_t size = decodeUint32(header.data() + sizeof(kPresetFileMagic) + 4);
+    if (size > kMaxPresetHeaderSize) {
+        LOG_WARN("Preset header claims {} bytes", size);
+        return false;
+    }
+
+    std::vector<uint8_t> cbor(size);
+    if (!in.read(reinterpret_cast<char*>(cbor.data()), size)) {
+        LOG_WARN("Preset header is truncated");
+        return false;
+    }
+
+    if (!decodePresetMetadata(cbor, metadata)) {
+        LOG_WARN("Preset header is invalid");
+        return false;
+    }
+    return true;
+}
+
+bool readPresetMetadata(const std::filesystem::path& path, PresetMetadata& metadata) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    return readPresetHeader(in, metadata);
+}
+
+std::string pathToUtf8(const std::filesystem::path& path) {
+    const std::u8string utf8 = path.generic_u8string();
+    return {utf8.begin(), utf8.end()};
+}
+
+std::filesystem::path pathFromUtf8(const std::string& utf8) {
+    return std::filesystem::path(std::u8string(utf8.begin(), utf8.end()));
+}
+
+}  // namespace applause
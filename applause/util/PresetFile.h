@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace applause {
+
+/** First bytes of a preset file. */
+inline constexpr char kPresetFileMagic[4] = {'A', 'P', 'L', 'P'};
+
+/** Version of the preset file container written by this build. */
+inline constexpr uint32_t kPresetFileVersion = 1;
+
+/** Extension, without the leading dot, of the preset files PresetLoadExtension writes by default. */
+inline constexpr const char* kPresetFileExtension = "aplp";
+
+/**
+ * @brief What a preset browser shows about a preset, stored in the preset file's header.
+ */
+struct PresetMetadata {
+    std::string name{};               /// Display name (if empty, browsers use the file name)
+    std::vector<std::string> tags{};  /// Free-form tags, e.g. "bass", "pad"; reported to hosts as preset features
+    std::string creator{};
+    std::string description{};
+
+    bool operator==(const PresetMetadata&) const = default;
+};
+
+/** The metadata as the CBOR document preset files and banks store it in. */
+std::vector<uint8_t> encodePresetMetadata(const PresetMetadata& metadata);
+
+/** Decodes metadata written by encodePresetMetadata(); false if cbor isn't such a document. */
+bool decodePresetMetadata(std::span<const uint8_t> cbor, PresetMetadata& metadata);
+
+/**
+ * Writes a preset file header: kPresetFileMagic, a little-endian uint32 version, a little-endian uint32 byte count
+ * and the metadata as CBOR. The plugin state follows it, as written by StateExtension::saveToStream().
+ *
+ * Keeping the metadata in its own length-prefixed block lets preset scans read a few hundred bytes per file and
+ * never touch the state.
+ */
+void writePresetHeader(std::ostream& out, const PresetMetadata& metadata);
+
+/**
+ * Reads a preset file header written by writePresetHeader(), leaving the stream at the start of the state.
+ * @return false, with a warning logged, if the stream isn't a preset or comes from a newer build.
+ */
+bool readPresetHeader(std::istream& in, PresetMetadata& metadata);
+
+/** Reads just the header of the preset file at path. */
+bool readPresetMetadata(const std::filesystem::path& path, PresetMetadata& metadata);
+
+/** A path as the UTF-8 string CLAP hosts exchange paths in. */
+std::string pathToUtf8(const std::filesystem::path& path);
+
+/** The path of a UTF-8 string from a CLAP host. */
+std::filesystem::path pathFromUtf8(const std::string& utf8);
+
+}  // namespace applause
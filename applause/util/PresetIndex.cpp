@@ -0,0 +1,261 @@
+#include "PresetIndex.h"
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/Json.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <unordered_set>
+
+namespace applause {
+namespace fs = std::filesystem;
+
+namespace {
+// Bump when the index file layout changes; older index files are then rebuilt instead of read
+constexpr int kPresetIndexVersion = 2;
+
+// A temp file next to file that no other save, in this process or another, writes at the same time
+fs::path uniqueTempPath(const fs::path& file) {
+    static const uint32_t process_token = std::random_device{}();
+    static std::atomic<uint64_t> counter{0};
+    fs::path temp = file;
+    temp += ".tmp-" + std::to_string(process_token) + "-" + std::to_string(counter.fetch_add(1));
+    return temp;
+}
+}  // namespace
+
+PresetIndex::PresetIndex(std::string file_extension) : extension_(std::move(file_extension)) {}
+
+std::string PresetIndex::keyOf(const fs::path& path) {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    if (ec) absolute = path;
+    return pathToUtf8(absolute.lexically_normal());
+}
+
+std::string PresetIndex::keyOfDirectory(const fs::path& directory) {
+    std::string prefix = keyOf(directory);
+    if (prefix.empty() || prefix.back() != '/') prefix.push_back('/');
+    return prefix;
+}
+
+bool PresetIndex::load(const fs::path& index_file) {
+    entries_.clear();
+    failed_.clear();
+    dirty_ = false;
+
+    std::ifstream in(index_file, std::ios::binary);
+    if (!in) return false;
+
+    try {
+        const applause::json document = applause::json::from_cbor(in, true, false);
+        if (!document.is_object() || document.value("version", 0) != kPresetIndexVersion ||
+            document.value("extension", std::string{}) != extension_) {
+            LOG_INFO("Preset index {} is outdated; rebuilding", pathToUtf8(index_file));
+            return false;
+        }
+
+        for (const auto& item : document.at("entries")) {
+            PresetIndexEntry entry;
+            entry.path = item.at("path").get<std::string>();
+            entry.modified = item.at("modified").get<int64_t>();
+            entry.size = item.at("size").get<uint64_t>();
+            entry.metadata.name = item.at("name").get<std::string>();
+            entry.metadata.tags = item.at("tags").get<std::vector<std::string>>();
+            entry.metadata.creator = item.at("creator").get<std::string>();
+            entry.metadata.description = item.at("description").get<std::string>();
+            std::string key = entry.path;
+            entries_.insert_or_assign(std::move(key), std::move(entry));
+        }
+        for (const auto& item : document.at("failed")) {
+            failed_.insert_or_assign(item.at("path").get<std::string>(),
+                                     FailedFile{item.at("modified").get<int64_t>(), item.at("size").get<uint64_t>()});
+        }
+        return true;
+    } catch (const std::exception& e) {
+        LOG_WARN("Preset index {} is corrupt: {}", pathToUtf8(index_file), e.what());
+        entries_.clear();
+        failed_.clear();
+        return false;
+    }
+}
+
+bool PresetIndex::save(const fs::path& index_file) {
+    // Sorted, so an unchanged index is written identically
+    std::vector<const PresetIndexEntry*> sorted;
+    sorted.reserve(entries_.size());
+    for (const auto& [key, entry] : entries_) sorted.push_back(&entry);
+    std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->path < b->path; });
+
+    applause::json items = applause::json::array();
+    for (const auto* entry : sorted) {
+        items.push_back({
+            {"path", entry->path},
+            {"modified", entry->modified},
+            {"size", entry->size},
+            {"name", entry->metadata.name},
+            {"tags", entry->metadata.tags},
+            {"creator", entry->metadata.creator},
+            {"description", entry->metadata.description},
+        });
+    }
+    std::vector<std::pair<const std::string*, const FailedFile*>> failed;
+    failed.reserve(failed_.size());
+    for (const auto& [key, file] : failed_) failed.emplace_back(&key, &file);
+    std::sort(failed.begin(), failed.end(), [](const auto& a, const auto& b) { return *a.first < *b.first; });
+
+    applause::json failed_items = applause::json::array();
+    for (const auto& [path, file] : failed) {
+        failed_items.push_back({{"path", *path}, {"modified", file->modified}, {"size", file->size}});
+    }
+
+    const applause::json document = {
+        {"version", kPresetIndexVersion},
+        {"extension", extension_},
+        {"entries", std::move(items)},
+        {"failed", std::move(failed_items)},
+    };
+
+    std::error_code ec;
+    if (index_file.has_parent_path()) fs::create_directories(index_file.parent_path(), ec);
+
+    // Written next to the index and renamed over it, so readers see either the old or the new index
+    const fs::path temp_file = uniqueTempPath(index_file);
+    {
+        std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        applause::json::to_cbor(document, out);
+        out.flush();
+        if (!out) {
+            out.close();
+            fs::remove(temp_file, ec);
+            return false;
+        }
+    }
+    fs::rename(temp_file, index_file, ec);
+    if (ec) {
+        LOG_WARN("Couldn't write preset index {}: {}", pathToUtf8(index_file), ec.message());
+        fs::remove(temp_file, ec);
+        return false;
+    }
+    dirty_ = false;
+    return true;
+}
+
+PresetIndexStats PresetIndex::refresh(const fs::path& directory) {
+    PresetIndexStats stats;
+    const std::string prefix = keyOfDirectory(directory);
+    const fs::path extension = "." + extension_;
+    std::unordered_set<std::string> seen;
+
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(directory, fs::directory_options::skip_permission_denied, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        const fs::directory_entry& file = *it;
+        std::error_code file_ec;
+        if (!file.is_regular_file(file_ec) || file.path().extension() != extension) continue;
+
+        // Directory iteration usually has these cached, so unchanged files cost no extra system calls
+        const auto modified = file.last_write_time(file_ec);
+        if (file_ec) continue;
+        const auto size = file.file_size(file_ec);
+        if (file_ec) continue;
+
+        std::string key = keyOf(file.path());
+        const bool known = entries_.contains(key);
+        switch (update(key, file.path(), modified.time_since_epoch().count(), size)) {
+            case Update::Reused: stats.reused++; break;
+            case Update::Read: stats.read++; break;
+            case Update::Failed: stats.removed += known ? 1 : 0; break;
+            case Update::Skipped: stats.skipped++; break;
+        }
+        seen.insert(std::move(key));
+    }
+
+    // Drop the entries of files that disappeared
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->first.starts_with(prefix) && !seen.contains(it->first)) {
+            it = entries_.erase(it);
+            stats.removed++;
+            dirty_ = true;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = failed_.begin(); it != failed_.end();) {
+        if (it->first.starts_with(prefix) && !seen.contains(it->first)) {
+            it = failed_.erase(it);
+            dirty_ = true;
+        } else {
+            ++it;
+        }
+    }
+    return stats;
+}
+
+const PresetIndexEntry* PresetIndex::refreshFile(const fs::path& file) {
+    const std::string key = keyOf(file);
+    std::error_code ec;
+    const auto modified = fs::last_write_time(file, ec);
+    const auto size = ec ? 0 : fs::file_size(file, ec);
+    if (ec) {
+        if (entries_.erase(key) + failed_.erase(key) > 0) dirty_ = true;
+        return nullptr;
+    }
+    const Update result = update(key, file, modified.time_since_epoch().count(), size);
+    if (result == Update::Failed || result == Update::Skipped) return nullptr;
+    return &entries_.at(key);
+}
+
+const PresetIndexEntry* PresetIndex::find(const fs::path& file) const {
+    const auto it = entries_.find(keyOf(file));
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+std::vector<const PresetIndexEntry*> PresetIndex::entriesIn(const fs::path& directory) const {
+    const std::string prefix = keyOfDirectory(directory);
+    std::vector<const PresetIndexEntry*> result;
+    for (const auto& [key, entry] : entries_) {
+        if (key.starts_with(prefix)) result.push_back(&entry);
+    }
+    std::sort(result.begin(), result.end(), [](const auto* a, const auto* b) { return a->path < b->path; });
+    return result;
+}
+
+PresetIndex::Update PresetIndex::update(const std::string& key, const fs::path& file, int64_t modified,
+                                        uint64_t size) {
+    const auto it = entries_.find(key);
+    if (it != entries_.end() && it->second.modified == modified && it->second.size == size) return Update::Reused;
+    const auto failed = failed_.find(key);
+    if (failed != failed_.end() && failed->second.modified == modified && failed->second.size == size) {
+        return Update::Skipped;
+    }
+
+    PresetMetadata metadata;
+    bool read = false;
+    try {
+        read = readPresetMetadata(file, metadata);
+    } catch (const std::exception& e) {
+        LOG_WARN("Couldn't read preset {}: {}", key, e.what());
+    }
+    if (!read) {
+        if (it != entries_.end()) entries_.erase(it);
+        failed_.insert_or_assign(key, FailedFile{modified, size});
+        dirty_ = true;
+        return Update::Failed;
+    }
+    if (failed != failed_.end()) failed_.erase(failed);
+
+    PresetIndexEntry& entry = entries_[key];
+    entry.path = key;
+    entry.metadata = std::move(metadata);
+    entry.modified = modified;
+    entry.size = size;
+    dirty_ = true;
+    return Update::Read;
+}
+
+}  // namespace applause
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <applause/util/PresetFile.h>
+
+namespace applause {
+
+/** A preset file as last seen by a PresetIndex. */
+struct PresetIndexEntry {
+    std::string path;          /// Absolute, normalized UTF-8 path; see pathToUtf8()
+    PresetMetadata metadata;
+    int64_t modified = 0;      /// std::filesystem::last_write_time() ticks
+    uint64_t size = 0;         /// File size in bytes
+};
+
+/** What a PresetIndex::refresh() had to do. */
+struct PresetIndexStats {
+    size_t reused = 0;   ///< Unchanged files, served from the index
+    size_t read = 0;     ///< New or changed files whose headers were read
+    size_t removed = 0;  ///< Entries of deleted or no longer readable files
+    size_t skipped = 0;  ///< Unchanged files that failed to read before, not reopened
+};
+
+/**
+ * @brief A metadata cache of preset files, kept on disk so preset scans don't reopen every file.
+ *
+ * refresh() walks a directory and only reads the headers of files whose modification time or size changed since
+ * the index last saw them; everything else is answered from the index. Files that fail to read are remembered
+ * too, and only retried once they change. With save() and load() around it, scanning a library of thousands of
+ * presets costs one directory walk when nothing changed.
+ *
+ * Not thread safe; give each thread its own index. save() writes a temp file of its own and renames it over the
+ * index file, so concurrent indexes sharing a file never read a partial one, and the last save wins.
+ */
+class PresetIndex {
+public:
+    /** @param file_extension Extension of the files to index, without the leading dot. */
+    explicit PresetIndex(std::string file_extension = kPresetFileExtension);
+
+    /**
+     * Replaces the index with the one in index_file. A missing, corrupt or outdated file leaves the index empty
+     * and returns false, so the next refresh() rebuilds it.
+     */
+    bool load(const std::filesystem::path& index_file);
+
+    /** Writes the index to index_file and clears isDirty(). */
+    bool save(const std::filesystem::path& index_file);
+
+    /** Brings the entries under directory (recursively) up to date with the files on disk. */
+    PresetIndexStats refresh(const std::filesystem::path& directory);
+
+    /** Brings the entry of a single file up to date; nullptr if it isn't a readable preset. */
+    const PresetIndexEntry* refreshFile(const std::filesystem::path& file);
+
+    /** The entry of a file as last refreshed, or nullptr. */
+    [[nodiscard]] const PresetIndexEntry* find(const std::filesystem::path& file) const;
+
+    /** The entries under directory (recursively), sorted by path. */
+    [[nodiscard]] std::vector<const PresetIndexEntry*> entriesIn(const std::filesystem::path& directory) const;
+
+    [[nodiscard]] size_t size() const noexcept { return entries_.size(); }
+
+    /** Whether the index changed since it was last loaded or saved. */
+    [[nodiscard]] bool isDirty() const noexcept { return dirty_; }
+
+    /** The key the index stores a file under. */
+    static std::string keyOf(const std::filesystem::path& path);
+
+    /** The prefix of the keys of everything under directory, ending in a slash. */
+    static std::string keyOfDirectory(const std::filesystem::path& directory);
+
+private:
+    enum class Update { Reused, Read, Failed, Skipped };
+
+    // The modification time and size of a file that failed to read
+    struct FailedFile {
+        int64_t modified = 0;
+        uint64_t size = 0;
+    };
+
+    Update update(const std::string& key, const std::filesystem::path& file, int64_t modified, uint64_t size);
+
+    std::string extension_;
+    std::unordered_map<std::string, PresetIndexEntry> entries_;
+    std::unordered_map<std::string, FailedFile> failed_;
+    bool dirty_ = false;
+};
+
+}  // namespace applause
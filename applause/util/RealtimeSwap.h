@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace applause {
+
+/**
+ * Hands complete objects, e.g. DSP state rebuilt by a state load, from the main thread to the audio thread without
+ * locks, and takes the replaced ones back so they're never freed on the audio thread.
+ *
+ * The main thread builds the new object off to the side and publish()es it. The audio thread calls update() at a
+ * block boundary, which swaps the object in with one atomic exchange, and reads it through get() for the rest of
+ * the block. The object it replaced is parked until the main thread's next publish() or collect() deletes it, and
+ * the audio thread doesn't swap again until then; call collect() now and then (e.g. from a UI timer) so a publish()
+ * racing with a swap isn't held back. Publishing again before the audio thread picked up the previous object
+ * deletes that one instead.
+ *
+ * @code
+ * // Main thread, e.g. in the StateExtension load callback
+ * auto next = std::make_unique<DspState>(json);
+ * dsp_state_.publish(std::move(next));
+ *
+ * // Audio thread, at the start of process()
+ * dsp_state_.update();
+ * const DspState& state = *dsp_state_.get();
+ * @endcode
+ */
+template <typename T>
+class RealtimeSwap {
+public:
+    explicit RealtimeSwap(std::unique_ptr<T> initial = nullptr) noexcept : current_(initial.release()) {}
+
+    ~RealtimeSwap() {
+        delete current_;
+        delete pending_.load(std::memory_order_acquire);
+        delete retired_.load(std::memory_order_acquire);
+    }
+
+    RealtimeSwap(const RealtimeSwap&) = delete;
+    RealtimeSwap& operator=(const RealtimeSwap&) = delete;
+
+    /** Main thread: queues next to replace the current object at the audio thread's next update(). */
+    void publish(std::unique_ptr<T> next) {
+        collect();
+        delete pending_.exchange(next.release(), std::memory_order_acq_rel);
+        collect();  // In case the audio thread swapped in the meantime
+    }
+
+    /** Main thread: deletes the object the audio thread last replaced, if any. */
+    void collect() { delete retired_.exchange(nullptr, std::memory_order_acquire); }
+
+    /**
+     * Audio thread: swaps in the last published object, if there is one, and returns whether the current object
+     * changed. Waits for the main thread to collect() the previously replaced object first. Never allocates or frees.
+     */
+    bool update() noexcept {
+        if (pending_.load(std::memory_order_relaxed) == nullptr) return false;
+        if (retired_.load(std::memory_order_acquire) != nullptr) return false;
+
+        T* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+        if (next == nullptr) return false;
+        retired_.store(current_, std::memory_order_release);
+        current_ = next;
+        return true;
+    }
+
+    /** Audio thread: the current object, or nullptr before the first one. */
+    [[nodiscard]] T* get() const noexcept { return current_; }
+
+    /** Whether a published object is waiting for update(). */
+    [[nodiscard]] bool hasPending() const noexcept { return pending_.load(std::memory_order_acquire) != nullptr; }
+
+private:
+    T* current_;
+    std::atomic<T*> pending_{nullptr};
+    std::atomic<T*> retired_{nullptr};
+};
+
+}  // namespace applause
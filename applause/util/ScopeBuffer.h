@@ -0,0 +1,135 @@
+#pragma once
+
+#include <applause/util/DebugHelpers.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+namespace applause {
+
+/**
+ * Wait-free pipe for audio the UI wants to draw: oscilloscopes, meters, spectrum displays.
+ *
+ * The audio thread push()es blocks of one or more channels into a ring that it overwrites freely; it never waits
+ * for, or even knows about, the reader. The UI thread calls readLatest() whenever it draws and gets the newest
+ * window of frames. The reader checks afterwards whether the producer overwrote anything it copied and retries if
+ * so, so it never returns a torn window; a window of at most half the capacity is practically never retried.
+ *
+ * With a decimation of n only every nth frame is stored (without filtering: it's for drawing, not listening),
+ * which stretches the time a ring of a given capacity covers. The phase carries over between blocks.
+ *
+ * push() stores one relaxed atomic per stored sample and nothing else, so taps on several points per voice in a
+ * debug view are cheap. Only one thread may push and only one may read.
+ *
+ * @code
+ * // Audio thread, e.g. at the end of process()
+ * scope_.push(output.data32, frames);
+ *
+ * // UI thread, when drawing
+ * std::array<float, 512> left, right;
+ * float* channels[] = {left.data(), right.data()};
+ * const uint32_t n = scope_.readLatest(channels, 512);  // n < 512 until enough audio arrived
+ * @endcode
+ */
+class ScopeBuffer {
+public:
+    /**
+     * @param num_channels channels in each pushed block
+     * @param capacity frames kept per channel after decimation; rounded up to a power of two
+     * @param decimation store every nth pushed frame
+     */
+    ScopeBuffer(uint32_t num_channels, uint32_t capacity, uint32_t decimation = 1)
+        : num_channels_(num_channels),
+          capacity_(std::bit_ceil(std::max(capacity, 1u))),
+          mask_(capacity_ - 1),
+          decimation_(std::max(decimation, 1u)),
+          samples_(std::make_unique<std::atomic<float>[]>(static_cast<size_t>(num_channels_) * capacity_)) {
+        ASSERT(num_channels > 0, "ScopeBuffer needs at least one channel");
+    }
+
+    ScopeBuffer(const ScopeBuffer&) = delete;
+    ScopeBuffer& operator=(const ScopeBuffer&) = delete;
+
+    /** Audio thread: appends num_frames frames of getNumChannels() channels. Wait-free; never allocates. */
+    void push(const float* const* channels, uint32_t num_frames) noexcept {
+        // Frames this block stores: the one phase_ points at, then every decimation_th after it
+        if (phase_ >= num_frames) {
+            phase_ -= num_frames;
+            return;
+        }
+        const uint32_t count = (num_frames - phase_ - 1) / decimation_ + 1;
+        const uint64_t start = position_;
+        position_ += count;
+
+        // Announce the slots about to be overwritten before touching them; the reader checks this afterwards
+        claimed_.store(position_, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (uint32_t ch = 0; ch < num_channels_; ++ch) {
+            const float* in = channels[ch];
+            std::atomic<float>* ring = samples_.get() + static_cast<size_t>(ch) * capacity_;
+            uint64_t pos = start;
+            for (uint32_t frame = phase_; frame < num_frames; frame += decimation_) {
+                ring[pos++ & mask_].store(in[frame], std::memory_order_relaxed);
+            }
+        }
+        phase_ = phase_ + count * decimation_ - num_frames;
+
+        written_.store(position_, std::memory_order_release);
+    }
+
+    /**
+     * UI thread: copies the newest frames, up to num_frames and the capacity, oldest first, into out[channel].
+     * Returns the number of frames copied, which is smaller than requested until enough audio was pushed, and 0 if
+     * the producer kept overwriting the window faster than it could be copied.
+     */
+    uint32_t readLatest(float* const* out, uint32_t num_frames) const noexcept {
+        for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+            const uint64_t end = written_.load(std::memory_order_acquire);
+            const auto count = static_cast<uint32_t>(std::min<uint64_t>({num_frames, end, capacity_}));
+            const uint64_t begin = end - count;
+
+            for (uint32_t ch = 0; ch < num_channels_; ++ch) {
+                const std::atomic<float>* ring = samples_.get() + static_cast<size_t>(ch) * capacity_;
+                for (uint32_t i = 0; i < count; ++i) {
+                    out[ch][i] = ring[(begin + i) & mask_].load(std::memory_order_relaxed);
+                }
+            }
+
+            // Valid if the producer hasn't claimed the slots of any frame we copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (claimed_.load(std::memory_order_relaxed) <= begin + capacity_) return count;
+        }
+        return 0;
+    }
+
+    /** Frames stored since construction; lets the UI skip redrawing when nothing new arrived. */
+    [[nodiscard]] uint64_t getWritePosition() const noexcept { return written_.load(std::memory_order_acquire); }
+
+    [[nodiscard]] uint32_t getNumChannels() const noexcept { return num_channels_; }
+
+    [[nodiscard]] uint32_t getCapacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] uint32_t getDecimation() const noexcept { return decimation_; }
+
+private:
+    static constexpr int kMaxReadAttempts = 4;
+
+    const uint32_t num_channels_;
+    const uint32_t capacity_;
+    const uint64_t mask_;
+    const uint32_t decimation_;
+    std::unique_ptr<std::atomic<float>[]> samples_;  // num_channels_ rings of capacity_ frames
+
+    // Producer only
+    uint64_t position_ = 0;
+    uint32_t phase_ = 0;  // Frames to skip at the start of the next block
+
+    std::atomic<uint64_t> claimed_{0};  // Frames whose slots the producer may be overwriting
+    std::atomic<uint64_t> written_{0};  // Frames fully stored
+};
+
+}  // namespace applause
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace applause {
+
+/**
+ * Immutable objects shared by reference count between everyone in the process who asks for the same key, e.g. the
+ * editors of several plugin instances loading the same icon.
+ *
+ * The first getOrCreate() for a key builds the object; later calls, from any instance, get the same one for as long
+ * as someone still holds it. The cache itself only keeps weak references: the object is destroyed together with its
+ * last holder, so closing every editor frees every resource, and the next request builds it again.
+ *
+ * Thread-safe. The factory runs under the cache's lock, so two instances asking for the same key at the same time
+ * build it once; factories must not call back into the same cache.
+ *
+ * @code
+ * static SharedCache<std::string, Wavetable> tables;
+ * auto table = tables.getOrCreate(path, [&] { return std::make_shared<Wavetable>(loadWavetable(path)); });
+ * @endcode
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class SharedCache {
+public:
+    /** The live object for key, or the one factory() returns (a shared_ptr to T or nullptr, which isn't cached). */
+    template <typename Factory>
+    std::shared_ptr<const T> getOrCreate(const Key& key, Factory&& factory) {
+        std::lock_guard lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            if (auto existing = it->second.lock()) return existing;
+        }
+
+        std::shared_ptr<const T> created = std::forward<Factory>(factory)();
+        if (!created) return nullptr;
+        if (it != entries_.end()) {
+            it->second = created;
+        } else {
+            pruneLocked();
+            entries_.emplace(key, created);
+        }
+        return created;
+    }
+
+    /** The live object for key, or nullptr. */
+    std::shared_ptr<const T> find(const Key& key) const {
+        std::lock_guard lock(mutex_);
+        auto it = entries_.find(key);
+        return it != entries_.end() ? it->second.lock() : nullptr;
+    }
+
+    /** Objects currently alive. */
+    [[nodiscard]] size_t size() const {
+        std::lock_guard lock(mutex_);
+        size_t alive = 0;
+        for (const auto& [key, entry] : entries_) alive += !entry.expired();
+        return alive;
+    }
+
+private:
+    // Forget entries whose objects are gone; runs before each new key so expired keys can't pile up
+    void pruneLocked() {
+        std::erase_if(entries_, [](const auto& entry) { return entry.second.expired(); });
+    }
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, std::weak_ptr<const T>, Hash> entries_;
+};
+
+}  // namespace applause
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <applause/core/RealtimeSafety.h>
+#include <applause/util/ContentHash.h>
+#include <applause/util/SharedCache.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace applause {
+
+/**
+ * The process-wide registry of immutable DSP tables (wavetable mipmaps, baked MSEG curves, convolution kernels),
+ * keyed by a ContentHasher hash of what they're built from.
+ *
+ * Every instance of a plugin that loads the same wavetable or impulse response builds the same table; asking here
+ * instead builds it once for the whole process, and every later instance gets the same read-only object for as
+ * long as any instance still holds it. There is one SharedCache per table type, so a Wavetable and an MSEGTable
+ * never collide even with one hash.
+ *
+ * Build tables off the audio thread: getOrBuild() locks, and build() runs under that lock, so a second instance
+ * asking for the same content waits for the first build instead of repeating it. Hand the result to the audio
+ * thread as usual, e.g. through a RealtimeSwap of the shared_ptr, so the last reference is never dropped there.
+ *
+ * Wavetable::shared(), MSEGTable::bakeShared() and ConvolverKernel::shared() hash their inputs and go through here.
+ *
+ * @code
+ * const uint64_t key = ContentHasher().add(samples).add(frame_size).value();
+ * auto table = SharedTables::getOrBuild<Wavetable>(key, [&] { return std::make_shared<Wavetable>(samples, 2048); });
+ * @endcode
+ */
+class SharedTables {
+public:
+    /** The live T built from content_hash, or the one build() returns (a shared_ptr to T, or nullptr). */
+    template <typename T, typename Build>
+    static std::shared_ptr<const T> getOrBuild(uint64_t content_hash, Build&& build) {
+        APPLAUSE_ASSERT_NOT_REALTIME("SharedTables::getOrBuild; build shared tables off the audio thread");
+        return cache<T>().getOrCreate(content_hash, std::forward<Build>(build));
+    }
+
+    /** The live T built from content_hash, or nullptr. */
+    template <typename T>
+    static std::shared_ptr<const T> find(uint64_t content_hash) {
+        return cache<T>().find(content_hash);
+    }
+
+    /** Tables of type T currently alive. */
+    template <typename T>
+    [[nodiscard]] static size_t size() {
+        return cache<T>().size();
+    }
+
+private:
+    template <typename T>
+    static SharedCache<uint64_t, T>& cache() {
+        static SharedCache<uint64_t, T> tables;
+        return tables;
+    }
+};
+
+}  // namespace applause
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <applause/dsp/FastMath.h>
+
 #include <cmath>
 #include <cstdint>
 
@@ -33,10 +35,11 @@ struct ValueScaling {
 
     [[nodiscard]] float fromNormalized(float norm, float min, float max) const noexcept {
         switch (type) {
+        // Clamped because the fast exp2 can land just outside the range at the endpoints
         case ValueScale::Frequency:
-            return a * std::exp2(norm * b / 12.0f);
+            return std::fmin(std::fmax(a * math::exp2(norm * b / 12.0f), min), max);
         case ValueScale::Time:
-            return a * std::pow(10.0f, norm * b);
+            return std::fmin(std::fmax(a * math::exp2(norm * b * 3.32192809489f), min), max);  // 10^x = 2^(x log2(10))
         case ValueScale::Quadratic:
             return min + (norm * norm) * (max - min);
         case ValueScale::Linear:
@@ -45,7 +48,7 @@ struct ValueScaling {
         }
     }
 
-    static ValueScaling linear() { return {ValueScale::Linear, 0.0f, 0.0f}; }
+    static constexpr ValueScaling linear() { return {ValueScale::Linear, 0.0f, 0.0f}; }
 
     static ValueScaling frequency(float minHz, float maxHz) {
         float semitones = 12.0f * std::log2(maxHz / minHz);
@@ -57,7 +60,7 @@ struct ValueScaling {
         return {ValueScale::Time, minSec, decades};
     }
 
-    static ValueScaling quadratic() { return {ValueScale::Quadratic, 0.0f, 0.0f}; }
+    static constexpr ValueScaling quadratic() { return {ValueScale::Quadratic, 0.0f, 0.0f}; }
 };
 
 struct ValueScaleInfo {
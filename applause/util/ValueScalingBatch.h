@@ -0,0 +1,248 @@
+#pragma once
+
+#include <applause/dsp/FastMath.h>
+#include <applause/util/SampleType.h>
+#include <applause/util/ValueScaling.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace applause {
+
+/**
+ * Accuracy of batch ValueScaling conversions.
+ *
+ * - Fast:  SIMD conversion using fast::exp2 / fast::log2. Plain values are within 1e-6 relative error of the
+ *          exact conversion; normalized values are within 1e-6 absolute error for frequency ranges of at least
+ *          an octave and time ranges of at least a factor of two. Linear and quadratic scales are exact up to
+ *          float rounding.
+ * - Exact: calls ValueScaling::fromNormalized / toNormalized per value, so results match the scalar API. That API
+ *          uses math::exp2, which is itself approximate when APPLAUSE_FAST_MATH is on; frequency and time results
+ *          are clamped to [min, max] in both modes.
+ */
+enum class ScalingPrecision : uint8_t { Fast, Exact };
+
+namespace scaling_detail {
+inline constexpr float kLog2Of10 = 3.32192809488736235f;
+inline constexpr float kLog10Of2 = 0.30102999566398120f;
+
+// Fast-path conversions of already-clamped values; the per-entry range arrives as samples so the batch converter
+// can feed one range per lane.
+template <Sample S>
+inline S fastFromNormalized(ValueScale type, S norm, S min, S max, S a, S b) noexcept {
+    switch (type) {
+    // Clamped for the same reason as ValueScaling::fromNormalized
+    case ValueScale::Frequency:
+        return applause::min(applause::max(a * fast::exp2(norm * b * S(1.0f / 12.0f)), min), max);
+    case ValueScale::Time: return applause::min(applause::max(a * fast::exp2(norm * b * S(kLog2Of10)), min), max);
+    case ValueScale::Quadratic: return min + (norm * norm) * (max - min);
+    case ValueScale::Linear:
+    default: return min + norm * (max - min);
+    }
+}
+
+template <Sample S>
+inline S fastToNormalized(ValueScale type, S plain, S min, S max, S a, S b) noexcept {
+    switch (type) {
+    case ValueScale::Frequency: return fast::log2(plain / a) * S(12.0f) / b;
+    case ValueScale::Time: return fast::log2(plain / a) * S(kLog10Of2) / b;
+    case ValueScale::Quadratic: return applause::sqrt((plain - min) / (max - min));
+    case ValueScale::Linear:
+    default: return (plain - min) / (max - min);
+    }
+}
+}  // namespace scaling_detail
+
+/**
+ * Normalized -> plain conversion of a scalar or SIMD batch of values sharing one scale. Unlike
+ * ValueScaling::fromNormalized, the input is clamped to [0, 1] first.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S fromNormalized(const ValueScaleInfo& info, S norm, ScalingPrecision precision) noexcept {
+    norm = applause::min(applause::max(norm, S(0.0f)), S(1.0f));
+
+    if (precision == ScalingPrecision::Exact) {
+        if constexpr (SimdBatch<S>) {
+            alignas(64) float lanes[S::size];
+            norm.store_aligned(lanes);
+            for (auto& x : lanes) x = info.scaling.fromNormalized(x, info.min, info.max);
+            return S::load_aligned(lanes);
+        } else {
+            return info.scaling.fromNormalized(norm, info.min, info.max);
+        }
+    }
+
+    return scaling_detail::fastFromNormalized(info.scaling.type, norm, S(info.min), S(info.max),
+                                              S(info.scaling.a), S(info.scaling.b));
+}
+
+/**
+ * Plain -> normalized conversion of a scalar or SIMD batch of values sharing one scale. Unlike
+ * ValueScaling::toNormalized, the input is clamped to [min, max] first.
+ */
+template <Sample S>
+    requires std::same_as<scalar_t<S>, float>
+inline S toNormalized(const ValueScaleInfo& info, S plain, ScalingPrecision precision) noexcept {
+    plain = applause::min(applause::max(plain, S(info.min)), S(info.max));
+
+    if (precision == ScalingPrecision::Exact) {
+        if constexpr (SimdBatch<S>) {
+            alignas(64) float lanes[S::size];
+            plain.store_aligned(lanes);
+            for (auto& x : lanes) x = info.scaling.toNormalized(x, info.min, info.max);
+            return S::load_aligned(lanes);
+        } else {
+            return info.scaling.toNormalized(plain, info.min, info.max);
+        }
+    }
+
+    return scaling_detail::fastToNormalized(info.scaling.type, plain, S(info.min), S(info.max),
+                                            S(info.scaling.a), S(info.scaling.b));
+}
+
+/**
+ * Converts a fixed set of indexed values between normalized and plain ranges in one call.
+ *
+ * Entries are grouped by ValueScale when they are added, with each group's ranges stored as parallel arrays, so
+ * a conversion runs one branch-free SIMD loop per scale type instead of switching on the type for every value.
+ * Values are gathered from and scattered back to their index in the caller's arrays; entries not in the set are
+ * left untouched.
+ *
+ * Building the set allocates; converting never does. Call reserve() up front if the set is rebuilt on a
+ * thread that must not allocate.
+ */
+class ValueScalingBatch {
+public:
+    void reserve(size_t n) {
+        for (auto& g : groups_) {
+            g.index.reserve(n);
+            g.min.reserve(n);
+            g.max.reserve(n);
+            g.a.reserve(n);
+            g.b.reserve(n);
+        }
+    }
+
+    void clear() noexcept {
+        for (auto& g : groups_) {
+            g.index.clear();
+            g.min.clear();
+            g.max.clear();
+            g.a.clear();
+            g.b.clear();
+        }
+    }
+
+    /** Adds the value at @p index with the given scale. An index should be added at most once. */
+    void add(uint16_t index, const ValueScaleInfo& info) {
+        auto& g = groups_[static_cast<size_t>(info.scaling.type)];
+        g.index.push_back(index);
+        g.min.push_back(info.min);
+        g.max.push_back(info.max);
+        g.a.push_back(info.scaling.a);
+        g.b.push_back(info.scaling.b);
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        size_t n = 0;
+        for (const auto& g : groups_) n += g.index.size();
+        return n;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    /** Copies other's entries into this set, reusing the reserved storage. */
+    void copyFrom(const ValueScalingBatch& other) {
+        for (size_t t = 0; t < groups_.size(); ++t) {
+            auto& g = groups_[t];
+            const auto& o = other.groups_[t];
+            g.index = o.index;
+            g.min = o.min;
+            g.max = o.max;
+            g.a = o.a;
+            g.b = o.b;
+        }
+    }
+
+    /**
+     * plain[i] = fromNormalized(norm[i]) for every index i in the set, with norm[i] clamped to [0, 1].
+     * @p norm and @p plain may alias.
+     */
+    void fromNormalized(const float* norm, float* plain, ScalingPrecision precision) const noexcept {
+        convert<true>(norm, plain, precision);
+    }
+
+    /**
+     * norm[i] = toNormalized(plain[i]) for every index i in the set, with plain[i] clamped to its range.
+     * @p plain and @p norm may alias.
+     */
+    void toNormalized(const float* plain, float* norm, ScalingPrecision precision) const noexcept {
+        convert<false>(plain, norm, precision);
+    }
+
+private:
+    using Batch = xsimd::batch<float>;
+    static constexpr size_t kWidth = Batch::size;
+
+    struct Group {
+        std::vector<uint16_t> index;
+        std::vector<float> min;
+        std::vector<float> max;
+        std::vector<float> a;
+        std::vector<float> b;
+    };
+
+    template <bool FromNormalized, Sample S>
+    static S convertOne(ValueScale type, S x, S min, S max, S a, S b) noexcept {
+        if constexpr (FromNormalized) {
+            x = applause::min(applause::max(x, S(0.0f)), S(1.0f));
+            return scaling_detail::fastFromNormalized(type, x, min, max, a, b);
+        } else {
+            x = applause::min(applause::max(x, min), max);
+            return scaling_detail::fastToNormalized(type, x, min, max, a, b);
+        }
+    }
+
+    template <bool FromNormalized>
+    void convert(const float* in, float* out, ScalingPrecision precision) const noexcept {
+        for (size_t t = 0; t < groups_.size(); ++t) {
+            const auto& g = groups_[t];
+            const auto type = static_cast<ValueScale>(t);
+            const size_t n = g.index.size();
+
+            if (precision == ScalingPrecision::Exact) {
+                for (size_t i = 0; i < n; ++i) {
+                    const ValueScaleInfo info{g.min[i], g.max[i], {type, g.a[i], g.b[i]}};
+                    out[g.index[i]] = FromNormalized ? applause::fromNormalized(info, in[g.index[i]], precision)
+                                                     : applause::toNormalized(info, in[g.index[i]], precision);
+                }
+                continue;
+            }
+
+            size_t i = 0;
+            if (type != ValueScale::Linear) {
+                // Linear is a single multiply-add; gathering it into batches costs more than it saves
+                alignas(64) float lanes[kWidth];
+                for (; i + kWidth <= n; i += kWidth) {
+                    for (size_t k = 0; k < kWidth; ++k) lanes[k] = in[g.index[i + k]];
+                    const Batch y = convertOne<FromNormalized>(
+                        type, Batch::load_aligned(lanes), Batch::load_unaligned(g.min.data() + i),
+                        Batch::load_unaligned(g.max.data() + i), Batch::load_unaligned(g.a.data() + i),
+                        Batch::load_unaligned(g.b.data() + i));
+                    y.store_aligned(lanes);
+                    for (size_t k = 0; k < kWidth; ++k) out[g.index[i + k]] = lanes[k];
+                }
+            }
+            for (; i < n; ++i) {
+                out[g.index[i]] = convertOne<FromNormalized>(type, in[g.index[i]], g.min[i], g.max[i], g.a[i], g.b[i]);
+            }
+        }
+    }
+
+    std::array<Group, 4> groups_;
+};
+
+}  // namespace applause
@@ -0,0 +1,164 @@
+#include "WorkerPool.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define APPLAUSE_WORKER_PAUSE() _mm_pause()
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define APPLAUSE_WORKER_PAUSE() __asm__ __volatile__("yield")
+#else
+#define APPLAUSE_WORKER_PAUSE() std::this_thread::yield()
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <sys/qos.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace applause {
+namespace {
+// Roughly tens of microseconds: long enough to catch the next sub-block's job, short enough not to burn a core
+constexpr int kSpinIterations = 4096;
+
+// Best effort: without the privilege (e.g. no rtprio limit on Linux) workers keep their normal priority
+void raiseToRealtimePriority() noexcept {
+#if defined(_WIN32)
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        LOG_WARN("WorkerPool: couldn't raise worker priority");
+    }
+#elif defined(__APPLE__)
+    if (pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) != 0) {
+        LOG_WARN("WorkerPool: couldn't raise worker priority");
+    }
+#else
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        LOG_INFO("WorkerPool: real-time scheduling unavailable, workers run at normal priority");
+    }
+#endif
+}
+}  // namespace
+
+WorkerPool::WorkerPool(size_t num_workers)
+    : num_workers_(std::min(num_workers, kMaxWorkers)),
+      threads_(std::make_unique<std::thread[]>(num_workers_)),
+      ranges_(std::make_unique<Range[]>(num_workers_ + 1)) {
+    if (num_workers > kMaxWorkers) LOG_WARN("WorkerPool: limited to {} workers", kMaxWorkers);
+    for (size_t i = 0; i < num_workers_; ++i) {
+        threads_[i] = std::thread([this, slot = i + 1] { workerLoop(slot); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    ASSERT(!job_open_.load(), "WorkerPool: destroyed while a job is running");
+    stop_.store(true, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (size_t i = 0; i < num_workers_; ++i) threads_[i].join();
+}
+
+size_t WorkerPool::defaultNumWorkers() noexcept {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return std::min<size_t>(hardware > 1 ? hardware - 1 : 0, kMaxWorkers);
+}
+
+void WorkerPool::run(uint32_t num_tasks, const void* fn, Trampoline trampoline) {
+    ASSERT(!job_open_.load(std::memory_order_relaxed), "WorkerPool: parallelFor() is not reentrant");
+    const size_t participants = num_workers_ + 1;
+    for (size_t i = 0; i < participants; ++i) {
+        const auto begin = static_cast<uint32_t>(uint64_t{num_tasks} * i / participants);
+        const auto end = static_cast<uint32_t>(uint64_t{num_tasks} * (i + 1) / participants);
+        ranges_[i].bounds.store(pack(begin, end), std::memory_order_relaxed);
+    }
+    fn_ = fn;
+    trampoline_ = trampoline;
+    remaining_.store(num_tasks, std::memory_order_relaxed);
+
+    job_open_.store(true);
+    generation_.fetch_add(1);
+    generation_.notify_all();
+
+    participate(0);
+    while (remaining_.load(std::memory_order_acquire) != 0) APPLAUSE_WORKER_PAUSE();
+
+    // Late wakers see the job closed; wait for those already inside before the next job rewrites the ranges
+    job_open_.store(false);
+    while (active_.load() != 0) APPLAUSE_WORKER_PAUSE();
+}
+
+void WorkerPool::workerLoop(size_t slot) {
+    raiseToRealtimePriority();
+    // Start from the initial generation rather than the current one, or a worker that only gets scheduled after
+    // the destructor's wakeup would sleep through it
+    uint32_t seen = 0;
+    while (!stop_.load(std::memory_order_acquire)) {
+        uint32_t current = seen;
+        for (int spin = 0; spin < kSpinIterations && current == seen; ++spin) {
+            APPLAUSE_WORKER_PAUSE();
+            current = generation_.load(std::memory_order_acquire);
+        }
+        if (current == seen) {
+            generation_.wait(seen, std::memory_order_acquire);
+            current = generation_.load(std::memory_order_acquire);
+            if (current == seen) continue;  // Spurious wakeup
+        }
+        if (stop_.load(std::memory_order_acquire)) return;
+        seen = current;
+
+        active_.fetch_add(1);
+        if (job_open_.load() && generation_.load() == seen) participate(slot);
+        active_.fetch_sub(1);
+    }
+}
+
+void WorkerPool::participate(size_t slot) noexcept {
+    uint32_t task = 0;
+    do {
+        while (popOwn(slot, task)) {
+            trampoline_(fn_, task);
+            remaining_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    } while (steal(slot));
+}
+
+bool WorkerPool::popOwn(size_t slot, uint32_t& task) noexcept {
+    auto& bounds = ranges_[slot].bounds;
+    uint64_t current = bounds.load(std::memory_order_acquire);
+    while (beginOf(current) < endOf(current)) {
+        if (bounds.compare_exchange_weak(current, pack(beginOf(current) + 1, endOf(current)),
+                                         std::memory_order_acq_rel, std::memory_order_acquire)) {
+            task = beginOf(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkerPool::steal(size_t slot) noexcept {
+    const size_t participants = num_workers_ + 1;
+    for (size_t offset = 1; offset < participants; ++offset) {
+        auto& victim = ranges_[(slot + offset) % participants].bounds;
+        uint64_t current = victim.load(std::memory_order_acquire);
+        while (beginOf(current) < endOf(current)) {
+            // Take the back half, rounding up so a single remaining task can be stolen too
+            const uint32_t count = endOf(current) - beginOf(current);
+            const uint32_t split = endOf(current) - (count + 1) / 2;
+            if (victim.compare_exchange_weak(current, pack(beginOf(current), split), std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+                ranges_[slot].bounds.store(pack(split, endOf(current)), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace applause
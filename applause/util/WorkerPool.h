@@ -0,0 +1,121 @@
+#pragma once
+
+#include <applause/util/DebugHelpers.h>
+#include <applause/util/MemoryArena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+namespace applause {
+
+/**
+ * A framework-owned pool of worker threads for fork/join work on the audio thread, for hosts that don't offer
+ * `clap_host_thread_pool`. ThreadPoolExtension falls back to it once enableFallbackPool() has been called.
+ *
+ * parallelFor(n, f) calls f(0) .. f(n - 1) across the workers and the calling thread, returning once every call has
+ * finished. The tasks are first split into one contiguous range per participant; a participant works through its
+ * own range from the front, and once that is empty steals the back half of another's, so uneven tasks (voices in
+ * different stages, say) still balance out. Each range is one 64-bit atomic, so owner and thief agree with a single
+ * compare-exchange.
+ *
+ * Submitting work doesn't allocate or lock: f is only referenced for the duration of the call, never copied into a
+ * std::function. Workers raise themselves to real-time priority where the OS allows it, spin briefly after a job
+ * and then sleep until the next one.
+ *
+ * @code
+ * WorkerPool pool{3};  // Main thread: starts three workers
+ *
+ * // Audio thread
+ * pool.parallelForRange(num_voices, 4, [&](size_t first, size_t last) {
+ *     for (size_t v = first; v < last; ++v) renderVoice(v);
+ * });
+ * @endcode
+ */
+class WorkerPool {
+public:
+    static constexpr size_t kMaxWorkers = 31;
+
+    /** Starts num_workers threads (at most kMaxWorkers); call off the audio thread. */
+    explicit WorkerPool(size_t num_workers);
+
+    /** Stops and joins the workers. No job may be running. */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /** One worker per hardware thread, less one for the audio thread itself. */
+    [[nodiscard]] static size_t defaultNumWorkers() noexcept;
+
+    /** Workers, not counting the thread that calls parallelFor(). */
+    [[nodiscard]] size_t numWorkers() const noexcept { return num_workers_; }
+
+    /**
+     * Calls f(task) for every task in [0, num_tasks), spread over the workers and the calling thread, and returns
+     * once all have run. Only one thread may submit at a time, and f must not submit to the same pool.
+     */
+    template <typename F>
+        requires std::is_invocable_v<F&, uint32_t>
+    void parallelFor(uint32_t num_tasks, F&& f) {
+        if (num_tasks == 0) return;
+        if (num_tasks == 1 || num_workers_ == 0) {
+            for (uint32_t task = 0; task < num_tasks; ++task) f(task);
+            return;
+        }
+        run(num_tasks, std::addressof(f), [](const void* fn, uint32_t task) {
+            (*static_cast<std::remove_reference_t<F>*>(const_cast<void*>(fn)))(task);
+        });
+    }
+
+    /** parallelFor() over [0, count) in chunks of at most grain items: f(first, last) for each chunk. */
+    template <typename F>
+        requires std::is_invocable_v<F&, size_t, size_t>
+    void parallelForRange(size_t count, size_t grain, F&& f) {
+        ASSERT(grain > 0, "WorkerPool: grain must be positive");
+        const auto num_tasks = static_cast<uint32_t>((count + grain - 1) / grain);
+        parallelFor(num_tasks, [&](uint32_t task) {
+            const size_t first = task * grain;
+            f(first, std::min(first + grain, count));
+        });
+    }
+
+private:
+    using Trampoline = void (*)(const void*, uint32_t);
+
+    // [begin, end) of one participant's remaining tasks, packed as (end << 32) | begin
+    struct alignas(defaultByteAlignment) Range {
+        std::atomic<uint64_t> bounds{0};
+    };
+
+    static constexpr uint64_t pack(uint32_t begin, uint32_t end) noexcept {
+        return (static_cast<uint64_t>(end) << 32) | begin;
+    }
+    static constexpr uint32_t beginOf(uint64_t bounds) noexcept { return static_cast<uint32_t>(bounds); }
+    static constexpr uint32_t endOf(uint64_t bounds) noexcept { return static_cast<uint32_t>(bounds >> 32); }
+
+    void run(uint32_t num_tasks, const void* fn, Trampoline trampoline);
+    void workerLoop(size_t slot);
+    void participate(size_t slot) noexcept;
+    bool popOwn(size_t slot, uint32_t& task) noexcept;
+    bool steal(size_t slot) noexcept;
+
+    size_t num_workers_ = 0;
+    std::unique_ptr<std::thread[]> threads_;
+    std::unique_ptr<Range[]> ranges_;  // Slot 0 is the submitting thread, slot i the i-th worker
+
+    const void* fn_ = nullptr;
+    Trampoline trampoline_ = nullptr;
+
+    alignas(defaultByteAlignment) std::atomic<uint32_t> generation_{0};
+    std::atomic<bool> job_open_{false};
+    std::atomic<bool> stop_{false};
+    alignas(defaultByteAlignment) std::atomic<uint32_t> remaining_{0};
+    alignas(defaultByteAlignment) std::atomic<uint32_t> active_{0};
+};
+
+}  // namespace applause
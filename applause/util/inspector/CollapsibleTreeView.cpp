@@ -14,10 +14,10 @@ void TreeRow::onHeaderClick(applause::Point /*local*/, const RowContext& ctx) {
 
 // One visible row's backing Frame. Bound to a TreeRow* by the tree; consults
 // it for height, drawing, layout, click dispatch. Lives in the tree's scroll
-// container; pooled by TreeRow* in row_frames_.
+// container; owned by frame_pool_ and rebound as rows scroll in and out.
 class CollapsibleTreeView::RowFrame : public applause::Frame {
 public:
-    RowFrame(CollapsibleTreeView& tree, TreeRow& row) : tree_(tree), row_(&row) {
+    explicit RowFrame(CollapsibleTreeView& tree) : tree_(tree) {
         onMouseEnter() += [this](const applause::MouseEvent&) {
             hovered_ = true;
             redraw();
@@ -27,15 +27,33 @@ public:
             redraw();
         };
         onMouseDown() += [this](const applause::MouseEvent& e) {
-            if (!e.isLeftButton()) return;
+            if (!e.isLeftButton() || !row_) return;
             tree_.onRowClicked(row_, e.relativePosition());
         };
     }
 
+    void setRow(TreeRow& row) {
+        row_ = &row;
+        hovered_ = false;
+        setVisible(true);
+        redraw();
+    }
+
+    // Gives back any widgets the row parented here (they belong to the row,
+    // which outlives this binding) and goes idle until the next setRow().
+    void clearRow() {
+        while (!children().empty()) removeChild(children().back());
+        row_ = nullptr;
+        hovered_ = false;
+        setVisible(false);
+    }
+
     void bind(int depth, bool expanded, bool selected) {
+        if (depth_ == depth && expanded_ == expanded && selected_ == selected) return;
         depth_ = depth;
         expanded_ = expanded;
         selected_ = selected;
+        redraw();
     }
 
     void setSelected(bool s) {
@@ -108,13 +126,16 @@ private:
     bool hovered_ = false;
 };
 
-CollapsibleTreeView::CollapsibleTreeView() = default;
+CollapsibleTreeView::CollapsibleTreeView() {
+    onScroll() += [this](applause::ScrollableFrame*) { syncRowFrames(false); };
+}
+
 CollapsibleTreeView::~CollapsibleTreeView() = default;
 
 void CollapsibleTreeView::setRoot(std::unique_ptr<TreeRow> root) {
-    // Drop all backing Frames before we discard their TreeRows. Frames
-    // auto-detach in ~Frame but doing it here keeps ordering predictable.
-    row_frames_.clear();
+    // Unbind all backing Frames before we discard their TreeRows, so no
+    // RowFrame keeps hosting a widget the rows own.
+    while (!row_frames_.empty()) unbindRowFrame(row_frames_.begin()->first);
     row_pool_.clear();
     visible_.clear();
     visited_keys_.clear();
@@ -126,6 +147,29 @@ void CollapsibleTreeView::setRoot(std::unique_ptr<TreeRow> root) {
 }
 
 void CollapsibleTreeView::rebuild() {
+    reuse_cached_children_ = false;
+    relayout();
+}
+
+bool CollapsibleTreeView::refresh() {
+    // visible_ is in walk order, so every row is asked only after its parent
+    // reported no change, i.e. while it's certainly still alive
+    bool changed = false;
+    for (const Entry& e : visible_) {
+        if (e.row->structureChanged()) {
+            changed = true;
+            break;
+        }
+    }
+    if (!changed) return false;
+
+    reuse_cached_children_ = true;
+    relayout();
+    reuse_cached_children_ = false;
+    return true;
+}
+
+void CollapsibleTreeView::relayout() {
     visible_.clear();
     visited_keys_.clear();
 
@@ -135,11 +179,11 @@ void CollapsibleTreeView::rebuild() {
     }
 
     sweepUnvisited();
-    syncRowFrames();
 
     const float total = visible_.empty() ? 0.0f
                                          : visible_.back().y + visible_.back().h;
     setScrollableHeight(total);
+    syncRowFrames(true);
     redraw();
 }
 
@@ -173,11 +217,25 @@ void CollapsibleTreeView::walkModel(TreeRow& row, int depth, float& y) {
     visible_.push_back(e);
     y += e.h;
 
-    if (is_branch && branch_expanded) walkChildrenOf(*canonical, depth + 1, y);
+    if (is_branch && branch_expanded) {
+        walkChildrenOf(*canonical, depth + 1, y);
+    } else {
+        // Collapsed children get swept from the pool, taking the cache's
+        // pointers with them
+        canonical->children_cached_ = false;
+        canonical->cached_children_.clear();
+    }
 }
 
 void CollapsibleTreeView::walkChildrenOf(TreeRow& parent, int depth, float& y) {
+    if (reuse_cached_children_ && parent.children_cached_ && !parent.structureChanged()) {
+        for (TreeRow* child : parent.cached_children_) walkModel(*child, depth, y);
+        return;
+    }
+
     auto children = parent.buildChildren();
+    parent.cached_children_.clear();
+    parent.children_cached_ = true;
     for (auto& child_uptr : children) {
         const std::string child_key = child_uptr->stableKey();
         auto child_it = row_pool_.find(child_key);
@@ -190,18 +248,18 @@ void CollapsibleTreeView::walkChildrenOf(TreeRow& parent, int depth, float& y) {
             child_canonical = child_uptr.get();
             row_pool_.emplace(child_key, std::move(child_uptr));
         }
+        parent.cached_children_.push_back(child_canonical);
         walkModel(*child_canonical, depth, y);
     }
 }
 
 void CollapsibleTreeView::sweepUnvisited() {
-    // Remove RowFrames first (so their layout teardown runs before we drop
-    // the TreeRow that owns any embedded widgets the RowFrame was hosting).
-    for (auto it = row_frames_.begin(); it != row_frames_.end(); ) {
-        const std::string key = it->first->stableKey();
-        if (visited_keys_.count(key) == 0) it = row_frames_.erase(it);
-        else                               ++it;
-    }
+    // Unbind RowFrames first (so they hand back any embedded widgets before
+    // we drop the TreeRow that owns them).
+    std::vector<TreeRow*> stale;
+    for (const auto& [row, frame] : row_frames_)
+        if (visited_keys_.count(row->stableKey()) == 0) stale.push_back(row);
+    for (TreeRow* row : stale) unbindRowFrame(row);
     // Drop pool entries that weren't visited. Skip the root — it was passed
     // in by setRoot() and is not part of the pool.
     for (auto it = row_pool_.begin(); it != row_pool_.end(); ) {
@@ -215,18 +273,42 @@ void CollapsibleTreeView::sweepUnvisited() {
     }
 }
 
-void CollapsibleTreeView::syncRowFrames() {
+void CollapsibleTreeView::syncRowFrames(bool relayout_all) {
+    const float top = yPosition() - kViewportMargin;
+    const float bottom = yPosition() + height() + kViewportMargin;
+    const auto first = std::partition_point(visible_.begin(), visible_.end(),
+                                            [top](const Entry& e) { return e.y + e.h < top; });
+    const auto last = std::partition_point(first, visible_.end(),
+                                           [bottom](const Entry& e) { return e.y <= bottom; });
+
+    // Unbind rows that left the window first, so their frames can be reused
+    std::unordered_set<TreeRow*> in_view;
+    for (auto it = first; it != last; ++it) in_view.insert(it->row);
+    std::vector<TreeRow*> leaving;
+    for (const auto& [row, frame] : row_frames_)
+        if (in_view.count(row) == 0) leaving.push_back(row);
+    for (TreeRow* row : leaving) unbindRowFrame(row);
+
     const float w = width();
-    for (const Entry& e : visible_) {
-        auto it = row_frames_.find(e.row);
+    for (auto it = first; it != last; ++it) {
+        const Entry& e = *it;
+        auto found = row_frames_.find(e.row);
+        if (found != row_frames_.end() && !relayout_all) continue;
+
         RowFrame* rf;
-        if (it == row_frames_.end()) {
-            auto frame = std::make_unique<RowFrame>(*this, *e.row);
-            rf = frame.get();
-            addScrolledChild(rf);
-            row_frames_.emplace(e.row, std::move(frame));
+        if (found != row_frames_.end()) {
+            rf = found->second;
+        } else if (!free_frames_.empty()) {
+            rf = free_frames_.back();
+            free_frames_.pop_back();
+            rf->setRow(*e.row);
+            row_frames_.emplace(e.row, rf);
         } else {
-            rf = it->second.get();
+            frame_pool_.push_back(std::make_unique<RowFrame>(*this));
+            rf = frame_pool_.back().get();
+            addScrolledChild(rf);
+            rf->setRow(*e.row);
+            row_frames_.emplace(e.row, rf);
         }
         rf->bind(e.depth, e.expanded, e.row == selected_);
         rf->setBounds(0, e.y, w, e.h);
@@ -234,6 +316,14 @@ void CollapsibleTreeView::syncRowFrames() {
     }
 }
 
+void CollapsibleTreeView::unbindRowFrame(TreeRow* row) {
+    auto it = row_frames_.find(row);
+    if (it == row_frames_.end()) return;
+    it->second->clearRow();
+    free_frames_.push_back(it->second);
+    row_frames_.erase(it);
+}
+
 void CollapsibleTreeView::onRowClicked(TreeRow* row, applause::Point local) {
     if (!row) return;
     RowContext ctx;
@@ -302,22 +392,20 @@ void CollapsibleTreeView::scrollToRow(TreeRow* row) {
     for (const Entry& e : visible_) {
         if (e.row == row) {
             setYPosition(std::max(0.0f, e.y - height() * 0.5f));
+            syncRowFrames(false);
             return;
         }
     }
 }
 
+void CollapsibleTreeView::redrawVisibleRows() {
+    for (const auto& [row, frame] : row_frames_) frame->redraw();
+}
+
 void CollapsibleTreeView::resized() {
     applause::ScrollableFrame::resized();
-    // Update widths in place; y-positions don't change.
-    const float w = width();
-    for (const Entry& e : visible_) {
-        auto it = row_frames_.find(e.row);
-        if (it != row_frames_.end()) {
-            it->second->setBounds(0, e.y, w, e.h);
-            it->second->relayoutContent();
-        }
-    }
+    // Widths change and a taller view may show more rows
+    syncRowFrames(true);
 }
 
 }  // namespace applause::inspector
@@ -80,16 +80,31 @@ public:
     // Default behavior: branches toggle on any click; leaves do nothing.
     virtual void onHeaderClick(applause::Point local, const RowContext& ctx);
 
+    // Change detection for CollapsibleTreeView::refresh(): true when
+    // isBranch() or buildChildren() would now answer differently than the
+    // last time the tree walked this row. refresh() asks every visible row,
+    // so keep it cheap. Rows that can't tell keep the default and rely on an
+    // explicit rebuild().
+    virtual bool structureChanged() const { return false; }
+
     CollapsibleTreeView* tree() { return tree_; }
 
 protected:
     friend class CollapsibleTreeView;
     CollapsibleTreeView* tree_ = nullptr;
+
+private:
+    // The pooled rows buildChildren() produced on the last walk; refresh()
+    // walks these again instead of rebuilding while structureChanged() is false.
+    std::vector<TreeRow*> cached_children_;
+    bool children_cached_ = false;
 };
 
-// Scrollable tree component. Each visible row is backed by an internal
-// RowFrame (real Visage Frame child of the scroll container) so hover,
-// per-row redraws, and child-widget reparenting come from Visage for free.
+// Scrollable tree component. Each row in (or near) the viewport is backed by
+// an internal RowFrame (real Visage Frame child of the scroll container) so
+// hover, per-row redraws, and child-widget reparenting come from Visage for
+// free. Rows scrolled out of view give their RowFrame back to a pool, so a
+// tree of thousands of rows keeps only a screenful of Frames.
 //
 // Usage:
 //   auto tree = std::make_unique<CollapsibleTreeView>();
@@ -114,6 +129,13 @@ public:
     // survives. Always call after mutating expand state or model.
     void rebuild();
 
+    // Incremental counterpart for polling: asks every visible row whether
+    // its structure changed and, only if one did, re-walks the tree, calling
+    // buildChildren() just for the rows that changed. Returns whether
+    // anything changed. Costs one structureChanged() per visible row when
+    // nothing did.
+    bool refresh();
+
     // Selection. selected() may be nullptr.
     void setSelected(TreeRow* row);
     TreeRow* selected() const { return selected_; }
@@ -136,6 +158,10 @@ public:
     // isn't currently visible.
     void scrollToRow(TreeRow* row);
 
+    // Repaints every visible row without rebuilding, for rows whose content
+    // changes on their own (live metrics).
+    void redrawVisibleRows();
+
     void resized() override;
 
 private:
@@ -155,10 +181,14 @@ private:
     // ones are reused and the freshly-built duplicates dropped.
     void walkModel(TreeRow& row, int depth, float& y);
     void walkChildrenOf(TreeRow& parent, int depth, float& y);
+    void relayout();
 
-    // Ensures a RowFrame exists for each visible Entry, attaches/detaches
-    // from the scroll container, sets bounds, and dispatches layoutContent.
-    void syncRowFrames();
+    // Binds a RowFrame to each visible Entry inside the viewport (plus
+    // kViewportMargin), unbinds the rest, sets bounds, and dispatches
+    // layoutContent. `relayout_all` re-lays out rows that stayed bound too,
+    // which a rebuild needs and a scroll doesn't.
+    void syncRowFrames(bool relayout_all);
+    void unbindRowFrame(TreeRow* row);
 
     // Drops any RowFrame / pool TreeRow whose key wasn't visited this rebuild.
     void sweepUnvisited();
@@ -177,10 +207,15 @@ private:
     // Visible rows in scroll order, regenerated each rebuild().
     std::vector<Entry> visible_;
 
-    // Per-TreeRow Frame backing. Created lazily on first visibility, reused
-    // across rebuilds, removed when the row is swept from the pool.
+    // Frame backing for the rows near the viewport. RowFrames are owned by
+    // frame_pool_ and move between rows as they scroll in and out of view.
     class RowFrame;
-    std::unordered_map<TreeRow*, std::unique_ptr<RowFrame>> row_frames_;
+    static constexpr float kViewportMargin = 200.0f;
+    std::unordered_map<TreeRow*, RowFrame*> row_frames_;
+    std::vector<std::unique_ptr<RowFrame>> frame_pool_;
+    std::vector<RowFrame*> free_frames_;
+    // Set while refresh() re-walks: unchanged rows reuse cached_children_.
+    bool reuse_cached_children_ = false;
 
     // Set during walkModel so sweepUnvisited can find pool entries that
     // weren't touched this rebuild.
@@ -0,0 +1,72 @@
+#include "DrawProfiler.h"
+
+#ifndef NDEBUG
+
+#include <algorithm>
+
+namespace applause::inspector {
+
+DrawProfiler& DrawProfiler::instance() {
+    static DrawProfiler profiler;
+    return profiler;
+}
+
+void DrawProfiler::setEnabled(bool enabled) {
+    if (enabled_ == enabled) return;
+    enabled_ = enabled;
+    // Start every session from a clean slate rather than stale numbers
+    records_.clear();
+    peak_ms_per_second_ = 0.0f;
+}
+
+void DrawProfiler::noteRedraw(const applause::Frame* frame, const char* source) {
+    if (!enabled_) return;
+    records_[frame].pending_source = source;
+}
+
+void DrawProfiler::recordDraw(const applause::Frame* frame, std::chrono::steady_clock::duration elapsed) {
+    Record& r = records_[frame];
+    const float ms = std::chrono::duration<float, std::milli>(elapsed).count();
+    r.interval_ms += ms;
+    r.interval_max_ms = std::max(r.interval_max_ms, ms);
+    ++r.interval_draws;
+    r.drawn = true;
+    if (r.pending_source) {
+        r.stats.redraw_source = r.pending_source;
+        r.pending_source = nullptr;
+    }
+}
+
+void DrawProfiler::endInterval(double seconds) {
+    if (!enabled_ || seconds <= 0.0) return;
+    peak_ms_per_second_ = 0.0f;
+    for (auto it = records_.begin(); it != records_.end();) {
+        Record& r = it->second;
+        if (r.interval_draws == 0 && ++r.idle_intervals > kIdleIntervalsBeforeDrop) {
+            it = records_.erase(it);
+            continue;
+        }
+        if (r.interval_draws > 0) {
+            r.idle_intervals = 0;
+            r.stats.draw_ms = static_cast<float>(r.interval_ms / r.interval_draws);
+            r.stats.max_draw_ms = r.interval_max_ms;
+        }
+        r.stats.draws_per_second = static_cast<float>(r.interval_draws / seconds);
+        r.stats.ms_per_second = static_cast<float>(r.interval_ms / seconds);
+        peak_ms_per_second_ = std::max(peak_ms_per_second_, r.stats.ms_per_second);
+
+        r.interval_ms = 0.0;
+        r.interval_max_ms = 0.0f;
+        r.interval_draws = 0;
+        ++it;
+    }
+}
+
+const DrawProfiler::Stats* DrawProfiler::stats(const applause::Frame* frame) const {
+    auto it = records_.find(frame);
+    return it != records_.end() && it->second.drawn ? &it->second.stats : nullptr;
+}
+
+}  // namespace applause::inspector
+
+#endif  // NDEBUG
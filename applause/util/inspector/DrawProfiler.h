@@ -0,0 +1,110 @@
+#pragma once
+
+#include <applause/ui/ApplauseUI.h>
+
+#ifndef NDEBUG
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+namespace applause::inspector {
+
+// Debug-build record of what each Frame's draw() costs, behind the
+// inspector's "Profile" toggle. Frames opt in with APPLAUSE_PROFILE_DRAW() at
+// the top of draw(); Visage draws every frame into its own region, so the
+// time measured is the frame's own and never includes its children.
+//
+// Visage gives no hook into redraw(), so the invalidation source is whatever
+// the code that asked for the redraw noted with APPLAUSE_PROFILE_REDRAW()
+// ("param", "frame update", "hover", ...). Frames that never note one show
+// no source.
+//
+// The inspector closes an interval on every polling tick (endInterval()) and
+// reads the per-frame Stats of the interval that just ended. Main thread
+// only, like everything it measures.
+class DrawProfiler {
+public:
+    struct Stats {
+        float draw_ms = 0.0f;            // average time per draw
+        float max_draw_ms = 0.0f;        // slowest single draw
+        float draws_per_second = 0.0f;
+        float ms_per_second = 0.0f;      // draw time spent per second: what the frame costs overall
+        const char* redraw_source = nullptr;
+    };
+
+    static DrawProfiler& instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_; }
+
+    void noteRedraw(const applause::Frame* frame, const char* source);
+
+    // Turns the draws recorded since the last call into Stats. `seconds` is
+    // the interval's length. Frames that didn't draw for a while are dropped,
+    // so destroyed frames don't linger.
+    void endInterval(double seconds);
+
+    // Stats of the last interval, or nullptr for a frame that hasn't drawn
+    // since profiling started (or doesn't opt in).
+    const Stats* stats(const applause::Frame* frame) const;
+
+    // Highest ms_per_second of any frame in the last interval; the heatmap's
+    // full-scale value.
+    float peakMsPerSecond() const { return peak_ms_per_second_; }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const auto& [frame, record] : records_) f(frame, record.stats);
+    }
+
+    // Times one draw() call; what APPLAUSE_PROFILE_DRAW() expands to.
+    class Scope {
+    public:
+        explicit Scope(const applause::Frame* frame)
+            : frame_(instance().isEnabled() ? frame : nullptr) {
+            if (frame_) start_ = std::chrono::steady_clock::now();
+        }
+        ~Scope() {
+            if (frame_) instance().recordDraw(frame_, std::chrono::steady_clock::now() - start_);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const applause::Frame* frame_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Intervals without a draw after which a frame's record is dropped.
+    static constexpr uint32_t kIdleIntervalsBeforeDrop = 50;
+
+private:
+    struct Record {
+        Stats stats;
+        const char* pending_source = nullptr;
+        double interval_ms = 0.0;
+        float interval_max_ms = 0.0f;
+        uint32_t interval_draws = 0;
+        uint32_t idle_intervals = 0;
+        bool drawn = false;
+    };
+
+    void recordDraw(const applause::Frame* frame, std::chrono::steady_clock::duration elapsed);
+
+    std::unordered_map<const applause::Frame*, Record> records_;
+    float peak_ms_per_second_ = 0.0f;
+    bool enabled_ = false;
+};
+
+}  // namespace applause::inspector
+
+#define APPLAUSE_PROFILE_DRAW() ::applause::inspector::DrawProfiler::Scope applause_profile_draw_scope_(this)
+#define APPLAUSE_PROFILE_REDRAW(source) ::applause::inspector::DrawProfiler::instance().noteRedraw(this, source)
+
+#else
+
+#define APPLAUSE_PROFILE_DRAW() ((void)0)
+#define APPLAUSE_PROFILE_REDRAW(source) ((void)0)
+
+#endif  // NDEBUG
@@ -104,9 +104,23 @@ static std::string formatNumber(float v) {
     return buf;
 }
 
+InspectorPropertiesView::Shown InspectorPropertiesView::snapshot() const {
+    const auto* sel = window_.selectedFrame();
+    if (!sel) return {};
+    return {sel, sel->x(), sel->y(), sel->width(), sel->height(),
+            sel->isVisible(), sel->isOnTop(), sel->ignoresMouseEvents()};
+}
+
+void InspectorPropertiesView::refreshIfChanged() {
+    if (snapshot() == shown_) return;
+    refreshEditorsFromFrame();
+    redraw();
+}
+
 void InspectorPropertiesView::refreshEditorsFromFrame() {
     auto* sel = window_.selectedFrame();
     const bool show = sel != nullptr;
+    shown_ = snapshot();
 
     applause::TextEditor* editors[] = {x_editor_.get(), y_editor_.get(),
                                        w_editor_.get(), h_editor_.get()};
@@ -121,8 +135,13 @@ void InspectorPropertiesView::refreshEditorsFromFrame() {
         return;
     }
 
-    auto setIfUnfocused = [](applause::TextEditor* e, float v) {
-        if (e->hasKeyboardFocus()) return;
+    // An editor being typed into keeps its text; forget the snapshot so the
+    // next poll catches it up once the edit ends.
+    auto setIfUnfocused = [this](applause::TextEditor* e, float v) {
+        if (e->hasKeyboardFocus()) {
+            shown_ = {};
+            return;
+        }
         e->setText(formatNumber(v));
     };
     setIfUnfocused(x_editor_.get(), sel->x());
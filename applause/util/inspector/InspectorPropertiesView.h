@@ -15,8 +15,9 @@ class InspectorWindow;
 // Key/value list showing the selected frame's metadata. The bounds, visible,
 // on-top and ignores-mouse rows are editable inline; the rest are read-only.
 // Subscribes to InspectorWindow::onSelectionChanged() in the constructor and
-// is also pulse-refreshed from InspectorWindow's polling timer so external
-// mutations (resize, animation) propagate into the editors.
+// is also polled from InspectorWindow's timer (refreshIfChanged()) so external
+// mutations (resize, animation) propagate into the editors; the poll only
+// touches the widgets when something it shows actually changed.
 class InspectorPropertiesView : public applause::Frame {
 public:
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorPropertiesKey);
@@ -39,7 +40,20 @@ public:
     // selected.
     void refreshEditorsFromFrame();
 
+    // refreshEditorsFromFrame() and a repaint, but only if the selected
+    // frame's bounds or flags differ from what the view last showed.
+    void refreshIfChanged();
+
 private:
+    // What the editors and toggles currently show.
+    struct Shown {
+        const applause::Frame* frame = nullptr;
+        float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;
+        bool visible = false, on_top = false, ignores_mouse = false;
+        bool operator==(const Shown&) const = default;
+    };
+    Shown snapshot() const;
+
     void drawRow(applause::Canvas& canvas, int row, const char* key,
                  const std::string& value);
     void commitBoundsFromEditors();
@@ -59,6 +73,8 @@ private:
     // Suppresses re-entrant onToggle handling while refreshEditorsFromFrame is
     // synchronising widget state from the underlying frame.
     bool suppress_toggle_callback_ = false;
+
+    Shown shown_;
 };
 
 }  // namespace applause::inspector
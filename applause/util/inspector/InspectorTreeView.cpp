@@ -2,11 +2,13 @@
 
 #ifndef NDEBUG
 
+#include "DrawProfiler.h"
 #include "FrameUtil.h"
 #include "InspectorWindow.h"
 
 #include <embedded/applause_fonts.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <string>
 
@@ -39,10 +41,24 @@ public:
     std::string stableKey() const override { return frameKey(frame_); }
 
     bool isBranch() const override {
+        // The tree asks on every walk, so this is also where the snapshot
+        // structureChanged() compares against gets taken
+        children_snapshot_.clear();
         if (!frame_) return false;
         for (auto* c : frame_->children())
-            if (!window_.isInternalFrame(c)) return true;
-        return false;
+            if (!window_.isInternalFrame(c)) children_snapshot_.push_back(c);
+        return !children_snapshot_.empty();
+    }
+
+    bool structureChanged() const override {
+        if (!frame_) return false;
+        size_t i = 0;
+        for (auto* c : frame_->children()) {
+            if (window_.isInternalFrame(c)) continue;
+            if (i >= children_snapshot_.size() || children_snapshot_[i] != c) return true;
+            ++i;
+        }
+        return i != children_snapshot_.size();
     }
 
     std::vector<std::unique_ptr<TreeRow>> buildChildren() override {
@@ -52,6 +68,13 @@ public:
             if (window_.isInternalFrame(c)) continue;
             out.push_back(std::make_unique<FrameTreeRow>(c, window_));
         }
+        if (window_.isProfiling() && window_.sortsByDrawCost()) {
+            // Stable, so frames that never drew keep their child order at the end
+            std::stable_sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+                return drawCost(static_cast<const FrameTreeRow&>(*a).frame_)
+                     > drawCost(static_cast<const FrameTreeRow&>(*b).frame_);
+            });
+        }
         return out;
     }
 
@@ -73,7 +96,7 @@ public:
         const float tri_x = InspectorTreeView::kPaddingX
                           + ctx.depth * InspectorTreeView::kIndentPx;
         const float tri_cy = bounds.height() * 0.5f;
-        const bool has_children = isBranch();
+        const bool has_children = hasChildren();
 
         if (has_children) {
             canvas.setColor(ctx.selected
@@ -97,17 +120,20 @@ public:
                         ? InspectorTreeView::ApplauseInspectorRowAccent
                         : InspectorTreeView::ApplauseInspectorRowText);
         const float text_x = tri_x + InspectorTreeView::kTriangleSize + 6.0f;
+        const float column_w = window_.isProfiling() ? InspectorTreeView::kProfileColumnWidth : 0.0f;
         canvas.text(applause::String(frameTypeName(*frame_)),
                     label_font_, applause::Font::kLeft,
                     text_x, 0,
-                    bounds.width() - text_x - InspectorTreeView::kPaddingX,
+                    bounds.width() - text_x - column_w - InspectorTreeView::kPaddingX,
                     bounds.height());
+
+        if (column_w > 0.0f) drawProfileColumn(canvas, bounds, column_w);
     }
 
     void onHeaderClick(applause::Point local, const RowContext& ctx) override {
         if (!frame_) return;
         // Triangle: pure expand/collapse, never changes selection.
-        if (isBranch() && isOnTriangle(local, ctx.depth)) {
+        if (hasChildren() && isOnTriangle(local, ctx.depth)) {
             ctx.toggleExpanded();
             return;
         }
@@ -116,7 +142,7 @@ public:
         // when the frame is already selected — the auto-expand in the
         // selection handler would never run, so re-opening a closed row
         // would do nothing.)
-        if (isBranch() && window_.selectedFrame() == frame_) {
+        if (hasChildren() && window_.selectedFrame() == frame_) {
             ctx.toggleExpanded();
             return;
         }
@@ -126,6 +152,32 @@ public:
     applause::Frame* frame() const { return frame_; }
 
 private:
+    // isBranch() without touching the snapshot, for drawing and clicks
+    bool hasChildren() const {
+        if (!frame_) return false;
+        for (auto* c : frame_->children())
+            if (!window_.isInternalFrame(c)) return true;
+        return false;
+    }
+
+    // Draw time spent per second, or -1 for frames that haven't drawn
+    static float drawCost(const applause::Frame* frame) {
+        const auto* stats = DrawProfiler::instance().stats(frame);
+        return stats ? stats->ms_per_second : -1.0f;
+    }
+
+    void drawProfileColumn(applause::Canvas& canvas, applause::Bounds bounds, float column_w) {
+        const auto* stats = DrawProfiler::instance().stats(frame_);
+        if (!stats) return;
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.2f ms  %.0f/s  %s", stats->draw_ms, stats->draws_per_second,
+                      stats->redraw_source ? stats->redraw_source : "");
+        canvas.setColor(InspectorTreeView::ApplauseInspectorRowTextMuted);
+        canvas.text(applause::String(buf), label_font_, applause::Font::kRight,
+                    bounds.width() - column_w - InspectorTreeView::kPaddingX, 0,
+                    column_w, bounds.height());
+    }
+
     static bool isOnTriangle(applause::Point p, int depth) {
         const float tri_x = InspectorTreeView::kPaddingX
                           + depth * InspectorTreeView::kIndentPx;
@@ -136,6 +188,7 @@ private:
     applause::Frame* frame_;
     InspectorWindow& window_;
     applause::Font label_font_;
+    mutable std::vector<const applause::Frame*> children_snapshot_;
 };
 
 }  // namespace
@@ -170,14 +223,24 @@ InspectorTreeView::InspectorTreeView(InspectorWindow& window) : window_(window)
 
     window_.onTreeChanged() += [this] {
         rebuild();
-        // If the selected frame was destroyed in the editor, the sweep in
-        // rebuild() cleared our tree-side selection. Propagate the clear
-        // back to the window so it doesn't keep holding a dangling Frame*.
-        if (!selected() && window_.selectedFrame() != nullptr)
-            window_.selectFrame(nullptr);
+        syncSelectionToWindow();
     };
 }
 
+bool InspectorTreeView::refreshFromEditor() {
+    if (!refresh()) return false;
+    syncSelectionToWindow();
+    return true;
+}
+
+void InspectorTreeView::syncSelectionToWindow() {
+    // If the selected frame was destroyed in the editor, the sweep in
+    // rebuild() cleared our tree-side selection. Propagate the clear back to
+    // the window so it doesn't keep holding a dangling Frame*.
+    if (!selected() && window_.selectedFrame() != nullptr)
+        window_.selectFrame(nullptr);
+}
+
 InspectorTreeView::~InspectorTreeView() = default;
 
 }  // namespace applause::inspector
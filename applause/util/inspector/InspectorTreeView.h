@@ -11,6 +11,15 @@ class InspectorWindow;
 // Tree view of the live frame hierarchy. Thin adapter over
 // CollapsibleTreeView — the row behavior (drawing, click → select / toggle,
 // children = frame children) lives in FrameTreeRow inside the .cpp.
+//
+// While the inspector profiles draws, each row shows the frame's draw cost
+// in a right-hand column, and with sort-by-cost on, siblings are ordered by
+// that cost (most expensive first) instead of by child order.
+//
+// Each row remembers the children it was built with, so refreshFromEditor()
+// finds hierarchy changes by comparing the visible rows against their
+// frames' live children: nothing else in the editor is visited, and nothing
+// is rebuilt until something changed.
 class InspectorTreeView : public CollapsibleTreeView {
 public:
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorRowSelectedBackground);
@@ -24,11 +33,19 @@ public:
     static constexpr float kTriangleSize = 6.0f;
     static constexpr float kPaddingX = 6.0f;
     static constexpr float kLabelFontSize = 11.0f;
+    static constexpr float kProfileColumnWidth = 150.0f;
 
     explicit InspectorTreeView(InspectorWindow& window);
     ~InspectorTreeView() override;
 
+    // Polling entry point: picks up frames added to, removed from or moved
+    // within the expanded part of the editor's hierarchy, re-walking only
+    // what changed. Returns whether anything did.
+    bool refreshFromEditor();
+
 private:
+    void syncSelectionToWindow();
+
     InspectorWindow& window_;
 };
 
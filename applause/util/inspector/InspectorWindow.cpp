@@ -2,6 +2,7 @@
 
 #ifndef NDEBUG
 
+#include "DrawProfiler.h"
 #include "FrameUtil.h"
 #include "InspectorPropertiesView.h"
 #include "InspectorThemeView.h"
@@ -15,6 +16,8 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <functional>
+#include <vector>
 
 namespace applause::inspector {
 
@@ -32,6 +35,8 @@ InspectorWindow::InspectorWindow(applause::Frame& editor)
     setAcceptsKeystrokes(true);
 
     pick_button_      = std::make_unique<applause::ToggleTextButton>("Select");
+    profile_button_   = std::make_unique<applause::ToggleTextButton>("Profile");
+    sort_button_      = std::make_unique<applause::ToggleTextButton>("Sort by cost");
     tree_panel_       = std::make_unique<applause::Panel>();
     properties_panel_ = std::make_unique<applause::Panel>();
     theme_panel_      = std::make_unique<applause::Panel>();
@@ -40,6 +45,8 @@ InspectorWindow::InspectorWindow(applause::Frame& editor)
     theme_            = std::make_unique<InspectorThemeView>(*this);
 
     addChild(pick_button_.get());
+    addChild(profile_button_.get());
+    addChild(sort_button_.get());
     addChild(tree_panel_.get());
     addChild(properties_panel_.get());
     addChild(theme_panel_.get());
@@ -52,6 +59,10 @@ InspectorWindow::InspectorWindow(applause::Frame& editor)
     // re-clicking this toggle exits.
     pick_button_->onToggle() += [this](applause::Button*, bool on) { setPickMode(on); };
 
+    profile_button_->onToggle() += [this](applause::Button*, bool on) { setProfiling(on); };
+    sort_button_->onToggle() += [this](applause::Button*, bool on) { setSortByDrawCost(on); };
+    sort_button_->setActive(false);
+
     on_pick_mode_changed_ += [this](bool pick) {
         pick_button_->setToggled(pick);
         pick_button_->redraw();
@@ -68,6 +79,7 @@ InspectorWindow::InspectorWindow(applause::Frame& editor)
 
 InspectorWindow::~InspectorWindow() {
     stopTimer();
+    if (profiling_) DrawProfiler::instance().setEnabled(false);
     setPickMode(false);  // detach pick_capture_ from editor before teardown
     if (selection_highlight_) {
         editor_.removeChild(selection_highlight_.get());
@@ -96,6 +108,7 @@ void InspectorWindow::setShown(bool shown) {
 
 void InspectorWindow::detachOverlays() {
     if (pick_mode_) setPickMode(false);
+    if (profiling_) setProfiling(false);
     if (selection_highlight_) {
         editor_.removeChild(selection_highlight_.get());
         selection_highlight_.reset();
@@ -127,6 +140,31 @@ void InspectorWindow::setPickMode(bool pick) {
     on_pick_mode_changed_.callback(pick);
 }
 
+void InspectorWindow::setProfiling(bool profiling) {
+    if (profiling_ == profiling) return;
+    profiling_ = profiling;
+    DrawProfiler::instance().setEnabled(profiling);
+    last_profile_tick_ = std::chrono::steady_clock::now();
+
+    profile_button_->setToggled(profiling);
+    profile_button_->redraw();
+    sort_button_->setActive(profiling);
+    sort_button_->redraw();
+
+    if (!profiling && selection_highlight_) selection_highlight_->setHeatmap({});
+    refreshSelectionHighlight();
+    // The tree gains or loses its cost column (and maybe its cost ordering)
+    on_tree_changed_.callback();
+}
+
+void InspectorWindow::setSortByDrawCost(bool sort) {
+    if (sort_by_draw_cost_ == sort) return;
+    sort_by_draw_cost_ = sort;
+    sort_button_->setToggled(sort);
+    sort_button_->redraw();
+    if (profiling_) on_tree_changed_.callback();
+}
+
 void InspectorWindow::selectFrame(applause::Frame* frame) {
     if (selected_ == frame) return;
     selected_ = frame;
@@ -136,8 +174,10 @@ void InspectorWindow::selectFrame(applause::Frame* frame) {
 
 void InspectorWindow::refreshSelectionHighlight() {
     // No highlight when the pop-out is closed or there's no selection (or the
-    // selection IS the editor itself — outlining the full editor isn't useful).
-    if (!isShown() || selected_ == nullptr || selected_ == &editor_) {
+    // selection IS the editor itself — outlining the full editor isn't useful),
+    // unless it's needed for the profiling heatmap.
+    const bool has_selection = selected_ != nullptr && selected_ != &editor_;
+    if (!isShown() || (!has_selection && !profiling_)) {
         if (selection_highlight_) {
             editor_.removeChild(selection_highlight_.get());
             selection_highlight_.reset();
@@ -173,6 +213,11 @@ void InspectorWindow::refreshSelectionHighlight() {
     // dashed lines have room to extend past the selection's own bounds.
     selection_highlight_->setBounds(0, 0, editor_.width(), editor_.height());
 
+    if (!has_selection) {
+        selection_highlight_->setSelectionBounds({}, {});
+        return;
+    }
+
     const applause::Bounds selected_local = editor_.relativeBounds(selected_);
     applause::Frame* parent = selected_->parent();
     const applause::Bounds parent_local =
@@ -183,6 +228,27 @@ void InspectorWindow::refreshSelectionHighlight() {
     selection_highlight_->setSelectionBounds(selected_local, parent_local);
 }
 
+void InspectorWindow::refreshHeatmap() {
+    if (!selection_highlight_) return;
+    const DrawProfiler& profiler = DrawProfiler::instance();
+    const float peak = profiler.peakMsPerSecond();
+    std::vector<SelectionHighlightFrame::HeatCell> cells;
+
+    // Visible frames only, and never the editor itself: its cell would tint
+    // the whole window
+    const std::function<void(applause::Frame*)> collect = [&](applause::Frame* f) {
+        for (auto* c : f->children()) {
+            if (isInternalFrame(c) || !c->isVisible()) continue;
+            const auto* stats = profiler.stats(c);
+            if (stats && peak > 0.0f && stats->ms_per_second > 0.0f)
+                cells.push_back({editor_.relativeBounds(c), std::min(1.0f, stats->ms_per_second / peak)});
+            collect(c);
+        }
+    };
+    collect(&editor_);
+    selection_highlight_->setHeatmap(std::move(cells));
+}
+
 void InspectorWindow::setHoveredFrame(applause::Frame* frame) {
     if (hovered_ == frame) return;
     hovered_ = frame;
@@ -282,7 +348,7 @@ void InspectorWindow::draw(applause::Canvas& canvas) {
     };
 
     canvas.setColor(ApplauseInspectorToolbarText);
-    float x = 6.0f + kPickButtonWidth + 10.0f;
+    float x = 6.0f + kPickButtonWidth + 4.0f + kProfileButtonWidth + 4.0f + kSortButtonWidth + 10.0f;
     for (int i = 0; i < 7; ++i) {
         canvas.text(applause::String(buf[i]), metric_font_, applause::Font::kLeft,
                     x, 0.0f, slot_widths[i], kToolbarHeight);
@@ -298,6 +364,8 @@ void InspectorWindow::resized() {
     const float h = height();
     const float btn_h = kToolbarHeight - 8.0f;
     pick_button_->setBounds(6.0f, 4.0f, kPickButtonWidth, btn_h);
+    profile_button_->setBounds(6.0f + kPickButtonWidth + 4.0f, 4.0f, kProfileButtonWidth, btn_h);
+    sort_button_->setBounds(6.0f + kPickButtonWidth + kProfileButtonWidth + 8.0f, 4.0f, kSortButtonWidth, btn_h);
 
     const float content_top = kToolbarHeight + 1.0f + kContentPadding;
     const float content_left = kContentPadding;
@@ -346,10 +414,13 @@ bool InspectorWindow::keyPress(const applause::KeyEvent& e) {
 void InspectorWindow::timerCallback() {
     if (!isShown()) return;
 
-    int count = recursiveFrameCount(&editor_);
-    if (count != last_frame_count_) {
-        last_frame_count_ = count;
-        on_tree_changed_.callback();
+    // The tree picks up changes to its visible part by itself. The toolbar's
+    // frame count needs a full walk, so it's only redone on a change and once
+    // a second, for changes inside collapsed branches.
+    const bool tree_changed = tree_->refreshFromEditor();
+    if (tree_changed || ++ticks_since_frame_count_ >= kFrameCountIntervalTicks) {
+        last_frame_count_ = recursiveFrameCount(&editor_);
+        ticks_since_frame_count_ = 0;
     }
 
     // Pick mode: editor may have resized since we attached. Keep the capture
@@ -366,9 +437,20 @@ void InspectorWindow::timerCallback() {
     // setSelectionBounds is a no-op when nothing changed.
     if (selection_highlight_ && selected_) refreshSelectionHighlight();
 
+    // Profiling: close the interval, then show its numbers. Sorted trees
+    // may reorder, so they rebuild; otherwise the rows just repaint.
+    if (profiling_) {
+        const auto now = std::chrono::steady_clock::now();
+        DrawProfiler::instance().endInterval(std::chrono::duration<double>(now - last_profile_tick_).count());
+        last_profile_tick_ = now;
+        refreshHeatmap();
+        if (sort_by_draw_cost_) on_tree_changed_.callback();
+        else                    tree_->redrawVisibleRows();
+    }
+
     // Properties pane: re-sync editor texts and toggle states with the live
-    // frame (skips any editor currently being typed into).
-    if (properties_ && selected_) properties_->refreshEditorsFromFrame();
+    // frame if they changed (skips any editor currently being typed into).
+    if (properties_ && selected_) properties_->refreshIfChanged();
 
     // Toolbar metrics (FPS / draws / mem / ...) update inside draw(), so force
     // a repaint each tick to keep the numbers live even when nothing else is
@@ -6,6 +6,7 @@
 #include <applause/ui/components/Button.h>
 #include <applause/ui/components/Panel.h>
 
+#include <chrono>
 #include <memory>
 
 namespace applause::inspector {
@@ -33,6 +34,7 @@ public:
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorToolbarText);
 
     static constexpr int kPollIntervalMs = 100;
+    static constexpr int kFrameCountIntervalTicks = 10;
     static constexpr float kDefaultWidth = 1020.0f;
     static constexpr float kDefaultHeight = 620.0f;
     static constexpr float kToolbarHeight = 28.0f;
@@ -43,6 +45,8 @@ public:
     static constexpr float kMetricFontSize = 10.0f;
     static constexpr float kMetricSmoothing = 0.1f;
     static constexpr float kPickButtonWidth = 56.0f;
+    static constexpr float kProfileButtonWidth = 56.0f;
+    static constexpr float kSortButtonWidth = 84.0f;
     // Frame budget is OS-paced (MTKView preferredFramesPerSecond = 120 on
     // macOS). Hardcoded here; in theory we could pull the live refresh rate
     // off Canvas but it's not exposed publicly.
@@ -65,6 +69,15 @@ public:
     void togglePickMode() { setPickMode(!pick_mode_); }
     bool isPickMode() const { return pick_mode_; }
 
+    // Draw profiling: records per-frame draw cost through DrawProfiler, shows
+    // it in the tree and tints the editor with a heatmap of it.
+    void setProfiling(bool profiling);
+    bool isProfiling() const { return profiling_; }
+
+    // Orders tree siblings by draw cost while profiling.
+    void setSortByDrawCost(bool sort);
+    bool sortsByDrawCost() const { return sort_by_draw_cost_; }
+
     void selectFrame(applause::Frame* frame);
     applause::Frame* selectedFrame() const { return selected_; }
 
@@ -101,12 +114,15 @@ public:
 private:
     void setHoveredFrame(applause::Frame* frame);
     void refreshSelectionHighlight();
+    void refreshHeatmap();
     // Common cleanup invoked from both setShown(false) and onCloseRequested
     // so the native-close button doesn't leave the selection overlay attached
     // to the host editor.
     void detachOverlays();
     applause::Frame& editor_;
     std::unique_ptr<applause::ToggleTextButton> pick_button_;
+    std::unique_ptr<applause::ToggleTextButton> profile_button_;
+    std::unique_ptr<applause::ToggleTextButton> sort_button_;
     applause::Font metric_font_;
     // Panels host the tree / properties / theme as children of their content()
     // frames. Declared before the views so the views are destroyed first and
@@ -123,7 +139,11 @@ private:
     applause::Frame* selected_ = nullptr;
     applause::Frame* hovered_ = nullptr;
     bool pick_mode_ = false;
+    bool profiling_ = false;
+    bool sort_by_draw_cost_ = false;
+    std::chrono::steady_clock::time_point last_profile_tick_;
     int last_frame_count_ = 0;
+    int ticks_since_frame_count_ = 0;
 
     float smoothed_fps_ = 0.0f;
     float smoothed_cpu_ms_ = 0.0f;
@@ -20,6 +20,10 @@ APPLAUSE_THEME_IMPLEMENT_COLOR(SelectionHighlightFrame,
                                ApplauseInspectorResizeHandle,          0xffffffff);
 APPLAUSE_THEME_IMPLEMENT_COLOR(SelectionHighlightFrame,
                                ApplauseInspectorResizeHandleBorder,    0xff1a3a5a);
+APPLAUSE_THEME_IMPLEMENT_COLOR(SelectionHighlightFrame,
+                               ApplauseInspectorHeatmapCold,           0x10ffaa00);
+APPLAUSE_THEME_IMPLEMENT_COLOR(SelectionHighlightFrame,
+                               ApplauseInspectorHeatmapHot,            0x88ff3020);
 
 namespace {
 
@@ -175,6 +179,12 @@ void SelectionHighlightFrame::setSelectionBounds(applause::Bounds selected,
     redraw();
 }
 
+void SelectionHighlightFrame::setHeatmap(std::vector<HeatCell> cells) {
+    if (cells.empty() && heatmap_.empty()) return;
+    heatmap_ = std::move(cells);
+    redraw();
+}
+
 void SelectionHighlightFrame::layoutHandles() {
     const bool show = selected_.width() > 0 && selected_.height() > 0;
     if (!show) {
@@ -210,6 +220,11 @@ void SelectionHighlightFrame::layoutHandles() {
 }
 
 void SelectionHighlightFrame::draw(applause::Canvas& canvas) {
+    for (const HeatCell& cell : heatmap_) {
+        canvas.setBlendedColor(ApplauseInspectorHeatmapCold, ApplauseInspectorHeatmapHot, cell.heat);
+        canvas.rectangle(cell.bounds.x(), cell.bounds.y(), cell.bounds.width(), cell.bounds.height());
+    }
+
     if (selected_.width() <= 0 || selected_.height() <= 0) return;
 
     const float x = selected_.x();
@@ -7,6 +7,7 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace applause::inspector {
 
@@ -16,6 +17,9 @@ namespace applause::inspector {
 // eight small drag-to-resize handles at the corners and edge midpoints of
 // the selection.
 //
+// While the inspector profiles draws, it also tints every profiled frame by
+// its draw cost (setHeatmap()), under the selection outline.
+//
 // The overlay itself ignores mouse events and passes them through to the
 // widgets underneath. Only the resize handles are interactive — they cover
 // 10x10 px each, so the rest of the editor is fully clickable as normal.
@@ -26,6 +30,8 @@ public:
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorSelectionDistanceText);
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorResizeHandle);
     APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorResizeHandleBorder);
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorHeatmapCold);
+    APPLAUSE_THEME_DEFINE_COLOR(ApplauseInspectorHeatmapHot);
 
     static constexpr float kThickness = 2.0f;
     static constexpr float kDashLength = 4.0f;
@@ -42,6 +48,13 @@ public:
         kBottom = 1u << 3,
     };
 
+    // One tinted rect of the draw-cost heatmap. `heat` is 0..1, relative to
+    // the most expensive frame.
+    struct HeatCell {
+        applause::Bounds bounds;
+        float heat = 0.0f;
+    };
+
     // Callback fires while the user drags a handle. `new_selected` is the
     // proposed selection rect in this frame's local coords (= editor coords,
     // because the highlight covers the whole editor).
@@ -53,6 +66,9 @@ public:
     // Both rectangles are in this frame's local coord space.
     void setSelectionBounds(applause::Bounds selected, applause::Bounds parent);
 
+    // Rects in this frame's local coord space; empty clears the heatmap.
+    void setHeatmap(std::vector<HeatCell> cells);
+
     void setOnResize(OnResizeCallback cb) { on_resize_ = std::move(cb); }
 
     // Used by ResizeHandle children to fetch the live anchor rect and to
@@ -87,6 +103,7 @@ private:
 
     applause::Bounds selected_;
     applause::Bounds parent_;
+    std::vector<HeatCell> heatmap_;
     applause::Font label_font_;
     OnResizeCallback on_resize_;
     std::array<std::unique_ptr<ResizeHandle>, 8> handles_;
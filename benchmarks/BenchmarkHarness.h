@@ -0,0 +1,109 @@
+// Shared plumbing for the micro-benchmarks: option parsing, timing and JSON reporting.
+//
+// Every benchmark executable takes the same options and prints one JSON object per line per case, holding the
+// parameters of the case and its timing:
+//   {"benchmark":"svf_lowpass","channels":2,"frames":64,"iterations":...,"min_ns_per_op":...,"ns_per_op":...}
+//
+// Usage: <Benchmark> [--filter <substring>] [--min-time-ms <ms>]
+// The filter matches against the benchmark name.
+
+#pragma once
+
+#include <applause/util/Json.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace applause::bench {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string filter;
+    double min_time_ms = 100.0;
+};
+
+struct Result {
+    double ns_per_op;
+    double min_ns_per_op;
+    uint64_t iterations;
+};
+
+// Workloads draw their random data from this, so every run measures the same input
+constexpr uint32_t kSeed = 0x41505055;
+
+// Parses the shared options. Prints the usage and returns false on an unknown argument.
+inline bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time-ms" && i + 1 < argc) {
+            options.min_time_ms = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--min-time-ms <ms>]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool enabled(const Options& options, std::string_view name) {
+    return options.filter.empty() || name.find(options.filter) != std::string_view::npos;
+}
+
+// Runs op in growing batches until min_time_ms has elapsed. Reports the mean and the fastest batch per op.
+inline Result measure(const Options& options, const std::function<void()>& op) {
+    op();  // warm-up
+
+    uint64_t batch = 1;
+    uint64_t iterations = 0;
+    double total_ns = 0.0;
+    double min_ns = 0.0;
+    while (total_ns < options.min_time_ms * 1e6) {
+        const auto start = Clock::now();
+        for (uint64_t i = 0; i < batch; ++i) op();
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        const double per_op = ns / static_cast<double>(batch);
+        min_ns = iterations == 0 ? per_op : std::min(min_ns, per_op);
+        total_ns += ns;
+        iterations += batch;
+        if (ns < 1e6) batch *= 2;
+    }
+    return {total_ns / static_cast<double>(iterations), min_ns, iterations};
+}
+
+// Like measure(), for ops that need fresh state: setup runs untimed before every op, and each op is timed alone.
+// Only suitable for ops well above the clock's resolution.
+template <typename State>
+Result measureEach(const Options& options, const std::function<State()>& setup, const std::function<void(State&)>& op) {
+    uint64_t iterations = 0;
+    double total_ns = 0.0;
+    double min_ns = 0.0;
+    while (total_ns < options.min_time_ms * 1e6) {
+        State state = setup();
+        const auto start = Clock::now();
+        op(state);
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        min_ns = iterations == 0 ? ns : std::min(min_ns, ns);
+        total_ns += ns;
+        ++iterations;
+    }
+    return {total_ns / static_cast<double>(iterations), min_ns, iterations};
+}
+
+// Prints one case: its parameters, including "benchmark", and its timing
+inline void report(json params, const Result& r) {
+    params["ns_per_op"] = r.ns_per_op;
+    params["min_ns_per_op"] = r.min_ns_per_op;
+    params["iterations"] = r.iterations;
+    std::cout << params.dump() << std::endl;
+}
+
+}  // namespace applause::bench
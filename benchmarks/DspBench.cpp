@@ -0,0 +1,159 @@
+// DSP building block micro-benchmarks.
+//
+// Prints one JSON object per line per case (see BenchmarkHarness.h), e.g.
+//   {"benchmark":"svf_lowpass","channels":2,"frames":64,...,"ns_per_op":...}
+// ns_per_op is per processed block, or per evaluation for "mseg_evaluate".
+//
+// Usage: DspBench [--filter <substring>] [--min-time-ms <ms>]
+// The filter matches against the benchmark name ("svf_lowpass", "svf_multimode", "mseg_evaluate",
+// "buffer_copy", "buffer_mix", "buffer_gain", "buffer_gain_ramp", "buffer_levels").
+
+#include "BenchmarkHarness.h"
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/filters/StateVariableFilter.h>
+#include <applause/dsp/modulation/MSEGCurve.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace applause;
+using namespace applause::bench;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr size_t kMaxChannels = 8;
+constexpr size_t kChannelCounts[] = {1, 2, 8};
+constexpr size_t kFrameCounts[] = {16, 64, 256, 1024};
+
+// Noise in [-1, 1], channel after channel
+std::vector<float> makeNoise(size_t channels, size_t frames) {
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> samples(channels * frames);
+    for (float& s : samples) s = dist(rng);
+    return samples;
+}
+
+void reportBlock(const char* name, size_t channels, size_t frames, const Result& r) {
+    report({{"benchmark", name}, {"channels", channels}, {"frames", frames}}, r);
+}
+
+template <typename Filter>
+void benchFilter(const Options& options, const char* name, size_t channels, size_t frames) {
+    if (!enabled(options, name)) return;
+
+    Filter filter;
+    filter.init(kSampleRate);
+    filter.setCutoffFrequency(1200.0f);
+    filter.setQValue(2.0f);
+    if constexpr (Filter::filter_type == StateVariableFilterType::MultiMode) filter.setMode(0.3f);
+
+    // Filtering in place feeds the output back in; reload the noise so the signal doesn't decay to denormals
+    const std::vector<float> noise = makeNoise(channels, frames);
+    std::vector<float> block = noise;
+    BufferView<float, kMaxChannels> view(block.data(), channels, frames);
+    const BufferView<const float, kMaxChannels> source(noise.data(), channels, frames);
+    reportBlock(name, channels, frames, measure(options, [&] {
+                    view.copyFrom(source);
+                    filter.processBlock(view);
+                }));
+}
+
+void benchBuffers(const Options& options, size_t channels, size_t frames) {
+    const std::vector<float> noise = makeNoise(channels, frames);
+    std::vector<float> block(channels * frames);
+    BufferView<float, kMaxChannels> view(block.data(), channels, frames);
+    const BufferView<const float, kMaxChannels> source(noise.data(), channels, frames);
+    view.copyFrom(source);
+
+    if (enabled(options, "buffer_copy")) {
+        reportBlock("buffer_copy", channels, frames, measure(options, [&] { view.copyFrom(source); }));
+    }
+    if (enabled(options, "buffer_mix")) {
+        // Adding and subtracting alternately keeps the values bounded
+        float sign = 1.0f;
+        reportBlock("buffer_mix", channels, frames, measure(options, [&] {
+                        view.mixWithGain(source, sign);
+                        sign = -sign;
+                    }));
+    }
+    if (enabled(options, "buffer_gain")) {
+        float gain = 0.5f;
+        reportBlock("buffer_gain", channels, frames, measure(options, [&] {
+                        view.applyGain(gain);
+                        gain = 1.0f / gain;
+                    }));
+    }
+    if (enabled(options, "buffer_gain_ramp")) {
+        reportBlock("buffer_gain_ramp", channels, frames, measure(options, [&] {
+                        view.copyFrom(source);
+                        view.applyGainRamp(0.0f, 1.0f);
+                    }));
+    }
+    if (enabled(options, "buffer_levels")) {
+        float sink = 0.0f;
+        reportBlock("buffer_levels", channels, frames, measure(options, [&] {
+                        for (size_t ch = 0; ch < channels; ++ch) sink += view.getLevels(ch).rms;
+                    }));
+        if (sink < 0.0f) std::cerr << sink;  // keeps the reads from being optimized out
+    }
+}
+
+// A curve of num_points points spread evenly over [0, 1] with random values, curved or linear
+MSEGCurve<> makeCurve(int num_points, bool curved) {
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::uniform_real_distribution<float> power(-8.0f, 8.0f);
+    MSEGCurve<> curve;
+    curve.num_points = num_points;
+    for (int i = 0; i < num_points; ++i) {
+        curve.points[i] = {static_cast<float>(i) / static_cast<float>(num_points - 1), value(rng)};
+        curve.curvature_power[i] = curved ? power(rng) : 0.0f;
+    }
+    return curve;
+}
+
+void benchMseg(const Options& options) {
+    if (!enabled(options, "mseg_evaluate")) return;
+
+    // Random phases, so the segment search can't ride on the previous lookup
+    constexpr size_t kPhases = 1024;
+    std::mt19937 rng(kSeed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> phases(kPhases);
+    for (float& p : phases) p = dist(rng);
+
+    for (const int num_points : {4, 16, 64}) {
+        for (const bool curved : {false, true}) {
+            const MSEGCurve<> curve = makeCurve(num_points, curved);
+            float sink = 0.0f;
+            const Result r = measure(options, [&] {
+                for (const float p : phases) sink += curve.evaluate(p);
+            });
+            if (sink < 0.0f) std::cerr << sink;
+            report({{"benchmark", "mseg_evaluate"}, {"points", num_points}, {"curved", curved}},
+                   {r.ns_per_op / kPhases, r.min_ns_per_op / kPhases, r.iterations * kPhases});
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    for (const size_t channels : kChannelCounts) {
+        for (const size_t frames : kFrameCounts) {
+            benchFilter<SVFLowpass<float, kMaxChannels>>(options, "svf_lowpass", channels, frames);
+            benchFilter<SVFMultiMode<float, kMaxChannels>>(options, "svf_multimode", channels, frames);
+            benchBuffers(options, channels, frames);
+        }
+    }
+    benchMseg(options);
+    return 0;
+}
@@ -0,0 +1,181 @@
+// ModMatrix micro-benchmarks.
+//
+// Prints one JSON object per line per case, so results can be diffed or collected across releases:
+//   {"benchmark":"process","layout":"rows","mix":"poly","voices":32,"connections":500,"ns_per_op":...,...}
+//
+// Usage: ModMatrixBench [--filter <substring>] [--min-time-ms <ms>]
+// The filter matches against the benchmark name ("process", "load_routing", "add_connections",
+// "add_connections_batched", "edit_topology", "edit_depth").
+
+#include "BenchmarkHarness.h"
+
+#include <applause/core/ModMatrix.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace applause;
+using namespace applause::bench;
+
+namespace {
+
+// Sources and destinations are split evenly between mono and poly
+constexpr uint16_t kPoolSize = 64;
+constexpr uint16_t kNumSources = 2 * kPoolSize;
+constexpr uint16_t kNumDestinations = 2 * kPoolSize;
+
+enum class Mix { Mono, Poly, Mixed };
+
+const char* mixName(Mix mix) {
+    switch (mix) {
+        case Mix::Mono: return "mono";
+        case Mix::Poly: return "poly";
+        default: return "mixed";
+    }
+}
+
+const char* layoutName(ModVoiceLayout layout) { return layout == ModVoiceLayout::VoiceRows ? "rows" : "lanes"; }
+
+struct Case {
+    ModVoiceLayout layout;
+    Mix mix;
+    uint16_t voices;
+    uint16_t connections;
+};
+
+std::unique_ptr<ModMatrix> makeMatrix(const Case& c) {
+    ModMatrix::Config config{c.voices, kNumSources, kNumDestinations, c.connections};
+    config.voice_layout = c.layout;
+    auto matrix = std::make_unique<ModMatrix>(config);
+    for (uint16_t i = 0; i < kNumSources; ++i) {
+        matrix->registerSource("src" + std::to_string(i), i < kPoolSize ? ModSrcType::Mono : ModSrcType::Poly,
+                               i % 2 == 0);
+    }
+    for (uint16_t i = 0; i < kNumDestinations; ++i) {
+        matrix->registerDestination("dst" + std::to_string(i), i < kPoolSize ? ModDstMode::Mono : ModDstMode::Poly,
+                                    {20.0f, 20000.0f, ValueScaling::frequency(20.0f, 20000.0f)});
+        matrix->setBaseValue(i, 1000.0f);
+    }
+    for (uint16_t v = 0; v < c.voices; ++v) matrix->notifyVoiceOn(v);
+    return matrix;
+}
+
+// Adds c.connections connections. Mono and Poly route within their pools; Mixed cycles through all four
+// routings and makes every eighth connection a depth mod on an earlier connection.
+void addConnections(ModMatrix& matrix, const Case& c) {
+    std::vector<ModConnection> params;
+    params.reserve(c.connections);
+    uint32_t pair[4] = {};
+    for (uint32_t k = 0; k < c.connections; ++k) {
+        if (c.mix == Mix::Mixed && k % 8 == 7 && !params.empty()) {
+            const auto& target = params[(k / 8) % params.size()];
+            const auto src = static_cast<uint16_t>(kPoolSize + k % kPoolSize);
+            if (!matrix.findDepthMod(src, target.depth_slot)) {
+                matrix.addDepthModulation(matrix.getSource(src), target, 0.1f);
+                continue;
+            }
+        }
+        const uint32_t route = c.mix == Mix::Mono ? 0 : c.mix == Mix::Poly ? 3 : k % 4;
+        const uint32_t j = pair[route]++;
+        const auto src = static_cast<uint16_t>((route >= 2 ? kPoolSize : 0) + j % kPoolSize);
+        const auto dst = static_cast<uint16_t>((route % 2 ? kPoolSize : 0) + (j / kPoolSize) % kPoolSize);
+        params.push_back(matrix.addConnection(matrix.getSource(src), matrix.getDestination(dst), 0.25f));
+    }
+}
+
+void report(const char* name, const Case& c, const Result& r) {
+    bench::report({{"benchmark", name},
+                   {"layout", layoutName(c.layout)},
+                   {"mix", mixName(c.mix)},
+                   {"voices", c.voices},
+                   {"connections", c.connections}},
+                  r);
+}
+
+void benchProcess(const Options& options, const Case& c) {
+    auto matrix = makeMatrix(c);
+    addConnections(*matrix, c);
+
+    // Move every source each block so no block is skipped as quiescent. The source writes are part of the
+    // measured time, as they are part of a real block.
+    float phase = 0.0f;
+    const auto r = measure(options, [&] {
+        phase = phase > 0.9f ? 0.0f : phase + 0.01f;
+        for (uint16_t s = 0; s < kPoolSize; ++s) matrix->setMonoSourceValue(s, phase);
+        for (uint16_t s = kPoolSize; s < kNumSources; ++s) {
+            for (uint16_t v = 0; v < c.voices; ++v) matrix->setPolySourceValue(s, v, phase);
+        }
+        matrix->process();
+    });
+    report("process", c, r);
+}
+
+void benchEdits(const Options& options, const Case& c) {
+    if (enabled(options, "load_routing")) {
+        auto source = makeMatrix(c);
+        addConnections(*source, c);
+        const auto blob = source->saveRouting();
+        auto matrix = makeMatrix(c);
+        report("load_routing", c, measure(options, [&] { matrix->loadRouting(blob); }));
+    }
+
+    if (enabled(options, "add_connections")) {
+        using MatrixPtr = std::unique_ptr<ModMatrix>;
+        const std::function<MatrixPtr()> setup = [&] { return makeMatrix(c); };
+        report("add_connections", c,
+               measureEach<MatrixPtr>(options, setup, [&](MatrixPtr& matrix) { addConnections(*matrix, c); }));
+        const auto batched = measureEach<MatrixPtr>(options, setup, [&](MatrixPtr& matrix) {
+            ModMatrix::Transaction tx(*matrix);
+            addConnections(*matrix, c);
+        });
+        report("add_connections_batched", c, batched);
+    }
+
+    // One connection: topology edits are what replaced full program recompiles
+    Case headroom = c;
+    headroom.connections = static_cast<uint16_t>(c.connections + 1);
+    auto matrix = makeMatrix(headroom);
+    addConnections(*matrix, c);
+    const auto& src = matrix->getSource(kPoolSize - 1);
+    const auto& dst = matrix->getDestination(kNumDestinations - 1);
+
+    if (enabled(options, "edit_topology")) {
+        report("edit_topology", c, measure(options, [&] {
+                   const auto conn = matrix->addConnection(src, dst, 0.5f);
+                   matrix->removeConnection(conn);
+               }));
+    }
+
+    if (enabled(options, "edit_depth")) {
+        auto conn = matrix->getConnections().front();
+        float depth = 0.0f;
+        report("edit_depth", c, measure(options, [&] { conn.setDepth(depth = depth > 0.9f ? 0.0f : depth + 0.01f); }));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!bench::parseOptions(argc, argv, options)) return 1;
+
+    constexpr uint16_t kVoiceCounts[] = {1, 8, 32, 128};
+    constexpr uint16_t kConnectionCounts[] = {10, 100, 500, 2000};
+    constexpr Mix kMixes[] = {Mix::Mono, Mix::Poly, Mix::Mixed};
+
+    for (const auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        for (const auto mix : kMixes) {
+            for (const auto connections : kConnectionCounts) {
+                if (enabled(options, "process")) {
+                    for (const auto voices : kVoiceCounts) benchProcess(options, {layout, mix, voices, connections});
+                }
+                // Edit costs don't depend on the voice count or layout, so those run once per mix and size
+                if (layout == ModVoiceLayout::VoiceRows) benchEdits(options, {layout, mix, 16, connections});
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,502 @@
+// Whole-plugin load test: loads a built .clap through its clap_entry into a headless host, renders scripted notes
+// and automation faster than real time, and reports how much headroom the plugin leaves.
+//
+// Prints one JSON object per instance count:
+//   {"benchmark":"offline_render","plugin":"...","instances":4,"threads":4,"block_size":128,
+//    "realtime_factor":...,"aggregate_realtime_factor":...,"scaling":...,"mean_block_us":...,
+//    "worst_block_us":...,"deadline_us":...,"overruns":...}
+// realtime_factor is audio time over the time process() took, per instance; aggregate_realtime_factor is the audio
+// time of all instances over the wall time. scaling is the aggregate factor relative to the single-instance run,
+// which is close to the instance count while the threads render independently.
+//
+// Usage: OfflineRenderBench <plugin.clap> [--plugin-id <id>] [--sample-rate <hz>] [--block-size <frames>]
+//                           [--seconds <s>] [--instances <n,n,...>] [--threads <n>] [--voices <n>]
+//                           [--automated-params <n>]
+// Instances are spread over min(instances, threads) threads, each rendering its share block by block.
+
+#include "BenchmarkHarness.h"
+
+#include <clap/clap.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+using namespace applause;
+using namespace applause::bench;
+
+namespace {
+
+struct RenderOptions {
+    std::string path;
+    std::string plugin_id;  // empty: the factory's first plugin
+    double sample_rate = 48000.0;
+    uint32_t block_size = 128;
+    double seconds = 10.0;
+    std::vector<uint32_t> instances{1};
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t voices = 4;  // notes per chord
+    uint32_t automated_params = 8;
+};
+
+// ---------------------------------------------------------------------------------------------------------------
+// Loading
+
+class PluginLibrary {
+public:
+    explicit PluginLibrary(const std::filesystem::path& path) {
+        std::filesystem::path binary = path;
+#if defined(__APPLE__)
+        // A macOS .clap is a bundle; the binary inside is named after it
+        if (std::filesystem::is_directory(path)) binary = path / "Contents" / "MacOS" / path.stem();
+#endif
+#if defined(_WIN32)
+        handle_ = LoadLibraryW(binary.c_str());
+        if (handle_) entry_ = reinterpret_cast<const clap_plugin_entry_t*>(GetProcAddress(handle_, "clap_entry"));
+#else
+        handle_ = dlopen(binary.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle_) std::cerr << dlerror() << "\n";
+        if (handle_) entry_ = static_cast<const clap_plugin_entry_t*>(dlsym(handle_, "clap_entry"));
+#endif
+        if (entry_ && !entry_->init(path.string().c_str())) entry_ = nullptr;
+    }
+
+    ~PluginLibrary() {
+        if (entry_) entry_->deinit();
+#if defined(_WIN32)
+        if (handle_) FreeLibrary(handle_);
+#else
+        if (handle_) dlclose(handle_);
+#endif
+    }
+
+    PluginLibrary(const PluginLibrary&) = delete;
+    PluginLibrary& operator=(const PluginLibrary&) = delete;
+
+    [[nodiscard]] const clap_plugin_entry_t* entry() const { return entry_; }
+
+private:
+#if defined(_WIN32)
+    HMODULE handle_ = nullptr;
+#else
+    void* handle_ = nullptr;
+#endif
+    const clap_plugin_entry_t* entry_ = nullptr;
+};
+
+// A host that supports nothing beyond the core: plugins must cope without optional host extensions anyway
+const clap_host_t kHost{
+    .clap_version = CLAP_VERSION,
+    .host_data = nullptr,
+    .name = "Applause OfflineRenderBench",
+    .vendor = "Applause",
+    .url = "",
+    .version = "1.0.0",
+    .get_extension = [](const clap_host_t*, const char*) -> const void* { return nullptr; },
+    .request_restart = [](const clap_host_t*) {},
+    .request_process = [](const clap_host_t*) {},
+    .request_callback = [](const clap_host_t*) {},
+};
+
+// ---------------------------------------------------------------------------------------------------------------
+// Scripted input
+
+// The events of one block, as a clap_input_events_t, sorted by time
+class EventList {
+public:
+    void clear() { events_.clear(); }
+
+    void note(uint16_t type, uint32_t time, int16_t key, int32_t note_id) {
+        clap_event_note_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, type, 0};
+        e.note_id = note_id;
+        e.port_index = 0;
+        e.channel = 0;
+        e.key = key;
+        e.velocity = 0.8;
+        events_.emplace_back(e);
+    }
+
+    void paramValue(uint32_t time, clap_id param_id, void* cookie, double value) {
+        clap_event_param_value_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE, 0};
+        e.param_id = param_id;
+        e.cookie = cookie;
+        e.note_id = -1;
+        e.port_index = -1;
+        e.channel = -1;
+        e.key = -1;
+        e.value = value;
+        events_.emplace_back(e);
+    }
+
+    const clap_input_events_t* get() {
+        std::stable_sort(events_.begin(), events_.end(),
+                         [](const Event& a, const Event& b) { return header(a).time < header(b).time; });
+        list_.ctx = this;
+        list_.size = [](const clap_input_events_t* l) {
+            return static_cast<uint32_t>(static_cast<EventList*>(l->ctx)->events_.size());
+        };
+        list_.get = [](const clap_input_events_t* l, uint32_t i) {
+            return &header(static_cast<EventList*>(l->ctx)->events_[i]);
+        };
+        return &list_;
+    }
+
+private:
+    using Event = std::variant<clap_event_note_t, clap_event_param_value_t>;
+
+    static const clap_event_header_t& header(const Event& e) {
+        return std::visit([](const auto& event) -> const clap_event_header_t& { return event.header; }, e);
+    }
+
+    std::vector<Event> events_;
+    clap_input_events_t list_{};
+};
+
+const clap_output_events_t kDiscardEvents{
+    .ctx = nullptr,
+    .try_push = [](const clap_output_events_t*, const clap_event_header_t*) { return true; },
+};
+
+struct AutomatedParam {
+    clap_id id;
+    void* cookie;
+    double min;
+    double max;
+    double phase;  // of its LFO, in cycles
+};
+
+// ---------------------------------------------------------------------------------------------------------------
+// Instances
+
+class Instance {
+public:
+    Instance(const clap_plugin_factory_t& factory, const RenderOptions& options, uint32_t index)
+        : options_(options), rng_(kSeed + index) {
+        plugin_ = factory.create_plugin(&factory, &kHost, options.plugin_id.c_str());
+        if (plugin_ && !plugin_->init(plugin_)) {
+            plugin_->destroy(plugin_);
+            plugin_ = nullptr;
+        }
+        if (!plugin_) return;
+
+        setUpAudioPorts(true, inputs_, input_samples_, input_pointers_);
+        setUpAudioPorts(false, outputs_, output_samples_, output_pointers_);
+        setUpAutomation();
+        const auto* note_ports = static_cast<const clap_plugin_note_ports_t*>(
+            plugin_->get_extension(plugin_, CLAP_EXT_NOTE_PORTS));
+        takes_notes_ = note_ports && note_ports->count(plugin_, true) > 0;
+
+        activated_ = plugin_->activate(plugin_, options.sample_rate, 1, options.block_size);
+    }
+
+    ~Instance() {
+        if (!plugin_) return;
+        if (activated_) plugin_->deactivate(plugin_);
+        plugin_->destroy(plugin_);
+    }
+
+    Instance(const Instance&) = delete;
+    Instance& operator=(const Instance&) = delete;
+
+    [[nodiscard]] bool isReady() const { return activated_; }
+
+    // Audio thread: before the first and after the last block
+    bool startProcessing() { return plugin_->start_processing(plugin_); }
+    void stopProcessing() { plugin_->stop_processing(plugin_); }
+
+    // Renders the next block and returns how long process() took, in seconds
+    double renderBlock() {
+        scriptBlock();
+
+        clap_process_t process{};
+        process.steady_time = static_cast<int64_t>(position_);
+        process.frames_count = options_.block_size;
+        process.audio_inputs = inputs_.data();
+        process.audio_inputs_count = static_cast<uint32_t>(inputs_.size());
+        process.audio_outputs = outputs_.data();
+        process.audio_outputs_count = static_cast<uint32_t>(outputs_.size());
+        process.in_events = events_.get();
+        process.out_events = &kDiscardEvents;
+
+        const auto start = Clock::now();
+        plugin_->process(plugin_, &process);
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        position_ += options_.block_size;
+        return elapsed;
+    }
+
+private:
+    void setUpAudioPorts(bool is_input, std::vector<clap_audio_buffer_t>& buffers, std::vector<float>& samples,
+                         std::vector<float*>& pointers) {
+        const auto* ports =
+            static_cast<const clap_plugin_audio_ports_t*>(plugin_->get_extension(plugin_, CLAP_EXT_AUDIO_PORTS));
+        if (!ports) return;
+
+        std::vector<uint32_t> channels;
+        for (uint32_t i = 0; i < ports->count(plugin_, is_input); ++i) {
+            clap_audio_port_info_t info{};
+            if (ports->get(plugin_, i, is_input, &info)) channels.push_back(info.channel_count);
+        }
+
+        uint32_t total = 0;
+        for (const uint32_t c : channels) total += c;
+        samples.assign(static_cast<size_t>(total) * options_.block_size, 0.0f);
+        pointers.resize(total);
+        for (uint32_t ch = 0; ch < total; ++ch) {
+            pointers[ch] = samples.data() + static_cast<size_t>(ch) * options_.block_size;
+        }
+
+        // Inputs carry quiet noise, so effects have something to work on
+        if (is_input) {
+            std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+            for (float& s : samples) s = noise(rng_);
+        }
+
+        uint32_t first = 0;
+        for (const uint32_t c : channels) {
+            clap_audio_buffer_t buffer{};
+            buffer.data32 = c > 0 ? pointers.data() + first : nullptr;
+            buffer.channel_count = c;
+            buffers.push_back(buffer);
+            first += c;
+        }
+    }
+
+    void setUpAutomation() {
+        const auto* params =
+            static_cast<const clap_plugin_params_t*>(plugin_->get_extension(plugin_, CLAP_EXT_PARAMS));
+        if (!params) return;
+
+        std::uniform_real_distribution<double> phase(0.0, 1.0);
+        for (uint32_t i = 0; i < params->count(plugin_) && automation_.size() < options_.automated_params; ++i) {
+            clap_param_info_t info{};
+            if (!params->get_info(plugin_, i, &info)) continue;
+            if ((info.flags & CLAP_PARAM_IS_AUTOMATABLE) == 0 || (info.flags & CLAP_PARAM_IS_READONLY) != 0) {
+                continue;
+            }
+            automation_.push_back({info.id, info.cookie, info.min_value, info.max_value, phase(rng_)});
+        }
+    }
+
+    // This block's events: every automated parameter moves once per block, following a slow LFO, and chords of
+    // options_.voices random keys start every half second and end 0.4 s later
+    void scriptBlock() {
+        constexpr double kLfoHz = 0.25;
+        constexpr double kChordInterval = 0.5;
+        constexpr double kChordLength = 0.4;
+
+        events_.clear();
+        const double time = static_cast<double>(position_) / options_.sample_rate;
+        for (const AutomatedParam& p : automation_) {
+            const double lfo = 0.5 + 0.5 * std::sin(2.0 * M_PI * (kLfoHz * time + p.phase));
+            events_.paramValue(0, p.id, p.cookie, p.min + (p.max - p.min) * lfo);
+        }
+        if (!takes_notes_) return;
+
+        const auto interval = static_cast<uint64_t>(kChordInterval * options_.sample_rate);
+        const auto length = static_cast<uint64_t>(kChordLength * options_.sample_rate);
+        const uint64_t end = position_ + options_.block_size;
+        for (uint64_t chord = position_ / interval * interval; chord < end; chord += interval) {
+            if (chord >= position_) {
+                std::uniform_int_distribution<int> key(36, 84);
+                for (uint32_t v = 0; v < options_.voices; ++v) {
+                    held_.emplace_back(static_cast<int16_t>(key(rng_)), next_note_id_++);
+                    events_.note(CLAP_EVENT_NOTE_ON, static_cast<uint32_t>(chord - position_), held_.back().first,
+                                 held_.back().second);
+                }
+            }
+            if (chord + length >= position_ && chord + length < end) {
+                const auto offset = static_cast<uint32_t>(chord + length - position_);
+                for (const auto& [key, id] : held_) events_.note(CLAP_EVENT_NOTE_OFF, offset, key, id);
+                held_.clear();
+            }
+        }
+    }
+
+    const RenderOptions& options_;
+    std::mt19937 rng_;
+    const clap_plugin_t* plugin_ = nullptr;
+    bool activated_ = false;
+    bool takes_notes_ = false;
+
+    std::vector<clap_audio_buffer_t> inputs_, outputs_;
+    std::vector<float> input_samples_, output_samples_;
+    std::vector<float*> input_pointers_, output_pointers_;
+    std::vector<AutomatedParam> automation_;
+
+    EventList events_;
+    std::vector<std::pair<int16_t, int32_t>> held_;  // key and note id of the sounding chord
+    int32_t next_note_id_ = 0;
+    uint64_t position_ = 0;
+};
+
+struct RunStats {
+    double process_seconds = 0.0;  // summed over instances
+    double worst_block = 0.0;
+    uint64_t blocks = 0;
+    uint64_t overruns = 0;
+    double wall_seconds = 0.0;
+};
+
+// Renders options.seconds of audio on every instance, spread over the threads
+RunStats render(std::vector<std::unique_ptr<Instance>>& instances, const RenderOptions& options, uint32_t threads) {
+    const auto blocks = static_cast<uint64_t>(std::ceil(options.seconds * options.sample_rate / options.block_size));
+    const double deadline = options.block_size / options.sample_rate;
+
+    std::vector<RunStats> per_thread(threads);
+    std::vector<std::thread> workers;
+    std::atomic<uint32_t> waiting{threads};
+    const auto start = Clock::now();
+    for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<Instance*> mine;
+            for (size_t i = t; i < instances.size(); i += threads) mine.push_back(instances[i].get());
+            for (Instance* instance : mine) instance->startProcessing();
+
+            // Start rendering together, so the threads actually compete
+            waiting.fetch_sub(1);
+            while (waiting.load() > 0) std::this_thread::yield();
+
+            RunStats& stats = per_thread[t];
+            for (uint64_t b = 0; b < blocks; ++b) {
+                for (Instance* instance : mine) {
+                    const double elapsed = instance->renderBlock();
+                    stats.process_seconds += elapsed;
+                    stats.worst_block = std::max(stats.worst_block, elapsed);
+                    stats.overruns += elapsed > deadline;
+                    ++stats.blocks;
+                }
+            }
+            for (Instance* instance : mine) instance->stopProcessing();
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    RunStats total;
+    total.wall_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const RunStats& stats : per_thread) {
+        total.process_seconds += stats.process_seconds;
+        total.worst_block = std::max(total.worst_block, stats.worst_block);
+        total.blocks += stats.blocks;
+        total.overruns += stats.overruns;
+    }
+    return total;
+}
+
+bool parseList(std::string_view text, std::vector<uint32_t>& out) {
+    out.clear();
+    std::stringstream stream{std::string(text)};
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const int value = std::atoi(item.c_str());
+        if (value <= 0) return false;
+        out.push_back(static_cast<uint32_t>(value));
+    }
+    return !out.empty();
+}
+
+bool parseRenderOptions(int argc, char** argv, RenderOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--plugin-id" && has_value) {
+            options.plugin_id = argv[++i];
+        } else if (arg == "--sample-rate" && has_value) {
+            options.sample_rate = std::atof(argv[++i]);
+        } else if (arg == "--block-size" && has_value) {
+            options.block_size = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--seconds" && has_value) {
+            options.seconds = std::atof(argv[++i]);
+        } else if (arg == "--instances" && has_value) {
+            if (!parseList(argv[++i], options.instances)) return false;
+        } else if (arg == "--threads" && has_value) {
+            options.threads = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--voices" && has_value) {
+            options.voices = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--automated-params" && has_value) {
+            options.automated_params = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (options.path.empty() && !arg.starts_with("--")) {
+            options.path = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.path.empty() && options.sample_rate > 0.0 && options.seconds > 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    RenderOptions options;
+    if (!parseRenderOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <plugin.clap> [--plugin-id <id>] [--sample-rate <hz>] [--block-size <frames>] [--seconds <s>]"
+                     " [--instances <n,n,...>] [--threads <n>] [--voices <n>] [--automated-params <n>]\n";
+        return 1;
+    }
+
+    PluginLibrary library(options.path);
+    const auto* factory = library.entry() ? static_cast<const clap_plugin_factory_t*>(
+                                                library.entry()->get_factory(CLAP_PLUGIN_FACTORY_ID))
+                                          : nullptr;
+    if (!factory || factory->get_plugin_count(factory) == 0) {
+        std::cerr << "No CLAP plugin factory in " << options.path << "\n";
+        return 1;
+    }
+    if (options.plugin_id.empty()) options.plugin_id = factory->get_plugin_descriptor(factory, 0)->id;
+
+    double single_aggregate = 0.0;
+    for (const uint32_t count : options.instances) {
+        std::vector<std::unique_ptr<Instance>> instances;
+        for (uint32_t i = 0; i < count; ++i) {
+            instances.push_back(std::make_unique<Instance>(*factory, options, i));
+            if (!instances.back()->isReady()) {
+                std::cerr << "Couldn't create and activate " << options.plugin_id << "\n";
+                return 1;
+            }
+        }
+
+        const uint32_t threads = std::min(count, options.threads);
+        const RunStats stats = render(instances, options, threads);
+        const double audio_seconds = static_cast<double>(stats.blocks) * options.block_size / options.sample_rate;
+        const double aggregate = audio_seconds / stats.wall_seconds;
+        if (count == 1) single_aggregate = aggregate;
+
+        json out{{"benchmark", "offline_render"},
+                 {"plugin", options.plugin_id},
+                 {"instances", count},
+                 {"threads", threads},
+                 {"block_size", options.block_size},
+                 {"sample_rate", options.sample_rate},
+                 {"realtime_factor", audio_seconds / stats.process_seconds},
+                 {"aggregate_realtime_factor", aggregate},
+                 {"mean_block_us", 1e6 * stats.process_seconds / static_cast<double>(stats.blocks)},
+                 {"worst_block_us", 1e6 * stats.worst_block},
+                 {"deadline_us", 1e6 * options.block_size / options.sample_rate},
+                 {"overruns", stats.overruns}};
+        if (single_aggregate > 0.0) out["scaling"] = aggregate / single_aggregate;
+        std::cout << out.dump() << std::endl;
+    }
+    return 0;
+}
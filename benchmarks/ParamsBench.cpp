@@ -0,0 +1,289 @@
+// ParamsExtension micro-benchmarks: the per-block cost of processEvents() under host automation.
+//
+// Prints one JSON object per line per case (see BenchmarkHarness.h), e.g.
+//   {"benchmark":"params_process_events","cookies":true,"events":256,"params":512,...,"ns_per_op":...}
+// ns_per_op is per block.
+//
+// Usage: ParamsBench [--filter <substring>] [--min-time-ms <ms>]
+// Benchmarks:
+//   params_process_events  Each block carries the case's CLAP_EVENT_PARAM_VALUE events at random times on random
+//                          parameters, with the cookies from get_info() or (like some hosts) without them.
+//   params_event_stream    A host-like block of up to 10k events: dense automation ramps clustered on a few
+//                          parameters, a sprinkle of others, CLAP_EVENT_PARAM_MOD and note events interleaved.
+//                          Adds "ns_per_event", over every event in the block.
+//   params_ui_drain        The same stream while the UI writes values through a ParamMessageQueue between blocks
+//                          (setup, untimed) and reads host changes back with dispatchHostChanges(); the block also
+//                          drains the queue into host output events, and "ns_per_event" counts those too. Adds
+//                          "dropped_to_audio_per_block", the UI messages the full queue refused,
+//                          "out_events_per_block" and "ui_notifications_per_block".
+
+#include "BenchmarkHarness.h"
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/ParamsExtension.h>
+#include <applause/util/ParamMessageQueue.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace applause;
+using namespace applause::bench;
+
+namespace {
+
+constexpr uint32_t kFrames = 256;
+const clap_plugin_descriptor_t kDescriptor{};
+
+struct BenchPlugin : PluginBase {
+    ParamsExtension params;
+    explicit BenchPlugin(uint32_t num_params) : PluginBase(&kDescriptor, nullptr), params(num_params) {
+        registerExtension(params);
+    }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+
+struct EventList {
+    std::vector<clap_event_param_value_t> events;
+    clap_input_events_t in{
+        .ctx = this,
+        .size = [](const clap_input_events_t* list) -> uint32_t {
+            return static_cast<uint32_t>(static_cast<EventList*>(list->ctx)->events.size());
+        },
+        .get = [](const clap_input_events_t* list, uint32_t index) -> const clap_event_header_t* {
+            return &static_cast<EventList*>(list->ctx)->events[index].header;
+        },
+    };
+};
+
+void registerParams(BenchPlugin& plugin, uint32_t num_params) {
+    for (uint32_t i = 0; i < num_params; ++i) {
+        ParamConfig config;
+        config.string_id = "param" + std::to_string(i);
+        plugin.params.registerParam(config);
+    }
+}
+
+void benchProcessEvents(const Options& options, uint32_t num_params, uint32_t event_count, bool cookies) {
+    BenchPlugin plugin(num_params);
+    registerParams(plugin, num_params);
+    const auto* clap_params = static_cast<const clap_plugin_params_t*>(plugin.params.getClapExtensionStruct());
+
+    std::mt19937 rng(kSeed);
+    std::uniform_int_distribution<uint32_t> param(0, num_params - 1);
+    std::uniform_int_distribution<uint32_t> time(0, kFrames - 1);
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+
+    EventList list;
+    for (uint32_t i = 0; i < event_count; ++i) {
+        clap_param_info_t info{};
+        clap_params->get_info(plugin.clapPlugin(), param(rng), &info);
+
+        clap_event_param_value_t event{};
+        event.header = {sizeof(event), time(rng), CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE, 0};
+        event.param_id = info.id;
+        event.cookie = cookies ? info.cookie : nullptr;
+        event.note_id = -1;
+        event.port_index = -1;
+        event.channel = -1;
+        event.key = -1;
+        event.value = value(rng);
+        list.events.push_back(event);
+    }
+    std::stable_sort(list.events.begin(), list.events.end(),
+                     [](const auto& a, const auto& b) { return a.header.time < b.header.time; });
+
+    const Result r = measure(options, [&] { plugin.params.processEvents(&list.in, nullptr); });
+    report({{"benchmark", "params_process_events"},
+            {"params", num_params},
+            {"events", event_count},
+            {"cookies", cookies}},
+           r);
+}
+
+// A host's block as it arrives: events of mixed types and sizes, sorted by time
+struct MixedEventList {
+    union Event {
+        clap_event_header_t header;
+        clap_event_param_value_t value;
+        clap_event_param_mod_t mod;
+        clap_event_note_t note;
+    };
+    std::vector<Event> events;
+    clap_input_events_t in{
+        .ctx = this,
+        .size = [](const clap_input_events_t* list) -> uint32_t {
+            return static_cast<uint32_t>(static_cast<MixedEventList*>(list->ctx)->events.size());
+        },
+        .get = [](const clap_input_events_t* list, uint32_t index) -> const clap_event_header_t* {
+            return &static_cast<MixedEventList*>(list->ctx)->events[index].header;
+        },
+    };
+};
+
+// Counts what processEvents() sends the host, accepting everything
+struct CountingOutList {
+    uint64_t count = 0;
+    clap_output_events_t out{
+        .ctx = this,
+        .try_push = [](const clap_output_events_t* list, const clap_event_header_t*) -> bool {
+            ++static_cast<CountingOutList*>(list->ctx)->count;
+            return true;
+        },
+    };
+};
+
+// What a host sends while a few automation lanes are drawn in: 80% ramps on kHotParams parameters, evenly spread
+// over the block, 10% single values on any parameter, 5% global modulation and 5% note events for the instrument
+MixedEventList makeEventStream(BenchPlugin& plugin, uint32_t num_params, uint32_t event_count, bool cookies) {
+    constexpr uint32_t kHotParams = 4;
+    const auto* clap_params = static_cast<const clap_plugin_params_t*>(plugin.params.getClapExtensionStruct());
+    auto paramInfo = [&](uint32_t index) {
+        clap_param_info_t info{};
+        clap_params->get_info(plugin.clapPlugin(), index, &info);
+        return info;
+    };
+
+    std::mt19937 rng(kSeed);
+    std::uniform_int_distribution<uint32_t> param(0, num_params - 1);
+    std::uniform_int_distribution<uint32_t> time(0, kFrames - 1);
+    std::uniform_int_distribution<uint32_t> kind(0, 99);
+    std::uniform_int_distribution<int16_t> key(36, 96);
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+
+    MixedEventList list;
+    list.events.reserve(event_count);
+    for (uint32_t i = 0; i < event_count; ++i) {
+        MixedEventList::Event event{};
+        const uint32_t k = kind(rng);
+        if (k < 80) {
+            const uint32_t lane = i % std::min(kHotParams, num_params);
+            const clap_param_info_t info = paramInfo(lane);
+            const double phase = static_cast<double>(i) / static_cast<double>(event_count);
+            const auto at = static_cast<uint32_t>(phase * kFrames);
+            event.value = {};
+            event.value.header = {sizeof(event.value), at, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE, 0};
+            event.value.param_id = info.id;
+            event.value.cookie = cookies ? info.cookie : nullptr;
+            event.value.note_id = event.value.port_index = event.value.channel = event.value.key = -1;
+            event.value.value = 0.5 + 0.5 * std::sin(6.283185307179586 * (phase + 0.25 * lane));
+        } else if (k < 90) {
+            const clap_param_info_t info = paramInfo(param(rng));
+            event.value = {};
+            event.value.header = {sizeof(event.value), time(rng), CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE, 0};
+            event.value.param_id = info.id;
+            event.value.cookie = cookies ? info.cookie : nullptr;
+            event.value.note_id = event.value.port_index = event.value.channel = event.value.key = -1;
+            event.value.value = value(rng);
+        } else if (k < 95) {
+            const clap_param_info_t info = paramInfo(param(rng));
+            event.mod = {};
+            event.mod.header = {sizeof(event.mod), time(rng), CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_MOD, 0};
+            event.mod.param_id = info.id;
+            event.mod.cookie = cookies ? info.cookie : nullptr;
+            event.mod.note_id = event.mod.port_index = event.mod.channel = event.mod.key = -1;
+            event.mod.amount = value(rng) - 0.5;
+        } else {
+            const uint16_t type = k % 2 == 0 ? CLAP_EVENT_NOTE_ON : CLAP_EVENT_NOTE_OFF;
+            event.note = {};
+            event.note.header = {sizeof(event.note), time(rng), CLAP_CORE_EVENT_SPACE_ID, type, 0};
+            event.note.note_id = -1;
+            event.note.port_index = 0;
+            event.note.channel = 0;
+            event.note.key = key(rng);
+            event.note.velocity = 0.8;
+        }
+        list.events.push_back(event);
+    }
+    std::stable_sort(list.events.begin(), list.events.end(),
+                     [](const auto& a, const auto& b) { return a.header.time < b.header.time; });
+    return list;
+}
+
+void benchEventStream(const Options& options, uint32_t num_params, uint32_t event_count, bool cookies) {
+    BenchPlugin plugin(num_params);
+    registerParams(plugin, num_params);
+    MixedEventList list = makeEventStream(plugin, num_params, event_count, cookies);
+
+    const Result r = measure(options, [&] { plugin.params.processEvents(&list.in, nullptr); });
+    report({{"benchmark", "params_event_stream"},
+            {"params", num_params},
+            {"events", event_count},
+            {"cookies", cookies},
+            {"ns_per_event", r.ns_per_op / event_count}},
+           r);
+}
+
+// ui_writes values per block from the UI, round-robin over the parameters, into a queue of the default capacity:
+// past ParamMessageQueue::kDefaultCapacity the queue refuses them and processEvents() coalesces the rest
+void benchUiDrain(const Options& options, uint32_t num_params, uint32_t event_count, uint32_t ui_writes) {
+    BenchPlugin plugin(num_params);
+    registerParams(plugin, num_params);
+    ParamMessageQueue queue;
+    plugin.params.setMessageQueue(&queue);
+    MixedEventList list = makeEventStream(plugin, num_params, event_count, true);
+    CountingOutList out;
+
+    uint32_t next = 0;
+    uint64_t notified = 0;
+    const Result r = measureEach<int>(
+        options,
+        [&] {
+            notified += plugin.params.dispatchHostChanges();
+            for (uint32_t i = 0; i < ui_writes; ++i, ++next) {
+                plugin.params.getInfoAt(next % num_params).setValueNotifyingHost(static_cast<float>(i % 100) * 0.01f);
+            }
+            return 0;
+        },
+        [&](int&) { plugin.params.processEvents(&list.in, &out.out); });
+
+    const auto blocks = static_cast<double>(r.iterations);
+    const double out_per_block = static_cast<double>(out.count) / blocks;
+    report({{"benchmark", "params_ui_drain"},
+            {"params", num_params},
+            {"events", event_count},
+            {"ui_writes", ui_writes},
+            {"ns_per_event", r.ns_per_op / (event_count + out_per_block)},
+            {"dropped_to_audio_per_block", static_cast<double>(queue.getDroppedToAudio()) / blocks},
+            {"out_events_per_block", out_per_block},
+            {"ui_notifications_per_block", static_cast<double>(notified) / blocks}},
+           r);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    constexpr uint32_t kParamCounts[] = {16, 128, 1024};
+
+    if (enabled(options, "params_process_events")) {
+        constexpr uint32_t kEventCounts[] = {0, 16, 256, 2048};
+        for (const uint32_t params : kParamCounts) {
+            for (const uint32_t events : kEventCounts) {
+                for (const bool cookies : {true, false}) {
+                    if (events > 0 || cookies) benchProcessEvents(options, params, events, cookies);
+                }
+            }
+        }
+    }
+
+    if (enabled(options, "params_event_stream")) {
+        for (const uint32_t params : kParamCounts) {
+            for (const uint32_t events : {256u, 2048u, 10000u}) {
+                for (const bool cookies : {true, false}) benchEventStream(options, params, events, cookies);
+            }
+        }
+    }
+
+    if (enabled(options, "params_ui_drain")) {
+        for (const uint32_t params : {128u, 1024u}) {
+            for (const uint32_t ui_writes : {64u, 4096u}) benchUiDrain(options, params, 10000, ui_writes);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Synthesizer micro-benchmarks: voice management and event dispatch around a minimal oscillator voice.
+//
+// Prints one JSON object per line per case (see BenchmarkHarness.h), e.g.
+//   {"benchmark":"synth_process","events":128,"frames":256,"voices":32,...,"ns_per_op":...}
+// ns_per_op is per processed block.
+//
+// Usage: SynthesizerBench [--filter <substring>] [--min-time-ms <ms>]
+// The only benchmark is "synth_process". Each block carries the case's events at random times: pressure
+// expressions on held notes, and retriggers (a note off followed by a new note on of the same key) for up to half
+// of them, so the number of sounding voices stays at the case's voice count.
+
+#include "BenchmarkHarness.h"
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/Synthesizer.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <variant>
+#include <vector>
+
+using namespace applause;
+using namespace applause::bench;
+
+namespace {
+
+constexpr size_t kChannels = 2;
+constexpr size_t kPoolSize = 128;
+constexpr uint32_t kMaxFrames = 1024;
+constexpr double kSampleRate = 48000.0;
+
+// A quiet naive saw that stops as soon as its key is released; cheap enough that the Synthesizer's own work shows
+class SawVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void noteOn() override {
+        phase_ = 0.0f;
+        increment_ = static_cast<float>(note_.getFrequency() / getSampleRate());
+    }
+
+    void process(BufferView<float, kChannels> buffer, int start_sample, int num_samples) override {
+        if (getState() == State::Released) {
+            terminateVoice();
+            return;
+        }
+        float phase = phase_;
+        for (size_t ch = 0; ch < buffer.numChannels(); ++ch) {
+            float* out = buffer.channelSamples(ch) + start_sample;
+            phase = phase_;
+            for (int i = 0; i < num_samples; ++i) {
+                out[i] += 0.05f * (2.0f * phase - 1.0f);
+                phase += increment_;
+                phase -= phase >= 1.0f ? 1.0f : 0.0f;
+            }
+        }
+        phase_ = phase;
+    }
+
+private:
+    float phase_ = 0.0f;
+    float increment_ = 0.0f;
+};
+
+using Synth = Synthesizer<float, kChannels, kPoolSize, SawVoice>;
+
+// The events of one block, as a clap_input_events_t, sorted by time
+class EventList {
+public:
+    void note(uint16_t type, uint32_t time, int16_t key) {
+        clap_event_note_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, type, 0};
+        e.note_id = -1;
+        e.key = key;
+        e.velocity = 0.8;
+        events_.emplace_back(e);
+    }
+
+    void pressure(uint32_t time, int16_t key, double value) {
+        clap_event_note_expression_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_NOTE_EXPRESSION, 0};
+        e.expression_id = CLAP_NOTE_EXPRESSION_PRESSURE;
+        e.note_id = -1;
+        e.port_index = -1;
+        e.channel = -1;
+        e.key = key;
+        e.value = value;
+        events_.emplace_back(e);
+    }
+
+    void sort() {
+        std::stable_sort(events_.begin(), events_.end(),
+                         [](const Event& a, const Event& b) { return header(a).time < header(b).time; });
+    }
+
+    const clap_input_events_t* get() {
+        list_.ctx = this;
+        list_.size = [](const clap_input_events_t* l) {
+            return static_cast<uint32_t>(static_cast<EventList*>(l->ctx)->events_.size());
+        };
+        list_.get = [](const clap_input_events_t* l, uint32_t i) {
+            return &header(static_cast<EventList*>(l->ctx)->events_[i]);
+        };
+        return &list_;
+    }
+
+private:
+    using Event = std::variant<clap_event_note_t, clap_event_note_expression_t>;
+
+    static const clap_event_header_t& header(const Event& e) {
+        return std::visit([](const auto& event) -> const clap_event_header_t& { return event.header; }, e);
+    }
+
+    std::vector<Event> events_;
+    clap_input_events_t list_{};
+};
+
+// Held notes use keys 0 to voices - 1
+EventList makeEvents(uint32_t voices, uint32_t frames, uint32_t count) {
+    std::mt19937 rng(kSeed);
+    std::uniform_int_distribution<uint32_t> key(0, voices - 1);
+    std::uniform_int_distribution<uint32_t> time(0, frames - 2);
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+
+    EventList events;
+    std::vector<std::vector<uint32_t>> retriggers(voices);  // note off times per key
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto k = static_cast<int16_t>(key(rng));
+        const uint32_t t = time(rng);
+
+        // The note on lands one frame after the note off, once the released voice has finished. A key retriggered
+        // twice that close together would leave an extra voice behind, so those become expressions too.
+        auto& times = retriggers[k];
+        const bool clashes = std::any_of(times.begin(), times.end(), [&](uint32_t other) {
+            return t < other + 2 && other < t + 2;
+        });
+        if (i % 2 == 0 || clashes) {
+            events.pressure(t, k, value(rng));
+        } else {
+            times.push_back(t);
+            events.note(CLAP_EVENT_NOTE_OFF, t, k);
+            events.note(CLAP_EVENT_NOTE_ON, t + 1, k);
+        }
+    }
+    events.sort();
+    return events;
+}
+
+void benchProcess(const Options& options, uint32_t voices, uint32_t frames, uint32_t event_count) {
+    Synth synth;
+    synth.activate({kSampleRate, 1, kMaxFrames});
+
+    EventList held;
+    for (uint32_t k = 0; k < voices; ++k) held.note(CLAP_EVENT_NOTE_ON, 0, static_cast<int16_t>(k));
+
+    std::vector<float> samples(kChannels * frames);
+    BufferView<float, kChannels> buffer(samples.data(), kChannels, frames);
+    synth.process(buffer, held.get());
+
+    EventList events = makeEvents(voices, frames, event_count);
+    const clap_input_events_t* in = events.get();
+    const Result r = measure(options, [&] {
+        buffer.clear();
+        synth.process(buffer, in);
+    });
+    report({{"benchmark", "synth_process"}, {"voices", voices}, {"frames", frames}, {"events", event_count}}, r);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+    if (!enabled(options, "synth_process")) return 0;
+
+    constexpr uint32_t kVoiceCounts[] = {1, 8, 32, 128};
+    constexpr uint32_t kFrameCounts[] = {64, 256, 1024};
+    constexpr uint32_t kEventCounts[] = {0, 16, 128};
+
+    for (const uint32_t voices : kVoiceCounts) {
+        for (const uint32_t frames : kFrameCounts) {
+            for (const uint32_t events : kEventCounts) benchProcess(options, voices, frames, events);
+        }
+    }
+    return 0;
+}
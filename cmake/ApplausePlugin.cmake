@@ -36,6 +36,7 @@
 #
 #       # Optional
 #       COPY_AFTER_BUILD TRUE
+#       SIMD_DISPATCH TRUE  # Select the framework's AVX2 / AVX-512 SIMD kernels at load on CPUs that have them
 #   )
 #
 # IMPORTANT: Some (not all) hosts are very picky about PLUGIN_FEATURES matching registered extensions. For example:
@@ -53,7 +54,7 @@ function(add_applause_plugin)
     # Parse arguments
     cmake_parse_arguments(
         APPL
-        "COPY_AFTER_BUILD"  # Options
+        "COPY_AFTER_BUILD;SIMD_DISPATCH"  # Options
         "TARGET_NAME;OUTPUT_NAME;PLUGIN_CLASS;PLUGIN_HEADER;PLUGIN_ID;PLUGIN_NAME;PLUGIN_VENDOR;PLUGIN_URL;PLUGIN_MANUAL_URL;PLUGIN_SUPPORT_URL;PLUGIN_VERSION;PLUGIN_DESCRIPTION;BUNDLE_IDENTIFIER;BUNDLE_VERSION;AUV2_MANUFACTURER_NAME;AUV2_MANUFACTURER_CODE;AUV2_SUBTYPE_CODE;AUV2_INSTRUMENT_TYPE"  # Single-value args
         "PLUGIN_FEATURES;SOURCES;PLUGIN_FORMATS"  # Multi-value args
         ${ARGN}
@@ -128,12 +129,21 @@ function(add_applause_plugin)
         set(SUPPORT_URL_VALUE "nullptr")
     endif()
 
+    # Kernel selection at load, see applause/dsp/simd/Dispatch.h
+    if(APPL_SIMD_DISPATCH)
+        set(SIMD_DISPATCH_INCLUDE "#include \"applause/dsp/simd/Dispatch.h\"\n")
+        set(SIMD_DISPATCH_INIT "    applause::simd::selectKernels();\n")
+    else()
+        set(SIMD_DISPATCH_INCLUDE "")
+        set(SIMD_DISPATCH_INIT "")
+    endif()
+
     # Generate the entry file content
     set(ENTRY_CONTENT "#include \"${APPL_PLUGIN_HEADER}\"
 #include <clap/clap.h>
 #include <cstring>
 #include \"applause/util/DebugHelpers.h\"
-
+${SIMD_DISPATCH_INCLUDE}
 // Plugin features
 static const char* features[] = {
 ${FEATURES_ARRAY}
@@ -189,7 +199,7 @@ static const clap_plugin_factory_t generated_factory = {
 
 // Plugin entry point implementation
 static bool clap_init(const char* path) {
-    return true;
+${SIMD_DISPATCH_INIT}    return true;
 }
 
 static void clap_deinit() {
@@ -219,6 +229,9 @@ extern \"C\" CLAP_EXPORT const clap_plugin_entry_t clap_entry = {
 
     # Link with Applause
     target_link_libraries(${APPL_TARGET_NAME}-impl PUBLIC Applause::Applause)
+    if(APPL_SIMD_DISPATCH)
+        target_link_libraries(${APPL_TARGET_NAME}-impl PUBLIC Applause::SimdDispatch)
+    endif()
 
     # Include directories
     target_include_directories(${APPL_TARGET_NAME}-impl PUBLIC
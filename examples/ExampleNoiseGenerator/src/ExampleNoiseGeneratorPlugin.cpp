@@ -2,8 +2,7 @@
 #include <applause/util/DebugHelpers.h>
 
 ExampleNoiseGeneratorPlugin::ExampleNoiseGeneratorPlugin(const clap_plugin_descriptor_t* descriptor, const clap_host_t* host)
-    : PluginBase(descriptor, host),
-      noise_seed_(1)  // Initialize with non-zero seed
+    : PluginBase(descriptor, host)
 {
     LOG_INFO("ExampleNoiseGenerator constructor");
 
@@ -48,18 +47,7 @@ applause::ProcessStatus ExampleNoiseGeneratorPlugin::process(applause::ProcessCo
     }
 
     auto output = context.output<float, 2>();
-    output.clear();
-
-    // Generate white noise for each frame
-    for (std::size_t frame = 0; frame < context.numFrames(); ++frame) {
-        // Fast PRNG: Linear congruential generator
-        noise_seed_ = noise_seed_ * 196314165 + 907633515;
-        int temp = static_cast<int>(noise_seed_ >> 7) - 16777216;
-        float sample = static_cast<float>(temp) / 16777216.0f;
-
-        for (std::size_t channel = 0; channel < output.numChannels(); ++channel)
-            output.channel(channel).store(frame, sample);
-    }
+    noise_.fillUniform(output);
 
     return applause::ProcessStatus::Continue;
 }
@@ -3,6 +3,7 @@
 #include <applause/extensions/StateExtension.h>
 
 #include <applause/core/PluginBase.h>
+#include <applause/dsp/Random.h>
 #include <applause/extensions/AudioPortsExtension.h>
 #include <applause/extensions/NotePortsExtension.h>
 #include <applause/util/DebugHelpers.h>
@@ -27,6 +28,6 @@ private:
     applause::AudioPortsExtension audio_ports_;
     applause::StateExtension state_;
     
-    // Fast PRNG state for white noise generation
-    uint32_t noise_seed_;
+    // White noise, one stream per output channel
+    applause::NoiseGenerator noise_{2};
 };
@@ -1,4 +1,5 @@
 #include "ExampleShowcasePlugin.h"
+#include <applause/dsp/FastMath.h>
 #include <applause/util/DebugHelpers.h>
 #include <applause/util/Json.h>
 #include <cmath>
@@ -226,7 +227,7 @@ applause::ProcessStatus ExampleShowcasePlugin::process(applause::ProcessContext&
     while (lfo_phase_ >= kTwoPi) lfo_phase_ -= kTwoPi;
 
     mod_matrix_.loadParamBaseValues(params_);
-    mod_matrix_.setMonoSourceValue(lfo1_src_idx_, std::sin(lfo_phase_));
+    mod_matrix_.setMonoSourceValue(lfo1_src_idx_, applause::math::sin(lfo_phase_));
     mod_matrix_.process();
 
     return applause::ProcessStatus::Continue;
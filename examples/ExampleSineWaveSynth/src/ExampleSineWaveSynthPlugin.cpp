@@ -13,6 +13,11 @@ ExampleSineWaveSynthPlugin::ExampleSineWaveSynthPlugin(
     registerExtension(note_ports_);
     registerExtension(audio_ports_);
     registerExtension(state_);
+
+    voice_info_.setVoiceCount(synth_.getNumVoices());
+    registerExtension(voice_info_);
+
+    sineTable();  // Build the voices' shared table now rather than on the first note
 }
 
 bool ExampleSineWaveSynthPlugin::init() noexcept {
@@ -41,7 +46,11 @@ applause::ProcessStatus ExampleSineWaveSynthPlugin::process(
         return applause::ProcessStatus::Sleep;
     }
 
-    synth_.process(context.output<float, 2>(), context.inputEvents());
+    synth_.process(context.output<float, 2>(), context.inputEvents(), context.outputEvents());
 
-    return applause::ProcessStatus::Continue;
+    // Idle tracks cost next to nothing: flag the silent output and let the host put the plugin to sleep
+    if (synth_.isOutputSilent()) {
+        context.markOutputConstant(0);
+    }
+    return synth_.getProcessStatus();
 }
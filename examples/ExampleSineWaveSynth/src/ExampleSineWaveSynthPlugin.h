@@ -2,21 +2,39 @@
 
 #include <applause/core/PluginBase.h>
 #include <applause/dsp/Synthesizer.h>
+#include <applause/dsp/oscillators/Wavetable.h>
+#include <applause/dsp/oscillators/WavetableOscillator.h>
 #include <applause/extensions/AudioPortsExtension.h>
 #include <applause/extensions/NotePortsExtension.h>
 #include <applause/extensions/StateExtension.h>
+#include <applause/extensions/VoiceInfoExtension.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <vector>
 
 constexpr float kPi = 3.14159265358979323846f;
 constexpr float kTwoPi = 2.0f * kPi;
 
+// One sine cycle shared by every voice; the plugin constructor builds it, off the audio thread
+inline const applause::Wavetable& sineTable() {
+    static const applause::Wavetable table = [] {
+        std::vector<float> cycle(2048);
+        for (size_t i = 0; i < cycle.size(); ++i) {
+            cycle[i] = std::sin(kTwoPi * static_cast<float>(i) / static_cast<float>(cycle.size()));
+        }
+        return applause::Wavetable(cycle, cycle.size());
+    }();
+    return table;
+}
+
 class SineWaveVoice : public applause::SynthesizerVoice<float, 2> {
 public:
     void noteOn() override {
-        const float frequency = static_cast<float>(note_.getFrequency());
-        phase_increment_ = kTwoPi * frequency / static_cast<float>(sample_rate_);
-        phase_ = 0.0f;
+        oscillator_.setSampleRate(sample_rate_);
+        oscillator_.setFrequency(static_cast<float>(note_.getFrequency()));
+        oscillator_.resetPhase();
         envelope_ = 0.0f;
         release_samples_ = -1;
     }
@@ -32,8 +50,7 @@ public:
     void onExpressionChange(applause::Note::Expression expression_id, double value) override {
         // React to expression changes by recalculating cached values
         if (expression_id == applause::Note::Expression::Tuning) {
-            const float frequency = static_cast<float>(note_.getFrequency());
-            phase_increment_ = kTwoPi * frequency / static_cast<float>(sample_rate_);
+            oscillator_.setFrequency(static_cast<float>(note_.getFrequency()));
         }
         // This simple synth ignores other expressions, but you could handle:
         // Note::Expression::Volume: adjust envelope target
@@ -49,7 +66,15 @@ public:
         auto left_channel = buffer.channel(0);
         auto right_channel = buffer.channel(1);
 
+        // The oscillator renders a chunk at a time; the envelope runs per sample on top of it
+        std::array<float, 64> wave;
         for (int i = 0; i < num_samples; ++i) {
+            const int chunk_index = i % static_cast<int>(wave.size());
+            if (chunk_index == 0) {
+                oscillator_.process(sineTable(), wave.data(),
+                                    std::min(static_cast<int>(wave.size()), num_samples - i));
+            }
+
             if (release_samples_ >= 0) {
                 const float release_total =
                     static_cast<float>(sample_rate_ * 0.01);
@@ -65,23 +90,16 @@ public:
                 if (envelope_ > 1.0f) envelope_ = 1.0f;
             }
 
-            const float sample =
-                std::sin(phase_) * envelope_ * velocity_scale * 0.3f;
+            const float sample = wave[static_cast<size_t>(chunk_index)] * envelope_ * velocity_scale * 0.3f;
 
             const int frame_index = start_sample + i;
             left_channel.add(frame_index, sample);
             right_channel.add(frame_index, sample);
-
-            phase_ += phase_increment_;
-            if (phase_ >= kTwoPi) {
-                phase_ -= kTwoPi;
-            }
         }
     }
 
 private:
-    float phase_ = 0.0f;
-    float phase_increment_ = 0.0f;
+    applause::WavetableOscillator<float> oscillator_;
     float envelope_ = 0.0f;
     int release_samples_ = -1;
 };
@@ -103,6 +121,7 @@ private:
     applause::NotePortsExtension note_ports_;
     applause::AudioPortsExtension audio_ports_;
     applause::StateExtension state_;
+    applause::VoiceInfoExtension voice_info_;
 
     applause::Synthesizer<float, 2, 16, SineWaveVoice> synth_;
     double sample_rate_ = 44100.0;
@@ -0,0 +1,47 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/core/DeadlineProfiler.h>
+
+using namespace applause;
+
+TEST_CASE("DeadlineProfiler bins block loads and logs overruns", "[core][profiling]") {
+    DeadlineProfiler profiler;
+    constexpr double rate = 48000.0;
+    constexpr uint32_t frames = 480;  // 10 ms of audio
+    constexpr uint64_t budget = 10'000'000;
+
+    profiler.record(budget / 4, frames, 0, rate);        // 25%
+    profiler.record(budget / 4, frames, 3, rate);        // 25%
+    profiler.record(budget * 12 / 10, frames, 7, rate);  // 120%, an overrun
+    profiler.record(budget * 3, frames, 1, rate);        // 300%, clamped into the last bin
+    profiler.record(budget * 2, frames, 0, rate);        // 200%
+    profiler.record(100, 0, 0, rate);                    // Counted as a block, but has no deadline
+
+    REQUIRE(profiler.getBlockCount() == 6);
+    const auto histogram = profiler.getHistogram();
+    CHECK(histogram[2] == 2);
+    CHECK(histogram[12] == 1);
+    CHECK(histogram[DeadlineProfiler::kNumBins - 1] == 2);
+    CHECK(profiler.getOverrunCount() == 3);
+    CHECK(profiler.getWorstLoad() == Catch::Approx(3.0f));
+
+    DeadlineOverrun overrun;
+    REQUIRE(profiler.tryPopOverrun(overrun));
+    CHECK(overrun.block_index == 2);
+    CHECK(overrun.num_frames == frames);
+    CHECK(overrun.num_events == 7);
+    CHECK(overrun.budget_ns == budget);
+    CHECK(overrun.load == Catch::Approx(1.2f));
+    REQUIRE(profiler.tryPopOverrun(overrun));
+    CHECK(overrun.block_index == 3);
+    REQUIRE(profiler.tryPopOverrun(overrun));
+    CHECK(overrun.block_index == 4);
+    CHECK_FALSE(profiler.tryPopOverrun(overrun));
+    CHECK(profiler.getDroppedOverrunCount() == 0);
+
+    profiler.resetCounts();
+    CHECK(profiler.getOverrunCount() == 0);
+    CHECK(profiler.getWorstLoad() == 0.0f);
+    CHECK(profiler.getHistogram()[2] == 0);
+}
@@ -0,0 +1,173 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/EventRouter.h>
+#include <applause/core/PluginBase.h>
+
+#include <utility>
+#include <vector>
+
+using namespace applause;
+
+namespace {
+
+// A host event list that counts how often the plugin reads it
+struct HostEvents {
+    std::vector<clap_event_note_t> events;
+    mutable uint32_t gets = 0;
+    clap_input_events_t in{};
+
+    HostEvents& add(uint16_t type, uint32_t time, int16_t key = 60) {
+        clap_event_note_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, type, 0};
+        e.key = key;
+        events.push_back(e);
+        return *this;
+    }
+
+    const clap_input_events_t* get() {
+        in.ctx = this;
+        in.size = [](const clap_input_events_t* list) {
+            return static_cast<uint32_t>(static_cast<HostEvents*>(list->ctx)->events.size());
+        };
+        in.get = [](const clap_input_events_t* list, uint32_t index) -> const clap_event_header_t* {
+            auto* self = static_cast<HostEvents*>(list->ctx);
+            ++self->gets;
+            return &self->events[index].header;
+        };
+        return &in;
+    }
+};
+
+struct Recorder {
+    std::vector<std::pair<uint16_t, uint32_t>> seen;  // (type, time)
+    void onEvent(const clap_event_header_t& event) noexcept { seen.emplace_back(event.type, event.time); }
+};
+
+}  // namespace
+
+TEST_CASE("EventRouter fetches each event from the host once", "[core][events]") {
+    HostEvents host;
+    host.add(CLAP_EVENT_NOTE_ON, 0).add(CLAP_EVENT_NOTE_ON, 8).add(CLAP_EVENT_NOTE_OFF, 16);
+    EventRouter router;
+    router.begin(host.get());
+    CHECK(host.gets == 3);
+
+    const clap_input_events_t* list = router.inputEvents();
+    CHECK(EventRouter::fromInputEvents(list) == &router);
+    CHECK(EventRouter::fromInputEvents(host.get()) == nullptr);
+    for (int pass = 0; pass < 2; ++pass) {
+        REQUIRE(list->size(list) == 3);
+        for (uint32_t i = 0; i < 3; ++i) CHECK(list->get(list, i) == &host.events[i].header);
+        CHECK(list->get(list, 3) == nullptr);
+    }
+    CHECK(host.gets == 3);
+
+    CHECK(router.hasType(CLAP_EVENT_NOTE_ON));
+    CHECK(router.hasType(CLAP_EVENT_NOTE_OFF));
+    CHECK_FALSE(router.hasType(CLAP_EVENT_PARAM_VALUE));
+
+    router.end();
+    CHECK(router.size() == 0);
+}
+
+TEST_CASE("EventRouter sorts out-of-order events stably", "[core][events]") {
+    HostEvents host;
+    host.add(CLAP_EVENT_NOTE_ON, 10, 1)
+        .add(CLAP_EVENT_NOTE_ON, 2, 2)
+        .add(CLAP_EVENT_NOTE_ON, 10, 3)
+        .add(CLAP_EVENT_NOTE_ON, 2, 4);
+    EventRouter router;
+    router.begin(host.get());
+    std::vector<int16_t> keys;
+    for (uint32_t i = 0; i < router.size(); ++i) {
+        keys.push_back(reinterpret_cast<const clap_event_note_t*>(router.get(i))->key);
+    }
+    CHECK(keys == std::vector<int16_t>{2, 4, 1, 3});
+}
+
+TEST_CASE("EventRouter dispatches by type and splits sub-blocks at event times", "[core][events]") {
+    HostEvents host;
+    host.add(CLAP_EVENT_NOTE_ON, 0)
+        .add(CLAP_EVENT_PARAM_VALUE, 0)
+        .add(CLAP_EVENT_NOTE_ON, 20)
+        .add(CLAP_EVENT_NOTE_OFF, 21)
+        .add(CLAP_EVENT_NOTE_OFF, 40)
+        .add(CLAP_EVENT_NOTE_ON, 70);  // Past the block: applied in the last sub-block
+    EventRouter router;
+    Recorder notes;
+    Recorder offs;
+    router.addHandler<&Recorder::onEvent>(CLAP_EVENT_NOTE_ON, notes);
+    router.addHandler<&Recorder::onEvent>(CLAP_EVENT_NOTE_OFF, notes);
+    router.addHandler<&Recorder::onEvent>(CLAP_EVENT_NOTE_OFF, offs);
+
+    SECTION("Sample-accurate") {
+        router.begin(host.get());
+        std::vector<std::pair<uint32_t, uint32_t>> blocks;
+        std::vector<size_t> dispatched_before;
+        router.forEachSubBlock(64, [&](uint32_t start, uint32_t count) {
+            blocks.emplace_back(start, count);
+            dispatched_before.push_back(notes.seen.size());
+        });
+        CHECK(blocks == std::vector<std::pair<uint32_t, uint32_t>>{{0, 20}, {20, 1}, {21, 19}, {40, 24}});
+        CHECK(dispatched_before == std::vector<size_t>{1, 2, 3, 4});
+        CHECK(notes.seen.size() == 5);  // Everything but the parameter event
+        CHECK(notes.seen.back() == std::pair<uint16_t, uint32_t>{CLAP_EVENT_NOTE_ON, 70});
+        CHECK(offs.seen.size() == 2);
+    }
+
+    SECTION("Minimum sub-block size") {
+        router.begin(host.get());
+        std::vector<std::pair<uint32_t, uint32_t>> blocks;
+        router.forEachSubBlock(
+            64, [&](uint32_t start, uint32_t count) { blocks.emplace_back(start, count); }, 16);
+        CHECK(blocks == std::vector<std::pair<uint32_t, uint32_t>>{{0, 20}, {20, 20}, {40, 24}});
+        CHECK(notes.seen.size() == 5);
+    }
+
+    SECTION("Removed handlers no longer run") {
+        router.removeHandlers(&notes);
+        router.begin(host.get());
+        router.dispatchAll();
+        CHECK(notes.seen.empty());
+        CHECK(offs.seen.size() == 2);
+    }
+}
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+const clap_host_t kHost{};
+
+struct CountingPlugin : PluginBase {
+    Recorder notes;
+    uint32_t events_seen = 0;
+
+    CountingPlugin() : PluginBase(&kDesc, &kHost) {
+        getEventRouter().addHandler<&Recorder::onEvent>(CLAP_EVENT_NOTE_ON, notes);
+    }
+    ProcessStatus process(ProcessContext& context) noexcept override {
+        const clap_input_events_t* in = context.inputEvents();
+        events_seen = in->size(in);
+        context.eventRouter()->dispatchAll();
+        return ProcessStatus::Continue;
+    }
+};
+}  // namespace
+
+TEST_CASE("PluginBase routes each block's events through its EventRouter", "[core][events]") {
+    CountingPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    REQUIRE(clap->activate(clap, 48000.0, 1, 64));
+
+    HostEvents host;
+    host.add(CLAP_EVENT_NOTE_ON, 0).add(CLAP_EVENT_NOTE_OFF, 4);
+    clap_process_t process{};
+    process.frames_count = 64;
+    process.in_events = host.get();
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.events_seen == 2);
+    CHECK(plugin.notes.seen.size() == 1);
+    CHECK(host.gets == 2);
+    CHECK(plugin.getEventRouter().size() == 0);  // Forgotten once process() returns
+    clap->deactivate(clap);
+}
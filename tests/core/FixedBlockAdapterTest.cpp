@@ -0,0 +1,221 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/AudioPortsExtension.h>
+#include <applause/extensions/LatencyExtension.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+clap_host_t makeHost() {
+    clap_host_t host{};
+    host.get_extension = [](const clap_host_t*, const char*) -> const void* { return nullptr; };
+    return host;
+}
+const clap_host_t kHost = makeHost();
+
+clap_event_param_value_t paramEvent(uint32_t time, double value) {
+    clap_event_param_value_t event{};
+    event.header = {.size = sizeof(event), .time = time, .space_id = CLAP_CORE_EVENT_SPACE_ID,
+                    .type = CLAP_EVENT_PARAM_VALUE, .flags = 0};
+    event.value = value;
+    return event;
+}
+
+struct InputEvents {
+    std::vector<clap_event_param_value_t> events;
+    clap_input_events_t list{.ctx = this,
+                             .size = [](const clap_input_events_t* l) {
+                                 return static_cast<uint32_t>(static_cast<InputEvents*>(l->ctx)->events.size());
+                             },
+                             .get = [](const clap_input_events_t* l, uint32_t i) -> const clap_event_header_t* {
+                                 return &static_cast<InputEvents*>(l->ctx)->events[i].header;
+                             }};
+};
+
+struct OutputEvents {
+    std::vector<uint32_t> times;
+    clap_output_events_t list{.ctx = this, .try_push = [](const clap_output_events_t* l, const clap_event_header_t* e) {
+                                  static_cast<OutputEvents*>(l->ctx)->times.push_back(e->time);
+                                  return true;
+                              }};
+};
+
+// Doubles a mono input, and records what each block looked like
+struct BlockPlugin : PluginBase {
+    AudioPortsExtension ports;
+    LatencyExtension latency;
+
+    struct Block {
+        uint32_t frames;
+        int64_t steady_time;
+        std::vector<uint32_t> event_times;
+        std::vector<double> event_values;
+    };
+    std::vector<Block> blocks;
+    ProcessInfo info{};
+
+    BlockPlugin(uint32_t block_size, FixedBlockMode mode) : PluginBase(&kDesc, &kHost) {
+        ports.addInput(AudioPortConfig::mainMono("In")).addOutput(AudioPortConfig::mainMono("Out"));
+        registerExtension(ports);
+        registerExtension(latency);
+        setFixedBlockSize(block_size, mode);
+    }
+
+    bool activate(const ProcessInfo& process_info) override {
+        info = process_info;
+        return true;
+    }
+
+    ProcessStatus process(ProcessContext& context) noexcept override {
+        Block block{context.numFrames(), context.steadyTime(), {}, {}};
+        const auto* in = context.inputEvents();
+        for (uint32_t i = 0; i < in->size(in); ++i) {
+            const auto* event = reinterpret_cast<const clap_event_param_value_t*>(in->get(in, i));
+            block.event_times.push_back(event->header.time);
+            block.event_values.push_back(event->value);
+        }
+        blocks.push_back(block);
+
+        const auto input = context.input<float, 1>();
+        auto output = context.output<float, 1>();
+        for (uint32_t i = 0; i < context.numFrames(); ++i) {
+            output.channelSamples(0)[i] = 2.0f * input.channelSamples(0)[i];
+        }
+
+        // One output event a few frames into every block
+        const auto note_end = paramEvent(3, 0.0);
+        context.outputEvents()->try_push(context.outputEvents(), &note_end.header);
+        return ProcessStatus::Continue;
+    }
+};
+
+// Runs one host block of the given size through the plugin, taking input from source at position
+struct HostBlock {
+    std::vector<float> in;
+    std::vector<float> out;
+    InputEvents events;
+    OutputEvents out_events;
+
+    clap_process_status run(const clap_plugin_t* clap, const std::vector<float>& source, size_t position,
+                            uint32_t frames, int64_t steady_time) {
+        in.assign(source.begin() + static_cast<std::ptrdiff_t>(position),
+                  source.begin() + static_cast<std::ptrdiff_t>(position + frames));
+        out.assign(frames, -1.0f);
+        float* in_ptr = in.data();
+        float* out_ptr = out.data();
+        clap_audio_buffer_t input{
+            .data32 = &in_ptr, .data64 = nullptr, .channel_count = 1, .latency = 0, .constant_mask = 0};
+        clap_audio_buffer_t output{
+            .data32 = &out_ptr, .data64 = nullptr, .channel_count = 1, .latency = 0, .constant_mask = 0};
+        clap_process_t process{};
+        process.frames_count = frames;
+        process.steady_time = steady_time;
+        process.audio_inputs = &input;
+        process.audio_inputs_count = 1;
+        process.audio_outputs = &output;
+        process.audio_outputs_count = 1;
+        process.in_events = &events.list;
+        process.out_events = &out_events.list;
+        return clap->process(clap, &process);
+    }
+};
+
+std::vector<float> ramp(size_t frames) {
+    std::vector<float> values(frames);
+    for (size_t i = 0; i < frames; ++i) values[i] = static_cast<float>(i + 1);
+    return values;
+}
+}  // namespace
+
+TEST_CASE("Fixed blocks without latency end each host block with a shorter one", "[core][plugin][blocks]") {
+    BlockPlugin plugin{64, FixedBlockMode::VariableTail};
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    REQUIRE(clap->activate(clap, 48000.0, 1, 512));
+    CHECK(plugin.info.max_frame_size == 64);
+    CHECK(plugin.latency.getLatency() == 0);
+
+    const auto source = ramp(150);
+    HostBlock host;
+    host.events.events = {paramEvent(0, 1.0), paramEvent(70, 2.0), paramEvent(149, 3.0)};
+    REQUIRE(host.run(clap, source, 0, 150, 1000) == CLAP_PROCESS_CONTINUE);
+
+    REQUIRE(plugin.blocks.size() == 3);
+    CHECK(plugin.blocks[0].frames == 64);
+    CHECK(plugin.blocks[1].frames == 64);
+    CHECK(plugin.blocks[2].frames == 22);
+    CHECK(plugin.blocks[1].steady_time == 1064);
+    CHECK(plugin.blocks[0].event_times == std::vector<uint32_t>{0});
+    CHECK(plugin.blocks[1].event_times == std::vector<uint32_t>{6});
+    CHECK(plugin.blocks[2].event_times == std::vector<uint32_t>{21});
+    CHECK(plugin.blocks[2].event_values == std::vector<double>{3.0});
+    for (uint32_t i = 0; i < 150; ++i) REQUIRE(host.out[i] == 2.0f * source[i]);
+    CHECK(host.out_events.times == std::vector<uint32_t>{3, 67, 131});
+
+    // A host call with no frames still delivers its events
+    plugin.blocks.clear();
+    host.events.events = {paramEvent(0, 4.0)};
+    REQUIRE(host.run(clap, source, 0, 0, 1150) == CLAP_PROCESS_CONTINUE);
+    REQUIRE(plugin.blocks.size() == 1);
+    CHECK(plugin.blocks[0].frames == 0);
+    CHECK(plugin.blocks[0].event_values == std::vector<double>{4.0});
+    clap->deactivate(clap);
+}
+
+TEST_CASE("Fixed blocks with latency are always full and delay the output by one block", "[core][plugin][blocks]") {
+    BlockPlugin plugin{32, FixedBlockMode::Latency};
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    REQUIRE(clap->activate(clap, 48000.0, 1, 256));
+    CHECK(plugin.info.min_frame_size == 32);
+    CHECK(plugin.info.max_frame_size == 32);
+    CHECK(plugin.latency.getLatency() == 32);
+    plugin.latency.setLatency(5);
+    CHECK(plugin.latency.getLatency() == 37);
+
+    const auto source = ramp(128);
+    std::vector<float> output;
+    size_t position = 0;
+    HostBlock host;
+    for (const uint32_t frames : {10u, 50u, 7u, 61u}) {
+        host.events.events.clear();
+        // An event at the host block's second frame, tagged with its position in the stream
+        if (frames > 1) host.events.events.push_back(paramEvent(1, static_cast<double>(position + 1)));
+        REQUIRE(host.run(clap, source, position, frames, static_cast<int64_t>(position)) == CLAP_PROCESS_CONTINUE);
+        output.insert(output.end(), host.out.begin(), host.out.end());
+        position += frames;
+    }
+
+    REQUIRE(plugin.blocks.size() == 4);
+    for (size_t b = 0; b < plugin.blocks.size(); ++b) {
+        const auto& block = plugin.blocks[b];
+        CHECK(block.frames == 32);
+        CHECK(block.steady_time == static_cast<int64_t>(32 * b));
+        // Every event arrives in the block holding its stream position, at its offset there
+        for (size_t e = 0; e < block.event_times.size(); ++e) {
+            CHECK(static_cast<double>(32 * b + block.event_times[e]) == block.event_values[e]);
+        }
+    }
+    CHECK(plugin.blocks[0].event_values == std::vector<double>{1.0, 11.0});
+    CHECK(plugin.blocks[1].event_values == std::vector<double>{61.0});
+    CHECK(plugin.blocks[2].event_values == std::vector<double>{68.0});
+
+    // One block of silence, then the processed input
+    for (size_t i = 0; i < 32; ++i) REQUIRE(output[i] == 0.0f);
+    for (size_t i = 32; i < 128; ++i) REQUIRE(output[i] == 2.0f * source[i - 32]);
+
+    // reset() drops what's buffered
+    clap->reset(clap);
+    plugin.blocks.clear();
+    host.events.events.clear();
+    REQUIRE(host.run(clap, source, 0, 40, 0) == CLAP_PROCESS_CONTINUE);
+    REQUIRE(plugin.blocks.size() == 1);
+    for (size_t i = 0; i < 32; ++i) REQUIRE(host.out[i] == 0.0f);
+    CHECK(host.out[32] == 2.0f * source[0]);
+    clap->deactivate(clap);
+}
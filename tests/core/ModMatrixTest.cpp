@@ -1,11 +1,18 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <applause/core/ModMatrix.h>
+#include <applause/core/StaticModMatrix.h>
 #include <applause/extensions/ParamsExtension.h>
+#include <applause/extensions/ThreadPoolExtension.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <cmath>
+#include <memory>
 #include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
 using namespace applause;
@@ -39,6 +46,7 @@ public:
         uint16_t depth_slot;
         bool is_depth_mod;
         bool bipolar_mapping;
+        ModReduction reduction = ModReduction::Max;
     };
 
     std::vector<Source> sources;
@@ -189,7 +197,17 @@ public:
                     poly_out[v][conn.target] += src_val * poly_depth[v][conn.depth_slot];
                 }
             }
-            // poly src -> mono dst: NYI in ModMatrix, so oracle leaves it out too.
+            else if (!src_mono && dst_mono && !active_voices.empty()) {
+                float reduced = conn.reduction == ModReduction::Max ? -INFINITY : 0.0f;
+                for (uint16_t v : active_voices) {
+                    const float x = poly_src_values[v][conn.src_idx];
+                    reduced = conn.reduction == ModReduction::Max ? std::max(reduced, x) : reduced + x;
+                }
+                if (conn.reduction == ModReduction::Mean) reduced /= static_cast<float>(active_voices.size());
+                if (conn.reduction == ModReduction::LastVoice) reduced = poly_src_values[active_voices.back()][conn.src_idx];
+                reduced = applyBipolarNormalization(reduced, src_bipolar, conn.bipolar_mapping);
+                mono_out[conn.target] += reduced * mono_depth[conn.depth_slot];
+            }
         }
 
         for (size_t d = 0; d < destinations.size(); ++d) {
@@ -350,6 +368,17 @@ TEST_CASE("C1: With no connections, output equals base plain value after scaling
         REQUIRE(matrix.getPolyModValue(dst.index, 2) == Catch::Approx(75.0f));
     }
 
+    SECTION("Unwritten base reads back the range's minimum") {
+        applause::ValueScaleInfo scale{20.0f, 20000.0f, applause::ValueScaling::linear()};
+        auto& mono = matrix.registerDestination("mono", ModDstMode::Mono, scale);
+        auto& poly = matrix.registerDestination("poly", ModDstMode::Poly, scale);
+        matrix.notifyVoiceOn(1);
+        matrix.process();
+
+        REQUIRE(matrix.getModValue(mono.index) == Catch::Approx(20.0f));
+        REQUIRE(matrix.getPolyModValue(poly.index, 1) == Catch::Approx(20.0f));
+    }
+
     SECTION("Identity scaling (0..1)") {
         auto& dst = matrix.registerDestination("dst", ModDstMode::Mono);
         matrix.setBaseValue(dst.index, 0.5f);
@@ -390,9 +419,8 @@ TEST_CASE("C2: Clamping behavior - normalized outside [0,1] clamps to min/max",
 
 TEST_CASE("C4: loadParamBaseValues with extra destinations", "[modmatrix][scaling]")
 {
-    // TODO: loadParamBaseValues() loops to dst_count_, which exceeds the param count when
-    // extra destinations are registered after registerFromParamsExtension(). Should track
-    // num_param_dests_ separately. This test pins the current safe-with-N-params behavior.
+    // loadParamBaseValues() only touches the destinations registered from the params extension;
+    // extra destinations registered afterwards keep their own base value.
 
     ModMatrix matrix(SmallConfig);
 
@@ -419,13 +447,50 @@ TEST_CASE("C4: loadParamBaseValues with extra destinations", "[modmatrix][scalin
     params.registerParam(config2);
 
     matrix.registerFromParamsExtension(params);
-    matrix.registerDestination("extra", ModDstMode::Mono);
+    auto& extra = matrix.registerDestination("extra", ModDstMode::Mono);
+    matrix.setBaseValue(extra.index, 0.25f);
 
     matrix.loadParamBaseValues(params);
     matrix.process();
 
     REQUIRE(matrix.getModValue(0) == Catch::Approx(0.5f));
     REQUIRE(matrix.getModValue(1) == Catch::Approx(50.0f));
+    REQUIRE(matrix.getModValue(extra.index) == Catch::Approx(0.25f));
+}
+
+TEST_CASE("C5: Unmodulated destinations pass their plain base value through", "[modmatrix][scaling]")
+{
+    ModMatrix matrix(SmallConfig);
+    const applause::ValueScaleInfo freq{20.0f, 20000.0f, applause::ValueScaling::frequency(20.0f, 20000.0f)};
+
+    auto& src = matrix.registerSource("src", ModSrcType::Mono, false);
+    auto& mono_dst = matrix.registerDestination("cutoff", ModDstMode::Mono, freq);
+    auto& poly_dst = matrix.registerDestination("poly_cutoff", ModDstMode::Poly, freq);
+    matrix.setBaseValue(mono_dst.index, 440.0f);
+    matrix.setBaseValue(poly_dst.index, 880.0f);
+    matrix.notifyVoiceOn(1);
+
+    // No normalize/denormalize round trip, so the value is exact
+    matrix.process();
+    REQUIRE(matrix.getModValue(mono_dst.index) == 440.0f);
+    REQUIRE(matrix.getPolyModValue(poly_dst.index, 1) == 880.0f);
+
+    SECTION("Out-of-range base values are clamped") {
+        matrix.setBaseValue(mono_dst.index, 50000.0f);
+        matrix.process();
+        REQUIRE(matrix.getModValue(mono_dst.index) == 20000.0f);
+    }
+
+    SECTION("Removing the last connection restores pass-through") {
+        matrix.setMonoSourceValue(src.index, 1.0f);
+        auto conn = matrix.addConnection(src, mono_dst, 0.25f, false);
+        matrix.process();
+        REQUIRE(matrix.getModValue(mono_dst.index) > 440.0f);
+
+        matrix.removeConnection(conn);
+        matrix.process();
+        REQUIRE(matrix.getModValue(mono_dst.index) == 440.0f);
+    }
 }
 
 TEST_CASE("D1: Mono source values propagate through MM connections", "[modmatrix][sources]")
@@ -980,23 +1045,92 @@ TEST_CASE("I2: Handle points to correct per-voice value for poly dest", "[modmat
     REQUIRE(handle2.getValue() == Catch::Approx(0.7f));
 }
 
-TEST_CASE("J1: Poly->Mono connections are compiled but have no effect (NYI)", "[modmatrix][nyi]")
+TEST_CASE("J1: Poly->Mono connections reduce across active voices", "[modmatrix][reduction]")
 {
-    ModMatrix matrix(SmallConfig);
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
 
-    auto& poly_src = matrix.registerSource("poly_src", ModSrcType::Poly, false);
-    auto& mono_dst = matrix.registerDestination("mono_dst", ModDstMode::Mono);
+        auto& poly_src = matrix.registerSource("poly_src", ModSrcType::Poly, false);
+        auto& mono_dst = matrix.registerDestination("mono_dst", ModDstMode::Mono);
 
-    matrix.addConnection(poly_src, mono_dst, 1.0f, false);
-    matrix.setBaseValue(mono_dst.index, 0.5f);
+        auto conn = matrix.addConnection(poly_src, mono_dst, 0.5f, false);
+        matrix.setBaseValue(mono_dst.index, 0.0f);
 
-    matrix.notifyVoiceOn(0);
-    matrix.setPolySourceValue(poly_src.index, 0, 1.0f);
+        matrix.setPolySourceValue(poly_src.index, 0, 0.9f);  // stale: voice 0 is never active
+        matrix.setPolySourceValue(poly_src.index, 1, 0.2f);
+        matrix.setPolySourceValue(poly_src.index, 2, 0.6f);
+        matrix.setPolySourceValue(poly_src.index, 3, 0.4f);
 
-    matrix.process();
+        SECTION("No active voices contribute nothing") {
+            matrix.process();
+            REQUIRE(matrix.getModValue(mono_dst.index) == Catch::Approx(0.0f));
+        }
+
+        matrix.notifyVoiceOn(3);
+        matrix.notifyVoiceOn(2);
+        matrix.notifyVoiceOn(1);
+
+        SECTION("Max (default)") {
+            matrix.process();
+            REQUIRE(matrix.getModValue(mono_dst.index) == Catch::Approx(0.6f * 0.5f));
+        }
+
+        SECTION("Sum") {
+            conn.setReduction(ModReduction::Sum);
+            matrix.process();
+            REQUIRE(matrix.getModValue(mono_dst.index) == Catch::Approx(1.2f * 0.5f));
+        }
+
+        SECTION("Mean") {
+            conn.setReduction(ModReduction::Mean);
+            matrix.process();
+            REQUIRE(matrix.getModValue(mono_dst.index) == Catch::Approx(0.4f * 0.5f));
+        }
+
+        SECTION("LastVoice follows trigger order") {
+            conn.setReduction(ModReduction::LastVoice);
+            matrix.process();
+            REQUIRE(matrix.getModValue(mono_dst.index) == Catch::Approx(0.2f * 0.5f));
+
+            matrix.notifyVoiceOff(1);
+            matrix.process();
+            REQUIRE(matrix.getModValue(mono_dst.index) == Catch::Approx(0.6f * 0.5f));
+        }
+    }
+}
+
+TEST_CASE("K1: Oracle verification for poly->mono reductions", "[modmatrix][oracle][reduction]")
+{
+    for (auto reduction : {ModReduction::Max, ModReduction::Sum, ModReduction::Mean, ModReduction::LastVoice}) {
+        ModMatrix matrix(SmallConfig);
+        ModMatrixOracle oracle(4, 8, 16);
+
+        auto& src = matrix.registerSource("env", ModSrcType::Poly, true);
+        auto& dst = matrix.registerDestination("send", ModDstMode::Mono);
+        oracle.addSource(false, false, true);
+        oracle.addDestination(true);
+
+        auto conn = matrix.addConnection(src, dst, 0.3f, true);
+        conn.setReduction(reduction);
+        oracle.addConnection(0, 0, 0.3f, true);
+        oracle.connections.back().reduction = reduction;
+
+        matrix.setBaseValue(dst.index, 0.5f);
+        oracle.setBaseValue(0, 0.5f);
 
-    // PM is compiled but its processing loop is a no-op, so the destination keeps its base value.
-    REQUIRE(matrix.getModValue(mono_dst.index) == Catch::Approx(0.5f));
+        for (uint16_t v : {2, 0, 3}) {
+            matrix.notifyVoiceOn(v);
+            oracle.active_voices.push_back(v);
+            matrix.setPolySourceValue(src.index, v, -0.8f + 0.5f * v);
+            oracle.setPolySource(0, v, -0.8f + 0.5f * v);
+        }
+
+        matrix.process();
+        auto [oracle_mono, oracle_poly] = oracle.process();
+        REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(oracle_mono[0]));
+    }
 }
 
 TEST_CASE("J2: Poly depth mod on MM slot is silently ignored", "[modmatrix][nyi]")
@@ -1435,6 +1569,47 @@ TEST_CASE("F11: reassignSource merge transfers the moving conn's depth mods onto
     REQUIRE(transferred->getDepth() == Catch::Approx(0.5f));
 }
 
+TEST_CASE("F11c: Removing a merge peer keeps lookups valid for connections ahead of it",
+          "[modmatrix][connections][reassign]")
+{
+    ModMatrix matrix(SmallConfig);
+
+    auto& s0 = matrix.registerSource("s0", ModSrcType::Mono);
+    auto& s1 = matrix.registerSource("s1", ModSrcType::Mono);
+    auto& depth_src = matrix.registerSource("depth", ModSrcType::Mono);
+    auto& d0 = matrix.registerDestination("d0", ModDstMode::Mono);
+    auto& d1 = matrix.registerDestination("d1", ModDstMode::Mono);
+
+    auto a = matrix.addConnection(s0, d0, 0.25f);
+    matrix.addDepthModulation(depth_src, a, 0.5f);
+    auto b = matrix.addConnection(s1, d0, 0.75f);
+    matrix.addConnection(s0, d1, 0.1f);
+    matrix.addConnection(s1, d1, 0.2f);
+
+    // A merges into B; A's depth mod now targets B but sits ahead of it in connections_
+    matrix.reassignSource(a, s1);
+    REQUIRE(matrix.removeConnection(b));
+    matrix.addConnection(depth_src, d0, 0.3f);
+
+    auto e = matrix.findConnection(s0.index, d1.index);
+    REQUIRE(e.has_value());
+    REQUIRE(e->src_idx == s0.index);
+    REQUIRE(e->dst_idx == d1.index);
+    REQUIRE(e->getDepth() == Catch::Approx(0.1f));
+
+    auto f = matrix.findConnection(s1.index, d1.index);
+    REQUIRE(f.has_value());
+    REQUIRE(f->getDepth() == Catch::Approx(0.2f));
+
+    for (const auto& c : matrix.getConnections()) {
+        if (c.isDepthMod()) continue;
+        auto by_slot = matrix.findConnection(c.depth_slot);
+        REQUIRE(by_slot.has_value());
+        REQUIRE(by_slot->src_idx == c.src_idx);
+        REQUIRE(by_slot->dst_idx == c.dst_idx);
+    }
+}
+
 TEST_CASE("F11b: reassignSource merge keeps peer's existing depth mod on conflict (peer wins)",
           "[modmatrix][connections][reassign]")
 {
@@ -1982,3 +2157,1341 @@ TEST_CASE("N6: Smart default integrates with getModOffsetRange",
         REQUIRE(max_off == Catch::Approx(0.0f));
     }
 }
+
+// ============================================================
+// L-series: VoiceLanes layout must match the VoiceRows reference
+// ============================================================
+
+TEST_CASE("L1: VoiceLanes layout matches VoiceRows on a randomized patch", "[modmatrix][layout]")
+{
+    // 13 voices: not a multiple of any SIMD width, so the padded tail lanes are exercised.
+    constexpr ModMatrix::Config rows_cfg{13, 16, 16, 64};
+    ModMatrix::Config lanes_cfg = rows_cfg;
+    lanes_cfg.voice_layout = ModVoiceLayout::VoiceLanes;
+
+    ModMatrix rows(rows_cfg);
+    ModMatrix lanes(lanes_cfg);
+    REQUIRE(lanes.getVoiceLayout() == ModVoiceLayout::VoiceLanes);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> depth(-1.0f, 1.0f);
+
+    const applause::ValueScaleInfo freq{20.0f, 20000.0f, applause::ValueScaling::frequency(20.0f, 20000.0f)};
+    const applause::ValueScaleInfo identity{0.0f, 1.0f, applause::ValueScaling::linear()};
+    for (ModMatrix* m : {&rows, &lanes}) {
+        for (int i = 0; i < 8; ++i) {
+            const auto type = (i % 2) ? ModSrcType::Poly : ModSrcType::Mono;
+            m->registerSource("src" + std::to_string(i), type, i % 3 == 0);
+        }
+        for (int i = 0; i < 8; ++i) {
+            const auto mode = (i < 2) ? ModDstMode::Mono : ModDstMode::Poly;
+            m->registerDestination("dst" + std::to_string(i), mode, (i % 2) ? freq : identity);
+        }
+    }
+
+    for (int n = 0; n < 24; ++n) {
+        const auto s = static_cast<uint16_t>(rng() % 8);
+        const auto d = static_cast<uint16_t>(rng() % 8);
+        const float dep = depth(rng);
+        const bool bip = rng() % 2;
+        auto rc = rows.addConnection(rows.getSource(s), rows.getDestination(d), dep, bip);
+        auto lc = lanes.addConnection(lanes.getSource(s), lanes.getDestination(d), dep, bip);
+        if (n % 3 == 0) {
+            const auto ds = static_cast<uint16_t>(rng() % 8);
+            const float ddep = depth(rng);
+            rows.addDepthModulation(rows.getSource(ds), rc, ddep, !bip);
+            lanes.addDepthModulation(lanes.getSource(ds), lc, ddep, !bip);
+        }
+    }
+
+    for (uint16_t d = 0; d < 8; ++d) {
+        const float base = (d % 2) ? 1000.0f : unit(rng);
+        rows.setBaseValue(d, base);
+        lanes.setBaseValue(d, base);
+    }
+
+    auto randomizeSources = [&] {
+        for (uint16_t s = 0; s < 8; ++s) {
+            const float mv = unit(rng);
+            rows.setMonoSourceValue(s, mv);
+            lanes.setMonoSourceValue(s, mv);
+            for (uint16_t v = 0; v < 13; ++v) {
+                const float pv = unit(rng);
+                rows.setPolySourceValue(s, v, pv);
+                lanes.setPolySourceValue(s, v, pv);
+            }
+        }
+    };
+
+    auto requireEqual = [&] {
+        for (uint16_t d = 0; d < 8; ++d) {
+            REQUIRE(lanes.getModValue(d) == Catch::Approx(rows.getModValue(d)).epsilon(1e-5));
+            for (uint16_t v = 0; v < 13; ++v) {
+                REQUIRE(lanes.getPolyModValue(d, v) == Catch::Approx(rows.getPolyModValue(d, v)).epsilon(1e-5));
+            }
+        }
+    };
+
+    for (uint16_t v : {0, 3, 4, 9, 12}) {
+        rows.notifyVoiceOn(v);
+        lanes.notifyVoiceOn(v);
+    }
+    randomizeSources();
+    rows.process();
+    lanes.process();
+    requireEqual();
+
+    // Inactive voices keep their last values under both layouts.
+    rows.notifyVoiceOff(4);
+    lanes.notifyVoiceOff(4);
+    randomizeSources();
+    rows.process();
+    lanes.process();
+    requireEqual();
+}
+
+// ============================================================
+// R-series: ramp_outputs start/end values
+// ============================================================
+
+TEST_CASE("R1: Without ramp_outputs, start value equals end value", "[modmatrix][ramp]")
+{
+    ModMatrix matrix(SmallConfig);
+    auto& src = matrix.registerSource("src", ModSrcType::Mono, false);
+    auto& dst = matrix.registerDestination("dst", ModDstMode::Mono);
+    matrix.addConnection(src, dst, 1.0f, false);
+
+    auto handle = matrix.getModHandle(dst.index);
+    matrix.setMonoSourceValue(src.index, 0.25f);
+    matrix.process();
+    matrix.setMonoSourceValue(src.index, 0.75f);
+    matrix.process();
+
+    REQUIRE(handle.getStartValue() == Catch::Approx(0.75f));
+    REQUIRE(handle.getValue() == Catch::Approx(0.75f));
+    REQUIRE(handle.getIncrement(64) == Catch::Approx(0.0f));
+}
+
+TEST_CASE("R2: Mono ramp spans previous block's value to the current one", "[modmatrix][ramp]")
+{
+    ModMatrix::Config cfg = SmallConfig;
+    cfg.ramp_outputs = true;
+    ModMatrix matrix(cfg);
+    auto& src = matrix.registerSource("src", ModSrcType::Mono, false);
+    auto& dst = matrix.registerDestination("dst", ModDstMode::Mono);
+    matrix.setBaseValue(dst.index, 0.0f);
+    matrix.addConnection(src, dst, 1.0f, false);
+
+    auto handle = matrix.getModHandle(dst.index);
+
+    SECTION("First block does not ramp from zero") {
+        matrix.setMonoSourceValue(src.index, 0.5f);
+        matrix.process();
+        REQUIRE(handle.getStartValue() == Catch::Approx(0.5f));
+        REQUIRE(handle.getValue() == Catch::Approx(0.5f));
+    }
+
+    SECTION("Subsequent blocks interpolate") {
+        matrix.setMonoSourceValue(src.index, 0.2f);
+        matrix.process();
+        matrix.setMonoSourceValue(src.index, 0.6f);
+        matrix.process();
+
+        REQUIRE(handle.getStartValue() == Catch::Approx(0.2f));
+        REQUIRE(handle.getValue() == Catch::Approx(0.6f));
+        REQUIRE(handle.getValueAt(0.5f) == Catch::Approx(0.4f));
+        REQUIRE(handle.getIncrement(4) == Catch::Approx(0.1f));
+
+        std::vector<float> ramp(4);
+        handle.fillRamp(ramp);
+        REQUIRE(ramp[0] == Catch::Approx(0.3f));
+        REQUIRE(ramp[3] == Catch::Approx(0.6f));
+    }
+}
+
+TEST_CASE("R3: Poly ramp snaps on voice start and ramps afterwards", "[modmatrix][ramp]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.ramp_outputs = true;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
+        auto& src = matrix.registerSource("src", ModSrcType::Poly, false);
+        auto& dst = matrix.registerDestination("dst", ModDstMode::Poly);
+        matrix.setBaseValue(dst.index, 0.0f);
+        matrix.addConnection(src, dst, 1.0f, false);
+
+        auto handle = matrix.getModHandle(dst.index, 1);
+
+        // Voice 1 plays a note which leaves a stale value behind.
+        matrix.notifyVoiceOn(1);
+        matrix.setPolySourceValue(src.index, 1, 0.9f);
+        matrix.process();
+        matrix.notifyVoiceOff(1);
+        matrix.process();
+
+        // A new note on voice 1 must not glide from the old note's value.
+        matrix.notifyVoiceOn(1);
+        matrix.setPolySourceValue(src.index, 1, 0.1f);
+        matrix.process();
+        REQUIRE(handle.getStartValue() == Catch::Approx(0.1f));
+        REQUIRE(handle.getValue() == Catch::Approx(0.1f));
+
+        matrix.setPolySourceValue(src.index, 1, 0.3f);
+        matrix.process();
+        REQUIRE(handle.getStartValue() == Catch::Approx(0.1f));
+        REQUIRE(handle.getValue() == Catch::Approx(0.3f));
+    }
+}
+
+// ============================================================
+// P-series: program publishing between editing and audio threads
+// ============================================================
+
+TEST_CASE("P1: Edits are visible to the next process() call", "[modmatrix][publish]")
+{
+    ModMatrix matrix(SmallConfig);
+    auto& src = matrix.registerSource("src", ModSrcType::Mono, false);
+    auto& dst = matrix.registerDestination("dst", ModDstMode::Mono);
+    matrix.setBaseValue(dst.index, 0.0f);
+    matrix.setMonoSourceValue(src.index, 1.0f);
+
+    auto conn = matrix.addConnection(src, dst, 0.5f, false);
+    matrix.process();
+    REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(0.5f));
+
+    // Several edits between blocks: only the latest state is observed.
+    conn.setDepth(0.1f);
+    conn.setDepth(0.2f);
+    conn.setDepth(0.3f);
+    matrix.process();
+    REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(0.3f));
+
+    // No edits: the audio thread keeps using the same snapshot.
+    matrix.process();
+    REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(0.3f));
+
+    matrix.removeConnection(conn);
+    matrix.process();
+    REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(0.0f));
+}
+
+TEST_CASE("P2: Concurrent edits never expose a partially rebuilt program", "[modmatrix][publish]")
+{
+    ModMatrix matrix(SmallConfig);
+    applause::ValueScaleInfo identity{0.0f, 1.0f, applause::ValueScaling::linear()};
+    auto& a = matrix.registerSource("a", ModSrcType::Mono, false);
+    auto& b = matrix.registerSource("b", ModSrcType::Mono, false);
+    auto& dst = matrix.registerDestination("dst", ModDstMode::Mono, identity);
+    matrix.setBaseValue(dst.index, 0.0f);
+    matrix.setMonoSourceValue(a.index, 1.0f);
+    matrix.setMonoSourceValue(b.index, 1.0f);
+
+    // The editor adds a:0.25, adds b:0.5, removes a, removes b. Each step is a whole program, so the output is
+    // always one of 0, 0.25, 0.75 or 0.5 -- anything else means a torn program.
+    std::atomic<bool> done{false};
+    std::thread editor([&] {
+        for (int i = 0; i < 2000; ++i) {
+            matrix.addConnection(a, dst, 0.25f, false);
+            matrix.addConnection(b, dst, 0.5f, false);
+            matrix.removeConnection(a.index, dst.index);
+            matrix.removeConnection(b.index, dst.index);
+        }
+        done = true;
+    });
+
+    bool ok = true;
+    while (!done) {
+        matrix.process();
+        const float v = matrix.getModValue(dst.index);
+        ok &= (v == Catch::Approx(0.0f) || v == Catch::Approx(0.25f) || v == Catch::Approx(0.75f) ||
+               v == Catch::Approx(0.5f));
+    }
+    editor.join();
+    REQUIRE(ok);
+}
+
+// ============================================================
+// S-series: incremental program edits and change-sets
+// ============================================================
+
+TEST_CASE("S1: Change-sets describe each edit", "[modmatrix][changes]")
+{
+    ModMatrix matrix(SmallConfig);
+    auto& src = matrix.registerSource("src", ModSrcType::Mono, false);
+    auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+    auto& dst = matrix.registerDestination("dst", ModDstMode::Mono);
+
+    std::vector<ModConnectionChange> seen;
+    int topology_changes = 0;
+    rocket::scoped_connection c1 = matrix.on_connections_edited.connect(
+        [&](std::span<const ModConnectionChange> changes) { seen.assign(changes.begin(), changes.end()); });
+    rocket::scoped_connection c2 = matrix.on_connections_changed.connect([&] { topology_changes++; });
+
+    auto conn = matrix.addConnection(src, dst, 0.5f, false);
+    REQUIRE(seen.size() == 1);
+    REQUIRE(seen[0].kind == ModConnectionChange::Kind::Added);
+    REQUIRE(seen[0].depth_slot == conn.depth_slot);
+    REQUIRE(topology_changes == 1);
+
+    auto dm = matrix.addDepthModulation(lfo, conn, 0.25f, false);
+    REQUIRE(topology_changes == 2);
+
+    SECTION("Depth edits do not fire on_connections_changed") {
+        conn.setDepth(0.75f);
+        REQUIRE(seen.size() == 1);
+        REQUIRE(seen[0].kind == ModConnectionChange::Kind::DepthChanged);
+        REQUIRE(seen[0].dst_idx == dst.index);
+        REQUIRE(!seen[0].is_depth_mod);
+
+        conn.setBipolar(true);
+        REQUIRE(seen.size() == 1);
+        REQUIRE(seen[0].kind == ModConnectionChange::Kind::MappingChanged);
+        REQUIRE(topology_changes == 2);
+    }
+
+    SECTION("Cascade removal reports every removed connection") {
+        matrix.removeConnection(conn);
+        REQUIRE(seen.size() == 2);
+        REQUIRE(seen[0].kind == ModConnectionChange::Kind::Removed);
+        REQUIRE(seen[1].kind == ModConnectionChange::Kind::Removed);
+        REQUIRE(seen[1].depth_slot == dm.depth_slot);
+        REQUIRE(seen[1].is_depth_mod);
+        REQUIRE(topology_changes == 3);
+    }
+}
+
+TEST_CASE("S2: Incrementally patched program matches a fresh build", "[modmatrix][changes]")
+{
+    const applause::ValueScaleInfo identity{0.0f, 1.0f, applause::ValueScaling::linear()};
+    auto setup = [&](ModMatrix& m) {
+        m.registerSource("m0", ModSrcType::Mono, false);
+        m.registerSource("p0", ModSrcType::Poly, true);
+        m.registerSource("b0", ModSrcType::Both, false);
+        m.registerSource("m1", ModSrcType::Mono, true);
+        m.registerDestination("dm", ModDstMode::Mono, identity);
+        m.registerDestination("dp", ModDstMode::Poly, identity);
+        m.registerDestination("dp2", ModDstMode::Poly, identity);
+        for (uint16_t d = 0; d < 3; ++d) m.setBaseValue(d, 0.5f);
+    };
+
+    ModMatrix edited(SmallConfig);
+    setup(edited);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> depth(-1.0f, 1.0f);
+    for (int step = 0; step < 200; ++step) {
+        const auto s = static_cast<uint16_t>(rng() % 4);
+        const auto d = static_cast<uint16_t>(rng() % 3);
+        const auto& conns = edited.getConnections();
+        switch (rng() % 6) {
+            case 0:
+            case 1: edited.addConnection(edited.getSource(s), edited.getDestination(d), depth(rng), rng() % 2); break;
+            case 2:
+                if (!conns.empty()) edited.removeConnection(ModConnection(conns[rng() % conns.size()]));
+                break;
+            case 3:
+                if (!conns.empty()) ModConnection(conns[rng() % conns.size()]).setBipolar(rng() % 2);
+                break;
+            case 4:
+                if (!conns.empty()) edited.reassignSource(ModConnection(conns[rng() % conns.size()]), edited.getSource(s));
+                break;
+            case 5:
+                if (auto c = edited.findConnection(s, d); c && edited.getConnections().size() < 12) {
+                    edited.addDepthModulation(edited.getSource(static_cast<uint16_t>(rng() % 4)), *c, depth(rng),
+                                              rng() % 2);
+                }
+                break;
+        }
+    }
+
+    // Rebuild the same graph from scratch, in the same connection order.
+    ModMatrix fresh(SmallConfig);
+    setup(fresh);
+    for (const auto& c : edited.getConnections()) {
+        if (c.isDepthMod()) continue;
+        fresh.addConnection(fresh.getSource(c.src_idx), fresh.getDestination(c.dst_idx), c.getDepth(), c.isBipolar());
+    }
+    for (const auto& c : edited.getConnections()) {
+        if (!c.isDepthMod()) continue;
+        const auto target = edited.findConnection(c.dst_idx);
+        REQUIRE(target.has_value());
+        auto fresh_target = fresh.findConnection(target->src_idx, target->dst_idx);
+        REQUIRE(fresh_target.has_value());
+        fresh.addDepthModulation(fresh.getSource(c.src_idx), *fresh_target, c.getDepth(), c.isBipolar());
+    }
+
+    for (ModMatrix* m : {&edited, &fresh}) {
+        for (uint16_t s = 0; s < 4; ++s) {
+            m->setMonoSourceValue(s, 0.1f * (s + 1));
+            for (uint16_t v = 0; v < 4; ++v) m->setPolySourceValue(s, v, 0.05f * (s + v + 1));
+        }
+        m->notifyVoiceOn(0);
+        m->notifyVoiceOn(3);
+        m->process();
+    }
+
+    for (uint16_t d = 0; d < 3; ++d) {
+        REQUIRE(edited.getModValue(d) == Catch::Approx(fresh.getModValue(d)));
+        for (uint16_t v : {0, 3}) {
+            REQUIRE(edited.getPolyModValue(d, v) == Catch::Approx(fresh.getPolyModValue(d, v)));
+        }
+    }
+}
+
+TEST_CASE("S3: Connection index agrees with a linear scan after random edits", "[modmatrix][changes]")
+{
+    ModMatrix matrix(StandardConfig);
+    for (int i = 0; i < 6; ++i) matrix.registerSource("s" + std::to_string(i), ModSrcType::Both, i % 2);
+    for (int i = 0; i < 6; ++i) matrix.registerDestination("d" + std::to_string(i), i % 2 ? ModDstMode::Poly : ModDstMode::Mono);
+
+    std::mt19937 rng(7);
+    for (int step = 0; step < 500; ++step) {
+        const auto s = static_cast<uint16_t>(rng() % 6);
+        const auto d = static_cast<uint16_t>(rng() % 6);
+        const auto conns = matrix.getConnections();
+        switch (rng() % 7) {
+            case 0:
+            case 1: matrix.addConnection(matrix.getSource(s), matrix.getDestination(d), 0.5f); break;
+            case 2:
+                if (!conns.empty()) matrix.removeConnection(conns[rng() % conns.size()]);
+                break;
+            case 3:
+                if (!conns.empty()) matrix.reassignSource(conns[rng() % conns.size()], matrix.getSource(s));
+                break;
+            case 4:
+                if (auto c = matrix.findConnection(s, d)) matrix.reassignDestination(*c, matrix.getDestination(
+                    static_cast<uint16_t>(rng() % 6)));
+                break;
+            case 5:
+                if (auto c = matrix.findConnection(s, d)) matrix.addDepthModulation(matrix.getSource(
+                    static_cast<uint16_t>(rng() % 6)), *c, 0.25f);
+                break;
+            case 6: matrix.setSourceMode(s, rng() % 2 ? ModSrcMode::Mono : ModSrcMode::Poly); break;
+        }
+    }
+
+    const auto& conns = matrix.getConnections();
+    for (uint16_t s = 0; s < 6; ++s) {
+        const bool src_scan = std::ranges::any_of(conns, [&](const ModConnection& c) { return c.src_idx == s; });
+        REQUIRE(matrix.srcIsConnected(s) == src_scan);
+        for (uint16_t d = 0; d < 6; ++d) {
+            const auto it = std::ranges::find_if(conns, [&](const ModConnection& c) {
+                return !c.isDepthMod() && c.src_idx == s && c.dst_idx == d;
+            });
+            const auto found = matrix.findConnection(s, d);
+            REQUIRE(found.has_value() == (it != conns.end()));
+            if (found) REQUIRE(found->depth_slot == it->depth_slot);
+        }
+    }
+    for (uint16_t d = 0; d < 6; ++d) {
+        const bool dst_scan = std::ranges::any_of(conns, [&](const ModConnection& c) {
+            return !c.isDepthMod() && c.dst_idx == d;
+        });
+        REQUIRE(matrix.dstIsConnected(d) == dst_scan);
+    }
+    for (const auto& c : conns) {
+        if (!c.isDepthMod()) continue;
+        // Every depth mod targets a live parameter connection and is findable by (src, slot)
+        REQUIRE(matrix.findConnection(c.dst_idx).has_value());
+        REQUIRE(matrix.findDepthMod(c.src_idx, c.dst_idx)->depth_slot == c.depth_slot);
+    }
+}
+
+// ============================================================
+// U-series: UI snapshot of output values
+// ============================================================
+
+TEST_CASE("U1: UI snapshot holds the last processed block", "[modmatrix][ui_snapshot]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
+        auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+        auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+        auto& gain = matrix.registerDestination("gain", ModDstMode::Mono);
+        auto& cutoff = matrix.registerDestination("cutoff", ModDstMode::Poly);
+        matrix.setBaseValue(gain.index, 0.0f);
+        matrix.setBaseValue(cutoff.index, 0.0f);
+        matrix.addConnection(lfo, gain, 1.0f, false);
+        matrix.addConnection(env, cutoff, 1.0f, false);
+
+        REQUIRE(matrix.acquireUiSnapshot().getBlockCount() == 0);
+
+        matrix.notifyVoiceOn(2);
+        matrix.setMonoSourceValue(lfo.index, 0.3f);
+        matrix.setPolySourceValue(env.index, 2, 0.7f);
+        matrix.process();
+
+        const ModUiSnapshot& snap = matrix.acquireUiSnapshot();
+        REQUIRE(snap.getBlockCount() == 1);
+        REQUIRE(snap.getModValue(gain.index) == Catch::Approx(0.3f));
+        REQUIRE(snap.getActiveVoices().size() == 1);
+        REQUIRE(snap.getActiveVoices()[0] == 2);
+        REQUIRE(snap.getPolyModValue(cutoff.index, 2) == Catch::Approx(0.7f));
+
+        // Without a new block the UI keeps reading the same frame
+        REQUIRE(&matrix.acquireUiSnapshot() == &snap);
+
+        matrix.setMonoSourceValue(lfo.index, 0.6f);
+        matrix.process();
+        matrix.process();  // nothing changed: reuses the outputs and publishes nothing new
+        const ModUiSnapshot& latest = matrix.acquireUiSnapshot();
+        REQUIRE(latest.getBlockCount() == 2);
+        REQUIRE(matrix.getQuiescentBlockCount() == 1);
+        REQUIRE(latest.getModValue(gain.index) == Catch::Approx(0.6f));
+    }
+}
+
+TEST_CASE("U2: UI snapshot is never torn across blocks", "[modmatrix][ui_snapshot]")
+{
+    ModMatrix matrix(SmallConfig);
+    applause::ValueScaleInfo identity{0.0f, 1.0f, applause::ValueScaling::linear()};
+    auto& src = matrix.registerSource("src", ModSrcType::Both, false, ModSrcMode::Mono);
+    auto& a = matrix.registerDestination("a", ModDstMode::Mono, identity);
+    auto& b = matrix.registerDestination("b", ModDstMode::Mono, identity);
+    auto& p = matrix.registerDestination("p", ModDstMode::Poly, identity);
+    for (auto* d : {&a, &b, &p}) {
+        matrix.setBaseValue(d->index, 0.0f);
+        matrix.addConnection(src, *d, 1.0f, false);
+    }
+    matrix.notifyVoiceOn(0);
+
+    // Every block drives all three destinations to the same value, so any mismatch in one frame means the
+    // UI saw values from two different blocks.
+    std::atomic<bool> done{false};
+    std::thread audio([&] {
+        for (int i = 0; i < 20000; ++i) {
+            matrix.setMonoSourceValue(src.index, static_cast<float>(i % 1000) / 1000.0f);
+            matrix.process();
+        }
+        done = true;
+    });
+
+    bool ok = true;
+    uint64_t last_block = 0;
+    while (!done) {
+        const ModUiSnapshot& snap = matrix.acquireUiSnapshot();
+        if (snap.getBlockCount() == 0) continue;
+        const float v = snap.getModValue(a.index);
+        ok &= snap.getModValue(b.index) == v;
+        ok &= snap.getPolyModValue(p.index, 0) == v;
+        ok &= snap.getBlockCount() >= last_block;
+        last_block = snap.getBlockCount();
+    }
+    audio.join();
+    REQUIRE(ok);
+}
+
+TEST_CASE("U3: UI snapshot versions move only with their destination", "[modmatrix][ui_snapshot]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
+        auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+        auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+        auto& gain = matrix.registerDestination("gain", ModDstMode::Mono);
+        auto& pan = matrix.registerDestination("pan", ModDstMode::Mono);
+        auto& cutoff = matrix.registerDestination("cutoff", ModDstMode::Poly);
+        for (auto* d : {&gain, &pan, &cutoff}) matrix.setBaseValue(d->index, 0.0f);
+        matrix.addConnection(lfo, gain, 1.0f, false);
+        matrix.addConnection(env, cutoff, 1.0f, false);
+
+        matrix.notifyVoiceOn(1);
+        matrix.setMonoSourceValue(lfo.index, 0.3f);
+        matrix.setPolySourceValue(env.index, 1, 0.5f);
+        matrix.process();
+        const ModUiSnapshot& first = matrix.acquireUiSnapshot();
+        REQUIRE(first.getDstVersion(gain.index) == 1);
+        REQUIRE(first.getDstVersion(cutoff.index) == 1);
+        REQUIRE(first.getDstVersion(pan.index) == 0);
+
+        // Only the LFO moves: the envelope's destination keeps its version
+        matrix.setMonoSourceValue(lfo.index, 0.4f);
+        matrix.process();
+        const ModUiSnapshot& second = matrix.acquireUiSnapshot();
+        REQUIRE(second.getBlockCount() == 2);
+        REQUIRE(second.getDstVersion(gain.index) == 2);
+        REQUIRE(second.getDstVersion(cutoff.index) == 1);
+
+        // A voice value changing, or another voice joining, moves the poly destination
+        matrix.setPolySourceValue(env.index, 1, 0.6f);
+        matrix.process();
+        REQUIRE(matrix.acquireUiSnapshot().getDstVersion(cutoff.index) == 3);
+        REQUIRE(matrix.acquireUiSnapshot().getDstVersion(gain.index) == 2);
+
+        matrix.notifyVoiceOn(3);
+        matrix.process();
+        REQUIRE(matrix.acquireUiSnapshot().getDstVersion(cutoff.index) == 4);
+
+        matrix.notifyVoiceOff(1);
+        matrix.notifyVoiceOff(3);
+        matrix.process();
+        REQUIRE(matrix.acquireUiSnapshot().getDstVersion(cutoff.index) == 5);
+        REQUIRE(matrix.acquireUiSnapshot().getDstVersion(pan.index) == 0);
+    }
+}
+
+// ============================================================
+// A-series: arena-backed buffers
+// ============================================================
+
+TEST_CASE("A1: Matrices built in a shared arena behave like owned ones", "[modmatrix][arena]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        cfg.ramp_outputs = true;
+
+        const size_t per_matrix = ModMatrix::requiredArenaBytes(cfg);
+        std::vector<std::byte> backing(2 * per_matrix);
+        applause::MemoryArena arena{backing.data(), backing.size()};
+
+        ModMatrix owned(cfg);
+        ModMatrix first(cfg, arena);
+        const size_t used_by_first = arena.getBytesUsed();
+        ModMatrix second(cfg, arena);
+
+        REQUIRE(used_by_first <= per_matrix);
+        REQUIRE(arena.getBytesUsed() <= 2 * per_matrix);
+
+        for (ModMatrix* m : {&owned, &first, &second}) {
+            auto& src = m->registerSource("env", ModSrcType::Poly, false);
+            auto& dst = m->registerDestination("cutoff", ModDstMode::Poly);
+            m->setBaseValue(dst.index, 0.25f);
+            m->addConnection(src, dst, 0.5f, false);
+            m->notifyVoiceOn(3);
+            m->setPolySourceValue(src.index, 3, 1.0f);
+            m->process();
+        }
+
+        REQUIRE(first.getPolyModValue(0, 3) == owned.getPolyModValue(0, 3));
+        REQUIRE(second.getPolyModValue(0, 3) == owned.getPolyModValue(0, 3));
+        REQUIRE(owned.getPolyModValue(0, 3) == Catch::Approx(0.75f));
+    }
+}
+
+TEST_CASE("A2: StaticModMatrix matches a runtime-configured matrix", "[modmatrix][arena]")
+{
+    using Static = StaticModMatrix<4, 8, 16, 32>;
+
+    auto fixed = std::make_unique<Static>();
+    ModMatrix dynamic(SmallConfig);
+
+    for (ModMatrix* m : {static_cast<ModMatrix*>(fixed.get()), &dynamic}) {
+        REQUIRE(m->getConfig().max_destinations == 16);
+        auto& lfo = m->registerSource("lfo", ModSrcType::Mono, true);
+        auto& env = m->registerSource("env", ModSrcType::Poly, false);
+        auto& gain = m->registerDestination("gain", ModDstMode::Mono);
+        auto& cutoff = m->registerDestination("cutoff", ModDstMode::Poly);
+        m->setBaseValue(gain.index, 0.5f);
+        m->setBaseValue(cutoff.index, 0.2f);
+        const auto conn = m->addConnection(env, cutoff, 0.6f, false);
+        m->addConnection(lfo, gain, 0.4f);
+        m->addDepthModulation(lfo, conn, 0.3f);
+        m->notifyVoiceOn(1);
+        m->setMonoSourceValue(lfo.index, 0.25f);
+        m->setPolySourceValue(env.index, 1, 0.8f);
+        m->process();
+    }
+
+    REQUIRE(fixed->getModValue(0) == dynamic.getModValue(0));
+    REQUIRE(fixed->getPolyModValue(1, 1) == dynamic.getPolyModValue(1, 1));
+}
+
+// ============================================================
+// Q-series: quiescent blocks
+// ============================================================
+
+TEST_CASE("Q1: Blocks without input changes reuse the previous outputs", "[modmatrix][quiescence]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
+        auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+        auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+        auto& gain = matrix.registerDestination("gain", ModDstMode::Mono);
+        auto& cutoff = matrix.registerDestination("cutoff", ModDstMode::Poly);
+        matrix.setBaseValue(gain.index, 0.0f);
+        matrix.setBaseValue(cutoff.index, 0.0f);
+        auto conn = matrix.addConnection(lfo, gain, 1.0f, false);
+        matrix.addConnection(env, cutoff, 1.0f, false);
+        matrix.notifyVoiceOn(0);
+        matrix.setMonoSourceValue(lfo.index, 0.5f);
+        matrix.setPolySourceValue(env.index, 0, 0.5f);
+
+        matrix.process();
+        REQUIRE(matrix.getQuiescentBlockCount() == 0);
+
+        // Rewriting the same values is not a change
+        matrix.setMonoSourceValue(lfo.index, 0.5f);
+        matrix.setPolySourceValue(env.index, 0, 0.5f);
+        matrix.process();
+        matrix.process();
+        REQUIRE(matrix.getQuiescentBlockCount() == 2);
+        REQUIRE(matrix.getModValue(gain.index) == Catch::Approx(0.5f));
+        REQUIRE(matrix.getPolyModValue(cutoff.index, 0) == Catch::Approx(0.5f));
+
+        SECTION("Source change") {
+            matrix.setPolySourceValue(env.index, 0, 0.25f);
+            matrix.process();
+            REQUIRE(matrix.getQuiescentBlockCount() == 2);
+            REQUIRE(matrix.getPolyModValue(cutoff.index, 0) == Catch::Approx(0.25f));
+        }
+
+        SECTION("Base value change") {
+            matrix.setBaseValue(gain.index, 0.25f);
+            matrix.process();
+            REQUIRE(matrix.getQuiescentBlockCount() == 2);
+            REQUIRE(matrix.getModValue(gain.index) == Catch::Approx(0.75f));
+        }
+
+        SECTION("Depth change") {
+            conn.setDepth(0.5f);
+            matrix.process();
+            REQUIRE(matrix.getQuiescentBlockCount() == 2);
+            REQUIRE(matrix.getModValue(gain.index) == Catch::Approx(0.25f));
+        }
+
+        SECTION("Voice on") {
+            matrix.setPolySourceValue(env.index, 1, 0.75f);
+            matrix.process();  // voice 1 isn't active yet, but its source value still counts as a change
+            REQUIRE(matrix.getQuiescentBlockCount() == 2);
+            matrix.process();
+            REQUIRE(matrix.getQuiescentBlockCount() == 3);
+            matrix.notifyVoiceOn(1);
+            matrix.process();
+            REQUIRE(matrix.getQuiescentBlockCount() == 3);
+            REQUIRE(matrix.getPolyModValue(cutoff.index, 1) == Catch::Approx(0.75f));
+        }
+    }
+}
+
+TEST_CASE("Q2: Unchanged parameters don't count as changes", "[modmatrix][quiescence]")
+{
+    ModMatrix matrix(SmallConfig);
+    applause::ParamsExtension params(4);
+    applause::ParamConfig config;
+    config.string_id = "pan";
+    config.name = "Pan";
+    config.min_value = -1.0f;
+    config.max_value = 1.0f;
+    config.default_value = 0.0f;
+    config.scaling = applause::ValueScaling::linear();
+    params.registerParam(config);
+    matrix.registerFromParamsExtension(params);
+    auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+    matrix.addConnection(lfo, matrix.getDestination(0), 0.0f, false);
+
+    // The base seeded at registration must be the real normalized value, even though plain 0 didn't "change"
+    matrix.process();
+    REQUIRE(matrix.getModValue(0) == Catch::Approx(0.0f));
+
+    matrix.loadParamBaseValues(params);
+    matrix.process();
+    REQUIRE(matrix.getQuiescentBlockCount() == 1);
+}
+
+TEST_CASE("Q3: Ramps flatten on a quiescent block", "[modmatrix][quiescence][ramp]")
+{
+    ModMatrix::Config cfg = SmallConfig;
+    cfg.ramp_outputs = true;
+    ModMatrix matrix(cfg);
+    auto& src = matrix.registerSource("src", ModSrcType::Mono, false);
+    auto& dst = matrix.registerDestination("dst", ModDstMode::Mono);
+    matrix.setBaseValue(dst.index, 0.0f);
+    matrix.addConnection(src, dst, 1.0f, false);
+    auto handle = matrix.getModHandle(dst.index);
+
+    matrix.setMonoSourceValue(src.index, 0.2f);
+    matrix.process();
+    matrix.setMonoSourceValue(src.index, 0.6f);
+    matrix.process();
+    REQUIRE(handle.getStartValue() == Catch::Approx(0.2f));
+
+    matrix.process();
+    REQUIRE(matrix.getQuiescentBlockCount() == 1);
+    REQUIRE(handle.getStartValue() == Catch::Approx(0.6f));
+    REQUIRE(handle.getValue() == Catch::Approx(0.6f));
+}
+
+// ============================================================
+// T-series: per-destination output smoothing
+// ============================================================
+
+TEST_CASE("T1: Smoothed destinations approach their target with a one-pole response", "[modmatrix][smoothing]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        cfg.smooth_outputs = true;
+        ModMatrix matrix(cfg);
+        matrix.setBlockRate(48000.0, 480);  // 100 blocks per second: 10 ms per block
+
+        const applause::ValueScaleInfo identity{0.0f, 1.0f, applause::ValueScaling::linear()};
+        auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+        auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+        auto& gain = matrix.registerDestination("gain", ModDstMode::Mono, identity, 10.0f);
+        auto& raw = matrix.registerDestination("raw", ModDstMode::Mono, identity);
+        auto& cutoff = matrix.registerDestination("cutoff", ModDstMode::Poly, identity, 10.0f);
+        for (auto* d : {&gain, &raw, &cutoff}) {
+            matrix.setBaseValue(d->index, 0.0f);
+            matrix.addConnection(d->mode == ModDstMode::Poly ? env : lfo, *d, 1.0f, false);
+        }
+        matrix.notifyVoiceOn(2);
+
+        // The first block (and a fresh voice) starts at its target instead of gliding from zero
+        matrix.setMonoSourceValue(lfo.index, 0.5f);
+        matrix.setPolySourceValue(env.index, 2, 0.5f);
+        matrix.process();
+        REQUIRE(matrix.getModValue(gain.index) == Catch::Approx(0.5f));
+        REQUIRE(matrix.getPolyModValue(cutoff.index, 2) == Catch::Approx(0.5f));
+
+        // A step moves 1 - 1/e of the way after one time constant, i.e. one block here
+        matrix.setMonoSourceValue(lfo.index, 1.0f);
+        matrix.setPolySourceValue(env.index, 2, 1.0f);
+        matrix.process();
+        const float expected = 0.5f + 0.5f * (1.0f - std::exp(-1.0f));
+        REQUIRE(matrix.getModValue(gain.index) == Catch::Approx(expected));
+        REQUIRE(matrix.getPolyModValue(cutoff.index, 2) == Catch::Approx(expected));
+        REQUIRE(matrix.getModValue(raw.index) == 1.0f);
+
+        // Smoothing keeps the matrix busy until it settles exactly on the target, then goes quiescent
+        for (int i = 0; i < 200 && matrix.getQuiescentBlockCount() == 0; ++i) matrix.process();
+        REQUIRE(matrix.getQuiescentBlockCount() > 0);
+        REQUIRE(matrix.getModValue(gain.index) == 1.0f);
+        REQUIRE(matrix.getPolyModValue(cutoff.index, 2) == 1.0f);
+    }
+}
+
+TEST_CASE("T2: Parameter smoothing times carry over from ParamConfig", "[modmatrix][smoothing]")
+{
+    ModMatrix::Config cfg = SmallConfig;
+    cfg.smooth_outputs = true;
+    ModMatrix matrix(cfg);
+    matrix.setBlockRate(48000.0, 480);
+
+    applause::ParamsExtension params(4);
+    applause::ParamConfig config;
+    config.string_id = "gain";
+    config.name = "Gain";
+    config.min_value = 0.0f;
+    config.max_value = 1.0f;
+    config.default_value = 0.0f;
+    config.smoothing_ms = 10.0f;
+    params.registerParam(config);
+    matrix.registerFromParamsExtension(params);
+
+    auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+    matrix.addConnection(lfo, matrix.getDestination(0), 1.0f, false);
+    matrix.process();
+    matrix.setMonoSourceValue(lfo.index, 1.0f);
+    matrix.process();
+    REQUIRE(matrix.getModValue(0) == Catch::Approx(1.0f - std::exp(-1.0f)));
+}
+
+// ============================================================
+// V-series: parallel per-voice evaluation
+// ============================================================
+
+namespace {
+
+// A thread pool extension attached to a fake host whose request_exec runs every task on its own thread
+struct FakeThreadPool : applause::ThreadPoolExtension {
+    clap_host_t host{};
+    clap_host_thread_pool_t host_pool{};
+    std::atomic<uint32_t> tasks_run{0};
+
+    void attach() {
+        host.host_data = this;
+        host.get_extension = [](const clap_host_t* h, const char* id) -> const void* {
+            auto* self = static_cast<FakeThreadPool*>(h->host_data);
+            return std::strcmp(id, CLAP_EXT_THREAD_POOL) == 0 ? &self->host_pool : nullptr;
+        };
+        host_pool.request_exec = [](const clap_host_t* h, uint32_t num_tasks) {
+            auto* self = static_cast<FakeThreadPool*>(h->host_data);
+            std::vector<std::thread> workers;
+            for (uint32_t t = 0; t < num_tasks; ++t) {
+                workers.emplace_back([self, t] {
+                    self->exec(t);
+                    self->tasks_run++;
+                });
+            }
+            for (auto& w : workers) w.join();
+            return true;
+        };
+        host_ = &host;
+        onHostReady();
+    }
+};
+
+}  // namespace
+
+TEST_CASE("V1: processParallel matches process()", "[modmatrix][parallel]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        for (const bool host_support : {false, true}) {
+            ModMatrix::Config cfg = StandardConfig;
+            cfg.voice_layout = layout;
+            ModMatrix serial(cfg);
+            ModMatrix parallel(cfg);
+
+            for (ModMatrix* m : {&serial, &parallel}) {
+                auto& lfo = m->registerSource("lfo", ModSrcType::Mono, true);
+                auto& env = m->registerSource("env", ModSrcType::Poly, false);
+                auto& cutoff = m->registerDestination("cutoff", ModDstMode::Poly);
+                auto& res = m->registerDestination("res", ModDstMode::Poly);
+                m->setBaseValue(cutoff.index, 0.3f);
+                m->setBaseValue(res.index, 0.1f);
+                const auto conn = m->addConnection(env, cutoff, 0.5f, false);
+                m->addConnection(lfo, res, 0.4f);
+                m->addDepthModulation(env, conn, 0.25f);
+                for (uint16_t v = 0; v < cfg.num_voices; v += 2) {
+                    m->notifyVoiceOn(v);
+                    m->setPolySourceValue(env.index, v, static_cast<float>(v) / cfg.num_voices);
+                }
+                m->setMonoSourceValue(lfo.index, 0.5f);
+            }
+
+            FakeThreadPool pool;
+            bool plugin_callback_ran = false;
+            pool.setCallback([&](uint32_t) { plugin_callback_ran = true; });
+            if (host_support) pool.attach();
+
+            parallel.processParallel(pool, 2);
+            serial.process();
+
+            // Without host support it runs serially; with it the voices are split into several tasks
+            if (host_support) {
+                REQUIRE(pool.tasks_run > 1);
+            } else {
+                REQUIRE(pool.tasks_run == 0);
+            }
+
+            // The plugin's own callback is restored afterwards
+            pool.exec(0);
+            REQUIRE(plugin_callback_ran);
+
+            for (uint16_t v = 0; v < cfg.num_voices; v += 2) {
+                REQUIRE(parallel.getPolyModValue(0, v) == serial.getPolyModValue(0, v));
+                REQUIRE(parallel.getPolyModValue(1, v) == serial.getPolyModValue(1, v));
+            }
+        }
+    }
+}
+
+TEST_CASE("W1: Voice bookkeeping survives on/off churn", "[modmatrix][voices]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = StandardConfig;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
+
+        auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+        auto& cutoff = matrix.registerDestination("cutoff", ModDstMode::Poly);
+        matrix.setBaseValue(cutoff.index, 0.2f);
+        matrix.addConnection(env, cutoff, 0.5f);
+        for (uint16_t v = 0; v < cfg.num_voices; ++v) {
+            matrix.setPolySourceValue(env.index, v, static_cast<float>(v) / cfg.num_voices);
+        }
+
+        std::mt19937 rng(1234);
+        std::vector<bool> expected(cfg.num_voices, false);
+        for (int step = 0; step < 500; ++step) {
+            const auto v = static_cast<uint16_t>(rng() % cfg.num_voices);
+            if (rng() % 2) {
+                matrix.notifyVoiceOn(v);
+                expected[v] = true;
+            } else {
+                matrix.notifyVoiceOff(v);
+                expected[v] = false;
+            }
+
+            size_t expected_count = 0;
+            for (uint16_t i = 0; i < cfg.num_voices; ++i) {
+                REQUIRE(matrix.isVoiceActive(i) == expected[i]);
+                expected_count += expected[i];
+            }
+            const auto active = matrix.getActiveVoices();
+            REQUIRE(active.size() == expected_count);
+            for (const uint16_t i : active) REQUIRE(expected[i]);
+
+            if (step % 25 == 0) {
+                matrix.process();
+                for (const uint16_t i : active) {
+                    const float expected_value = 0.2f + 0.5f * static_cast<float>(i) / cfg.num_voices;
+                    REQUIRE(matrix.getPolyModValue(cutoff.index, i) == Catch::Approx(expected_value));
+                }
+                const auto& snap = matrix.acquireUiSnapshot();
+                REQUIRE(std::ranges::is_sorted(snap.getActiveVoices()));
+                REQUIRE(snap.getActiveVoices().size() == expected_count);
+            }
+        }
+    }
+}
+
+TEST_CASE("W2: LastVoice follows trigger order through out-of-order releases", "[modmatrix][voices][reduction]")
+{
+    ModMatrix matrix(SmallConfig);
+    auto& src = matrix.registerSource("env", ModSrcType::Poly, false);
+    auto& dst = matrix.registerDestination("send", ModDstMode::Mono);
+    auto conn = matrix.addConnection(src, dst, 1.0f);
+    conn.setReduction(ModReduction::LastVoice);
+    for (uint16_t v = 0; v < SmallConfig.num_voices; ++v) {
+        matrix.setPolySourceValue(src.index, v, 0.1f * (v + 1));
+    }
+
+    matrix.notifyVoiceOn(2);
+    matrix.notifyVoiceOn(0);
+    matrix.notifyVoiceOn(3);
+    matrix.notifyVoiceOn(1);
+    matrix.process();
+    REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(0.2f));
+
+    // Releasing from the middle swaps the voice list around; the most recent remaining trigger still wins
+    matrix.notifyVoiceOff(0);
+    matrix.notifyVoiceOff(1);
+    matrix.process();
+    REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(0.4f));
+
+    // Retriggering an active voice makes it the most recent one
+    matrix.notifyVoiceOn(2);
+    matrix.process();
+    REQUIRE(matrix.getModValue(dst.index) == Catch::Approx(0.3f));
+
+    // Turning an inactive voice off is a no-op
+    matrix.notifyVoiceOff(1);
+    REQUIRE(matrix.getActiveVoices().size() == 2);
+}
+
+namespace {
+// Registers the routing test fixture's sources and destinations, optionally in reverse order
+void registerRoutingFixture(ModMatrix& m, bool reversed) {
+    if (reversed) {
+        m.registerDestination("pan", ModDstMode::Mono);
+        m.registerDestination("res", ModDstMode::Poly);
+        m.registerDestination("cutoff", ModDstMode::Poly);
+        m.registerSource("vel", ModSrcType::Poly, false);
+        m.registerSource("env", ModSrcType::Both, false);
+        m.registerSource("lfo", ModSrcType::Mono, true);
+    } else {
+        m.registerSource("lfo", ModSrcType::Mono, true);
+        m.registerSource("env", ModSrcType::Both, false);
+        m.registerSource("vel", ModSrcType::Poly, false);
+        m.registerDestination("cutoff", ModDstMode::Poly);
+        m.registerDestination("res", ModDstMode::Poly);
+        m.registerDestination("pan", ModDstMode::Mono);
+    }
+}
+
+void driveRoutingFixture(ModMatrix& m) {
+    m.notifyVoiceOn(1);
+    m.notifyVoiceOn(3);
+    m.setMonoSourceValue(m.findSource("lfo")->index, 0.25f);
+    for (const char* name : {"env", "vel"}) {
+        const uint16_t idx = m.findSource(name)->index;
+        m.setMonoSourceValue(idx, 0.7f);
+        m.setPolySourceValue(idx, 1, 0.4f);
+        m.setPolySourceValue(idx, 3, 0.9f);
+    }
+    for (const char* name : {"cutoff", "res", "pan"}) m.setBaseValue(m.findDestination(name)->index, 0.4f);
+}
+}  // namespace
+
+TEST_CASE("X1: Routing round-trips through saveRouting/loadRouting", "[modmatrix][routing]")
+{
+    ModMatrix source_matrix(SmallConfig);
+    registerRoutingFixture(source_matrix, false);
+    auto& lfo = *source_matrix.findSource("lfo");
+    auto& env = *source_matrix.findSource("env");
+    auto& vel = *source_matrix.findSource("vel");
+    auto& cutoff = *source_matrix.findDestination("cutoff");
+    auto& res = *source_matrix.findDestination("res");
+    auto& pan = *source_matrix.findDestination("pan");
+
+    // Leave a hole in the depth slots so loading has to keep them as saved
+    auto scratch = source_matrix.addConnection(lfo, res, 0.1f);
+    auto c1 = source_matrix.addConnection(env, cutoff, 0.6f, false);
+    auto c2 = source_matrix.addConnection(vel, pan, -0.3f, true);
+    c2.setReduction(ModReduction::Mean);
+    source_matrix.addConnection(lfo, cutoff, 0.2f);
+    source_matrix.addDepthModulation(lfo, c1, 0.5f);
+    source_matrix.removeConnection(scratch);
+    source_matrix.setSourceMode(env.index, ModSrcMode::Mono);
+
+    const std::vector<std::byte> blob = source_matrix.saveRouting();
+
+    ModMatrix loaded(SmallConfig);
+    registerRoutingFixture(loaded, true);
+    loaded.addConnection(*loaded.findSource("vel"), *loaded.findDestination("res"), 0.9f);
+
+    int topology_changes = 0;
+    int edits = 0;
+    rocket::scoped_connection c_edit = loaded.on_connections_edited.connect(
+        [&](std::span<const ModConnectionChange>) { edits++; });
+    rocket::scoped_connection c_topo = loaded.on_connections_changed.connect([&] { topology_changes++; });
+    REQUIRE(loaded.loadRouting(blob));
+    REQUIRE(edits == 1);
+    REQUIRE(topology_changes == 1);
+
+    // Same connections, by name, on the same depth slots
+    REQUIRE(loaded.getConnections().size() == source_matrix.getConnections().size());
+    for (const auto& c : source_matrix.getConnections()) {
+        const auto& src_name = source_matrix.getSource(c.src_idx).name;
+        const uint16_t src_idx = loaded.findSource(src_name)->index;
+        std::optional<ModConnection> match;
+        if (c.isDepthMod()) {
+            match = loaded.findDepthMod(src_idx, c.dst_idx);
+        } else {
+            match = loaded.findConnection(src_idx, loaded.findDestination(c.destination()->name)->index);
+        }
+        REQUIRE(match.has_value());
+        REQUIRE(match->depth_slot == c.depth_slot);
+        REQUIRE(match->flags == c.flags);
+        REQUIRE(match->reduction == c.reduction);
+        REQUIRE(match->getDepth() == c.getDepth());
+    }
+    REQUIRE(loaded.getSource(loaded.findSource("env")->index).mode == ModSrcMode::Mono);
+    REQUIRE_FALSE(loaded.findConnection(loaded.findSource("vel")->index, loaded.findDestination("res")->index));
+
+    // Both matrices compute the same outputs
+    driveRoutingFixture(source_matrix);
+    driveRoutingFixture(loaded);
+    source_matrix.process();
+    loaded.process();
+    const uint16_t loaded_cutoff = loaded.findDestination("cutoff")->index;
+    for (uint16_t v : {1, 3}) {
+        REQUIRE(loaded.getPolyModValue(loaded_cutoff, v) == Catch::Approx(source_matrix.getPolyModValue(cutoff.index, v)));
+    }
+    REQUIRE(loaded.getModValue(loaded.findDestination("pan")->index) == Catch::Approx(source_matrix.getModValue(pan.index)));
+
+    // Editing after a load reuses the free slot
+    auto added = loaded.addConnection(*loaded.findSource("lfo"), *loaded.findDestination("pan"), 0.1f);
+    REQUIRE(added.depth_slot == scratch.depth_slot);
+}
+
+TEST_CASE("X2: Routing for unknown ids is dropped with its depth mods", "[modmatrix][routing]")
+{
+    ModMatrix source_matrix(SmallConfig);
+    registerRoutingFixture(source_matrix, false);
+    auto& lfo = *source_matrix.findSource("lfo");
+    auto& vel = *source_matrix.findSource("vel");
+    auto conn = source_matrix.addConnection(vel, *source_matrix.findDestination("cutoff"), 0.5f);
+    source_matrix.addDepthModulation(lfo, conn, 0.5f);
+    source_matrix.addConnection(lfo, *source_matrix.findDestination("pan"), 0.5f);
+    const auto blob = source_matrix.saveRouting();
+
+    ModMatrix loaded(SmallConfig);
+    loaded.registerSource("lfo", ModSrcType::Mono, true);
+    loaded.registerSource("vel", ModSrcType::Poly, false);
+    loaded.registerDestination("pan", ModDstMode::Mono);
+
+    REQUIRE(loaded.loadRouting(blob));
+    REQUIRE(loaded.getConnections().size() == 1);
+    REQUIRE(loaded.getConnections()[0].dst_idx == loaded.findDestination("pan")->index);
+}
+
+TEST_CASE("X3: Malformed routing blobs are rejected", "[modmatrix][routing]")
+{
+    ModMatrix source_matrix(SmallConfig);
+    registerRoutingFixture(source_matrix, false);
+    auto conn = source_matrix.addConnection(*source_matrix.findSource("vel"), *source_matrix.findDestination("cutoff"), 0.5f);
+    source_matrix.addDepthModulation(*source_matrix.findSource("lfo"), conn, 0.5f);
+    const auto blob = source_matrix.saveRouting();
+
+    ModMatrix loaded(SmallConfig);
+    registerRoutingFixture(loaded, false);
+    loaded.addConnection(*loaded.findSource("lfo"), *loaded.findDestination("pan"), 0.5f);
+
+    SECTION("Empty") { REQUIRE_FALSE(loaded.loadRouting({})); }
+
+    SECTION("Truncated") { REQUIRE_FALSE(loaded.loadRouting(std::span(blob).first(blob.size() - 1))); }
+
+    SECTION("Bad magic") {
+        auto bad = blob;
+        bad[0] = std::byte{0};
+        REQUIRE_FALSE(loaded.loadRouting(bad));
+    }
+
+    SECTION("Depth mod targeting a missing slot") {
+        // The second record is the depth mod; its dst field is the target slot
+        auto bad = blob;
+        const uint16_t missing = SmallConfig.max_connections - 1;
+        std::memcpy(bad.data() + 16 + 12 + 4, &missing, sizeof(missing));
+        REQUIRE_FALSE(loaded.loadRouting(bad));
+    }
+
+    SECTION("Too many connections for this matrix") {
+        ModMatrix small({4, 4, 4, 1});
+        small.registerSource("vel", ModSrcType::Poly, false);
+        small.registerSource("lfo", ModSrcType::Mono, true);
+        small.registerDestination("cutoff", ModDstMode::Poly);
+        REQUIRE_FALSE(small.loadRouting(blob));
+        REQUIRE(small.getConnections().empty());
+    }
+
+    REQUIRE(loaded.getConnections().size() == 1);
+    REQUIRE(loaded.findConnection(loaded.findSource("lfo")->index, loaded.findDestination("pan")->index));
+}
+
+TEST_CASE("Y1: Edit transactions publish and notify once", "[modmatrix][transaction]")
+{
+    ModMatrix matrix(StandardConfig);
+    auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, true);
+    auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+    std::vector<ModDestination*> dsts;
+    for (int i = 0; i < 8; ++i) {
+        dsts.push_back(&matrix.registerDestination("dst" + std::to_string(i), ModDstMode::Mono));
+    }
+    matrix.setMonoSourceValue(lfo.index, 0.5f);
+
+    int topology_changes = 0;
+    std::vector<size_t> change_set_sizes;
+    rocket::scoped_connection c1 = matrix.on_connections_edited.connect(
+        [&](std::span<const ModConnectionChange> changes) { change_set_sizes.push_back(changes.size()); });
+    rocket::scoped_connection c2 = matrix.on_connections_changed.connect([&] { topology_changes++; });
+
+    SECTION("Edits inside a transaction are deferred to the outermost commit") {
+        {
+            ModMatrix::Transaction tx(matrix);
+            for (auto* dst : dsts) matrix.addConnection(lfo, *dst, 0.25f);
+            {
+                // Nested batches fold into the outer one
+                ModMatrix::Transaction inner(matrix);
+                matrix.addConnection(env, *dsts[0], 0.5f);
+                matrix.removeConnection(lfo.index, dsts[1]->index);
+            }
+            REQUIRE(matrix.isEditing());
+            REQUIRE(change_set_sizes.empty());
+            REQUIRE(topology_changes == 0);
+
+            // Lookups already see the pending edits, but the audio thread doesn't
+            REQUIRE(matrix.findConnection(lfo.index, dsts[2]->index).has_value());
+            matrix.process();
+            REQUIRE(matrix.getModValue(dsts[2]->index) == Catch::Approx(0.0f));
+        }
+        REQUIRE_FALSE(matrix.isEditing());
+        REQUIRE(change_set_sizes == std::vector<size_t>{10});
+        REQUIRE(topology_changes == 1);
+
+        matrix.process();
+        REQUIRE(matrix.getModValue(dsts[2]->index) == Catch::Approx(0.0625f));
+        REQUIRE(matrix.getModValue(dsts[1]->index) == Catch::Approx(0.0f));
+    }
+
+    SECTION("Depth-only batches don't report a topology change") {
+        auto conn = matrix.addConnection(lfo, *dsts[0], 0.25f);
+        change_set_sizes.clear();
+        topology_changes = 0;
+        {
+            ModMatrix::Transaction tx(matrix);
+            for (int i = 0; i < 5; ++i) conn.setDepth(0.1f * i);
+            tx.commit();
+            REQUIRE_FALSE(matrix.isEditing());
+        }
+        REQUIRE(change_set_sizes == std::vector<size_t>{5});
+        REQUIRE(topology_changes == 0);
+    }
+
+    SECTION("Empty batches are silent") {
+        matrix.beginEdit();
+        matrix.endEdit();
+        REQUIRE(change_set_sizes.empty());
+        REQUIRE(topology_changes == 0);
+    }
+}
+
+TEST_CASE("Z1: Poly connections read the right depth after slot churn", "[modmatrix][depth]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
+        auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+        auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+        auto& mono_dst = matrix.registerDestination("mono", ModDstMode::Mono);
+        auto& poly_dst = matrix.registerDestination("poly", ModDstMode::Poly);
+
+        // Interleave mono and poly connections, then remove some so the live slots are sparse
+        std::vector<ModConnection> scratch;
+        for (int i = 0; i < 4; ++i) scratch.push_back(matrix.addConnection(lfo, mono_dst, 0.1f));
+        auto pp = matrix.addConnection(env, poly_dst, 0.5f, false);
+        auto mp = matrix.addConnection(lfo, poly_dst, 0.2f, false);
+        matrix.addDepthModulation(lfo, mp, 0.5f, false);
+        matrix.addDepthModulation(env, pp, -0.5f, false);
+        matrix.removeConnection(scratch[0]);
+
+        matrix.setMonoSourceValue(lfo.index, 0.5f);
+        matrix.notifyVoiceOn(2);
+        matrix.setPolySourceValue(env.index, 2, 0.4f);
+        matrix.process();
+
+        // pp: env * (0.5 + env * -0.5); mp: lfo * (0.2 + lfo * 0.5)
+        const float expected = 0.4f * (0.5f - 0.4f * 0.5f) + 0.5f * (0.2f + 0.5f * 0.5f);
+        REQUIRE(matrix.getPolyModValue(poly_dst.index, 2) == Catch::Approx(expected));
+
+        // Removing the trailing connections frees their slots for reuse
+        matrix.removeConnection(mp);
+        matrix.process();
+        REQUIRE(matrix.getPolyModValue(poly_dst.index, 2) == Catch::Approx(0.4f * (0.5f - 0.4f * 0.5f)));
+        auto readded = matrix.addConnection(lfo, poly_dst, 0.2f, false);
+        REQUIRE(readded.depth_slot == scratch[0].depth_slot);
+    }
+}
+
+TEST_CASE("Z2: Per-voice depth follows poly depth mods as they come and go", "[modmatrix][depth]")
+{
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix::Config cfg = SmallConfig;
+        cfg.voice_layout = layout;
+        ModMatrix matrix(cfg);
+        auto& lfo = matrix.registerSource("lfo", ModSrcType::Mono, false);
+        auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+        auto& both = matrix.registerSource("both", ModSrcType::Both, false, ModSrcMode::Poly);
+        auto& dst = matrix.registerDestination("poly", ModDstMode::Poly);
+
+        auto mp = matrix.addConnection(lfo, dst, 0.4f, false);
+        matrix.setMonoSourceValue(lfo.index, 0.5f);
+        matrix.setMonoSourceValue(both.index, 1.0f);
+        for (uint16_t v : {0, 3}) {
+            matrix.notifyVoiceOn(v);
+            matrix.setPolySourceValue(env.index, v, 0.25f * (v + 1));
+            matrix.setPolySourceValue(both.index, v, 0.5f);
+        }
+        const auto value = [&](uint16_t v) {
+            matrix.process();
+            return matrix.getPolyModValue(dst.index, v);
+        };
+
+        REQUIRE(value(3) == Catch::Approx(0.5f * 0.4f));
+
+        auto dm = matrix.addDepthModulation(env, mp, 0.4f, false);
+        REQUIRE(value(0) == Catch::Approx(0.5f * (0.4f + 0.25f * 0.4f)));
+        REQUIRE(value(3) == Catch::Approx(0.5f * (0.4f + 1.0f * 0.4f)));
+
+        // A second poly depth mod on the same slot; removing one keeps the slot per-voice
+        auto dm2 = matrix.addDepthModulation(both, mp, 0.2f, false);
+        REQUIRE(value(3) == Catch::Approx(0.5f * (0.4f + 0.4f + 0.5f * 0.2f)));
+        matrix.removeConnection(dm);
+        REQUIRE(value(3) == Catch::Approx(0.5f * (0.4f + 0.5f * 0.2f)));
+
+        // Switching the remaining depth mod's source to mono makes the depth shared again
+        matrix.setSourceMode(both.index, ModSrcMode::Mono);
+        REQUIRE(value(3) == Catch::Approx(0.5f * (0.4f + 1.0f * 0.2f)));
+        matrix.setSourceMode(both.index, ModSrcMode::Poly);
+        REQUIRE(value(0) == Catch::Approx(0.5f * (0.4f + 0.5f * 0.2f)));
+
+        matrix.removeConnection(dm2);
+        REQUIRE(value(0) == Catch::Approx(0.5f * 0.4f));
+
+        // Depth edits on the target keep the flag intact
+        matrix.addDepthModulation(env, mp, 0.4f, false);
+        mp.setBipolar(false);
+        mp.setDepth(0.6f);
+        REQUIRE(value(3) == Catch::Approx(0.5f * (0.6f + 1.0f * 0.4f)));
+    }
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/OutputEventBatch.h>
+#include <applause/core/PluginBase.h>
+
+#include <vector>
+
+using namespace applause;
+
+namespace {
+
+// A host output list that records what it receives and refuses everything past limit
+struct HostOutput {
+    std::vector<clap_event_note_t> notes;
+    std::vector<clap_event_param_value_t> values;
+    size_t limit = SIZE_MAX;
+    clap_output_events_t out{};
+
+    const clap_output_events_t* get() {
+        out.ctx = this;
+        out.try_push = [](const clap_output_events_t* list, const clap_event_header_t* event) -> bool {
+            auto* self = static_cast<HostOutput*>(list->ctx);
+            if (self->notes.size() + self->values.size() >= self->limit) return false;
+            if (event->type == CLAP_EVENT_PARAM_VALUE) {
+                self->values.push_back(*reinterpret_cast<const clap_event_param_value_t*>(event));
+            } else {
+                self->notes.push_back(*reinterpret_cast<const clap_event_note_t*>(event));
+            }
+            return true;
+        };
+        return &out;
+    }
+};
+
+clap_event_note_t noteEnd(uint32_t time, int16_t key) {
+    clap_event_note_t e{};
+    e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_NOTE_END, 0};
+    e.key = key;
+    return e;
+}
+
+}  // namespace
+
+TEST_CASE("OutputEventBatch flushes events sorted by time, ties in push order", "[core][events]") {
+    OutputEventBatch batch;
+    const clap_output_events_t* list = batch.outputEvents();
+    const auto a = noteEnd(30, 1);
+    const auto b = noteEnd(10, 2);
+    const auto c = noteEnd(30, 3);
+    const auto d = noteEnd(0, 4);
+    REQUIRE(list->try_push(list, &a.header));
+    REQUIRE(batch.push(b));
+    REQUIRE(batch.push(c));
+
+    clap_event_param_value_t value{};
+    value.header = {sizeof(value), 10, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE, 0};
+    value.param_id = 7;
+    value.value = 0.25;
+    REQUIRE(batch.push(value));
+    REQUIRE(batch.push(d));
+    CHECK(batch.size() == 5);
+
+    HostOutput host;
+    CHECK(batch.flush(host.get()) == 0);
+    CHECK(batch.size() == 0);
+    REQUIRE(host.notes.size() == 4);
+    CHECK(host.notes[0].key == 4);
+    CHECK(host.notes[1].key == 2);
+    CHECK(host.notes[2].key == 1);
+    CHECK(host.notes[3].key == 3);
+    REQUIRE(host.values.size() == 1);
+    CHECK(host.values[0].param_id == 7);
+    CHECK(host.values[0].value == 0.25);
+}
+
+TEST_CASE("OutputEventBatch refuses events past its capacity", "[core][events]") {
+    OutputEventBatch batch{3 * sizeof(clap_event_note_t) + 8, 8};
+    for (int16_t key = 0; key < 3; ++key) REQUIRE(batch.push(noteEnd(0, key)));
+    CHECK_FALSE(batch.push(noteEnd(0, 3)));
+    CHECK(batch.getDroppedCount() == 1);
+
+    // A full host list counts as dropped too
+    HostOutput host;
+    host.limit = 2;
+    CHECK(batch.flush(host.get()) == 1);
+    CHECK(batch.getDroppedCount() == 2);
+
+    // Flushing empties the storage for the next block
+    for (int16_t key = 0; key < 3; ++key) CHECK(batch.push(noteEnd(0, key)));
+    batch.clear();
+    CHECK(batch.flush(host.get()) == 0);
+}
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+const clap_host_t kHost{};
+
+struct PushingPlugin : PluginBase {
+    PushingPlugin() : PluginBase(&kDesc, &kHost) {}
+    ProcessStatus process(ProcessContext& context) noexcept override {
+        const clap_output_events_t* out = context.outputEvents();
+        for (const uint32_t time : {40u, 5u, 20u}) {
+            const auto event = noteEnd(time, static_cast<int16_t>(time));
+            out->try_push(out, &event.header);
+        }
+        return ProcessStatus::Continue;
+    }
+};
+}  // namespace
+
+TEST_CASE("PluginBase sends process() output events sorted after the block", "[core][events]") {
+    PushingPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    REQUIRE(clap->activate(clap, 48000.0, 1, 64));
+
+    HostOutput host;
+    clap_process_t process{};
+    process.frames_count = 64;
+    process.out_events = host.get();
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    REQUIRE(host.notes.size() == 3);
+    CHECK(host.notes[0].header.time == 5);
+    CHECK(host.notes[1].header.time == 20);
+    CHECK(host.notes[2].header.time == 40);
+    CHECK(plugin.getDroppedOutputEventCount() == 0);
+    clap->deactivate(clap);
+}
@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/AudioPortsExtension.h>
+#include <applause/extensions/LatencyExtension.h>
+#include <applause/extensions/StateExtension.h>
+
+#include <array>
+#include <cstdint>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+const clap_host_t kHost{};
+
+struct ScratchPlugin : PluginBase {
+    ScratchPlugin() : PluginBase(&kDesc, &kHost) { setScratchBytesPerFrame(8 * sizeof(float), 1024); }
+
+    ProcessStatus process(ProcessContext& context) noexcept override {
+        MemoryArena& scratch = context.scratch();
+        used_at_start = scratch.getBytesUsed();
+        capacity = scratch.getCapacity();
+        auto buffer = scratch.allocateAudioBuffer<float, 2>(context.numFrames());
+        buffer.clear();
+        first_sample = buffer.channelSamples(0);
+        return ProcessStatus::Continue;
+    }
+
+    size_t used_at_start = 1;
+    size_t capacity = 0;
+    float* first_sample = nullptr;
+};
+
+// Processes in double and doubles its input, whatever format the host supplies
+struct DoublePrecisionPlugin : PluginBase {
+    AudioPortsExtension ports;
+
+    DoublePrecisionPlugin() : PluginBase(&kDesc, &kHost) {
+        ports.addInput(AudioPortConfig::mainStereo("In")).addOutput(AudioPortConfig::mainStereo("Out")).enable64Bit();
+        registerExtension(ports);
+    }
+
+    ProcessStatus process(ProcessContext& context) noexcept override {
+        const auto in = context.input<double, 2>();
+        auto out = context.output<double, 2>();
+        if (in.numChannels() != 2 || out.numChannels() != 2) return ProcessStatus::Error;
+        // Asking again returns the same converted buffers
+        if (context.output<double, 2>().channelSamples(1) != out.channelSamples(1)) return ProcessStatus::Error;
+        for (size_t ch = 0; ch < 2; ++ch) {
+            for (size_t i = 0; i < in.numFrames(); ++i) out.store(ch, i, 2.0 * in.load(ch, i));
+        }
+        return ProcessStatus::Continue;
+    }
+};
+
+struct CustomPorts : AudioPortsExtension {};
+
+struct ExtensionPlugin : PluginBase {
+    CustomPorts ports;
+    LatencyExtension latency;
+
+    ExtensionPlugin() : PluginBase(&kDesc, &kHost) {
+        registerExtension(ports);
+        registerExtension(latency);
+    }
+
+    const AudioPortsExtension* constPorts() const { return getExtension<AudioPortsExtension>(); }
+};
+}  // namespace
+
+TEST_CASE("PluginBase finds registered extensions by type", "[core][plugin]") {
+    ExtensionPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+
+    // A subclass is found under its base extension's ID
+    CHECK(PluginBase::findExtension<AudioPortsExtension>(clap) == &plugin.ports);
+    CHECK(PluginBase::findExtension<LatencyExtension>(clap) == &plugin.latency);
+    CHECK(plugin.constPorts() == &plugin.ports);
+    CHECK(PluginBase::findExtension<StateExtension>(clap) == nullptr);
+
+    // The host's ID lookup sees the same extensions
+    CHECK(clap->get_extension(clap, CLAP_EXT_LATENCY) == plugin.latency.getClapExtensionStruct());
+    CHECK(clap->get_extension(clap, CLAP_EXT_STATE) == nullptr);
+
+    // Slots are per plugin instance
+    ExtensionPlugin other;
+    CHECK(PluginBase::findExtension<LatencyExtension>(other.clapPlugin()) == &other.latency);
+    CHECK(PluginBase::findExtension<LatencyExtension>(clap) == &plugin.latency);
+}
+
+TEST_CASE("PluginBase hands process() a scratch arena that rewinds after every block", "[core][plugin]") {
+    ScratchPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    REQUIRE(clap->activate(clap, 48000.0, 1, 256));
+
+    clap_process_t process{};
+    process.frames_count = 256;
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.capacity == 1024 + 8 * sizeof(float) * 256);
+    CHECK(plugin.used_at_start == 0);
+    float* const first = plugin.first_sample;
+    REQUIRE(first != nullptr);
+    CHECK(reinterpret_cast<std::uintptr_t>(first) % defaultByteAlignment == 0);
+    CHECK(plugin.getScratchPeakBytes() >= 2 * 256 * sizeof(float));
+
+    // The next block starts from an empty arena and gets the same memory back
+    process.frames_count = 64;
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.used_at_start == 0);
+    CHECK(plugin.first_sample == first);
+    CHECK(plugin.getScratchPeakBytes() >= 2 * 256 * sizeof(float));
+
+    clap->deactivate(clap);
+    REQUIRE(clap->activate(clap, 48000.0, 1, 512));
+    CHECK(plugin.getScratchPeakBytes() == 0);
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.capacity == 1024 + 8 * sizeof(float) * 512);
+    float* const grown = plugin.first_sample;
+    clap->deactivate(clap);
+
+    // A smaller activation keeps the grown storage instead of allocating again
+    REQUIRE(clap->activate(clap, 48000.0, 1, 128));
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.capacity == 1024 + 8 * sizeof(float) * 128);
+    CHECK(plugin.first_sample == grown);
+    clap->deactivate(clap);
+}
+
+TEST_CASE("ProcessContext bridges ports the host supplies in the other sample format", "[core][plugin]") {
+    DoublePrecisionPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    REQUIRE(clap->activate(clap, 48000.0, 1, 64));
+
+    const auto* ports = static_cast<const clap_plugin_audio_ports_t*>(clap->get_extension(clap, CLAP_EXT_AUDIO_PORTS));
+    clap_audio_port_info_t info{};
+    REQUIRE(ports->get(clap, 0, false, &info));
+    CHECK((info.flags & CLAP_AUDIO_PORT_SUPPORTS_64BITS) != 0);
+    CHECK((info.flags & CLAP_AUDIO_PORT_PREFERS_64BITS) != 0);
+    CHECK((info.flags & CLAP_AUDIO_PORT_IS_MAIN) != 0);
+
+    constexpr uint32_t frames = 48;
+    std::array<std::array<float, frames>, 2> in{};
+    std::array<std::array<float, frames>, 2> out{};
+    for (uint32_t i = 0; i < frames; ++i) {
+        in[0][i] = static_cast<float>(i) * 0.01f;
+        in[1][i] = -static_cast<float>(i) * 0.02f;
+    }
+    std::array<float*, 2> in_ptrs{in[0].data(), in[1].data()};
+    std::array<float*, 2> out_ptrs{out[0].data(), out[1].data()};
+    clap_audio_buffer_t input{
+        .data32 = in_ptrs.data(), .data64 = nullptr, .channel_count = 2, .latency = 0, .constant_mask = 0};
+    clap_audio_buffer_t output{
+        .data32 = out_ptrs.data(), .data64 = nullptr, .channel_count = 2, .latency = 0, .constant_mask = 0};
+
+    clap_process_t process{};
+    process.frames_count = frames;
+    process.audio_inputs = &input;
+    process.audio_inputs_count = 1;
+    process.audio_outputs = &output;
+    process.audio_outputs_count = 1;
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    for (size_t ch = 0; ch < 2; ++ch) {
+        for (uint32_t i = 0; i < frames; ++i) REQUIRE(out[ch][i] == 2.0f * in[ch][i]);
+    }
+    clap->deactivate(clap);
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/ProcessContext.h>
+
+#include <array>
+#include <cstdint>
+
+using namespace applause;
+
+TEST_CASE("ProcessContext reports in-place ports and constant channels", "[core][process]") {
+    constexpr uint32_t frames = 16;
+    std::array<std::array<float, frames>, 2> shared{};
+    std::array<std::array<float, frames>, 2> separate{};
+    shared[0].fill(0.5f);
+    std::array<float*, 2> shared_ptrs{shared[0].data(), shared[1].data()};
+    std::array<float*, 2> mixed_ptrs{shared[0].data(), separate[1].data()};
+
+    std::array<clap_audio_buffer_t, 2> inputs{};
+    inputs[0] = {.data32 = shared_ptrs.data(), .channel_count = 2, .constant_mask = 0b11};
+    inputs[1] = {.data32 = mixed_ptrs.data(), .channel_count = 2, .constant_mask = 0b10};
+    clap_audio_buffer_t output{.data32 = shared_ptrs.data(), .channel_count = 2};
+
+    clap_process_t process{};
+    process.frames_count = frames;
+    process.audio_inputs = inputs.data();
+    process.audio_inputs_count = 2;
+    process.audio_outputs = &output;
+    process.audio_outputs_count = 1;
+    ProcessContext context{process};
+
+    CHECK(context.isInPlace(0, 0));
+    CHECK_FALSE(context.isInPlace(1, 0));
+    CHECK(context.isChannelInPlace(1, 0, 0));
+    CHECK_FALSE(context.isChannelInPlace(1, 0, 1));
+    CHECK_FALSE(context.isInPlace(2, 0));
+    CHECK_FALSE(context.isChannelInPlace(0, 0, 2));
+
+    CHECK(context.inputConstantMask(0) == 0b11);
+    CHECK(context.isInputChannelConstant(1, 1));
+    CHECK_FALSE(context.isInputChannelConstant(1, 0));
+    CHECK(context.inputConstantMask(5) == 0);
+
+    // Port 0 is constant but channel 0 holds DC, port 1's channel 0 isn't flagged
+    CHECK_FALSE(context.isInputSilent(0));
+    CHECK_FALSE(context.isInputSilent(1));
+    shared[0].fill(0.0f);
+    CHECK(context.isInputSilent(0));
+}
+
+TEST_CASE("ProcessContext::clearOutput zeros the port and flags it constant", "[core][process]") {
+    constexpr uint32_t frames = 8;
+    std::array<std::array<float, frames>, 3> out{};
+    for (auto& channel : out) channel.fill(1.0f);
+    std::array<float*, 3> out_ptrs{out[0].data(), out[1].data(), out[2].data()};
+    clap_audio_buffer_t output{.data32 = out_ptrs.data(), .channel_count = 3};
+
+    clap_process_t process{};
+    process.frames_count = frames;
+    process.audio_outputs = &output;
+    process.audio_outputs_count = 1;
+
+    alignas(defaultByteAlignment) std::array<std::byte, 4096> scratch_memory{};
+    MemoryArena scratch{scratch_memory.data(), scratch_memory.size()};
+    ProcessContext context{process, &scratch};
+
+    SECTION("host buffers") {
+        context.clearOutput(0);
+        for (const auto& channel : out) {
+            for (float sample : channel) REQUIRE(sample == 0.0f);
+        }
+        CHECK(output.constant_mask == 0b111);
+    }
+
+    SECTION("a bridged copy is cleared too, so committing it keeps the silence") {
+        auto bridged = context.output<double, 4>();
+        REQUIRE(bridged.numChannels() == 3);
+        for (size_t ch = 0; ch < 3; ++ch) bridged.store(ch, 0, 2.0);
+        context.clearOutput(0);
+        context.commitBridgedOutputs();
+        for (const auto& channel : out) {
+            for (float sample : channel) REQUIRE(sample == 0.0f);
+        }
+        CHECK(output.constant_mask == 0b111);
+    }
+
+    output.constant_mask = 0;
+    context.markOutputConstant(0);
+    CHECK(output.constant_mask == 0b111);
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/RealtimeSafety.h>
+
+#include <memory>
+#include <vector>
+
+using namespace applause;
+
+namespace {
+int allocations = 0;
+int blocking = 0;
+
+void countViolation(RealtimeViolation violation, const char*) noexcept {
+    if (violation == RealtimeViolation::Blocking) {
+        ++blocking;
+    } else {
+        ++allocations;
+    }
+}
+
+struct HandlerGuard {
+    RealtimeViolationHandler previous = setRealtimeViolationHandler(countViolation);
+    HandlerGuard() {
+        allocations = 0;
+        blocking = 0;
+    }
+    ~HandlerGuard() { setRealtimeViolationHandler(previous); }
+};
+}  // namespace
+
+TEST_CASE("Realtime violations are only reported on marked threads", "[core][realtime]") {
+    const HandlerGuard guard;
+    const uint64_t count_before = getRealtimeViolationCount();
+
+    checkRealtimeViolation(RealtimeViolation::Blocking, "unmarked");
+    CHECK_FALSE(isRealtimeThread());
+    CHECK(blocking == 0);
+
+    {
+        const RealtimeThreadScope outer;
+        {
+            const RealtimeThreadScope inner;
+            CHECK(isRealtimeThread());
+        }
+        CHECK(isRealtimeThread());
+        checkRealtimeViolation(RealtimeViolation::Blocking, "marked");
+        CHECK(blocking == 1);
+
+        {
+            const NonRealtimeScope exempt;
+            CHECK_FALSE(isRealtimeThread());
+            checkRealtimeViolation(RealtimeViolation::Blocking, "exempt");
+        }
+        CHECK(blocking == 1);
+    }
+    CHECK_FALSE(isRealtimeThread());
+    CHECK(getRealtimeViolationCount() == count_before + 1);
+}
+
+#if APPLAUSE_REALTIME_CHECKS
+TEST_CASE("Realtime checks catch heap allocations on the audio thread", "[core][realtime]") {
+    const HandlerGuard guard;
+    std::vector<int> values;
+    {
+        const RealtimeThreadScope realtime;
+        values.push_back(1);
+        auto owned = std::make_unique<int>(2);
+        APPLAUSE_ASSERT_NOT_REALTIME("test lock");
+    }
+    CHECK(allocations >= 3);  // Vector growth, make_unique and its delete
+    CHECK(blocking == 1);
+}
+#endif
@@ -0,0 +1,40 @@
+#include <catch2/catch_test_macros.hpp>
+#include <applause/core/RealtimeScope.h>
+
+#include <limits>
+
+using namespace applause;
+
+namespace {
+
+// volatile keeps the compiler from folding the arithmetic at compile time
+float halve(float x) {
+    volatile float v = x;
+    return v * 0.5f;
+}
+
+}  // namespace
+
+TEST_CASE("RealtimeScope flushes denormals and restores the caller's state", "[realtime]")
+{
+    const float smallest_normal = std::numeric_limits<float>::min();
+    REQUIRE(halve(smallest_normal) != 0.0f);
+
+    {
+        const RealtimeScope scope;
+#if defined(APPLAUSE_REALTIME_SCOPE_X86) || defined(APPLAUSE_REALTIME_SCOPE_ARM64)
+        REQUIRE(scope.isActive());
+        REQUIRE(halve(smallest_normal) == 0.0f);
+#else
+        REQUIRE_FALSE(scope.isActive());
+#endif
+    }
+
+    REQUIRE(halve(smallest_normal) != 0.0f);
+
+    {
+        const RealtimeScope disabled{false};
+        REQUIRE_FALSE(disabled.isActive());
+        REQUIRE(halve(smallest_normal) != 0.0f);
+    }
+}
@@ -0,0 +1,186 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/PluginBase.h>
+#include <applause/core/Telemetry.h>
+
+#include <string_view>
+#include <vector>
+
+using namespace applause;
+
+namespace {
+const clap_host_t kHost{};
+clap_plugin_descriptor_t telemetryDescriptor() {
+    clap_plugin_descriptor_t desc{};
+    desc.id = "org.applause.test.telemetry";
+    return desc;
+}
+const clap_plugin_descriptor_t kDesc = telemetryDescriptor();
+
+struct TelemetryPlugin : PluginBase {
+    std::vector<std::byte> storage = std::vector<std::byte>(4096);
+    MemoryArena arena{storage.data(), storage.size()};
+
+    TelemetryPlugin() : PluginBase(&kDesc, &kHost) { enableTelemetry(); }
+
+    bool activate(const ProcessInfo&) override {
+        arena.clear();
+        (void)arena.allocateBytes(1000);
+        setTelemetryArena(&arena);
+        return true;
+    }
+
+    ProcessStatus process(ProcessContext& context) noexcept override {
+        (void)context.scratch().allocateBytes(100);
+        setTelemetryVoiceCount(3, 16);
+        return ProcessStatus::Continue;
+    }
+};
+
+struct FailingTelemetryPlugin : PluginBase {
+    FailingTelemetryPlugin() : PluginBase(&kDesc, &kHost) { enableTelemetry(); }
+    bool activate(const ProcessInfo&) override { return false; }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+
+// The active slot whose plugin_id is id, if there is exactly one
+bool findSlot(const TelemetryReader& reader, std::string_view id, TelemetrySlot& out) {
+    size_t found = 0;
+    for (size_t i = 0; i < reader.header().slot_count; ++i) {
+        TelemetrySlot slot;
+        if (reader.read(i, slot) && std::string_view{slot.plugin_id} == id) {
+            out = slot;
+            ++found;
+        }
+    }
+    return found == 1;
+}
+}  // namespace
+
+TEST_CASE("TelemetrySegment hands out zeroed slots a reader can copy", "[core][telemetry]") {
+    TelemetrySegment& segment = TelemetrySegment::shared();
+    TelemetryReader reader;
+    REQUIRE(reader.attach(segment.bytes()));
+    CHECK(reader.header().schema_version == kTelemetrySchemaVersion);
+    CHECK(reader.header().slot_count == kTelemetrySlotCount);
+    CHECK(reader.header().process_id == currentProcessId());
+
+    TelemetryPublisher publisher;
+    REQUIRE(publisher.claim(segment, "first", 48000.0, 512));
+    DeadlineProfiler profiler;
+    profiler.record(20'000'000, 480, 0, 48000.0);  // Twice the deadline
+    publisher.setVoiceCount(5, 8);
+    publisher.publish({.profiler = &profiler, .dropped_output_events = 2, .scratch_peak_bytes = 64});
+
+    TelemetrySlot slot;
+    REQUIRE(findSlot(reader, "first", slot));
+    CHECK(slot.sequence % 2 == 0);
+    CHECK(slot.blocks == 1);
+    CHECK(slot.overruns == 1);
+    CHECK(slot.histogram[DeadlineProfiler::kNumBins - 1] == 1);
+    CHECK(slot.worst_load > 1.9f);
+    CHECK(slot.dropped_output_events == 2);
+    CHECK(slot.scratch_peak_bytes == 64);
+    CHECK(slot.active_voices == 5);
+    CHECK(slot.voice_capacity == 8);
+    CHECK(slot.sample_rate == 48000.0f);
+    CHECK(slot.max_frames == 512);
+    const uint64_t generation = slot.generation;
+
+    // A later claim of the freed slot starts from zero, under a new generation
+    publisher.release();
+    CHECK_FALSE(findSlot(reader, "first", slot));
+    REQUIRE(publisher.claim(segment, "second", 44100.0, 64));
+    REQUIRE(findSlot(reader, "second", slot));
+    CHECK(slot.blocks == 0);
+    CHECK(slot.active_voices == 0);
+    CHECK(slot.generation > 0);
+    CHECK(slot.generation != generation);
+
+    // Counts published after a claim start from the counters it was handed
+    profiler.record(1'000'000, 480, 0, 48000.0);  // A tenth of the deadline
+    publisher.publish({.profiler = &profiler, .dropped_output_events = 2});
+    REQUIRE(findSlot(reader, "second", slot));
+    CHECK(slot.blocks == 2);
+    REQUIRE(publisher.claim(segment, "second", 44100.0, 64, {.profiler = &profiler, .dropped_output_events = 2}));
+    profiler.record(1'000'000, 480, 0, 48000.0);
+    publisher.publish({.profiler = &profiler, .dropped_output_events = 3});
+    REQUIRE(findSlot(reader, "second", slot));
+    CHECK(slot.blocks == 1);
+    CHECK(slot.overruns == 0);
+    CHECK(slot.histogram[DeadlineProfiler::kNumBins - 1] == 0);
+    CHECK(slot.histogram[1] == 1);
+    CHECK(slot.worst_load < 1.0f);
+    CHECK(slot.dropped_output_events == 1);
+
+    // Every slot taken: the next claim fails instead of sharing one
+    std::vector<TelemetrySlot*> taken;
+    while (TelemetrySlot* other = segment.claim("filler")) taken.push_back(other);
+    TelemetryPublisher late;
+    CHECK_FALSE(late.claim(segment, "late", 48000.0, 64));
+    for (TelemetrySlot* other : taken) segment.release(other);
+    CHECK(late.claim(segment, "late", 48000.0, 64));
+
+    if (segment.isShared()) {
+        // What an external monitor does: find the segment by process id
+        TelemetryReader monitor;
+        REQUIRE(monitor.open(currentProcessId()));
+        REQUIRE(findSlot(monitor, "second", slot));
+        CHECK(slot.sample_rate == 44100.0f);
+    }
+}
+
+TEST_CASE("PluginBase publishes telemetry while it is active", "[core][telemetry]") {
+    TelemetryPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    CHECK_FALSE(plugin.isPublishingTelemetry());
+    REQUIRE(clap->activate(clap, 48000.0, 1, 256));
+    REQUIRE(plugin.isPublishingTelemetry());
+    REQUIRE(plugin.getDeadlineProfiler() != nullptr);
+
+    TelemetryReader reader;
+    REQUIRE(reader.attach(TelemetrySegment::shared().bytes()));
+    TelemetrySlot slot;
+    REQUIRE(findSlot(reader, kDesc.id, slot));
+    CHECK(slot.blocks == 0);
+    CHECK(slot.max_frames == 256);
+
+    // 50 ms of audio at 48 kHz is 2400 frames: ten blocks of 256 cross it once
+    clap_process_t process{};
+    process.frames_count = 256;
+    for (int i = 0; i < 10; ++i) REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    REQUIRE(findSlot(reader, kDesc.id, slot));
+    CHECK(slot.blocks == 10);
+    CHECK(slot.active_voices == 3);
+    CHECK(slot.voice_capacity == 16);
+    CHECK(slot.scratch_peak_bytes >= 100);
+    CHECK(slot.scratch_capacity_bytes > slot.scratch_peak_bytes);
+    CHECK(slot.arena_peak_bytes == 1000);
+    CHECK(slot.arena_capacity_bytes == 4096);
+    CHECK(slot.published_ns > 0);
+
+    clap->deactivate(clap);
+    CHECK_FALSE(plugin.isPublishingTelemetry());
+    CHECK_FALSE(findSlot(reader, kDesc.id, slot));
+
+    // A reactivated instance publishes the blocks since its new claim, not since construction
+    REQUIRE(clap->activate(clap, 48000.0, 1, 256));
+    for (int i = 0; i < 10; ++i) REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    REQUIRE(findSlot(reader, kDesc.id, slot));
+    CHECK(slot.blocks == 10);
+    clap->deactivate(clap);
+}
+
+TEST_CASE("PluginBase doesn't claim a telemetry slot when activation fails", "[core][telemetry]") {
+    FailingTelemetryPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    CHECK_FALSE(clap->activate(clap, 48000.0, 1, 256));
+    CHECK_FALSE(plugin.isPublishingTelemetry());
+
+    TelemetryReader reader;
+    REQUIRE(reader.attach(TelemetrySegment::shared().bytes()));
+    TelemetrySlot slot;
+    CHECK_FALSE(findSlot(reader, kDesc.id, slot));
+}
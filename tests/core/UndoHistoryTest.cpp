@@ -0,0 +1,172 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include <applause/core/ModMatrix.h>
+#include <applause/core/UndoHistory.h>
+#include <applause/extensions/ParamsExtension.h>
+
+using namespace applause;
+
+namespace {
+constexpr ModMatrix::Config kConfig{4, 8, 16, 32};
+
+struct Fixture {
+    ParamsExtension params{8};
+    ModMatrix matrix{kConfig};
+
+    Fixture() {
+        for (const char* id : {"cutoff", "resonance", "drive"}) {
+            ParamConfig config;
+            config.string_id = id;
+            params.registerParam(config);
+        }
+        matrix.registerSource("lfo", ModSrcType::Mono, true);
+        matrix.registerFromParamsExtension(params);
+    }
+
+    float value(const char* id) { return params.getInfo(id).getValue(); }
+    void set(const char* id, float value) { params.getInfo(id).setValueNotifyingHost(value); }
+};
+}  // namespace
+
+TEST_CASE("UndoHistory records only changed parameters", "[undo]") {
+    Fixture f;
+    UndoHistory history(f.params, &f.matrix);
+    CHECK_FALSE(history.snapshot());
+    CHECK_FALSE(history.canUndo());
+
+    f.set("cutoff", 0.8f);
+    REQUIRE(history.snapshot());
+    f.set("resonance", 0.1f);
+    f.set("drive", 0.9f);
+    f.set("drive", 0.5f);  // Back to where it was: not part of the step
+    REQUIRE(history.snapshot());
+
+    REQUIRE(history.size() == 2);
+    REQUIRE(history.getParamChanges(0).size() == 1);
+    REQUIRE(history.getParamChanges(1).size() == 1);
+    CHECK(history.getParamChanges(1)[0].before == 0.5f);
+    CHECK(history.getParamChanges(1)[0].after == 0.1f);
+    CHECK(history.getMemoryUsage() < 64);
+
+    REQUIRE(history.undo());
+    CHECK(f.value("resonance") == 0.5f);
+    CHECK(f.value("cutoff") == 0.8f);
+    REQUIRE(history.undo());
+    CHECK(f.value("cutoff") == 0.5f);
+    CHECK_FALSE(history.undo());
+
+    // Undoing doesn't count as an edit
+    CHECK_FALSE(history.snapshot());
+
+    REQUIRE(history.redo());
+    CHECK(f.value("cutoff") == 0.8f);
+    CHECK(history.canRedo());
+
+    SECTION("A new edit drops the redo steps") {
+        f.set("drive", 0.2f);
+        REQUIRE(history.snapshot());
+        CHECK(history.size() == 2);
+        CHECK_FALSE(history.canRedo());
+        REQUIRE(history.undo());
+        CHECK(f.value("drive") == 0.5f);
+        CHECK(f.value("resonance") == 0.5f);
+    }
+
+    SECTION("Pending edits are undone first") {
+        f.set("drive", 0.3f);
+        REQUIRE(history.undo());
+        CHECK(f.value("drive") == 0.5f);
+        CHECK(f.value("cutoff") == 0.8f);
+    }
+}
+
+TEST_CASE("UndoHistory drops the oldest steps when full", "[undo]") {
+    Fixture f;
+    UndoHistory history(f.params, nullptr, 3);
+    for (int i = 1; i <= 5; ++i) {
+        f.set("cutoff", static_cast<float>(i) / 10.0f);
+        REQUIRE(history.snapshot());
+    }
+    CHECK(history.size() == 3);
+    CHECK(history.getParamChanges(0)[0].after == 0.3f);
+
+    while (history.undo()) {
+    }
+    CHECK(f.value("cutoff") == 0.2f);
+
+    history.clear();
+    CHECK(history.size() == 0);
+    CHECK_FALSE(history.snapshot());
+}
+
+TEST_CASE("UndoHistory restores mod matrix routing", "[undo]") {
+    Fixture f;
+    UndoHistory history(f.params, &f.matrix);
+    auto& lfo = *f.matrix.findSource("lfo");
+    auto& cutoff = *f.matrix.findDestination("cutoff");
+
+    f.matrix.addConnection(lfo, cutoff, 0.5f);
+    REQUIRE(history.snapshot());
+
+    auto connection = *f.matrix.findConnection(lfo.index, cutoff.index);
+    connection.setDepth(0.25f);
+    f.set("drive", 0.7f);
+    REQUIRE(history.snapshot());
+
+    REQUIRE(history.undo());
+    REQUIRE(f.matrix.findConnection(lfo.index, cutoff.index).has_value());
+    CHECK(f.matrix.findConnection(lfo.index, cutoff.index)->getDepth() == 0.5f);
+    CHECK(f.value("drive") == 0.5f);
+
+    REQUIRE(history.undo());
+    CHECK(f.matrix.getConnections().empty());
+
+    REQUIRE(history.redo());
+    REQUIRE(history.redo());
+    CHECK(f.matrix.findConnection(lfo.index, cutoff.index)->getDepth() == 0.25f);
+    CHECK(f.value("drive") == 0.7f);
+}
+
+TEST_CASE("UndoHistory doesn't record host automation", "[undo]") {
+    Fixture f;
+    UndoHistory history(f.params, &f.matrix);
+
+    const auto automate = [&](const char* id, double value) {
+        clap_event_param_value_t event{};
+        event.header.size = sizeof(event);
+        event.header.type = CLAP_EVENT_PARAM_VALUE;
+        event.param_id = f.params.getInfo(id).clapId;
+        event.note_id = -1;
+        event.port_index = -1;
+        event.channel = -1;
+        event.key = -1;
+        event.value = value;
+        const clap_input_events_t in{
+            .ctx = &event,
+            .size = [](const clap_input_events_t*) -> uint32_t { return 1; },
+            .get = [](const clap_input_events_t* list, uint32_t) -> const clap_event_header_t* {
+                return &static_cast<const clap_event_param_value_t*>(list->ctx)->header;
+            },
+        };
+        f.params.processEvents(&in, nullptr);
+    };
+
+    automate("cutoff", 0.9);
+    CHECK_FALSE(history.snapshot());
+    CHECK_FALSE(history.canUndo());
+
+    // A user edit of an automated parameter starts from the automated value
+    f.set("cutoff", 0.3f);
+    automate("resonance", 0.7);
+    REQUIRE(history.snapshot());
+    REQUIRE(history.getParamChanges(0).size() == 1);
+    CHECK(history.getParamChanges(0)[0].before == 0.9f);
+    CHECK(history.getParamChanges(0)[0].after == 0.3f);
+
+    REQUIRE(history.undo());
+    CHECK(f.value("cutoff") == 0.9f);
+    CHECK(f.value("resonance") == 0.7f);
+    CHECK_FALSE(history.canUndo());
+}
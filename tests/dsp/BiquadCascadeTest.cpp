@@ -0,0 +1,217 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/filters/Biquad.h>
+#include <applause/dsp/filters/BiquadCascade.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <xsimd/xsimd.hpp>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr double kSampleRate = 48000.0;
+
+const std::array<BiquadBand, 6> kBands{{
+    {.type = BiquadType::LowShelf, .frequency = 120.0, .q = 0.7, .gain_db = 4.0},
+    {.type = BiquadType::Peak, .frequency = 450.0, .q = 1.5, .gain_db = -6.0},
+    {.type = BiquadType::Peak, .frequency = 2500.0, .q = 3.0, .gain_db = 9.0},
+    {.type = BiquadType::HighShelf, .frequency = 8000.0, .q = 0.7, .gain_db = -3.0},
+    {.type = BiquadType::Highpass, .frequency = 30.0, .q = 0.7071},
+    {.type = BiquadType::Notch, .frequency = 60.0, .q = 10.0, .enabled = false},
+}};
+
+// Channel ch is a sine whose frequency and phase differ per channel
+std::vector<float> makeInput(size_t channels, size_t frames) {
+    std::vector<float> input(channels * frames);
+    for (size_t ch = 0; ch < channels; ++ch) {
+        for (size_t i = 0; i < frames; ++i) {
+            const double frequency = 310.0 * static_cast<double>(ch + 1);
+            input[ch * frames + i] = static_cast<float>(std::sin(2.0 * M_PI * frequency * i / kSampleRate + ch));
+        }
+    }
+    return input;
+}
+
+// Direct form I in double, one band after another, as the reference for every processing path. The coefficients
+// are rounded to T first, as the cascade stores them.
+template <typename T>
+void referenceFilter(const std::vector<BiquadCoefficients>& bands, T* samples, size_t frames) {
+    for (const auto& band : bands) {
+        const auto round = [](double x) { return static_cast<double>(static_cast<T>(x)); };
+        const BiquadCoefficients c{round(band.b0), round(band.b1), round(band.b2), round(band.a1), round(band.a2)};
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+        for (size_t i = 0; i < frames; ++i) {
+            const double x = samples[i];
+            const double y = c.b0 * x + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            samples[i] = static_cast<T>(y);
+        }
+    }
+}
+
+// Runs kBands over block (channels planes of frames) in uneven blocks, so the state carried across blocks and
+// chunks is checked too
+template <typename T>
+void processInBlocks(std::vector<T>& block, size_t channels, size_t frames) {
+    BiquadCascade<T, 8, 8> cascade;
+    cascade.init(kSampleRate);
+    for (size_t b = 0; b < kBands.size(); ++b) cascade.setBand(b, kBands[b]);
+
+    // The first block ramps from unity to the bands; keep it out of the comparison with silence
+    std::vector<T> silence(channels * 32, T(0));
+    cascade.processBlock(BufferView<T, 8>(silence.data(), channels, 32));
+
+    for (size_t start = 0; start < frames;) {
+        const size_t end = std::min(frames, start + 37 + start % 91);
+        BufferView<T, 8> view(block.data(), channels, frames);
+        cascade.processBlock(view.getSubView(start, end));
+        start = end;
+    }
+}
+
+std::vector<BiquadCoefficients> designAll() {
+    std::vector<BiquadCoefficients> coefficients;
+    for (const auto& band : kBands) coefficients.push_back(BiquadCoefficients::design(band, kSampleRate));
+    return coefficients;
+}
+}  // namespace
+
+TEST_CASE("BiquadCoefficients hit their design gains", "[dsp][biquad]") {
+    const auto db = [](const BiquadBand& band, double frequency) {
+        const auto coefficients = BiquadCoefficients::design(band, kSampleRate);
+        return 10.0 * std::log10(coefficients.magnitudeSquared(frequency, kSampleRate));
+    };
+    CHECK(db({.type = BiquadType::Peak, .frequency = 1000.0, .q = 2.0, .gain_db = 6.0}, 1000.0) == Approx(6.0));
+    CHECK(db({.type = BiquadType::Peak, .frequency = 1000.0, .q = 2.0, .gain_db = -12.0}, 1000.0) == Approx(-12.0));
+    CHECK(db({.type = BiquadType::LowShelf, .frequency = 200.0, .gain_db = 5.0}, 1.0) == Approx(5.0).margin(1e-4));
+    CHECK(db({.type = BiquadType::HighShelf, .frequency = 2000.0, .gain_db = -4.0}, 23999.0)
+          == Approx(-4.0).margin(1e-3));
+    CHECK(db({.type = BiquadType::Lowpass, .frequency = 1000.0}, 1.0) == Approx(0.0).margin(1e-6));
+    CHECK(db({.type = BiquadType::Lowpass, .frequency = 1000.0}, 1000.0) == Approx(-3.0103).margin(1e-3));
+    CHECK(db({.type = BiquadType::Highpass, .frequency = 1000.0}, 1000.0) == Approx(-3.0103).margin(1e-3));
+    CHECK(db({.type = BiquadType::Bandpass, .frequency = 1000.0, .q = 4.0}, 1000.0) == Approx(0.0).margin(1e-6));
+    CHECK(db({.type = BiquadType::Allpass, .frequency = 1000.0}, 3456.0) == Approx(0.0).margin(1e-9));
+    CHECK(BiquadCoefficients::design({.type = BiquadType::Notch, .frequency = 1000.0}, kSampleRate)
+              .magnitudeSquared(1000.0, kSampleRate) == Approx(0.0).margin(1e-9));
+    CHECK(BiquadCoefficients::design({.gain_db = 6.0, .enabled = false}, kSampleRate) == BiquadCoefficients{});
+}
+
+TEST_CASE("BiquadCascade matches a double-precision reference on every path", "[dsp][biquad]") {
+    constexpr size_t kFrames = 500;
+    const auto coefficients = designAll();
+
+    SECTION("Scalar samples, channels packed into lanes") {
+        for (size_t channels : {1u, 2u, 3u, 5u, 8u}) {
+            const std::vector<float> input = makeInput(channels, kFrames);
+            std::vector<double> block(input.begin(), input.end());
+            std::vector<double> expected = block;
+            processInBlocks(block, channels, kFrames);
+            for (size_t ch = 0; ch < channels; ++ch) referenceFilter(coefficients, &expected[ch * kFrames], kFrames);
+            for (size_t i = 0; i < block.size(); ++i) REQUIRE(block[i] == Approx(expected[i]).margin(1e-9));
+
+            // In float, rounding in the state is amplified by the 30 Hz highpass's and 120 Hz shelf's poles near
+            // z = 1, and the 2.5 kHz bell's gain, to a few 1e-4
+            std::vector<float> float_block = input;
+            std::vector<float> float_expected = input;
+            processInBlocks(float_block, channels, kFrames);
+            for (size_t ch = 0; ch < channels; ++ch) {
+                referenceFilter(coefficients, &float_expected[ch * kFrames], kFrames);
+            }
+            for (size_t i = 0; i < float_block.size(); ++i) {
+                REQUIRE(float_block[i] == Approx(float_expected[i]).margin(1e-3));
+            }
+        }
+    }
+
+    SECTION("Batch samples, one voice per lane") {
+        using Batch = xsimd::batch<float>;
+        constexpr size_t kLanes = Batch::size;
+        BiquadCascade<Batch, 8, 1> cascade;
+        cascade.init(kSampleRate);
+        for (size_t b = 0; b < kBands.size(); ++b) cascade.setBand(b, kBands[b]);
+        std::vector<Batch> silence(32, Batch(0.0f));
+        cascade.processBlock(BufferView<Batch, 1>(reinterpret_cast<float*>(silence.data()), 1, 32));
+
+        const std::vector<float> lanes = makeInput(kLanes, kFrames);
+        std::vector<Batch> block(kFrames);
+        for (size_t i = 0; i < kFrames; ++i) {
+            alignas(64) std::array<float, kLanes> frame{};
+            for (size_t l = 0; l < kLanes; ++l) frame[l] = lanes[l * kFrames + i];
+            block[i] = Batch::load_aligned(frame.data());
+        }
+        cascade.processBlock(BufferView<Batch, 1>(reinterpret_cast<float*>(block.data()), 1, kFrames));
+
+        std::vector<float> expected = lanes;
+        for (size_t l = 0; l < kLanes; ++l) referenceFilter(coefficients, expected.data() + l * kFrames, kFrames);
+        for (size_t i = 0; i < kFrames; ++i) {
+            for (size_t l = 0; l < kLanes; ++l) {
+                REQUIRE(block[i].get(l) == Approx(expected[l * kFrames + i]).margin(1e-3));
+            }
+        }
+    }
+}
+
+TEST_CASE("BiquadCascade ramps coefficients across one block", "[dsp][biquad]") {
+    constexpr size_t kFrames = 256;
+    BiquadCascade<float, 4, 1> cascade;
+    cascade.init(kSampleRate);
+    const BiquadBand from{.type = BiquadType::Lowpass, .frequency = 500.0};
+    const BiquadBand to{.type = BiquadType::Lowpass, .frequency = 5000.0, .q = 2.0};
+    cascade.setBand(0, from);
+    std::vector<float> warmup(kFrames, 0.0f);
+    cascade.processBlock(BufferView<float, 1>(warmup.data(), 1, kFrames));
+
+    cascade.setBand(0, to);
+    CHECK(cascade.getCoefficients(0) == BiquadCoefficients::design(to, kSampleRate));
+    std::vector<float> block = makeInput(1, kFrames);
+    std::vector<float> expected = block;
+    cascade.processBlock(BufferView<float, 1>(block.data(), 1, kFrames));
+
+    // Reference: TDF-II with each coefficient stepped linearly from the old band to the new one
+    const auto a = BiquadCoefficients::design(from, kSampleRate);
+    const auto b = BiquadCoefficients::design(to, kSampleRate);
+    double s1 = 0.0, s2 = 0.0;
+    for (size_t i = 0; i < kFrames; ++i) {
+        const double t = static_cast<double>(i + 1) / kFrames;
+        const auto lerp = [t](double x, double y) { return x + t * (y - x); };
+        const double x = expected[i];
+        const double y = lerp(a.b0, b.b0) * x + s1;
+        s1 = lerp(a.b1, b.b1) * x - lerp(a.a1, b.a1) * y + s2;
+        s2 = lerp(a.b2, b.b2) * x - lerp(a.a2, b.a2) * y;
+        expected[i] = static_cast<float>(y);
+    }
+    for (size_t i = 0; i < kFrames; ++i) REQUIRE(block[i] == Approx(expected[i]).margin(1e-4));
+}
+
+TEST_CASE("Biquad magnitude response follows the exact coefficients", "[dsp][biquad]") {
+    const auto coefficients = designAll();
+    std::vector<float> frequencies;
+    for (double f = 20.0; f < 23900.0; f *= 1.02) frequencies.push_back(static_cast<float>(f));
+    std::vector<float> db(frequencies.size());
+    magnitudeResponseDb(coefficients, kSampleRate, frequencies, db);
+
+    for (size_t i = 0; i < frequencies.size(); ++i) {
+        double power = 1.0;
+        for (const auto& c : coefficients) power *= c.magnitudeSquared(frequencies[i], kSampleRate);
+        REQUIRE(db[i] == Approx(10.0 * std::log10(power)).margin(1e-3));
+    }
+
+    SECTION("The cascade draws the targets it ramps to") {
+        BiquadCascade<float, 8, 2> cascade;
+        cascade.init(kSampleRate);
+        for (size_t b = 0; b < kBands.size(); ++b) cascade.setBand(b, kBands[b]);
+        std::vector<float> from_cascade(frequencies.size());
+        cascade.magnitudeResponseDb(frequencies, from_cascade);
+        for (size_t i = 0; i < frequencies.size(); ++i) REQUIRE(from_cascade[i] == db[i]);
+    }
+}
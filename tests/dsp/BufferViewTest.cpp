@@ -1,11 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <applause/dsp/BufferView.h>
 #include <applause/util/MemoryArena.h>
 #include <applause/util/SampleType.h>
 
 #include <array>
+#include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <span>
 #include <utility>
 #include <vector>
@@ -691,6 +694,125 @@ TEMPLATE_TEST_CASE("BufferView with SIMD types", "[dsp][buffer][simd]",
     }
 }
 
+TEMPLATE_TEST_CASE("BufferView block operations", "[dsp][buffer][simd]",
+                   float, double, xsimd::batch<float>, xsimd::batch<double>)
+{
+    using SampleType = TestType;
+    using Scalar = applause::scalar_t<SampleType>;
+    using Buffer = applause::BufferView<SampleType, 2>;
+    constexpr std::size_t width = applause::sampleWidth<SampleType>();
+    constexpr std::size_t frames = 37;  // Leaves a scalar tail
+    constexpr std::size_t channels = 2;
+    constexpr std::size_t n = frames * width;
+
+    alignas(64) std::array<Scalar, (frames + 1) * channels * width> dst_backing{};
+    alignas(64) std::array<Scalar, (frames + 1) * channels * width> src_backing{};
+    auto fill = [&](auto& backing, Scalar scale) {
+        for (std::size_t i = 0; i < backing.size(); ++i)
+        {
+            backing[i] = scale * static_cast<Scalar>(static_cast<int>(i % 23) - 11);
+        }
+    };
+
+    // Offsetting by one frame misaligns every channel pointer for the batch
+    for (std::size_t offset : {std::size_t{0}, std::size_t{1}})
+    {
+        const Buffer full_dst{dst_backing.data(), channels, frames + 1};
+        const Buffer full_src{src_backing.data(), channels, frames + 1};
+        const Buffer dst = full_dst.getSubView(offset, offset + frames);
+        const applause::BufferView<const SampleType, 2> src =
+            full_src.getSubView(offset, offset + frames);
+
+        auto at = [](const Buffer& b, std::size_t ch, std::size_t i) {
+            return reinterpret_cast<const Scalar*>(b.channelSamples(ch))[i];
+        };
+        auto src_at = [&](std::size_t ch, std::size_t i) {
+            return reinterpret_cast<const Scalar*>(src.channelSamples(ch))[i];
+        };
+        std::vector<Scalar> before(channels * n);
+        auto reset = [&] {
+            fill(dst_backing, Scalar{0.5});
+            fill(src_backing, Scalar{0.25});
+            for (std::size_t ch = 0; ch < channels; ++ch)
+            {
+                for (std::size_t i = 0; i < n; ++i) before[ch * n + i] = at(dst, ch, i);
+            }
+        };
+
+        {
+            INFO("copyFrom, offset " << offset);
+            reset();
+            dst.copyFrom(src);
+            for (std::size_t ch = 0; ch < channels; ++ch)
+            {
+                for (std::size_t i = 0; i < n; ++i) REQUIRE(at(dst, ch, i) == src_at(ch, i));
+            }
+        }
+
+        {
+            INFO("addFrom, mixWithGain and multiplyBy, offset " << offset);
+            reset();
+            dst.addFrom(src);
+            dst.mixWithGain(src, Scalar{2});
+            dst.multiplyBy(src);
+            for (std::size_t ch = 0; ch < channels; ++ch)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    const Scalar s = src_at(ch, i);
+                    REQUIRE(at(dst, ch, i) == (before[ch * n + i] + s + s * Scalar{2}) * s);
+                }
+            }
+        }
+
+        {
+            INFO("applyGain, offset " << offset);
+            reset();
+            dst.applyGain(Scalar{3});
+            dst.applyGain(1, Scalar{0.5});
+            for (std::size_t ch = 0; ch < channels; ++ch)
+            {
+                const Scalar gain = ch == 1 ? Scalar{1.5} : Scalar{3};
+                for (std::size_t i = 0; i < n; ++i) REQUIRE(at(dst, ch, i) == before[ch * n + i] * gain);
+            }
+        }
+
+        {
+            INFO("applyGainRamp ramps per frame, equally across lanes, offset " << offset);
+            reset();
+            dst.applyGainRamp(Scalar{1}, Scalar{0});
+            for (std::size_t ch = 0; ch < channels; ++ch)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    const Scalar gain = Scalar{1} - static_cast<Scalar>(i / width) / Scalar{frames};
+                    REQUIRE(at(dst, ch, i) == Catch::Approx(before[ch * n + i] * gain).margin(1e-5));
+                }
+            }
+        }
+
+        {
+            INFO("getPeak and getRms, offset " << offset);
+            reset();
+            Scalar peak{};
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                peak = std::max(peak, std::abs(before[n + i]));
+                sum += static_cast<double>(before[n + i]) * before[n + i];
+            }
+            REQUIRE(dst.getPeak(1) == peak);
+            REQUIRE(dst.getRms(1) == Catch::Approx(std::sqrt(sum / n)).epsilon(1e-5));
+            REQUIRE(dst.getPeak() >= dst.getPeak(0));
+            REQUIRE(dst.getPeak() >= dst.getPeak(1));
+
+            const auto levels = dst.getLevels(1);
+            REQUIRE(levels.peak == peak);
+            REQUIRE(levels.rms == Catch::Approx(dst.getRms(1)).epsilon(1e-5));
+        }
+    }
+}
+
 TEST_CASE("Invalid BufferView construction returns an empty view",
           "[dsp][buffer]")
 {
@@ -792,3 +914,53 @@ TEST_CASE("BufferView with MemoryArena allocation", "[dsp][buffer][memory]")
         REQUIRE(buffer1.channelSamples(0) != buffer2.channelSamples(0));
     }
 }
+
+TEST_CASE("BufferView slice offsets every channel", "[dsp][buffer]")
+{
+    std::array<float, 2 * 16> data{};
+    const applause::BufferView<float, 2> view{data.data(), 2, 16};
+    const auto sliced = view.slice(5, 7);
+    REQUIRE(sliced.numFrames() == 7);
+    REQUIRE(sliced.numChannels() == 2);
+    REQUIRE(sliced.channelSamples(0) == data.data() + 5);
+    REQUIRE(sliced.channelSamples(1) == data.data() + 16 + 5);
+    REQUIRE(view.slice(16, 0).numFrames() == 0);
+}
+
+TEMPLATE_TEST_CASE("forEachSimdChunk covers a range with an aligned body",
+                   "[dsp][buffer][simd]", float, double)
+{
+    using T = TestType;
+    using Batch = xsimd::batch<T>;
+    constexpr std::size_t n = 5 * Batch::size + 3;
+    alignas(Batch) std::array<T, n + Batch::size> storage{};
+
+    for (std::size_t offset = 0; offset < Batch::size; ++offset) {
+        for (std::size_t count : {std::size_t{0}, std::size_t{1}, n}) {
+            INFO("offset " << offset << ", count " << count);
+            T* data = storage.data() + offset;
+            const applause::SimdSplit split = applause::splitForSimd<T>(data, count);
+            REQUIRE(split.head + split.body + split.tail == count);
+            REQUIRE(split.body % Batch::size == 0);
+            if (split.body > 0) {
+                REQUIRE(reinterpret_cast<std::uintptr_t>(data + split.head) %
+                            xsimd::default_arch::alignment() ==
+                        0);
+            }
+
+            for (std::size_t i = 0; i < count; ++i) data[i] = T(i);
+            std::size_t next = 0;
+            applause::forEachSimdChunk<T>(
+                data, count, [&](std::size_t i, auto chunk) {
+                using V = typename decltype(chunk)::Value;
+                REQUIRE(i == next);
+                next += chunk.width;
+                chunk.store(data + i, chunk.load(data + i) * V(T(2)));
+            });
+            REQUIRE(next == count);
+            for (std::size_t i = 0; i < count; ++i) {
+                REQUIRE(data[i] == T(2 * i));
+            }
+        }
+    }
+}
@@ -0,0 +1,175 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/core/PluginBase.h>
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/Convolver.h>
+#include <applause/extensions/ThreadPoolExtension.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+std::vector<float> noise(size_t length, unsigned seed, float decay = 0.0f) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> out(length);
+    for (size_t i = 0; i < length; ++i) out[i] = dist(rng) * std::exp(-decay * static_cast<float>(i));
+    return out;
+}
+
+std::vector<float> directConvolution(const std::vector<float>& input, const std::vector<float>& ir) {
+    std::vector<float> out(input.size(), 0.0f);
+    for (size_t n = 0; n < input.size(); ++n) {
+        double sum = 0.0;
+        for (size_t k = 0; k < ir.size() && k <= n; ++k) sum += double(ir[k]) * double(input[n - k]);
+        out[n] = static_cast<float>(sum);
+    }
+    return out;
+}
+
+// Runs input through convolver in uneven blocks and checks it against the direct convolution, delayed by latency
+void checkAgainstDirect(Convolver& convolver, const std::array<std::vector<float>, 2>& irs, size_t frames) {
+    std::array<std::vector<float>, 2> input{noise(frames, 11), noise(frames, 12)};
+    std::array<std::vector<float>, 2> output = input;
+    for (size_t start = 0, i = 0; start < frames; ++i) {
+        const size_t length = std::min<size_t>(frames - start, 1 + (i * 97) % 300);
+        std::array<float*, 2> channels{output[0].data() + start, output[1].data() + start};
+        convolver.process(BufferView<float, 2>(channels.data(), 2, length));
+        start += length;
+    }
+
+    const size_t latency = convolver.getLatency();
+    for (size_t ch = 0; ch < 2; ++ch) {
+        const std::vector<float> expected = directConvolution(input[ch], irs[ch]);
+        for (size_t n = 0; n < latency; ++n) REQUIRE(output[ch][n] == 0.0f);
+        for (size_t n = latency; n < frames; ++n) {
+            REQUIRE(output[ch][n] == Approx(expected[n - latency]).margin(2e-4));
+        }
+    }
+}
+
+// A host pool that runs every task right away, on the calling thread
+ThreadPoolExtension* g_pool = nullptr;
+uint32_t g_tasks_run = 0;
+const clap_host_thread_pool_t kHostPool{.request_exec = [](const clap_host_t*, uint32_t num_tasks) {
+    for (uint32_t t = 0; t < num_tasks; ++t) g_pool->exec(t);
+    g_tasks_run += num_tasks;
+    return true;
+}};
+const clap_host_t kHost{
+    .get_extension = [](const clap_host_t*, const char* id) -> const void* {
+        return std::strcmp(id, CLAP_EXT_THREAD_POOL) == 0 ? &kHostPool : nullptr;
+    },
+};
+const clap_plugin_descriptor_t kDesc{};
+
+struct PoolPlugin : PluginBase {
+    ThreadPoolExtension pool;
+    PoolPlugin() : PluginBase(&kDesc, &kHost) { registerExtension(pool); }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+}  // namespace
+
+TEST_CASE("Convolver matches direct convolution", "[dsp][convolver]") {
+    const std::array<std::vector<float>, 2> irs{noise(1500, 1, 0.002f), noise(1100, 2, 0.003f)};
+    const std::array<std::span<const float>, 2> channels{irs[0], irs[1]};
+
+    SECTION("Uniformly partitioned") {
+        const ConvolverLayout layout{.head_block = 64};
+        Convolver convolver;
+        convolver.activate(layout, 2, 2000);
+        convolver.setKernel(std::make_unique<ConvolverKernel>(layout, channels));
+        checkAgainstDirect(convolver, irs, 4000);
+    }
+
+    SECTION("Non-uniformly partitioned, tail inline") {
+        const ConvolverLayout layout{.head_block = 32, .tail_block = 256};
+        Convolver convolver;
+        convolver.activate(layout, 2, 2000);
+        const auto kernel = std::make_unique<ConvolverKernel>(layout, channels);
+        CHECK(kernel->numHeadPartitions() == 16);
+        CHECK(kernel->numTailPartitions() == 4);
+        convolver.setKernel(std::make_unique<ConvolverKernel>(layout, channels));
+        checkAgainstDirect(convolver, irs, 4000);
+    }
+
+    SECTION("Tail on the host thread pool") {
+        PoolPlugin plugin;
+        plugin.clapPlugin()->init(plugin.clapPlugin());
+        g_pool = &plugin.pool;
+        g_tasks_run = 0;
+
+        const ConvolverLayout layout{.head_block = 64, .tail_block = 512};
+        Convolver convolver;
+        convolver.setTailMode(ConvolverTailMode::ThreadPool, &plugin.pool);
+        convolver.activate(layout, 2, 2000);
+        convolver.setKernel(std::make_unique<ConvolverKernel>(layout, channels));
+        checkAgainstDirect(convolver, irs, 4000);
+        CHECK(g_tasks_run > 0);
+        g_pool = nullptr;
+    }
+
+    SECTION("Tail on a background thread") {
+        const ConvolverLayout layout{.head_block = 32, .tail_block = 128};
+        Convolver convolver;
+        convolver.setTailMode(ConvolverTailMode::Background);
+        convolver.activate(layout, 2, 2000);
+        convolver.setKernel(std::make_unique<ConvolverKernel>(layout, channels));
+
+        std::atomic<bool> running{true};
+        std::thread worker([&] {
+            while (running.load()) {
+                if (!convolver.processTail()) std::this_thread::yield();
+            }
+        });
+        checkAgainstDirect(convolver, irs, 4000);
+        running = false;
+        worker.join();
+    }
+}
+
+TEST_CASE("Convolver swaps kernels at block boundaries and truncates long ones", "[dsp][convolver]") {
+    const ConvolverLayout layout{.head_block = 16};
+    Convolver convolver;
+    convolver.activate(layout, 1, 32);
+
+    // An impulse through a delayed unit impulse response comes out delayed by latency + the response's delay
+    std::vector<float> ir(40, 0.0f);
+    ir[5] = 1.0f;
+    ir[39] = 1.0f;  // Past max_length: dropped
+    convolver.setKernel(std::make_unique<ConvolverKernel>(layout, std::span<const float>(ir)));
+
+    std::vector<float> buffer(128, 0.0f);
+    buffer[0] = 1.0f;
+    convolver.process(BufferView<float, 1>(buffer.data(), 1, buffer.size()));
+    for (size_t n = 0; n < buffer.size(); ++n) {
+        REQUIRE(buffer[n] == Approx(n == 16 + 5 ? 1.0f : 0.0f).margin(1e-5));
+    }
+
+    SECTION("A mismatched layout is refused") {
+        const ConvolverLayout other{.head_block = 32};
+        convolver.setKernel(std::make_unique<ConvolverKernel>(other, std::span<const float>(ir)));
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        buffer[0] = 1.0f;
+        convolver.process(BufferView<float, 1>(buffer.data(), 1, buffer.size()));
+        CHECK(buffer[21] == Approx(1.0f).margin(1e-5));
+    }
+
+    SECTION("reset() clears the history") {
+        convolver.reset();
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        convolver.process(BufferView<float, 1>(buffer.data(), 1, buffer.size()));
+        CHECK(std::all_of(buffer.begin(), buffer.end(), [](float x) { return std::abs(x) < 1e-6f; }));
+    }
+}
@@ -0,0 +1,167 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/DelayLine.h>
+#include <applause/util/MemoryArena.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <xsimd/xsimd.hpp>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr size_t kMaxDelay = 100;
+constexpr size_t kMaxFrames = 64;
+
+// A ramp interpolates exactly with every mode but None, so reads can be checked against the fractional position
+float ramp(double frame) { return static_cast<float>(0.25 * frame); }
+
+template <Sample S>
+struct Fixture {
+    std::vector<std::byte> storage;
+    MemoryArena arena;
+    DelayLine<S, 2> delay;
+
+    explicit Fixture(size_t max_frames = kMaxFrames)
+        : storage(DelayLine<S, 2>::requiredArenaBytes(2, kMaxDelay, max_frames)),
+          arena(storage.data(), storage.size()) {
+        delay.activate(arena, 2, kMaxDelay, max_frames);
+    }
+};
+
+template <DelayInterpolation Mode>
+void checkModulatedRamp() {
+    Fixture<float> fixture;
+    auto& delay = fixture.delay;
+    std::array<std::vector<float>, 2> input{std::vector<float>(kMaxFrames), std::vector<float>(kMaxFrames)};
+    std::vector<float> delays(kMaxFrames);
+    std::vector<float> output(kMaxFrames);
+    size_t frame = 0;
+    for (size_t block = 0; block < 20; ++block) {
+        const size_t num_frames = 1 + (block * 37) % kMaxFrames;
+        for (size_t i = 0; i < num_frames; ++i) {
+            input[0][i] = ramp(static_cast<double>(frame + i));
+            input[1][i] = -input[0][i];
+            delays[i] = 1.5f + 40.0f * (1.0f + std::sin(0.01f * static_cast<float>(frame + i)));
+        }
+        std::array<const float*, 2> channels{input[0].data(), input[1].data()};
+        delay.write(BufferView<const float, 2>(channels.data(), 2, num_frames));
+        delay.readModulated<Mode>(0, delays.data(), output.data(), num_frames);
+        for (size_t i = 0; i < num_frames; ++i) {
+            const double position = static_cast<double>(frame + i) - delays[i];
+            if (position < 2.0) continue;
+            REQUIRE(output[i] == Approx(ramp(position)).margin(1e-3));
+        }
+        frame += num_frames;
+    }
+}
+}  // namespace
+
+TEST_CASE("DelayLine capacity is a power of two with room for the taps", "[dsp][delayline]") {
+    Fixture<float> fixture;
+    const auto& delay = fixture.delay;
+    CHECK(delay.capacity() == 256);
+    CHECK(delay.maxDelay() == kMaxDelay);
+    CHECK(DelayLine<float>::capacityFor(61, 0) == 128);
+    CHECK(DelayLine<float>::capacityFor(125, 0) == 256);
+}
+
+TEST_CASE("DelayLine block reads delay by whole frames across the wrap", "[dsp][delayline]") {
+    Fixture<float> fixture;
+    auto& delay = fixture.delay;
+    std::vector<float> input(kMaxFrames);
+    std::vector<float> output(kMaxFrames);
+    size_t frame = 0;
+    for (size_t block = 0; block < 40; ++block) {
+        const size_t num_frames = 1 + (block * 29) % kMaxFrames;
+        for (size_t i = 0; i < num_frames; ++i) input[i] = static_cast<float>(frame + i + 1);
+        delay.write(BufferView<const float, 2>(input.data(), 1, num_frames));
+        delay.read(BufferView<float, 2>(output.data(), 1, num_frames), 37);
+        for (size_t i = 0; i < num_frames; ++i) {
+            const size_t t = frame + i;
+            REQUIRE(output[i] == (t >= 37 ? static_cast<float>(t - 37 + 1) : 0.0f));
+        }
+        frame += num_frames;
+    }
+}
+
+TEST_CASE("DelayLine modulated reads interpolate between frames", "[dsp][delayline]") {
+    SECTION("Linear") { checkModulatedRamp<DelayInterpolation::Linear>(); }
+    SECTION("Hermite") { checkModulatedRamp<DelayInterpolation::Hermite>(); }
+    SECTION("Lagrange") { checkModulatedRamp<DelayInterpolation::Lagrange>(); }
+}
+
+TEST_CASE("DelayLine per-sample reads match block reads", "[dsp][delayline]") {
+    Fixture<float> per_sample(0);
+    Fixture<float> per_block;
+    std::vector<float> input(kMaxFrames);
+    std::vector<float> delays(kMaxFrames);
+    std::vector<float> output(kMaxFrames);
+    for (size_t i = 0; i < kMaxFrames; ++i) {
+        input[i] = std::sin(0.3f * static_cast<float>(i * i));
+        delays[i] = 1.0f + 0.37f * static_cast<float>(i);
+    }
+    per_block.delay.write(BufferView<const float, 2>(input.data(), 1, kMaxFrames));
+    per_block.delay.readModulated<DelayInterpolation::Hermite>(0, delays.data(), output.data(), kMaxFrames);
+    for (size_t i = 0; i < kMaxFrames; ++i) {
+        per_sample.delay.write(0, input[i]);
+        REQUIRE(per_sample.delay.read<DelayInterpolation::Hermite>(0, delays[i]) == Approx(output[i]).margin(1e-6));
+        per_sample.delay.advance();
+    }
+}
+
+TEST_CASE("DelayLine clamps delays and reads whole samples without interpolation", "[dsp][delayline]") {
+    Fixture<float> fixture(0);
+    auto& delay = fixture.delay;
+    for (size_t i = 0; i < 300; ++i) {
+        delay.write(0, static_cast<float>(i));
+        if (i == 299) break;
+        delay.advance();
+    }
+    CHECK(delay.read<DelayInterpolation::None>(0, 0.0f) == 299.0f);
+    CHECK(delay.read<DelayInterpolation::None>(0, 2.6f) == 296.0f);
+    CHECK(delay.read<DelayInterpolation::Linear>(0, 2.25f) == Approx(296.75f));
+    CHECK(delay.read<DelayInterpolation::Linear>(0, 1e6f) == 299.0f - kMaxDelay);
+    CHECK(delay.read<DelayInterpolation::Hermite>(0, 0.0f) == Approx(298.0f));
+}
+
+TEST_CASE("DelayLine reads each voice of a batch at its own delay", "[dsp][delayline]") {
+    using Batch = xsimd::batch<float>;
+    constexpr size_t kLanes = Batch::size;
+    Fixture<Batch> fixture;
+    auto& delay = fixture.delay;
+
+    // Lane l holds ramp(frame) + 1000 * l, so a wrong lane is off by far more than the margin
+    std::vector<Batch> input(kMaxFrames);
+    std::vector<Batch> delays(kMaxFrames);
+    std::vector<Batch> output(kMaxFrames);
+    for (size_t block = 0, frame = 0; block < 10; ++block, frame += kMaxFrames) {
+        for (size_t i = 0; i < kMaxFrames; ++i) {
+            alignas(64) std::array<float, kLanes> values{};
+            alignas(64) std::array<float, kLanes> lane_delays{};
+            for (size_t l = 0; l < kLanes; ++l) {
+                values[l] = ramp(static_cast<double>(frame + i)) + 1000.0f * static_cast<float>(l);
+                lane_delays[l] = 3.5f + 11.25f * static_cast<float>(l);
+            }
+            input[i] = Batch::load_aligned(values.data());
+            delays[i] = Batch::load_aligned(lane_delays.data());
+        }
+        delay.write(BufferView<const Batch, 2>(reinterpret_cast<const float*>(input.data()), 1, kMaxFrames));
+        delay.readModulated<DelayInterpolation::Hermite>(0, delays.data(), output.data(), kMaxFrames);
+        if (block == 0) continue;
+        for (size_t i = 0; i < kMaxFrames; ++i) {
+            for (size_t l = 0; l < kLanes; ++l) {
+                const double position = static_cast<double>(frame + i) - (3.5 + 11.25 * static_cast<double>(l));
+                REQUIRE(output[i].get(l) == Approx(ramp(position) + 1000.0f * static_cast<float>(l)).margin(1e-3));
+            }
+        }
+    }
+    // After a block, the current frame is the one after it
+    CHECK(delay.read(0, Batch(1.0f)).get(0) == Approx(ramp(10.0 * kMaxFrames - 1.0)).margin(1e-3));
+}
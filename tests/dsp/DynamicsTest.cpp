@@ -0,0 +1,202 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/Dynamics.h>
+#include <applause/dsp/Random.h>
+#include <applause/util/MemoryArena.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr float kSampleRate = 48000.0f;
+constexpr double kPi = 3.14159265358979323846;
+
+float toDb(float gain) { return 20.0f * std::log10(gain); }
+
+// Planar channels x frames, with a BufferView over them
+struct Buffer {
+    std::vector<float> data;
+    size_t channels;
+    size_t frames;
+
+    Buffer(size_t num_channels, size_t num_frames)
+        : data(num_channels * num_frames), channels(num_channels), frames(num_frames) {}
+    float* channel(size_t ch) { return data.data() + ch * frames; }
+    template <size_t MaxChannels>
+    BufferView<float, MaxChannels> view(size_t first = 0, size_t count = SIZE_MAX) {
+        count = std::min(count, frames - first);
+        std::array<float*, MaxChannels> channels_ptrs{};
+        for (size_t ch = 0; ch < channels; ++ch) channels_ptrs[ch] = channel(ch) + first;
+        return BufferView<float, MaxChannels>(channels_ptrs.data(), channels, count);
+    }
+};
+}  // namespace
+
+TEST_CASE("SlidingWindowMax tracks the maximum of the last values pushed", "[dsp][dynamics]") {
+    constexpr size_t kWindow = 5;
+    std::vector<std::byte> storage(SlidingWindowMax::requiredArenaBytes(kWindow));
+    MemoryArena arena{storage.data(), storage.size()};
+    SlidingWindowMax window;
+    window.activate(arena, kWindow);
+
+    NoiseGenerator noise{1, 3};
+    Buffer values{1, 500};
+    auto view = values.view<1>();
+    noise.fillUniform(view);
+    // Runs of falling values are what a monotonic queue has to keep
+    for (size_t i = 200; i < 260; ++i) values.data[i] = 1.0f - static_cast<float>(i - 200) / 60.0f;
+
+    for (size_t i = 0; i < values.data.size(); ++i) {
+        const size_t first = i + 1 >= kWindow ? i + 1 - kWindow : 0;
+        const float expected = *std::max_element(values.data.begin() + first, values.data.begin() + i + 1);
+        REQUIRE(window.push(values.data[i]) == expected);
+    }
+}
+
+TEST_CASE("EnvelopeFollower follows every channel in its own lane", "[dsp][dynamics]") {
+    // More channels than lanes, so several groups are in play with any SIMD width
+    constexpr size_t kChannels = 2 * EnvelopeFollower<>::kLanes + 1;
+    EnvelopeFollower<kChannels> follower;
+    follower.prepare(kSampleRate, 1.0f, 10.0f);
+
+    Buffer input{kChannels, 1000};
+    for (size_t ch = 1; ch < kChannels; ch += 2) std::fill_n(input.channel(ch), 48, static_cast<float>(ch) / 10.0f);
+    Buffer envelope{kChannels, 1000};
+    follower.process(input.view<kChannels>(), envelope.view<kChannels>());
+
+    // One attack time into the step, 1 - 1/e of it; one release time after the step ends, 1/e of that
+    const float reached = 1.0f - std::exp(-1.0f);
+    for (size_t ch = 0; ch < kChannels; ++ch) {
+        const float level = ch % 2 == 1 ? static_cast<float>(ch) / 10.0f : 0.0f;
+        CHECK(envelope.channel(ch)[47] == Approx(level * reached).margin(1e-4));
+        CHECK(envelope.channel(ch)[47 + 480] == Approx(level * reached * std::exp(-1.0f)).margin(1e-4));
+        CHECK(follower.getEnvelope(ch) == envelope.channel(ch)[999]);
+    }
+
+    SECTION("RMS") {
+        EnvelopeFollower<1> rms{EnvelopeDetector::Rms};
+        rms.prepare(kSampleRate, 50.0f, 50.0f);
+        Buffer sine{1, 48000};
+        for (size_t i = 0; i < sine.frames; ++i) sine.data[i] = static_cast<float>(std::sin(2.0 * kPi * i / 48.0));
+        rms.process(sine.view<1>(), sine.view<1>());
+        CHECK(rms.getEnvelope(0) == Approx(std::sqrt(0.5)).epsilon(0.02));
+    }
+}
+
+TEST_CASE("Compressor static curve and steady-state gain", "[dsp][dynamics]") {
+    Compressor<2> compressor{{.threshold_db = -20.0f, .ratio = 4.0f, .knee_db = 0.0f, .attack_ms = 1.0f,
+                              .release_ms = 20.0f, .makeup_db = 0.0f, .linked = true}};
+    compressor.prepare(kSampleRate);
+
+    using Batch = Compressor<2>::Batch;
+    CHECK(compressor.staticCurve(Batch(-30.0f)).get(0) == Approx(-30.0f));
+    CHECK(compressor.staticCurve(Batch(-10.0f)).get(0) == Approx(-17.5f));
+
+    SECTION("soft knee meets both lines") {
+        compressor.setParameters({.threshold_db = -20.0f, .ratio = 4.0f, .knee_db = 10.0f});
+        CHECK(compressor.staticCurve(Batch(-25.0f)).get(0) == Approx(-25.0f));
+        CHECK(compressor.staticCurve(Batch(-15.0f)).get(0) == Approx(-18.75f));
+        // Halfway between the two lines' knee ends, below both
+        CHECK(compressor.staticCurve(Batch(-20.0f)).get(0) == Approx(-20.0f - 0.75f * 25.0f / 20.0f));
+    }
+
+    SECTION("linked, a loud channel turns the quiet one down too") {
+        Buffer buffer{2, 4800};
+        std::fill_n(buffer.channel(0), buffer.frames, 0.5f);  // -6 dB, 14 dB over
+        std::fill_n(buffer.channel(1), buffer.frames, 0.01f);
+        compressor.process(buffer.view<2>());
+        const float reduction = -0.75f * (toDb(0.5f) + 20.0f);
+        CHECK(toDb(buffer.channel(0)[4799] / 0.5f) == Approx(reduction).margin(0.05));
+        CHECK(toDb(buffer.channel(1)[4799] / 0.01f) == Approx(reduction).margin(0.05));
+        CHECK(compressor.getGainReductionDb(1) == Approx(reduction).margin(0.05));
+    }
+
+    SECTION("unlinked, each channel keeps its own gain") {
+        auto parameters = compressor.getParameters();
+        parameters.linked = false;
+        parameters.makeup_db = 3.0f;
+        compressor.setParameters(parameters);
+        Buffer buffer{2, 4800};
+        std::fill_n(buffer.channel(0), buffer.frames, 0.5f);
+        std::fill_n(buffer.channel(1), buffer.frames, 0.01f);
+        compressor.process(buffer.view<2>());
+        CHECK(toDb(buffer.channel(0)[4799] / 0.5f) == Approx(3.0f - 0.75f * (toDb(0.5f) + 20.0f)).margin(0.05));
+        CHECK(toDb(buffer.channel(1)[4799] / 0.01f) == Approx(3.0f).margin(0.05));
+    }
+}
+
+namespace {
+void checkLimiter(bool true_peak) {
+    constexpr size_t kMaxFrames = 128;
+    std::vector<std::byte> storage(LookaheadLimiter<2>::requiredArenaBytes(2, kMaxFrames, kSampleRate));
+    MemoryArena arena{storage.data(), storage.size()};
+    LookaheadLimiter<2> limiter{-1.0f, 50.0f, true_peak};
+    limiter.activate(arena, 2, kMaxFrames, kSampleRate);
+    const size_t lookahead = LookaheadLimiter<2>::lookaheadFrames(kSampleRate, 1.5f);
+    CHECK(limiter.getLatency() == lookahead + (true_peak ? 4 : 0));
+
+    // Quiet noise with a few loud bursts, processed in blocks of uneven sizes
+    constexpr size_t kFrames = 40000;
+    Buffer input{2, kFrames};
+    NoiseGenerator noise{2, 11};
+    auto view = input.view<2>();
+    noise.fillUniform(view, 0.2f);
+    for (size_t start : {3000u, 9000u, 9100u, 15000u}) {
+        for (size_t i = start; i < start + 300; ++i) input.channel(i % 2)[i] *= 20.0f;
+    }
+    Buffer output = input;
+    for (size_t first = 0, b = 0; first < kFrames; ++b) {
+        const size_t count = std::min<size_t>({kMaxFrames, 1 + (b * 37) % kMaxFrames, kFrames - first});
+        limiter.process(output.view<2>(first, count));
+        first += count;
+    }
+
+    const float ceiling = std::pow(10.0f, -1.0f / 20.0f);
+    const size_t latency = limiter.getLatency();
+    for (size_t ch = 0; ch < 2; ++ch) {
+        for (size_t i = 0; i < kFrames; ++i) {
+            REQUIRE(std::abs(output.channel(ch)[i]) <= ceiling * 1.0001f);
+            const float delayed = i >= latency ? input.channel(ch)[i - latency] : 0.0f;
+            // Every output frame is the input frame latency back, at some gain between 0 and 1
+            REQUIRE(std::abs(output.channel(ch)[i]) <= std::abs(delayed) * 1.0001f + 1e-7f);
+        }
+        // Away from the bursts the audio passes untouched
+        for (size_t i = 1000 + latency; i < 2900; ++i) REQUIRE(output.channel(ch)[i] == input.channel(ch)[i - latency]);
+    }
+    // Ten release times after the last burst, the gain is back
+    CHECK(limiter.getGainReductionDb() == Approx(0.0f).margin(1e-3));
+}
+}  // namespace
+
+TEST_CASE("LookaheadLimiter holds the ceiling and delays the audio by its latency", "[dsp][dynamics]") {
+    SECTION("sample peaks") { checkLimiter(false); }
+    SECTION("true peaks") { checkLimiter(true); }
+}
+
+TEST_CASE("LookaheadLimiter with true peak catches peaks between samples", "[dsp][dynamics]") {
+    constexpr size_t kFrames = 4800;
+    std::vector<std::byte> storage(LookaheadLimiter<1>::requiredArenaBytes(1, kFrames, kSampleRate));
+    MemoryArena arena{storage.data(), storage.size()};
+
+    // A quarter of the sample rate, 45 degrees off: every sample is at 0.707 of the real peak
+    Buffer sine{1, kFrames};
+    for (size_t i = 0; i < kFrames; ++i) sine.data[i] = static_cast<float>(1.2 * std::sin(kPi / 2.0 * i + kPi / 4.0));
+
+    auto limited = [&](bool true_peak) {
+        arena.clear();
+        LookaheadLimiter<1> limiter{0.0f, 50.0f, true_peak};
+        limiter.activate(arena, 1, kFrames, kSampleRate);
+        Buffer out = sine;
+        limiter.process(out.view<1>());
+        return std::abs(out.data[kFrames - 1]);
+    };
+    CHECK(limited(false) == Approx(1.2f * std::sqrt(0.5f)).epsilon(1e-4));
+    CHECK(limited(true) == Approx(std::sqrt(0.5f)).epsilon(0.03));
+}
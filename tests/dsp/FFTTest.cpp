@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/dsp/FFT.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+TEST_CASE("FFT matches a direct DFT and inverts exactly", "[dsp][fft]") {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    for (size_t size : {4u, 8u, 32u, 256u, 2048u}) {
+        FFT fft(size);
+        REQUIRE(fft.numBins() == size / 2 + 1);
+
+        std::vector<float> input(size);
+        for (float& x : input) x = dist(rng);
+        std::vector<float> re(fft.numBins());
+        std::vector<float> im(fft.numBins());
+        fft.forward(input.data(), re.data(), im.data());
+
+        const double tolerance = 1e-5 * static_cast<double>(size);
+        for (size_t k = 0; k < fft.numBins(); k += std::max<size_t>(1, size / 64)) {
+            std::complex<double> expected;
+            for (size_t n = 0; n < size; ++n) {
+                expected += static_cast<double>(input[n]) * std::polar(1.0, -2.0 * M_PI * double(k * n) / double(size));
+            }
+            REQUIRE(re[k] == Approx(expected.real()).margin(tolerance));
+            REQUIRE(im[k] == Approx(expected.imag()).margin(tolerance));
+        }
+
+        std::vector<float> output(size);
+        fft.inverse(re.data(), im.data(), output.data());
+        for (size_t n = 0; n < size; ++n) REQUIRE(output[n] == Approx(input[n]).margin(1e-5));
+    }
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+#include <applause/dsp/FastMath.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace applause;
+
+TEST_CASE("fast::exp2 stays within its relative error bound", "[dsp][fastmath]")
+{
+    float worst = 0.0f;
+    for (float x = -40.0f; x <= 40.0f; x += 0.0137f) {
+        const float exact = std::exp2(x);
+        worst = std::max(worst, std::abs(fast::exp2(x) - exact) / exact);
+    }
+    REQUIRE(worst < 3e-7f);
+
+    SECTION("Integer powers are exact")
+    {
+        REQUIRE(fast::exp2(0.0f) == 1.0f);
+        REQUIRE(fast::exp2(10.0f) == 1024.0f);
+        REQUIRE(fast::exp2(-3.0f) == 0.125f);
+    }
+
+    SECTION("Out-of-range inputs clamp instead of overflowing")
+    {
+        REQUIRE(std::isfinite(fast::exp2(1000.0f)));
+        REQUIRE(fast::exp2(-1000.0f) > 0.0f);
+    }
+}
+
+TEST_CASE("fast::log2 stays within its absolute error bound", "[dsp][fastmath]")
+{
+    for (float x = 1e-4f; x <= 1e5f; x *= 1.0093f) {
+        const float exact = std::log2(x);
+        const float ulp = std::nextafter(std::abs(exact), INFINITY) - std::abs(exact);
+        REQUIRE(std::abs(fast::log2(x) - exact) < 2e-7f + ulp);
+    }
+
+    REQUIRE(fast::log2(1.0f) == 0.0f);
+    REQUIRE(fast::log2(8.0f) == 3.0f);
+}
+
+TEST_CASE("fast::tan stays within its relative error bound up to the pole", "[dsp][fastmath]")
+{
+    float worst = 0.0f;
+    for (float x = 1e-4f; x < 1.5707f; x += 0.000731f) {
+        const double exact = std::tan(static_cast<double>(x));
+        worst = std::max(worst, static_cast<float>(std::abs(fast::tan(x) - exact) / exact));
+    }
+    REQUIRE(worst < 5e-7f);
+    REQUIRE(fast::tan(0.0f) == 0.0f);
+}
+
+TEST_CASE("fast::exp stays within its relative error bound", "[dsp][fastmath]")
+{
+    float worst = 0.0f;
+    for (float x = -87.0f; x <= 88.0f; x += 0.0113f) {
+        const double exact = std::exp(static_cast<double>(x));
+        worst = std::max(worst, static_cast<float>(std::abs(fast::exp(x) - exact) / exact));
+    }
+    REQUIRE(worst < 3e-7f);
+    REQUIRE(fast::exp(0.0f) == 1.0f);
+    REQUIRE(std::isfinite(fast::exp(1000.0f)));
+}
+
+TEST_CASE("fast::sin stays within its absolute error bound", "[dsp][fastmath]")
+{
+    float worst = 0.0f;
+    for (float x = -8192.0f; x <= 8192.0f; x += 0.0371f) {
+        worst = std::max(worst, static_cast<float>(std::abs(fast::sin(x) - std::sin(static_cast<double>(x)))));
+    }
+    REQUIRE(worst < 2e-7f);
+    REQUIRE(fast::sin(0.0f) == 0.0f);
+}
+
+TEST_CASE("fast::tanh stays within its error bounds", "[dsp][fastmath]")
+{
+    float worst_absolute = 0.0f;
+    float worst_relative = 0.0f;
+    for (float x = -12.0f; x <= 12.0f; x += 0.000917f) {
+        const double exact = std::tanh(static_cast<double>(x));
+        const auto error = static_cast<float>(std::abs(fast::tanh(x) - exact));
+        worst_absolute = std::max(worst_absolute, error);
+        if (exact != 0.0) worst_relative = std::max(worst_relative, static_cast<float>(error / std::abs(exact)));
+    }
+    REQUIRE(worst_absolute < 3e-7f);
+    REQUIRE(worst_relative < 3e-6f);
+    REQUIRE(fast::tanh(0.0f) == 0.0f);
+    REQUIRE(fast::tanh(50.0f) == 1.0f);
+    REQUIRE(fast::tanh(-50.0f) == -1.0f);
+}
+
+TEST_CASE("fast:: batch and scalar paths agree", "[dsp][fastmath]")
+{
+    using Batch = xsimd::batch<float>;
+    alignas(64) float in[Batch::size];
+    alignas(64) float out[Batch::size];
+    for (size_t i = 0; i < Batch::size; ++i) in[i] = 0.37f + 1.91f * static_cast<float>(i);
+
+    fast::exp2(Batch::load_aligned(in)).store_aligned(out);
+    for (size_t i = 0; i < Batch::size; ++i) REQUIRE(std::abs(out[i] - fast::exp2(in[i])) <= 1e-6f * out[i]);
+
+    fast::log2(Batch::load_aligned(in)).store_aligned(out);
+    for (size_t i = 0; i < Batch::size; ++i) REQUIRE(std::abs(out[i] - fast::log2(in[i])) <= 1e-6f);
+
+    for (size_t i = 0; i < Batch::size; ++i) in[i] = 0.05f + 0.19f * static_cast<float>(i);
+    fast::tan(Batch::load_aligned(in)).store_aligned(out);
+    for (size_t i = 0; i < Batch::size; ++i) REQUIRE(std::abs(out[i] - fast::tan(in[i])) <= 1e-6f * out[i]);
+
+    for (size_t i = 0; i < Batch::size; ++i) in[i] = -3.1f + 1.7f * static_cast<float>(i);
+    fast::exp(Batch::load_aligned(in)).store_aligned(out);
+    for (size_t i = 0; i < Batch::size; ++i) REQUIRE(std::abs(out[i] - fast::exp(in[i])) <= 1e-6f * out[i]);
+    fast::sin(Batch::load_aligned(in)).store_aligned(out);
+    for (size_t i = 0; i < Batch::size; ++i) REQUIRE(std::abs(out[i] - fast::sin(in[i])) <= 1e-6f);
+    fast::tanh(Batch::load_aligned(in)).store_aligned(out);
+    for (size_t i = 0; i < Batch::size; ++i) REQUIRE(std::abs(out[i] - fast::tanh(in[i])) <= 1e-6f);
+}
+
+TEST_CASE("math:: follows APPLAUSE_FAST_MATH for float and stays exact for double", "[dsp][fastmath]")
+{
+    if constexpr (APPLAUSE_FAST_MATH) {
+        REQUIRE(math::sin(1.234f) == fast::sin(1.234f));
+        REQUIRE(math::exp2(3.7f) == fast::exp2(3.7f));
+    } else {
+        REQUIRE(math::sin(1.234f) == std::sin(1.234f));
+        REQUIRE(math::exp2(3.7f) == std::exp2(3.7f));
+    }
+    REQUIRE(math::tanh(0.4) == std::tanh(0.4));
+    REQUIRE(math::log2(10.0) == std::log2(10.0));
+
+    using DoubleBatch = xsimd::batch<double>;
+    REQUIRE(math::exp(DoubleBatch(1.5)).get(0) == xsimd::exp(DoubleBatch(1.5)).get(0));
+}
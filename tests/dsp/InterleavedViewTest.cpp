@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/InterleavedView.h>
+#include <applause/util/SampleType.h>
+
+#include <span>
+#include <vector>
+
+using namespace applause;
+
+TEMPLATE_TEST_CASE("interleave and deinterleave round-trip", "[dsp][buffer]", float, double)
+{
+    using T = TestType;
+    constexpr size_t frames = 37;
+
+    for (size_t channels : {1, 2, 3, 4, 8}) {
+        INFO("channels " << channels);
+        std::vector<T> planar(channels * frames);
+        for (size_t i = 0; i < planar.size(); ++i) planar[i] = static_cast<T>(i);
+        const BufferView<const T, 8> in{planar.data(), channels, frames};
+
+        std::vector<T> interleaved(channels * frames, T{-1});
+        interleave(in, InterleavedView<T>{interleaved.data(), channels, frames});
+        for (size_t ch = 0; ch < channels; ++ch) {
+            for (size_t i = 0; i < frames; ++i) REQUIRE(interleaved[i * channels + ch] == in.load(ch, i));
+        }
+
+        std::vector<T> back(channels * frames, T{-1});
+        const BufferView<T, 8> out{back.data(), channels, frames};
+        deinterleave(InterleavedView<const T>{interleaved.data(), channels, frames}, out);
+        REQUIRE(back == planar);
+    }
+}
+
+TEST_CASE("InterleavedView accessors and sub-views", "[dsp][buffer]")
+{
+    std::vector<float> data(3 * 10);
+    const InterleavedView<float> view{data.data(), 3, 10};
+    REQUIRE(view.numChannels() == 3);
+    REQUIRE(view.numFrames() == 10);
+    REQUIRE(view.numScalars() == 30);
+
+    view.store(2, 4, 5.0f);
+    REQUIRE(data[4 * 3 + 2] == 5.0f);
+    REQUIRE(view.load(2, 4) == 5.0f);
+
+    const InterleavedView<const float> sub = view.getSubView(4, 6);
+    REQUIRE(sub.numFrames() == 2);
+    REQUIRE(sub.framePtr(0) == data.data() + 12);
+    REQUIRE(sub.load(2, 0) == 5.0f);
+
+    view.clear();
+    REQUIRE(view.load(2, 4) == 0.0f);
+}
+
+TEST_CASE("InterleavedView views stereo frames without copying", "[dsp][buffer]")
+{
+    std::vector<StereoSample<float>> frames(5);
+    const InterleavedView<float> view{std::span<StereoSample<float>>(frames)};
+    REQUIRE(view.numChannels() == 2);
+    REQUIRE(view.numFrames() == 5);
+
+    view.store(0, 3, 1.0f);
+    view.store(1, 3, 2.0f);
+    REQUIRE(frames[3].left() == 1.0f);
+    REQUIRE(frames[3].right() == 2.0f);
+
+    const auto stereo = view.stereoFrames();
+    REQUIRE(stereo.data() == frames.data());
+    stereo[1] = StereoSample<float>(3.0f, 4.0f);
+    REQUIRE(view.load(0, 1) == 3.0f);
+    REQUIRE(view.load(1, 1) == 4.0f);
+}
+
+TEMPLATE_TEST_CASE("packLanes and unpackLanes move channels through batch lanes", "[dsp][buffer][simd]", float, double)
+{
+    using T = TestType;
+    using Batch = xsimd::batch<T>;
+    constexpr size_t frames = 19;
+
+    for (size_t channels = 1; channels <= Batch::size; ++channels) {
+        std::vector<T> planar(channels * frames);
+        for (size_t i = 0; i < planar.size(); ++i) planar[i] = static_cast<T>(i + 1);
+        const BufferView<const T, Batch::size> in{planar.data(), channels, frames};
+
+        std::vector<Batch, xsimd::aligned_allocator<Batch>> lanes(frames, Batch(T{-1}));
+        packLanes(in, std::span<Batch>(lanes));
+        for (size_t i = 0; i < frames; ++i) {
+            for (size_t lane = 0; lane < Batch::size; ++lane) {
+                REQUIRE(lanes[i].get(lane) == (lane < channels ? in.load(lane, i) : T{0}));
+            }
+        }
+
+        std::vector<T> back(channels * frames);
+        unpackLanes(std::span<const Batch>(lanes), BufferView<T, Batch::size>{back.data(), channels, frames});
+        REQUIRE(back == planar);
+    }
+}
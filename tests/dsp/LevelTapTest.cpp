@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <applause/dsp/LevelTap.h>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+// Pushes a stereo block holding a constant level on the left and silence on the right
+void pushConstant(LevelTap& tap, float value, std::size_t frames) {
+    std::vector<float> backing(2 * frames, 0.0f);
+    std::fill_n(backing.begin(), frames, value);
+    tap.push(BufferView<const float, 2>(backing.data(), 2, frames));
+}
+}  // namespace
+
+TEST_CASE("LevelTap reports peak and RMS over the newest blocks", "[dsp][meter]") {
+    LevelTap tap(2, 16);
+    std::array<LevelTap::Level, 2> levels{};
+
+    REQUIRE(tap.readLevels(levels, 1024) == 0);
+    CHECK(levels[0].peak == 0.0f);
+
+    SECTION("A single block carries its own peak and RMS") {
+        std::vector<float> backing(64);
+        for (std::size_t i = 0; i < 32; ++i) backing[i] = (i % 2 == 0) ? 0.5f : -1.0f;
+        tap.push(BufferView<const float, 2>(backing.data(), 2, 32));
+        REQUIRE(tap.getBlockCount() == 1);
+        REQUIRE(tap.readLevels(levels, 32) == 32);
+        CHECK(levels[0].peak == 1.0f);
+        CHECK(levels[0].rms == Approx(std::sqrt((0.25 + 1.0) / 2.0)));
+        CHECK(levels[1].peak == 0.0f);
+        CHECK(levels[1].rms == 0.0f);
+    }
+
+    SECTION("The window combines blocks by length") {
+        pushConstant(tap, 1.0f, 64);
+        pushConstant(tap, 0.5f, 32);
+        pushConstant(tap, 0.25f, 32);
+
+        // The newest 64 frames are the two short blocks
+        REQUIRE(tap.readLevels(levels, 64) == 64);
+        CHECK(levels[0].peak == 0.5f);
+        CHECK(levels[0].rms == Approx(std::sqrt((0.25 * 32 + 0.0625 * 32) / 64.0)));
+
+        // Windows round up to whole blocks
+        REQUIRE(tap.readLevels(levels, 65) == 128);
+        CHECK(levels[0].peak == 1.0f);
+        CHECK(levels[0].rms == Approx(std::sqrt((64.0 + 0.25 * 32 + 0.0625 * 32) / 128.0)));
+    }
+
+    SECTION("Old blocks fall out of the history") {
+        pushConstant(tap, 1.0f, 16);
+        for (int i = 0; i < 16; ++i) pushConstant(tap, 0.1f, 16);
+        REQUIRE(tap.readLevels(levels, 1u << 20) == 16 * 16);
+        CHECK(levels[0].peak == 0.1f);
+    }
+}
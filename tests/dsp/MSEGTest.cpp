@@ -1,10 +1,15 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <applause/core/ModMatrix.h>
+#include <applause/dsp/modulation/MSEGBank.h>
 #include <applause/dsp/modulation/MSEGCurve.h>
+#include <applause/dsp/modulation/MSEGCurveHandoff.h>
 #include <applause/dsp/modulation/MSEGModulator.h>
+#include <applause/dsp/modulation/MSEGTable.h>
 
 #include <array>
 #include <cmath>
+#include <vector>
 
 using namespace applause;
 using Catch::Approx;
@@ -122,6 +127,18 @@ TEST_CASE("MSEGCurve power curve", "[dsp][mseg]")
     }
 }
 
+TEST_CASE("MSEGCurve segment evaluation matches evaluate()", "[dsp][mseg]")
+{
+    auto c = makeTriangle();
+    c.curvature_power[0] = 3.0f;
+    c.curvature_power[1] = -2.0f;
+    for (int i = 0; i <= 16; ++i) {
+        const float t = static_cast<float>(i) / 16.0f;
+        REQUIRE(c.evaluateSegment(0, t) == Approx(c.evaluate(0.5f * t)));
+        REQUIRE(c.evaluateSegment(1, t) == Approx(c.evaluate(0.5f + 0.5f * t)));
+    }
+}
+
 TEST_CASE("MSEGModulator phase advancement", "[dsp][mseg]")
 {
     auto curve = makeRamp();
@@ -223,3 +240,247 @@ TEST_CASE("MSEGModulator with triangle curve", "[dsp][mseg]")
     REQUIRE(mod.value() == Approx(0.5f));
 }
 
+TEST_CASE("MSEGModulator processBlock follows the curve sample by sample", "[dsp][mseg]")
+{
+    auto curve = makeTriangle();
+    curve.points[0] = {0.1f, 0.2f};
+    curve.curvature_power[0] = 3.0f;
+    curve.curvature_power[1] = -5.0f;
+
+    // A rate that doesn't divide the sample rate, so segment ends fall between samples
+    MSEGModulator mod(&curve, 1000.0f);
+    mod.setRate(3.7f);
+    const float increment = 3.7f / 1000.0f;
+
+    SECTION("Looping, across several blocks") {
+        float phase = 0.0f;
+        std::vector<float> block(97);
+        for (int b = 0; b < 10; ++b) {
+            mod.processBlock(block.data(), static_cast<int>(block.size()));
+            for (float value : block) {
+                phase += increment;
+                if (phase >= 1.0f) phase = std::fmod(phase, 1.0f);
+                REQUIRE(value == Approx(curve.evaluate(phase)).margin(1e-5));
+            }
+        }
+        REQUIRE(mod.phase() == Approx(phase).margin(1e-6));
+        REQUIRE(mod.value() == block.back());
+    }
+
+    SECTION("One-shot holds the end value") {
+        curve.loop = false;
+        std::vector<float> block(400);
+        mod.processBlock(block.data(), static_cast<int>(block.size()));
+        REQUIRE(mod.phase() == 1.0f);
+        REQUIRE(block.back() == Approx(0.0f));
+        REQUIRE(block[200] == Approx(curve.evaluate(201 * increment)).margin(1e-5));
+    }
+
+    SECTION("Ends where process() does") {
+        MSEGModulator stepped(&curve, 1000.0f);
+        stepped.setRate(3.7f);
+        std::vector<float> block(64);
+        mod.processBlock(block.data(), 64);
+        stepped.process(64);
+        REQUIRE(mod.phase() == Approx(stepped.phase()).margin(1e-6));
+        REQUIRE(mod.value() == Approx(stepped.value()).margin(1e-5));
+    }
+}
+
+TEST_CASE("MSEGTable bakes a curve within its reported error", "[dsp][mseg]")
+{
+    auto curve = makeTriangle();
+    curve.curvature_power[0] = 8.0f;
+
+    MSEGTable table;
+    REQUIRE(table.evaluate(0.5f) == 0.0f);
+
+    const float error = table.bake(curve);
+    REQUIRE(table.getResolution() == MSEGTable::kDefaultResolution);
+    // Mostly the corner at the peak, where the slope jumps from about 16 to -2
+    REQUIRE(error > 0.0f);
+    REQUIRE(error < 5e-3f);
+    for (float phase = 0.0f; phase <= 1.0f; phase += 0.00123f) {
+        REQUIRE(table.evaluate(phase) == Approx(curve.evaluate(phase)).margin(error * 1.01f + 1e-6f));
+    }
+    REQUIRE(table.evaluate(-1.0f) == curve.evaluate(0.0f));
+    REQUIRE(table.evaluate(2.0f) == curve.evaluate(1.0f));
+
+    SECTION("bakeWithin raises the resolution for sharper curves") {
+        REQUIRE(table.bakeWithin(curve, 1e-3f) <= 1e-3f);
+        const size_t gentle = table.getResolution();
+        curve.curvature_power[0] = 30.0f;
+        REQUIRE(table.bakeWithin(curve, 1e-3f) <= 1e-3f);
+        REQUIRE(table.getResolution() > gentle);
+    }
+
+    SECTION("A modulator reads the table instead of the curve") {
+        MSEGModulator mod(&curve, 100.0f);
+        mod.setTable(&table);
+        std::vector<float> block(150);
+        mod.processBlock(block.data(), static_cast<int>(block.size()));
+        REQUIRE(block[24] == Approx(curve.evaluate(0.25f)).margin(1e-4));
+        REQUIRE(mod.phase() == Approx(0.5f).margin(1e-5));
+        REQUIRE(mod.process(25) == Approx(curve.evaluate(0.75f)).margin(1e-4));
+    }
+}
+
+TEST_CASE("MSEGCurveHandoff swaps edited curves in at block boundaries", "[dsp][mseg]")
+{
+    MSEGCurveHandoff handoff;
+    MSEGModulator mod(nullptr, 100.0f);
+    mod.setHandoff(&handoff);
+    REQUIRE(mod.process(25) == 0.0f);
+
+    auto curve = makeRamp();
+    handoff.publish(curve);
+    // Not picked up until the audio thread's update()
+    REQUIRE(mod.process(25) == 0.0f);
+
+    REQUIRE(handoff.update());
+    REQUIRE_FALSE(handoff.update());
+    REQUIRE(handoff.get().table.isBaked());
+    REQUIRE(mod.process(25) == Approx(0.75f).margin(1e-4));
+
+    SECTION("Editing the UI copy doesn't touch the published one") {
+        curve.points[1] = {1.0f, 0.0f};
+        REQUIRE(mod.process(0) == Approx(0.75f).margin(1e-4));
+
+        handoff.publish(curve, 0);
+        handoff.update();
+        handoff.collect();
+        REQUIRE_FALSE(handoff.get().table.isBaked());
+        REQUIRE(mod.process(0) == Approx(0.0f).margin(1e-4));
+    }
+
+    SECTION("Transport sync picks up the current curve before reading it") {
+        MSEGModulator synced(nullptr, 100.0f);
+        synced.setHandoff(&handoff);
+        synced.setSyncMode(MSEGSync::Transport);
+        synced.setSyncLength(4.0);
+
+        clap_event_transport_t transport{};
+        transport.flags = CLAP_TRANSPORT_HAS_TEMPO | CLAP_TRANSPORT_HAS_BEATS_TIMELINE | CLAP_TRANSPORT_IS_PLAYING;
+        transport.tempo = 120.0;
+        transport.song_pos_beats = 2 * CLAP_BEATTIME_FACTOR;
+        synced.syncToTransport(&transport);
+        REQUIRE(synced.phase() == Approx(0.5f));
+    }
+}
+
+TEST_CASE("MSEGModulator sync modes follow the host timeline", "[dsp][mseg]")
+{
+    auto curve = makeRamp();
+    MSEGModulator mod(&curve, 48000.0f);
+    mod.setSyncLength(4.0);
+
+    clap_event_transport_t transport{};
+    transport.flags = CLAP_TRANSPORT_HAS_TEMPO | CLAP_TRANSPORT_HAS_BEATS_TIMELINE | CLAP_TRANSPORT_IS_PLAYING;
+    transport.tempo = 120.0;
+    const auto at_beat = [&](double beat) {
+        transport.song_pos_beats = static_cast<clap_beattime>(beat * static_cast<double>(CLAP_BEATTIME_FACTOR));
+        mod.syncToTransport(&transport);
+    };
+
+    SECTION("Transport: phase is the song position over the cycle length") {
+        mod.setSyncMode(MSEGSync::Transport);
+        at_beat(5.5);
+        REQUIRE(mod.phase() == Approx(0.375f));
+
+        // Half a second at 120 bpm is one beat
+        REQUIRE(mod.process(24000) == Approx(0.625f));
+
+        // Seeks are followed at the next block, and retriggers are ignored
+        at_beat(2.0);
+        mod.retrigger();
+        REQUIRE(mod.phase() == Approx(0.5f));
+
+        // Stopped: runs on at the last tempo
+        transport.flags = CLAP_TRANSPORT_HAS_BEATS_TIMELINE;
+        at_beat(0.0);
+        mod.process(24000);
+        REQUIRE(mod.phase() == Approx(0.75f));
+    }
+
+    SECTION("Tempo: cycles count from the last retrigger") {
+        mod.setSyncMode(MSEGSync::Tempo);
+        at_beat(5.5);
+        REQUIRE(mod.phase() == 0.0f);
+
+        std::vector<float> block(12000);
+        for (int b = 0; b < 10; ++b) mod.processBlock(block.data(), static_cast<int>(block.size()));
+        // 10 * 12000 samples = 2.5 s = 5 beats
+        REQUIRE(mod.phase() == Approx(0.25f).margin(1e-6));
+        REQUIRE(block.back() == Approx(0.25f).margin(1e-4));
+
+        transport.tempo = 60.0;
+        at_beat(0.0);
+        mod.retrigger();
+        mod.process(48000);
+        REQUIRE(mod.phase() == Approx(0.25f));
+    }
+
+    SECTION("Free mode ignores the transport") {
+        mod.setRate(1.0f);
+        at_beat(5.5);
+        REQUIRE(mod.phase() == 0.0f);
+        mod.process(12000);
+        REQUIRE(mod.phase() == Approx(0.25f));
+    }
+}
+
+TEST_CASE("MSEGBank evaluates every active voice", "[dsp][mseg]")
+{
+    constexpr size_t kVoices = 7;
+    auto curve = makeTriangle();
+    curve.curvature_power[1] = 2.0f;
+    MSEGTable table;
+    table.bake(curve);
+
+    for (bool use_table : {false, true}) {
+        MSEGBank<kVoices> bank(&curve, 100.0f);
+        if (use_table) bank.setTable(&table);
+        for (size_t v = 0; v < kVoices; ++v) bank.setRate(v, 0.5f + 0.1f * static_cast<float>(v));
+        for (size_t v = 0; v < kVoices; v += 2) bank.noteOn(v);
+
+        for (int block = 0; block < 5; ++block) bank.process(37);
+        for (size_t v = 0; v < kVoices; ++v) {
+            if (!bank.isActive(v)) {
+                CHECK(bank.value(v) == 0.0f);
+                continue;
+            }
+            const float rate = 0.5f + 0.1f * static_cast<float>(v);
+            CHECK(bank.phase(v) == Approx(std::fmod(rate * 185.0f / 100.0f, 1.0f)).margin(1e-5));
+            CHECK(bank.value(v) == Approx(curve.evaluate(bank.phase(v))).margin(use_table ? 2e-3 : 1e-6));
+        }
+    }
+}
+
+TEST_CASE("MSEGBank writes straight into the ModMatrix source row", "[dsp][mseg]")
+{
+    constexpr size_t kVoices = 7;
+    auto curve = makeRamp();
+    MSEGBank<kVoices> bank(&curve, 100.0f);
+    for (size_t v = 0; v < kVoices; ++v) {
+        bank.setRate(v, static_cast<float>(v + 1));
+        bank.noteOn(v);
+    }
+    bank.process(7);
+
+    for (auto layout : {ModVoiceLayout::VoiceRows, ModVoiceLayout::VoiceLanes}) {
+        ModMatrix matrix({10, 4, 4, 4, layout});
+        auto& src = matrix.registerSource("mseg", ModSrcType::Poly);
+        auto& dst = matrix.registerDestination("dst", ModDstMode::Poly);
+        matrix.addConnection(src, dst, 1.0f, false);
+        matrix.setBaseValue(dst.index, 0.0f);
+        for (uint16_t v = 0; v < 10; ++v) matrix.notifyVoiceOn(v);
+
+        bank.writeTo(matrix, src.index, 2);
+        matrix.process();
+        CHECK(matrix.getPolyModValue(dst.index, 0) == 0.0f);
+        for (size_t v = 0; v < kVoices; ++v) {
+            const auto voice = static_cast<uint16_t>(v + 2);
+            CHECK(matrix.getPolyModValue(dst.index, voice) == Approx(bank.value(v)).margin(1e-6));
+        }
+    }
+}
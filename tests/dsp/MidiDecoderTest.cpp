@@ -0,0 +1,247 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/dsp/MidiDecoder.h>
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+
+clap_event_midi_t midi1(uint8_t status, uint8_t data1, uint8_t data2, uint32_t time = 7, uint16_t port = 1) {
+    clap_event_midi_t e{};
+    e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_MIDI, 0};
+    e.port_index = port;
+    e.data[0] = status;
+    e.data[1] = data1;
+    e.data[2] = data2;
+    return e;
+}
+
+clap_event_midi2_t midi2(uint32_t word0, uint32_t word1, uint32_t time = 7, uint16_t port = 1) {
+    clap_event_midi2_t e{};
+    e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_MIDI2, 0};
+    e.port_index = port;
+    e.data[0] = word0;
+    e.data[1] = word1;
+    return e;
+}
+
+using Decoded = std::variant<std::monostate, clap_event_note_t, clap_event_note_expression_t>;
+
+// Decodes one event, expecting at most one translated event back
+template <typename Event>
+Decoded decode(MidiDecoder& decoder, const Event& event) {
+    Decoded result;
+    int calls = 0;
+    decoder.decode(event.header, [&](const clap_event_header_t& header) {
+        ++calls;
+        if (header.type == CLAP_EVENT_NOTE_EXPRESSION) {
+            result = reinterpret_cast<const clap_event_note_expression_t&>(header);
+        } else {
+            result = reinterpret_cast<const clap_event_note_t&>(header);
+        }
+    });
+    REQUIRE(calls <= 1);
+    return result;
+}
+
+template <typename Event>
+clap_event_note_t decodeNote(MidiDecoder& decoder, const Event& event) {
+    const Decoded decoded = decode(decoder, event);
+    REQUIRE(std::holds_alternative<clap_event_note_t>(decoded));
+    return std::get<clap_event_note_t>(decoded);
+}
+
+template <typename Event>
+clap_event_note_expression_t decodeExpression(MidiDecoder& decoder, const Event& event) {
+    const Decoded decoded = decode(decoder, event);
+    REQUIRE(std::holds_alternative<clap_event_note_expression_t>(decoded));
+    return std::get<clap_event_note_expression_t>(decoded);
+}
+
+// Decodes one event into however many expressions it becomes
+template <typename Event>
+std::vector<clap_event_note_expression_t> decodeExpressions(MidiDecoder& decoder, const Event& event) {
+    std::vector<clap_event_note_expression_t> result;
+    decoder.decode(event.header, [&](const clap_event_header_t& header) {
+        REQUIRE(header.type == CLAP_EVENT_NOTE_EXPRESSION);
+        result.push_back(reinterpret_cast<const clap_event_note_expression_t&>(header));
+    });
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("MidiDecoder translates MIDI 1.0 notes", "[midi]")
+{
+    MidiDecoder decoder;
+
+    const auto on = decodeNote(decoder, midi1(0x93, 60, 127));
+    CHECK(on.header.type == CLAP_EVENT_NOTE_ON);
+    CHECK(on.header.time == 7);
+    CHECK(on.header.size == sizeof(clap_event_note_t));
+    CHECK(on.port_index == 1);
+    CHECK(on.channel == 3);
+    CHECK(on.key == 60);
+    CHECK(on.note_id == -1);
+    CHECK(on.velocity == 1.0);
+
+    // A note on with velocity 0 is a note off
+    CHECK(decodeNote(decoder, midi1(0x93, 60, 0)).header.type == CLAP_EVENT_NOTE_OFF);
+    const auto off = decodeNote(decoder, midi1(0x83, 60, 64));
+    CHECK(off.header.type == CLAP_EVENT_NOTE_OFF);
+    CHECK(off.velocity == Approx(64 / 127.0));
+
+    CHECK(MidiDecoder::isNoteOn(midi1(0x90, 60, 1).header));
+    CHECK_FALSE(MidiDecoder::isNoteOn(midi1(0x90, 60, 0).header));
+    CHECK_FALSE(MidiDecoder::isNoteOn(midi1(0x80, 60, 1).header));
+
+    // All Notes Off and All Sound Off address every key on the channel
+    const auto all_off = decodeNote(decoder, midi1(0xB2, 123, 0));
+    CHECK(all_off.header.type == CLAP_EVENT_NOTE_OFF);
+    CHECK(all_off.key == -1);
+    CHECK(all_off.channel == 2);
+    CHECK(decodeNote(decoder, midi1(0xB2, 120, 0)).header.type == CLAP_EVENT_NOTE_CHOKE);
+}
+
+TEST_CASE("MidiDecoder translates MIDI 1.0 controllers into expressions", "[midi]")
+{
+    MidiDecoder decoder;
+
+    SECTION("Pitch bend scales by the bend range") {
+        const auto up = decodeExpression(decoder, midi1(0xE1, 0x7F, 0x7F));
+        CHECK(up.expression_id == CLAP_NOTE_EXPRESSION_TUNING);
+        CHECK(up.channel == 1);
+        CHECK(up.key == -1);
+        CHECK(up.value == Approx(2.0 * 8191 / 8192));
+        CHECK(decodeExpression(decoder, midi1(0xE1, 0, 0x40)).value == 0.0);
+        CHECK(decodeExpression(decoder, midi1(0xE1, 0, 0)).value == -2.0);
+
+        decoder.setConfig({.pitch_bend_range = 12.0});
+        CHECK(decodeExpression(decoder, midi1(0xE1, 0, 0)).value == -12.0);
+    }
+
+    SECTION("Pressure and timbre") {
+        const auto channel = decodeExpression(decoder, midi1(0xD4, 127, 0));
+        CHECK(channel.expression_id == CLAP_NOTE_EXPRESSION_PRESSURE);
+        CHECK(channel.key == -1);
+        CHECK(channel.value == 1.0);
+
+        const auto poly = decodeExpression(decoder, midi1(0xA4, 61, 0));
+        CHECK(poly.expression_id == CLAP_NOTE_EXPRESSION_PRESSURE);
+        CHECK(poly.key == 61);
+        CHECK(poly.value == 0.0);
+
+        CHECK(decodeExpression(decoder, midi1(0xB4, 74, 127)).expression_id == CLAP_NOTE_EXPRESSION_BRIGHTNESS);
+        CHECK(decodeExpression(decoder, midi1(0xB4, 11, 127)).expression_id == CLAP_NOTE_EXPRESSION_EXPRESSION);
+    }
+
+    SECTION("Messages without a CLAP counterpart are ignored") {
+        CHECK(std::holds_alternative<std::monostate>(decode(decoder, midi1(0xB0, 1, 64))));  // mod wheel
+        CHECK(std::holds_alternative<std::monostate>(decode(decoder, midi1(0xC0, 5, 0))));  // program change
+        CHECK(std::holds_alternative<std::monostate>(decode(decoder, midi1(0xF8, 0, 0))));  // clock
+    }
+}
+
+TEST_CASE("MidiDecoder applies MPE zones", "[midi][mpe]")
+{
+    MidiDecoder decoder({.pitch_bend_range = 2.0, .mpe = true, .mpe_pitch_bend_range = 48.0});
+
+    // Member channels bend by the per-note range and shape only their own notes
+    const auto member = decodeExpression(decoder, midi1(0xE5, 0, 0));
+    CHECK(member.value == -48.0);
+    CHECK(member.channel == 5);
+
+    // The master channel bends by the zone range, on top of every channel's own bend
+    const auto master = decodeExpressions(decoder, midi1(0xE0, 0, 0));
+    REQUIRE(master.size() == 16);
+    for (const auto& e : master) {
+        CHECK(e.channel >= 0);
+        CHECK(e.key == -1);
+        CHECK(e.value == (e.channel == 5 ? -50.0 : -2.0));
+    }
+
+    // Later member bends keep the master's
+    CHECK(decodeExpression(decoder, midi1(0xE5, 0, 0x40)).value == -2.0);
+
+    // Master pressure adds to the member's, up to full pressure
+    decodeExpression(decoder, midi1(0xD3, 100, 0));
+    for (const auto& e : decodeExpressions(decoder, midi1(0xD0, 64, 0))) {
+        if (e.channel == 3) CHECK(e.value == 1.0);
+        if (e.channel == 4) CHECK(e.value == Approx(64 / 127.0));
+    }
+
+    // Master CC 74 offsets the member's brightness from the centre
+    decodeExpression(decoder, midi1(0xB3, 74, 32));
+    for (const auto& e : decodeExpressions(decoder, midi1(0xB0, 74, 127))) {
+        if (e.channel == 3) CHECK(e.value == Approx(32 / 127.0 + 0.5));
+    }
+
+    // Other master channel expressions still reach every channel at once
+    CHECK(decodeExpression(decoder, midi1(0xB0, 11, 127)).channel == -1);
+
+    // A new config starts from neutral channels
+    decoder.setConfig(decoder.getConfig());
+    CHECK(decodeExpression(decoder, midi1(0xE5, 0, 0x40)).value == 0.0);
+
+    // Notes keep their channel either way
+    CHECK(decodeNote(decoder, midi1(0x90, 60, 100)).channel == 0);
+}
+
+TEST_CASE("MidiDecoder translates MIDI 2.0 channel voice messages", "[midi][midi2]")
+{
+    MidiDecoder decoder;
+
+    const auto on = decodeNote(decoder, midi2(0x40923C00, 0xFFFF0000));
+    CHECK(on.header.type == CLAP_EVENT_NOTE_ON);
+    CHECK(on.channel == 2);
+    CHECK(on.key == 60);
+    CHECK(on.velocity == 1.0);
+    CHECK(MidiDecoder::isNoteOn(midi2(0x40923C00, 0).header));
+
+    const auto off = decodeNote(decoder, midi2(0x40823C00, 0x80000000));
+    CHECK(off.header.type == CLAP_EVENT_NOTE_OFF);
+    CHECK(off.velocity == Approx(0x8000 / 65535.0));
+
+    const auto bend = decodeExpression(decoder, midi2(0x40E20000, 0));
+    CHECK(bend.expression_id == CLAP_NOTE_EXPRESSION_TUNING);
+    CHECK(bend.value == -2.0);
+    CHECK(decodeExpression(decoder, midi2(0x40E20000, 0x80000000)).value == 0.0);
+
+    const auto per_note_bend = decodeExpression(decoder, midi2(0x40623C00, 0xC0000000));
+    CHECK(per_note_bend.key == 60);
+    CHECK(per_note_bend.value == 24.0);
+
+    const auto poly_pressure = decodeExpression(decoder, midi2(0x40A23C00, 0xFFFFFFFF));
+    CHECK(poly_pressure.expression_id == CLAP_NOTE_EXPRESSION_PRESSURE);
+    CHECK(poly_pressure.key == 60);
+    CHECK(poly_pressure.value == 1.0);
+
+    SECTION("Registered per-note controllers") {
+        // Pitch 7.25 of 61.5 semitones on key 60 is a tuning of 1.5
+        const auto pitch = decodeExpression(decoder, midi2(0x40023C03, static_cast<uint32_t>(61.5 * 33554432.0)));
+        CHECK(pitch.expression_id == CLAP_NOTE_EXPRESSION_TUNING);
+        CHECK(pitch.value == Approx(1.5));
+        CHECK(decodeExpression(decoder, midi2(0x40023C0A, 0)).expression_id == CLAP_NOTE_EXPRESSION_PAN);
+        CHECK(decodeExpression(decoder, midi2(0x40023C4A, 0)).expression_id == CLAP_NOTE_EXPRESSION_BRIGHTNESS);
+    }
+
+    SECTION("MIDI 1.0 messages in a UMP") {
+        const auto wrapped = decodeNote(decoder, midi2(0x20933C7F, 0));
+        CHECK(wrapped.header.type == CLAP_EVENT_NOTE_ON);
+        CHECK(wrapped.channel == 3);
+        CHECK(wrapped.key == 60);
+        CHECK(MidiDecoder::isNoteOn(midi2(0x20933C7F, 0).header));
+        CHECK_FALSE(MidiDecoder::isNoteOn(midi2(0x20933C00, 0).header));
+    }
+
+    SECTION("Other packet types are ignored") {
+        CHECK(std::holds_alternative<std::monostate>(decode(decoder, midi2(0x10F80000, 0))));  // system
+        CHECK(std::holds_alternative<std::monostate>(decode(decoder, midi2(0x30000000, 0))));  // sysex
+    }
+}
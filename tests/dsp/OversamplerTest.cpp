@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/Oversampler.h>
+#include <applause/util/MemoryArena.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr double kSampleRate = 48000.0;
+constexpr size_t kMaxFrames = 256;
+
+double sine(double frequency, double frame) { return std::sin(2.0 * M_PI * frequency * frame / kSampleRate); }
+
+struct Fixture {
+    std::vector<std::byte> storage;
+    MemoryArena arena;
+    Oversampler<float, 2> oversampler;
+
+    explicit Fixture(size_t factor, size_t channels = 2)
+        : storage(Oversampler<float, 2>::requiredArenaBytes(factor, channels, kMaxFrames)),
+          arena(storage.data(), storage.size()),
+          oversampler(factor) {
+        oversampler.activate(arena, channels, kMaxFrames);
+    }
+};
+}  // namespace
+
+TEST_CASE("Oversampler round trip delays the signal by its latency", "[dsp][oversampler]") {
+    for (size_t factor : {1u, 2u, 4u, 8u}) {
+        Fixture fixture(factor);
+        auto& oversampler = fixture.oversampler;
+        const double latency = oversampler.getExactLatency();
+        CHECK(oversampler.getLatency() == static_cast<uint32_t>(std::lround(latency)));
+        if (factor == 1) CHECK(latency == 0.0);
+
+        // Odd block sizes exercise the scalar tails; the channels carry different frequencies
+        constexpr size_t kFrames = 2000;
+        std::vector<float> signal(2 * kFrames);
+        for (size_t i = 0; i < kFrames; ++i) {
+            signal[i] = static_cast<float>(sine(440.0, static_cast<double>(i)));
+            signal[kFrames + i] = static_cast<float>(sine(3000.0, static_cast<double>(i)));
+        }
+        std::vector<float> output = signal;
+        for (size_t start = 0; start < kFrames;) {
+            const size_t length = std::min<size_t>({kMaxFrames - 3, kFrames - start, 37 + start % 200});
+            std::array<float*, 2> channels{output.data() + start, output.data() + kFrames + start};
+            BufferView<float, 2> block(channels.data(), 2, length);
+            oversampler.process(block, [&](BufferView<float, 2> oversampled) {
+                REQUIRE(oversampled.numFrames() == length * factor);
+            });
+            start += length;
+        }
+
+        // Past the filters' settling time, the output is the input delayed by the exact latency
+        for (size_t i = 200; i < kFrames; ++i) {
+            const double t = static_cast<double>(i) - latency;
+            REQUIRE(output[i] == Approx(sine(440.0, t)).margin(2e-3));
+            REQUIRE(output[kFrames + i] == Approx(sine(3000.0, t)).margin(2e-3));
+        }
+    }
+}
+
+TEST_CASE("Oversampler upsamples without images and rejects content above Nyquist", "[dsp][oversampler]") {
+    constexpr size_t kFactor = 4;
+    Fixture fixture(kFactor, 1);
+    auto& oversampler = fixture.oversampler;
+
+    std::vector<float> input(kMaxFrames);
+    for (size_t i = 0; i < kMaxFrames; ++i) input[i] = static_cast<float>(sine(1000.0, static_cast<double>(i)));
+    BufferView<float, 2> view(input.data(), 1, kMaxFrames);
+
+    SECTION("The oversampled signal is the same sine at the higher rate") {
+        const auto up = oversampler.upsample(view);
+        // The upsampling half of the latency, in base-rate samples
+        const double delay = oversampler.getExactLatency() / 2.0;
+        for (size_t i = 100 * kFactor; i < up.numFrames(); ++i) {
+            const double t = static_cast<double>(i) / kFactor - delay;
+            REQUIRE(up.channelSamples(0)[i] == Approx(sine(1000.0, t)).margin(2e-3));
+        }
+    }
+
+    SECTION("A tone generated at the oversampled rate above base Nyquist is filtered out") {
+        auto up = oversampler.upsample(view);
+        for (size_t i = 0; i < up.numFrames(); ++i) {
+            up.channelSamples(0)[i] = static_cast<float>(sine(40000.0, static_cast<double>(i) / kFactor));
+        }
+        oversampler.downsample(view);
+        for (size_t i = 100; i < kMaxFrames; ++i) REQUIRE(std::abs(input[i]) < 1e-3f);
+    }
+}
+
+TEST_CASE("Oversampler::reset clears the filter state", "[dsp][oversampler]") {
+    Fixture fixture(8, 1);
+    std::vector<float> buffer(kMaxFrames, 1.0f);
+    BufferView<float, 2> view(buffer.data(), 1, kMaxFrames);
+    fixture.oversampler.process(view, [](BufferView<float, 2>) {});
+    CHECK(buffer.back() == Approx(1.0f).margin(1e-4));
+
+    fixture.oversampler.reset();
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    fixture.oversampler.process(view, [](BufferView<float, 2>) {});
+    CHECK(std::all_of(buffer.begin(), buffer.end(), [](float x) { return x == 0.0f; }));
+}
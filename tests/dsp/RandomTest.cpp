@@ -0,0 +1,153 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/Random.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <xsimd/xsimd.hpp>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr size_t kLanes = NoiseGenerator::kLanes;
+
+using Fill = void (*)(NoiseGenerator&, BufferView<float, 2>&);
+
+// Fills channels x frames of noise as a run of blocks of the given sizes, cycled
+std::vector<float> render(NoiseGenerator& noise, size_t channels, size_t frames, std::vector<size_t> blocks,
+                          Fill fill) {
+    std::vector<float> out(channels * frames);
+    std::vector<float> block;
+    for (size_t first = 0, b = 0; first < frames; ++b) {
+        const size_t count = std::min(blocks[b % blocks.size()], frames - first);
+        block.assign(channels * count, 0.0f);
+        BufferView<float, 2> view{block.data(), channels, count};
+        fill(noise, view);
+        for (size_t ch = 0; ch < channels; ++ch) {
+            std::copy_n(block.data() + ch * count, count, out.data() + ch * frames + first);
+        }
+        first += count;
+    }
+    return out;
+}
+
+const Fill uniformFill = [](NoiseGenerator& noise, BufferView<float, 2>& view) { noise.fillUniform(view); };
+const Fill gaussianFill = [](NoiseGenerator& noise, BufferView<float, 2>& view) { noise.fillGaussian(view); };
+const Fill pinkFill = [](NoiseGenerator& noise, BufferView<float, 2>& view) { noise.fillPink(view); };
+
+struct Moments {
+    double mean = 0.0;
+    double variance = 0.0;
+    double lag1 = 0.0;  // Autocorrelation at one sample
+};
+
+Moments moments(const float* values, size_t count) {
+    Moments m;
+    for (size_t i = 0; i < count; ++i) m.mean += values[i];
+    m.mean /= static_cast<double>(count);
+    double covariance = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const double d = values[i] - m.mean;
+        m.variance += d * d;
+        if (i > 0) covariance += d * (values[i - 1] - m.mean);
+    }
+    m.lag1 = covariance / m.variance;
+    m.variance /= static_cast<double>(count);
+    return m;
+}
+}  // namespace
+
+TEST_CASE("NoiseGenerator streams are deterministic and independent", "[dsp][random]") {
+    NoiseGenerator a{2, 42};
+    NoiseGenerator b{2, 42};
+    const auto first = render(a, 2, 256, {256}, uniformFill);
+    CHECK(render(b, 2, 256, {256}, uniformFill) == first);
+
+    // Channels, seeds and streams all differ
+    CHECK(!std::equal(first.begin(), first.begin() + 256, first.begin() + 256));
+    NoiseGenerator other_seed{2, 43};
+    CHECK(render(other_seed, 2, 256, {256}, uniformFill) != first);
+    NoiseGenerator other_voice{2, 42, 2};
+    CHECK(render(other_voice, 2, 256, {256}, uniformFill) != first);
+
+    // The second channel of one generator is the first stream of the next voice's
+    NoiseGenerator shifted{1, 42, 1};
+    const auto second = render(shifted, 1, 256, {256}, uniformFill);
+    CHECK(std::equal(second.begin(), second.end(), first.begin() + 256));
+
+    a.reset();
+    CHECK(render(a, 2, 256, {256}, uniformFill) == first);
+}
+
+TEST_CASE("NoiseGenerator doesn't depend on how a stream is cut into blocks", "[dsp][random]") {
+    for (const Fill fill : {uniformFill, gaussianFill, pinkFill}) {
+        NoiseGenerator whole{2, 7};
+        NoiseGenerator split{2, 7};
+        CHECK(render(split, 2, 1000, {1, 7, 33, 64, 3, 0}, fill) == render(whole, 2, 1000, {1000}, fill));
+    }
+}
+
+TEST_CASE("NoiseGenerator distributions", "[dsp][random]") {
+    constexpr size_t kCount = 1 << 16;
+    NoiseGenerator noise{1, 1234};
+
+    SECTION("uniform") {
+        const auto values = render(noise, 1, kCount, {512}, uniformFill);
+        CHECK(*std::min_element(values.begin(), values.end()) >= -1.0f);
+        CHECK(*std::max_element(values.begin(), values.end()) < 1.0f);
+        const auto m = moments(values.data(), kCount);
+        CHECK(m.mean == Approx(0.0).margin(0.01));
+        CHECK(m.variance == Approx(1.0 / 3.0).epsilon(0.02));
+        CHECK(std::abs(m.lag1) < 0.02);
+    }
+
+    SECTION("gaussian") {
+        const auto values = render(noise, 1, kCount, {512}, gaussianFill);
+        const auto m = moments(values.data(), kCount);
+        CHECK(m.mean == Approx(0.0).margin(0.02));
+        CHECK(m.variance == Approx(1.0).epsilon(0.03));
+        CHECK(std::abs(m.lag1) < 0.02);
+        size_t within_one_sigma = 0;
+        for (float v : values) within_one_sigma += std::abs(v) < 1.0f ? 1 : 0;
+        CHECK(static_cast<double>(within_one_sigma) / kCount == Approx(0.6827).margin(0.01));
+    }
+
+    SECTION("pink has white's level, but its power leans to the low end") {
+        const auto values = render(noise, 1, kCount, {512}, pinkFill);
+        const auto m = moments(values.data(), kCount);
+        CHECK(std::sqrt(m.variance) == Approx(std::sqrt(1.0 / 3.0)).epsilon(0.1));
+        CHECK(m.lag1 > 0.5);
+    }
+}
+
+TEST_CASE("NoiseGenerator fills double and per-voice batch buffers", "[dsp][random]") {
+    NoiseGenerator floats{1, 99};
+    const auto reference = render(floats, 1, 64, {64}, gaussianFill);
+
+    NoiseGenerator doubles{1, 99};
+    std::vector<double> values(64);
+    BufferView<double, 1> view{values.data(), 1, 64};
+    doubles.fillGaussian(view);
+    for (size_t i = 0; i < 64; ++i) REQUIRE(values[i] == static_cast<double>(reference[i]));
+
+    // One voice per lane: frame f of every voice comes from step f of its lane
+    using Batch = xsimd::batch<float>;
+    NoiseGenerator voices{1, 99};
+    alignas(Batch) std::array<float, 64 * kLanes> lanes{};
+    BufferView<Batch, 1> batches{lanes.data(), 1, 64};
+    voices.fillUniform(batches, 0.5f);
+
+    XoshiroBatch rng{99, 0};
+    for (size_t frame = 0; frame < 64; ++frame) {
+        alignas(Batch) std::array<float, kLanes> expected;
+        (rng.bipolar() * Batch(0.5f)).store_aligned(expected.data());
+        for (size_t lane = 0; lane < kLanes; ++lane) REQUIRE(lanes[frame * kLanes + lane] == expected[lane]);
+    }
+}
@@ -0,0 +1,230 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <applause/dsp/sampler/SampleStreamer.h>
+#include <applause/dsp/sampler/StreamingSample.h>
+#include <applause/dsp/sampler/StreamingSampleVoice.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+namespace fs = std::filesystem;
+
+namespace {
+
+// A temporary file, removed with the object
+struct TempFile {
+    fs::path path = fs::temp_directory_path() / ("applause-sample-" + std::to_string(std::random_device{}()));
+    ~TempFile() { fs::remove(path); }
+};
+
+void put16(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t value) {
+    put16(out, value & 0xffff);
+    put16(out, value >> 16);
+}
+
+// Writes interleaved samples as a WAV file with the given format tag and bit depth
+void writeWav(const fs::path& path, const std::vector<float>& interleaved, uint16_t channels, uint16_t tag,
+              uint16_t bits) {
+    std::vector<uint8_t> data;
+    for (const float x : interleaved) {
+        if (tag == 3) {
+            uint32_t bitsOf;
+            std::memcpy(&bitsOf, &x, 4);
+            put32(data, bitsOf);
+        } else if (bits == 16) {
+            put16(data, static_cast<uint16_t>(static_cast<int16_t>(x * 32767.0f)));
+        } else {
+            const auto s = static_cast<uint32_t>(static_cast<int32_t>(x * 8388607.0f));
+            data.push_back(static_cast<uint8_t>(s));
+            data.push_back(static_cast<uint8_t>(s >> 8));
+            data.push_back(static_cast<uint8_t>(s >> 16));
+        }
+    }
+
+    std::vector<uint8_t> file{'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E'};
+    // An unrelated chunk with an odd size first, to exercise chunk padding
+    file.insert(file.end(), {'L', 'I', 'S', 'T'});
+    put32(file, 3);
+    file.insert(file.end(), {'a', 'b', 'c', 0});
+    file.insert(file.end(), {'f', 'm', 't', ' '});
+    put32(file, 16);
+    put16(file, tag);
+    put16(file, channels);
+    put32(file, 48000);
+    put32(file, 48000u * channels * bits / 8);
+    put16(file, static_cast<uint16_t>(channels * bits / 8));
+    put16(file, bits);
+    file.insert(file.end(), {'d', 'a', 't', 'a'});
+    put32(file, static_cast<uint32_t>(data.size()));
+    file.insert(file.end(), data.begin(), data.end());
+
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()),
+                                                static_cast<std::streamsize>(file.size()));
+}
+
+std::vector<float> ramp(size_t frames) {
+    std::vector<float> values(frames);
+    for (size_t i = 0; i < frames; ++i) values[i] = static_cast<float>(i % 1000) / 1000.0f - 0.5f;
+    return values;
+}
+
+}  // namespace
+
+TEST_CASE("StreamingSample reads WAV files and keeps their head resident", "[dsp][sampler]") {
+    TempFile file;
+    std::vector<float> stereo;
+    for (int i = 0; i < 300; ++i) {
+        stereo.push_back(static_cast<float>(i) / 400.0f);
+        stereo.push_back(-static_cast<float>(i) / 400.0f);
+    }
+
+    for (const auto& [tag, bits, tolerance] : {std::tuple{1, 16, 1e-4}, {1, 24, 1e-6}, {3, 32, 0.0}}) {
+        INFO("format " << tag << ", " << bits << " bits");
+        writeWav(file.path, stereo, 2, static_cast<uint16_t>(tag), static_cast<uint16_t>(bits));
+
+        StreamingSample sample;
+        REQUIRE(sample.open(file.path, 100));
+        CHECK(sample.numFrames() == 300);
+        CHECK(sample.numChannels() == 2);
+        CHECK(sample.sampleRate() == 48000.0);
+        CHECK(sample.headFrames() == 100);
+        CHECK(sample.head(0)[50] == Approx(50.0f / 400.0f).margin(tolerance));
+        CHECK(sample.head(1)[99] == Approx(-99.0f / 400.0f).margin(tolerance));
+
+        std::vector<float> left(10), right(10);
+        float* out[] = {left.data(), right.data()};
+        CHECK(sample.decode(295, 10, out, 2) == 5);
+        CHECK(left[4] == Approx(299.0f / 400.0f).margin(tolerance));
+        CHECK(right[0] == Approx(-295.0f / 400.0f).margin(tolerance));
+    }
+
+    std::ofstream(file.path, std::ios::binary) << "not a wav file";
+    StreamingSample broken;
+    CHECK_FALSE(broken.open(file.path));
+    CHECK_FALSE(broken.isOpen());
+}
+
+TEST_CASE("SampleStream plays the head at once and the rest as the streamer fetches it", "[dsp][sampler]") {
+    TempFile file;
+    const auto source = ramp(10000);
+    writeWav(file.path, source, 1, 3, 32);
+    StreamingSample sample;
+    REQUIRE(sample.open(file.path, 1000));
+
+    SampleStreamer streamer({.num_streams = 2, .max_channels = 2, .ring_frames = 1024, .chunk_frames = 256});
+    SampleStream& stream = streamer.stream(0);
+    std::vector<float> block(64);
+    float* out[] = {block.data()};
+
+    SECTION("Starting plays the head before anything is fetched") {
+        stream.start(sample);
+        for (size_t first = 0; first + 64 <= 1000; first += 64) {
+            REQUIRE(stream.read(first, 64, out, 1));
+            REQUIRE(block[7] == source[first + 7]);
+        }
+        // Past the head without a pass of the streamer: an underrun, played as silence
+        CHECK_FALSE(stream.read(1000, 64, out, 1));
+        CHECK(block[0] == 0.0f);
+        CHECK(stream.getUnderruns() == 1);
+        CHECK(streamer.getUnderruns() == 1);
+    }
+
+    SECTION("With the streamer keeping up, every frame arrives") {
+        stream.start(sample);
+        for (size_t first = 0; first < 10000; first += 64) {
+            streamer.service();
+            REQUIRE(stream.read(first, 64, out, 1));
+            for (size_t i = 0; i < 64 && first + i < 10000; ++i) REQUIRE(block[i] == source[first + i]);
+        }
+        CHECK(stream.getUnderruns() == 0);
+        // Past the end: silence, and nothing left to fetch
+        REQUIRE(stream.read(10000, 64, out, 1));
+        CHECK(block[0] == 0.0f);
+        CHECK(streamer.service() == 0);
+    }
+
+    SECTION("A restart drops what was fetched for the previous playback") {
+        stream.start(sample);
+        while (streamer.service() > 0) {
+        }
+        stream.start(sample, 5000);
+        CHECK_FALSE(stream.read(5000, 64, out, 1));
+        streamer.service();
+        REQUIRE(stream.read(5000, 64, out, 1));
+        CHECK(block[10] == source[5010]);
+
+        // After an underrun the stream skips ahead instead of falling behind
+        CHECK_FALSE(stream.read(5600, 64, out, 1));
+        streamer.service();
+        REQUIRE(stream.read(5600, 64, out, 1));
+        CHECK(block[0] == source[5600]);
+
+        stream.stop();
+        CHECK_FALSE(stream.isPlaying());
+        CHECK(streamer.service() == 0);
+    }
+}
+
+TEST_CASE("StreamingSampleVoice plays a streamed sample at the note's pitch", "[dsp][sampler]") {
+    TempFile file;
+    const auto source = ramp(20000);
+    writeWav(file.path, source, 1, 3, 32);
+    StreamingSample sample;
+    REQUIRE(sample.open(file.path, 2048));
+
+    SampleStreamer streamer({.num_streams = 1, .ring_frames = 8192});
+    streamer.start();
+
+    using Voice = StreamingSampleVoice<float, 2>;
+    Voice voice;
+    voice.setSampleRate(48000.0);
+    voice.setStream(&streamer.stream(0));
+    voice.note_.key = 69;
+    voice.startSample(sample, voice.note_.getFrequency(), 0, 0.5f);
+
+    std::vector<float> output(2 * 512);
+    BufferView<float, 2> buffer(output.data(), 2, 512);
+    for (size_t block = 0; block < 8; ++block) {
+        std::fill(output.begin(), output.end(), 0.0f);
+        voice.process(buffer, 0, 512);
+        for (size_t i = 0; i < 512; ++i) {
+            const size_t frame = block * 512 + i;
+            REQUIRE(output[i] == Approx(0.5f * source[frame]).margin(1e-6));
+            REQUIRE(output[512 + i] == output[i]);  // Mono on both channels
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    CHECK(streamer.getUnderruns() == 0);
+
+    // Released: fades over the release time, then finishes and stops streaming
+    voice.setReleaseTime(0.005);
+    voice.noteOff(false);
+    std::fill(output.begin(), output.end(), 0.0f);
+    voice.process(buffer, 0, 512);
+    CHECK_FALSE(streamer.stream(0).isPlaying());
+    CHECK(std::abs(output[0]) > 0.0f);
+    CHECK(output[300] == 0.0f);
+
+    // An octave up reads every other frame
+    voice.startSample(sample, voice.note_.getFrequency() / 2.0);
+    std::fill(output.begin(), output.end(), 0.0f);
+    voice.process(buffer, 0, 512);
+    CHECK(output[100] == Approx(source[200]).margin(1e-6));
+    streamer.stop();
+}
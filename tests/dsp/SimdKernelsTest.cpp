@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/simd/Dispatch.h>
+#include <applause/dsp/simd/Kernels.h>
+#include <applause/util/ValueScalingBatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace applause;
+
+namespace {
+
+// Restores the baseline table when a test that switched tables ends
+struct BaselineKernelsGuard {
+    ~BaselineKernelsGuard() { simd::useKernels(simd::baselineKernels()); }
+};
+
+std::vector<float> randomFloats(std::size_t n, float lo, float hi, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> values(n);
+    for (float& v : values) v = dist(rng);
+    return values;
+}
+
+std::vector<float> randomMask(std::size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<float> mask(n);
+    for (float& m : mask) m = rng() % 3 == 0 ? 0.0f : 1.0f;
+    return mask;
+}
+
+void requireClose(const std::vector<float>& actual, const std::vector<float>& expected) {
+    REQUIRE(actual.size() == expected.size());
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        REQUIRE(actual[i] == Catch::Approx(expected[i]).epsilon(1e-5).margin(1e-6));
+    }
+}
+
+}  // namespace
+
+TEST_CASE("supportedKernels starts with the baseline and selectKernels installs the widest", "[dsp][simd]")
+{
+    BaselineKernelsGuard guard;
+    const auto supported = simd::supportedKernels();
+    REQUIRE(!supported.empty());
+    REQUIRE(supported.front() == &simd::baselineKernels());
+    REQUIRE(&simd::kernels() == &simd::baselineKernels());
+
+    const simd::Kernels& selected = simd::selectKernels();
+    REQUIRE(&selected == supported.back());
+    REQUIRE(&simd::kernels() == &selected);
+    REQUIRE(simd::isaName(simd::baselineKernels().isa) == std::string_view("baseline"));
+}
+
+TEST_CASE("Every supported kernel table matches a scalar reference", "[dsp][simd]")
+{
+    // Lengths around every batch width, at an odd offset so nothing is aligned
+    constexpr std::size_t kOffset = 1;
+    const ValueScaleInfo freq{20.0f, 20000.0f, ValueScaling::frequency(20.0f, 20000.0f)};
+
+    for (const simd::Kernels* table : simd::supportedKernels()) {
+        const simd::Kernels& k = *table;
+        INFO("kernels: " << simd::isaName(k.isa));
+        for (const std::size_t n : {0u, 1u, 3u, 4u, 7u, 8u, 15u, 16u, 17u, 31u, 33u, 64u, 67u}) {
+            INFO("n = " << n);
+            const auto a = randomFloats(n + kOffset, -1.0f, 1.0f, 1);
+            const auto b = randomFloats(n + kOffset, -1.0f, 1.0f, 2);
+            const auto mask = randomMask(n + kOffset, 3);
+            std::vector<float> expected(a.begin() + kOffset, a.end());
+            std::vector<float> actual = a;
+
+            auto run = [&](auto&& kernel, auto&& reference) {
+                actual = a;
+                expected.assign(a.begin() + kOffset, a.end());
+                kernel(actual.data() + kOffset);
+                for (std::size_t i = 0; i < n; ++i) reference(expected[i], i);
+                requireClose({actual.begin() + kOffset, actual.end()}, expected);
+            };
+
+            run([&](float* d) { k.gain(d, n, 0.5f); }, [](float& e, std::size_t) { e *= 0.5f; });
+            run([&](float* d) { k.gainRamp(d, n, 0.25f, 0.01f); },
+                [](float& e, std::size_t i) { e *= 0.25f + static_cast<float>(i) * 0.01f; });
+            run([&](float* d) { k.add(d, b.data() + kOffset, n); },
+                [&](float& e, std::size_t i) { e += b[i + kOffset]; });
+            run([&](float* d) { k.mixWithGain(d, b.data() + kOffset, n, -0.7f); },
+                [&](float& e, std::size_t i) { e += b[i + kOffset] * -0.7f; });
+            run([&](float* d) { k.multiply(d, b.data() + kOffset, n); },
+                [&](float& e, std::size_t i) { e *= b[i + kOffset]; });
+
+            run([&](float* d) { k.modAccumulate(d, b.data() + kOffset, 0.0f, nullptr, 0.3f, true, true, n); },
+                [&](float& e, std::size_t i) { e += ((b[i + kOffset] + 1.0f) * 0.5f - 0.5f) * 0.3f; });
+            run([&](float* d) { k.modAccumulate(d, nullptr, 0.6f, b.data() + kOffset, 0.0f, false, false, n); },
+                [&](float& e, std::size_t i) { e += 0.6f * b[i + kOffset]; });
+            run([&](float* d) { k.modAccumulate(d, nullptr, 0.6f, nullptr, 0.5f, false, false, n); },
+                [](float& e, std::size_t) { e += 0.3f; });
+            run([&](float* d) { k.maskedFill(d, mask.data() + kOffset, n, 2.0f); },
+                [&](float& e, std::size_t i) { e = mask[i + kOffset] != 0.0f ? 2.0f : e; });
+            run([&](float* d) { k.maskedClampAdd(d, b.data() + kOffset, mask.data() + kOffset, n, -0.5f, 0.5f); },
+                [&](float& e, std::size_t i) {
+                    if (mask[i + kOffset] != 0.0f) e = std::clamp(e + b[i + kOffset], -0.5f, 0.5f);
+                });
+            for (const auto precision : {ScalingPrecision::Fast, ScalingPrecision::Exact}) {
+                run([&](float* d) { k.maskedScale(d, b.data() + kOffset, mask.data() + kOffset, n, freq, precision); },
+                    [&](float& e, std::size_t i) {
+                        if (mask[i + kOffset] != 0.0f) e = fromNormalized(freq, b[i + kOffset], precision);
+                    });
+            }
+
+            float peak = -1.0f;
+            float sum = -1.0f;
+            k.levels(a.data() + kOffset, n, peak, sum);
+            float expected_peak = 0.0f;
+            float expected_sum = 0.0f;
+            for (std::size_t i = kOffset; i < a.size(); ++i) {
+                expected_peak = std::max(expected_peak, std::abs(a[i]));
+                expected_sum += a[i] * a[i];
+            }
+            REQUIRE(peak == expected_peak);
+            REQUIRE(sum == Catch::Approx(expected_sum).epsilon(1e-5).margin(1e-6));
+        }
+    }
+}
+
+TEST_CASE("BufferView float operations run on the installed kernel table", "[dsp][simd]")
+{
+    BaselineKernelsGuard guard;
+    constexpr std::size_t kFrames = 45;
+    const auto noise = randomFloats(2 * kFrames, -1.0f, 1.0f, 4);
+
+    std::vector<float> reference(2 * kFrames, 0.25f);
+    BufferView<float, 2> reference_view(reference.data(), 2, kFrames);
+    reference_view.mixWithGain(BufferView<const float, 2>(noise.data(), 2, kFrames), 0.5f);
+    reference_view.applyGainRamp(1.0f, 0.0f);
+    const auto reference_levels = reference_view.getLevels(1);
+
+    for (const simd::Kernels* table : simd::supportedKernels()) {
+        INFO("kernels: " << simd::isaName(table->isa));
+        simd::useKernels(*table);
+        std::vector<float> samples(2 * kFrames, 0.25f);
+        BufferView<float, 2> view(samples.data(), 2, kFrames);
+        view.mixWithGain(BufferView<const float, 2>(noise.data(), 2, kFrames), 0.5f);
+        view.applyGainRamp(1.0f, 0.0f);
+        requireClose(samples, reference);
+
+        const auto levels = view.getLevels(1);
+        REQUIRE(levels.peak == Catch::Approx(reference_levels.peak).epsilon(1e-5));
+        REQUIRE(levels.rms == Catch::Approx(reference_levels.rms).epsilon(1e-5));
+    }
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/dsp/SpectrumAnalyzer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr double kSampleRate = 48000.0;
+
+void pushSine(ScopeBuffer& scope, double frequency, float amplitude, uint32_t frames, uint64_t& phase) {
+    std::vector<float> block(frames);
+    for (auto& sample : block) {
+        sample = amplitude * static_cast<float>(std::sin(2.0 * std::numbers::pi * frequency * phase++ / kSampleRate));
+    }
+    const float* channels[] = {block.data()};
+    scope.push(channels, frames);
+}
+
+size_t nearestBin(const SpectrumAnalyzer& analyzer, float frequency) {
+    const auto freqs = analyzer.getBinFrequencies();
+    size_t best = 0;
+    for (size_t b = 1; b < freqs.size(); ++b) {
+        if (std::abs(std::log(freqs[b] / frequency)) < std::abs(std::log(freqs[best] / frequency))) best = b;
+    }
+    return best;
+}
+}  // namespace
+
+TEST_CASE("SpectrumAnalyzer measures a sine in dB full scale", "[dsp][spectrum]") {
+    ScopeBuffer scope(1, 8192);
+    SpectrumAnalyzer analyzer(scope, 0, kSampleRate, {.fft_size = 4096, .overlap = 4, .num_bins = 128});
+    std::vector<float> spectrum(analyzer.getNumBins());
+
+    REQUIRE_FALSE(analyzer.analyze());
+    REQUIRE(analyzer.readSpectrum(spectrum) == 0);
+
+    // A sine centred on FFT bin 85, at half of full scale
+    const double frequency = kSampleRate / 4096 * 85;
+    uint64_t phase = 0;
+    pushSine(scope, frequency, 0.5f, 4096, phase);
+    REQUIRE(analyzer.analyze());
+    REQUIRE(analyzer.readSpectrum(spectrum) == 1);
+
+    const size_t peak = nearestBin(analyzer, static_cast<float>(frequency));
+    CHECK(spectrum[peak] == Approx(20.0 * std::log10(0.5)).margin(0.1));
+    CHECK(*std::max_element(spectrum.begin(), spectrum.end()) == spectrum[peak]);
+    CHECK(spectrum[nearestBin(analyzer, 10000.0f)] < -80.0f);
+    CHECK(analyzer.getBinFrequencies().front() == Approx(20.0f));
+    CHECK(analyzer.getBinFrequencies().back() == Approx(20000.0f));
+
+    SECTION("Analyses run once per hop") {
+        REQUIRE_FALSE(analyzer.analyze());
+        pushSine(scope, frequency, 0.5f, 512, phase);
+        REQUIRE_FALSE(analyzer.analyze());
+        pushSine(scope, frequency, 0.5f, 512, phase);
+        REQUIRE(analyzer.analyze());
+        CHECK(analyzer.getVersion() == 2);
+    }
+
+    SECTION("Falling bins decay instead of dropping") {
+        const float before = spectrum[peak];
+        std::vector<float> silence(4096, 0.0f);
+        const float* channels[] = {silence.data()};
+        scope.push(channels, 1024);
+        REQUIRE(analyzer.analyze());
+        analyzer.readSpectrum(spectrum);
+        CHECK(spectrum[peak] < before);
+        CHECK(spectrum[peak] > -30.0f);
+
+        for (int i = 0; i < 60; ++i) {
+            scope.push(channels, 1024);
+            analyzer.analyze();
+        }
+        analyzer.readSpectrum(spectrum);
+        CHECK(spectrum[peak] == Approx(-120.0f).margin(1.0));
+    }
+}
+
+TEST_CASE("SpectrumAnalyzer analyzes on its own thread", "[dsp][spectrum][threads]") {
+    ScopeBuffer scope(1, 4096);
+    SpectrumAnalyzer analyzer(scope, 0, kSampleRate, {.fft_size = 1024});
+    analyzer.start();
+    REQUIRE(analyzer.isRunning());
+
+    uint64_t phase = 0;
+    pushSine(scope, 1000.0, 1.0f, 1024, phase);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (analyzer.getVersion() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    analyzer.stop();
+    REQUIRE_FALSE(analyzer.isRunning());
+
+    std::vector<float> spectrum(analyzer.getNumBins());
+    REQUIRE(analyzer.readSpectrum(spectrum) > 0);
+    CHECK(spectrum[nearestBin(analyzer, 1000.0f)] > -3.0f);
+}
@@ -0,0 +1,187 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/core/ModMatrix.h>
+#include <applause/dsp/BufferView.h>
+#include <applause/dsp/filters/SVFBank.h>
+#include <applause/dsp/filters/StateVariableFilter.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr double kSampleRate = 48000.0;
+
+template <typename Filter>
+void configure(Filter& filter) {
+    filter.init(kSampleRate);
+    filter.setCutoffFrequency(1200.0f);
+    filter.setQValue(2.0f);
+    if constexpr (Filter::filter_type == StateVariableFilterType::MultiMode) filter.setMode(0.3f);
+}
+
+// Channel ch is a sine whose frequency and phase differ per channel
+std::vector<float> makeInput(size_t channels, size_t frames) {
+    std::vector<float> input(channels * frames);
+    for (size_t ch = 0; ch < channels; ++ch) {
+        for (size_t i = 0; i < frames; ++i) {
+            const double frequency = 200.0 * static_cast<double>(ch + 1);
+            const double phase = 2.0 * M_PI * frequency * static_cast<double>(i) / kSampleRate;
+            input[ch * frames + i] = static_cast<float>(std::sin(phase + static_cast<double>(ch)));
+        }
+    }
+    return input;
+}
+}  // namespace
+
+TEMPLATE_TEST_CASE("StateVariableFilter::processBlock matches per-channel processing", "[dsp][svf]",
+                   (SVFLowpass<float, 8>), (SVFBandpass<float, 8>), (SVFHighpass<float, 8>),
+                   (SVFMultiMode<float, 8>), (StateVariableFilter<float, StateVariableFilterType::Lowpass, true, 8>)) {
+    constexpr size_t kFrames = 300;
+
+    for (size_t channels : {1u, 2u, 3u, 5u, 8u}) {
+        TestType block_filter;
+        TestType reference;
+        configure(block_filter);
+        configure(reference);
+
+        std::vector<float> block = makeInput(channels, kFrames);
+        std::vector<float> expected = block;
+
+        // Two calls, so the state carried across blocks is checked too
+        for (size_t start : {size_t(0), kFrames / 2}) {
+            BufferView<float, 8> view(block.data(), channels, kFrames);
+            block_filter.processBlock(view.getSubView(start, start == 0 ? kFrames / 2 : kFrames));
+        }
+        for (size_t ch = 0; ch < channels; ++ch) {
+            float* samples = expected.data() + ch * kFrames;
+            reference.process(ch, samples, samples, kFrames);
+        }
+
+        for (size_t i = 0; i < block.size(); ++i) {
+            REQUIRE(block[i] == Approx(expected[i]).margin(1e-6));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("StateVariableFilter modulated process tracks the exact coefficients", "[dsp][svf]",
+                   SVFLowpass<float>, SVFBandpass<float>, SVFHighpass<float>, SVFMultiMode<float>,
+                   (StateVariableFilter<float, StateVariableFilterType::Bandpass, true>)) {
+    constexpr size_t kFrames = 2000;
+    const std::vector<float> input = makeInput(1, kFrames);
+
+    // An exponential sweep from 40 Hz to past Nyquist, with the Q swinging between 0.5 and 8
+    std::vector<float> cutoff(kFrames);
+    std::vector<float> q(kFrames);
+    for (size_t i = 0; i < kFrames; ++i) {
+        const double t = static_cast<double>(i) / kFrames;
+        cutoff[i] = static_cast<float>(40.0 * std::pow(700.0, t));
+        q[i] = static_cast<float>(0.5 + 7.5 * 0.5 * (1.0 - std::cos(6.0 * M_PI * t)));
+    }
+
+    TestType filter;
+    TestType exact;
+    configure(filter);
+    configure(exact);
+
+    SECTION("Per-sample cutoff and Q") {
+        std::vector<float> output(kFrames);
+        filter.process(0, input.data(), output.data(), kFrames, cutoff.data(), q.data());
+        for (size_t i = 0; i < kFrames; ++i) {
+            exact.setQValue(q[i]);
+            exact.setCutoffFrequency(std::min(cutoff[i], 23990.0f));
+            REQUIRE(output[i] == Approx(exact.processSample(input[i])).margin(1e-5));
+        }
+        // The filter's own parameters are untouched
+        CHECK(filter.getCutoffFrequency() == 1200.0f);
+        CHECK(filter.getResonance() == 2.0f);
+    }
+
+    SECTION("A constant cutoff matches process()") {
+        const std::vector<float> constant(kFrames, 1200.0f);
+        std::vector<float> output = input;
+        std::vector<float> expected = input;
+        filter.process(0, output.data(), output.data(), kFrames, constant.data());
+        exact.process(0, expected.data(), expected.data(), kFrames);
+        for (size_t i = 0; i < kFrames; ++i) {
+            REQUIRE(output[i] == Approx(expected[i]).margin(1e-6));
+        }
+    }
+}
+
+TEST_CASE("SVFBank filters each voice like its own StateVariableFilter", "[dsp][svf]") {
+    constexpr size_t kVoices = 6;
+    constexpr size_t kFrames = 256;
+    using Bank = SVFBank<float, kVoices, StateVariableFilterType::Bandpass, 1>;
+    using Batch = Bank::Batch;
+
+    Bank bank;
+    bank.init(kSampleRate);
+    std::array<SVFBandpass<float, 1>, kVoices> reference;
+    for (size_t v = 0; v < kVoices; ++v) {
+        const auto cutoff = 300.0f * static_cast<float>(v + 1);
+        const auto q = 0.6f + static_cast<float>(v);
+        bank.setCutoffFrequency(v, cutoff);
+        bank.setQValue(v, q);
+        reference[v].init(kSampleRate);
+        reference[v].setQValue(q);
+        reference[v].setCutoffFrequency(cutoff);
+    }
+    bank.update();
+
+    // Voice v's input is channel v of makeInput(), laid out in SimdSynthesizer's voice packing
+    const std::vector<float> input = makeInput(kVoices, kFrames);
+    std::vector<Batch> lanes(Bank::kNumGroups * kFrames, Batch(0.0f));
+    const auto sample = [&](size_t v, size_t i) -> float& {
+        return reinterpret_cast<float*>(&lanes[(v / Bank::kLanes) * kFrames + i])[v % Bank::kLanes];
+    };
+    for (size_t v = 0; v < kVoices; ++v) {
+        for (size_t i = 0; i < kFrames; ++i) sample(v, i) = input[v * kFrames + i];
+    }
+
+    auto run = [&] {
+        for (size_t g = 0; g < Bank::kNumGroups; ++g) {
+            auto* group = reinterpret_cast<float*>(lanes.data() + g * kFrames);
+            bank.process(g, BufferView<Batch, 1>(group, 1, kFrames));
+        }
+    };
+    run();
+    for (size_t v = 0; v < kVoices; ++v) {
+        for (size_t i = 0; i < kFrames; ++i) {
+            REQUIRE(sample(v, i) == Approx(reference[v].processSample(input[v * kFrames + i])).margin(1e-5));
+        }
+    }
+
+    SECTION("resetVoice clears only that voice") {
+        bank.resetVoice(1);
+        reference[1].reset();
+        std::fill(lanes.begin(), lanes.end(), Batch(0.0f));
+        run();
+        CHECK(sample(1, 0) == 0.0f);
+        CHECK(sample(0, 0) == Approx(reference[0].processSample(0.0f)).margin(1e-5));
+    }
+
+    SECTION("Parameters come from ModMatrix poly destinations") {
+        ModMatrix matrix({8, 4, 4, 4});
+        auto& cutoff =
+            matrix.registerDestination("cutoff", ModDstMode::Poly, {20.0f, 20000.0f, ValueScaling::linear()});
+        auto& q = matrix.registerDestination("q", ModDstMode::Poly, {0.5f, 10.0f, ValueScaling::linear()});
+        matrix.setBaseValue(cutoff.index, 5000.0f);
+        matrix.setBaseValue(q.index, 3.0f);
+        for (uint16_t v = 0; v < 8; ++v) matrix.notifyVoiceOn(v);
+        matrix.process();
+
+        bank.loadFromModMatrix(matrix, cutoff.index, q.index, 4);
+        bank.update();
+        for (size_t v = 0; v < kVoices; ++v) {
+            CHECK(bank.getCutoffFrequency(v) == Approx(v < 4 ? 5000.0f : 300.0f * static_cast<float>(v + 1)));
+            CHECK(bank.getResonance(v) == Approx(v < 4 ? 3.0f : 0.6f + static_cast<float>(v)));
+        }
+    }
+}
@@ -0,0 +1,1122 @@
+#include <catch2/catch_test_macros.hpp>
+#include <applause/dsp/SimdSynthesizer.h>
+#include <applause/dsp/Synthesizer.h>
+#include <applause/dsp/UnisonVoice.h>
+#include <applause/extensions/ThreadPoolExtension.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numbers>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace applause;
+
+namespace {
+
+constexpr size_t kChannels = 2;
+constexpr uint32_t kFrames = 64;
+
+// A silent voice that finishes at the end of the first sub-block after its release
+class TestVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void process(BufferView<float, kChannels>, int, int) override {
+        if (getState() == State::Released && finish_on_release) terminateVoice();
+    }
+
+    bool finish_on_release = true;
+};
+
+template <size_t NumVoices>
+using TestSynth = Synthesizer<float, kChannels, NumVoices, TestVoice>;
+
+// A clap_input_events_t over a vector of note and expression events
+class EventList {
+public:
+    EventList& note(uint16_t type, uint32_t time, int16_t key, int32_t note_id = -1, int16_t channel = 0,
+                    int16_t port = 0) {
+        clap_event_note_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, type, 0};
+        e.note_id = note_id;
+        e.port_index = port;
+        e.channel = channel;
+        e.key = key;
+        e.velocity = 1.0;
+        events_.emplace_back(e);
+        return *this;
+    }
+
+    EventList& expression(uint32_t time, double value, int16_t key, int32_t note_id = -1, int16_t channel = 0) {
+        clap_event_note_expression_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_NOTE_EXPRESSION, 0};
+        e.expression_id = CLAP_NOTE_EXPRESSION_PRESSURE;
+        e.note_id = note_id;
+        e.port_index = -1;
+        e.channel = channel;
+        e.key = key;
+        e.value = value;
+        events_.emplace_back(e);
+        return *this;
+    }
+
+    EventList& paramMod(uint32_t time, double amount, clap_id param_id, void* cookie, int16_t key = -1,
+                        int32_t note_id = -1, int16_t channel = -1, int16_t port = -1) {
+        clap_event_param_mod_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_MOD, 0};
+        e.param_id = param_id;
+        e.cookie = cookie;
+        e.note_id = note_id;
+        e.port_index = port;
+        e.channel = channel;
+        e.key = key;
+        e.amount = amount;
+        events_.emplace_back(e);
+        return *this;
+    }
+
+    EventList& midi(uint32_t time, uint8_t status, uint8_t data1, uint8_t data2) {
+        clap_event_midi_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_MIDI, 0};
+        e.data[0] = status;
+        e.data[1] = data1;
+        e.data[2] = data2;
+        events_.emplace_back(e);
+        return *this;
+    }
+
+    EventList& midi2(uint32_t time, uint32_t word0, uint32_t word1) {
+        clap_event_midi2_t e{};
+        e.header = {sizeof(e), time, CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_MIDI2, 0};
+        e.data[0] = word0;
+        e.data[1] = word1;
+        events_.emplace_back(e);
+        return *this;
+    }
+
+    const clap_input_events_t* get() {
+        list_.ctx = this;
+        list_.size = [](const clap_input_events_t* l) {
+            return static_cast<uint32_t>(static_cast<EventList*>(l->ctx)->events_.size());
+        };
+        list_.get = [](const clap_input_events_t* l, uint32_t i) {
+            return std::visit([](const auto& e) { return &e.header; }, static_cast<EventList*>(l->ctx)->events_[i]);
+        };
+        return &list_;
+    }
+
+private:
+    std::vector<std::variant<clap_event_note_t, clap_event_note_expression_t, clap_event_param_mod_t,
+                             clap_event_midi_t, clap_event_midi2_t>>
+        events_;
+    clap_input_events_t list_{};
+};
+
+struct Block {
+    std::array<float, kChannels * kFrames> data{};
+    BufferView<float, kChannels> view{data.data(), kChannels, kFrames};
+};
+
+template <typename Synth>
+void run(Synth& synth, EventList& events) {
+    Block block;
+    synth.process(block.view, events.get());
+}
+
+template <typename Synth>
+void run(Synth& synth) {
+    Block block;
+    synth.process(block.view, nullptr);
+}
+
+template <typename Synth>
+auto* voiceForKey(Synth& synth, int16_t key) {
+    using Voice = typename decltype(synth.getVoices())::element_type;
+    for (auto& v : synth.getVoices()) {
+        if (v.isActive() && v.note_.key == key) return &v;
+    }
+    return static_cast<Voice*>(nullptr);
+}
+
+}  // namespace
+
+TEST_CASE("Synthesizer note-off addressing", "[synth][voices]")
+{
+    TestSynth<8> synth;
+    for (auto& v : synth.getVoices()) v.finish_on_release = false;
+    EventList on;
+    on.note(CLAP_EVENT_NOTE_ON, 0, 60, 1, 0)
+        .note(CLAP_EVENT_NOTE_ON, 0, 60, 2, 1)
+        .note(CLAP_EVENT_NOTE_ON, 0, 64, 3, 0)
+        .note(CLAP_EVENT_NOTE_ON, 0, 60, 4, 0);
+    run(synth, on);
+    REQUIRE(synth.getNumActiveVoices() == 4);
+
+    const auto state = [&](int32_t note_id) {
+        for (auto& v : synth.getVoices()) {
+            if (v.isActive() && v.note_.note_id == note_id) return v.getState();
+        }
+        return TestVoice::State::Idle;
+    };
+
+    SECTION("By note id releases only that note") {
+        EventList off;
+        off.note(CLAP_EVENT_NOTE_OFF, 0, -1, 4, -1, -1);
+        run(synth, off);
+        REQUIRE(state(4) == TestVoice::State::Released);
+        REQUIRE(state(1) == TestVoice::State::KeyDown);
+    }
+
+    SECTION("By key and channel releases every matching note") {
+        EventList off;
+        off.note(CLAP_EVENT_NOTE_OFF, 0, 60, -1, 0);
+        run(synth, off);
+        REQUIRE(state(1) == TestVoice::State::Released);
+        REQUIRE(state(4) == TestVoice::State::Released);
+        REQUIRE(state(2) == TestVoice::State::KeyDown);
+        REQUIRE(state(3) == TestVoice::State::KeyDown);
+    }
+
+    SECTION("Wildcard channel falls back to matching across channels") {
+        EventList off;
+        off.note(CLAP_EVENT_NOTE_OFF, 0, 60, -1, -1);
+        run(synth, off);
+        REQUIRE(state(1) == TestVoice::State::Released);
+        REQUIRE(state(2) == TestVoice::State::Released);
+        REQUIRE(state(4) == TestVoice::State::Released);
+        REQUIRE(state(3) == TestVoice::State::KeyDown);
+    }
+
+    SECTION("Mismatched port doesn't match") {
+        EventList off;
+        off.note(CLAP_EVENT_NOTE_OFF, 0, 64, -1, 0, 1);
+        run(synth, off);
+        REQUIRE(state(3) == TestVoice::State::KeyDown);
+    }
+}
+
+TEST_CASE("Synthesizer reuses voices that finished themselves", "[synth][voices]")
+{
+    TestSynth<2> synth;
+    EventList first;
+    first.note(CLAP_EVENT_NOTE_ON, 0, 60).note(CLAP_EVENT_NOTE_ON, 0, 62).note(CLAP_EVENT_NOTE_OFF, 10, 60);
+    run(synth, first);
+
+    // The released voice finished during the block, so the next note takes it instead of stealing
+    REQUIRE(synth.getNumActiveVoices() == 1);
+    EventList second;
+    second.note(CLAP_EVENT_NOTE_ON, 0, 64);
+    run(synth, second);
+    REQUIRE(voiceForKey(synth, 62) != nullptr);
+    REQUIRE(voiceForKey(synth, 64) != nullptr);
+    REQUIRE(synth.getNumActiveVoices() == 2);
+}
+
+TEST_CASE("Synthesizer steals the oldest voice", "[synth][voices]")
+{
+    TestSynth<3> synth;
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 0, 60)
+        .note(CLAP_EVENT_NOTE_ON, 1, 61)
+        .note(CLAP_EVENT_NOTE_ON, 2, 62)
+        .note(CLAP_EVENT_NOTE_CHOKE, 3, 61)
+        .note(CLAP_EVENT_NOTE_ON, 4, 63)  // takes the choked voice
+        .note(CLAP_EVENT_NOTE_ON, 5, 64)  // steals 60
+        .note(CLAP_EVENT_NOTE_ON, 6, 65);  // steals 62
+    run(synth, events);
+
+    REQUIRE(voiceForKey(synth, 60) == nullptr);
+    REQUIRE(voiceForKey(synth, 61) == nullptr);
+    REQUIRE(voiceForKey(synth, 62) == nullptr);
+    REQUIRE(voiceForKey(synth, 63) != nullptr);
+    REQUIRE(voiceForKey(synth, 64) != nullptr);
+    REQUIRE(voiceForKey(synth, 65) != nullptr);
+    REQUIRE(synth.getNumActiveVoices() == 3);
+}
+
+TEST_CASE("Synthesizer reports notes that stop sounding as NOTE_END", "[synth][voices]")
+{
+    std::vector<clap_event_note_t> ended;
+    const clap_output_events_t out{
+        .ctx = &ended,
+        .try_push = [](const clap_output_events_t* list, const clap_event_header_t* event) -> bool {
+            REQUIRE(event->type == CLAP_EVENT_NOTE_END);
+            static_cast<std::vector<clap_event_note_t>*>(list->ctx)
+                ->push_back(*reinterpret_cast<const clap_event_note_t*>(event));
+            return true;
+        },
+    };
+
+    TestSynth<2> synth;
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 0, 60, 1)
+        .note(CLAP_EVENT_NOTE_ON, 0, 62, 2, 3)
+        .note(CLAP_EVENT_NOTE_OFF, 10, 60)  // finishes itself in [10, 20)
+        .note(CLAP_EVENT_NOTE_CHOKE, 20, 62, -1, 3)
+        .note(CLAP_EVENT_NOTE_ON, 30, 64)
+        .note(CLAP_EVENT_NOTE_ON, 40, 65)
+        .note(CLAP_EVENT_NOTE_ON, 50, 66);  // steals 64
+    Block block;
+    synth.process(block.view, events.get(), &out);
+
+    REQUIRE(ended.size() == 3);
+    CHECK(ended[0].key == 60);
+    CHECK(ended[0].note_id == 1);
+    CHECK(ended[0].header.time == 20);
+    CHECK(ended[1].key == 62);
+    CHECK(ended[1].note_id == 2);
+    CHECK(ended[1].channel == 3);
+    CHECK(ended[1].header.time == 20);
+    CHECK(ended[2].key == 64);
+    CHECK(ended[2].header.time == 50);
+
+    // A voice that finishes in the block's last sub-block ends on its last frame
+    ended.clear();
+    EventList release;
+    release.note(CLAP_EVENT_NOTE_OFF, 5, 65);
+    synth.process(block.view, release.get(), &out);
+    REQUIRE(ended.size() == 1);
+    CHECK(ended[0].key == 65);
+    CHECK(ended[0].header.time == kFrames - 1);
+
+    // Without output events nothing is reported
+    ended.clear();
+    EventList choke;
+    choke.note(CLAP_EVENT_NOTE_CHOKE, 0, 66);
+    synth.process(block.view, choke.get());
+    CHECK(ended.empty());
+    CHECK(synth.getNumActiveVoices() == 0);
+}
+
+TEST_CASE("Synthesizer note expressions reach matching voices", "[synth][voices]")
+{
+    TestSynth<8> synth;
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 0, 60, 10, 0)
+        .note(CLAP_EVENT_NOTE_ON, 0, 62, 11, 0)
+        .note(CLAP_EVENT_NOTE_ON, 0, 60, 12, 1)
+        .expression(1, 0.25, -1, 11)  // by note id
+        .expression(2, 0.5, 60, -1, 0)  // by key and channel
+        .expression(3, 0.75, -1, -1, 1);  // whole channel 1
+    run(synth, events);
+
+    const auto pressure = [&](int32_t note_id) {
+        for (auto& v : synth.getVoices()) {
+            if (v.isActive() && v.note_.note_id == note_id) return v.note_.pressure;
+        }
+        return -1.0f;
+    };
+    REQUIRE(pressure(10) == 0.5);
+    REQUIRE(pressure(11) == 0.25);
+    REQUIRE(pressure(12) == 0.75);
+}
+
+TEST_CASE("Synthesizer plays raw MIDI and MIDI 2.0", "[synth][voices][midi]")
+{
+    TestSynth<8> synth;
+    EventList events;
+    events.midi(0, 0x91, 60, 127)
+        .midi2(0, 0x40923E00, 0x80000000)  // MIDI 2.0 note on, key 62 on channel 2
+        .midi(1, 0xE1, 0, 0)               // full bend down on channel 1
+        .midi2(2, 0x40A23E00, 0xFFFFFFFF)  // poly pressure on key 62
+        .midi(3, 0x90, 64, 0);             // velocity 0: releases nothing here
+    run(synth, events);
+
+    auto* a = voiceForKey(synth, 60);
+    auto* b = voiceForKey(synth, 62);
+    REQUIRE(a);
+    REQUIRE(b);
+    CHECK(a->note_.channel == 1);
+    CHECK(a->note_.note_on_velocity == 1.0);
+    CHECK(a->note_.tuning == -2.0);
+    CHECK(b->note_.channel == 2);
+    CHECK(b->note_.tuning == 0.0);
+    CHECK(b->note_.pressure == 1.0);
+    CHECK(synth.getNumActiveVoices() == 2);
+
+    SECTION("Note offs release by channel and key") {
+        EventList off;
+        off.midi(0, 0x81, 60, 0).midi2(0, 0x40823E00, 0);
+        run(synth, off);
+        CHECK(synth.getNumActiveVoices() == 0);
+    }
+
+    SECTION("All Sound Off chokes the channel") {
+        EventList off;
+        off.midi(0, 0xB2, 120, 0);
+        run(synth, off);
+        CHECK(voiceForKey(synth, 60));
+        CHECK_FALSE(voiceForKey(synth, 62));
+    }
+
+    SECTION("MPE master channel messages reach every note") {
+        synth.setMidiConfig({.mpe = true});
+        EventList bend;
+        bend.midi(0, 0xD0, 127, 0);
+        run(synth, bend);
+        CHECK(a->note_.pressure == 1.0);
+        CHECK(b->note_.pressure == 1.0);
+    }
+}
+
+TEST_CASE("Synthesizer voice tables survive heavy churn", "[synth][voices]")
+{
+    // Every note gets its own id; each block releases some notes by id and some by key, and all released voices
+    // finish, so the active count must track the notes still held.
+    TestSynth<16> synth;
+    std::vector<std::pair<int32_t, int16_t>> held;  // (note_id, key)
+    int32_t next_id = 0;
+    uint32_t seed = 7;
+    const auto rand = [&] { return seed = seed * 1664525u + 1013904223u; };
+
+    for (int block = 0; block < 200; ++block) {
+        EventList events;
+        for (int i = 0; i < 4; ++i) {
+            if (held.size() < 12 && rand() % 2) {
+                // A key that no held note uses, so key-addressed releases stay unambiguous
+                int16_t key;
+                do {
+                    key = static_cast<int16_t>(36 + rand() % 48);
+                } while (std::ranges::any_of(held, [&](const auto& h) { return h.second == key; }));
+                events.note(CLAP_EVENT_NOTE_ON, i, key, next_id);
+                held.emplace_back(next_id++, key);
+            } else if (!held.empty()) {
+                const size_t pick = rand() % held.size();
+                const auto [id, key] = held[pick];
+                if (rand() % 2) {
+                    events.note(CLAP_EVENT_NOTE_OFF, i, -1, id, -1, -1);
+                } else {
+                    events.note(CLAP_EVENT_NOTE_OFF, i, key, -1, 0);
+                }
+                held.erase(held.begin() + static_cast<std::ptrdiff_t>(pick));
+            }
+        }
+        run(synth, events);
+
+        REQUIRE(synth.getNumActiveVoices() == static_cast<int>(held.size()));
+        for (const auto& [id, key] : held) {
+            const auto* v = voiceForKey(synth, key);
+            REQUIRE(v != nullptr);
+            REQUIRE(v->note_.note_id == id);
+            REQUIRE(v->getState() == TestVoice::State::KeyDown);
+        }
+    }
+}
+
+namespace {
+
+// A voice with a key-dependent, not-too-regular waveform, so summation order shows up in the output
+class ToneVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void process(BufferView<float, kChannels> buffer, int start_sample, int num_samples) override {
+        for (int i = start_sample; i < start_sample + num_samples; ++i) {
+            phase_ += 0.01f * static_cast<float>(note_.key);
+            buffer.add(0, i, std::sin(phase_) * 0.1f);
+            buffer.add(1, i, std::cos(phase_ * 1.37f) * 0.3f);
+        }
+        if (getState() == State::Released) terminateVoice();
+    }
+
+    void noteOn() override { phase_ = 0.1f * static_cast<float>(note_.key); }
+
+private:
+    float phase_ = 0.0f;
+};
+
+using ToneSynth = Synthesizer<float, kChannels, 16, ToneVoice>;
+
+// A thread pool extension attached to a fake host whose request_exec runs every task on its own thread
+struct FakeThreadPool : ThreadPoolExtension {
+    clap_host_t host{};
+    clap_host_thread_pool_t host_pool{};
+    std::atomic<uint32_t> tasks_run{0};
+
+    void attach() {
+        host.host_data = this;
+        host.get_extension = [](const clap_host_t* h, const char* id) -> const void* {
+            auto* self = static_cast<FakeThreadPool*>(h->host_data);
+            return std::strcmp(id, CLAP_EXT_THREAD_POOL) == 0 ? &self->host_pool : nullptr;
+        };
+        host_pool.request_exec = [](const clap_host_t* h, uint32_t num_tasks) {
+            auto* self = static_cast<FakeThreadPool*>(h->host_data);
+            std::vector<std::thread> workers;
+            for (uint32_t t = 0; t < num_tasks; ++t) {
+                workers.emplace_back([self, t] {
+                    self->exec(t);
+                    self->tasks_run++;
+                });
+            }
+            for (auto& w : workers) w.join();
+            return true;
+        };
+        host_ = &host;
+        onHostReady();
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Synthesizer processParallel matches process()", "[synth][parallel]")
+{
+    for (const bool host_support : {false, true}) {
+        ToneSynth serial;
+        ToneSynth parallel;
+        serial.activate({48000.0, 1, kFrames});
+        parallel.activate({48000.0, 1, kFrames});
+
+        FakeThreadPool pool;
+        bool plugin_callback_ran = false;
+        pool.setCallback([&](uint32_t) { plugin_callback_ran = true; });
+        if (host_support) pool.attach();
+
+        for (int block = 0; block < 4; ++block) {
+            // Notes start and end mid-block, so the block splits into several sub-blocks
+            EventList serial_events;
+            EventList parallel_events;
+            for (EventList* events : {&serial_events, &parallel_events}) {
+                for (int16_t k = 0; k < 5; ++k) {
+                    const auto key = static_cast<int16_t>(40 + block * 5 + k);
+                    events->note(CLAP_EVENT_NOTE_ON, static_cast<uint32_t>(k * 7), key);
+                    if (block > 0) events->note(CLAP_EVENT_NOTE_OFF, static_cast<uint32_t>(k * 9), key - 5);
+                }
+            }
+
+            Block serial_out;
+            Block parallel_out;
+            serial.process(serial_out.view, serial_events.get());
+            parallel.processParallel(parallel_out.view, parallel_events.get(), pool, 2);
+            REQUIRE(parallel_out.data == serial_out.data);
+            REQUIRE(parallel.getNumActiveVoices() == serial.getNumActiveVoices());
+        }
+
+        // Without host support it renders serially; with it the voices are split into several tasks
+        if (host_support) {
+            REQUIRE(pool.tasks_run > 1);
+        } else {
+            REQUIRE(pool.tasks_run == 0);
+        }
+
+        // The plugin's own callback is restored afterwards
+        pool.exec(0);
+        REQUIRE(plugin_callback_ran);
+    }
+}
+
+namespace {
+
+// Each active lane outputs its key / 1000 on channel 0 and 1 on channel 1, and finishes on release. Inactive
+// lanes output garbage, which the synthesizer must discard.
+class KeyGroup : public SynthesizerVoiceGroup<float, kChannels> {
+public:
+    void process(BufferView<Batch, kChannels> buffer, uint32_t active_lanes, int num_samples) override {
+        alignas(Batch) std::array<float, kLanes> keys;
+        alignas(Batch) std::array<float, kLanes> ones;
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            const bool active = active_lanes & (1u << lane);
+            keys[lane] = active ? static_cast<float>(note(lane).key) / 1000.0f : 1000.0f;
+            ones[lane] = active ? 1.0f : -1000.0f;
+        }
+        for (int i = 0; i < num_samples; ++i) {
+            buffer.store(0, i, Batch::load_aligned(keys.data()));
+            buffer.store(1, i, Batch::load_aligned(ones.data()));
+        }
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            if ((active_lanes & (1u << lane)) && state(lane) == State::Released) terminateLane(lane);
+        }
+        ++blocks_rendered;
+    }
+
+    void noteOn(size_t) override { ++note_ons; }
+
+    int note_ons = 0;
+    int blocks_rendered = 0;
+};
+
+constexpr size_t kGroupLanes = KeyGroup::kLanes;
+// One partial group at the end
+using KeySynth = SimdSynthesizer<float, kChannels, 2 * kGroupLanes + 1, KeyGroup>;
+
+}  // namespace
+
+TEST_CASE("SimdSynthesizer renders voices in lane groups", "[synth][simd]")
+{
+    KeySynth synth;
+    synth.activate({48000.0, 1, 16});  // shorter than the block, so sub-blocks are rendered in slices
+
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 0, 60).note(CLAP_EVENT_NOTE_ON, 10, 62).note(CLAP_EVENT_NOTE_OFF, 40, 60);
+    Block block;
+    synth.process(block.view, events.get());
+
+    const auto* left = block.view.channelSamples(0);
+    const auto* right = block.view.channelSamples(1);
+    for (uint32_t i = 0; i < kFrames; ++i) {
+        // 62 starts at frame 10; 60 renders through the sub-block after its release, which then finishes it
+        const float expected_voices = i < 10 ? 1.0f : 2.0f;
+        const float expected_keys = 0.060f + (i >= 10 ? 0.062f : 0.0f);
+        REQUIRE(right[i] == expected_voices);
+        REQUIRE(std::abs(left[i] - expected_keys) < 1e-6f);
+    }
+    REQUIRE(synth.getNumActiveVoices() == 1);
+    REQUIRE(synth.getGroups()[0].note_ons == 2);
+    // The idle groups were skipped
+    REQUIRE(synth.getGroups()[1].blocks_rendered == 0);
+    REQUIRE(synth.getGroups()[2].blocks_rendered == 0);
+}
+
+TEST_CASE("SimdSynthesizer fills every group under full polyphony", "[synth][simd]")
+{
+    KeySynth synth;
+    synth.activate({48000.0, 1, kFrames});
+
+    EventList events;
+    float expected = 0.0f;
+    for (size_t v = 0; v < 2 * kGroupLanes + 1; ++v) {
+        const auto key = static_cast<int16_t>(30 + v);
+        events.note(CLAP_EVENT_NOTE_ON, 0, key);
+        expected += static_cast<float>(key) / 1000.0f;
+    }
+    events.note(CLAP_EVENT_NOTE_ON, 32, 100);  // steals the oldest voice, key 30
+    Block block;
+    synth.process(block.view, events.get());
+
+    REQUIRE(synth.getNumActiveVoices() == static_cast<int>(2 * kGroupLanes + 1));
+    REQUIRE(block.view.channelSamples(1)[0] == static_cast<float>(2 * kGroupLanes + 1));
+    REQUIRE(std::abs(block.view.channelSamples(0)[0] - expected) < 1e-5f);
+    REQUIRE(std::abs(block.view.channelSamples(0)[kFrames - 1] - (expected + 0.070f)) < 1e-5f);
+    for (const auto& group : synth.getGroups()) REQUIRE(group.blocks_rendered > 0);
+}
+
+namespace {
+
+// Outputs 1 on channel 0 while sounding
+class DcVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void process(BufferView<float, kChannels> buffer, int start_sample, int num_samples) override {
+        for (int i = start_sample; i < start_sample + num_samples; ++i) buffer.add(0, i, 1.0f);
+    }
+};
+
+using DcSynth = Synthesizer<float, kChannels, 4, DcVoice>;
+
+}  // namespace
+
+TEST_CASE("Synthesizer minimum sub-block size quantizes dense events", "[synth][quantize]")
+{
+    DcSynth synth;
+
+    // An expression on every sample after the first
+    EventList stream;
+    stream.note(CLAP_EVENT_NOTE_ON, 0, 60);
+    for (uint32_t t = 1; t < kFrames; ++t) stream.expression(t, t / static_cast<double>(kFrames), 60);
+
+    SECTION("Sample-accurate by default") {
+        run(synth, stream);
+        REQUIRE(synth.getSubBlockCount() == kFrames);
+        REQUIRE(synth.getQuantizedEventCount() == 0);
+    }
+
+    SECTION("Events inside the window are applied at its start") {
+        synth.setMinSubBlockSize(16);
+        run(synth, stream);
+        REQUIRE(synth.getSubBlockCount() == kFrames / 16);
+        REQUIRE(synth.getQuantizedEventCount() == kFrames - kFrames / 16);
+        // The last expression was applied at frame 48
+        REQUIRE(synth.getVoices()[0].note_.pressure == (kFrames - 1) / static_cast<double>(kFrames));
+    }
+}
+
+TEST_CASE("Synthesizer note-ons stay sample-accurate unless opted out", "[synth][quantize]")
+{
+    DcSynth synth;
+    synth.setMinSubBlockSize(16);
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 5, 60);
+    Block block;
+
+    SECTION("Sample-accurate") {
+        synth.process(block.view, events.get());
+        REQUIRE(block.view.channelSamples(0)[4] == 0.0f);
+        REQUIRE(block.view.channelSamples(0)[5] == 1.0f);
+        // The idle stretch before the note-on isn't rendered
+        REQUIRE(synth.getSubBlockCount() == 1);
+    }
+
+    SECTION("Quantized") {
+        synth.setSampleAccurateNoteOns(false);
+        synth.process(block.view, events.get());
+        REQUIRE(block.view.channelSamples(0)[0] == 1.0f);
+        REQUIRE(synth.getSubBlockCount() == 1);
+        REQUIRE(synth.getQuantizedEventCount() == 1);
+    }
+}
+
+namespace {
+
+constexpr uint16_t kEnvSrc = 0;
+constexpr uint16_t kCutoffDst = 0;
+
+// Sets its envelope source to key / 128 and outputs its modulated cutoff on channel 0
+class ModVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void updateModSources(ModMatrix& matrix, int, int) override {
+        matrix.setPolySourceValue(kEnvSrc, getVoiceIndex(), static_cast<float>(note_.key) / 128.0f);
+        ++updates;
+    }
+
+    void noteOn() override { cutoff_ = getModHandle(kCutoffDst); }
+
+    void process(BufferView<float, kChannels> buffer, int start_sample, int num_samples) override {
+        for (int i = start_sample; i < start_sample + num_samples; ++i) buffer.add(0, i, cutoff_.getValue());
+        if (getState() == State::Released) terminateVoice();
+    }
+
+    int updates = 0;
+
+private:
+    ModParamHandle cutoff_;
+};
+
+using ModSynth = Synthesizer<float, kChannels, 4, ModVoice>;
+
+}  // namespace
+
+TEST_CASE("Synthesizer drives a bound ModMatrix per sub-block", "[synth][modmatrix]")
+{
+    ModMatrix matrix({4, 4, 4, 8});
+    auto& env = matrix.registerSource("env", ModSrcType::Poly, false);
+    auto& cutoff = matrix.registerDestination("cutoff", ModDstMode::Poly);
+    REQUIRE(env.index == kEnvSrc);
+    REQUIRE(cutoff.index == kCutoffDst);
+    matrix.setBaseValue(cutoff.index, 0.25f);
+    matrix.addConnection(env, cutoff, 0.5f, false);
+
+    ModSynth synth;
+    synth.setModMatrix(&matrix);
+
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 0, 64).note(CLAP_EVENT_NOTE_ON, 20, 32).note(CLAP_EVENT_NOTE_OFF, 40, 64);
+    Block block;
+    synth.process(block.view, events.get());
+
+    // The second note is modulated from its first sample, in the middle of the block
+    const float a = 0.25f + 0.5f * 64.0f / 128.0f;
+    const float b = 0.25f + 0.5f * 32.0f / 128.0f;
+    const auto* out = block.view.channelSamples(0);
+    REQUIRE(std::abs(out[0] - a) < 1e-6f);
+    REQUIRE(std::abs(out[19] - a) < 1e-6f);
+    REQUIRE(std::abs(out[20] - (a + b)) < 1e-6f);
+    REQUIRE(std::abs(out[kFrames - 1] - (a + b)) < 1e-6f);
+
+    // The released voice finished in the last sub-block and was switched off in the matrix
+    REQUIRE(synth.getNumActiveVoices() == 1);
+    REQUIRE(matrix.getActiveVoices().size() == 1);
+    REQUIRE(matrix.isVoiceActive(synth.getVoices()[1].getVoiceIndex()));
+    REQUIRE_FALSE(matrix.isVoiceActive(0));
+    REQUIRE(synth.getVoices()[0].updates == 3);
+
+    // Unbinding switches the sounding voices off in the matrix
+    synth.setModMatrix(nullptr);
+    REQUIRE(matrix.getActiveVoices().empty());
+}
+
+TEST_CASE("Synthesizer routes host per-note modulation into the ModMatrix", "[synth][modmatrix][host]")
+{
+    ParamsExtension params(4);
+    ParamConfig config;
+    config.string_id = "cutoff";
+    config.default_value = 0.25f;
+    config.is_polyphonic = true;
+    params.registerParam(config);
+    config.string_id = "gain";
+    config.is_polyphonic = false;
+    params.registerParam(config);
+
+    ModMatrix::Config matrix_config{4, 4, 4, 8};
+    matrix_config.host_modulation = true;
+    ModMatrix matrix(matrix_config);
+    matrix.registerSource("env", ModSrcType::Poly, false);
+    matrix.registerFromParamsExtension(params);
+
+    ModSynth synth;
+    synth.setModMatrix(&matrix);
+
+    auto& handle = params.getHandle("cutoff");
+    const clap_id cutoff_id = params.getInfo("cutoff").clapId;
+    const clap_id gain_id = params.getInfo("gain").clapId;
+
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 0, 64, 1).note(CLAP_EVENT_NOTE_ON, 0, 32, 2);
+    events.paramMod(0, 0.1, cutoff_id, &handle);                       // global: every voice
+    events.paramMod(10, 0.5, cutoff_id, &handle, -1, 2);               // note 2 only
+    events.paramMod(20, 2.0, cutoff_id, nullptr, 64);                  // key 64, clamped to the range
+    events.paramMod(30, 0.5, gain_id, &params.getHandle("gain"), 64);  // mono destination: ignored
+
+    params.processEvents(events.get(), nullptr);
+    REQUIRE(std::abs(handle.getModulation() - 0.1f) < 1e-6f);
+    matrix.loadParamBaseValues(params);
+
+    Block block;
+    synth.process(block.view, events.get());
+
+    const auto* out = block.view.channelSamples(0);
+    REQUIRE(std::abs(out[0] - (0.35f + 0.35f)) < 1e-6f);
+    REQUIRE(std::abs(out[10] - (0.35f + 0.85f)) < 1e-6f);
+    REQUIRE(std::abs(out[20] - (1.0f + 0.85f)) < 1e-6f);
+    REQUIRE(std::abs(out[kFrames - 1] - (1.0f + 0.85f)) < 1e-6f);
+
+    // A new note on a voice starts without its previous note's modulation
+    EventList next;
+    next.note(CLAP_EVENT_NOTE_CHOKE, 0, 64, 1).note(CLAP_EVENT_NOTE_ON, 0, 64, 3);
+    Block second;
+    synth.process(second.view, next.get());
+    REQUIRE(std::abs(second.view.channelSamples(0)[0] - (0.35f + 0.85f)) < 1e-6f);
+}
+
+namespace {
+
+// Outputs its velocity on channel 0 and decays by half every sample after release; never finishes by itself
+class DecayVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void noteOn() override { level_ = static_cast<float>(note_.note_on_velocity); }
+
+    void process(BufferView<float, kChannels> buffer, int start_sample, int num_samples) override {
+        for (int i = start_sample; i < start_sample + num_samples; ++i) {
+            if (getState() == State::Released) level_ *= 0.5f;
+            buffer.add(0, i, level_);
+        }
+    }
+
+private:
+    float level_ = 0.0f;
+};
+
+}  // namespace
+
+TEST_CASE("Synthesizer reports idle and quiet output", "[synth][silence]")
+{
+    Synthesizer<float, kChannels, 4, DecayVoice> synth;
+
+    // Idle: nothing is rendered and the host may sleep
+    run(synth);
+    REQUIRE(synth.isOutputSilent());
+    REQUIRE_FALSE(synth.hasActiveVoices());
+    REQUIRE(synth.getProcessStatus() == ProcessStatus::Sleep);
+    REQUIRE(synth.getSubBlockCount() == 0);
+
+    EventList on;
+    on.note(CLAP_EVENT_NOTE_ON, 0, 60);
+    run(synth, on);
+    REQUIRE_FALSE(synth.isOutputSilent());
+    REQUIRE(synth.getProcessStatus() == ProcessStatus::Continue);
+
+    SECTION("Without silence detection a sounding voice keeps processing") {
+        EventList off;
+        off.note(CLAP_EVENT_NOTE_OFF, 0, 60);
+        run(synth, off);
+        run(synth);
+        REQUIRE(synth.getProcessStatus() == ProcessStatus::Continue);
+    }
+
+    SECTION("A quiet release tail lets the host stop") {
+        synth.setSilenceThreshold(1e-4f, kFrames);
+        run(synth);
+        // Held notes keep processing however quiet they are
+        REQUIRE(synth.getProcessStatus() == ProcessStatus::Continue);
+
+        EventList off;
+        off.note(CLAP_EVENT_NOTE_OFF, 0, 60);
+        run(synth, off);  // decays below the threshold, but the block started loud
+        REQUIRE(synth.getProcessStatus() == ProcessStatus::Continue);
+        run(synth);
+        REQUIRE(synth.getProcessStatus() == ProcessStatus::ContinueIfNotQuiet);
+        REQUIRE(synth.hasActiveVoices());
+
+        // A new note makes it loud again
+        run(synth, on);
+        REQUIRE(synth.getProcessStatus() == ProcessStatus::Continue);
+    }
+}
+
+namespace {
+
+// Reports its velocity as its amplitude; holds until released, then finishes only when choked or stolen
+class LevelVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void process(BufferView<float, kChannels>, int, int) override {}
+
+    [[nodiscard]] float getAmplitudeEstimate() const override { return static_cast<float>(note_.note_on_velocity); }
+};
+
+using LevelSynth = Synthesizer<float, kChannels, 4, LevelVoice>;
+
+}  // namespace
+
+TEST_CASE("Synthesizer steal policies", "[synth][voices][steal]")
+{
+    LevelSynth synth;
+    // Keys 60..63 in order, with 61 released and 63 the quietest held voice
+    EventList fill;
+    for (int16_t k = 0; k < 4; ++k) fill.note(CLAP_EVENT_NOTE_ON, k, static_cast<int16_t>(60 + k));
+    fill.note(CLAP_EVENT_NOTE_OFF, 4, 61);
+    run(synth, fill);
+    const std::array<float, 4> velocities = {0.9f, 0.8f, 0.7f, 0.1f};
+    for (auto& v : synth.getVoices()) v.note_.note_on_velocity = velocities[v.note_.key - 60];
+
+    const auto stolen = [&](std::initializer_list<int16_t> keys) {
+        for (const int16_t key : keys) {
+            if (voiceForKey(synth, key) != nullptr) return false;
+        }
+        return true;
+    };
+
+    SECTION("Oldest") {
+        synth.setStealPolicy(VoiceStealPolicy::Oldest);
+        EventList events;
+        events.note(CLAP_EVENT_NOTE_ON, 0, 70);
+        run(synth, events);
+        REQUIRE(stolen({60}));
+    }
+
+    SECTION("Released first") {
+        synth.setStealPolicy(VoiceStealPolicy::ReleasedFirst);
+        EventList events;
+        events.note(CLAP_EVENT_NOTE_ON, 0, 70).note(CLAP_EVENT_NOTE_ON, 1, 71);
+        run(synth, events);
+        REQUIRE(stolen({61, 60}));
+        REQUIRE(voiceForKey(synth, 62) != nullptr);
+    }
+
+    SECTION("Cost aware takes released, then quiet, then old voices") {
+        REQUIRE(synth.getStealPolicy() == VoiceStealPolicy::CostAware);
+        // A chord at full polyphony: all three victims are chosen together
+        EventList events;
+        events.note(CLAP_EVENT_NOTE_ON, 0, 70).note(CLAP_EVENT_NOTE_ON, 0, 71).note(CLAP_EVENT_NOTE_ON, 0, 72);
+        run(synth, events);
+        REQUIRE(stolen({61, 63, 62}));
+        REQUIRE(voiceForKey(synth, 60) != nullptr);
+        for (const int16_t key : {70, 71, 72}) REQUIRE(voiceForKey(synth, key) != nullptr);
+    }
+
+    SECTION("A planned victim that was choked frees its voice instead") {
+        EventList events;
+        events.note(CLAP_EVENT_NOTE_ON, 0, 70)
+            .note(CLAP_EVENT_NOTE_ON, 0, 71)
+            .note(CLAP_EVENT_NOTE_CHOKE, 0, 63)
+            .note(CLAP_EVENT_NOTE_ON, 0, 72);
+        run(synth, events);
+        REQUIRE(stolen({61, 63, 62}));
+        REQUIRE(voiceForKey(synth, 60) != nullptr);
+        REQUIRE(synth.getNumActiveVoices() == 4);
+    }
+
+    SECTION("A planned victim's voice reused by the chord is not stolen again") {
+        // 63 is choked after the plan, then its voice plays 71; 72 must take the next victim instead
+        EventList events;
+        events.note(CLAP_EVENT_NOTE_ON, 0, 70)
+            .note(CLAP_EVENT_NOTE_CHOKE, 0, 63)
+            .note(CLAP_EVENT_NOTE_ON, 0, 71)
+            .note(CLAP_EVENT_NOTE_ON, 0, 72);
+        run(synth, events);
+        REQUIRE(stolen({61, 63, 62}));
+        REQUIRE(voiceForKey(synth, 60) != nullptr);
+        for (const int16_t key : {70, 71, 72}) REQUIRE(voiceForKey(synth, key) != nullptr);
+    }
+}
+
+namespace {
+
+// Each sub-voice outputs 1 + its index; records how often the shared control state was computed
+class StackVoice : public UnisonVoice<float, kChannels, 7> {
+public:
+    void noteOn() override { setUnison(unison, 0.5f, spread); }
+
+    int control_updates = 0;
+    size_t unison = 7;
+    float spread = 0.0f;
+
+protected:
+    void updateControl(int, int) override { ++control_updates; }
+
+    void renderStack(size_t batch, std::span<Batch> out) override {
+        alignas(Batch) std::array<float, kLanes> values;
+        for (size_t lane = 0; lane < kLanes; ++lane) values[lane] = static_cast<float>(1 + batch * kLanes + lane);
+        std::fill(out.begin(), out.end(), Batch::load_aligned(values.data()));
+    }
+};
+
+using StackSynth = Synthesizer<float, kChannels, 2, StackVoice>;
+
+}  // namespace
+
+TEST_CASE("UnisonVoice renders a detuned, panned stack per note", "[synth][unison]")
+{
+    StackSynth synth;
+
+    SECTION("Control state is shared by the stack") {
+        EventList events;
+        events.note(CLAP_EVENT_NOTE_ON, 0, 60).expression(30, 0.5, 60);
+        Block block;
+        synth.process(block.view, events.get());
+        auto& voice = *voiceForKey(synth, 60);
+        REQUIRE(voice.getUnisonCount() == 7);
+        REQUIRE(voice.control_updates == 2);
+
+        // Detune spans +-0.5 semitones evenly, centered on the note
+        for (size_t i = 0; i < 7; ++i) {
+            const float ratio = voice.getDetuneRatios(i / StackVoice::kLanes).get(i % StackVoice::kLanes);
+            REQUIRE(std::abs(ratio - std::exp2((static_cast<float>(i) / 3.0f - 1.0f) * 0.5f / 12.0f)) < 1e-6f);
+        }
+
+        // All centered: each sub-voice reaches both sides at sqrt(2 / 7), and lanes past the stack are silent
+        const float expected = 28.0f * std::sqrt(2.0f / 7.0f) * std::cos(std::numbers::pi_v<float> / 4.0f);
+        for (uint32_t i = 0; i < kFrames; ++i) {
+            REQUIRE(std::abs(block.view.channelSamples(0)[i] - expected) < 1e-4f);
+            REQUIRE(std::abs(block.view.channelSamples(1)[i] - expected) < 1e-4f);
+        }
+    }
+
+    SECTION("Stereo spread pans the outermost sub-voices hard") {
+        for (auto& v : synth.getVoices()) {
+            v.unison = 2;
+            v.spread = 1.0f;
+        }
+        EventList events;
+        events.note(CLAP_EVENT_NOTE_ON, 0, 60);
+        Block block;
+        synth.process(block.view, events.get());
+        // Sub-voice 0 (value 1) is hard left and sub-voice 1 (value 2) hard right, each at unity gain
+        REQUIRE(std::abs(block.view.channelSamples(0)[0] - 1.0f) < 1e-5f);
+        REQUIRE(std::abs(block.view.channelSamples(1)[0] - 2.0f) < 1e-5f);
+    }
+}
+
+TEST_CASE("Synthesizer profiling hooks", "[synth][profiling]")
+{
+    TestSynth<2> synth;
+    SynthProfiler profiler(256);
+    synth.setProfiler(&profiler);
+
+    EventList events;
+    events.note(CLAP_EVENT_NOTE_ON, 0, 60).note(CLAP_EVENT_NOTE_ON, 8, 62).note(CLAP_EVENT_NOTE_ON, 16, 64);
+    run(synth, events);
+
+    std::vector<SynthProfileEvent> recorded;
+    for (SynthProfileEvent e{}; profiler.tryPop(e);) recorded.push_back(e);
+
+    if constexpr (!kProfilingEnabled) {
+        // Compiled out: attaching a profiler records nothing
+        REQUIRE(recorded.empty());
+    } else {
+        const auto count = [&](SynthProfileEvent::Type type) {
+            return std::ranges::count_if(recorded, [&](const auto& e) { return e.type == type; });
+        };
+        // Sub-blocks [0, 8), [8, 16) and [16, 64) render one, two and two voices; the third note steals the first
+        REQUIRE(count(SynthProfileEvent::Type::SubBlock) == 3);
+        REQUIRE(count(SynthProfileEvent::Type::Voice) == 5);
+        REQUIRE(count(SynthProfileEvent::Type::Steal) == 1);
+        REQUIRE(recorded.back().type == SynthProfileEvent::Type::Block);
+        REQUIRE(recorded.back().sub_blocks == 3);
+        REQUIRE(recorded.back().num_samples == kFrames);
+        REQUIRE(profiler.getDroppedCount() == 0);
+    }
+}
+
+namespace {
+
+// A sine of 1 kHz per key at whatever rate the synthesizer gives it; finishes as soon as it is released
+class SineVoice : public SynthesizerVoice<float, kChannels> {
+public:
+    void noteOn() override { phase_ = 0.0; }
+
+    void process(BufferView<float, kChannels> buffer, int start_sample, int num_samples) override {
+        if (getState() == State::Released) {
+            terminateVoice();
+            return;
+        }
+        first_start = first_start < 0 ? start_sample : first_start;
+        rendered += num_samples;
+        const double step = 2.0 * std::numbers::pi * 1000.0 * note_.key / getSampleRate();
+        for (int i = start_sample; i < start_sample + num_samples; ++i) {
+            buffer.add(0, i, static_cast<float>(std::sin(phase_)));
+            phase_ += step;
+        }
+    }
+
+    int first_start = -1;
+    int rendered = 0;
+
+private:
+    double phase_ = 0.0;
+};
+
+using SineSynth = Synthesizer<float, kChannels, 4, SineVoice>;
+
+// The loudest sample of channel 0 over the next blocks blocks
+float peakOver(SineSynth& synth, int blocks) {
+    float peak = 0.0f;
+    for (int b = 0; b < blocks; ++b) {
+        Block block;
+        synth.process(block.view, nullptr);
+        for (uint32_t i = 0; i < kFrames; ++i) peak = std::max(peak, std::abs(block.data[i]));
+    }
+    return peak;
+}
+
+}  // namespace
+
+TEST_CASE("Synthesizer oversampling renders voices fast and decimates their sum once", "[synth][oversampling]") {
+    SineSynth synth;
+    synth.setOversampling(2);
+    synth.activate({.sample_rate = 48000.0, .min_frame_size = 1, .max_frame_size = kFrames});
+    CHECK(synth.getLatency() == 16);
+    CHECK(synth.getVoices()[0].getSampleRate() == 96000.0);
+
+    SECTION("voices render at twice the rate, from the scaled event position") {
+        EventList on;
+        on.note(CLAP_EVENT_NOTE_ON, 10, 1);
+        run(synth, on);
+        const SineVoice* voice = voiceForKey(synth, 1);
+        REQUIRE(voice != nullptr);
+        CHECK(voice->first_start == 20);
+        CHECK(voice->rendered == 2 * (kFrames - 10));
+        // 1 kHz is well inside the passband
+        CHECK(std::abs(peakOver(synth, 4) - 1.0f) < 0.02f);
+    }
+
+    SECTION("a tone above the host's Nyquist frequency doesn't alias back") {
+        EventList on;
+        on.note(CLAP_EVENT_NOTE_ON, 0, 36);  // 36 kHz: fine at 96 kHz, but 12 kHz once aliased at 48 kHz
+        run(synth, on);
+        CHECK(peakOver(synth, 4) < 1e-3f);
+
+        SineSynth plain;
+        plain.activate({.sample_rate = 48000.0, .min_frame_size = 1, .max_frame_size = kFrames});
+        CHECK(plain.getLatency() == 0);
+        run(plain, on);
+        CHECK(peakOver(plain, 1) > 0.9f);
+    }
+
+    SECTION("once the voices end, the decimator rings out and then the host may sleep") {
+        EventList on;
+        on.note(CLAP_EVENT_NOTE_ON, 0, 1);
+        run(synth, on);
+        run(synth);
+        EventList off;
+        off.note(CLAP_EVENT_NOTE_OFF, 0, 1);
+        Block block;
+        synth.process(block.view, off.get());
+        CHECK_FALSE(synth.hasActiveVoices());
+        // The delayed tail of the sine, then exact zeros from the filters' cleared history
+        CHECK(block.data[0] != 0.0f);
+        CHECK(block.data[kFrames - 1] == 0.0f);
+        CHECK_FALSE(synth.isOutputSilent());
+        CHECK(synth.getProcessStatus() == ProcessStatus::Sleep);
+        run(synth);
+        CHECK(synth.isOutputSilent());
+    }
+}
@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <applause/dsp/oscillators/Wavetable.h>
+#include <applause/dsp/oscillators/WavetableOscillator.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include <xsimd/xsimd.hpp>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+constexpr size_t kFrameSize = 1024;
+constexpr double kSampleRate = 48000.0;
+
+// Frame f is a sawtooth for f == 0 and a sine otherwise, scaled by (-1)^f
+std::vector<float> makeFrames(size_t num_frames) {
+    std::vector<float> samples(num_frames * kFrameSize);
+    for (size_t f = 0; f < num_frames; ++f) {
+        const float sign = f % 2 ? -1.0f : 1.0f;
+        for (size_t i = 0; i < kFrameSize; ++i) {
+            const double phase = static_cast<double>(i) / kFrameSize;
+            const double value = f == 0 ? 2.0 * phase - 1.0 : std::sin(2.0 * M_PI * phase);
+            samples[f * kFrameSize + i] = sign * static_cast<float>(value);
+        }
+    }
+    return samples;
+}
+
+double harmonicMagnitude(const float* table, size_t harmonic) {
+    std::complex<double> sum;
+    for (size_t i = 0; i < kFrameSize; ++i) {
+        sum += static_cast<double>(table[i]) * std::polar(1.0, -2.0 * M_PI * double(harmonic * i) / kFrameSize);
+    }
+    return std::abs(sum) * 2.0 / kFrameSize;
+}
+}  // namespace
+
+TEST_CASE("Wavetable band-limits each mip level to its harmonic count", "[dsp][wavetable]") {
+    const std::vector<float> samples = makeFrames(1);
+    const Wavetable table(samples, kFrameSize);
+    REQUIRE(table.numFrames() == 1);
+    REQUIRE(table.numLevels() == 10);
+
+    for (size_t level = 0; level < table.numLevels(); ++level) {
+        const float* data = table.table(level, 0);
+        const size_t top = table.maxHarmonic(level);
+        CHECK(data[kFrameSize] == data[0]);
+        // Harmonics up to the level's top are the source frame's own; Nyquist and everything above are gone
+        const size_t kept = std::min(top, kFrameSize / 2 - 1);
+        CHECK(harmonicMagnitude(data, kept) == Approx(harmonicMagnitude(samples.data(), kept)).epsilon(1e-4));
+        CHECK(harmonicMagnitude(data, kept + 1) < 1e-5);
+    }
+
+    // Level l is chosen once 2^(l-1) < frameSize * increment <= 2^l
+    CHECK(table.levelFor(0.0f) == 0);
+    CHECK(table.levelFor(1.0f / kFrameSize) == 0);
+    CHECK(table.levelFor(3.0f / kFrameSize) == 2);
+    CHECK(table.levelFor(4.0f / kFrameSize) == 2);
+    CHECK(table.levelFor(0.5f) == table.numLevels() - 1);
+}
+
+TEST_CASE("WavetableOscillator plays a sine frame cleanly", "[dsp][wavetable]") {
+    std::vector<float> samples = makeFrames(2);
+    const Wavetable table(std::span<const float>(samples).subspan(kFrameSize), kFrameSize);  // One sine frame
+    WavetableOscillator<float> osc;
+    osc.setSampleRate(kSampleRate);
+    osc.setFrequency(440.0f);
+
+    std::vector<float> out(1000);
+    osc.process(table, out.data(), 500);
+    osc.process(table, out.data() + 500, 500);
+    for (size_t i = 0; i < out.size(); ++i) {
+        REQUIRE(out[i] == Approx(-std::sin(2.0 * M_PI * 440.0 * double(i) / kSampleRate)).margin(1e-4));
+    }
+}
+
+TEST_CASE("WavetableOscillator morphs between frames", "[dsp][wavetable]") {
+    const std::vector<float> samples = makeFrames(3);  // Saw, -sine, sine
+    const Wavetable table(samples, kFrameSize);
+    WavetableOscillator<float> osc;
+    osc.setSampleRate(kSampleRate);
+    osc.setFrequency(100.0f);
+
+    // Halfway between the -sine and the sine frames, they cancel
+    osc.setMorph(0.75f);
+    std::vector<float> out(256);
+    osc.process(table, out.data(), 256);
+    for (float sample : out) REQUIRE(sample == Approx(0.0f).margin(1e-6));
+
+    SECTION("setModulation reads pitch and a morph ramp from ModMatrix handles") {
+        float pitch_value = 12.0f;
+        float morph_start = 1.0f;
+        float morph_end = 0.5f;
+        const ModParamHandle pitch{&pitch_value, &pitch_value};
+        const ModParamHandle morph{&morph_end, &morph_start};
+
+        WavetableOscillator<float> modulated;
+        modulated.setSampleRate(kSampleRate);
+        modulated.setModulation(220.0, pitch, morph);
+        modulated.process(table, out.data(), 256);
+        for (size_t i = 0; i < out.size(); ++i) {
+            const float m = 1.0f - 0.5f * static_cast<float>(i) / 256.0f;
+            const float phase = std::fmod(440.0f * static_cast<float>(i) / static_cast<float>(kSampleRate), 1.0f);
+            REQUIRE(out[i] == Approx(table.evaluate(phase, m, table.levelFor(440.0f / kSampleRate))).margin(1e-4));
+        }
+    }
+}
+
+TEST_CASE("WavetableOscillator renders each lane like a scalar oscillator", "[dsp][wavetable]") {
+    using Batch = xsimd::batch<float>;
+    constexpr size_t kLanes = Batch::size;
+    const std::vector<float> samples = makeFrames(4);
+    const Wavetable table(samples, kFrameSize);
+
+    WavetableOscillator<Batch> simd;
+    std::vector<WavetableOscillator<float>> scalar(kLanes);
+    simd.setSampleRate(kSampleRate);
+    alignas(64) std::array<float, kLanes> hz, start, end;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        hz[lane] = 55.0f * static_cast<float>(1 << lane);  // Spans several mip levels
+        start[lane] = 0.1f * static_cast<float>(lane);
+        end[lane] = 1.0f - 0.1f * static_cast<float>(lane);
+        scalar[lane].setSampleRate(kSampleRate);
+        scalar[lane].setFrequency(hz[lane]);
+        scalar[lane].setMorph(start[lane], end[lane]);
+    }
+    simd.setFrequency(Batch::load_aligned(hz.data()));
+    simd.setMorph(Batch::load_aligned(start.data()), Batch::load_aligned(end.data()));
+
+    constexpr int kSamples = 300;
+    std::vector<Batch> out(kSamples);
+    simd.process(table, out.data(), kSamples);
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        std::vector<float> expected(kSamples);
+        scalar[lane].process(table, expected.data(), kSamples);
+        for (int i = 0; i < kSamples; ++i) {
+            alignas(64) std::array<float, kLanes> values;
+            out[static_cast<size_t>(i)].store_aligned(values.data());
+            REQUIRE(values[lane] == Approx(expected[static_cast<size_t>(i)]).margin(1e-6));
+        }
+    }
+}
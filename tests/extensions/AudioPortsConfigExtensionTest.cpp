@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/AudioPortsConfigExtension.h>
+#include <applause/extensions/AudioPortsExtension.h>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+int rescan_calls = 0;
+const clap_host_audio_ports_config_t kHostPortsConfig{.rescan = [](const clap_host_t*) { ++rescan_calls; }};
+clap_host_t makeHost() {
+    clap_host_t host{};
+    host.get_extension = [](const clap_host_t*, const char* id) -> const void* {
+        return std::strcmp(id, CLAP_EXT_AUDIO_PORTS_CONFIG) == 0 ? &kHostPortsConfig : nullptr;
+    };
+    return host;
+}
+const clap_host_t kHost = makeHost();
+
+struct LayoutPlugin : PluginBase {
+    AudioPortsExtension audio_ports;
+    AudioPortsConfigExtension ports_config{audio_ports};
+
+    LayoutPlugin() : PluginBase(&kDesc, &kHost) {
+        ports_config.addLayout(AudioPortsLayout::effect("Mono", 1))
+            .addLayout(AudioPortsLayout::effect("Stereo", 2))
+            .addLayout(AudioPortsLayout::instrument("5.1", 6, "surround"));
+        registerExtension(audio_ports);
+        registerExtension(ports_config);
+    }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+}  // namespace
+
+TEST_CASE("AudioPortsConfigExtension lists layouts and applies the selected one", "[extensions][audio-ports]") {
+    rescan_calls = 0;
+    LayoutPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    CHECK(rescan_calls == 0);  // Layouts added before init() are part of the first scan
+    const auto* ext = static_cast<const clap_plugin_audio_ports_config_t*>(
+        clap->get_extension(clap, CLAP_EXT_AUDIO_PORTS_CONFIG));
+    const auto* ports = static_cast<const clap_plugin_audio_ports_t*>(clap->get_extension(clap, CLAP_EXT_AUDIO_PORTS));
+    REQUIRE(ext != nullptr);
+    REQUIRE(ports != nullptr);
+
+    REQUIRE(ext->count(clap) == 3);
+    clap_audio_ports_config_t config{};
+    REQUIRE(ext->get(clap, 1, &config));
+    CHECK(config.id == 1);
+    CHECK(std::strcmp(config.name, "Stereo") == 0);
+    CHECK(config.input_port_count == 1);
+    CHECK(config.output_port_count == 1);
+    CHECK(config.has_main_input);
+    CHECK(config.main_input_channel_count == 2);
+    CHECK(std::strcmp(config.main_input_port_type, CLAP_PORT_STEREO) == 0);
+    REQUIRE(ext->get(clap, 2, &config));
+    CHECK_FALSE(config.has_main_input);
+    CHECK(config.main_output_channel_count == 6);
+    CHECK(std::strcmp(config.main_output_port_type, "surround") == 0);
+    CHECK_FALSE(ext->get(clap, 3, &config));
+
+    // The first layout starts out selected
+    CHECK(plugin.ports_config.getSelectedLayout()->name == "Mono");
+    clap_audio_port_info_t info{};
+    REQUIRE(ports->get(clap, 0, true, &info));
+    CHECK(info.channel_count == 1);
+    CHECK(std::strcmp(info.port_type, CLAP_PORT_MONO) == 0);
+
+    REQUIRE(ext->select(clap, 2));
+    CHECK(plugin.ports_config.getSelectedLayout()->name == "5.1");
+    CHECK(ports->count(clap, true) == 0);
+    REQUIRE(ports->count(clap, false) == 1);
+    REQUIRE(ports->get(clap, 0, false, &info));
+    CHECK(info.channel_count == 6);
+    CHECK((info.flags & CLAP_AUDIO_PORT_IS_MAIN) != 0);
+
+    CHECK_FALSE(ext->select(clap, 7));
+    CHECK(plugin.ports_config.getSelectedLayout()->name == "5.1");
+
+    // DSP is sized once for the widest layout
+    CHECK(plugin.ports_config.getMaxChannelCount() == 6);
+
+    plugin.ports_config.addLayout(AudioPortsLayout::effect("7.1", 8, "surround"));
+    CHECK(rescan_calls == 1);
+    CHECK(ext->count(clap) == 4);
+    CHECK(plugin.ports_config.getMaxChannelCount() == 8);
+    CHECK(plugin.ports_config.getSelectedLayout()->name == "5.1");
+}
@@ -0,0 +1,42 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/LatencyExtension.h>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+
+int changed_calls = 0;
+const clap_host_latency_t kHostLatency{.changed = [](const clap_host_t*) { ++changed_calls; }};
+
+const clap_host_t kHost{
+    .get_extension = [](const clap_host_t*, const char* id) -> const void* {
+        return std::strcmp(id, CLAP_EXT_LATENCY) == 0 ? &kHostLatency : nullptr;
+    },
+};
+
+struct TestPlugin : PluginBase {
+    LatencyExtension latency;
+    TestPlugin() : PluginBase(&kDesc, &kHost) { registerExtension(latency); }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+}  // namespace
+
+TEST_CASE("LatencyExtension reports the latency and notifies the host of changes", "[extensions][latency]") {
+    changed_calls = 0;
+    TestPlugin plugin;
+    plugin.clapPlugin()->init(plugin.clapPlugin());
+    const auto* ext = static_cast<const clap_plugin_latency_t*>(plugin.latency.getClapExtensionStruct());
+    CHECK(ext->get(plugin.clapPlugin()) == 0);
+
+    plugin.latency.setLatency(31);
+    CHECK(ext->get(plugin.clapPlugin()) == 31);
+    CHECK(changed_calls == 1);
+
+    plugin.latency.setLatency(31);
+    CHECK(changed_calls == 1);
+}
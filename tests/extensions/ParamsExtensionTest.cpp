@@ -1,9 +1,12 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <applause/core/PluginBase.h>
@@ -58,6 +61,7 @@ struct FakeHost {
     int rescan_count = 0;
     clap_param_rescan_flags last_rescan_flags = 0;
     int flush_count = 0;
+    int callback_requests = 0;
     clap_host_params_t params{};
     clap_host_t host{};
 
@@ -69,6 +73,7 @@ struct FakeHost {
         };
         params.request_flush = [](const clap_host_t* h) { static_cast<FakeHost*>(h->host_data)->flush_count++; };
         host.host_data = this;
+        host.request_callback = [](const clap_host_t* h) { static_cast<FakeHost*>(h->host_data)->callback_requests++; };
         host.get_extension = [](const clap_host_t* h, const char* id) -> const void* {
             auto* self = static_cast<FakeHost*>(h->host_data);
             return std::strcmp(id, CLAP_EXT_PARAMS) == 0 ? static_cast<const void*>(&self->params) : nullptr;
@@ -91,6 +96,15 @@ clap_event_param_value_t makeEvent(clap_id param_id, void* cookie, double value)
     return event;
 }
 
+// clap_event_param_mod_t has the same layout as clap_event_param_value_t, so the lists above carry both
+clap_event_param_value_t makeModEvent(clap_id param_id, void* cookie, double amount, int16_t key = -1) {
+    static_assert(sizeof(clap_event_param_mod_t) == sizeof(clap_event_param_value_t));
+    auto event = makeEvent(param_id, cookie, amount);
+    event.header.type = CLAP_EVENT_PARAM_MOD;
+    event.key = key;
+    return event;
+}
+
 ParamConfig rangedConfig(std::string string_id, float min, float max, float def, bool stepped = false) {
     ParamConfig config;
     config.string_id = std::move(string_id);
@@ -192,6 +206,26 @@ TEST_CASE("ParamsExtension registration metadata via get_info", "[params][info]"
         REQUIRE(info.flags == (CLAP_PARAM_IS_STEPPED | CLAP_PARAM_IS_HIDDEN | CLAP_PARAM_IS_AUTOMATABLE));
     }
 
+    SECTION("polyphonic param flags") {
+        TestPlugin fresh;
+        auto config = makeConfig("cutoff", 0.5f);
+        config.is_polyphonic = true;
+        fresh.params.registerParam(config);
+        fresh.params.registerParam(makeConfig("volume", 0.5f));
+
+        // Without per-note routing, only global modulation is offered, and only for polyphonic parameters
+        REQUIRE(clapParams(fresh)->get_info(fresh.clapPlugin(), 0, &info));
+        REQUIRE(info.flags == (CLAP_PARAM_IS_AUTOMATABLE | CLAP_PARAM_IS_MODULATABLE));
+
+        fresh.params.setPerNoteModulation(true);
+        REQUIRE(clapParams(fresh)->get_info(fresh.clapPlugin(), 1, &info));
+        REQUIRE(info.flags == CLAP_PARAM_IS_AUTOMATABLE);
+        REQUIRE(clapParams(fresh)->get_info(fresh.clapPlugin(), 0, &info));
+        REQUIRE(info.flags == (CLAP_PARAM_IS_AUTOMATABLE | CLAP_PARAM_IS_MODULATABLE |
+                               CLAP_PARAM_IS_MODULATABLE_PER_NOTE_ID | CLAP_PARAM_IS_MODULATABLE_PER_KEY |
+                               CLAP_PARAM_IS_MODULATABLE_PER_CHANNEL | CLAP_PARAM_IS_MODULATABLE_PER_PORT));
+    }
+
     SECTION("cookies non-null and distinct") {
         clap_param_info_t other{};
         REQUIRE(clap_params->get_info(plugin.clapPlugin(), 0, &info));
@@ -262,6 +296,68 @@ TEST_CASE("ParamsExtension CLAP id stability and module dependence", "[params][i
     }
 }
 
+constexpr ParamTable kTable({
+    {.string_id = "cutoff", .name = {}, .module = "Filter", .short_name = {}, .unit = "Hz", .min_value = 20.0f,
+     .max_value = 20000.0f, .default_value = 500.0f},
+    {.string_id = "resonance", .name = {}, .module = {}, .short_name = {}, .unit = {}, .min_value = 0.1f,
+     .max_value = 10.0f, .default_value = 0.71f},
+    {.string_id = "mode", .name = {}, .module = {}, .short_name = {}, .unit = {}, .max_value = 3.0f,
+     .default_value = 0.0f, .is_stepped = true, .is_internal = true},
+});
+
+// Resolved by the compiler
+static_assert(kTable.size() == 3);
+static_assert(kTable.index("mode") == 2);
+static_assert(kTable.find("missing") == ParamTable<3>::kNotFound);
+static_assert(kTable.clapId("cutoff") == paramIdHash("Filter", "cutoff"));
+static_assert(kTable.clapId("resonance") == paramIdHash({}, "resonance"));
+
+TEST_CASE("ParamsExtension compile-time parameter table", "[params][id][table]") {
+    TestPlugin plugin;
+    plugin.params.registerParams(kTable);
+
+    // Same ids, values and metadata as registering the parameters one by one
+    ParamsExtension manual{4};
+    auto cutoff = rangedConfig("cutoff", 20.0f, 20000.0f, 500.0f);
+    cutoff.module = "Filter";
+    manual.registerParam(cutoff);
+    manual.registerParam(rangedConfig("resonance", 0.1f, 10.0f, 0.71f));
+    for (const char* id : {"cutoff", "resonance"}) {
+        REQUIRE(plugin.params.getInfo(id).clapId == manual.getInfo(id).clapId);
+        REQUIRE(plugin.params.getHandle(id).getValue() == manual.getHandle(id).getValue());
+    }
+    REQUIRE(plugin.params.getInfo("cutoff").unit == "Hz");
+    REQUIRE(plugin.params.getInfo("mode").internal);
+    REQUIRE(clapParams(plugin)->count(plugin.clapPlugin()) == 2);
+
+    // Indices are table indices, and lookups by either id find the same parameter
+    constexpr uint32_t kResonance = kTable.index("resonance");
+    REQUIRE(&plugin.params.getHandleAt(kResonance) == &plugin.params.getHandle("resonance"));
+    REQUIRE(&plugin.params.getInfoAt(kResonance) == &plugin.params.getInfo(kTable.clapId("resonance")));
+    REQUIRE(plugin.params.findParamIndex(nullptr, kTable.clapIdAt(0)) == 0);
+    REQUIRE(plugin.params.findParamIndex(nullptr, 12345) == ParamsExtension::kNoParam);
+
+    double value = 0.0;
+    REQUIRE(clapParams(plugin)->get_value(plugin.clapPlugin(), kTable.clapId("resonance"), &value));
+    REQUIRE(value == Approx(0.71));
+
+    EventList list;
+    list.events.push_back(makeEvent(kTable.clapId("cutoff"), nullptr, 1000.0));
+    plugin.params.processEvents(&list.in, nullptr);
+    REQUIRE(plugin.params.getHandleAt(kTable.index("cutoff")).getValue() == 1000.0f);
+
+    // Parameters registered afterwards use the maps, and don't collide with table ids
+    plugin.params.registerParam(makeConfig("extra", 0.5f));
+    REQUIRE(plugin.params.getHandle("extra").getValue() == 0.5f);
+    REQUIRE(plugin.params.getInfo("extra").clapId == paramIdHash({}, "extra"));
+    REQUIRE(&plugin.params.getInfo("resonance") == &plugin.params.getInfoAt(kResonance));
+
+    applause::json state = applause::json::array();
+    state.push_back({{"id", kTable.clapId("resonance")}, {"value", 2.0f}});
+    REQUIRE(plugin.params.loadFromJson(state));
+    REQUIRE(plugin.params.getHandleAt(kResonance).getValue() == 2.0f);
+}
+
 TEST_CASE("ParamsExtension value access and get_value callback", "[params][value]") {
     TestPlugin plugin;
     plugin.params.registerParam(makeConfig("a", 0.5f));
@@ -307,6 +403,75 @@ TEST_CASE("ParamsExtension default value_to_text formatting", "[params][text]")
     SECTION("unit appended without space") { REQUIRE(plugin.params.getInfo("fu").valueToText(0.25f) == "0.25Hz"); }
 }
 
+TEST_CASE("ParamsExtension value_to_text writes into the host's buffer", "[params][text]") {
+    TestPlugin plugin;
+    auto config = rangedConfig("f", -100.0f, 100.0f, 12.5f);
+    config.unit = "dB";
+    plugin.params.registerParam(config);
+    const auto& info = plugin.params.getInfo("f");
+
+    char buffer[16];
+    REQUIRE(info.valueToText(-0.5f, buffer, sizeof(buffer)) == 7);
+    REQUIRE(std::string(buffer) == "-0.50dB");
+    REQUIRE(info.valueToText(-0.5f) == "-0.50dB");
+
+    SECTION("truncated to the capacity") {
+        REQUIRE(info.valueToText(-0.5f, buffer, 4) == 3);
+        REQUIRE(std::string(buffer) == "-0.");
+        REQUIRE(info.valueToText(-0.5f, buffer, 1) == 0);
+        REQUIRE(buffer[0] == '\0');
+    }
+
+    SECTION("through CLAP, for the current value and others") {
+        auto* clap_params = clapParams(plugin);
+        REQUIRE(clap_params->value_to_text(plugin.clapPlugin(), info.clapId, 12.5, buffer, sizeof(buffer)));
+        REQUIRE(std::string(buffer) == "12.50dB");
+        REQUIRE(clap_params->value_to_text(plugin.clapPlugin(), info.clapId, 12.5, buffer, 3));
+        REQUIRE(std::string(buffer) == "12");
+        REQUIRE(clap_params->value_to_text(plugin.clapPlugin(), info.clapId, 3.0, buffer, sizeof(buffer)));
+        REQUIRE(std::string(buffer) == "3.00dB");
+    }
+}
+
+TEST_CASE("ParamsExtension caches the current value's text until the value is written", "[params][text]") {
+    TestPlugin plugin;
+    int calls = 0;
+    auto config = makeConfig("x", 0.5f);
+    config.value_to_text = [&](float value, const ParamInfo&) {
+        ++calls;
+        return std::to_string(static_cast<int>(value * 100.0f)) + "%";
+    };
+    plugin.params.registerParam(config);
+    const auto& info = plugin.params.getInfo("x");
+    auto* clap_params = clapParams(plugin);
+
+    const auto text = [&](double value) {
+        char buffer[32] = {};
+        REQUIRE(clap_params->value_to_text(plugin.clapPlugin(), info.clapId, value, buffer, sizeof(buffer)));
+        return std::string(buffer);
+    };
+
+    REQUIRE(text(0.5) == "50%");
+    REQUIRE(text(0.5) == "50%");
+    REQUIRE(calls == 1);
+
+    // Other values are formatted every time
+    REQUIRE(text(0.25) == "25%");
+    REQUIRE(text(0.25) == "25%");
+    REQUIRE(calls == 3);
+    REQUIRE(text(0.5) == "50%");
+    REQUIRE(calls == 3);
+
+    // A write drops the cached text, even one that comes back to the same value
+    info.setValueSilently(0.5f);
+    REQUIRE(text(0.5) == "50%");
+    REQUIRE(calls == 4);
+    info.setValueSilently(0.75f);
+    REQUIRE(text(0.75) == "75%");
+    REQUIRE(text(0.75) == "75%");
+    REQUIRE(calls == 5);
+}
+
 TEST_CASE("ParamsExtension default text_to_value parsing", "[params][text]") {
     TestPlugin plugin;
     plugin.params.registerParam(rangedConfig("wide", -1000.0f, 1000.0f, 0.0f));
@@ -410,22 +575,39 @@ TEST_CASE("ParamsExtension processEvents inbound", "[params][process]") {
         REQUIRE(plugin.params.getInfo("s").getValue() == 2.0f);
     }
 
-    SECTION("host changes are forwarded to the UI queue") {
+    SECTION("host changes reach the UI coalesced") {
         ParamMessageQueue queue;
         plugin.params.setMessageQueue(&queue);
+        std::vector<float> received;
+        plugin.params.getInfo("p").on_value_changed.connect([&](float value) { received.push_back(value); });
+
         const clap_id id = plugin.params.getInfo("p").clapId;
         EventList list;
         list.events.push_back(makeEvent(id, nullptr, 0.3));
+        list.events.push_back(makeEvent(id, nullptr, 0.6));
         plugin.params.processEvents(&list.in, nullptr);
+        list.events = {makeEvent(id, nullptr, 0.7)};
+        plugin.params.processEvents(&list.in, nullptr);
+
+        plugin.params.dispatchHostChanges();
+        REQUIRE(received.size() == 1);
+        REQUIRE(received[0] == Approx(0.7f));
+
+        plugin.params.dispatchHostChanges();
+        REQUIRE(received.size() == 1);
 
         ParamMessageQueue::Message message{};
-        REQUIRE(queue.toUi().try_dequeue(message));
-        REQUIRE(message.type == ParamMessageQueue::PARAM_VALUE);
-        REQUIRE(message.paramId == id);
-        REQUIRE(message.value == Approx(0.3f));
         REQUIRE_FALSE(queue.toUi().try_dequeue(message));
     }
 
+    SECTION("UI-side writes are not echoed back") {
+        std::vector<float> received;
+        plugin.params.getInfo("p").on_value_changed.connect([&](float value) { received.push_back(value); });
+        plugin.params.getInfo("p").setValueSilently(0.2f);
+        plugin.params.dispatchHostChanges();
+        REQUIRE(received.empty());
+    }
+
     SECTION("non-param events are skipped") {
         EventList list;
         auto event = makeEvent(plugin.params.getInfo("p").clapId, nullptr, 0.9);
@@ -441,6 +623,267 @@ TEST_CASE("ParamsExtension processEvents inbound", "[params][process]") {
     }
 }
 
+TEST_CASE("ParamsExtension automation timeline", "[params][process][timeline]") {
+    TestPlugin plugin;
+    plugin.params.registerParam(makeConfig("p", 0.5f));
+    plugin.params.registerParam(makeConfig("q", 0.25f));
+    const clap_id id = plugin.params.getInfo("p").clapId;
+    const auto& handle = plugin.params.getHandle("p");
+    const auto& other = plugin.params.getHandle("q");
+
+    auto event = [&](uint32_t time, double value) {
+        auto e = makeEvent(id, nullptr, value);
+        e.header.time = time;
+        return e;
+    };
+
+    SECTION("events keep their sample offsets") {
+        EventList list;
+        list.events = {event(10, 0.1), event(20, 0.2), event(30, 0.3)};
+        plugin.params.processEvents(&list.in, nullptr);
+
+        REQUIRE(handle.getValue() == Approx(0.3f));
+        REQUIRE(handle.getTimeline().size() == 3);
+        REQUIRE(handle.getTimeline().getStartValue() == Approx(0.5f));
+        REQUIRE(handle.getValueAt(0) == Approx(0.5f));
+        REQUIRE(handle.getValueAt(9) == Approx(0.5f));
+        REQUIRE(handle.getValueAt(10) == Approx(0.1f));
+        REQUIRE(handle.getValueAt(25) == Approx(0.2f));
+        REQUIRE(handle.getValueAt(1000) == Approx(0.3f));
+
+        // Untouched parameters have an empty timeline that follows their value
+        REQUIRE(other.getTimeline().empty());
+        REQUIRE(other.getValueAt(15) == Approx(0.25f));
+        REQUIRE(&plugin.params.getTimelineAt(0) == &handle.getTimeline());
+    }
+
+    SECTION("segments cover the block") {
+        EventList list;
+        list.events = {event(0, 0.1), event(16, 0.2), event(16, 0.4), event(80, 0.9)};
+        plugin.params.processEvents(&list.in, nullptr);
+
+        std::vector<std::tuple<uint32_t, uint32_t, float>> segments;
+        handle.getTimeline().forEachSegment(64, [&](uint32_t start, uint32_t length, float value) {
+            segments.emplace_back(start, length, value);
+        });
+        REQUIRE(segments.size() == 2);
+        REQUIRE(std::get<0>(segments[0]) == 0);
+        REQUIRE(std::get<1>(segments[0]) == 16);
+        REQUIRE(std::get<2>(segments[0]) == Approx(0.1f));
+        REQUIRE(std::get<0>(segments[1]) == 16);
+        REQUIRE(std::get<1>(segments[1]) == 48);
+        REQUIRE(std::get<2>(segments[1]) == Approx(0.4f));
+
+        segments.clear();
+        other.getTimeline().forEachSegment(64, [&](uint32_t start, uint32_t length, float value) {
+            segments.emplace_back(start, length, value);
+        });
+        REQUIRE(segments.size() == 1);
+        REQUIRE(std::get<1>(segments[0]) == 64);
+        REQUIRE(std::get<2>(segments[0]) == Approx(0.25f));
+    }
+
+    SECTION("the next block starts from the last value") {
+        EventList list;
+        list.events = {event(8, 0.7)};
+        plugin.params.processEvents(&list.in, nullptr);
+        REQUIRE(handle.getTimeline().size() == 1);
+
+        EventList empty;
+        plugin.params.processEvents(&empty.in, nullptr);
+        REQUIRE(handle.getTimeline().empty());
+        REQUIRE(handle.getValueAt(0) == Approx(0.7f));
+
+        list.events = {event(4, 0.2)};
+        plugin.params.processEvents(&list.in, nullptr);
+        REQUIRE(handle.getTimeline().getStartValue() == Approx(0.7f));
+        REQUIRE(handle.getValueAt(4) == Approx(0.2f));
+    }
+
+    SECTION("a full timeline keeps the final value") {
+        EventList list;
+        for (uint32_t i = 0; i < ParamTimeline::kCapacity + 4; ++i) {
+            list.events.push_back(event(i, 0.01 * i));
+        }
+        plugin.params.processEvents(&list.in, nullptr);
+        REQUIRE(handle.getTimeline().size() == ParamTimeline::kCapacity);
+        REQUIRE(handle.getValueAt(ParamTimeline::kCapacity + 3) ==
+                Approx(0.01f * static_cast<float>(ParamTimeline::kCapacity + 3)));
+        REQUIRE(handle.getValueAt(1000) == Approx(handle.getValue()));
+    }
+}
+
+TEST_CASE("ParamsExtension value smoothing", "[params][smoothing]") {
+    TestPlugin plugin;
+    auto linear = makeConfig("lin", 0.0f);
+    linear.value_smoothing = ParamSmoothing::Linear;
+    linear.value_smoothing_ms = 1.0f;  // 48 samples at 48 kHz
+    plugin.params.registerParam(linear);
+    auto exponential = makeConfig("exp", 0.0f);
+    exponential.value_smoothing = ParamSmoothing::Exponential;
+    exponential.value_smoothing_ms = 1.0f;
+    plugin.params.registerParam(exponential);
+    plugin.params.registerParam(makeConfig("plain", 0.0f));
+
+    plugin.params.activate({48000.0, 1, 64});
+    const auto& lin = plugin.params.getHandle("lin");
+    const auto& exp = plugin.params.getHandle("exp");
+    REQUIRE(lin.getSmoothedValues() != nullptr);
+    REQUIRE(plugin.params.getHandle("plain").getSmoothedValues() == nullptr);
+
+    auto event = [&](const char* id, uint32_t time, double value) {
+        auto e = makeEvent(plugin.params.getInfo(id).clapId, nullptr, value);
+        e.header.time = time;
+        return e;
+    };
+
+    SECTION("settled parameters hold their value") {
+        plugin.params.processEvents(nullptr, nullptr);
+        plugin.params.processSmoothing(0, 64);
+        for (uint32_t i = 0; i < 64; ++i) {
+            REQUIRE(lin.getSmoothedValues()[i] == 0.0f);
+            REQUIRE(exp.getSmoothedValues()[i] == 0.0f);
+        }
+    }
+
+    SECTION("linear ramps reach the target after the smoothing time") {
+        EventList list;
+        list.events = {event("lin", 0, 0.96)};
+        plugin.params.processEvents(&list.in, nullptr);
+        plugin.params.processSmoothing(0, 64);
+
+        const float* values = lin.getSmoothedValues();
+        REQUIRE(values[0] == Approx(0.02f));
+        REQUIRE(values[23] == Approx(0.48f));
+        REQUIRE(values[47] == Approx(0.96f));
+        REQUIRE(values[63] == Approx(0.96f));
+    }
+
+    SECTION("exponential smoothing decays towards the target") {
+        EventList list;
+        list.events = {event("exp", 0, 1.0)};
+        plugin.params.processEvents(&list.in, nullptr);
+        plugin.params.processSmoothing(0, 64);
+
+        const float* values = exp.getSmoothedValues();
+        REQUIRE(values[47] == Approx(1.0f - std::exp(-1.0f)).margin(1e-4));
+        for (uint32_t i = 1; i < 64; ++i) {
+            REQUIRE(values[i] > values[i - 1]);
+        }
+
+        // Settles within the threshold a few hundred samples later
+        for (int block = 0; block < 16; ++block) {
+            plugin.params.processEvents(nullptr, nullptr);
+            plugin.params.processSmoothing(0, 64);
+        }
+        REQUIRE(exp.getSmoothedValues()[0] == 1.0f);
+        REQUIRE(exp.getSmoothedValues()[63] == 1.0f);
+    }
+
+    SECTION("automation starts ramps at its sample offsets") {
+        EventList list;
+        list.events = {event("lin", 32, 0.48)};
+        plugin.params.processEvents(&list.in, nullptr);
+        plugin.params.processSmoothing(0, 16);
+        plugin.params.processSmoothing(16, 48);
+
+        const float* values = lin.getSmoothedValues();
+        REQUIRE(values[31] == 0.0f);
+        REQUIRE(values[32] == Approx(0.01f));
+        REQUIRE(values[63] == Approx(0.32f));
+    }
+
+    SECTION("ramps continue across blocks and settle flat") {
+        EventList list;
+        list.events = {event("lin", 0, 0.96)};
+        plugin.params.processEvents(&list.in, nullptr);
+        plugin.params.processSmoothing(0, 32);
+        REQUIRE(lin.getSmoothedValues()[31] == Approx(0.64f));
+
+        plugin.params.processEvents(nullptr, nullptr);
+        plugin.params.processSmoothing(0, 32);
+        REQUIRE(lin.getSmoothedValues()[15] == Approx(0.96f));
+        REQUIRE(lin.getSmoothedValues()[31] == Approx(0.96f));
+
+        plugin.params.processEvents(nullptr, nullptr);
+        plugin.params.processSmoothing(0, 64);
+        for (uint32_t i = 0; i < 64; ++i) {
+            REQUIRE(lin.getSmoothedValues()[i] == Approx(0.96f));
+        }
+    }
+
+    SECTION("UI-side value changes are smoothed too") {
+        plugin.params.getInfo("lin").setValueSilently(0.48f);
+        plugin.params.processEvents(nullptr, nullptr);
+        plugin.params.processSmoothing(0, 64);
+        REQUIRE(lin.getSmoothedValues()[0] == Approx(0.01f));
+        REQUIRE(lin.getSmoothedValues()[63] == Approx(0.48f));
+    }
+}
+
+TEST_CASE("ParamsExtension host modulation", "[params][process][mod]") {
+    TestPlugin plugin;
+    plugin.params.registerParam(makeConfig("a", 0.5f));
+    auto& handle = plugin.params.getHandle("a");
+    const clap_id id = plugin.params.getInfo("a").clapId;
+
+    EventList list;
+    list.events.push_back(makeModEvent(id, &handle, 0.25));
+    list.events.push_back(makeModEvent(id, nullptr, 0.75, 60));  // per-note: left to the voices
+    plugin.params.processEvents(&list.in, nullptr);
+
+    // Modulation is an offset next to the value, which it leaves alone
+    REQUIRE(handle.getModulation() == Approx(0.25f));
+    REQUIRE(plugin.params.getModulationArray()[0] == Approx(0.25f));
+    REQUIRE(handle.getValue() == Approx(0.5f));
+    REQUIRE(plugin.params.getTimelineAt(0).empty());
+
+    bool changed = false;
+    plugin.params.consumeChangedParams([&](uint32_t index) { changed = changed || index == 0; });
+    REQUIRE(changed);
+
+    list.events = {makeModEvent(id, nullptr, 0.0)};
+    plugin.params.processEvents(&list.in, nullptr);
+    REQUIRE(handle.getModulation() == 0.0f);
+}
+
+TEST_CASE("ParamsExtension change tracking", "[params][dirty]") {
+    TestPlugin plugin;
+    plugin.params.registerParam(makeConfig("a", 0.5f));
+    plugin.params.registerParam(makeConfig("b", 0.5f));
+    plugin.params.registerParam(makeConfig("c", 0.5f));
+
+    auto changed = [&] {
+        std::vector<uint32_t> indices;
+        plugin.params.consumeChangedParams([&](uint32_t index) { indices.push_back(index); });
+        return indices;
+    };
+
+    // Registration marks every parameter; consuming clears the bits
+    REQUIRE(changed() == std::vector<uint32_t>{0, 1, 2});
+    REQUIRE(changed().empty());
+
+    SECTION("host events") {
+        EventList list;
+        list.events.push_back(makeEvent(plugin.params.getInfo("c").clapId, nullptr, 0.1));
+        plugin.params.processEvents(&list.in, nullptr);
+        REQUIRE(changed() == std::vector<uint32_t>{2});
+    }
+
+    SECTION("UI writes") {
+        plugin.params.getInfo("b").setValueNotifyingHost(0.2f);
+        plugin.params.getInfo("a").setValueSilently(0.3f);
+        REQUIRE(changed() == std::vector<uint32_t>{0, 1});
+    }
+
+    SECTION("state loads") {
+        applause::json state = applause::json::array();
+        state.push_back({{"id", plugin.params.getInfo("b").clapId}, {"value", 0.9f}});
+        REQUIRE(plugin.params.loadFromJson(state));
+        REQUIRE(changed() == std::vector<uint32_t>{1});
+    }
+}
+
 TEST_CASE("ParamsExtension processEvents outbound", "[params][process][out]") {
     TestPlugin plugin;
     plugin.params.registerParam(makeConfig("p", 0.5f));
@@ -521,16 +964,196 @@ TEST_CASE("ParamsExtension flush drives both directions", "[params][process][flu
 
     REQUIRE(plugin.params.getInfo("p").getValue() == 0.4f);
 
-    ParamMessageQueue::Message message{};
-    REQUIRE(queue.toUi().try_dequeue(message));
-    REQUIRE(message.paramId == id_p);
-    REQUIRE(message.value == Approx(0.4f));
+    std::vector<float> received;
+    plugin.params.getInfo("p").on_value_changed.connect([&](float value) { received.push_back(value); });
+    plugin.params.dispatchHostChanges();
+    REQUIRE(received == std::vector<float>{0.4f});
 
     REQUIRE(out.values.size() == 1);
     REQUIRE(out.values[0].param_id == id_q2);
     REQUIRE(out.values[0].value == Approx(0.8));
 }
 
+TEST_CASE("ParamsExtension bounded message queue", "[params][process][queue]") {
+    TestPlugin plugin;
+    plugin.params.registerParam(makeConfig("p", 0.5f));
+    const auto& info = plugin.params.getInfo("p");
+
+    ParamMessageQueue queue(4);
+    plugin.params.setMessageQueue(&queue);
+    const size_t capacity = queue.toAudio().max_capacity();
+
+    SECTION("full queues drop and count instead of growing") {
+        ParamMessageQueue::Message message{ParamMessageQueue::PARAM_VALUE, info.clapId, 0.0f};
+        for (size_t i = 0; i < capacity; ++i) {
+            REQUIRE(queue.sendToUi(message));
+        }
+        REQUIRE_FALSE(queue.sendToUi(message));
+        REQUIRE(queue.getDroppedToUi() == 1);
+        REQUIRE(queue.getDroppedToAudio() == 0);
+        REQUIRE(queue.toUi().max_capacity() == capacity);
+    }
+
+    SECTION("overflowing UI values reach the host coalesced") {
+        const size_t sent = capacity + 5;
+        for (size_t i = 1; i <= sent; ++i) {
+            info.setValueNotifyingHost(0.01f * static_cast<float>(i));
+        }
+        REQUIRE(queue.getDroppedToAudio() == 5);
+
+        OutList out;
+        plugin.params.processEvents(nullptr, &out.out);
+        REQUIRE(out.values.size() == capacity + 1);
+        REQUIRE(out.values.back().param_id == info.clapId);
+        REQUIRE(out.values.back().value == Approx(0.01f * static_cast<float>(sent)));
+
+        OutList next;
+        plugin.params.processEvents(nullptr, &next.out);
+        REQUIRE(next.values.empty());
+    }
+
+    SECTION("a gesture whose begin overflows is dropped whole") {
+        for (size_t i = 0; i < capacity; ++i) info.setValueNotifyingHost(0.5f);
+        info.beginGesture();
+        info.endGesture();
+        REQUIRE(queue.getDroppedToAudio() == 1);
+
+        OutList out;
+        plugin.params.processEvents(nullptr, &out.out);
+        REQUIRE(out.gestures.empty());
+    }
+
+    SECTION("a gesture whose end overflows still ends, after its values") {
+        info.beginGesture();
+        for (size_t i = 1; i < capacity; ++i) info.setValueNotifyingHost(0.01f * static_cast<float>(i));
+        info.endGesture();
+
+        // Grabbing the control again before the end went out carries on the same gesture
+        info.beginGesture();
+        info.setValueNotifyingHost(0.9f);
+        info.endGesture();
+
+        OutList out;
+        plugin.params.processEvents(nullptr, &out.out);
+        REQUIRE(out.types.front() == CLAP_EVENT_PARAM_GESTURE_BEGIN);
+        REQUIRE(out.types.back() == CLAP_EVENT_PARAM_GESTURE_END);
+        REQUIRE(out.gestures.size() == 2);
+        REQUIRE(out.values.back().value == Approx(0.9f));
+
+        OutList next;
+        plugin.params.processEvents(nullptr, &next.out);
+        REQUIRE(next.types.empty());
+
+        // With the end sent, the next gesture begins afresh
+        info.beginGesture();
+        info.endGesture();
+        OutList again;
+        plugin.params.processEvents(nullptr, &again.out);
+        REQUIRE(again.types ==
+                std::vector<uint16_t>{CLAP_EVENT_PARAM_GESTURE_BEGIN, CLAP_EVENT_PARAM_GESTURE_END});
+    }
+}
+
+TEST_CASE("ParamsExtension bulk changes", "[params][process][bulk]") {
+    TestPlugin plugin;
+    plugin.params.registerParam(makeConfig("a", 0.5f));
+    plugin.params.registerParam(makeConfig("b", 0.5f));
+    plugin.params.registerParam(makeConfig("c", 0.5f));
+    const auto& a = plugin.params.getInfo("a");
+    const auto& c = plugin.params.getInfo("c");
+
+    ParamMessageQueue queue(4);
+    plugin.params.setMessageQueue(&queue);
+
+    int notified = 0;
+    c.on_value_changed.connect([&](float) { ++notified; });
+
+    // A morph writing far more values than the queue holds
+    plugin.params.beginBulkChange();
+    plugin.params.beginBulkChange();
+    for (int step = 1; step <= 100; ++step) {
+        c.setValueNotifyingHost(0.01f * static_cast<float>(step));
+        a.setValueNotifyingHost(1.0f - 0.01f * static_cast<float>(step));
+    }
+    plugin.params.endBulkChange();
+    REQUIRE(notified == 100);
+    REQUIRE(queue.toAudio().size_approx() == 0);
+    REQUIRE(queue.getDroppedToAudio() == 0);
+
+    // Nothing is sent until the outermost bulk change ends
+    OutList early;
+    plugin.params.processEvents(nullptr, &early.out);
+    REQUIRE(early.types.empty());
+
+    plugin.params.endBulkChange();
+    OutList out;
+    plugin.params.processEvents(nullptr, &out.out);
+    REQUIRE(out.types == std::vector<uint16_t>{CLAP_EVENT_PARAM_GESTURE_BEGIN, CLAP_EVENT_PARAM_GESTURE_BEGIN,
+                                               CLAP_EVENT_PARAM_VALUE, CLAP_EVENT_PARAM_VALUE,
+                                               CLAP_EVENT_PARAM_GESTURE_END, CLAP_EVENT_PARAM_GESTURE_END});
+    REQUIRE(out.gestures[0].param_id == a.clapId);
+    REQUIRE(out.gestures[1].param_id == c.clapId);
+    REQUIRE(out.values[0].param_id == a.clapId);
+    REQUIRE(out.values[0].value == Approx(0.0f).margin(1e-6));
+    REQUIRE(out.values[1].param_id == c.clapId);
+    REQUIRE(out.values[1].value == Approx(1.0f));
+
+    OutList next;
+    plugin.params.processEvents(nullptr, &next.out);
+    REQUIRE(next.types.empty());
+
+    // Outside of bulk changes values are queued one by one again
+    a.setValueNotifyingHost(0.3f);
+    REQUIRE(queue.toAudio().size_approx() == 1);
+}
+
+TEST_CASE("ParamsExtension wakes an idle UI on host changes", "[params][process][wake]") {
+    FakeHost fake;
+    TestPlugin plugin(&fake.host);
+    plugin.params.registerParam(makeConfig("p", 0.5f));
+    const clap_id id = plugin.params.getInfo("p").clapId;
+    REQUIRE(plugin.clapPlugin()->init(plugin.clapPlugin()));
+
+    int wakes = 0;
+    EventList list;
+    list.events.push_back(makeEvent(id, nullptr, 0.6));
+
+    // Without a wake callback the UI has to keep polling
+    REQUIRE_FALSE(plugin.params.armUiWake());
+    plugin.params.setUiWakeCallback([&] { ++wakes; });
+
+    SECTION("the first change after arming requests one main-thread callback") {
+        REQUIRE(plugin.params.armUiWake());
+        plugin.params.processEvents(&list.in, nullptr);
+        plugin.params.processEvents(&list.in, nullptr);
+        REQUIRE(fake.callback_requests == 1);
+        REQUIRE(wakes == 0);
+
+        plugin.clapPlugin()->on_main_thread(plugin.clapPlugin());
+        REQUIRE(wakes == 1);
+        plugin.clapPlugin()->on_main_thread(plugin.clapPlugin());
+        REQUIRE(wakes == 1);
+        REQUIRE(plugin.params.dispatchHostChanges() == 1);
+    }
+
+    SECTION("changes that arrive unarmed don't call the host") {
+        plugin.params.processEvents(&list.in, nullptr);
+        REQUIRE(fake.callback_requests == 0);
+
+        // ...and keep the UI from going idle until dispatched
+        REQUIRE_FALSE(plugin.params.armUiWake());
+        REQUIRE(plugin.params.dispatchHostChanges() == 1);
+        REQUIRE(plugin.params.armUiWake());
+    }
+
+    SECTION("clearing the callback disarms") {
+        REQUIRE(plugin.params.armUiWake());
+        plugin.params.setUiWakeCallback(nullptr);
+        plugin.params.processEvents(&list.in, nullptr);
+        REQUIRE(fake.callback_requests == 0);
+    }
+}
+
 TEST_CASE("ParamInfo UI methods notify host and queue", "[params][ui][host]") {
     FakeHost fake;
     TestPlugin plugin(&fake.host);
@@ -593,11 +1216,13 @@ TEST_CASE("ParamInfo UI methods notify host and queue", "[params][ui][host]") {
     }
 
     SECTION("endGesture queues and flushes") {
+        info.beginGesture();
+        REQUIRE(queue.toAudio().try_dequeue(message));
         info.endGesture();
         REQUIRE(queue.toAudio().try_dequeue(message));
         REQUIRE(message.type == ParamMessageQueue::END_GESTURE);
         REQUIRE(message.paramId == id);
-        REQUIRE(fake.flush_count == 1);
+        REQUIRE(fake.flush_count == 2);
     }
 }
 
@@ -658,6 +1283,48 @@ TEST_CASE("ParamsExtension normalization", "[params][scaling]") {
     }
 }
 
+TEST_CASE("ParamsExtension packed DSP storage", "[params][scaling][storage]") {
+    TestPlugin plugin;
+    auto quad = rangedConfig("q", 0.0f, 4.0f, 1.0f);
+    quad.scaling = ValueScaling::quadratic();
+    quad.is_polyphonic = true;
+    plugin.params.registerParam(quad);
+    auto mode = rangedConfig("mode", 0.0f, 3.0f, 0.0f, true);
+    mode.is_internal = true;
+    plugin.params.registerParam(mode);
+
+    // Every DSP array starts on its own cache line
+    const auto aligned = [](const void* p) { return reinterpret_cast<uintptr_t>(p) % 64 == 0; };
+    REQUIRE(aligned(plugin.params.getValuesArray()));
+    REQUIRE(aligned(plugin.params.getNormalizedArray()));
+    REQUIRE(aligned(plugin.params.getScaleInfoArray()));
+    REQUIRE(aligned(plugin.params.getModulationArray()));
+    REQUIRE(aligned(plugin.params.getFlagsArray()));
+
+    REQUIRE(plugin.params.getFlagsArray()[0] == kParamPolyphonic);
+    REQUIRE(plugin.params.getFlagsArray()[1] == (kParamStepped | kParamInternal));
+
+    // The normalized cache follows every kind of write
+    const auto& handle = plugin.params.getHandle("q");
+    REQUIRE(handle.getNormalizedValue() == Approx(0.5f));
+
+    EventList list;
+    list.events.push_back(makeEvent(plugin.params.getInfo("q").clapId, nullptr, 4.0));
+    plugin.params.processEvents(&list.in, nullptr);
+    REQUIRE(handle.getNormalizedValue() == Approx(1.0f));
+
+    plugin.params.getInfo("q").setValueSilently(0.0f);
+    REQUIRE(plugin.params.getNormalizedAt(0) == Approx(0.0f));
+
+    plugin.params.getInfo("q").setValueNotifyingHost(1.0f);
+    REQUIRE(handle.getNormalizedValue() == Approx(0.5f));
+
+    applause::json state = applause::json::array();
+    state.push_back({{"id", plugin.params.getInfo("mode").clapId}, {"value", 3.0f}});
+    REQUIRE(plugin.params.loadFromJson(state));
+    REQUIRE(plugin.params.getNormalizedArray()[1].load() == Approx(1.0f));
+}
+
 TEST_CASE("ParamsExtension JSON save and load", "[params][json]") {
     TestPlugin plugin;
     plugin.params.registerParam(makeConfig("a", 0.5f));
@@ -718,18 +1385,98 @@ TEST_CASE("ParamsExtension JSON save and load", "[params][json]") {
         REQUIRE(plugin.params.getInfo("a").getValue() == 1.0f);
     }
 
-    SECTION("loading pushes changes to the UI queue") {
-        ParamMessageQueue queue;
-        plugin.params.setMessageQueue(&queue);
+    SECTION("loading notifies the UI") {
+        std::vector<float> received;
+        plugin.params.getInfo("a").on_value_changed.connect([&](float value) { received.push_back(value); });
         applause::json state = applause::json::array();
         state.push_back({{"id", id_a}, {"value", 0.42f}});
         REQUIRE(plugin.params.loadFromJson(state));
 
-        ParamMessageQueue::Message message{};
-        REQUIRE(queue.toUi().try_dequeue(message));
-        REQUIRE(message.type == ParamMessageQueue::PARAM_VALUE);
-        REQUIRE(message.paramId == id_a);
-        REQUIRE(message.value == Approx(0.42f));
-        REQUIRE_FALSE(queue.toUi().try_dequeue(message));
+        plugin.params.dispatchHostChanges();
+        REQUIRE(received.size() == 1);
+        REQUIRE(received[0] == Approx(0.42f));
+    }
+}
+
+TEST_CASE("ParamsExtension stages state loads while active", "[params][json][staged]") {
+    FakeHost fake;
+    TestPlugin plugin(&fake.host);
+    plugin.params.registerParam(makeConfig("a", 0.5f));
+    plugin.params.registerParam(makeConfig("b", 0.25f));
+    REQUIRE(plugin.clapPlugin()->init(plugin.clapPlugin()));
+    plugin.params.activate({48000.0, 1, 64});
+
+    applause::json state = applause::json::array();
+    state.push_back({{"id", plugin.params.getInfo("a").clapId}, {"value", 0.9f}});
+    state.push_back({{"id", plugin.params.getInfo("b").clapId}, {"value", 0.1f}});
+    REQUIRE(plugin.params.loadFromJson(state));
+
+    // Nothing changes mid-block, but the host is asked for one, in case the plugin sleeps
+    REQUIRE(plugin.params.getInfo("a").getValue() == 0.5f);
+    REQUIRE(plugin.params.getInfo("b").getValue() == 0.25f);
+    REQUIRE(fake.flush_count == 1);
+
+    // The next block boundary applies the whole state, before the block's own events
+    EventList list;
+    list.events.push_back(makeEvent(plugin.params.getInfo("b").clapId, nullptr, 0.75));
+    plugin.params.processEvents(&list.in, nullptr);
+    REQUIRE(plugin.params.getInfo("a").getValue() == Approx(0.9f));
+    REQUIRE(plugin.params.getInfo("b").getValue() == Approx(0.75f));
+
+    bool notified = false;
+    plugin.params.getInfo("a").on_value_changed.connect([&](float) { notified = true; });
+    plugin.params.dispatchHostChanges();
+    REQUIRE(notified);
+
+    // Deactivating applies a load no block picked up, and later loads apply right away
+    state[0]["value"] = 0.2f;
+    REQUIRE(plugin.params.loadFromJson(state));
+    REQUIRE(plugin.params.getInfo("a").getValue() == Approx(0.9f));
+    plugin.params.deactivate();
+    REQUIRE(plugin.params.getInfo("a").getValue() == Approx(0.2f));
+
+    state[0]["value"] = 0.3f;
+    REQUIRE(plugin.params.loadFromJson(state));
+    REQUIRE(plugin.params.getInfo("a").getValue() == Approx(0.3f));
+    REQUIRE(fake.flush_count == 2);
+}
+
+TEST_CASE("ParamsExtension binary save and load", "[params][binary]") {
+    TestPlugin plugin;
+    plugin.params.registerParam(makeConfig("a", 0.5f));
+    plugin.params.registerParam(makeConfig("b", 0.25f));
+    plugin.params.getInfo("a").setValueSilently(0.7f);
+
+    applause::json saved;
+    REQUIRE(plugin.params.saveToBinary(saved));
+    REQUIRE(saved.is_binary());
+    REQUIRE(saved.get_binary().size() == 4 + 2 * 8);
+
+    SECTION("round trip survives CBOR and JSON text") {
+        for (const auto& state : {applause::json::from_cbor(applause::json::to_cbor(saved)),
+                                  applause::json::parse(saved.dump())}) {
+            TestPlugin other;
+            other.params.registerParam(makeConfig("b", 0.5f));
+            other.params.registerParam(makeConfig("a", 0.5f));
+            REQUIRE(other.params.loadFromBinary(state));
+            REQUIRE(other.params.getInfo("a").getValue() == 0.7f);
+            REQUIRE(other.params.getInfo("b").getValue() == 0.25f);
+        }
+    }
+
+    SECTION("JSON states still load") {
+        applause::json state;
+        REQUIRE(plugin.params.saveToJson(state));
+        plugin.params.getInfo("a").setValueSilently(0.1f);
+        REQUIRE(plugin.params.loadFromBinary(state));
+        REQUIRE(plugin.params.getInfo("a").getValue() == Approx(0.7f));
+    }
+
+    SECTION("truncated data is rejected") {
+        auto bytes = saved.get_binary();
+        bytes.resize(bytes.size() - 1);
+        plugin.params.getInfo("a").setValueSilently(0.1f);
+        REQUIRE_FALSE(plugin.params.loadFromBinary(applause::json::binary(bytes)));
+        REQUIRE(plugin.params.getInfo("a").getValue() == 0.1f);
     }
 }
@@ -0,0 +1,242 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/PresetDiscoveryFactory.h>
+#include <applause/extensions/PresetLoadExtension.h>
+#include <applause/extensions/StateExtension.h>
+#include <applause/util/PresetIndex.h>
+
+using namespace applause;
+namespace fs = std::filesystem;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+
+struct TestPlugin : PluginBase {
+    StateExtension state;
+    PresetLoadExtension presets{state};
+    applause::json current = {{"cutoff", 500.0}};
+
+    TestPlugin() : PluginBase(&kDesc, nullptr) {
+        state.setSaveCallback([this](applause::json& json) {
+            json = current;
+            return true;
+        });
+        state.setLoadCallback([this](const applause::json& json) {
+            if (!json.contains("cutoff")) return false;
+            current = json;
+            return true;
+        });
+        registerExtension(state);
+        registerExtension(presets);
+    }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+
+    const clap_plugin_preset_load_t* clapPresetLoad() {
+        return static_cast<const clap_plugin_preset_load_t*>(presets.getClapExtensionStruct());
+    }
+};
+
+struct TempDir {
+    fs::path path = fs::temp_directory_path() / ("applause-presets-" + std::to_string(std::random_device{}()));
+    TempDir() { fs::create_directories(path); }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+struct Indexer {
+    std::vector<std::string> extensions;
+    std::vector<std::string> locations;
+    clap_preset_discovery_indexer_t indexer{
+        .clap_version = CLAP_VERSION,
+        .name = "test",
+        .vendor = "Applause",
+        .url = "",
+        .version = "1.0",
+        .indexer_data = this,
+        .declare_filetype = [](const clap_preset_discovery_indexer_t* i,
+                               const clap_preset_discovery_filetype_t* filetype) {
+            static_cast<Indexer*>(i->indexer_data)->extensions.emplace_back(filetype->file_extension);
+            return true;
+        },
+        .declare_location = [](const clap_preset_discovery_indexer_t* i,
+                               const clap_preset_discovery_location_t* location) {
+            static_cast<Indexer*>(i->indexer_data)->locations.emplace_back(location->location);
+            return true;
+        },
+        .declare_soundpack = [](const clap_preset_discovery_indexer_t*, const clap_preset_discovery_soundpack_t*) {
+            return true;
+        },
+        .get_extension = [](const clap_preset_discovery_indexer_t*, const char*) -> const void* { return nullptr; },
+    };
+};
+
+struct FoundPreset {
+    std::string name;
+    std::string load_key;
+    std::string plugin_id;
+    uint32_t flags = 0;
+    std::vector<std::string> features;
+    clap_timestamp modified = CLAP_TIMESTAMP_UNKNOWN;
+};
+
+struct Receiver {
+    std::vector<FoundPreset> presets;
+    int errors = 0;
+
+    static Receiver* self(const clap_preset_discovery_metadata_receiver_t* r) {
+        return static_cast<Receiver*>(r->receiver_data);
+    }
+
+    clap_preset_discovery_metadata_receiver_t receiver{
+        .receiver_data = this,
+        .on_error = [](const clap_preset_discovery_metadata_receiver_t* r, int32_t, const char*) { self(r)->errors++; },
+        .begin_preset = [](const clap_preset_discovery_metadata_receiver_t* r, const char* name, const char* key) {
+            FoundPreset& preset = self(r)->presets.emplace_back();
+            preset.name = name;
+            preset.load_key = key ? key : "";
+            return true;
+        },
+        .add_plugin_id = [](const clap_preset_discovery_metadata_receiver_t* r, const clap_universal_plugin_id_t* id) {
+            self(r)->presets.back().plugin_id = id->id;
+        },
+        .set_soundpack_id = [](const clap_preset_discovery_metadata_receiver_t*, const char*) {},
+        .set_flags = [](const clap_preset_discovery_metadata_receiver_t* r, uint32_t flags) {
+            self(r)->presets.back().flags = flags;
+        },
+        .add_creator = [](const clap_preset_discovery_metadata_receiver_t*, const char*) {},
+        .set_description = [](const clap_preset_discovery_metadata_receiver_t*, const char*) {},
+        .set_timestamps = [](const clap_preset_discovery_metadata_receiver_t* r, clap_timestamp, clap_timestamp mod) {
+            self(r)->presets.back().modified = mod;
+        },
+        .add_feature = [](const clap_preset_discovery_metadata_receiver_t* r, const char* feature) {
+            self(r)->presets.back().features.emplace_back(feature);
+        },
+        .add_extra_info = [](const clap_preset_discovery_metadata_receiver_t*, const char*, const char*) {},
+    };
+};
+}  // namespace
+
+TEST_CASE("PresetLoadExtension saves and loads presets through the state callbacks", "[presets]") {
+    TempDir dir;
+    TestPlugin plugin;
+    const fs::path file = dir.path / "Bass" / "Deep.aplp";
+
+    REQUIRE(plugin.presets.savePreset(file, {.name = "Deep", .tags = {"bass"}}));
+    CHECK_FALSE(fs::exists(file.string() + ".tmp"));
+
+    // Presets always carry the binary state, whatever format host states use
+    PresetMetadata header;
+    REQUIRE(readPresetMetadata(file, header));
+    CHECK(header.name == "Deep");
+
+    PresetMetadata loaded_metadata;
+    plugin.presets.setLoadedCallback([&](const PresetMetadata& metadata) { loaded_metadata = metadata; });
+
+    plugin.current = {{"cutoff", 1000.0}};
+    REQUIRE(plugin.presets.loadPreset(file));
+    CHECK(plugin.current["cutoff"] == 500.0);
+    CHECK(loaded_metadata.tags == std::vector<std::string>{"bass"});
+
+    SECTION("Hosts load files directly or through a directory and load key") {
+        const clap_plugin_preset_load_t* clap = plugin.clapPresetLoad();
+        plugin.current = {{"cutoff", 1000.0}};
+        REQUIRE(clap->from_location(plugin.clapPlugin(), CLAP_PRESET_DISCOVERY_LOCATION_FILE,
+                                    pathToUtf8(file).c_str(), nullptr));
+        CHECK(plugin.current["cutoff"] == 500.0);
+
+        plugin.current = {{"cutoff", 1000.0}};
+        REQUIRE(clap->from_location(plugin.clapPlugin(), CLAP_PRESET_DISCOVERY_LOCATION_FILE,
+                                    pathToUtf8(dir.path).c_str(), "Bass/Deep.aplp"));
+        CHECK(plugin.current["cutoff"] == 500.0);
+
+        CHECK_FALSE(clap->from_location(plugin.clapPlugin(), CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN, "x", nullptr));
+        CHECK_FALSE(clap->from_location(plugin.clapPlugin(), CLAP_PRESET_DISCOVERY_LOCATION_FILE,
+                                        pathToUtf8(dir.path / "missing.aplp").c_str(), nullptr));
+    }
+
+    SECTION("Failed saves leave existing presets alone") {
+        plugin.state.setSaveCallback([](applause::json&) { return false; });
+        CHECK_FALSE(plugin.presets.savePreset(file, {.name = "Broken"}));
+        REQUIRE(readPresetMetadata(file, header));
+        CHECK(header.name == "Deep");
+    }
+
+    SECTION("Rejected states fail the load") {
+        plugin.current = {{"other", 1}};
+        REQUIRE(plugin.presets.savePreset(dir.path / "Other.aplp", {}));
+        CHECK_FALSE(plugin.presets.loadPreset(dir.path / "Other.aplp"));
+    }
+}
+
+TEST_CASE("PresetDiscoveryFactory reports presets from its index", "[presets]") {
+    TempDir dir;
+    TestPlugin plugin;
+    const fs::path factory_dir = dir.path / "Factory";
+    REQUIRE(plugin.presets.savePreset(factory_dir / "Lead.aplp", {.name = "Lead", .tags = {"lead", "bright"}}));
+    REQUIRE(plugin.presets.savePreset(factory_dir / "Pads" / "Untitled.aplp", {}));
+    const fs::path index_file = dir.path / "cache" / "index.cbor";
+
+    const PresetDiscoveryFactory factory({
+        .provider_id = "test.presets",
+        .name = "Test Presets",
+        .vendor = "Applause",
+        .plugin_id = "test.plugin",
+        .locations = {{.name = "Factory", .path = factory_dir, .flags = CLAP_PRESET_DISCOVERY_IS_FACTORY_CONTENT}},
+        .index_file = index_file,
+    });
+    const clap_preset_discovery_factory_t* clap = factory.clapFactory();
+    REQUIRE(clap->count(clap) == 1);
+    REQUIRE(std::string(clap->get_descriptor(clap, 0)->id) == "test.presets");
+
+    Indexer indexer;
+    CHECK(clap->create(clap, &indexer.indexer, "other.presets") == nullptr);
+
+    auto scan = [&](uint32_t kind, const fs::path& location) {
+        const clap_preset_discovery_provider_t* provider = clap->create(clap, &indexer.indexer, "test.presets");
+        REQUIRE(provider != nullptr);
+        REQUIRE(provider->init(provider));
+        Receiver receiver;
+        const bool ok = provider->get_metadata(provider, kind, pathToUtf8(location).c_str(), &receiver.receiver);
+        provider->destroy(provider);
+        return std::make_pair(ok, receiver);
+    };
+
+    auto [ok, found] = scan(CLAP_PRESET_DISCOVERY_LOCATION_FILE, factory_dir);
+    REQUIRE(ok);
+    CHECK(indexer.extensions == std::vector<std::string>{"aplp"});
+    CHECK(indexer.locations == std::vector<std::string>{pathToUtf8(factory_dir)});
+
+    REQUIRE(found.presets.size() == 2);
+    CHECK(found.presets[0].name == "Lead");
+    CHECK(found.presets[0].load_key == "Lead.aplp");
+    CHECK(found.presets[0].plugin_id == "test.plugin");
+    CHECK(found.presets[0].flags == CLAP_PRESET_DISCOVERY_IS_FACTORY_CONTENT);
+    CHECK(found.presets[0].features == std::vector<std::string>{"lead", "bright"});
+    CHECK(found.presets[0].modified != CLAP_TIMESTAMP_UNKNOWN);
+    CHECK(found.presets[1].name == "Untitled");  // Named after the file without a name in the header
+    CHECK(found.presets[1].load_key == "Pads/Untitled.aplp");
+
+    // The provider left its index behind for the next scan
+    PresetIndex index;
+    REQUIRE(index.load(index_file));
+    CHECK(index.size() == 2);
+
+    SECTION("Single files are reported without a load key") {
+        auto [file_ok, file_found] = scan(CLAP_PRESET_DISCOVERY_LOCATION_FILE, factory_dir / "Lead.aplp");
+        REQUIRE(file_ok);
+        REQUIRE(file_found.presets.size() == 1);
+        CHECK(file_found.presets[0].load_key.empty());
+
+        auto [bad_ok, bad_found] = scan(CLAP_PRESET_DISCOVERY_LOCATION_FILE, factory_dir / "missing.aplp");
+        CHECK_FALSE(bad_ok);
+        CHECK(bad_found.errors == 1);
+    }
+}
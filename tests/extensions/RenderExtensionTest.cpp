@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/RenderExtension.h>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+const clap_host_t kHost{};
+
+struct RenderPlugin : PluginBase {
+    RenderExtension render;
+    QualityTier tier_in_process = QualityTier::Realtime;
+
+    RenderPlugin() : PluginBase(&kDesc, &kHost) { registerExtension(render); }
+    ProcessStatus process(ProcessContext&) noexcept override {
+        tier_in_process = currentQualityTier();
+        return ProcessStatus::Continue;
+    }
+};
+}  // namespace
+
+TEST_CASE("RenderExtension switches process() to the offline quality tier", "[extensions][render]") {
+    RenderPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    REQUIRE(clap->activate(clap, 48000.0, 1, 256));
+    const auto* ext = static_cast<const clap_plugin_render_t*>(clap->get_extension(clap, CLAP_EXT_RENDER));
+    REQUIRE(ext == plugin.render.getClapExtensionStruct());
+
+    clap_process_t process{};
+    process.frames_count = 64;
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.tier_in_process == QualityTier::Realtime);
+
+    REQUIRE(ext->set(clap, CLAP_RENDER_OFFLINE));
+    CHECK(plugin.render.isOffline());
+    CHECK(plugin.getQualityTier() == QualityTier::Offline);
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.tier_in_process == QualityTier::Offline);
+    // The tier only applies inside process()
+    CHECK(currentQualityTier() == QualityTier::Realtime);
+
+    REQUIRE(ext->set(clap, CLAP_RENDER_REALTIME));
+    REQUIRE(clap->process(clap, &process) == CLAP_PROCESS_CONTINUE);
+    CHECK(plugin.tier_in_process == QualityTier::Realtime);
+    clap->deactivate(clap);
+}
+
+TEST_CASE("RenderExtension refuses offline rendering with a hard real-time requirement", "[extensions][render]") {
+    RenderPlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    const auto* ext = static_cast<const clap_plugin_render_t*>(plugin.render.getClapExtensionStruct());
+    CHECK_FALSE(ext->has_hard_realtime_requirement(clap));
+
+    plugin.render.setHardRealtime(true);
+    CHECK(ext->has_hard_realtime_requirement(clap));
+    CHECK_FALSE(ext->set(clap, CLAP_RENDER_OFFLINE));
+    CHECK_FALSE(plugin.render.isOffline());
+    CHECK(ext->set(clap, CLAP_RENDER_REALTIME));
+}
+
+TEST_CASE("QualityTierScope nests and restores the previous tier", "[extensions][render]") {
+    CHECK(currentQualityTier() == QualityTier::Realtime);
+    {
+        const QualityTierScope offline{QualityTier::Offline};
+        CHECK(currentQualityTier() == QualityTier::Offline);
+        {
+            const QualityTierScope realtime{QualityTier::Realtime};
+            CHECK(currentQualityTier() == QualityTier::Realtime);
+        }
+        CHECK(currentQualityTier() == QualityTier::Offline);
+    }
+    CHECK(currentQualityTier() == QualityTier::Realtime);
+}
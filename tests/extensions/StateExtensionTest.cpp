@@ -0,0 +1,198 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/StateExtension.h>
+#include <applause/util/ClapStreamBuf.h>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+
+struct TestPlugin : PluginBase {
+    StateExtension state;
+    TestPlugin() : PluginBase(&kDesc, nullptr) { registerExtension(state); }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+
+    const clap_plugin_state_t* clapState() {
+        return static_cast<const clap_plugin_state_t*>(state.getClapExtensionStruct());
+    }
+};
+
+// Accepts at most max_write bytes per call, like hosts writing to small pipes; fails after fail_after bytes
+struct OutStream {
+    std::string data;
+    size_t max_write = 100;
+    size_t fail_after = SIZE_MAX;
+    int calls = 0;
+    clap_ostream_t stream{
+        .ctx = this,
+        .write = [](const clap_ostream_t* s, const void* buffer, uint64_t size) -> int64_t {
+            auto* self = static_cast<OutStream*>(s->ctx);
+            self->calls++;
+            if (self->data.size() >= self->fail_after) return -1;
+            const size_t n = std::min<size_t>(size, self->max_write);
+            self->data.append(static_cast<const char*>(buffer), n);
+            return static_cast<int64_t>(n);
+        },
+    };
+};
+
+// Hands out at most max_read bytes per call; fails after fail_after bytes
+struct InStream {
+    std::string data;
+    size_t pos = 0;
+    size_t max_read = 7;
+    size_t fail_after = SIZE_MAX;
+    clap_istream_t stream{
+        .ctx = this,
+        .read = [](const clap_istream_t* s, void* buffer, uint64_t size) -> int64_t {
+            auto* self = static_cast<InStream*>(s->ctx);
+            if (self->pos >= self->fail_after) return -1;
+            const size_t n = std::min<size_t>({size, self->max_read, self->data.size() - self->pos});
+            std::copy_n(self->data.data() + self->pos, n, static_cast<char*>(buffer));
+            self->pos += n;
+            return static_cast<int64_t>(n);
+        },
+    };
+};
+
+applause::json makeState() {
+    applause::json state;
+    state["name"] = "patch";
+    state["table"] = applause::json::array();
+    for (int i = 0; i < 2000; ++i) state["table"].push_back(i * 0.5);
+    return state;
+}
+}  // namespace
+
+TEST_CASE("StateExtension streams JSON state through the host's streams", "[state]") {
+    TestPlugin plugin;
+    const applause::json saved = makeState();
+    applause::json loaded;
+    plugin.state.setSaveCallback([&](applause::json& json) {
+        json = saved;
+        return true;
+    });
+    plugin.state.setLoadCallback([&](const applause::json& json) {
+        loaded = json;
+        return true;
+    });
+    REQUIRE(plugin.state.isConfigured());
+
+    OutStream out;
+    REQUIRE(plugin.clapState()->save(plugin.clapPlugin(), &out.stream));
+    REQUIRE(out.data == saved.dump());
+    REQUIRE(out.data.size() > kClapStreamChunkSize);
+
+    SECTION("round trip with short reads") {
+        InStream in;
+        in.data = out.data;
+        REQUIRE(plugin.clapState()->load(plugin.clapPlugin(), &in.stream));
+        REQUIRE(loaded == saved);
+    }
+
+    SECTION("write errors fail the save") {
+        OutStream failing;
+        failing.fail_after = 1000;
+        REQUIRE_FALSE(plugin.clapState()->save(plugin.clapPlugin(), &failing.stream));
+    }
+
+    SECTION("read errors and truncated state fail the load") {
+        InStream failing;
+        failing.data = out.data;
+        failing.fail_after = 1000;
+        REQUIRE_FALSE(plugin.clapState()->load(plugin.clapPlugin(), &failing.stream));
+
+        InStream truncated;
+        truncated.data = out.data.substr(0, out.data.size() / 2);
+        REQUIRE_FALSE(plugin.clapState()->load(plugin.clapPlugin(), &truncated.stream));
+        REQUIRE(loaded.is_null());
+    }
+}
+
+TEST_CASE("StateExtension binary format", "[state][binary]") {
+    TestPlugin plugin;
+    const applause::json saved = makeState();
+    applause::json loaded;
+    plugin.state.setSaveCallback([&](applause::json& json) {
+        json = saved;
+        return true;
+    });
+    plugin.state.setLoadCallback([&](const applause::json& json) {
+        loaded = json;
+        return true;
+    });
+
+    OutStream text;
+    REQUIRE(plugin.clapState()->save(plugin.clapPlugin(), &text.stream));
+
+    plugin.state.setFormat(StateFormat::Binary);
+    OutStream binary;
+    REQUIRE(plugin.clapState()->save(plugin.clapPlugin(), &binary.stream));
+    REQUIRE(binary.data.starts_with(std::string("APLB\x01\x00\x00\x00", 8)));
+    REQUIRE(binary.data.size() < text.data.size());
+
+    SECTION("binary states load") {
+        InStream in;
+        in.data = binary.data;
+        REQUIRE(plugin.clapState()->load(plugin.clapPlugin(), &in.stream));
+        REQUIRE(loaded == saved);
+    }
+
+    SECTION("JSON states still load") {
+        InStream in;
+        in.data = text.data;
+        REQUIRE(plugin.clapState()->load(plugin.clapPlugin(), &in.stream));
+        REQUIRE(loaded == saved);
+    }
+
+    SECTION("newer versions and bad headers are rejected") {
+        InStream newer;
+        newer.data = binary.data;
+        newer.data[4] = 2;
+        REQUIRE_FALSE(plugin.clapState()->load(plugin.clapPlugin(), &newer.stream));
+
+        InStream bad;
+        bad.data = "APLX" + binary.data.substr(4);
+        REQUIRE_FALSE(plugin.clapState()->load(plugin.clapPlugin(), &bad.stream));
+        REQUIRE(loaded.is_null());
+    }
+}
+
+TEST_CASE("StateExtension raw stream callbacks", "[state]") {
+    TestPlugin plugin;
+    REQUIRE_FALSE(plugin.state.isConfigured());
+
+    std::string loaded;
+    plugin.state.setStreamSaveCallback([](std::ostream& out) {
+        for (int i = 0; i < 1000; ++i) out << "chunk" << i << ';';
+        return true;
+    });
+    plugin.state.setStreamLoadCallback([&](std::istream& in) {
+        loaded.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    });
+    REQUIRE(plugin.state.isConfigured());
+
+    OutStream out;
+    out.max_write = SIZE_MAX;
+    REQUIRE(plugin.clapState()->save(plugin.clapPlugin(), &out.stream));
+    REQUIRE(out.data.starts_with("chunk0;chunk1;"));
+
+    // Written in chunks, not a call per insertion
+    REQUIRE(out.calls == static_cast<int>((out.data.size() + kClapStreamChunkSize - 1) / kClapStreamChunkSize));
+
+    InStream in;
+    in.data = out.data;
+    in.max_read = SIZE_MAX;
+    REQUIRE(plugin.clapState()->load(plugin.clapPlugin(), &in.stream));
+    REQUIRE(loaded == out.data);
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/DelayReport.h>
+#include <applause/extensions/LatencyExtension.h>
+#include <applause/extensions/TailExtension.h>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+
+int tail_changed_calls = 0;
+int latency_changed_calls = 0;
+const clap_host_tail_t kHostTail{.changed = [](const clap_host_t*) { ++tail_changed_calls; }};
+const clap_host_latency_t kHostLatency{.changed = [](const clap_host_t*) { ++latency_changed_calls; }};
+
+clap_host_t makeHost() {
+    clap_host_t host{};
+    host.get_extension = [](const clap_host_t*, const char* id) -> const void* {
+        if (std::strcmp(id, CLAP_EXT_TAIL) == 0) return &kHostTail;
+        if (std::strcmp(id, CLAP_EXT_LATENCY) == 0) return &kHostLatency;
+        return nullptr;
+    };
+    return host;
+}
+const clap_host_t kHost = makeHost();
+
+struct TestPlugin : PluginBase {
+    LatencyExtension latency;
+    TailExtension tail;
+    DelayReport delays{&latency, &tail};
+
+    TestPlugin() : PluginBase(&kDesc, &kHost) {
+        registerExtension(latency);
+        registerExtension(tail);
+    }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+
+// Runs one empty block, after which the host hears of tail changes
+void processBlock(TestPlugin& plugin) {
+    clap_process_t process{};
+    process.frames_count = 64;
+    plugin.clapPlugin()->process(plugin.clapPlugin(), &process);
+}
+
+struct FakeOversampler {
+    uint32_t getLatency() const noexcept { return 12; }
+    uint32_t getTailSamples() const noexcept { return 12; }
+};
+
+struct FakeGain {};
+}  // namespace
+
+TEST_CASE("TailExtension reports the tail and notifies the host of changes", "[extensions][tail]") {
+    tail_changed_calls = 0;
+    TestPlugin plugin;
+    plugin.clapPlugin()->init(plugin.clapPlugin());
+    REQUIRE(plugin.clapPlugin()->activate(plugin.clapPlugin(), 48000.0, 1, 64));
+    const auto* ext = static_cast<const clap_plugin_tail_t*>(plugin.tail.getClapExtensionStruct());
+    CHECK(ext->get(plugin.clapPlugin()) == 0);
+
+    // The value is visible at once, the change notice waits for the audio thread
+    plugin.tail.setTail(48000);
+    CHECK(ext->get(plugin.clapPlugin()) == 48000);
+    CHECK(tail_changed_calls == 0);
+    processBlock(plugin);
+    CHECK(tail_changed_calls == 1);
+    processBlock(plugin);
+    CHECK(tail_changed_calls == 1);
+
+    plugin.tail.setTail(48000);
+    processBlock(plugin);
+    CHECK(tail_changed_calls == 1);
+
+    // Several changes between blocks are one notice
+    plugin.tail.setTail(100);
+    plugin.tail.setTail(200);
+    processBlock(plugin);
+    CHECK(tail_changed_calls == 2);
+
+    plugin.tail.setTail(UINT32_MAX);
+    CHECK(ext->get(plugin.clapPlugin()) == TailExtension::kInfiniteTail);
+}
+
+TEST_CASE("DelayReport sums the blocks in a chain and publishes changes", "[extensions][tail][latency]") {
+    tail_changed_calls = 0;
+    latency_changed_calls = 0;
+    TestPlugin plugin;
+    plugin.clapPlugin()->init(plugin.clapPlugin());
+    REQUIRE(plugin.clapPlugin()->activate(plugin.clapPlugin(), 48000.0, 1, 64));
+
+    const FakeOversampler oversampler;
+    plugin.delays.begin().add(oversampler).add(FakeGain{}).addLatency(64).addTail(96000).publish();
+    processBlock(plugin);
+    CHECK(plugin.latency.getLatency() == 76);
+    CHECK(plugin.tail.getTail() == 96012);
+    CHECK(latency_changed_calls == 1);
+    CHECK(tail_changed_calls == 1);
+
+    // Rebuilding the same chain doesn't bother the host
+    plugin.delays.begin().add(oversampler).addLatency(64).addTail(96000).publish();
+    processBlock(plugin);
+    CHECK(latency_changed_calls == 1);
+    CHECK(tail_changed_calls == 1);
+
+    plugin.delays.begin().add(oversampler).addTail(TailExtension::kInfiniteTail).publish();
+    processBlock(plugin);
+    CHECK(plugin.latency.getLatency() == 12);
+    CHECK(plugin.tail.getTail() == TailExtension::kInfiniteTail);
+    CHECK(latency_changed_calls == 2);
+    CHECK(tail_changed_calls == 2);
+}
@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+
+#include <applause/core/PluginBase.h>
+#include <applause/dsp/Synthesizer.h>
+#include <applause/extensions/VoiceInfoExtension.h>
+
+using namespace applause;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+
+int voice_info_changed_calls = 0;
+const clap_host_voice_info_t kHostVoiceInfo{.changed = [](const clap_host_t*) { ++voice_info_changed_calls; }};
+
+const clap_host_t kHost{
+    .get_extension = [](const clap_host_t*, const char* id) -> const void* {
+        return std::strcmp(id, CLAP_EXT_VOICE_INFO) == 0 ? &kHostVoiceInfo : nullptr;
+    },
+};
+
+struct SilentVoice : SynthesizerVoice<float, 2> {
+    void process(BufferView<float, 2>, int, int) override {}
+};
+
+struct VoicePlugin : PluginBase {
+    Synthesizer<float, 2, 12, SilentVoice> synth;
+    VoiceInfoExtension voice_info;
+
+    VoicePlugin() : PluginBase(&kDesc, &kHost) {
+        voice_info.setVoiceCount(synth.getNumVoices());
+        registerExtension(voice_info);
+    }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+}  // namespace
+
+TEST_CASE("VoiceInfoExtension reports the synthesizer's voices", "[extensions][voice-info]") {
+    voice_info_changed_calls = 0;
+    VoicePlugin plugin;
+    const clap_plugin_t* clap = plugin.clapPlugin();
+    REQUIRE(clap->init(clap));
+    const auto* ext = static_cast<const clap_plugin_voice_info_t*>(clap->get_extension(clap, CLAP_EXT_VOICE_INFO));
+    REQUIRE(ext != nullptr);
+
+    clap_voice_info_t info{};
+    REQUIRE(ext->get(clap, &info));
+    CHECK(info.voice_count == 12);
+    CHECK(info.voice_capacity == 12);
+    CHECK(info.flags == CLAP_VOICE_INFO_SUPPORTS_OVERLAPPING_NOTES);
+    CHECK(voice_info_changed_calls == 0);  // Set before the host was known
+
+    // A lower user polyphony keeps the synthesizer's capacity
+    plugin.voice_info.setVoiceCount(4, 12);
+    REQUIRE(ext->get(clap, &info));
+    CHECK(info.voice_count == 4);
+    CHECK(info.voice_capacity == 12);
+    CHECK(voice_info_changed_calls == 1);
+
+    plugin.voice_info.setVoiceCount(4, 12);
+    CHECK(voice_info_changed_calls == 1);
+}
@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/core/PluginBase.h>
+#include <applause/util/BackgroundJobs.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace applause;
+
+namespace {
+// Holds the pool's only thread until released, so tests can queue up jobs behind it
+struct Gate {
+    std::atomic<bool> entered{false};
+    std::atomic<bool> open{false};
+
+    JobGroup::Work work() {
+        return [this](const JobContext&) {
+            entered.store(true);
+            while (!open.load()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        };
+    }
+
+    void waitEntered() const {
+        while (!entered.load()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+};
+
+struct CallbackHost {
+    clap_host_t host{};
+    std::atomic<int> requests{0};
+
+    CallbackHost() {
+        host.host_data = this;
+        host.request_callback = [](const clap_host_t* h) { static_cast<CallbackHost*>(h->host_data)->requests++; };
+    }
+};
+}  // namespace
+
+TEST_CASE("BackgroundJobs runs higher priorities first and completes on dispatch", "[util][threads][jobs]") {
+    BackgroundJobs pool{1};
+    CallbackHost host;
+    JobGroup group{&host.host, &pool};
+
+    Gate gate;
+    group.submit(JobPriority::High, gate.work());
+    gate.waitEntered();
+
+    std::mutex mutex;
+    std::vector<int> ran;
+    std::vector<int> completed;
+    const auto job = [&](int id) {
+        return [&, id](const JobContext&) {
+            std::lock_guard lock{mutex};
+            ran.push_back(id);
+        };
+    };
+    const auto completion = [&](int id) {
+        return [&, id](JobStatus status) {
+            CHECK(status == JobStatus::Done);
+            completed.push_back(id);
+        };
+    };
+    group.submit(JobPriority::Low, job(3), completion(3));
+    group.submit(JobPriority::Normal, job(2), completion(2));
+    group.submit(JobPriority::High, job(1), completion(1));
+    const JobHandle last = group.submit(JobPriority::Low, job(4), completion(4));
+    CHECK(pool.numQueued() == 4);
+    CHECK(group.numOutstanding() == 5);
+    CHECK(last.status() == JobStatus::Queued);
+
+    gate.open.store(true);
+    group.waitIdle();
+    CHECK(ran == std::vector<int>{1, 2, 3, 4});
+    CHECK(last.isFinished());
+
+    // Completions wait for the main thread, which the host was asked for once
+    CHECK(completed.empty());
+    CHECK(host.requests.load() == 1);
+    CHECK(group.dispatchCompletions() == 4);
+    CHECK(completed == std::vector<int>{1, 2, 3, 4});
+    CHECK(group.dispatchCompletions() == 0);
+}
+
+TEST_CASE("BackgroundJobs cancels queued and running jobs", "[util][threads][jobs]") {
+    BackgroundJobs pool{1};
+    JobGroup group{nullptr, &pool};
+    std::vector<JobStatus> statuses;
+    const auto record = [&](JobStatus status) { statuses.push_back(status); };
+
+    SECTION("A cancelled job doesn't start, but still completes") {
+        Gate gate;
+        group.submit(JobPriority::Normal, gate.work());
+        gate.waitEntered();
+        std::atomic<int> runs{0};
+        const JobHandle handle = group.submit(JobPriority::Normal, [&](const JobContext&) { runs++; }, record);
+        group.submit(JobPriority::Normal, [&](const JobContext&) { runs++; }, record);
+        handle.cancel();
+        gate.open.store(true);
+        group.waitIdle();
+        group.dispatchCompletions();
+        CHECK(runs.load() == 1);
+        CHECK(handle.status() == JobStatus::Cancelled);
+        CHECK(statuses == std::vector<JobStatus>{JobStatus::Cancelled, JobStatus::Done});
+    }
+
+    SECTION("Running work sees cancelAll() and ends Cancelled") {
+        std::atomic<bool> started{false};
+        const JobHandle handle = group.submit(
+            JobPriority::Low,
+            [&](const JobContext& job) {
+                started.store(true);
+                while (!job.isCancelled()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            },
+            record);
+        while (!started.load()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        CHECK(handle.status() == JobStatus::Running);
+        group.cancelAll();
+        group.waitIdle();
+        group.dispatchCompletions();
+        CHECK(statuses == std::vector<JobStatus>{JobStatus::Cancelled});
+
+        // Jobs submitted afterwards run as usual
+        group.submit(JobPriority::Low, [](const JobContext& job) { CHECK_FALSE(job.isCancelled()); }, record);
+        group.waitIdle();
+        group.dispatchCompletions();
+        CHECK(statuses.back() == JobStatus::Done);
+    }
+
+    SECTION("A job that throws fails without taking the thread down") {
+        group.submit(JobPriority::Normal, [](const JobContext&) { throw std::runtime_error("no such file"); }, record);
+        group.submit(JobPriority::Normal, [](const JobContext&) {}, record);
+        group.waitIdle();
+        group.dispatchCompletions();
+        CHECK(statuses == std::vector<JobStatus>{JobStatus::Failed, JobStatus::Done});
+    }
+}
+
+TEST_CASE("PluginBase waits for its background jobs and completes them on the main thread", "[util][threads][jobs]") {
+    struct JobPlugin : PluginBase {
+        explicit JobPlugin(const clap_host_t* host) : PluginBase(&desc, host) {}
+        clap_plugin_descriptor_t desc{};
+    };
+
+    CallbackHost host;
+    auto* plugin = new JobPlugin(&host.host);
+    const clap_plugin_t* clap = plugin->clapPlugin();
+    REQUIRE(clap->init(clap));
+
+    bool done = false;
+    plugin->backgroundJobs().submit(JobPriority::Normal, [](const JobContext&) {},
+                                    [&](JobStatus status) { done = status == JobStatus::Done; });
+    plugin->backgroundJobs().waitIdle();
+    CHECK(host.requests.load() == 1);
+    CHECK_FALSE(done);
+    clap->on_main_thread(clap);
+    CHECK(done);
+
+    // destroy() doesn't return while work is still running
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+    plugin->backgroundJobs().submit(JobPriority::Normal, [&](const JobContext& job) {
+        started.store(true);
+        while (!job.isCancelled()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        finished.store(true);
+    });
+    while (!started.load()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    clap->destroy(clap);
+    CHECK(finished.load());
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include <applause/util/ChainedMemoryArena.h>
+
+#include <cstdint>
+#include <cstring>
+
+TEST_CASE("ChainedMemoryArena grows instead of failing", "[util][memory]")
+{
+    applause::ChainedMemoryArena arena{256};
+    REQUIRE(arena.getNumBlocks() == 0);
+    REQUIRE(arena.getCapacity() == 0);
+
+    auto* first = static_cast<std::byte*>(arena.allocateBytes(200));
+    REQUIRE(first != nullptr);
+    REQUIRE(arena.getNumBlocks() == 1);
+
+    // Doesn't fit in the rest of the first block
+    auto* second = static_cast<std::byte*>(arena.allocateBytes(100));
+    REQUIRE(second != nullptr);
+    REQUIRE(arena.getNumBlocks() == 2);
+    REQUIRE(arena.getBytesUsed() == 300);
+    std::memset(first, 1, 200);
+    std::memset(second, 2, 100);
+    REQUIRE(first[199] == std::byte{1});
+
+    // Larger than a block: gets a block of its own
+    auto* big = arena.allocateBytes(1000, 64);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(big) % 64 == 0);
+    REQUIRE(arena.getNumBlocks() == 3);
+    REQUIRE(arena.getCapacity() >= 256 + 256 + 1000);
+}
+
+TEST_CASE("ChainedMemoryArena typed allocation", "[util][memory]")
+{
+    applause::ChainedMemoryArena arena{128};
+    auto span = arena.makeSpan<float>(100);
+    REQUIRE(span.size() == 100);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(span.data()) % applause::defaultByteAlignment == 0);
+
+    auto buffer = arena.allocateAudioBuffer<float, 2>(64);
+    REQUIRE(buffer.numChannels() == 2);
+    REQUIRE(buffer.numFrames() == 64);
+    buffer.clear();
+    REQUIRE(buffer.load(1, 63) == 0.0f);
+}
+
+TEST_CASE("ChainedMemoryArena frames rewind and reuse blocks", "[util][memory]")
+{
+    applause::ChainedMemoryArena arena{256};
+    arena.allocateBytes(100);
+    const size_t before = arena.getBytesUsed();
+
+    void* inside = nullptr;
+    {
+        auto frame = arena.createFrame();
+        arena.allocateBytes(200);
+        inside = arena.allocateBytes(200);
+        REQUIRE(arena.getNumBlocks() == 3);
+    }
+    REQUIRE(arena.getBytesUsed() == before);
+    REQUIRE(arena.getPeakBytesUsed() == 500);
+
+    // The same requests land in the same, already allocated blocks
+    arena.allocateBytes(200);
+    REQUIRE(arena.allocateBytes(200) == inside);
+    REQUIRE(arena.getNumBlocks() == 3);
+
+    arena.clear();
+    REQUIRE(arena.getBytesUsed() == 0);
+    REQUIRE(arena.getNumBlocks() == 3);
+    REQUIRE(arena.getPeakBytesUsed() == 500);
+
+    arena.release();
+    REQUIRE(arena.getNumBlocks() == 0);
+    REQUIRE(arena.getCapacity() == 0);
+}
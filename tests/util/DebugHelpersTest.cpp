@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/util/DebugHelpers.h>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef NDEBUG
+
+namespace {
+debug::LogRecord makeRecord(std::string_view text, int line) {
+    debug::LogRecord record;
+    record.file = "/path/to/Source.cpp";
+    record.func = "process";
+    record.line = line;
+    record.level = debug::Level::WARN;
+    record.length = static_cast<uint16_t>(text.size());
+    text.copy(record.text, text.size());
+    return record;
+}
+}  // namespace
+
+TEST_CASE("LogQueue writes queued records in order and counts drops", "[util][log]") {
+    debug::LogQueue<4> queue;
+    for (int i = 0; i < 4; ++i) REQUIRE(queue.push(makeRecord("message " + std::to_string(i), i)));
+    REQUIRE_FALSE(queue.push(makeRecord("dropped", 99)));
+
+    std::ostringstream out;
+    REQUIRE(queue.drain(out) == 4);
+    const std::string text = out.str();
+    CHECK(text.find("1 messages dropped") != std::string::npos);
+    CHECK(text.find("WARN  Source.cpp:0 (process) message 0") != std::string::npos);
+    CHECK(text.find("message 3") > text.find("message 2"));
+    CHECK(text.find("path/to") == std::string::npos);
+
+    // The ring wraps around once drained
+    REQUIRE(queue.push(makeRecord("again", 5)));
+    std::ostringstream again;
+    REQUIRE(queue.drain(again) == 1);
+    CHECK(again.str().find("again") != std::string::npos);
+    CHECK(again.str().find("dropped") == std::string::npos);
+}
+
+TEST_CASE("LogQueue takes pushes from several threads at once", "[util][log]") {
+    debug::LogQueue<1024> queue;
+    std::atomic<int> pushed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&queue, &pushed, t] {
+            for (int i = 0; i < 200; ++i) pushed += queue.push(makeRecord("x", t * 1000 + i)) ? 1 : 0;
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    REQUIRE(pushed == 800);
+
+    std::ostringstream out;
+    REQUIRE(queue.drain(out) == 800);
+}
+
+TEST_CASE("Logger truncates long messages instead of allocating", "[util][log]") {
+    const std::string long_text(2 * debug::LogRecord::kTextCapacity, 'y');
+    LOG_DBG("{}", long_text);
+    debug::flushLog();
+    SUCCEED();
+}
+
+#endif
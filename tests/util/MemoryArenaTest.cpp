@@ -155,6 +155,18 @@ TEST_CASE("MemoryArena frame behavior", "[util][memory]")
         arena.resetToFrame(frame);
         REQUIRE(arena.getBytesUsed() == at_frame);
     }
+
+    SECTION("Peak usage survives frame rewinds")
+    {
+        REQUIRE(arena.getCapacity() == backing.size());
+        {
+            auto frame = arena.createFrame();
+            arena.allocateBytes(300);
+        }
+        arena.allocateBytes(100);
+        REQUIRE(arena.getBytesUsed() == 100);
+        REQUIRE(arena.getPeakBytesUsed() == 300);
+    }
 }
 
 TEST_CASE("MemoryArena makeSpan", "[util][memory]")
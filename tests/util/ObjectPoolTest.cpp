@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <applause/util/ObjectPool.h>
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Tracked {
+    static inline int alive = 0;
+    explicit Tracked(int v) : value(v) { ++alive; }
+    ~Tracked() { --alive; }
+    int value;
+};
+}  // namespace
+
+TEST_CASE("ObjectPool acquires until exhausted and recycles slots", "[util][memory]")
+{
+    applause::ObjectPool<Tracked> pool{3};
+    REQUIRE(pool.capacity() == 3);
+    REQUIRE(pool.available() == 3);
+
+    Tracked* a = pool.acquire(1);
+    Tracked* b = pool.acquire(2);
+    Tracked* c = pool.acquire(3);
+    REQUIRE(a != nullptr);
+    REQUIRE(b != nullptr);
+    REQUIRE(c != nullptr);
+    REQUIRE(pool.acquire(4) == nullptr);
+    REQUIRE(pool.available() == 0);
+    REQUIRE(Tracked::alive == 3);
+    REQUIRE(b->value == 2);
+
+    std::set<Tracked*> distinct{a, b, c};
+    REQUIRE(distinct.size() == 3);
+    for (auto* p : distinct) {
+        REQUIRE(pool.owns(p));
+        REQUIRE(reinterpret_cast<std::uintptr_t>(p) % applause::defaultByteAlignment == 0);
+    }
+
+    pool.release(b);
+    REQUIRE(Tracked::alive == 2);
+    REQUIRE(pool.available() == 1);
+    Tracked* d = pool.acquire(5);
+    REQUIRE(d == b);
+    REQUIRE(d->value == 5);
+
+    pool.release(nullptr);
+    pool.release(a);
+    pool.release(c);
+    pool.release(d);
+    REQUIRE(Tracked::alive == 0);
+    REQUIRE(pool.available() == 3);
+
+    Tracked outside{0};
+    REQUIRE_FALSE(pool.owns(&outside));
+}
+
+TEST_CASE("ObjectPool acquireUnique releases on destruction", "[util][memory]")
+{
+    applause::ObjectPool<Tracked> pool{1};
+    {
+        auto owned = pool.acquireUnique(7);
+        REQUIRE(owned);
+        REQUIRE(owned->value == 7);
+        REQUIRE_FALSE(pool.acquireUnique(8));
+    }
+    REQUIRE(pool.available() == 1);
+    REQUIRE(Tracked::alive == 0);
+}
+
+TEST_CASE("ObjectPool hands each slot to one owner across threads", "[util][memory]")
+{
+    constexpr int kThreads = 4;
+    constexpr int kIterations = 20000;
+    applause::ObjectPool<std::atomic<int>> pool{8};
+    std::atomic<int> collisions{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kIterations; ++i) {
+                auto* slot = pool.acquire(t);
+                if (!slot) continue;
+                // Nobody else may hold this slot while we do
+                for (int k = 0; k < 4; ++k) {
+                    if (slot->load() != t) collisions.fetch_add(1);
+                    slot->store(t);
+                }
+                pool.release(slot);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    REQUIRE(collisions.load() == 0);
+    REQUIRE(pool.available() == pool.capacity());
+}
+
+TEST_CASE("ObjectPool takes objects back from another thread", "[util][memory]")
+{
+    applause::ObjectPool<Tracked> pool{16};
+    std::vector<Tracked*> acquired;
+    for (int i = 0; i < 16; ++i) acquired.push_back(pool.acquire(i));
+    REQUIRE(pool.acquire(16) == nullptr);
+
+    std::thread ui([&] {
+        for (auto* p : acquired) pool.release(p);
+    });
+    ui.join();
+
+    REQUIRE(pool.available() == 16);
+    REQUIRE(Tracked::alive == 0);
+    Tracked* again = pool.acquire(0);
+    REQUIRE(pool.owns(again));
+    pool.release(again);
+}
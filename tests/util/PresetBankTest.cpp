@@ -0,0 +1,143 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <applause/core/PluginBase.h>
+#include <applause/extensions/ParamsExtension.h>
+#include <applause/util/MappedFile.h>
+#include <applause/util/PresetBank.h>
+
+using namespace applause;
+namespace fs = std::filesystem;
+
+namespace {
+const clap_plugin_descriptor_t kDesc{};
+
+struct TestPlugin : PluginBase {
+    ParamsExtension params{4};
+    TestPlugin() : PluginBase(&kDesc, nullptr) {
+        for (const char* id : {"cutoff", "resonance"}) {
+            ParamConfig config;
+            config.string_id = id;
+            params.registerParam(config);
+        }
+        registerExtension(params);
+    }
+    ProcessStatus process(ProcessContext&) noexcept override { return ProcessStatus::Continue; }
+};
+
+struct TempDir {
+    fs::path path = fs::temp_directory_path() / ("applause-preset-bank-" + std::to_string(std::random_device{}()));
+    TempDir() { fs::create_directories(path); }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+// A bank of count presets whose cutoff is i / count
+fs::path writeBank(const fs::path& file, TestPlugin& plugin, int count) {
+    PresetBankWriter writer;
+    std::vector<uint8_t> params;
+    for (int i = 0; i < count; ++i) {
+        plugin.params.getInfo("cutoff").setValueSilently(static_cast<float>(i) / static_cast<float>(count));
+        params.clear();
+        REQUIRE(plugin.params.saveToBytes(params));
+        const std::vector<uint8_t> state(static_cast<size_t>(i), static_cast<uint8_t>(i));
+        writer.add({.name = "Preset " + std::to_string(i), .tags = {"tag"}}, params, state);
+    }
+    REQUIRE(writer.write(file));
+    return file;
+}
+}  // namespace
+
+TEST_CASE("MappedFile maps whole files", "[presets][bank]") {
+    TempDir dir;
+    {
+        std::ofstream out(dir.path / "data.bin", std::ios::binary);
+        out << "hello";
+        std::ofstream empty(dir.path / "empty.bin", std::ios::binary);
+    }
+
+    MappedFile file;
+    REQUIRE(file.open(dir.path / "data.bin"));
+    CHECK(std::string(reinterpret_cast<const char*>(file.data()), file.size()) == "hello");
+
+    MappedFile moved = std::move(file);
+    CHECK_FALSE(file.isOpen());
+    CHECK(moved.size() == 5);
+
+    REQUIRE(moved.open(dir.path / "empty.bin"));
+    CHECK(moved.isOpen());
+    CHECK(moved.size() == 0);
+    CHECK_FALSE(moved.open(dir.path / "missing.bin"));
+    CHECK_FALSE(moved.isOpen());
+}
+
+TEST_CASE("PresetBank loads single presets straight from the mapping", "[presets][bank]") {
+    TempDir dir;
+    TestPlugin plugin;
+    const fs::path file = writeBank(dir.path / "Factory.bank", plugin, 5);
+
+    PresetBank bank;
+    REQUIRE(bank.open(file));
+    REQUIRE(bank.size() == 5);
+
+    PresetBankEntry entry;
+    REQUIRE(bank.getEntry(3, entry));
+    CHECK(reinterpret_cast<uintptr_t>(entry.params.data()) % 8 == 0);
+    CHECK(entry.state.size() == 3);
+    CHECK(entry.state[0] == 3);
+    REQUIRE(plugin.params.loadFromBytes(entry.params));
+    CHECK(plugin.params.getInfo("cutoff").getValue() == 0.6f);
+
+    PresetMetadata metadata;
+    REQUIRE(bank.getMetadata(4, metadata));
+    CHECK(metadata.name == "Preset 4");
+    CHECK(metadata.tags == std::vector<std::string>{"tag"});
+
+    CHECK_FALSE(bank.getEntry(5, entry));
+
+#if !defined(_WIN32)
+    SECTION("Replacing the bank leaves open mappings intact") {
+        TestPlugin other;
+        writeBank(file, other, 2);
+        REQUIRE(bank.getMetadata(4, metadata));
+        CHECK(metadata.name == "Preset 4");
+
+        PresetBank reopened;
+        REQUIRE(reopened.open(file));
+        CHECK(reopened.size() == 2);
+    }
+#endif
+
+    SECTION("A bank handed to the writer is reopened on the new file") {
+        PresetBankWriter writer;
+        writer.add({.name = "Only"}, std::vector<uint8_t>{1, 2, 3});
+        REQUIRE(writer.write(file, &bank));
+        REQUIRE(bank.isOpen());
+        REQUIRE(bank.size() == 1);
+        REQUIRE(bank.getMetadata(0, metadata));
+        CHECK(metadata.name == "Only");
+    }
+
+    SECTION("Truncated banks fail per preset") {
+        bank.close();
+        const auto size = fs::file_size(file);
+        fs::resize_file(file, size - 10);
+        REQUIRE(bank.open(file));
+        CHECK(bank.getEntry(0, entry));
+        CHECK_FALSE(bank.getEntry(4, entry));
+    }
+
+    SECTION("Other files are rejected") {
+        std::ofstream(dir.path / "other.bank", std::ios::binary) << "APLP not a bank";
+        CHECK_FALSE(bank.open(dir.path / "other.bank"));
+        CHECK_FALSE(bank.isOpen());
+        CHECK(bank.size() == 0);
+    }
+}
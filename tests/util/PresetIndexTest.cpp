@@ -0,0 +1,158 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <applause/util/PresetFile.h>
+#include <applause/util/PresetIndex.h>
+
+using namespace applause;
+namespace fs = std::filesystem;
+
+namespace {
+struct TempDir {
+    fs::path path = fs::temp_directory_path() / ("applause-preset-index-" + std::to_string(std::random_device{}()));
+    TempDir() { fs::create_directories(path); }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+void writePreset(const fs::path& file, const PresetMetadata& metadata, const std::string& state = "state") {
+    fs::create_directories(file.parent_path());
+    std::ofstream out(file, std::ios::binary);
+    writePresetHeader(out, metadata);
+    out << state;
+}
+}  // namespace
+
+TEST_CASE("Preset file headers round trip and leave the stream at the state", "[presets]") {
+    const PresetMetadata metadata{.name = "Warm Pad", .tags = {"pad", "warm"}, .creator = "me", .description = "d"};
+    std::stringstream stream;
+    writePresetHeader(stream, metadata);
+    stream << "STATE";
+
+    PresetMetadata read;
+    REQUIRE(readPresetHeader(stream, read));
+    CHECK(read == metadata);
+    std::string rest;
+    stream >> rest;
+    CHECK(rest == "STATE");
+
+    SECTION("Rejects other files and newer versions") {
+        std::stringstream not_preset("{\"a\": 1}");
+        CHECK_FALSE(readPresetHeader(not_preset, read));
+
+        std::string bytes = stream.str();
+        bytes[4] = static_cast<char>(kPresetFileVersion + 1);
+        std::stringstream newer(bytes);
+        CHECK_FALSE(readPresetHeader(newer, read));
+
+        std::stringstream truncated(stream.str().substr(0, 14));
+        CHECK_FALSE(readPresetHeader(truncated, read));
+    }
+}
+
+TEST_CASE("PresetIndex only rereads new and changed presets", "[presets]") {
+    TempDir dir;
+    writePreset(dir.path / "a.aplp", {.name = "A", .tags = {"bass"}});
+    writePreset(dir.path / "sub" / "b.aplp", {.name = "B"});
+    writePreset(dir.path / "ignored.txt", {.name = "Not a preset"});
+    {
+        std::ofstream broken(dir.path / "broken.aplp");
+        broken << "garbage";
+    }
+
+    PresetIndex index;
+    PresetIndexStats stats = index.refresh(dir.path);
+    CHECK(stats.read == 2);
+    CHECK(stats.reused == 0);
+    CHECK(index.size() == 2);
+    CHECK(index.isDirty());
+    REQUIRE(index.find(dir.path / "a.aplp") != nullptr);
+    CHECK(index.find(dir.path / "a.aplp")->metadata.tags == std::vector<std::string>{"bass"});
+
+    const auto entries = index.entriesIn(dir.path);
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0]->metadata.name == "A");
+    CHECK(entries[1]->metadata.name == "B");
+    CHECK(index.entriesIn(dir.path / "sub").size() == 1);
+
+    SECTION("Unchanged files are served from the index") {
+        stats = index.refresh(dir.path);
+        CHECK(stats.read == 0);
+        CHECK(stats.reused == 2);
+        CHECK(stats.skipped == 1);
+    }
+
+    SECTION("Unreadable files are only retried once they change") {
+        const fs::path broken = dir.path / "broken.aplp";
+        CHECK(index.refreshFile(broken) == nullptr);
+        writePreset(broken, {.name = "Fixed"});
+        fs::last_write_time(broken, fs::last_write_time(broken) + std::chrono::seconds(2));
+
+        stats = index.refresh(dir.path);
+        CHECK(stats.read == 1);
+        CHECK(stats.skipped == 0);
+        REQUIRE(index.find(broken) != nullptr);
+        CHECK(index.find(broken)->metadata.name == "Fixed");
+    }
+
+    SECTION("Changed, new and deleted files are picked up") {
+        const fs::path a = dir.path / "a.aplp";
+        const auto modified = fs::last_write_time(a);
+        writePreset(a, {.name = "A2"});
+        fs::last_write_time(a, modified + std::chrono::seconds(2));
+        writePreset(dir.path / "c.aplp", {.name = "C"});
+        fs::remove(dir.path / "sub" / "b.aplp");
+
+        stats = index.refresh(dir.path);
+        CHECK(stats.read == 2);
+        CHECK(stats.reused == 0);
+        CHECK(stats.removed == 1);
+        CHECK(index.find(a)->metadata.name == "A2");
+        CHECK(index.find(dir.path / "sub" / "b.aplp") == nullptr);
+        CHECK(index.size() == 2);
+    }
+
+    SECTION("The index persists across instances") {
+        const fs::path index_file = dir.path / "cache" / "index.cbor";
+        REQUIRE(index.save(index_file));
+        CHECK_FALSE(index.isDirty());
+
+        PresetIndex loaded;
+        REQUIRE(loaded.load(index_file));
+        CHECK(loaded.size() == 2);
+        CHECK(loaded.find(dir.path / "sub" / "b.aplp")->metadata.name == "B");
+
+        stats = loaded.refresh(dir.path);
+        CHECK(stats.reused == 2);
+        CHECK(stats.read == 0);
+        CHECK(stats.skipped == 1);
+        CHECK_FALSE(loaded.isDirty());
+
+        // Each save writes its own temp file, and none is left behind
+        REQUIRE(loaded.save(index_file));
+        size_t files = 0;
+        for (const auto& file : fs::directory_iterator(index_file.parent_path())) files += file.is_regular_file();
+        CHECK(files == 1);
+
+        // Indexes of other file types are rebuilt rather than trusted
+        PresetIndex other("preset");
+        CHECK_FALSE(other.load(index_file));
+        CHECK(other.size() == 0);
+    }
+
+    SECTION("Single files refresh on their own") {
+        const PresetIndexEntry* entry = index.refreshFile(dir.path / "sub" / "b.aplp");
+        REQUIRE(entry != nullptr);
+        CHECK(entry->metadata.name == "B");
+        CHECK(index.refreshFile(dir.path / "broken.aplp") == nullptr);
+        CHECK(index.refreshFile(dir.path / "missing.aplp") == nullptr);
+    }
+}
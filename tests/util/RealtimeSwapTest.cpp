@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <applause/util/RealtimeSwap.h>
+
+using namespace applause;
+
+namespace {
+struct Tracked {
+    static inline std::atomic<int> alive{0};
+    int value;
+    explicit Tracked(int v) : value(v) { ++alive; }
+    ~Tracked() { --alive; }
+};
+}  // namespace
+
+TEST_CASE("RealtimeSwap hands objects over and frees them on the main thread", "[util][swap]") {
+    {
+        RealtimeSwap<Tracked> swap(std::make_unique<Tracked>(1));
+        REQUIRE(swap.get()->value == 1);
+        REQUIRE_FALSE(swap.update());
+
+        swap.publish(std::make_unique<Tracked>(2));
+        REQUIRE(swap.hasPending());
+        REQUIRE(swap.get()->value == 1);
+        REQUIRE(swap.update());
+        REQUIRE(swap.get()->value == 2);
+
+        // The replaced object waits for the main thread
+        REQUIRE(Tracked::alive == 2);
+        swap.collect();
+        REQUIRE(Tracked::alive == 1);
+
+        // Publishing twice before an update drops the first one unseen
+        swap.publish(std::make_unique<Tracked>(3));
+        swap.publish(std::make_unique<Tracked>(4));
+        REQUIRE(Tracked::alive == 2);
+        REQUIRE(swap.update());
+        REQUIRE(swap.get()->value == 4);
+        REQUIRE_FALSE(swap.update());
+
+        // Each publish collects whatever the last swap replaced
+        swap.publish(std::make_unique<Tracked>(5));
+        REQUIRE(Tracked::alive == 2);
+        REQUIRE(swap.update());
+        REQUIRE(swap.get()->value == 5);
+    }
+    REQUIRE(Tracked::alive == 0);
+}
+
+TEST_CASE("RealtimeSwap under concurrent publish and update", "[util][swap]") {
+    {
+        RealtimeSwap<Tracked> swap(std::make_unique<Tracked>(0));
+        std::atomic<bool> done{false};
+        int last_seen = 0;
+        bool monotonic = true;
+
+        std::thread audio([&] {
+            while (!done.load()) {
+                if (swap.update()) {
+                    monotonic = monotonic && swap.get()->value > last_seen;
+                    last_seen = swap.get()->value;
+                }
+            }
+            swap.update();
+        });
+        for (int i = 1; i <= 2000; ++i) {
+            swap.publish(std::make_unique<Tracked>(i));
+        }
+        done = true;
+        audio.join();
+        swap.collect();
+        swap.update();
+
+        REQUIRE(monotonic);
+        REQUIRE(swap.get()->value == 2000);
+    }
+    REQUIRE(Tracked::alive == 0);
+}
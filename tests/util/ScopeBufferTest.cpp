@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <applause/util/ScopeBuffer.h>
+
+using namespace applause;
+
+namespace {
+// Pushes frames [first, first + count) of a ramp whose right channel is the left one negated
+void pushRamp(ScopeBuffer& scope, int first, uint32_t count) {
+    std::vector<float> left(count), right(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        left[i] = static_cast<float>(first + static_cast<int>(i));
+        right[i] = -left[i];
+    }
+    const float* channels[] = {left.data(), right.data()};
+    scope.push(channels, count);
+}
+}  // namespace
+
+TEST_CASE("ScopeBuffer returns the newest window", "[util][scope]") {
+    ScopeBuffer scope(2, 100);
+    REQUIRE(scope.getCapacity() == 128);
+
+    std::array<float, 64> left{}, right{};
+    float* out[] = {left.data(), right.data()};
+    REQUIRE(scope.readLatest(out, 64) == 0);
+
+    // Fewer frames than requested so far
+    pushRamp(scope, 0, 10);
+    REQUIRE(scope.getWritePosition() == 10);
+    REQUIRE(scope.readLatest(out, 64) == 10);
+    CHECK(left[0] == 0.0f);
+    CHECK(left[9] == 9.0f);
+    CHECK(right[9] == -9.0f);
+
+    // After wrapping around the ring, the window ends at the last pushed frame
+    for (int first = 10; first < 500; first += 70) pushRamp(scope, first, 70);
+    REQUIRE(scope.readLatest(out, 64) == 64);
+    for (uint32_t i = 0; i < 64; ++i) {
+        CHECK(left[i] == static_cast<float>(500 - 64 + static_cast<int>(i)));
+        CHECK(right[i] == -left[i]);
+    }
+
+    // The window never exceeds the capacity
+    std::vector<float> big_left(256), big_right(256);
+    float* big[] = {big_left.data(), big_right.data()};
+    REQUIRE(scope.readLatest(big, 256) == 128);
+    CHECK(big_left[127] == 499.0f);
+}
+
+TEST_CASE("ScopeBuffer decimates across block boundaries", "[util][scope]") {
+    ScopeBuffer scope(2, 64, 3);
+
+    // Blocks of uneven length still keep exactly every third frame
+    pushRamp(scope, 0, 5);
+    pushRamp(scope, 5, 1);
+    pushRamp(scope, 6, 1);
+    pushRamp(scope, 7, 13);
+    REQUIRE(scope.getWritePosition() == 7);
+
+    std::array<float, 16> left{}, right{};
+    float* out[] = {left.data(), right.data()};
+    REQUIRE(scope.readLatest(out, 16) == 7);
+    for (uint32_t i = 0; i < 7; ++i) CHECK(left[i] == static_cast<float>(i * 3));
+}
+
+TEST_CASE("ScopeBuffer reader never sees a torn window", "[util][scope][threads]") {
+    ScopeBuffer scope(2, 256);
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (int first = 0; first < 2'000'000; first += 32) pushRamp(scope, first, 32);
+        done = true;
+    });
+
+    std::array<float, 128> left{}, right{};
+    float* out[] = {left.data(), right.data()};
+    uint64_t reads = 0;
+    bool consistent = true;
+    while (!done || reads == 0) {
+        const uint32_t n = scope.readLatest(out, 128);
+        for (uint32_t i = 1; i < n; ++i) {
+            consistent = consistent && left[i] == left[i - 1] + 1.0f && right[i] == -left[i];
+        }
+        reads += n > 0;
+    }
+    producer.join();
+
+    CHECK(consistent);
+    CHECK(reads > 0);
+}
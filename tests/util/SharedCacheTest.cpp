@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+
+#include <applause/util/SharedCache.h>
+
+using namespace applause;
+
+TEST_CASE("SharedCache shares live objects and frees them with their last holder", "[util][cache]") {
+    SharedCache<std::string, std::string> cache;
+    int builds = 0;
+    const auto make = [&](const char* value) {
+        return [&builds, value] {
+            ++builds;
+            return std::make_shared<std::string>(value);
+        };
+    };
+
+    auto first = cache.getOrCreate("icon", make("a"));
+    auto second = cache.getOrCreate("icon", make("b"));
+    CHECK(builds == 1);
+    CHECK(first == second);
+    CHECK(*second == "a");
+    CHECK(cache.find("icon") == first);
+    CHECK(cache.size() == 1);
+
+    // Other keys get their own object
+    auto other = cache.getOrCreate("font", make("c"));
+    CHECK(builds == 2);
+    CHECK(cache.size() == 2);
+
+    // Gone once nobody holds it, and rebuilt on the next request
+    first.reset();
+    CHECK(cache.find("icon") != nullptr);
+    second.reset();
+    CHECK(cache.find("icon") == nullptr);
+    CHECK(cache.size() == 1);
+    CHECK(*cache.getOrCreate("icon", make("d")) == "d");
+    CHECK(builds == 3);
+
+    // A failed build isn't cached
+    CHECK(cache.getOrCreate("missing", [] { return std::shared_ptr<std::string>(); }) == nullptr);
+    CHECK(*cache.getOrCreate("missing", make("e")) == "e");
+}
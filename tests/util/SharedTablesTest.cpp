@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <applause/dsp/Convolver.h>
+#include <applause/dsp/modulation/MSEGTable.h>
+#include <applause/dsp/oscillators/Wavetable.h>
+#include <applause/util/ContentHash.h>
+#include <applause/util/SharedTables.h>
+
+using namespace applause;
+using Catch::Approx;
+
+TEST_CASE("ContentHasher depends on every byte and on how content is split", "[util][tables]") {
+    const std::vector<float> a{0.0f, 0.5f, 1.0f};
+    std::vector<float> b = a;
+    const auto hash = [](std::span<const float> values) { return ContentHasher().add(values).value(); };
+
+    CHECK(hash(a) == hash(b));
+    b[2] = 0.75f;
+    CHECK(hash(a) != hash(b));
+    CHECK(hash(std::span(a).first(2)) != hash(a));
+    CHECK(ContentHasher().add(1u).add(2u).value() != ContentHasher().add(2u).add(1u).value());
+    CHECK(ContentHasher().add(std::string_view("ab")).add(std::string_view("c")).value() !=
+          ContentHasher().add(std::string_view("a")).add(std::string_view("bc")).value());
+}
+
+TEST_CASE("SharedTables builds each table once and frees it with its last holder", "[util][tables]") {
+    std::vector<float> saw(2 * 64);
+    for (size_t i = 0; i < saw.size(); ++i) saw[i] = static_cast<float>(i % 64) / 32.0f - 1.0f;
+
+    auto first = Wavetable::shared(saw, 64);
+    auto second = Wavetable::shared(saw, 64);
+    REQUIRE(first);
+    CHECK(first == second);
+    CHECK(first->numFrames() == 2);
+    CHECK(SharedTables::size<Wavetable>() == 1);
+
+    // Different content or parameters build their own tables
+    auto halves = Wavetable::shared(saw, 32);
+    CHECK(halves != first);
+    CHECK(halves->numFrames() == 4);
+    saw[3] = 0.0f;
+    auto edited = Wavetable::shared(saw, 64);
+    CHECK(edited != first);
+    CHECK(SharedTables::size<Wavetable>() == 3);
+
+    first.reset();
+    CHECK(SharedTables::size<Wavetable>() == 3);
+    second.reset();
+    CHECK(SharedTables::size<Wavetable>() == 2);
+    halves.reset();
+    edited.reset();
+    CHECK(SharedTables::size<Wavetable>() == 0);
+
+    MSEGCurve<4> curve;
+    curve.points[0] = {0.0f, 0.0f};
+    curve.points[1] = {0.5f, 1.0f};
+    curve.points[2] = {1.0f, 0.0f};
+    curve.curvature_power = {2.0f, -2.0f};
+    curve.num_points = 3;
+
+    auto baked = MSEGTable::bakeShared(curve, 1e-3f);
+    CHECK(MSEGTable::bakeShared(curve, 1e-3f) == baked);
+    CHECK(baked->evaluate(0.5f) == Approx(1.0f).margin(1e-3));
+    // Unused points don't change the key
+    curve.points[3] = {0.7f, 0.2f};
+    CHECK(MSEGTable::bakeShared(curve, 1e-3f) == baked);
+    curve.loop = false;
+    CHECK(MSEGTable::bakeShared(curve, 1e-3f) != baked);
+}
+
+TEST_CASE("Convolvers share one kernel and keep it alive while in use", "[util][tables][dsp]") {
+    const ConvolverLayout layout{.head_block = 16};
+    std::vector<float> ir(24, 0.0f);
+    ir[3] = 0.5f;
+
+    Convolver a;
+    Convolver b;
+    a.activate(layout, 1, 32);
+    b.activate(layout, 1, 32);
+
+    auto kernel = ConvolverKernel::shared(layout, std::span<const float>(ir));
+    CHECK(ConvolverKernel::shared(layout, std::span<const float>(ir)) == kernel);
+    CHECK(ConvolverKernel::shared(ConvolverLayout{.head_block = 32}, std::span<const float>(ir)) != kernel);
+    a.setKernel(kernel);
+    b.setKernel(kernel);
+    const std::weak_ptr<const ConvolverKernel> watch = kernel;
+    kernel.reset();
+    CHECK(!watch.expired());
+
+    for (Convolver* convolver : {&a, &b}) {
+        std::vector<float> buffer(64, 0.0f);
+        buffer[0] = 1.0f;
+        convolver->process(BufferView<float, 1>(buffer.data(), 1, buffer.size()));
+        CHECK(buffer[16 + 3] == Approx(0.5f).margin(1e-5));
+    }
+
+    // Replacing it in both convolvers releases the last reference on the main thread's collect()
+    std::vector<float> other(8, 0.25f);
+    for (Convolver* convolver : {&a, &b}) {
+        convolver->setKernel(std::make_unique<ConvolverKernel>(layout, std::span<const float>(other)));
+        std::vector<float> buffer(16, 0.0f);
+        convolver->process(BufferView<float, 1>(buffer.data(), 1, buffer.size()));
+        convolver->collect();
+    }
+    CHECK(watch.expired());
+}
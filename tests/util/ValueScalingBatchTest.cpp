@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <applause/util/ValueScalingBatch.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace applause;
+using Catch::Approx;
+
+namespace {
+
+// One destination of each scale type, repeated so every group fills whole batches plus a scalar tail
+std::vector<ValueScaleInfo> makeScales(size_t count) {
+    const ValueScaleInfo kinds[] = {
+        {0.0f, 1.0f, ValueScaling::linear()},
+        {20.0f, 20000.0f, ValueScaling::frequency(20.0f, 20000.0f)},
+        {0.001f, 10.0f, ValueScaling::time(0.001f, 10.0f)},
+        {-5.0f, 5.0f, ValueScaling::quadratic()},
+    };
+    std::vector<ValueScaleInfo> scales;
+    for (size_t i = 0; i < count; ++i) scales.push_back(kinds[i % 4]);
+    return scales;
+}
+
+}  // namespace
+
+TEST_CASE("ValueScalingBatch matches the scalar conversions", "[util][scaling]")
+{
+    const auto scales = makeScales(37);
+    ValueScalingBatch batch;
+    for (size_t i = 0; i < scales.size(); ++i) batch.add(static_cast<uint16_t>(i), scales[i]);
+    REQUIRE(batch.size() == scales.size());
+
+    std::vector<float> norm(scales.size());
+    for (size_t i = 0; i < norm.size(); ++i) norm[i] = static_cast<float>(i) / static_cast<float>(norm.size() - 1);
+
+    SECTION("Exact fromNormalized is identical to ValueScaling")
+    {
+        std::vector<float> plain(norm.size());
+        batch.fromNormalized(norm.data(), plain.data(), ScalingPrecision::Exact);
+        for (size_t i = 0; i < norm.size(); ++i) {
+            const auto& s = scales[i];
+            REQUIRE(plain[i] == s.scaling.fromNormalized(norm[i], s.min, s.max));
+        }
+    }
+
+    SECTION("Fast fromNormalized is within the documented relative bound")
+    {
+        std::vector<float> plain(norm.size());
+        batch.fromNormalized(norm.data(), plain.data(), ScalingPrecision::Fast);
+        for (size_t i = 0; i < norm.size(); ++i) {
+            const auto& s = scales[i];
+            const float exact = s.scaling.fromNormalized(norm[i], s.min, s.max);
+            REQUIRE(std::abs(plain[i] - exact) <= 1e-6f * std::max(std::abs(exact), std::abs(s.max - s.min)));
+        }
+    }
+
+    SECTION("Fast toNormalized round-trips within the documented absolute bound")
+    {
+        std::vector<float> values(norm.size());
+        batch.fromNormalized(norm.data(), values.data(), ScalingPrecision::Exact);
+        batch.toNormalized(values.data(), values.data(), ScalingPrecision::Fast);
+        for (size_t i = 0; i < norm.size(); ++i) {
+            REQUIRE(values[i] == Approx(norm[i]).margin(1e-6));
+        }
+    }
+
+    SECTION("Exponential scales stay inside their range at the endpoints")
+    {
+        for (const auto precision : {ScalingPrecision::Fast, ScalingPrecision::Exact}) {
+            std::vector<float> plain(norm.size());
+            batch.fromNormalized(norm.data(), plain.data(), precision);
+            for (size_t i = 0; i < norm.size(); ++i) {
+                REQUIRE(plain[i] >= scales[i].min);
+                REQUIRE(plain[i] <= scales[i].max);
+            }
+        }
+    }
+}
+
+TEST_CASE("ValueScalingBatch clamps and leaves unlisted entries alone", "[util][scaling]")
+{
+    ValueScalingBatch batch;
+    batch.add(1, {20.0f, 20000.0f, ValueScaling::frequency(20.0f, 20000.0f)});
+    batch.add(3, {0.0f, 10.0f, ValueScaling::linear()});
+
+    for (const auto precision : {ScalingPrecision::Fast, ScalingPrecision::Exact}) {
+        float values[4] = {7.0f, 1.5f, 7.0f, -0.5f};
+        batch.fromNormalized(values, values, precision);
+        REQUIRE(values[0] == 7.0f);
+        REQUIRE(values[1] == Approx(20000.0f));
+        REQUIRE(values[1] <= 20000.0f);
+        REQUIRE(values[2] == 7.0f);
+        REQUIRE(values[3] == 0.0f);
+    }
+}
+
+TEST_CASE("Sample fromNormalized converts a SIMD batch with one scale", "[util][scaling]")
+{
+    using Batch = xsimd::batch<float>;
+    const ValueScaleInfo s{0.001f, 10.0f, ValueScaling::time(0.001f, 10.0f)};
+
+    alignas(64) float in[Batch::size];
+    alignas(64) float out[Batch::size];
+    for (size_t i = 0; i < Batch::size; ++i) in[i] = static_cast<float>(i) / static_cast<float>(Batch::size);
+
+    fromNormalized(s, Batch::load_aligned(in), ScalingPrecision::Fast).store_aligned(out);
+    for (size_t i = 0; i < Batch::size; ++i) {
+        REQUIRE(out[i] == Approx(s.scaling.fromNormalized(in[i], s.min, s.max)).epsilon(1e-6));
+    }
+}
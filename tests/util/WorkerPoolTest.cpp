@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <applause/extensions/ThreadPoolExtension.h>
+#include <applause/util/WorkerPool.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+using namespace applause;
+
+TEST_CASE("WorkerPool runs every task exactly once", "[util][threads]") {
+    WorkerPool pool{3};
+    REQUIRE(pool.numWorkers() == 3);
+
+    for (uint32_t num_tasks : {0u, 1u, 2u, 7u, 64u, 1000u}) {
+        INFO("tasks " << num_tasks);
+        std::vector<std::atomic<int>> runs(num_tasks);
+        pool.parallelFor(num_tasks, [&](uint32_t task) {
+            // Uneven task lengths give the thieves something to do
+            volatile uint32_t spin = 0;
+            for (uint32_t i = 0; i < (task % 7) * 100; ++i) spin = spin + 1;
+            runs[task].fetch_add(1, std::memory_order_relaxed);
+        });
+        for (const auto& count : runs) REQUIRE(count.load() == 1);
+    }
+}
+
+TEST_CASE("WorkerPool survives many back-to-back jobs", "[util][threads]") {
+    WorkerPool pool{2};
+    std::atomic<uint64_t> sum{0};
+    uint64_t expected = 0;
+    for (uint32_t job = 0; job < 2000; ++job) {
+        const uint32_t num_tasks = 1 + job % 9;
+        pool.parallelFor(num_tasks, [&](uint32_t task) { sum.fetch_add(task + 1, std::memory_order_relaxed); });
+        expected += uint64_t{num_tasks} * (num_tasks + 1) / 2;
+    }
+    REQUIRE(sum.load() == expected);
+}
+
+TEST_CASE("WorkerPool::parallelForRange covers the range in chunks", "[util][threads]") {
+    WorkerPool pool{2};
+    std::vector<int> hits(103, 0);
+    pool.parallelForRange(hits.size(), 10, [&](size_t first, size_t last) {
+        REQUIRE(last - first <= 10);
+        for (size_t i = first; i < last; ++i) ++hits[i];
+    });
+    for (int h : hits) REQUIRE(h == 1);
+}
+
+TEST_CASE("ThreadPoolExtension falls back to its own pool without host support", "[util][threads]") {
+    ThreadPoolExtension ext;
+    REQUIRE_FALSE(ext.hasHostSupport());
+    REQUIRE_FALSE(ext.hasParallelSupport());
+    REQUIRE_FALSE(ext.requestExec(4));
+
+    ext.enableFallbackPool(2);
+    REQUIRE(ext.hasParallelSupport());
+    REQUIRE(ext.getFallbackPool() != nullptr);
+
+    std::vector<std::atomic<int>> runs(16);
+    ext.setCallback([&](uint32_t task) { runs[task].fetch_add(1); });
+    REQUIRE(ext.requestExec(16));
+    for (const auto& count : runs) REQUIRE(count.load() == 1);
+
+    ext.disableFallbackPool();
+    REQUIRE_FALSE(ext.hasParallelSupport());
+}